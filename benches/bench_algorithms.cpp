@@ -0,0 +1,144 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Benchmarks for the sorting and search algorithms.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <psh_algorithms.hpp>
+#include <psh_memory.hpp>
+#include "bench_utils.hpp"
+
+namespace psh::bench::algorithms {
+    psh_global constexpr usize SORT_ELEMENT_COUNT = 100'000;
+    psh_global constexpr usize SEARCH_TABLE_COUNT = 1u << 20;
+    psh_global constexpr usize SEARCH_QUERY_COUNT = 100'000;
+
+    psh_global constexpr usize TOP_K_COUNT        = 100;
+
+    struct SortData {
+        u32 const* source;
+        u32*       work;
+        u32*       scratch;
+    };
+
+    /// Sort a fresh copy of random data, each operation accounts for one element.
+    psh_internal void quick_sort_u32(void* data, usize op_count) {
+        SortData* sort_data = reinterpret_cast<SortData*>(data);
+        memory_copy(reinterpret_cast<u8*>(sort_data->work), reinterpret_cast<u8 const*>(sort_data->source), op_count * psh_usize_of(u32));
+        quick_sort(FatPtr<u32>{sort_data->work, op_count});
+        do_not_optimize(sort_data->work[0]);
+    }
+
+    /// Stable sort of a fresh copy of the data, each operation accounts for one element.
+    psh_internal void merge_sort_u32(void* data, usize op_count) {
+        SortData* sort_data = reinterpret_cast<SortData*>(data);
+        memory_copy(reinterpret_cast<u8*>(sort_data->work), reinterpret_cast<u8 const*>(sort_data->source), op_count * psh_usize_of(u32));
+        merge_sort(FatPtr<u32>{sort_data->work, op_count}, FatPtr<u32>{sort_data->scratch, op_count});
+        do_not_optimize(sort_data->work[0]);
+    }
+
+    /// Select and sort the smallest TOP_K_COUNT elements, each operation accounts for one element.
+    psh_internal void partial_sort_top_100_u32(void* data, usize op_count) {
+        SortData* sort_data = reinterpret_cast<SortData*>(data);
+        memory_copy(reinterpret_cast<u8*>(sort_data->work), reinterpret_cast<u8 const*>(sort_data->source), op_count * psh_usize_of(u32));
+        partial_sort(FatPtr<u32>{sort_data->work, op_count}, TOP_K_COUNT);
+        do_not_optimize(sort_data->work[0]);
+    }
+
+    struct SearchData {
+        FatPtr<u32 const> table;
+        u32 const*        queries;
+    };
+
+    /// Look up random keys in a sorted table larger than the caches.
+    psh_internal void lower_bound_u32(void* data, usize op_count) {
+        SearchData* search = reinterpret_cast<SearchData*>(data);
+        usize       sum    = 0;
+        for (usize idx = 0; idx < op_count; ++idx) {
+            sum += lower_bound(search->table, search->queries[idx]);
+        }
+        do_not_optimize(sum);
+    }
+
+    psh_internal void eytzinger_lower_bound_u32(void* data, usize op_count) {
+        SearchData* search = reinterpret_cast<SearchData*>(data);
+        usize       sum    = 0;
+        for (usize idx = 0; idx < op_count; ++idx) {
+            sum += eytzinger_lower_bound(search->table, search->queries[idx]);
+        }
+        do_not_optimize(sum);
+    }
+
+    psh_internal void run_search_benchmarks() {
+        Arena arena = make_owned_arena((2 * SEARCH_TABLE_COUNT + SEARCH_QUERY_COUNT) * psh_usize_of(u32));
+        psh_defer(destroy_owned_arena(&arena));
+
+        u32* sorted = memory_alloc_uninit<u32>(&arena, SEARCH_TABLE_COUNT);
+        for (usize idx = 0; idx < SEARCH_TABLE_COUNT; ++idx) {
+            sorted[idx] = static_cast<u32>(2 * idx);
+        }
+
+        u32* queries = memory_alloc_uninit<u32>(&arena, SEARCH_QUERY_COUNT);
+        u32  state   = 0x2545F491u;
+        for (usize idx = 0; idx < SEARCH_QUERY_COUNT; ++idx) {
+            queries[idx] = random_u32(&state) % static_cast<u32>(2 * SEARCH_TABLE_COUNT);
+        }
+
+        u32* layout = memory_alloc_uninit<u32>(&arena, SEARCH_TABLE_COUNT);
+        eytzinger_layout(FatPtr<u32 const>{sorted, SEARCH_TABLE_COUNT}, FatPtr<u32>{layout, SEARCH_TABLE_COUNT});
+
+        SearchData sorted_data = {.table = {sorted, SEARCH_TABLE_COUNT}, .queries = queries};
+        SearchData layout_data = {.table = {layout, SEARCH_TABLE_COUNT}, .queries = queries};
+        run_benchmark("lower_bound_u32_1m", lower_bound_u32, &sorted_data, SEARCH_QUERY_COUNT);
+        run_benchmark("eytzinger_lower_bound_u32_1m", eytzinger_lower_bound_u32, &layout_data, SEARCH_QUERY_COUNT);
+    }
+
+    psh_internal void run_all() {
+        run_search_benchmarks();
+
+        Arena arena = make_owned_arena(4 * SORT_ELEMENT_COUNT * psh_usize_of(u32));
+        psh_defer(destroy_owned_arena(&arena));
+
+        u32* source = memory_alloc_uninit<u32>(&arena, SORT_ELEMENT_COUNT);
+        u32  state  = 0x9E3779B9u;
+        for (usize idx = 0; idx < SORT_ELEMENT_COUNT; ++idx) {
+            source[idx] = random_u32(&state);
+        }
+
+        SortData data = {
+            .source  = source,
+            .work    = memory_alloc_uninit<u32>(&arena, SORT_ELEMENT_COUNT),
+            .scratch = memory_alloc_uninit<u32>(&arena, SORT_ELEMENT_COUNT),
+        };
+        run_benchmark("quick_sort_random_u32", quick_sort_u32, &data, SORT_ELEMENT_COUNT);
+        run_benchmark("merge_sort_random_u32", merge_sort_u32, &data, SORT_ELEMENT_COUNT);
+        run_benchmark("partial_sort_top_100_random_u32", partial_sort_top_100_u32, &data, SORT_ELEMENT_COUNT);
+
+        // Data made of a few long sorted runs, such as incrementally updated datasets.
+        u32* runs = memory_alloc_uninit<u32>(&arena, SORT_ELEMENT_COUNT);
+        for (usize idx = 0; idx < SORT_ELEMENT_COUNT; ++idx) {
+            runs[idx] = static_cast<u32>(idx % (SORT_ELEMENT_COUNT / 8u));
+        }
+        SortData runs_data = {.source = runs, .work = data.work, .scratch = data.scratch};
+        run_benchmark("quick_sort_8_runs_u32", quick_sort_u32, &runs_data, SORT_ELEMENT_COUNT);
+        run_benchmark("merge_sort_8_runs_u32", merge_sort_u32, &runs_data, SORT_ELEMENT_COUNT);
+    }
+}  // namespace psh::bench::algorithms
@@ -0,0 +1,93 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Benchmarks for the memory allocators.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <psh_memory.hpp>
+#include "bench_utils.hpp"
+
+namespace psh::bench::allocators {
+    psh_global constexpr usize ALLOCATION_COUNT = 100'000;
+    psh_global constexpr usize ALLOCATION_SIZE  = 64;
+    psh_global constexpr usize PROBE_COUNT      = 1'000'000;
+    psh_global constexpr usize PROBE_WORD_COUNT = psh_mebibytes(256) / sizeof(u64);
+
+    psh_internal void arena_alloc_align(void* data, usize op_count) {
+        Arena* arena = reinterpret_cast<Arena*>(data);
+        arena_clear(arena);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            do_not_optimize(memory_alloc_align(arena, ALLOCATION_SIZE, 16));
+        }
+    }
+
+    psh_internal void arena_alloc_align_uninit(void* data, usize op_count) {
+        Arena* arena = reinterpret_cast<Arena*>(data);
+        arena_clear(arena);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            do_not_optimize(memory_alloc_align_uninit(arena, ALLOCATION_SIZE, 16));
+        }
+    }
+
+    psh_internal void stack_alloc_align(void* data, usize op_count) {
+        Stack* stack = reinterpret_cast<Stack*>(data);
+        stack->clear();
+        for (usize idx = 0; idx < op_count; ++idx) {
+            do_not_optimize(memory_alloc_align(stack, ALLOCATION_SIZE, 16));
+        }
+    }
+
+    /// Reads of words scattered across a large arena, so that most reads miss the TLB.
+    psh_internal void arena_random_reads_256mib(void* data, usize op_count) {
+        u64 const* words = reinterpret_cast<u64 const*>(reinterpret_cast<Arena*>(data)->buf);
+        u64        state = 0x9E3779B97F4A7C15ull;
+        u64        sum   = 0;
+        for (usize idx = 0; idx < op_count; ++idx) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            sum += words[(state >> 20) % PROBE_WORD_COUNT];
+        }
+        do_not_optimize(sum);
+    }
+
+    psh_internal void run_all() {
+        // Account for the alignment padding and the stack headers.
+        usize capacity = ALLOCATION_COUNT * (ALLOCATION_SIZE + 64);
+
+        Arena arena = make_owned_arena(capacity);
+        psh_defer(destroy_owned_arena(&arena));
+        run_benchmark("arena_alloc_align_64b", arena_alloc_align, &arena, ALLOCATION_COUNT);
+        run_benchmark("arena_alloc_align_uninit_64b", arena_alloc_align_uninit, &arena, ALLOCATION_COUNT);
+
+        arena_clear(&arena);
+        Stack stack{.buf = memory_alloc<u8>(&arena, capacity), .capacity = capacity};
+        run_benchmark("stack_alloc_align_64b", stack_alloc_align, &stack, ALLOCATION_COUNT);
+
+        Arena regular_pages = make_owned_arena(psh_mebibytes(256), {.flags = VIRTUAL_MEMORY_FLAG_PREFAULT});
+        psh_defer(destroy_owned_arena(&regular_pages));
+        run_benchmark("arena_random_reads_256mib", arena_random_reads_256mib, &regular_pages, PROBE_COUNT);
+
+        Arena huge_pages = make_owned_arena(
+            psh_mebibytes(256),
+            {.flags = VIRTUAL_MEMORY_FLAG_TRANSPARENT_HUGE_PAGES | VIRTUAL_MEMORY_FLAG_PREFAULT});
+        psh_defer(destroy_owned_arena(&huge_pages));
+        run_benchmark("arena_random_reads_256mib_huge_pages", arena_random_reads_256mib, &huge_pages, PROBE_COUNT);
+    }
+}  // namespace psh::bench::allocators
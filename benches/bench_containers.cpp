@@ -0,0 +1,133 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Benchmarks for the containers.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <psh_memory.hpp>
+#include "bench_utils.hpp"
+
+namespace psh::bench::containers {
+    psh_global constexpr usize PUSH_COUNT = 100'000;
+    psh_global constexpr usize BIT_COUNT  = 1u << 20;
+
+    psh_internal void dynamic_array_push_i32(void* data, usize op_count) {
+        Arena* arena = reinterpret_cast<Arena*>(data);
+        arena_clear(arena);
+
+        DynamicArray<i32> darray = make_dynamic_array<i32>(arena);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            psh_discard_value(dynamic_array_push(&darray, static_cast<i32>(idx)));
+        }
+        do_not_optimize(darray.buf);
+    }
+
+    psh_internal void stable_array_push_i32(void* data, usize op_count) {
+        Arena* arena = reinterpret_cast<Arena*>(data);
+        arena_clear(arena);
+
+        StableArray<i32> sarray = make_stable_array<i32>(arena);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            do_not_optimize(stable_array_push(&sarray, static_cast<i32>(idx)));
+        }
+    }
+
+    struct SlotMapLookups {
+        SlotMap<u64>* map;
+        SlotHandle*   handles;
+    };
+
+    psh_internal void slot_map_find_u64(void* data, usize op_count) {
+        SlotMapLookups* lookups = reinterpret_cast<SlotMapLookups*>(data);
+
+        u64 sum = 0;
+        for (usize idx = 0; idx < op_count; ++idx) {
+            u64 const* value = slot_map_find(lookups->map, lookups->handles[idx]);
+            sum += (value != nullptr) ? *value : 0u;
+        }
+        do_not_optimize(sum);
+    }
+
+    struct BitArrayPair {
+        BitArray lhs;
+        BitArray rhs;
+    };
+
+    psh_internal void bit_array_and_count_ones(void* data, usize op_count) {
+        BitArrayPair* pair = reinterpret_cast<BitArrayPair*>(data);
+        psh_discard_value(op_count);
+
+        bit_array_and(&pair->lhs, &pair->rhs);
+        do_not_optimize(bit_array_count_ones(&pair->lhs));
+    }
+
+    psh_internal void bit_array_iterate_set_bits(void* data, usize op_count) {
+        BitArrayPair* pair = reinterpret_cast<BitArrayPair*>(data);
+        psh_discard_value(op_count);
+
+        usize sum = 0;
+        for (isize idx = bit_array_find_next(&pair->rhs, 0); idx != -1; idx = bit_array_find_next(&pair->rhs, static_cast<usize>(idx) + 1)) {
+            sum += static_cast<usize>(idx);
+        }
+        do_not_optimize(sum);
+    }
+
+    psh_internal void run_all() {
+        Arena arena = make_owned_arena(PUSH_COUNT * psh_usize_of(i32) * 4);
+        psh_defer(destroy_owned_arena(&arena));
+
+        Arena bit_arena = make_owned_arena(2 * BIT_COUNT / 8);
+        psh_defer(destroy_owned_arena(&bit_arena));
+
+        BitArrayPair pair = {
+            .lhs = make_bit_array(&bit_arena, BIT_COUNT),
+            .rhs = make_bit_array(&bit_arena, BIT_COUNT),
+        };
+        bit_array_fill(&pair.lhs, true);
+        // Scatter the dense order of the slot map with random removals and reinsertions.
+        Arena slot_arena = make_owned_arena(PUSH_COUNT * 32);
+        psh_defer(destroy_owned_arena(&slot_arena));
+
+        SlotMap<u64> map     = make_slot_map<u64>(&slot_arena, PUSH_COUNT);
+        SlotHandle*  handles = memory_alloc<SlotHandle>(&slot_arena, PUSH_COUNT);
+        for (usize idx = 0; idx < PUSH_COUNT; ++idx) {
+            handles[idx] = slot_map_insert(&map, static_cast<u64>(idx));
+        }
+
+        u32 seed = 0x2545F491;
+        for (usize idx = 0; idx < PUSH_COUNT / 2; ++idx) {
+            usize victim = random_u32(&seed) % PUSH_COUNT;
+            psh_discard_value(slot_map_remove(&map, handles[victim]));
+            handles[victim] = slot_map_insert(&map, static_cast<u64>(victim));
+        }
+        SlotMapLookups lookups = {.map = &map, .handles = handles};
+
+        for (usize idx = 0; idx < BIT_COUNT / 16; ++idx) {
+            bit_array_set(&pair.rhs, random_u32(&seed) % BIT_COUNT);
+        }
+
+        run_benchmark("dynamic_array_push_i32", dynamic_array_push_i32, &arena, PUSH_COUNT);
+        run_benchmark("stable_array_push_i32", stable_array_push_i32, &arena, PUSH_COUNT);
+        run_benchmark("slot_map_find_u64", slot_map_find_u64, &lookups, PUSH_COUNT);
+        run_benchmark("bit_array_and_count_ones", bit_array_and_count_ones, &pair, BIT_COUNT);
+        run_benchmark("bit_array_iterate_set_bits", bit_array_iterate_set_bits, &pair, BIT_COUNT / 16);
+    }
+}  // namespace psh::bench::containers
@@ -0,0 +1,57 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Benchmarks for the logging procedures.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <psh_debug.hpp>
+#include "bench_utils.hpp"
+
+namespace psh::bench::logging {
+    psh_global constexpr usize LOG_COUNT = 100'000;
+
+    /// Discard all messages, so that only the formatting of the messages is measured.
+    psh_internal void discard_log(void* context, impl::LogInfo const& info, char const* msg, usize length) {
+        psh_discard_value(context);
+        psh_discard_value(info);
+        do_not_optimize(msg[length - 1]);
+    }
+
+    psh_internal void log_fmt_discarded(void* data, usize op_count) {
+        psh_discard_value(data);
+
+        impl::LogInfo info = {
+            .file_name     = psh_source_file_name(),
+            .function_name = psh_source_function_name(),
+            .line          = psh_source_line_number(),
+            .level         = impl::LOG_LEVEL_INFO,
+        };
+        for (usize idx = 0; idx < op_count; ++idx) {
+            impl::log_fmt(info, "Request %zu served in %.3f ms with status %d.", idx, 1.25, 200);
+        }
+    }
+
+    psh_internal void run_all() {
+        set_log_writer(discard_log);
+        run_benchmark("log_fmt_discarded", log_fmt_discarded, nullptr, LOG_COUNT);
+        set_log_writer(nullptr);
+    }
+}  // namespace psh::bench::logging
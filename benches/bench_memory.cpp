@@ -0,0 +1,90 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+///
+/// Description: Benchmarks for the raw memory manipulation procedures.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <psh_memory.hpp>
+#include "bench_utils.hpp"
+
+namespace psh::bench::memory {
+    psh_global constexpr usize SMALL_COPY_COUNT = 100'000;
+    psh_global constexpr usize LARGE_SIZE       = psh_mebibytes(16);
+
+    struct Particle {
+        f32 position[3];
+        f32 velocity[3];
+        u32 flags;
+    };
+
+    struct CopyBuffers {
+        u8* src;
+        u8* dst;
+    };
+
+    psh_internal void memory_copy_28b(void* data, usize op_count) {
+        CopyBuffers* buffers = reinterpret_cast<CopyBuffers*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            usize offset = (idx % 1024) * psh_usize_of(Particle);
+            memory_copy(buffers->dst + offset, buffers->src + offset, psh_usize_of(Particle));
+        }
+        do_not_optimize(buffers->dst);
+    }
+
+    psh_internal void copy_struct_28b(void* data, usize op_count) {
+        CopyBuffers* buffers = reinterpret_cast<CopyBuffers*>(data);
+        Particle*    src     = reinterpret_cast<Particle*>(buffers->src);
+        Particle*    dst     = reinterpret_cast<Particle*>(buffers->dst);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            copy_struct(dst + (idx % 1024), src + (idx % 1024));
+        }
+        do_not_optimize(buffers->dst);
+    }
+
+    psh_internal void memory_copy_large(void* data, usize op_count) {
+        CopyBuffers* buffers = reinterpret_cast<CopyBuffers*>(data);
+        memory_copy(buffers->dst, buffers->src, op_count);
+        do_not_optimize(buffers->dst);
+    }
+
+    psh_internal void memory_set_large(void* data, usize op_count) {
+        CopyBuffers* buffers = reinterpret_cast<CopyBuffers*>(data);
+        memory_set(buffers->dst, op_count, 0x7F);
+        do_not_optimize(buffers->dst);
+    }
+
+    psh_internal void run_all() {
+        Arena arena = make_owned_arena(2 * LARGE_SIZE);
+        psh_defer(destroy_owned_arena(&arena));
+
+        CopyBuffers buffers = {
+            .src = memory_alloc<u8>(&arena, LARGE_SIZE),
+            .dst = memory_alloc<u8>(&arena, LARGE_SIZE),
+        };
+        memory_set(buffers.src, LARGE_SIZE, 1);
+
+        run_benchmark("memory_copy_28b", memory_copy_28b, &buffers, SMALL_COPY_COUNT);
+        run_benchmark("copy_struct_28b", copy_struct_28b, &buffers, SMALL_COPY_COUNT);
+        run_benchmark("memory_copy_16mib", memory_copy_large, &buffers, LARGE_SIZE);
+        run_benchmark("memory_set_16mib", memory_set_large, &buffers, LARGE_SIZE);
+    }
+}  // namespace psh::bench::memory
@@ -0,0 +1,103 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Benchmarks for the networking module.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+
+#include <stdio.h>
+#include <psh_memory.hpp>
+#include <psh_net.hpp>
+#include "bench_utils.hpp"
+
+namespace psh::bench::net {
+    psh_global constexpr u32   DATAGRAM_BATCH_SIZE = 32;
+    psh_global constexpr usize DATAGRAM_SIZE       = 64;
+    psh_global constexpr usize DATAGRAM_COUNT      = 32 * 1024;
+
+    /// Pair of UDP sockets on the loopback interface, with the datagrams exchanged between them.
+    struct UdpExchange {
+        Socket                                     sender;
+        Socket                                     receiver;
+        Buffer<NetDatagram, DATAGRAM_BATCH_SIZE> outgoing;
+        Buffer<NetDatagram, DATAGRAM_BATCH_SIZE> incoming;
+    };
+
+    /// Exchange the datagrams in batches of a given size, each batch being a single call.
+    psh_internal void udp_exchange(void* data, usize op_count, u32 batch_size) {
+        UdpExchange* exchange = reinterpret_cast<UdpExchange*>(data);
+        for (usize idx = 0; idx < op_count; idx += DATAGRAM_BATCH_SIZE) {
+            for (u32 batch_idx = 0; batch_idx < DATAGRAM_BATCH_SIZE; batch_idx += batch_size) {
+                psh_discard_value(net_udp_send_batch(&exchange->sender, FatPtr<NetDatagram const>{&exchange->outgoing[batch_idx], batch_size}));
+            }
+
+            // Loopback datagrams are delivered as they are sent.
+            u32 received_count = 0;
+            while (received_count < DATAGRAM_BATCH_SIZE) {
+                NetBatchResult result = net_udp_receive_batch(&exchange->receiver, FatPtr<NetDatagram>{&exchange->incoming[received_count], batch_size});
+                if (result.status != NET_STATUS_OK) {
+                    break;
+                }
+                received_count += result.count;
+            }
+            do_not_optimize(received_count);
+        }
+    }
+
+    psh_internal void udp_exchange_batched(void* data, usize op_count) {
+        udp_exchange(data, op_count, DATAGRAM_BATCH_SIZE);
+    }
+
+    psh_internal void udp_exchange_one_by_one(void* data, usize op_count) {
+        udp_exchange(data, op_count, 1);
+    }
+
+    psh_internal void run_all() {
+        if (!init_net()) {
+            fprintf(stderr, "[BENCH] Unable to initialise the network, skipping the networking benchmarks.\n");
+            return;
+        }
+        psh_defer(destroy_net());
+
+        NetAddress  any_port = make_net_address_ipv4(127, 0, 0, 1, 0);
+        UdpExchange exchange;
+        if (!net_udp_open(&exchange.sender, &any_port) || !net_udp_open(&exchange.receiver, &any_port)) {
+            fprintf(stderr, "[BENCH] Unable to open UDP sockets, skipping the networking benchmarks.\n");
+            net_close(&exchange.sender);
+            return;
+        }
+        psh_defer(net_close(&exchange.sender));
+        psh_defer(net_close(&exchange.receiver));
+
+        NetAddress receiver_address;
+        psh_discard_value(net_local_address(&exchange.receiver, &receiver_address));
+
+        Buffer<u8, DATAGRAM_BATCH_SIZE * DATAGRAM_SIZE> payloads;
+        Buffer<u8, DATAGRAM_BATCH_SIZE * DATAGRAM_SIZE> storage;
+        for (usize idx = 0; idx < DATAGRAM_BATCH_SIZE; ++idx) {
+            exchange.outgoing[idx] = NetDatagram{.buf = &payloads[idx * DATAGRAM_SIZE], .count = DATAGRAM_SIZE, .address = receiver_address};
+            exchange.incoming[idx] = NetDatagram{.buf = &storage[idx * DATAGRAM_SIZE], .capacity = DATAGRAM_SIZE};
+        }
+
+        run_benchmark("udp_exchange_batched_64b", udp_exchange_batched, &exchange, DATAGRAM_COUNT);
+        run_benchmark("udp_exchange_one_by_one_64b", udp_exchange_one_by_one, &exchange, DATAGRAM_COUNT);
+    }
+}  // namespace psh::bench::net
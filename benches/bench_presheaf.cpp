@@ -0,0 +1,69 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Single compilation unit containing all Presheaf library benchmarks.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+///
+/// The results are written to the standard output, one JSON object per line, and can be
+/// redirected to a file to be compared across versions of the library:
+///
+///     lua build.lua -bench > bench_results.jsonl
+
+// -------------------------------------------------------------------------------------------------
+// Single compilation unit comprising the whole library implementation.
+// -------------------------------------------------------------------------------------------------
+
+#include "../src/presheaf_impl.cpp"
+
+// -------------------------------------------------------------------------------------------------
+// Invoke all benchmarks.
+// -------------------------------------------------------------------------------------------------
+
+// clang-format off
+#include "bench_allocators.cpp"
+#include "bench_memory.cpp"
+#include "bench_containers.cpp"
+#include "bench_algorithms.cpp"
+#include "bench_string.cpp"
+#include "bench_streams.cpp"
+#include "bench_serialize.cpp"
+#include "bench_net.cpp"
+#include "bench_logging.cpp"
+#include "bench_vec.cpp"
+#include "bench_thread.cpp"
+#include "bench_profile.cpp"
+// clang-format on
+
+int main() {
+    psh::bench::allocators::run_all();
+    psh::bench::memory::run_all();
+    psh::bench::containers::run_all();
+    psh::bench::algorithms::run_all();
+    psh::bench::string::run_all();
+    psh::bench::streams::run_all();
+    psh::bench::serialize::run_all();
+    psh::bench::net::run_all();
+    psh::bench::logging::run_all();
+    psh::bench::vec::run_all();
+    psh::bench::thread::run_all();
+    psh::bench::profile::run_all();
+    return 0;
+}
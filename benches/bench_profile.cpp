@@ -0,0 +1,60 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+///
+/// Description: Benchmarks for the profiling zones.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <psh_memory.hpp>
+#include <psh_profile.hpp>
+#include "bench_utils.hpp"
+
+namespace psh::bench::profile {
+    psh_global constexpr usize ZONE_COUNT = 100'000;
+
+    /// Open and close a zone, measuring the overhead of the instrumentation itself.
+    psh_internal void profile_zone(void* data, usize op_count) {
+        psh_discard_value(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            profile_zone_end(profile_zone_begin("bench_zone"));
+        }
+    }
+
+    /// Read the timestamp counter twice, the floor of the cost of a zone.
+    psh_internal void timestamp_counter_pair(void* data, usize op_count) {
+        psh_discard_value(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            u64 begin = cpu_timestamp_counter();
+            do_not_optimize(cpu_timestamp_counter() - begin);
+        }
+    }
+
+    psh_internal void run_all() {
+        Arena arena = make_owned_arena(psh_mebibytes(4));
+        psh_assert(profile_register_thread(&arena, PROFILE_DEFAULT_EVENT_CAPACITY, "bench"));
+
+        run_benchmark("timestamp_counter_pair", timestamp_counter_pair, nullptr, ZONE_COUNT);
+        run_benchmark("profile_zone", profile_zone, nullptr, ZONE_COUNT);
+
+        // The arena stays alive since the thread remains registered with the profiler.
+        profile_clear_thread();
+    }
+}  // namespace psh::bench::profile
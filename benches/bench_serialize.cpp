@@ -0,0 +1,108 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+///
+/// Description: Benchmarks for the serialization of containers.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <stdio.h>
+#include <psh_memory.hpp>
+#include <psh_serialize.hpp>
+#include "bench_utils.hpp"
+
+namespace psh::bench::serialize {
+    psh_global constexpr usize   TABLE_ELEMENT_COUNT = 1'000'000;
+    psh_global constexpr usize   LOAD_COUNT          = 16;
+    psh_global constexpr cstring TABLE_FILE_PATH     = "presheaf_bench_serialize.bin";
+
+    struct TableBenchData {
+        Arena*            arena;
+        Array<u32> const* keys;
+    };
+
+    /// Rebuild the hash map from its keys, as done by a cold start.
+    psh_internal void hash_map_rebuild_1m(void* data, usize op_count) {
+        TableBenchData* bench = reinterpret_cast<TableBenchData*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            ArenaCheckpoint checkpoint = make_arena_checkpoint(bench->arena);
+
+            HashMap<u32, u32> map = make_hash_map<u32, u32>(bench->arena, TABLE_ELEMENT_COUNT);
+            for (usize key_idx = 0; key_idx < bench->keys->count; ++key_idx) {
+                psh_discard_value(hash_map_insert(&map, bench->keys->buf[key_idx], static_cast<u32>(key_idx)));
+            }
+            do_not_optimize(hash_map_find(&map, bench->keys->buf[0]));
+
+            arena_checkpoint_restore(checkpoint);
+        }
+    }
+
+    /// Load the hash map from the serialized file and make a single lookup, as done by a warm start.
+    psh_internal void serial_hash_map_load_1m(void* data, usize op_count) {
+        TableBenchData* bench = reinterpret_cast<TableBenchData*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            SerialFile file;
+            psh_assert(open_serial_file(&file, TABLE_FILE_PATH) == SERIAL_STATUS_OK);
+
+            HashMap<u32, u32> map;
+            psh_assert(serial_file_get_hash_map(&file, make_string("table"), &map));
+            HashMap<u32, u32> const* view = &map;
+            do_not_optimize(hash_map_find(view, bench->keys->buf[0]));
+
+            close_serial_file(&file);
+        }
+    }
+
+    psh_internal void run_all() {
+        Arena arena = make_owned_arena(psh_mebibytes(128));
+        psh_defer(destroy_owned_arena(&arena));
+
+        Array<u32> keys  = make_array_uninit<u32>(&arena, TABLE_ELEMENT_COUNT);
+        u32        state = 0x12345678u;
+        for (usize idx = 0; idx < keys.count; ++idx) {
+            keys[idx] = random_u32(&state);
+        }
+
+        // Create the file loaded by the benchmark.
+        {
+            ArenaCheckpoint checkpoint = make_arena_checkpoint(&arena);
+
+            HashMap<u32, u32> map = make_hash_map<u32, u32>(&arena, TABLE_ELEMENT_COUNT);
+            for (usize idx = 0; idx < keys.count; ++idx) {
+                psh_discard_value(hash_map_insert(&map, keys[idx], static_cast<u32>(idx)));
+            }
+
+            SerialWriter writer;
+            init_serial_writer(&writer, &arena);
+            serial_writer_add_hash_map(&writer, make_string("table"), &map);
+            if (write_serial_file(&writer, &arena, TABLE_FILE_PATH) != SERIAL_STATUS_OK) {
+                fprintf(stderr, "[BENCH] Unable to create %s, skipping the serialization benchmarks.\n", TABLE_FILE_PATH);
+                return;
+            }
+
+            arena_checkpoint_restore(checkpoint);
+        }
+        psh_defer(psh_discard_value(remove(TABLE_FILE_PATH)));
+
+        TableBenchData data = {.arena = &arena, .keys = &keys};
+        run_benchmark("hash_map_rebuild_1m", hash_map_rebuild_1m, &data, LOAD_COUNT);
+        run_benchmark("serial_hash_map_load_1m", serial_hash_map_load_1m, &data, LOAD_COUNT);
+    }
+}  // namespace psh::bench::serialize
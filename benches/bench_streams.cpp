@@ -0,0 +1,71 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Benchmarks for the file streams.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <stdio.h>
+#include <psh_memory.hpp>
+#include <psh_streams.hpp>
+#include "bench_utils.hpp"
+
+namespace psh::bench::streams {
+    psh_global constexpr usize   READ_FILE_SIZE  = psh_mebibytes(1);
+    psh_global constexpr usize   READ_FILE_COUNT = 16;
+    psh_global constexpr cstring READ_FILE_PATH  = "presheaf_bench_read_file.bin";
+
+    /// Read the whole file into the arena, each operation accounts for one read.
+    psh_internal void read_file_1mib(void* data, usize op_count) {
+        Arena* arena = reinterpret_cast<Arena*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            arena_clear(arena);
+            FileReadResult result = read_file(arena, READ_FILE_PATH);
+            psh_assert(result.status == FILE_STATUS_OK);
+            do_not_optimize(result.content.buf);
+        }
+    }
+
+    psh_internal void run_all() {
+        Arena arena = make_owned_arena(2 * READ_FILE_SIZE);
+        psh_defer(destroy_owned_arena(&arena));
+
+        // Create the file read by the benchmark.
+        {
+            FileWriter writer;
+            if (open_file_writer(&writer, &arena, READ_FILE_PATH) != FILE_STATUS_OK) {
+                fprintf(stderr, "[BENCH] Unable to create %s, skipping the file benchmarks.\n", READ_FILE_PATH);
+                return;
+            }
+
+            u8* contents = memory_alloc_uninit<u8>(&arena, READ_FILE_SIZE);
+            u32 state    = 0x12345678u;
+            for (usize idx = 0; idx < READ_FILE_SIZE; ++idx) {
+                contents[idx] = static_cast<u8>(random_u32(&state));
+            }
+            psh_discard_value(file_writer_write(&writer, FatPtr<u8 const>{contents, READ_FILE_SIZE}));
+            psh_discard_value(close_file_writer(&writer));
+        }
+        psh_defer(psh_discard_value(remove(READ_FILE_PATH)));
+
+        arena_clear(&arena);
+        run_benchmark("read_file_1mib", read_file_1mib, &arena, READ_FILE_COUNT);
+    }
+}  // namespace psh::bench::streams
@@ -0,0 +1,269 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Benchmarks for the string procedures.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <psh_memory.hpp>
+#include <psh_string.hpp>
+#include <stdlib.h>
+#include "bench_utils.hpp"
+
+namespace psh::bench::string {
+    psh_global constexpr usize STRING_LENGTH       = 1024;
+    psh_global constexpr usize COMPARISON_COUNT    = 100'000;
+    psh_global constexpr usize NUMBER_COUNT        = 4096;
+    psh_global constexpr usize TEXT_LENGTH         = 64 * 1024;
+    psh_global constexpr usize TEXT_PASS_COUNT     = 2000;
+    psh_global constexpr usize HEADER_STREAM_COUNT = 1024;
+
+    /// Zero-terminated decimal representations of numbers, as found in CSV columns.
+    struct NumberColumn {
+        String* integers;
+        String* floats;
+        f64*    values;
+    };
+
+    struct Transcoding {
+        String text;
+        Arena* arena;
+    };
+
+    struct StringPair {
+        String lhs;
+        String rhs;
+    };
+
+    psh_global constexpr String HEADER_NAMES[] = {
+        psh_comptime_make_string("Accept"),
+        psh_comptime_make_string("Accept-Encoding"),
+        psh_comptime_make_string("Authorization"),
+        psh_comptime_make_string("Cache-Control"),
+        psh_comptime_make_string("Connection"),
+        psh_comptime_make_string("Content-Length"),
+        psh_comptime_make_string("Content-Type"),
+        psh_comptime_make_string("Cookie"),
+        psh_comptime_make_string("Host"),
+        psh_comptime_make_string("User-Agent"),
+    };
+    psh_global constexpr StaticStringTable<count_of(HEADER_NAMES)> HEADER_TABLE = make_static_string_table(HEADER_NAMES);
+
+    /// Header names to be dispatched on, where one in each four isn't a known header.
+    struct HeaderStream {
+        String* names;
+    };
+
+    psh_internal void string_equal_1kib(void* data, usize op_count) {
+        StringPair* pair = reinterpret_cast<StringPair*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            do_not_optimize(string_equal(pair->lhs, pair->rhs));
+        }
+    }
+
+    psh_internal void static_string_table_find_headers(void* data, usize op_count) {
+        HeaderStream* stream = reinterpret_cast<HeaderStream*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            do_not_optimize(static_string_table_find(&HEADER_TABLE, stream->names[idx % HEADER_STREAM_COUNT]));
+        }
+    }
+
+    psh_internal void string_equal_chain_headers(void* data, usize op_count) {
+        HeaderStream* stream = reinterpret_cast<HeaderStream*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            String name  = stream->names[idx % HEADER_STREAM_COUNT];
+            isize  found = -1;
+            for (usize key = 0; key < count_of(HEADER_NAMES); ++key) {
+                if (string_equal(name, HEADER_NAMES[key])) {
+                    found = static_cast<isize>(key);
+                    break;
+                }
+            }
+            do_not_optimize(found);
+        }
+    }
+
+    psh_internal void string_builder_append_fmt(void* data, usize op_count) {
+        Arena* arena = reinterpret_cast<Arena*>(data);
+        arena_clear(arena);
+
+        StringBuilder builder = make_string_builder(arena);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            psh_discard_value(string_builder_append_fmt(&builder, "{\"id\": %zu, \"value\": %.3f}", idx, 0.5));
+        }
+        do_not_optimize(builder.buf);
+    }
+
+    psh_internal void string_to_u64_column(void* data, usize op_count) {
+        NumberColumn* column = reinterpret_cast<NumberColumn*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            u64 value;
+            psh_discard_value(string_to_u64(column->integers[idx % NUMBER_COUNT], &value));
+            do_not_optimize(value);
+        }
+    }
+
+    psh_internal void strtoull_column(void* data, usize op_count) {
+        NumberColumn* column = reinterpret_cast<NumberColumn*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            do_not_optimize(strtoull(column->integers[idx % NUMBER_COUNT].buf, nullptr, 10));
+        }
+    }
+
+    psh_internal void string_to_f64_column(void* data, usize op_count) {
+        NumberColumn* column = reinterpret_cast<NumberColumn*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            f64 value;
+            psh_discard_value(string_to_f64(column->floats[idx % NUMBER_COUNT], &value));
+            do_not_optimize(value);
+        }
+    }
+
+    psh_internal void strtod_column(void* data, usize op_count) {
+        NumberColumn* column = reinterpret_cast<NumberColumn*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            do_not_optimize(strtod(column->floats[idx % NUMBER_COUNT].buf, nullptr));
+        }
+    }
+
+    psh_internal void format_f64_shortest_column(void* data, usize op_count) {
+        NumberColumn* column = reinterpret_cast<NumberColumn*>(data);
+        char          buf[FORMAT_FLOAT_SHORTEST_MAX_LENGTH];
+        for (usize idx = 0; idx < op_count; ++idx) {
+            do_not_optimize(format_f64_shortest(buf, column->values[idx % NUMBER_COUNT]));
+        }
+    }
+
+    psh_internal void string_format_f64_column(void* data, usize op_count) {
+        NumberColumn* column = reinterpret_cast<NumberColumn*>(data);
+        char          buf[32];
+        for (usize idx = 0; idx < op_count; ++idx) {
+            do_not_optimize(string_format(buf, static_cast<i32>(sizeof(buf)), "%.17g", column->values[idx % NUMBER_COUNT]));
+        }
+    }
+
+    psh_internal void utf8_is_valid_64kib(void* data, usize op_count) {
+        String* text = reinterpret_cast<String*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            do_not_optimize(utf8_is_valid(*text));
+        }
+    }
+
+    psh_internal void utf8_decode_next_64kib(void* data, usize op_count) {
+        String* text = reinterpret_cast<String*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            String remaining = *text;
+            u32    codepoint;
+            while (utf8_decode_next(&remaining, &codepoint)) {
+                do_not_optimize(codepoint);
+            }
+        }
+    }
+
+    psh_internal void utf8_to_utf16_64kib(void* data, usize op_count) {
+        Transcoding* transcoding = reinterpret_cast<Transcoding*>(data);
+        for (usize idx = 0; idx < op_count; ++idx) {
+            ArenaCheckpoint checkpoint = make_arena_checkpoint(transcoding->arena);
+            do_not_optimize(utf8_to_utf16(transcoding->arena, transcoding->text).buf);
+            arena_checkpoint_restore(checkpoint);
+        }
+    }
+
+    psh_internal void run_all() {
+        Arena arena = make_owned_arena(psh_mebibytes(16));
+        psh_defer(destroy_owned_arena(&arena));
+
+        // Equal strings at distinct addresses, so that the whole strings are compared.
+        char* lhs = memory_alloc_uninit<char>(&arena, STRING_LENGTH);
+        char* rhs = memory_alloc_uninit<char>(&arena, STRING_LENGTH);
+        for (usize idx = 0; idx < STRING_LENGTH; ++idx) {
+            lhs[idx] = static_cast<char>('a' + idx % 26u);
+            rhs[idx] = lhs[idx];
+        }
+
+        StringPair pair = {.lhs = String{lhs, STRING_LENGTH}, .rhs = String{rhs, STRING_LENGTH}};
+        run_benchmark("string_equal_1kib", string_equal_1kib, &pair, COMPARISON_COUNT);
+
+        HeaderStream headers = {.names = memory_alloc<String>(&arena, HEADER_STREAM_COUNT)};
+        for (usize idx = 0; idx < HEADER_STREAM_COUNT; ++idx) {
+            headers.names[idx] = ((idx % 4u) == 3u) ? psh_comptime_make_string("X-Request-Id")
+                                                    : HEADER_NAMES[(idx * 7u) % count_of(HEADER_NAMES)];
+        }
+        run_benchmark("static_string_table_find", static_string_table_find_headers, &headers, COMPARISON_COUNT);
+        run_benchmark("string_equal_chain", string_equal_chain_headers, &headers, COMPARISON_COUNT);
+
+        Arena builder_arena = make_sub_arena(&arena, psh_mebibytes(8));
+        run_benchmark("string_builder_append_fmt", string_builder_append_fmt, &builder_arena, COMPARISON_COUNT);
+
+        // Integers of varied lengths and floats with the shortest representation of random values.
+        NumberColumn column = {
+            .integers = memory_alloc<String>(&arena, NUMBER_COUNT),
+            .floats   = memory_alloc<String>(&arena, NUMBER_COUNT),
+            .values   = memory_alloc<f64>(&arena, NUMBER_COUNT),
+        };
+        u64 state = 0x9E3779B97F4A7C15ull;
+        for (usize idx = 0; idx < NUMBER_COUNT; ++idx) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+
+            char* integer        = memory_alloc<char>(&arena, FORMAT_INTEGER_MAX_LENGTH + 1);
+            column.integers[idx] = String{integer, format_u64(integer, state >> (state % 64u))};
+            column.values[idx]   = static_cast<f64>(state >> 11) / static_cast<f64>(1u << (state % 32u));
+
+            char* float_text   = memory_alloc<char>(&arena, FORMAT_FLOAT_SHORTEST_MAX_LENGTH + 1);
+            column.floats[idx] = String{float_text, format_f64_shortest(float_text, column.values[idx])};
+        }
+
+        run_benchmark("string_to_u64", string_to_u64_column, &column, COMPARISON_COUNT);
+        run_benchmark("strtoull", strtoull_column, &column, COMPARISON_COUNT);
+        run_benchmark("string_to_f64", string_to_f64_column, &column, COMPARISON_COUNT);
+        run_benchmark("strtod", strtod_column, &column, COMPARISON_COUNT);
+        run_benchmark("format_f64_shortest", format_f64_shortest_column, &column, COMPARISON_COUNT);
+        run_benchmark("string_format_f64_17g", string_format_f64_column, &column, COMPARISON_COUNT);
+
+        // Mostly ASCII text interspersed with accented letters, symbols and emojis, as in user input.
+        char* text = memory_alloc_uninit<char>(&arena, TEXT_LENGTH);
+        for (usize idx = 0; idx < TEXT_LENGTH;) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+
+            u32 const kind      = static_cast<u32>((state >> 33) % 16u);
+            u32 const codepoint = (kind == 0)   ? 0xE9
+                                  : (kind == 1) ? 0x20AC
+                                  : (kind == 2) ? 0x1F333
+                                                : 'a' + static_cast<u32>((state >> 40) % 26u);
+
+            char  encoded[UTF8_MAX_ENCODED_LENGTH];
+            usize length = utf8_encode(encoded, codepoint);
+            if (idx + length > TEXT_LENGTH) {
+                encoded[0] = ' ';
+                length     = 1;
+            }
+            memory_copy(reinterpret_cast<u8*>(text + idx), reinterpret_cast<u8 const*>(encoded), length);
+            idx += length;
+        }
+
+        String mixed_text = String{text, TEXT_LENGTH};
+        run_benchmark("utf8_is_valid_64kib", utf8_is_valid_64kib, &mixed_text, TEXT_PASS_COUNT);
+        run_benchmark("utf8_decode_next_64kib", utf8_decode_next_64kib, &mixed_text, TEXT_PASS_COUNT);
+
+        Arena       units_arena = make_sub_arena(&arena, psh_mebibytes(1));
+        Transcoding transcoding = {.text = mixed_text, .arena = &units_arena};
+        run_benchmark("utf8_to_utf16_64kib", utf8_to_utf16_64kib, &transcoding, TEXT_PASS_COUNT);
+    }
+}  // namespace psh::bench::string
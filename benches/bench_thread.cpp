@@ -0,0 +1,67 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+///
+/// Description: Benchmarks for the lock-free queues.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <psh_memory.hpp>
+#include <psh_thread.hpp>
+#include "bench_utils.hpp"
+
+namespace psh::bench::thread {
+    psh_global constexpr usize QUEUE_CAPACITY = 1024;
+    psh_global constexpr usize QUEUE_OP_COUNT = 100'000;
+
+    /// Push and immediately pop each element, measuring the uncontended cost of a hand-off.
+    psh_internal void spsc_queue_push_pop_u64(void* data, usize op_count) {
+        SpscQueue<u64>* queue = reinterpret_cast<SpscQueue<u64>*>(data);
+        u64             value = 0;
+        for (usize idx = 0; idx < op_count; ++idx) {
+            psh_discard_value(spsc_queue_push(queue, static_cast<u64>(idx)));
+            psh_discard_value(spsc_queue_pop(queue, &value));
+        }
+        do_not_optimize(value);
+    }
+
+    psh_internal void mpmc_queue_push_pop_u64(void* data, usize op_count) {
+        MpmcQueue<u64>* queue = reinterpret_cast<MpmcQueue<u64>*>(data);
+        u64             value = 0;
+        for (usize idx = 0; idx < op_count; ++idx) {
+            psh_discard_value(mpmc_queue_push(queue, static_cast<u64>(idx)));
+            psh_discard_value(mpmc_queue_pop(queue, &value));
+        }
+        do_not_optimize(value);
+    }
+
+    psh_internal void run_all() {
+        Arena arena = make_owned_arena(psh_kibibytes(64));
+        psh_defer(destroy_owned_arena(&arena));
+
+        SpscQueue<u64> spsc_queue;
+        MpmcQueue<u64> mpmc_queue;
+        psh_assert(init_spsc_queue(&spsc_queue, &arena, QUEUE_CAPACITY));
+        psh_assert(init_mpmc_queue(&mpmc_queue, &arena, QUEUE_CAPACITY));
+
+        run_benchmark("spsc_queue_push_pop_u64", spsc_queue_push_pop_u64, &spsc_queue, QUEUE_OP_COUNT);
+        run_benchmark("mpmc_queue_push_pop_u64", mpmc_queue_push_pop_u64, &mpmc_queue, QUEUE_OP_COUNT);
+    }
+}  // namespace psh::bench::thread
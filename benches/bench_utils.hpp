@@ -0,0 +1,141 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Timing harness shared by all benchmarks.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+///
+/// Each benchmark runs a procedure performing a given number of operations: a few warmup runs are
+/// discarded, then each repetition is timed with both the monotonic clock and the timestamp counter
+/// of the processor. Results are printed to the standard output as one JSON object per line, and
+/// progress information goes to the standard error stream.
+
+#pragma once
+
+#include <stdio.h>
+#include <psh_algorithms.hpp>
+#include <psh_core.hpp>
+#include <psh_platform.hpp>
+#include <psh_time.hpp>
+
+#if PSH_COMPILER_MSVC && !PSH_COMPILER_CLANG
+#    include <intrin.h>
+#endif
+
+namespace psh::bench {
+    psh_global constexpr u32 BENCH_MAX_REPETITION_COUNT     = 256;
+    psh_global constexpr u32 BENCH_DEFAULT_WARMUP_COUNT     = 3;
+    psh_global constexpr u32 BENCH_DEFAULT_REPETITION_COUNT = 31;
+
+    /// Procedure running a given number of operations of a benchmark.
+    using BenchProc = void(void* data, usize op_count);
+
+    struct BenchOptions {
+        u32 warmup_count     = BENCH_DEFAULT_WARMUP_COUNT;
+        u32 repetition_count = BENCH_DEFAULT_REPETITION_COUNT;
+    };
+
+    /// Prevent the compiler from discarding the computation of a value.
+    template <typename T>
+    psh_proc psh_inline void do_not_optimize(T const& value) psh_no_except {
+#if PSH_COMPILER_MSVC && !PSH_COMPILER_CLANG
+        // Force the value to be materialised in memory.
+        char const volatile* bytes = reinterpret_cast<char const volatile*>(&value);
+        psh_discard_value(*bytes);
+        _ReadWriteBarrier();
+#else
+        __asm__ __volatile__("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    /// Pseudo-random number generator for the benchmark inputs (xorshift32).
+    psh_proc psh_inline u32 random_u32(u32* state) psh_no_except {
+        u32 x   = *state;
+        x      ^= x << 13u;
+        x      ^= x >> 17u;
+        x      ^= x << 5u;
+        *state  = x;
+        return x;
+    }
+
+    /// Get the value at a given percentile of a sorted list of samples.
+    psh_proc psh_inline f64 sorted_percentile(f64 const* samples, u32 count, f64 percentile) psh_no_except {
+        u32 idx = static_cast<u32>(percentile * static_cast<f64>(count - 1u) + 0.5);
+        return samples[psh_min_value(idx, count - 1u)];
+    }
+
+    /// Run and time a benchmark, printing its results.
+    ///
+    /// Parameters:
+    ///     * name: Identifier of the benchmark in the output.
+    ///     * proc: Procedure running the operations.
+    ///     * data: Data passed to the procedure.
+    ///     * op_count: Number of operations executed by each run of the procedure.
+    psh_proc void run_benchmark(
+        cstring      name,
+        BenchProc*   proc,
+        void*        data,
+        usize        op_count,
+        BenchOptions options = {}) psh_no_except {
+        psh_assert_msg(
+            (options.repetition_count != 0) && (options.repetition_count <= BENCH_MAX_REPETITION_COUNT),
+            "Invalid repetition count.");
+
+        for (u32 idx = 0; idx < options.warmup_count; ++idx) {
+            proc(data, op_count);
+        }
+
+        f64 ns_per_op[BENCH_MAX_REPETITION_COUNT];
+        f64 ticks_per_op[BENCH_MAX_REPETITION_COUNT];
+        for (u32 idx = 0; idx < options.repetition_count; ++idx) {
+            f64 start_time  = current_time_in_seconds();
+            u64 start_ticks = cpu_timestamp_counter();
+
+            proc(data, op_count);
+
+            u64 end_ticks = cpu_timestamp_counter();
+            f64 end_time  = current_time_in_seconds();
+
+            ns_per_op[idx]    = (end_time - start_time) * 1e9 / static_cast<f64>(op_count);
+            ticks_per_op[idx] = static_cast<f64>(end_ticks - start_ticks) / static_cast<f64>(op_count);
+        }
+
+        u32 count = options.repetition_count;
+        insertion_sort(FatPtr<f64>{ns_per_op, count});
+        insertion_sort(FatPtr<f64>{ticks_per_op, count});
+
+        printf(
+            "{\"benchmark\": \"%s\", \"ops\": %zu, \"repetitions\": %u, "
+            "\"ns_per_op\": {\"min\": %.3f, \"median\": %.3f, \"p99\": %.3f}, "
+            "\"ticks_per_op\": {\"min\": %.3f, \"median\": %.3f, \"p99\": %.3f}}\n",
+            name,
+            op_count,
+            count,
+            ns_per_op[0],
+            sorted_percentile(ns_per_op, count, 0.5),
+            sorted_percentile(ns_per_op, count, 0.99),
+            ticks_per_op[0],
+            sorted_percentile(ticks_per_op, count, 0.5),
+            sorted_percentile(ticks_per_op, count, 0.99));
+        fflush(stdout);
+
+        fprintf(stderr, "[BENCH] %-40s %10.3f ns/op (median)\n", name, sorted_percentile(ns_per_op, count, 0.5));
+    }
+}  // namespace psh::bench
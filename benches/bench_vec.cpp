@@ -0,0 +1,86 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Benchmarks for the linear algebra procedures.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <psh_memory.hpp>
+#include <psh_vec.hpp>
+#include "bench_utils.hpp"
+
+namespace psh::bench::vec {
+    psh_global constexpr usize MAT_MUL_COUNT = 100'000;
+    psh_global constexpr usize VECTOR_COUNT  = 4096;
+
+    struct MatMulData {
+        ColMat4 lhs;
+        ColMat4 rhs;
+    };
+
+    psh_internal void mat_mul_colmat4(void* data, usize op_count) {
+        MatMulData* mat_data = reinterpret_cast<MatMulData*>(data);
+        ColMat4     acc      = mat_data->lhs;
+        for (usize idx = 0; idx < op_count; ++idx) {
+            acc = mat_mul(acc, mat_data->rhs);
+        }
+        do_not_optimize(acc);
+    }
+
+    struct VectorBatchData {
+        ColMat4           m;
+        FatPtr<Vec4 const> in;
+        FatPtr<Vec4>      out;
+    };
+
+    /// Transform a batch of vectors, each operation accounts for one vector.
+    psh_internal void mat_mul_vec4_batch(void* data, usize op_count) {
+        VectorBatchData* batch = reinterpret_cast<VectorBatchData*>(data);
+        psh_discard_value(op_count);
+        mat_mul(batch->out, batch->m, batch->in);
+        do_not_optimize(batch->out.buf[0]);
+    }
+
+    psh_internal void run_all() {
+        // Rotation-like matrices keep the accumulated product bounded.
+        MatMulData mat_data = {.lhs = ColMat4::id(), .rhs = ColMat4::id()};
+        mat_data.rhs.at(0, 0) = 0.6f;
+        mat_data.rhs.at(0, 1) = -0.8f;
+        mat_data.rhs.at(1, 0) = 0.8f;
+        mat_data.rhs.at(1, 1) = 0.6f;
+        run_benchmark("mat_mul_colmat4", mat_mul_colmat4, &mat_data, MAT_MUL_COUNT);
+
+        Arena arena = make_owned_arena(2 * VECTOR_COUNT * psh_usize_of(Vec4));
+        psh_defer(destroy_owned_arena(&arena));
+
+        Vec4* in = memory_alloc_uninit<Vec4>(&arena, VECTOR_COUNT);
+        for (usize idx = 0; idx < VECTOR_COUNT; ++idx) {
+            f32 value = static_cast<f32>(idx);
+            in[idx]   = Vec4{value, value + 1.0f, value + 2.0f, 1.0f};
+        }
+
+        VectorBatchData batch = {
+            .m   = mat_data.rhs,
+            .in  = FatPtr<Vec4 const>{in, VECTOR_COUNT},
+            .out = FatPtr<Vec4>{memory_alloc_uninit<Vec4>(&arena, VECTOR_COUNT), VECTOR_COUNT},
+        };
+        run_benchmark("mat_mul_vec4_batch", mat_mul_vec4_batch, &batch, VECTOR_COUNT);
+    }
+}  // namespace psh::bench::vec
@@ -42,6 +42,8 @@ local options = {
     release = { on = false, description = "Release build type (on by default)." },
     debug   = { on = false, description = "Debug build type (off by default)." },
     test    = { on = false, description = "Build and run tests." },
+    bench   = { on = false, description = "Build and run benchmarks, results are printed as JSON lines." },
+    tools   = { on = false, description = "Build the command line tools, such as the binary log decoder." },
     fmt     = { on = false, description = "Format source files with clang-format before building." },
     clang   = {
         on = false,
@@ -222,7 +224,7 @@ local compilers = {
         opt_no_link   = "-c",
         opt_out_obj   = "-o",
         opt_out_exe   = "-o",
-        flags_common  = "-pedantic -Wall -Wextra -Wpedantic -Wuninitialized -Wcast-align -Wconversion -Wnull-pointer-arithmetic -Wnull-dereference -Wformat=2 -Wpointer-arith -Wno-unsafe-buffer-usage -Wno-switch-default -fno-rtti -fno-exceptions -Werror=implicit-function-declaration",
+        flags_common  = "-pedantic -Wall -Wextra -Wpedantic -Wuninitialized -Wcast-align -Wconversion -Wnull-pointer-arithmetic -Wnull-dereference -Wformat=2 -Wpointer-arith -Wno-unsafe-buffer-usage -Wno-switch-default -fno-rtti -fno-exceptions -pthread -Werror=implicit-function-declaration",
         flags_debug   = "-Werror -Wno-unused-variable -Werror -g -O0 -fsanitize=address -fsanitize=pointer-compare -fsanitize=pointer-subtract -fsanitize=undefined -fstack-protector-strong -fsanitize=leak",
         flags_release = "-Wunused -O2",
         ar            = "llvm-ar",
@@ -238,7 +240,7 @@ local compilers = {
         opt_no_link   = "-c",
         opt_out_obj   = "-o",
         opt_out_exe   = "-o",
-        flags_common  = "-pedantic -Wall -Wextra -Wpedantic -Wuninitialized -Wcast-align -Wconversion -Wnull-dereference -Wformat=2 -fno-rtti -fno-exceptions",
+        flags_common  = "-pedantic -Wall -Wextra -Wpedantic -Wuninitialized -Wcast-align -Wconversion -Wnull-dereference -Wformat=2 -fno-rtti -fno-exceptions -pthread",
         flags_debug   = "-Werror -g -O0 -fsanitize=address -fsanitize=pointer-compare -fsanitize=pointer-subtract -fsanitize=undefined -fstack-protector-strong -fsanitize=leak",
         flags_release = "-O2",
         ar            = "ar",
@@ -288,12 +290,15 @@ local linker_flags = os_info.windows and "/NODEFAULTLIB:libcpmt /NODEFAULTLIB:li
 local presheaf = {
     src              = make_path({ root_dir, "src", "presheaf_impl.cpp" }),
     test_src         = make_path({ root_dir, "tests", "test_presheaf.cpp" }),
+    bench_src        = make_path({ root_dir, "benches", "bench_presheaf.cpp" }),
+    tools_src        = { psh_log_decoder = make_path({ root_dir, "tools", "psh_log_decoder.cpp" }) },
     include_dir      = make_path({ root_dir, "src" }),
     dll_build_define = "PSH_BUILD_DLL",
     debug_defines    = { "PSH_ENABLE_DEBUG" },
-    test_defines     = { "PSH_ENABLE_DEBUG", "PSH_ENABLE_PARANOID_USAGE_VALIDATION", "PSH_ENABLE_ANSI_COLOURS" },
+    test_defines     = { "PSH_ENABLE_DEBUG", "PSH_ENABLE_PARANOID_USAGE_VALIDATION", "PSH_ENABLE_ANSI_COLOURS", "PSH_ENABLE_MEMORY_INSTRUMENTATION", "PSH_ENABLE_PROFILING" },
     lib              = "presheaf",
     test_exe         = "presheaf_tests",
+    bench_exe        = "presheaf_benches",
     std              = "c++20",
     out_dir          = make_path({ ".", "build" }),
 }
@@ -334,6 +339,9 @@ local function format_source_files()
         make_path({ root_dir, "src", "*.hpp" }),
         make_path({ root_dir, "tests", "*.hpp" }),
         make_path({ root_dir, "tests", "*.cpp" }),
+        make_path({ root_dir, "benches", "*.hpp" }),
+        make_path({ root_dir, "benches", "*.cpp" }),
+        make_path({ root_dir, "tools", "*.cpp" }),
     }))
 end
 
@@ -437,6 +445,60 @@ local function build_presheaf_tests(tc)
     return test_exe_out
 end
 
+local function build_presheaf_benches(tc)
+    log_info("Building the presheaf library benchmarks...")
+
+    local default_flags = tc.flags_common .. " " .. tc.flags_release
+    local custom_flags  = concat(custom_compiler_flags)
+
+    local out_obj_flag = ""
+    if tc.cc == "cl" then
+        out_obj_flag = tc.opt_out_obj .. make_path({ presheaf.out_dir, presheaf.bench_exe .. os_ext.obj })
+    end
+
+    local bench_exe_out = make_path({ presheaf.out_dir, presheaf.bench_exe .. os_ext.exe })
+    exec(concat({
+        tc.cc,
+        tc.opt_std .. presheaf.std,
+        default_flags,
+        custom_flags,
+        tc.opt_include .. presheaf.include_dir,
+        out_obj_flag,
+        tc.opt_out_exe .. bench_exe_out,
+        presheaf.bench_src,
+        tc.opt_link_flags_start,
+        linker_flags,
+    }))
+    return bench_exe_out
+end
+
+local function build_presheaf_tools(tc)
+    log_info("Building the presheaf tools...")
+
+    local default_flags = tc.flags_common .. " " .. tc.flags_release
+    local custom_flags  = concat(custom_compiler_flags)
+
+    for tool_name, tool_src in pairs(presheaf.tools_src) do
+        local out_obj_flag = ""
+        if tc.cc == "cl" then
+            out_obj_flag = tc.opt_out_obj .. make_path({ presheaf.out_dir, tool_name .. os_ext.obj })
+        end
+
+        exec(concat({
+            tc.cc,
+            tc.opt_std .. presheaf.std,
+            default_flags,
+            custom_flags,
+            tc.opt_include .. presheaf.include_dir,
+            out_obj_flag,
+            tc.opt_out_exe .. make_path({ presheaf.out_dir, tool_name .. os_ext.exe }),
+            tool_src,
+            tc.opt_link_flags_start,
+            linker_flags,
+        }))
+    end
+end
+
 if options.fmt.on then
     format_source_files()
 end
@@ -449,5 +511,14 @@ if options.test.on then
     exec(test_exe)
 end
 
+if options.bench.on then
+    local bench_exe = build_presheaf_benches(toolchain)
+    exec(bench_exe)
+end
+
+if options.tools.on then
+    build_presheaf_tools(toolchain)
+end
+
 local end_time = os.time()
 log_info(string.format("Time elapsed: %.5f seconds", os.difftime(end_time, start_time)))
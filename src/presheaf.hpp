@@ -28,13 +28,19 @@
 #include "psh_platform.hpp"
 #include "psh_config.hpp"
 #include "psh_core.hpp"
+#include "psh_atomic.hpp"
 #include "psh_math.hpp"
 #include "psh_time.hpp"
 #include "psh_vec.hpp"
 #include "psh_streams.hpp"
+#include "psh_net.hpp"
 #include "psh_debug.hpp"
 #include "psh_memory.hpp"
+#include "psh_thread.hpp"
+#include "psh_profile.hpp"
+#include "psh_log.hpp"
 #include "psh_string.hpp"
+#include "psh_serialize.hpp"
 #include "psh_repr.hpp"
 #include "psh_bit.hpp"
 #include "psh_defer.hpp"
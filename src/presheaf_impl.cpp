@@ -32,4 +32,9 @@
 #include "psh_impl_debug.cpp"
 #include "psh_impl_memory.cpp"
 #include "psh_impl_streams.cpp"
+#include "psh_impl_serialize.cpp"
+#include "psh_impl_net.cpp"
+#include "psh_impl_thread.cpp"
+#include "psh_impl_profile.cpp"
+#include "psh_impl_log.cpp"
 // clang-format on
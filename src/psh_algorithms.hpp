@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include "psh_bit.hpp"
 #include "psh_core.hpp"
 #include "psh_memory.hpp"
 
@@ -34,6 +35,17 @@
 #    define QUICK_SORT_CUTOFF_TO_INSERTION_SORT 10u
 #endif
 
+/// Run length below which the merge sort algorithm sorts runs via the insertion sort algorithm.
+#ifndef MERGE_SORT_CUTOFF_TO_INSERTION_SORT
+#    define MERGE_SORT_CUTOFF_TO_INSERTION_SORT 16u
+#endif
+
+/// Minimum ratio between the element count and the sorted count for the partial sort algorithm to
+/// select the sorted elements via a heap instead of a quick select.
+#ifndef PARTIAL_SORT_HEAP_SELECT_RATIO
+#    define PARTIAL_SORT_HEAP_SELECT_RATIO 128u
+#endif
+
 namespace psh {
     // -------------------------------------------------------------------------------------------------
     // Search algorithms.
@@ -96,35 +108,171 @@ namespace psh {
         return match_idx;
     }
 
+    // -------------------------------------------------------------------------------------------------
+    // Vectorised search of unsigned integers.
+    //
+    // These overloads are preferred over the generic ones for exact type matches, scanning whole
+    // blocks of memory per comparison.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc psh_inline isize linear_search(FatPtr<u8 const> fptr, u8 match) psh_no_except {
+        return memory_find_u8(fptr.buf, fptr.count, match);
+    }
+    psh_proc psh_inline isize linear_search(FatPtr<u32 const> fptr, u32 match) psh_no_except {
+        return memory_find_u32(fptr.buf, fptr.count, match);
+    }
+    psh_proc psh_inline isize linear_search(FatPtr<u64 const> fptr, u64 match) psh_no_except {
+        return memory_find_u64(fptr.buf, fptr.count, match);
+    }
+
+    psh_proc psh_inline bool contains(FatPtr<u8 const> fptr, u8 match) psh_no_except {
+        return memory_find_u8(fptr.buf, fptr.count, match) >= 0;
+    }
+    psh_proc psh_inline bool contains(FatPtr<u32 const> fptr, u32 match) psh_no_except {
+        return memory_find_u32(fptr.buf, fptr.count, match) >= 0;
+    }
+    psh_proc psh_inline bool contains(FatPtr<u64 const> fptr, u64 match) psh_no_except {
+        return memory_find_u64(fptr.buf, fptr.count, match) >= 0;
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Search of sorted ranges.
+    //
+    // The searches are branchless: each step halves the range with a conditional move instead of a
+    // branch, so that the cost of a lookup doesn't depend on the branch predictor. The elements of
+    // both possible next steps are prefetched while the current comparison is resolved.
+    // -------------------------------------------------------------------------------------------------
+
+    /// Index of the first element that isn't less than the match, or the count of the range if
+    /// there is no such element.
+    ///
+    /// Note: We assume that the buffer of data is ordered.
+    template <typename T>
+    psh_proc usize lower_bound(FatPtr<T const> fptr, T match) psh_no_except {
+        if (fptr.count == 0) {
+            return 0;
+        }
+
+        T const* base  = fptr.buf;
+        usize    count = fptr.count;
+        while (count > 1) {
+            usize half = count / 2u;
+            psh_prefetch(base + (count - half) / 2u);
+            psh_prefetch(base + half + (count - half) / 2u);
+            base = (base[half] < match) ? (base + half) : base;
+            count -= half;
+        }
+        return static_cast<usize>(base - fptr.buf) + static_cast<usize>(*base < match);
+    }
+
+    /// Index of the first element that is greater than the match, or the count of the range if
+    /// there is no such element.
+    ///
+    /// Note: We assume that the buffer of data is ordered.
+    template <typename T>
+    psh_proc usize upper_bound(FatPtr<T const> fptr, T match) psh_no_except {
+        if (fptr.count == 0) {
+            return 0;
+        }
+
+        T const* base  = fptr.buf;
+        usize    count = fptr.count;
+        while (count > 1) {
+            usize half = count / 2u;
+            psh_prefetch(base + (count - half) / 2u);
+            psh_prefetch(base + half + (count - half) / 2u);
+            base = !(match < base[half]) ? (base + half) : base;
+            count -= half;
+        }
+        return static_cast<usize>(base - fptr.buf) + static_cast<usize>(!(match < *base));
+    }
+
     /// Try to find the index of the first match.
     ///
     /// Note: We assume that the buffer of data is ordered.
     template <typename T>
     psh_proc isize binary_search(FatPtr<T const> fptr, T match) psh_no_except {
-        return binary_search_range(fptr, match, 0, fptr.count - 1u);
+        usize idx = lower_bound(fptr, match);
+        return ((idx < fptr.count) && (fptr.buf[idx] == match)) ? static_cast<isize>(idx) : -1;
     }
 
+    /// Try to find the index of the first match within the range [low, high] of the data.
+    ///
+    /// Note: We assume that the buffer of data is ordered.
     template <typename T>
     psh_proc isize binary_search_range(FatPtr<T const> fptr, T match, usize low, usize high) psh_no_except {
-        if (psh_unlikely(high < low)) {
+        if (psh_unlikely((high < low) || (high >= fptr.count))) {
             return -1;
         }
 
-        usize mid      = (low + high) / 2;
-        T     mid_elem = fptr[mid];
+        isize idx = binary_search(FatPtr<T const>{fptr.buf + low, (high + 1u) - low}, match);
+        return (idx != -1) ? static_cast<isize>(low) + idx : -1;
+    }
 
-        // Found.
-        if (mid_elem == match) {
-            return static_cast<isize>(mid);
+    // -------------------------------------------------------------------------------------------------
+    // Eytzinger layout.
+    //
+    // For sorted data that is searched many times and rarely modified, the elements can be laid out
+    // in the order of a breadth-first traversal of the implicit binary search tree: the root comes
+    // first, followed by its two children, and so on. The first levels of the tree then share a
+    // few cache lines, and the descendants of an element four levels down are contiguous, so that
+    // they can be fetched ahead of time. Indices into the layout are 0-based, with the children of
+    // the element at idx being at 2 * idx + 1 and 2 * idx + 2.
+    // -------------------------------------------------------------------------------------------------
+
+    namespace impl {
+        template <typename T>
+        psh_proc void eytzinger_fill(FatPtr<T const> sorted, FatPtr<T> layout, usize* sorted_idx, usize node) psh_no_except {
+            if (node > layout.count) {
+                return;
+            }
+            eytzinger_fill(sorted, layout, sorted_idx, 2u * node);
+            layout.buf[node - 1u] = sorted.buf[(*sorted_idx)++];
+            eytzinger_fill(sorted, layout, sorted_idx, 2u * node + 1u);
         }
+    }  // namespace impl
+
+    /// Write the Eytzinger layout of sorted data.
+    ///
+    /// Parameters:
+    ///     * sorted: Ordered elements.
+    ///     * layout: Destination of the layout, should have the same count as the sorted data.
+    template <typename T>
+    psh_proc void eytzinger_layout(FatPtr<T const> sorted, FatPtr<T> layout) psh_no_except {
+        psh_validate_usage(psh_assert_msg(sorted.count == layout.count, "The layout and the sorted data should have the same count."));
+
+        usize sorted_idx = 0;
+        impl::eytzinger_fill(sorted, layout, &sorted_idx, 1);
+    }
+
+    /// Index, in the layout, of the first element that isn't less than the match, or the count of
+    /// the layout if there is no such element.
+    template <typename T>
+    psh_proc usize eytzinger_lower_bound(FatPtr<T const> layout, T match) psh_no_except {
+        // Number of elements per cache line. The descendants of a node log2(PREFETCH_STRIDE) levels
+        // down are contiguous in the layout, starting at 1-based index PREFETCH_STRIDE * node, so a
+        // single prefetch brings all of them in ahead of the traversal.
+        constexpr usize PREFETCH_STRIDE = psh_max_value(CACHE_LINE_SIZE / psh_usize_of(T), usize{1});
 
-        // Search the left side.
-        if (mid_elem < match) {
-            return binary_search_range(fptr, match, mid + 1u, high);
+        // The traversal uses 1-based node indices, where each step appends a bit to the index: 1
+        // for going right, when the element is less than the match.
+        uptr  base = reinterpret_cast<uptr>(layout.buf);
+        usize node = 1;
+        while (node <= layout.count) {
+            psh_prefetch(reinterpret_cast<void const*>(base + (PREFETCH_STRIDE * node - 1u) * psh_usize_of(T)));
+            node = 2u * node + static_cast<usize>(layout.buf[node - 1u] < match);
         }
 
-        // Search the right side.
-        return binary_search_range(fptr, match, low, mid - 1u);
+        // Drop the trailing right turns and the last left turn, landing at the lower bound.
+        node >>= bit_count_trailing_zeros(static_cast<u64>(~node)) + 1u;
+        return (node != 0) ? (node - 1u) : layout.count;
+    }
+
+    /// Try to find the index, in the layout, of an element equal to the match.
+    template <typename T>
+    psh_proc isize eytzinger_search(FatPtr<T const> layout, T match) psh_no_except {
+        usize idx = eytzinger_lower_bound(layout, match);
+        return ((idx < layout.count) && (layout.buf[idx] == match)) ? static_cast<isize>(idx) : -1;
     }
 
     // -------------------------------------------------------------------------------------------------
@@ -154,45 +302,823 @@ namespace psh {
         }
     }
 
+    /// Strict weak ordering of elements, telling whether the left element goes before the right one.
+    ///
+    /// Has the same shape as MatchFn, so that sorting procedures can be given any comparison of two
+    /// elements.
     template <typename T>
-    psh_proc void quick_sort(FatPtr<T> data) psh_no_except {
-        quick_sort_range(data, 0, data.count - 1u);
+    using LessFn = bool(T lhs, T rhs);
+
+    namespace impl {
+        /// Order given by the less-than operator of the elements.
+        struct OperatorLess {
+            template <typename T>
+            psh_inline bool operator()(T const& lhs, T const& rhs) const psh_no_except {
+                return (lhs < rhs);
+            }
+        };
+
+        template <typename T, typename Less>
+        psh_proc void insertion_sort_by(FatPtr<T> data, Less less) psh_no_except {
+            for (usize end = 1; end < data.count; ++end) {
+                for (usize idx = end; (idx > 0) && less(data[idx], data[idx - 1u]); --idx) {
+                    swap_elements(data.buf, idx, idx - 1u);
+                }
+            }
+        }
+
+        template <typename T, typename Less>
+        psh_proc void heap_sift_down_by(FatPtr<T> data, usize root, usize count, Less less) psh_no_except {
+            for (;;) {
+                usize child = 2u * root + 1u;
+                if (child >= count) {
+                    break;
+                }
+                if ((child + 1u < count) && less(data[child], data[child + 1u])) {
+                    ++child;
+                }
+                if (!less(data[root], data[child])) {
+                    break;
+                }
+                swap_elements(data.buf, root, child);
+                root = child;
+            }
+        }
+
+        template <typename T, typename Less>
+        psh_proc void heap_make_by(FatPtr<T> data, Less less) psh_no_except {
+            for (usize root = data.count / 2u; root > 0; --root) {
+                heap_sift_down_by(data, root - 1u, data.count, less);
+            }
+        }
+
+        /// Sort a max-heap in place.
+        template <typename T, typename Less>
+        psh_proc void heap_sort_heap_by(FatPtr<T> data, Less less) psh_no_except {
+            for (usize end = data.count; end > 1; --end) {
+                swap_elements(data.buf, 0, end - 1u);
+                heap_sift_down_by(data, 0, end - 1u, less);
+            }
+        }
+
+        template <typename T, typename Less>
+        psh_proc void heap_sort_by(FatPtr<T> data, Less less) psh_no_except {
+            heap_make_by(data, less);
+            heap_sort_heap_by(data, less);
+        }
+
+        /// Depth limit of 2 * floor(log2(n)) for the quick sort of a range of a given size.
+        psh_proc psh_inline u32 quick_sort_depth_limit(usize count) psh_no_except {
+            u32 depth_limit = 0;
+            for (; count > 1; count /= 2u) {
+                depth_limit += 2u;
+            }
+            return depth_limit;
+        }
+
+        /// Partition the range [low, high] around the median of its first, middle and last elements.
+        ///
+        /// The range should have at least three elements.
+        ///
+        /// Return: The final index of the pivot, every element before it doesn't go after it and
+        ///         every element after it doesn't go before it.
+        template <typename T, typename Less>
+        psh_proc usize quick_sort_partition_by(FatPtr<T> data, usize low, usize high, Less less) psh_no_except {
+            // Move the median of the first, middle and last elements to the start of the range, to
+            // be used as the pivot.
+            usize mid = low + (high - low) / 2u;
+            if (less(data[mid], data[low])) {
+                swap_elements(data.buf, low, mid);
+            }
+            if (less(data[high], data[low])) {
+                swap_elements(data.buf, low, high);
+            }
+            if (less(data[high], data[mid])) {
+                swap_elements(data.buf, mid, high);
+            }
+            swap_elements(data.buf, low, mid);
+
+            // Partition the range. The scans stop at elements equal to the pivot, which keeps the
+            // partitions balanced in the presence of many equal elements.
+            usize left_scan  = low;
+            usize right_scan = high + 1u;
+            for (;;) {
+                do {
+                    ++left_scan;
+                } while ((left_scan != high) && less(data[left_scan], data[low]));
+
+                do {
+                    --right_scan;
+                } while ((right_scan != low) && less(data[low], data[right_scan]));
+
+                if (right_scan <= left_scan) {
+                    break;
+                }
+
+                swap_elements(data.buf, left_scan, right_scan);
+            }
+            swap_elements(data.buf, low, right_scan);
+
+            return right_scan;
+        }
+
+        template <typename T, typename Less>
+        psh_proc void quick_sort_range_by(FatPtr<T> data, usize low, usize high, u32 depth_limit, Less less) psh_no_except {
+            for (;;) {
+                if (high <= low + QUICK_SORT_CUTOFF_TO_INSERTION_SORT) {
+                    insertion_sort_by(make_slice(&data, low, (high + 1u) - low), less);
+                    return;
+                }
+
+                if (depth_limit == 0) {
+                    heap_sort_by(make_slice(&data, low, (high + 1u) - low), less);
+                    return;
+                }
+                --depth_limit;
+
+                usize pivot = quick_sort_partition_by(data, low, high, less);
+
+                // Recurse into the smaller partition and iterate over the larger one, bounding the
+                // stack depth to O(log n).
+                if (pivot - low < high - pivot) {
+                    if (pivot > low) {
+                        quick_sort_range_by(data, low, pivot - 1u, depth_limit, less);
+                    }
+                    low = pivot + 1u;
+                } else {
+                    if (pivot < high) {
+                        quick_sort_range_by(data, pivot + 1u, high, depth_limit, less);
+                    }
+                    if (pivot == low) {
+                        return;
+                    }
+                    high = pivot - 1u;
+                }
+            }
+        }
+    }  // namespace impl
+
+    /// Restore the max-heap property of the subtree rooted at a given index.
+    template <typename T>
+    psh_proc void heap_sift_down(FatPtr<T> data, usize root, usize count) psh_no_except {
+        impl::heap_sift_down_by(data, root, count, impl::OperatorLess{});
+    }
+
+    /// In-place sort with guaranteed O(n log n) running time.
+    template <typename T>
+    psh_proc void heap_sort(FatPtr<T> data) psh_no_except {
+        impl::heap_sort_by(data, impl::OperatorLess{});
+    }
+
+    /// Sort the range [low, high] of the data.
+    ///
+    /// The algorithm is an introsort: a quick sort with median-of-three pivoting that falls back to
+    /// the heap sort once the recursion depth exceeds the given limit, keeping the worst case at
+    /// O(n log n).
+    template <typename T>
+    psh_proc void quick_sort_range(FatPtr<T> data, usize low, usize high, u32 depth_limit) psh_no_except {
+        impl::quick_sort_range_by(data, low, high, depth_limit, impl::OperatorLess{});
     }
 
     template <typename T>
     psh_proc void quick_sort_range(FatPtr<T> data, usize low, usize high) psh_no_except {
-        if (high <= low + QUICK_SORT_CUTOFF_TO_INSERTION_SORT) {
-            insertion_sort(make_slice(&data, low, (high + 1u) - low));
+        if (high <= low) {
             return;
         }
+        quick_sort_range(data, low, high, impl::quick_sort_depth_limit((high + 1u) - low));
+    }
 
-        usize left_scan  = low + 1u;
-        usize right_scan = high;
-        for (;;) {
-            while (data[left_scan] <= data[low]) {
-                if (left_scan == high) {
-                    break;
+    template <typename T>
+    psh_proc void quick_sort(FatPtr<T> data) psh_no_except {
+        if (data.count <= 1) {
+            return;
+        }
+        quick_sort_range(data, 0, data.count - 1u);
+    }
+
+    /// Merge two sorted ranges into a destination range with enough space for both.
+    ///
+    /// The merge is stable: for equivalent elements, the ones from the left range come first.
+    template <typename T>
+    psh_proc void merge_sorted(
+        T const* psh_no_alias lhs,
+        usize                 lhs_count,
+        T const* psh_no_alias rhs,
+        usize                 rhs_count,
+        T* psh_no_alias       dst) psh_no_except {
+        usize lhs_idx = 0;
+        usize rhs_idx = 0;
+        usize dst_idx = 0;
+        while ((lhs_idx < lhs_count) && (rhs_idx < rhs_count)) {
+            if (rhs[rhs_idx] < lhs[lhs_idx]) {
+                dst[dst_idx++] = rhs[rhs_idx++];
+            } else {
+                dst[dst_idx++] = lhs[lhs_idx++];
+            }
+        }
+        while (lhs_idx < lhs_count) {
+            dst[dst_idx++] = lhs[lhs_idx++];
+        }
+        while (rhs_idx < rhs_count) {
+            dst[dst_idx++] = rhs[rhs_idx++];
+        }
+    }
+
+    namespace impl {
+        /// Maximum number of runs waiting to be merged by the merge sort. The lengths of the pending
+        /// runs grow at least as fast as the Fibonacci numbers, so this suffices for any 64-bit count.
+        psh_global constexpr usize MERGE_SORT_MAX_PENDING_RUNS = 96;
+
+        struct MergeSortRun {
+            usize start;
+            usize count;
+        };
+
+        /// Index of the first element of a sorted range that goes after a given element.
+        template <typename T, typename Less>
+        psh_proc usize sorted_upper_bound_by(T const* data, usize count, T const& match, Less less) psh_no_except {
+            usize low  = 0;
+            usize high = count;
+            while (low < high) {
+                usize mid = low + (high - low) / 2u;
+                if (less(match, data[mid])) {
+                    high = mid;
+                } else {
+                    low = mid + 1u;
                 }
-                ++left_scan;
             }
+            return low;
+        }
 
-            while (data[low] <= data[right_scan]) {
-                if (right_scan == low) {
-                    break;
+        /// Index of the first element of a sorted range that doesn't go before a given element.
+        template <typename T, typename Less>
+        psh_proc usize sorted_lower_bound_by(T const* data, usize count, T const& match, Less less) psh_no_except {
+            usize low  = 0;
+            usize high = count;
+            while (low < high) {
+                usize mid = low + (high - low) / 2u;
+                if (less(data[mid], match)) {
+                    low = mid + 1u;
+                } else {
+                    high = mid;
                 }
-                right_scan = psh_nowrap_unsigned_dec(right_scan);
             }
+            return low;
+        }
 
-            if (right_scan <= left_scan) {
-                break;
+        /// Stably merge two adjacent sorted runs in place.
+        ///
+        /// Only the elements that actually need to move are merged: the prefix of the left run going
+        /// before the whole right run and the suffix of the right run going after the whole left run
+        /// are left untouched. The remaining part of the left run is moved to the scratch buffer.
+        template <typename T, typename Less>
+        psh_proc void merge_adjacent_runs_by(T* data, usize lhs_count, usize rhs_count, T* scratch, Less less) psh_no_except {
+            T* rhs = data + lhs_count;
+
+            usize skip_count = sorted_upper_bound_by(data, lhs_count, rhs[0], less);
+            if (skip_count == lhs_count) {
+                return;
             }
+            rhs_count = sorted_lower_bound_by(rhs, rhs_count, data[lhs_count - 1u], less);
+
+            T* lhs = data + skip_count;
+            lhs_count -= skip_count;
+            for (usize idx = 0; idx < lhs_count; ++idx) {
+                scratch[idx] = lhs[idx];
+            }
+
+            // The merge writes from the start of the left run and never overtakes the elements of
+            // the right run yet to be read. Once the scratch buffer is exhausted, the remaining
+            // elements of the right run are already in place.
+            usize lhs_idx = 0;
+            usize rhs_idx = 0;
+            usize dst_idx = 0;
+            while ((lhs_idx < lhs_count) && (rhs_idx < rhs_count)) {
+                if (less(rhs[rhs_idx], scratch[lhs_idx])) {
+                    lhs[dst_idx++] = rhs[rhs_idx++];
+                } else {
+                    lhs[dst_idx++] = scratch[lhs_idx++];
+                }
+            }
+            while (lhs_idx < lhs_count) {
+                lhs[dst_idx++] = scratch[lhs_idx++];
+            }
+        }
 
-            swap_elements(data.buf, left_scan, right_scan);
+        template <typename T, typename Less>
+        psh_proc void merge_sort_merge_at(T* data, T* scratch, MergeSortRun* runs, usize* run_count, usize idx, Less less) psh_no_except {
+            merge_adjacent_runs_by(data + runs[idx].start, runs[idx].count, runs[idx + 1u].count, scratch, less);
+
+            runs[idx].count += runs[idx + 1u].count;
+            for (usize run_idx = idx + 1u; run_idx + 1u < *run_count; ++run_idx) {
+                runs[run_idx] = runs[run_idx + 1u];
+            }
+            --*run_count;
         }
-        swap_elements(data.buf, low, right_scan);
 
-        quick_sort_range(data, low, psh_nowrap_unsigned_dec(right_scan));
-        quick_sort_range(data, right_scan + 1u, high);
+        template <typename T, typename Less>
+        psh_proc void merge_sort_by(FatPtr<T> data, FatPtr<T> scratch, Less less) psh_no_except {
+            psh_validate_usage(psh_assert_msg(scratch.count >= data.count, "Scratch buffer too small for the merge sort."));
+
+            MergeSortRun runs[MERGE_SORT_MAX_PENDING_RUNS];
+            usize        run_count = 0;
+
+            usize count = data.count;
+            for (usize start = 0; start < count;) {
+                // Find the natural run starting at the current position. Strictly descending runs
+                // are reversed, which keeps the sort stable since they have no equivalent elements.
+                usize end = start + 1u;
+                if ((end < count) && less(data[end], data[start])) {
+                    do {
+                        ++end;
+                    } while ((end < count) && less(data[end], data[end - 1u]));
+
+                    for (usize lhs = start, rhs = end - 1u; lhs < rhs; ++lhs, --rhs) {
+                        swap_elements(data.buf, lhs, rhs);
+                    }
+                } else {
+                    while ((end < count) && !less(data[end], data[end - 1u])) {
+                        ++end;
+                    }
+                }
+
+                // Short runs are extended via the insertion sort, which is cheap for the already
+                // sorted prefix.
+                usize min_end = psh_min_value(start + MERGE_SORT_CUTOFF_TO_INSERTION_SORT, count);
+                if (end < min_end) {
+                    insertion_sort_by(FatPtr<T>{data.buf + start, min_end - start}, less);
+                    end = min_end;
+                }
+
+                psh_assert(run_count < MERGE_SORT_MAX_PENDING_RUNS);
+                runs[run_count++] = MergeSortRun{.start = start, .count = end - start};
+                start             = end;
+
+                // Merge the pending runs until their lengths decrease faster than the Fibonacci
+                // numbers from the bottom to the top, keeping the merges balanced.
+                while (run_count > 1) {
+                    usize idx = run_count - 2u;
+                    if (((idx > 0) && (runs[idx - 1u].count <= runs[idx].count + runs[idx + 1u].count))
+                        || ((idx > 1) && (runs[idx - 2u].count <= runs[idx - 1u].count + runs[idx].count))) {
+                        if (runs[idx - 1u].count < runs[idx + 1u].count) {
+                            --idx;
+                        }
+                    } else if (runs[idx].count > runs[idx + 1u].count) {
+                        break;
+                    }
+                    merge_sort_merge_at(data.buf, scratch.buf, runs, &run_count, idx, less);
+                }
+            }
+
+            while (run_count > 1) {
+                usize idx = run_count - 2u;
+                if ((idx > 0) && (runs[idx - 1u].count < runs[idx + 1u].count)) {
+                    --idx;
+                }
+                merge_sort_merge_at(data.buf, scratch.buf, runs, &run_count, idx, less);
+            }
+        }
+
+        template <typename T, typename Less>
+        psh_proc Status merge_sort_by(Arena* arena, FatPtr<T> data, Less less) psh_no_except {
+            if (data.count <= MERGE_SORT_CUTOFF_TO_INSERTION_SORT) {
+                insertion_sort_by(data, less);
+                return STATUS_OK;
+            }
+
+            ScratchArena scratch_arena{arena};
+
+            T* scratch = memory_alloc_uninit<T>(scratch_arena.arena, data.count);
+            if (psh_unlikely(scratch == nullptr)) {
+                return STATUS_FAILED;
+            }
+
+            merge_sort_by(data, FatPtr<T>{scratch, data.count}, less);
+            return STATUS_OK;
+        }
+    }  // namespace impl
+
+    /// Stable sort with guaranteed O(n log n) running time.
+    ///
+    /// The algorithm is an adaptive merge sort: the data is split into its natural ascending and
+    /// descending runs, with short runs extended to MERGE_SORT_CUTOFF_TO_INSERTION_SORT elements
+    /// via the insertion sort, and runs are merged in place as they are found, keeping their
+    /// lengths balanced. Sorted and reverse sorted data take a linear number of comparisons, and
+    /// data made of a few sorted runs is sorted in O(n log r) for r runs.
+    ///
+    /// Parameters:
+    ///     * data: Elements to be sorted.
+    ///     * scratch: Buffer with capacity for at least data.count elements.
+    template <typename T>
+    psh_proc void merge_sort(FatPtr<T> data, FatPtr<T> scratch) psh_no_except {
+        impl::merge_sort_by(data, scratch, impl::OperatorLess{});
+    }
+
+    /// Stable sort ordering the elements by a given comparison procedure.
+    template <typename T>
+    psh_proc void merge_sort(FatPtr<T> data, FatPtr<T> scratch, LessFn<T>* less_fn) psh_no_except {
+        psh_assert_not_null(less_fn);
+        impl::merge_sort_by(data, scratch, less_fn);
+    }
+
+    /// Stable sort with guaranteed O(n log n) running time, using the arena for the scratch buffer.
+    ///
+    /// Return: Whether the arena had enough memory for the scratch buffer.
+    template <typename T>
+    psh_proc Status merge_sort(Arena* arena, FatPtr<T> data) psh_no_except {
+        return impl::merge_sort_by(arena, data, impl::OperatorLess{});
+    }
+
+    /// Stable sort ordering the elements by a given comparison procedure, using the arena for the
+    /// scratch buffer.
+    ///
+    /// Return: Whether the arena had enough memory for the scratch buffer.
+    template <typename T>
+    psh_proc Status merge_sort(Arena* arena, FatPtr<T> data, LessFn<T>* less_fn) psh_no_except {
+        psh_assert_not_null(less_fn);
+        return impl::merge_sort_by(arena, data, less_fn);
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Selection algorithms.
+    //
+    // Both procedures only order the part of the data that was asked for, which is much cheaper
+    // than sorting everything when a few elements are needed, such as the top-k elements of a
+    // large range.
+    // -------------------------------------------------------------------------------------------------
+
+    namespace impl {
+        template <typename T, typename Less>
+        psh_proc void nth_element_by(FatPtr<T> data, usize nth, Less less) psh_no_except {
+            psh_validate_usage(psh_assert_fmt(nth < data.count, "Index %zu out of bounds of a range of size %zu.", nth, data.count));
+
+            // Quick select, recursing only into the partition containing the wanted index, and
+            // falling back to the heap sort once the depth limit is reached.
+            usize low         = 0;
+            usize high        = data.count - 1u;
+            u32   depth_limit = quick_sort_depth_limit(data.count);
+            while (high > low + QUICK_SORT_CUTOFF_TO_INSERTION_SORT) {
+                if (depth_limit == 0) {
+                    heap_sort_by(make_slice(&data, low, (high + 1u) - low), less);
+                    return;
+                }
+                --depth_limit;
+
+                usize pivot = quick_sort_partition_by(data, low, high, less);
+                if (pivot == nth) {
+                    return;
+                }
+                if (nth < pivot) {
+                    high = pivot - 1u;
+                } else {
+                    low = pivot + 1u;
+                }
+            }
+            insertion_sort_by(make_slice(&data, low, (high + 1u) - low), less);
+        }
+
+        template <typename T, typename Less>
+        psh_proc void partial_sort_by(FatPtr<T> data, usize sorted_count, Less less) psh_no_except {
+            usize count  = data.count;
+            sorted_count = psh_min_value(sorted_count, count);
+            if (sorted_count == 0) {
+                return;
+            }
+
+            // For a few elements, keep a max-heap of the smallest elements seen so far: most
+            // elements are discarded by a single comparison against the top of the heap, and the
+            // data is only read.
+            if (sorted_count <= count / PARTIAL_SORT_HEAP_SELECT_RATIO) {
+                FatPtr<T> heap = {data.buf, sorted_count};
+                heap_make_by(heap, less);
+                for (usize idx = sorted_count; idx < count; ++idx) {
+                    if (less(data[idx], heap[0])) {
+                        swap_elements(data.buf, 0, idx);
+                        heap_sift_down_by(heap, 0, sorted_count, less);
+                    }
+                }
+                heap_sort_heap_by(heap, less);
+                return;
+            }
+
+            if (sorted_count < count) {
+                nth_element_by(data, sorted_count - 1u, less);
+            }
+            if (sorted_count > 1) {
+                quick_sort_range_by(data, 0, sorted_count - 1u, quick_sort_depth_limit(sorted_count), less);
+            }
+        }
+    }  // namespace impl
+
+    /// Reorder the data so that the element at a given index is the one that would be there if the
+    /// data was sorted. No element before the index goes after it, and no element after the index
+    /// goes before it, but both sides are otherwise left in an unspecified order.
+    ///
+    /// Runs in O(n) expected time and O(n log n) in the worst case.
+    template <typename T>
+    psh_proc void nth_element(FatPtr<T> data, usize nth) psh_no_except {
+        impl::nth_element_by(data, nth, impl::OperatorLess{});
+    }
+
+    /// Select the element at a given index of the order given by a comparison procedure.
+    template <typename T>
+    psh_proc void nth_element(FatPtr<T> data, usize nth, LessFn<T>* less_fn) psh_no_except {
+        psh_assert_not_null(less_fn);
+        impl::nth_element_by(data, nth, less_fn);
+    }
+
+    /// Sort the smallest elements of the data into its first positions, leaving the remaining
+    /// elements in an unspecified order. The sort isn't stable.
+    ///
+    /// Few elements are selected via a heap, in O(n log k) for k sorted elements, otherwise the
+    /// elements are selected by nth_element and then sorted.
+    ///
+    /// Parameters:
+    ///     * data: Elements to be partially sorted.
+    ///     * sorted_count: Number of elements to be sorted, clamped to the number of elements.
+    template <typename T>
+    psh_proc void partial_sort(FatPtr<T> data, usize sorted_count) psh_no_except {
+        impl::partial_sort_by(data, sorted_count, impl::OperatorLess{});
+    }
+
+    /// Partially sort the data by a given comparison procedure.
+    template <typename T>
+    psh_proc void partial_sort(FatPtr<T> data, usize sorted_count, LessFn<T>* less_fn) psh_no_except {
+        psh_assert_not_null(less_fn);
+        impl::partial_sort_by(data, sorted_count, less_fn);
+    }
+
+    /// Procedure extracting the sorting key of an element.
+    template <typename T, typename K>
+    using RadixKeyFn = K(T const& element);
+
+    namespace impl {
+        // Map keys to unsigned integers whose ordering matches the ordering of the keys.
+        psh_proc psh_inline u8 radix_key(u8 key) psh_no_except { return key; }
+        psh_proc psh_inline u16 radix_key(u16 key) psh_no_except { return key; }
+        psh_proc psh_inline u32 radix_key(u32 key) psh_no_except { return key; }
+        psh_proc psh_inline u64 radix_key(u64 key) psh_no_except { return key; }
+        psh_proc psh_inline u8 radix_key(i8 key) psh_no_except { return static_cast<u8>(static_cast<u8>(key) ^ 0x80u); }
+        psh_proc psh_inline u16 radix_key(i16 key) psh_no_except { return static_cast<u16>(static_cast<u16>(key) ^ 0x8000u); }
+        psh_proc psh_inline u32 radix_key(i32 key) psh_no_except { return static_cast<u32>(key) ^ 0x80000000u; }
+        psh_proc psh_inline u64 radix_key(i64 key) psh_no_except { return static_cast<u64>(key) ^ 0x8000000000000000ull; }
+
+        // Negative floats have all their bits flipped, while positive floats only have the sign bit
+        // flipped. NaNs are placed at the extremes, according to their sign bit.
+        psh_proc psh_inline u32 radix_key(f32 key) psh_no_except {
+            u32 bits = __builtin_bit_cast(u32, key);
+            return bits ^ ((bits >> 31u) ? 0xFFFFFFFFu : 0x80000000u);
+        }
+        psh_proc psh_inline u64 radix_key(f64 key) psh_no_except {
+            u64 bits = __builtin_bit_cast(u64, key);
+            return bits ^ ((bits >> 63u) ? 0xFFFFFFFFFFFFFFFFull : 0x8000000000000000ull);
+        }
+
+        template <typename T>
+        psh_proc psh_inline T radix_identity_key(T const& element) psh_no_except {
+            return element;
+        }
+    }  // namespace impl
+
+    /// Stable sort of elements by the key given by a key extractor.
+    ///
+    /// The algorithm is a least significant digit radix sort with 8-bit digits, running in O(n)
+    /// for a fixed key size. Passes in which all keys have the same digit are skipped. The key type
+    /// should be any of the integral or floating point types.
+    ///
+    /// Parameters:
+    ///     * arena: Arena providing the scratch buffer, of the same size as the data.
+    ///     * data: Elements to be sorted.
+    ///     * key_fn: Procedure extracting the key of each element.
+    ///
+    /// Return: Whether the arena had enough memory for the scratch buffers.
+    template <typename T, typename K>
+    psh_proc Status radix_sort(Arena* arena, FatPtr<T> data, RadixKeyFn<T, K>* key_fn) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(key_fn));
+
+        using Key                   = decltype(impl::radix_key(K{}));
+        constexpr usize DIGIT_COUNT = 256;
+        constexpr usize PASS_COUNT  = sizeof(Key);
+
+        usize count = data.count;
+        if (count <= 1) {
+            return STATUS_OK;
+        }
+
+        ScratchArena scratch_arena{arena};
+
+        T*     scratch    = memory_alloc<T>(scratch_arena.arena, count);
+        usize* histograms = memory_alloc<usize>(scratch_arena.arena, PASS_COUNT * DIGIT_COUNT);
+        if (psh_unlikely((scratch == nullptr) || (histograms == nullptr))) {
+            return STATUS_FAILED;
+        }
+
+        // Compute the histograms of all passes in a single read of the data.
+        for (usize idx = 0; idx < count; ++idx) {
+            Key key = impl::radix_key(key_fn(data.buf[idx]));
+            for (usize pass = 0; pass < PASS_COUNT; ++pass) {
+                ++histograms[pass * DIGIT_COUNT + static_cast<usize>((key >> (8u * pass)) & 0xFFu)];
+            }
+        }
+
+        T* src = data.buf;
+        T* dst = scratch;
+        for (usize pass = 0; pass < PASS_COUNT; ++pass) {
+            usize* histogram = histograms + pass * DIGIT_COUNT;
+            usize  shift     = 8u * pass;
+
+            usize first_digit = static_cast<usize>((impl::radix_key(key_fn(src[0])) >> shift) & 0xFFu);
+            if (histogram[first_digit] == count) {
+                continue;
+            }
+
+            // Transform the histogram into the starting offsets of each digit.
+            usize offset = 0;
+            for (usize digit = 0; digit < DIGIT_COUNT; ++digit) {
+                usize digit_count = histogram[digit];
+                histogram[digit]  = offset;
+                offset += digit_count;
+            }
+
+            for (usize idx = 0; idx < count; ++idx) {
+                usize digit             = static_cast<usize>((impl::radix_key(key_fn(src[idx])) >> shift) & 0xFFu);
+                dst[histogram[digit]++] = src[idx];
+            }
+
+            T* tmp = src;
+            src    = dst;
+            dst    = tmp;
+        }
+
+        if (src != data.buf) {
+            for (usize idx = 0; idx < count; ++idx) {
+                data.buf[idx] = src[idx];
+            }
+        }
+
+        return STATUS_OK;
+    }
+
+    /// Sort integral or floating point elements with the radix sort algorithm.
+    ///
+    /// Return: Whether the arena had enough memory for the scratch buffers.
+    template <typename T>
+    psh_proc Status radix_sort(Arena* arena, FatPtr<T> data) psh_no_except {
+        return radix_sort(arena, data, impl::radix_identity_key<T>);
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Sorted flat map.
+    // -------------------------------------------------------------------------------------------------
+
+    /// Map whose keys are kept sorted in an array, with the values in a parallel array.
+    ///
+    /// Lookups are a branchless binary search over the contiguous keys, touching only the values of
+    /// the found keys, which makes the map a good fit for small or read-mostly tables. Insertions
+    /// and removals shift the elements after the affected position, costing O(n).
+    ///
+    /// The keys should be totally ordered by operator<. Both arrays have their lifetime bound to the
+    /// lifetime of the arena.
+    ///
+    /// Note: The arrays are separate allocations of the same arena, so at most the topmost of them
+    ///       grows in place: the other is copied, and its previous buffer is left unused until the
+    ///       arena is cleared. When the final size is known, calling flat_map_reserve upfront avoids
+    ///       both the copies and the waste.
+    ///
+    /// Note: Pointers to the values of the map are invalidated by insertions and removals.
+    template <typename K, typename V>
+    struct FlatMap {
+        DynamicArray<K> keys;
+        DynamicArray<V> values;
+    };
+
+    template <typename K, typename V>
+    psh_proc psh_inline FlatMap<K, V> make_flat_map(Arena* arena, usize capacity = DYNARRAY_DEFAULT_INITIAL_CAPACITY) psh_no_except {
+        return FlatMap<K, V>{
+            .keys   = make_dynamic_array<K>(arena, capacity, DynamicArrayGrowth::UNINITIALISED),
+            .values = make_dynamic_array<V>(arena, capacity, DynamicArrayGrowth::UNINITIALISED),
+        };
+    }
+
+    template <typename K, typename V>
+    psh_proc psh_inline void init_flat_map(FlatMap<K, V>* map, Arena* arena, usize capacity = DYNARRAY_DEFAULT_INITIAL_CAPACITY) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(map);
+            psh_assert_msg(map->keys.count == 0, "FlatMap already initialised.");
+        });
+
+        *map = make_flat_map<K, V>(arena, capacity);
+    }
+
+    /// Ensure that the map can hold a given number of elements without growing.
+    template <typename K, typename V>
+    psh_proc Status flat_map_reserve(FlatMap<K, V>* map, usize element_count) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        Status status = STATUS_OK;
+        if (map->keys.capacity < element_count) {
+            status = dynamic_array_reserve(&map->keys, element_count);
+        }
+        if (status && (map->values.capacity < element_count)) {
+            status = dynamic_array_reserve(&map->values, element_count);
+        }
+        return status;
+    }
+
+    /// Find the value associated with a key.
+    ///
+    /// Return: A pointer to the value, or null if the key isn't in the map.
+    template <typename K, typename V>
+    psh_proc V* flat_map_find(FlatMap<K, V>* map, K key) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        FatPtr<K const> keys = {map->keys.buf, map->keys.count};
+        usize           idx  = lower_bound(keys, key);
+        return ((idx < keys.count) && !(key < keys.buf[idx])) ? &map->values.buf[idx] : nullptr;
+    }
+    template <typename K, typename V>
+    psh_proc V const* flat_map_find(FlatMap<K, V> const* map, K key) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        FatPtr<K const> keys = {map->keys.buf, map->keys.count};
+        usize           idx  = lower_bound(keys, key);
+        return ((idx < keys.count) && !(key < keys.buf[idx])) ? &map->values.buf[idx] : nullptr;
+    }
+
+    template <typename K, typename V>
+    psh_proc psh_inline bool flat_map_contains(FlatMap<K, V> const* map, K key) psh_no_except {
+        return (flat_map_find(map, key) != nullptr);
+    }
+
+    /// Insert a key-value pair into the map. If the key is already present, its value is
+    /// overwritten.
+    template <typename K, typename V>
+    psh_proc Status flat_map_insert(FlatMap<K, V>* map, K key, V value) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        usize count = map->keys.count;
+        usize idx   = lower_bound(FatPtr<K const>{map->keys.buf, count}, key);
+        if ((idx < count) && !(key < map->keys.buf[idx])) {
+            map->values.buf[idx] = value;
+            return STATUS_OK;
+        }
+
+        Status status = STATUS_OK;
+        if (map->keys.capacity == count) {
+            status = dynamic_array_grow(&map->keys);
+        }
+        if (status && (map->values.capacity == count)) {
+            status = dynamic_array_grow(&map->values);
+        }
+        if (psh_unlikely(!status)) {
+            return STATUS_FAILED;
+        }
+
+        // Make room for the new element at its sorted position.
+        usize shifted_count = count - idx;
+        if (shifted_count != 0) {
+            memory_move(
+                reinterpret_cast<u8*>(map->keys.buf + idx + 1u),
+                reinterpret_cast<u8 const*>(map->keys.buf + idx),
+                shifted_count * psh_usize_of(K));
+            memory_move(
+                reinterpret_cast<u8*>(map->values.buf + idx + 1u),
+                reinterpret_cast<u8 const*>(map->values.buf + idx),
+                shifted_count * psh_usize_of(V));
+        }
+
+        map->keys.buf[idx]   = key;
+        map->values.buf[idx] = value;
+        map->keys.count      = count + 1u;
+        map->values.count    = count + 1u;
+
+        return STATUS_OK;
+    }
+
+    /// Try to remove a key from the map.
+    ///
+    /// Return: Whether the key was present in the map.
+    template <typename K, typename V>
+    psh_proc Status flat_map_remove(FlatMap<K, V>* map, K key) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        usize idx = lower_bound(FatPtr<K const>{map->keys.buf, map->keys.count}, key);
+        if ((idx == map->keys.count) || (key < map->keys.buf[idx])) {
+            return STATUS_FAILED;
+        }
+
+        dynamic_array_ordered_remove(&map->keys, idx);
+        dynamic_array_ordered_remove(&map->values, idx);
+        return STATUS_OK;
+    }
+
+    /// Remove all elements of the map, keeping its capacity.
+    template <typename K, typename V>
+    psh_proc psh_inline void flat_map_clear(FlatMap<K, V>* map) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        dynamic_array_clear(&map->keys);
+        dynamic_array_clear(&map->values);
     }
 
     // -------------------------------------------------------------------------------------------------
@@ -0,0 +1,215 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Atomic operations on integers and pointers.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+///
+/// The operations are thin wrappers over the compiler intrinsics: the __atomic builtins for GCC and
+/// Clang, and the Interlocked family for MSVC. Only types of 4 or 8 bytes are supported.
+
+#pragma once
+
+#include "psh_core.hpp"
+#include "psh_platform.hpp"
+
+#if PSH_COMPILER_MSVC && !PSH_COMPILER_CLANG
+#    define PSH_IMPL_ATOMIC_MSVC 1
+#    include <intrin.h>
+#else
+#    define PSH_IMPL_ATOMIC_MSVC 0
+#endif
+
+namespace psh {
+    /// Size assumed for a cache line, used to keep data that is written by distinct threads from
+    /// sharing a line.
+    psh_global constexpr usize CACHE_LINE_SIZE = 64;
+
+    /// Memory ordering constraints of atomic operations.
+    ///
+    /// Note: The MSVC implementation treats every ordering as sequentially consistent.
+    enum struct MemoryOrder {
+#if PSH_IMPL_ATOMIC_MSVC
+        RELAXED,
+        ACQUIRE,
+        RELEASE,
+        ACQ_REL,
+        SEQ_CST,
+#else
+        RELAXED = __ATOMIC_RELAXED,
+        ACQUIRE = __ATOMIC_ACQUIRE,
+        RELEASE = __ATOMIC_RELEASE,
+        ACQ_REL = __ATOMIC_ACQ_REL,
+        SEQ_CST = __ATOMIC_SEQ_CST,
+#endif
+    };
+
+    /// Value that should only be accessed via atomic operations.
+    template <typename T>
+    struct Atomic {
+        static_assert((sizeof(T) == 4) || (sizeof(T) == 8), "Only 4 and 8 byte atomics are supported.");
+
+        alignas(sizeof(T)) T value;
+    };
+
+#if PSH_IMPL_ATOMIC_MSVC
+    namespace impl {
+        template <typename T>
+        struct AtomicIntrinsicType {
+            using Type = long;
+        };
+        template <typename T>
+            requires(sizeof(T) == 8)
+        struct AtomicIntrinsicType<T> {
+            using Type = __int64;
+        };
+
+        template <typename T>
+        using AtomicIntrinsic = typename AtomicIntrinsicType<T>::Type;
+    }  // namespace impl
+#endif
+
+    template <typename T>
+    psh_proc psh_inline T atomic_load(Atomic<T> const* atomic, MemoryOrder order = MemoryOrder::SEQ_CST) psh_no_except {
+#if PSH_IMPL_ATOMIC_MSVC
+        // Aligned loads are atomic and have acquire semantics on x64.
+        psh_discard_value(order);
+        T value = *reinterpret_cast<T const volatile*>(&atomic->value);
+        _ReadWriteBarrier();
+        return value;
+#else
+        return __atomic_load_n(&atomic->value, static_cast<int>(order));
+#endif
+    }
+
+    template <typename T>
+    psh_proc psh_inline void atomic_store(Atomic<T>* atomic, T value, MemoryOrder order = MemoryOrder::SEQ_CST) psh_no_except {
+#if PSH_IMPL_ATOMIC_MSVC
+        psh_discard_value(order);
+        using I = impl::AtomicIntrinsic<T>;
+        if constexpr (sizeof(T) == 8) {
+            psh_discard_value(_InterlockedExchange64(reinterpret_cast<I volatile*>(&atomic->value), __builtin_bit_cast(I, value)));
+        } else {
+            psh_discard_value(_InterlockedExchange(reinterpret_cast<I volatile*>(&atomic->value), __builtin_bit_cast(I, value)));
+        }
+#else
+        __atomic_store_n(&atomic->value, value, static_cast<int>(order));
+#endif
+    }
+
+    /// Atomically replace the value, returning the previous one.
+    template <typename T>
+    psh_proc psh_inline T atomic_exchange(Atomic<T>* atomic, T value, MemoryOrder order = MemoryOrder::SEQ_CST) psh_no_except {
+#if PSH_IMPL_ATOMIC_MSVC
+        psh_discard_value(order);
+        using I = impl::AtomicIntrinsic<T>;
+        if constexpr (sizeof(T) == 8) {
+            return __builtin_bit_cast(T, _InterlockedExchange64(reinterpret_cast<I volatile*>(&atomic->value), __builtin_bit_cast(I, value)));
+        } else {
+            return __builtin_bit_cast(T, _InterlockedExchange(reinterpret_cast<I volatile*>(&atomic->value), __builtin_bit_cast(I, value)));
+        }
+#else
+        return __atomic_exchange_n(&atomic->value, value, static_cast<int>(order));
+#endif
+    }
+
+    /// Atomically add to an integer value, returning the previous value.
+    template <typename T>
+    psh_proc psh_inline T atomic_fetch_add(Atomic<T>* atomic, T addend, MemoryOrder order = MemoryOrder::SEQ_CST) psh_no_except {
+#if PSH_IMPL_ATOMIC_MSVC
+        psh_discard_value(order);
+        using I = impl::AtomicIntrinsic<T>;
+        if constexpr (sizeof(T) == 8) {
+            return static_cast<T>(_InterlockedExchangeAdd64(reinterpret_cast<I volatile*>(&atomic->value), static_cast<I>(addend)));
+        } else {
+            return static_cast<T>(_InterlockedExchangeAdd(reinterpret_cast<I volatile*>(&atomic->value), static_cast<I>(addend)));
+        }
+#else
+        return __atomic_fetch_add(&atomic->value, addend, static_cast<int>(order));
+#endif
+    }
+
+    /// Atomically subtract from an integer value, returning the previous value.
+    template <typename T>
+    psh_proc psh_inline T atomic_fetch_sub(Atomic<T>* atomic, T subtrahend, MemoryOrder order = MemoryOrder::SEQ_CST) psh_no_except {
+#if PSH_IMPL_ATOMIC_MSVC
+        return atomic_fetch_add(atomic, static_cast<T>(T{0} - subtrahend), order);
+#else
+        return __atomic_fetch_sub(&atomic->value, subtrahend, static_cast<int>(order));
+#endif
+    }
+
+    /// Atomically replace the value by desired if it is equal to expected.
+    ///
+    /// Return: Whether the value was replaced. On failure, expected is updated with the current value.
+    template <typename T>
+    psh_proc psh_inline bool atomic_compare_exchange(
+        Atomic<T>*  atomic,
+        T*          expected,
+        T           desired,
+        MemoryOrder order = MemoryOrder::SEQ_CST) psh_no_except {
+#if PSH_IMPL_ATOMIC_MSVC
+        psh_discard_value(order);
+        using I = impl::AtomicIntrinsic<T>;
+
+        I expected_value = __builtin_bit_cast(I, *expected);
+        I previous;
+        if constexpr (sizeof(T) == 8) {
+            previous = _InterlockedCompareExchange64(reinterpret_cast<I volatile*>(&atomic->value), __builtin_bit_cast(I, desired), expected_value);
+        } else {
+            previous = _InterlockedCompareExchange(reinterpret_cast<I volatile*>(&atomic->value), __builtin_bit_cast(I, desired), expected_value);
+        }
+
+        if (previous == expected_value) {
+            return true;
+        }
+        *expected = __builtin_bit_cast(T, previous);
+        return false;
+#else
+        // The failure ordering can't be stronger than the success one, nor have release semantics.
+        int failure_order = (order == MemoryOrder::ACQ_REL)   ? __ATOMIC_ACQUIRE
+                            : (order == MemoryOrder::RELEASE) ? __ATOMIC_RELAXED
+                                                              : static_cast<int>(order);
+        return __atomic_compare_exchange_n(&atomic->value, expected, desired, false, static_cast<int>(order), failure_order);
+#endif
+    }
+
+    /// Full memory fence.
+    psh_proc psh_inline void atomic_fence(MemoryOrder order = MemoryOrder::SEQ_CST) psh_no_except {
+#if PSH_IMPL_ATOMIC_MSVC
+        psh_discard_value(order);
+        _ReadWriteBarrier();
+        _mm_mfence();
+#else
+        __atomic_thread_fence(static_cast<int>(order));
+#endif
+    }
+
+    /// Hint the processor that the thread is spinning in a busy-wait loop.
+    psh_proc psh_inline void cpu_relax() psh_no_except {
+#if PSH_IMPL_ATOMIC_MSVC
+        _mm_pause();
+#elif PSH_ARCH_X64
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || PSH_ARCH_ARM
+        __asm__ __volatile__("yield");
+#endif
+    }
+}  // namespace psh
@@ -25,6 +25,15 @@
 #pragma once
 
 #include <limits.h>
+#include "psh_core.hpp"
+#include "psh_platform.hpp"
+
+#if PSH_COMPILER_MSVC
+#    include <intrin.h>
+#endif
+#if defined(__BMI2__)
+#    include <immintrin.h>
+#endif
 
 // -------------------------------------------------------------------------------------------------
 // Bit Manipulations.
@@ -138,3 +147,84 @@
 /// Rotate left by n digits.
 #define psh_int_rotl(val, n) \
     (static_cast<decltype(val)>((val << (n)) | (val >> (psh_value_bit_count(val) - (n)))))
+
+// -------------------------------------------------------------------------------------------------
+// Bit scanning.
+// -------------------------------------------------------------------------------------------------
+
+namespace psh {
+    /// Count the number of trailing zero bits of a value.
+    ///
+    /// Note: The value is assumed to be non-zero, otherwise the result is undefined.
+    psh_proc psh_inline u32 bit_count_trailing_zeros(u32 value) psh_no_except {
+#if PSH_COMPILER_MSVC
+        unsigned long idx;
+        _BitScanForward(&idx, value);
+        return static_cast<u32>(idx);
+#else
+        return static_cast<u32>(__builtin_ctz(value));
+#endif
+    }
+    psh_proc psh_inline u32 bit_count_trailing_zeros(u64 value) psh_no_except {
+#if PSH_COMPILER_MSVC
+        unsigned long idx;
+        _BitScanForward64(&idx, value);
+        return static_cast<u32>(idx);
+#else
+        return static_cast<u32>(__builtin_ctzll(value));
+#endif
+    }
+
+    /// Count the number of leading zero bits of a value.
+    ///
+    /// Note: The value is assumed to be non-zero, otherwise the result is undefined.
+    psh_proc psh_inline u32 bit_count_leading_zeros(u32 value) psh_no_except {
+#if PSH_COMPILER_MSVC
+        unsigned long idx;
+        _BitScanReverse(&idx, value);
+        return 31u - static_cast<u32>(idx);
+#else
+        return static_cast<u32>(__builtin_clz(value));
+#endif
+    }
+    psh_proc psh_inline u32 bit_count_leading_zeros(u64 value) psh_no_except {
+#if PSH_COMPILER_MSVC
+        unsigned long idx;
+        _BitScanReverse64(&idx, value);
+        return 63u - static_cast<u32>(idx);
+#else
+        return static_cast<u32>(__builtin_clzll(value));
+#endif
+    }
+
+    /// Count the number of bits set to 1.
+    psh_proc psh_inline u32 bit_count_ones(u32 value) psh_no_except {
+#if PSH_COMPILER_MSVC && !PSH_COMPILER_CLANG
+        return static_cast<u32>(__popcnt(value));
+#else
+        return static_cast<u32>(__builtin_popcount(value));
+#endif
+    }
+    psh_proc psh_inline u32 bit_count_ones(u64 value) psh_no_except {
+#if PSH_COMPILER_MSVC && !PSH_COMPILER_CLANG
+        return static_cast<u32>(__popcnt64(value));
+#else
+        return static_cast<u32>(__builtin_popcountll(value));
+#endif
+    }
+
+    /// Get the position of the n-th bit set to 1, counting from zero and starting at the least
+    /// significant bit.
+    ///
+    /// Note: The value is assumed to have more than n bits set, otherwise the result is undefined.
+    psh_proc psh_inline u32 bit_select(u64 value, u32 n) psh_no_except {
+#if defined(__BMI2__)
+        return bit_count_trailing_zeros(static_cast<u64>(_pdep_u64(u64{1} << n, value)));
+#else
+        for (u32 idx = 0; idx < n; ++idx) {
+            value &= value - 1u;
+        }
+        return bit_count_trailing_zeros(value);
+#endif
+    }
+}  // namespace psh
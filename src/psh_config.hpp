@@ -43,7 +43,24 @@
 //   copied don't overlap.
 // - PSH_ENABLE_ASSERT_NO_MEMORY_ERROR: When a memory acquisition function fails, abort the program.
 // - PSH_ENABLE_LOGGING: Enable logging calls to execute.
+// - PSH_LOG_MIN_LEVEL: Least severe level of the log calls compiled into the program, calls of
+//   lesser severity are entirely removed. The levels are, from most to least severe:
+//   PSH_LOG_LEVEL_FATAL, PSH_LOG_LEVEL_ERROR, PSH_LOG_LEVEL_WARNING, PSH_LOG_LEVEL_INFO, and
+//   PSH_LOG_LEVEL_DEBUG. Defaults to PSH_LOG_LEVEL_DEBUG when PSH_ENABLE_DEBUG is set, and to
+//   PSH_LOG_LEVEL_INFO otherwise.
 // - PSH_ENABLE_DEBUG: Enables all of the above debug checks.
+// - PSH_ENABLE_MEMORY_INSTRUMENTATION: Keep usage statistics for each allocator and attribute every
+//   allocation to its call site (this option isn't enabled via PSH_ENABLE_DEBUG, you have to set it
+//   manually).
+// - PSH_ENABLE_PROFILING: Compile the profiling zone macros of psh_profile.hpp, which are otherwise
+//   removed. This option is independent of PSH_ENABLE_DEBUG so that release builds can be profiled.
+// - PSH_ENABLE_FREESTANDING_MEMORY: Implement memory_set, memory_copy and memory_move with the
+//   library's own SIMD kernels instead of forwarding to libc's memset, memcpy and memmove. When
+//   building without libc, also prevent the compiler from recognising the kernels as library calls
+//   (e.g. -fno-builtin or -fno-tree-loop-distribute-patterns).
+// - PSH_MEMORY_NON_TEMPORAL_THRESHOLD: Size in bytes above which memory_copy and memory_set use
+//   non-temporal stores, bypassing the cache for writes that wouldn't fit in it anyway. Only has
+//   effect on x64. Defaults to 4 MiB.
 // - PSH_ENABLE_ANSI_COLOURS: When logging, use ANSI colour codes for pretty printing. This may not
 //   be desired if you're printing to a log file, hence the option is disabled by default.
 // - PSH_ENABLE_FORCED_INLINING: Disable the use of forced inlining hints via psh_inline.
@@ -129,6 +146,33 @@
 #if !defined(PSH_ENABLE_ANSI_COLOURS)
 #    define PSH_ENABLE_ANSI_COLOURS 0
 #endif
+#if !defined(PSH_ENABLE_MEMORY_INSTRUMENTATION)
+#    define PSH_ENABLE_MEMORY_INSTRUMENTATION 0
+#endif
+#if !defined(PSH_ENABLE_PROFILING)
+#    define PSH_ENABLE_PROFILING 0
+#endif
+#if !defined(PSH_ENABLE_FREESTANDING_MEMORY)
+#    define PSH_ENABLE_FREESTANDING_MEMORY 0
+#endif
+#if !defined(PSH_MEMORY_NON_TEMPORAL_THRESHOLD)
+#    define PSH_MEMORY_NON_TEMPORAL_THRESHOLD (4u * 1024u * 1024u)
+#endif
+
+// Log levels, matching the values of psh::impl::LogLevel.
+#define PSH_LOG_LEVEL_FATAL   0
+#define PSH_LOG_LEVEL_ERROR   1
+#define PSH_LOG_LEVEL_WARNING 2
+#define PSH_LOG_LEVEL_INFO    3
+#define PSH_LOG_LEVEL_DEBUG   4
+
+#if !defined(PSH_LOG_MIN_LEVEL)
+#    if defined(PSH_ENABLE_DEBUG) && PSH_ENABLE_DEBUG
+#        define PSH_LOG_MIN_LEVEL PSH_LOG_LEVEL_DEBUG
+#    else
+#        define PSH_LOG_MIN_LEVEL PSH_LOG_LEVEL_INFO
+#    endif
+#endif
 
 // @TODO: these are the new ones:
 
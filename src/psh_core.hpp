@@ -177,6 +177,17 @@ namespace psh {
 #    define psh_unlikely
 #endif
 
+/// Hint the processor to fetch the cache line of an address that is about to be read. Prefetching
+/// an invalid address is harmless.
+#if defined(__clang__) || defined(__GNUC__)
+#    define psh_prefetch(addr) __builtin_prefetch((addr), 0, 3)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#    include <intrin.h>
+#    define psh_prefetch(addr) _mm_prefetch(reinterpret_cast<char const*>(addr), _MM_HINT_T0)
+#else
+#    define psh_prefetch(addr) static_cast<void>(addr)
+#endif
+
 // -------------------------------------------------------------------------------------------------
 // Common operations.
 // -------------------------------------------------------------------------------------------------
@@ -61,6 +61,11 @@ namespace psh::impl {
         LOG_LEVEL_DEBUG,
         LOG_LEVEL_COUNT,
     };
+    static_assert(
+        (LOG_LEVEL_FATAL == PSH_LOG_LEVEL_FATAL) && (LOG_LEVEL_ERROR == PSH_LOG_LEVEL_ERROR)
+            && (LOG_LEVEL_WARNING == PSH_LOG_LEVEL_WARNING) && (LOG_LEVEL_INFO == PSH_LOG_LEVEL_INFO)
+            && (LOG_LEVEL_DEBUG == PSH_LOG_LEVEL_DEBUG),
+        "The log levels should match their preprocessor counterparts.");
 
     struct LogInfo {
         cstring  file_name;
@@ -69,13 +74,38 @@ namespace psh::impl {
         LogLevel level;
     };
 
-    /// Log a message to the standard error stream.
+    /// Log a message to the current log writer.
     psh_proc void log_msg(LogInfo info, cstring msg) psh_no_except;
 
-    /// Log a formatted message to the standard error stream.
+    /// Log a formatted message to the current log writer.
     psh_proc psh_attribute_fmt(2) void log_fmt(LogInfo const& info, cstring fmt, ...) psh_no_except;
 }  // namespace psh::impl
 
+namespace psh {
+    /// Location of a call in the source code.
+    struct SourceLocation {
+        cstring file_name;
+        cstring function_name;
+        u32     line;
+    };
+
+    /// Procedure receiving each formatted log message.
+    ///
+    /// Parameters:
+    ///     * context: Context registered alongside the writer.
+    ///     * info: Information about the call site of the log.
+    ///     * msg: Formatted message, including its header and trailing line feed. It isn't
+    ///            zero-terminated and is only valid during the call.
+    ///     * length: Number of characters of the message.
+    using LogWriter = void(void* context, impl::LogInfo const& info, char const* msg, usize length);
+
+    /// Replace the destination of the log messages, which is the standard error stream by default.
+    ///
+    /// A null writer restores the default destination. The writer shouldn't be replaced while other
+    /// threads may be logging.
+    psh_proc void set_log_writer(LogWriter* writer, void* context = nullptr) psh_no_except;
+}  // namespace psh
+
 // -------------------------------------------------------------------------------------------------
 // Logging macros.
 // -------------------------------------------------------------------------------------------------
@@ -89,33 +119,46 @@ namespace psh::impl {
         .level         = log_level,                  \
     }
 
-#if PSH_ENABLE_LOGGING
-#    define psh_log_fatal(msg)            psh::impl::log_msg(psh_impl_make_log_info(psh::impl::LOG_LEVEL_FATAL), msg)
-#    define psh_log_error(msg)            psh::impl::log_msg(psh_impl_make_log_info(psh::impl::LOG_LEVEL_ERROR), msg)
+// Calls whose level is less severe than PSH_LOG_MIN_LEVEL are compiled out.
+
+#if PSH_ENABLE_LOGGING && (PSH_LOG_MIN_LEVEL >= PSH_LOG_LEVEL_FATAL)
+#    define psh_log_fatal(msg)          psh::impl::log_msg(psh_impl_make_log_info(psh::impl::LOG_LEVEL_FATAL), msg)
+#    define psh_log_fatal_fmt(fmt, ...) psh::impl::log_fmt(psh_impl_make_log_info(psh::impl::LOG_LEVEL_FATAL), fmt, __VA_ARGS__)
+#else
+#    define psh_log_fatal(msg)          0
+#    define psh_log_fatal_fmt(fmt, ...) 0
+#endif
+
+#if PSH_ENABLE_LOGGING && (PSH_LOG_MIN_LEVEL >= PSH_LOG_LEVEL_ERROR)
+#    define psh_log_error(msg)          psh::impl::log_msg(psh_impl_make_log_info(psh::impl::LOG_LEVEL_ERROR), msg)
+#    define psh_log_error_fmt(fmt, ...) psh::impl::log_fmt(psh_impl_make_log_info(psh::impl::LOG_LEVEL_ERROR), fmt, __VA_ARGS__)
+#else
+#    define psh_log_error(msg)          0
+#    define psh_log_error_fmt(fmt, ...) 0
+#endif
+
+#if PSH_ENABLE_LOGGING && (PSH_LOG_MIN_LEVEL >= PSH_LOG_LEVEL_WARNING)
 #    define psh_log_warning(msg)          psh::impl::log_msg(psh_impl_make_log_info(psh::impl::LOG_LEVEL_WARNING), msg)
-#    define psh_log_info(msg)             psh::impl::log_msg(psh_impl_make_log_info(psh::impl::LOG_LEVEL_INFO), msg)
-#    define psh_log_fatal_fmt(fmt, ...)   psh::impl::log_fmt(psh_impl_make_log_info(psh::impl::LOG_LEVEL_FATAL), fmt, __VA_ARGS__)
-#    define psh_log_error_fmt(fmt, ...)   psh::impl::log_fmt(psh_impl_make_log_info(psh::impl::LOG_LEVEL_ERROR), fmt, __VA_ARGS__)
 #    define psh_log_warning_fmt(fmt, ...) psh::impl::log_fmt(psh_impl_make_log_info(psh::impl::LOG_LEVEL_WARNING), fmt, __VA_ARGS__)
-#    define psh_log_info_fmt(fmt, ...)    psh::impl::log_fmt(psh_impl_make_log_info(psh::impl::LOG_LEVEL_INFO), fmt, __VA_ARGS__)
-#    if PSH_ENABLE_DEBUG
-#        define psh_log_debug(msg)          psh::impl::log_msg(psh_impl_make_log_info(psh::impl::LOG_LEVEL_DEBUG), msg)
-#        define psh_log_debug_fmt(fmt, ...) psh::impl::log_fmt(psh_impl_make_log_info(psh::impl::LOG_LEVEL_DEBUG), fmt, __VA_ARGS__)
-#    else
-#        define psh_log_debug(msg)          0
-#        define psh_log_debug_fmt(fmt, ...) 0
-#    endif  // PSH_ENABLE_DEBUG
 #else
-#    define psh_log_fatal(msg)            0
-#    define psh_log_error(msg)            0
 #    define psh_log_warning(msg)          0
-#    define psh_log_info(msg)             0
-#    define psh_log_debug(msg)            0
-#    define psh_log_fatal_fmt(fmt, ...)   0
-#    define psh_log_error_fmt(fmt, ...)   0
 #    define psh_log_warning_fmt(fmt, ...) 0
-#    define psh_log_info_fmt(fmt, ...)    0
-#    define psh_log_debug_fmt(fmt, ...)   0
+#endif
+
+#if PSH_ENABLE_LOGGING && (PSH_LOG_MIN_LEVEL >= PSH_LOG_LEVEL_INFO)
+#    define psh_log_info(msg)          psh::impl::log_msg(psh_impl_make_log_info(psh::impl::LOG_LEVEL_INFO), msg)
+#    define psh_log_info_fmt(fmt, ...) psh::impl::log_fmt(psh_impl_make_log_info(psh::impl::LOG_LEVEL_INFO), fmt, __VA_ARGS__)
+#else
+#    define psh_log_info(msg)          0
+#    define psh_log_info_fmt(fmt, ...) 0
+#endif
+
+#if PSH_ENABLE_LOGGING && (PSH_LOG_MIN_LEVEL >= PSH_LOG_LEVEL_DEBUG)
+#    define psh_log_debug(msg)          psh::impl::log_msg(psh_impl_make_log_info(psh::impl::LOG_LEVEL_DEBUG), msg)
+#    define psh_log_debug_fmt(fmt, ...) psh::impl::log_fmt(psh_impl_make_log_info(psh::impl::LOG_LEVEL_DEBUG), fmt, __VA_ARGS__)
+#else
+#    define psh_log_debug(msg)          0
+#    define psh_log_debug_fmt(fmt, ...) 0
 #endif
 
 // -------------------------------------------------------------------------------------------------
@@ -82,9 +82,7 @@ namespace psh {
 
 namespace psh::impl {
     // @TODO:
-    // - Enable the user to set a different output stream for the logs.
     // - Remove dependency on stdio.h for windows by using WriteFile.
-    // - Use stb_sprintf for formatting.
     constexpr usize LOG_RESULT_MSG_MAX_LENGTH = PSH_LOG_HEADER_MAX_LENGTH + PSH_LOG_MSG_MAX_LENGTH;
 
     constexpr Buffer<cstring, LOG_LEVEL_COUNT> LOG_LEVEL_CSTRING = {
@@ -103,111 +101,139 @@ namespace psh::impl {
 #endif
     };
 
+    psh_internal void default_log_writer(void* context, LogInfo const& info, char const* msg, usize length) psh_no_except {
+        psh_discard_value(context);
+        psh_discard_value(info);
+        psh_discard_value(fwrite(msg, 1, length, stderr));
+    }
+
+    psh_internal LogWriter* log_writer         = default_log_writer;
+    psh_internal void*      log_writer_context = nullptr;
+
+    /// Send a formatted message, whose reported length may exceed the buffer when truncated, to the
+    /// log writer.
+    psh_internal void log_write(LogInfo const& info, char* msg, i32 length, usize buf_size) psh_no_except {
+        usize msg_length = psh_min_value(static_cast<usize>(length), buf_size - 1u);
+        if (msg_length != static_cast<usize>(length)) {
+            msg[msg_length - 1u] = '\n';
+        }
+        log_writer(log_writer_context, info, msg, msg_length);
+    }
+
 #if PSH_ENABLE_USE_STB_SPRINTF
     psh_proc void log_msg(LogInfo info, cstring msg) psh_no_except {
         Buffer<char, LOG_RESULT_MSG_MAX_LENGTH> result_msg;
-        {
-            i32 result_msg_length = string_format(
-                result_msg.buf,
-                result_msg.count,
-                PSH_LOG_HEADER_FMT " %s\n",
-                LOG_LEVEL_CSTRING[info.level],
-                info.file_name,
-                info.line,
-                info.function_name,
-                msg);
-            if (psh_unlikely(result_msg_length < 0)) {
-                fprintf(stderr, "[ERROR] Failed to format logging message.");
-                return;
-            }
+
+        i32 result_msg_length = string_format(
+            result_msg.buf,
+            result_msg.count,
+            PSH_LOG_HEADER_FMT " %s\n",
+            LOG_LEVEL_CSTRING[info.level],
+            info.file_name,
+            info.line,
+            info.function_name,
+            msg);
+        if (psh_unlikely(result_msg_length < 0)) {
+            fprintf(stderr, "[ERROR] Failed to format logging message.");
+            return;
         }
-        psh_discard_value(fprintf(stderr, "%s", result_msg.buf));
+
+        log_write(info, result_msg.buf, result_msg_length, result_msg.count);
     }
 
     psh_proc void log_fmt(LogInfo const& info, cstring fmt, ...) psh_no_except {
         Buffer<char, LOG_RESULT_MSG_MAX_LENGTH> result_msg;
+
+        i32 header_length = string_format(
+            result_msg.buf,
+            PSH_LOG_HEADER_MAX_LENGTH,
+            PSH_LOG_HEADER_FMT,
+            LOG_LEVEL_CSTRING[info.level],
+            info.file_name,
+            info.line,
+            info.function_name);
+        if (psh_unlikely(header_length < 0)) {
+            psh_log_fatal("Failed to format the header of the logging message.");
+        }
+        header_length = psh_min_value(header_length, static_cast<i32>(PSH_LOG_HEADER_MAX_LENGTH - 1));
+
+        // The resulting log message will have an additional space between the header and
+        // message, as well as a new-line escape sequence at the end of the end of the message
+        // and a null-terminator.
+        constexpr usize LOG_MSG_MAX_EFFECTIVE_LENGTH = PSH_LOG_MSG_MAX_LENGTH - 3;
+
+        result_msg.buf[header_length] = ' ';
+
+        char* msg_buf = result_msg.buf + (header_length + 1);
+
+        i32     msg_length;
+        va_list args;
+        va_start(args, fmt);
         {
-            i32 header_length = string_format(
-                result_msg.buf,
-                PSH_LOG_HEADER_MAX_LENGTH,
-                PSH_LOG_HEADER_FMT,
-                LOG_LEVEL_CSTRING[info.level],
-                info.file_name,
-                info.line,
-                info.function_name);
-            if (psh_unlikely(header_length < 0)) {
-                psh_log_fatal("Failed to format the header of the logging message.");
-            }
+            msg_length = string_format_list(
+                msg_buf,
+                LOG_MSG_MAX_EFFECTIVE_LENGTH,
+                fmt,
+                args);
+        }
+        va_end(args);
 
-            // The resulting log message will have an additional space between the header and
-            // message, as well as a new-line escape sequence at the end of the end of the message
-            // and a null-terminator.
-            constexpr usize LOG_MSG_MAX_EFFECTIVE_LENGTH = PSH_LOG_MSG_MAX_LENGTH - 3;
-
-            result_msg.buf[header_length] = ' ';
-
-            char* msg_buf = result_msg.buf + (header_length + 1);
-
-            va_list args;
-            va_start(args, fmt);
-            {
-                i32 msg_length = string_format_list(
-                    msg_buf,
-                    LOG_MSG_MAX_EFFECTIVE_LENGTH,
-                    fmt,
-                    args);
-                if (psh_unlikely(msg_length < 0)) {
-                    psh_log_error("Failed to parse user the formatted message string.");
-                    return;
-                }
-
-                msg_buf[msg_length]     = '\n';
-                msg_buf[msg_length + 1] = 0;
-            }
-            va_end(args);
+        if (psh_unlikely(msg_length < 0)) {
+            psh_log_error("Failed to parse user the formatted message string.");
+            return;
         }
 
-        psh_discard_value(fprintf(stderr, "%s", result_msg.buf));
+        msg_length = psh_min_value(msg_length, static_cast<i32>(LOG_MSG_MAX_EFFECTIVE_LENGTH - 1));
+
+        msg_buf[msg_length]     = '\n';
+        msg_buf[msg_length + 1] = 0;
+
+        log_write(info, result_msg.buf, header_length + msg_length + 2, result_msg.count);
     }
 #else   // !PSH_ENABLE_USE_STB_SPRINTF - use libc functions.
     psh_proc void log_msg(LogInfo info, cstring msg) psh_no_except {
-        psh_discard_value(fprintf(
-            stderr,
+        Buffer<char, LOG_RESULT_MSG_MAX_LENGTH> result_msg;
+
+        i32 result_msg_length = snprintf(
+            result_msg.buf,
+            result_msg.count,
             PSH_LOG_HEADER_FMT " %s\n",
             LOG_LEVEL_CSTRING[info.level],
             info.file_name,
             info.line,
             info.function_name,
-            msg));
+            msg);
+        if (psh_unlikely(result_msg_length < 0)) {
+            fprintf(stderr, "[ERROR] Failed to format logging message.");
+            return;
+        }
+
+        log_write(info, result_msg.buf, result_msg_length, result_msg.count);
     }
 
-    psh_internal ph_attribute_fmt(2) void log_fmt(LogInfo const& info, cstring fmt, ...) psh_no_except {
-        Buffer<char, LOG_RESULT_MSG_MAX_LENGTH> result_msg;
+    psh_proc psh_attribute_fmt(2) void log_fmt(LogInfo const& info, cstring fmt, ...) psh_no_except {
+        Buffer<char, PSH_LOG_MSG_MAX_LENGTH> user_msg;
 
         va_list args;
         va_start(args, fmt);
         {
             // Format the message with the given arguments.
-            i32 result_length = vsnprintf(result_msg.buf, result_msg.count, fmt, args);
+            i32 result_length = vsnprintf(user_msg.buf, user_msg.count, fmt, args);
             if (result_length < 0) {
                 psh_log_fatal("snptrintf unable to parse the format string and arguments");
                 abort_program();
             }
-
-            // Stamp the message with a null-terminator.
-            usize effective_msg_length       = psh_min_value(static_cast<usize>(result_length), result_msg.count);
-            result_msg[effective_msg_length] = 0;
         }
         va_end(args);
 
-        psh_discard_value(fprintf(
-            stderr,
-            PSH_LOG_HEADER_FMT " %s\n",
-            LOG_LEVEL_CSTRING[info.level],
-            info.file_name,
-            info.line,
-            info.function_name,
-            result_msg.buf));
+        log_msg(info, user_msg.buf);
     }
 #endif  // PSH_ENABLE_USE_STB_SPRINTF
 }  // namespace psh::impl
+
+namespace psh {
+    psh_proc void set_log_writer(LogWriter* writer, void* context) psh_no_except {
+        impl::log_writer         = (writer != nullptr) ? writer : impl::default_log_writer;
+        impl::log_writer_context = context;
+    }
+}  // namespace psh
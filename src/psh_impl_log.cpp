@@ -0,0 +1,978 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Implementation of the asynchronous logging backend.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include "psh_log.hpp"
+
+#include <string.h>
+#include "psh_string.hpp"
+
+#if PSH_OS_WINDOWS
+#    include <Windows.h>
+#elif PSH_OS_UNIX
+#    include <errno.h>
+#    include <fcntl.h>
+#    include <sys/uio.h>
+#    include <unistd.h>
+#endif
+
+namespace psh::impl {
+    psh_global constexpr u64 LOG_RECORD_COMMITTED   = u64{1} << 63u;
+    psh_global constexpr u64 LOG_RECORD_PADDING     = u64{1} << 62u;
+    psh_global constexpr u64 LOG_RECORD_LENGTH_MASK = (u64{1} << 32u) - 1u;
+    psh_global constexpr u64 LOG_RECORD_HEADER_SIZE = sizeof(u64);
+
+    /// Maximum number of records gathered by a single write.
+    psh_global constexpr u32 LOG_FLUSH_MAX_RECORDS = 64;
+
+    /// Current destination of the binary log records.
+    psh_global Atomic<AsyncLogger*> binary_logger = {};
+
+    /// Incremented for each new binary logger, so that call sites get defined again in its sink.
+    psh_global Atomic<u32> binary_logger_generation = {};
+
+    psh_global Atomic<u32> binary_log_site_count = {};
+
+    psh_internal psh_inline u64 log_record_size(u64 msg_length) psh_no_except {
+        return (LOG_RECORD_HEADER_SIZE + msg_length + 7u) & ~u64{7};
+    }
+
+    psh_internal psh_inline Atomic<u64>* log_record_header(AsyncLogger* logger, u64 position) psh_no_except {
+        return reinterpret_cast<Atomic<u64>*>(logger->buf + (position & (logger->capacity - 1u)));
+    }
+
+    psh_internal void async_logger_wake_flusher(AsyncLogger* logger) psh_no_except {
+        if (atomic_load(&logger->flusher_sleeping) != 0) {
+            mutex_lock(&logger->mutex);
+            condition_variable_signal(&logger->cv);
+            mutex_unlock(&logger->mutex);
+        }
+    }
+
+    psh_internal Status log_sink_open(cstring path, LogSink* sink) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(path));
+
+#if PSH_OS_WINDOWS
+        HANDLE handle = CreateFileA(path, FILE_APPEND_DATA, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (psh_unlikely(handle == INVALID_HANDLE_VALUE)) {
+            psh_log_error_fmt("Unable to open the log file %s due to the error: %lu", path, GetLastError());
+            return STATUS_FAILED;
+        }
+#elif PSH_OS_UNIX
+        i32 handle = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (psh_unlikely(handle == -1)) {
+            psh_log_error_fmt("Unable to open the log file %s.", path);
+            return STATUS_FAILED;
+        }
+#endif
+
+        *sink = handle;
+        return STATUS_OK;
+    }
+
+    psh_internal void log_sink_close(LogSink sink) psh_no_except {
+#if PSH_OS_WINDOWS
+        CloseHandle(sink);
+#elif PSH_OS_UNIX
+        close(sink);
+#endif
+    }
+
+    /// Write a sequence of messages to the sink, retrying on partial writes.
+    psh_internal void log_sink_write(LogSink sink, FatPtr<u8 const> const* msgs, u32 msg_count) psh_no_except {
+#if PSH_OS_WINDOWS
+        for (u32 idx = 0; idx < msg_count; ++idx) {
+            u8 const* buf    = msgs[idx].buf;
+            usize     remain = msgs[idx].count;
+            while (remain != 0) {
+                DWORD written = 0;
+                if (!WriteFile(sink, buf, static_cast<DWORD>(remain), &written, nullptr)) {
+                    return;  // There's no way to report a failure to log.
+                }
+                buf    += written;
+                remain -= written;
+            }
+        }
+#elif PSH_OS_UNIX
+        iovec iov[LOG_FLUSH_MAX_RECORDS];
+        for (u32 idx = 0; idx < msg_count; ++idx) {
+            iov[idx] = iovec{.iov_base = const_cast<u8*>(msgs[idx].buf), .iov_len = msgs[idx].count};
+        }
+
+        iovec* first     = iov;
+        i32    remaining = static_cast<i32>(msg_count);
+        while (remaining > 0) {
+            isize written = writev(sink, first, remaining);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;  // There's no way to report a failure to log.
+            }
+
+            // Skip the fully written messages and adjust the partially written one.
+            usize written_size = static_cast<usize>(written);
+            while ((remaining > 0) && (written_size >= first->iov_len)) {
+                written_size -= first->iov_len;
+                ++first;
+                --remaining;
+            }
+            if (remaining > 0) {
+                first->iov_base  = reinterpret_cast<u8*>(first->iov_base) + written_size;
+                first->iov_len  -= written_size;
+            }
+        }
+#endif
+    }
+
+    /// Write a batch of committed records to the sink.
+    ///
+    /// Return: Whether any record was consumed.
+    psh_internal bool async_logger_flush_batch(AsyncLogger* logger) psh_no_except {
+        u64 head = atomic_load(&logger->head, MemoryOrder::RELAXED);
+        u64 tail = atomic_load(&logger->tail, MemoryOrder::ACQUIRE);
+
+        FatPtr<u8 const> msgs[LOG_FLUSH_MAX_RECORDS];
+        u32              msg_count = 0;
+
+        u64 position = head;
+        while ((position != tail) && (msg_count < LOG_FLUSH_MAX_RECORDS)) {
+            u64 header = atomic_load(log_record_header(logger, position), MemoryOrder::ACQUIRE);
+            if ((header & LOG_RECORD_COMMITTED) == 0) {
+                break;  // The producer is still copying its message.
+            }
+
+            u64 length = header & LOG_RECORD_LENGTH_MASK;
+            if ((header & LOG_RECORD_PADDING) != 0) {
+                position += length;
+                continue;
+            }
+
+            u8 const* msg     = logger->buf + (position & (logger->capacity - 1u)) + LOG_RECORD_HEADER_SIZE;
+            msgs[msg_count++] = FatPtr<u8 const>{msg, static_cast<usize>(length)};
+            position         += log_record_size(length);
+        }
+
+        if (position == head) {
+            return false;
+        }
+
+        log_sink_write(logger->sink, msgs, msg_count);
+
+        // Zero the consumed records so that stale bytes are never mistaken for committed headers.
+        // Records never wrap around the end of the buffer, but the consumed range may.
+        usize start = static_cast<usize>(head & (logger->capacity - 1u));
+        usize size  = static_cast<usize>(position - head);
+        usize first = psh_min_value(size, logger->capacity - start);
+        memset(logger->buf + start, 0, first);
+        memset(logger->buf, 0, size - first);
+
+        atomic_store(&logger->head, position, MemoryOrder::RELEASE);
+        return true;
+    }
+
+    psh_internal void async_logger_flusher_proc(void* arg) psh_no_except {
+        AsyncLogger* logger = reinterpret_cast<AsyncLogger*>(arg);
+
+        for (;;) {
+            if (async_logger_flush_batch(logger)) {
+                continue;
+            }
+
+            // A record is reserved but not yet committed.
+            if (atomic_load(&logger->head) != atomic_load(&logger->tail)) {
+                thread_yield();
+                continue;
+            }
+
+            if (atomic_load(&logger->running) == 0) {
+                break;
+            }
+
+            // Producers check the sleeping flag after reserving their records, so either they see
+            // the flag and signal, or the flusher sees the new tail before waiting.
+            mutex_lock(&logger->mutex);
+            atomic_store(&logger->flusher_sleeping, 1u);
+            if ((atomic_load(&logger->head) == atomic_load(&logger->tail)) && (atomic_load(&logger->running) != 0)) {
+                condition_variable_wait(&logger->cv, &logger->mutex);
+            }
+            atomic_store(&logger->flusher_sleeping, 0u);
+            mutex_unlock(&logger->mutex);
+        }
+    }
+
+    /// Initialise the ring buffer of the logger and spawn its flusher thread.
+    psh_internal Status async_logger_start(AsyncLogger* logger, Arena* arena, LogSink sink, usize buffer_size) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(logger);
+            psh_assert_not_null(arena);
+            psh_assert_msg(psh_is_pow_of_two(buffer_size) && (buffer_size >= 64), "The buffer size should be a power of two.");
+        });
+
+        ArenaCheckpoint arena_checkpoint = make_arena_checkpoint(arena);
+
+        u8* buf = memory_alloc_align(arena, buffer_size, alignof(u64));
+        if (psh_unlikely(buf == nullptr)) {
+            return STATUS_FAILED;
+        }
+
+        logger->buf       = buf;
+        logger->capacity  = buffer_size;
+        logger->sink      = sink;
+        logger->owns_sink = false;
+        logger->binary    = false;
+        atomic_store(&logger->tail, u64{0});
+        atomic_store(&logger->head, u64{0});
+        atomic_store(&logger->running, 1u);
+        atomic_store(&logger->flusher_sleeping, 0u);
+        init_mutex(&logger->mutex);
+        init_condition_variable(&logger->cv);
+
+        if (psh_unlikely(!thread_create(&logger->flusher, async_logger_flusher_proc, logger))) {
+            psh_log_error("Unable to create the flusher thread of the asynchronous logger.");
+            destroy_condition_variable(&logger->cv);
+            destroy_mutex(&logger->mutex);
+            arena_checkpoint_restore(arena_checkpoint);
+            return STATUS_FAILED;
+        }
+
+        return STATUS_OK;
+    }
+
+    /// Reserve a record in the ring buffer and copy the message into it.
+    psh_internal void async_logger_push(AsyncLogger* logger, u8 const* msg, usize length) psh_no_except {
+        // Each record should fit in half of the buffer, so that the record and the padding needed
+        // to avoid wrapping around the end of the buffer never exceed its capacity.
+        u64 max_length = (logger->capacity / 2u) - LOG_RECORD_HEADER_SIZE;
+        u64 msg_length = psh_min_value(static_cast<u64>(length), max_length);
+        u64 size       = log_record_size(msg_length);
+
+        u64 tail;
+        u64 reserved;
+        for (;;) {
+            tail = atomic_load(&logger->tail, MemoryOrder::RELAXED);
+
+            u64 offset     = tail & (logger->capacity - 1u);
+            u64 contiguous = logger->capacity - offset;
+            reserved       = (size <= contiguous) ? size : (contiguous + size);
+
+            // Wait for the flusher to free enough space.
+            u64 head = atomic_load(&logger->head, MemoryOrder::ACQUIRE);
+            if (tail + reserved - head > logger->capacity) {
+                async_logger_wake_flusher(logger);
+                thread_yield();
+                continue;
+            }
+
+            if (atomic_compare_exchange(&logger->tail, &tail, tail + reserved)) {
+                break;
+            }
+        }
+
+        // Fill the space up to the end of the buffer with padding if the record doesn't fit.
+        u64 position = tail;
+        if (reserved != size) {
+            u64 padding = reserved - size;
+            atomic_store(log_record_header(logger, position), LOG_RECORD_COMMITTED | LOG_RECORD_PADDING | padding, MemoryOrder::RELEASE);
+            position += padding;
+        }
+
+        // Only text messages may be truncated, binary records always fit.
+        Atomic<u64>* header = log_record_header(logger, position);
+        memcpy(reinterpret_cast<u8*>(header) + LOG_RECORD_HEADER_SIZE, msg, static_cast<usize>(msg_length));
+        if (msg_length != length) {
+            reinterpret_cast<u8*>(header)[LOG_RECORD_HEADER_SIZE + msg_length - 1u] = '\n';
+        }
+        atomic_store(header, LOG_RECORD_COMMITTED | msg_length, MemoryOrder::RELEASE);
+
+        async_logger_wake_flusher(logger);
+    }
+}  // namespace psh::impl
+
+namespace psh {
+    psh_proc LogSink log_sink_stderr() psh_no_except {
+#if PSH_OS_WINDOWS
+        return GetStdHandle(STD_ERROR_HANDLE);
+#elif PSH_OS_UNIX
+        return STDERR_FILENO;
+#endif
+    }
+
+    psh_proc Status init_async_logger(AsyncLogger* logger, Arena* arena, LogSink sink, usize buffer_size) psh_no_except {
+        if (psh_unlikely(!impl::async_logger_start(logger, arena, sink, buffer_size))) {
+            return STATUS_FAILED;
+        }
+
+        set_log_writer(async_logger_write, logger);
+        return STATUS_OK;
+    }
+
+    psh_proc Status init_async_logger(AsyncLogger* logger, Arena* arena, cstring path, usize buffer_size) psh_no_except {
+        LogSink sink;
+        if (psh_unlikely(!impl::log_sink_open(path, &sink))) {
+            return STATUS_FAILED;
+        }
+
+        if (psh_unlikely(!init_async_logger(logger, arena, sink, buffer_size))) {
+            impl::log_sink_close(sink);
+            return STATUS_FAILED;
+        }
+
+        logger->owns_sink = true;
+        return STATUS_OK;
+    }
+
+    psh_proc void destroy_async_logger(AsyncLogger* logger) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(logger));
+
+        if (logger->binary) {
+            // Binary log calls made from now on are discarded.
+            atomic_store(&impl::binary_logger, static_cast<AsyncLogger*>(nullptr), MemoryOrder::RELEASE);
+        } else {
+            // Messages logged from now on are written directly by the logging thread.
+            set_log_writer(nullptr);
+        }
+
+        mutex_lock(&logger->mutex);
+        atomic_store(&logger->running, 0u);
+        condition_variable_signal(&logger->cv);
+        mutex_unlock(&logger->mutex);
+
+        thread_join(&logger->flusher);
+
+        destroy_condition_variable(&logger->cv);
+        destroy_mutex(&logger->mutex);
+
+        if (logger->owns_sink) {
+            impl::log_sink_close(logger->sink);
+        }
+
+        logger->buf       = nullptr;
+        logger->capacity  = 0;
+        logger->owns_sink = false;
+        logger->binary    = false;
+    }
+
+    psh_proc void async_logger_flush(AsyncLogger* logger) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(logger));
+
+        u64 target = atomic_load(&logger->tail);
+        while (atomic_load(&logger->head) < target) {
+            impl::async_logger_wake_flusher(logger);
+            thread_yield();
+        }
+    }
+
+    psh_proc void async_logger_write(void* context, impl::LogInfo const& info, char const* msg, usize length) psh_no_except {
+        AsyncLogger* logger = reinterpret_cast<AsyncLogger*>(context);
+
+        impl::async_logger_push(logger, reinterpret_cast<u8 const*>(msg), length);
+
+        // The program is about to be aborted, so the message should reach the sink right away.
+        if (info.level == impl::LOG_LEVEL_FATAL) {
+            async_logger_flush(logger);
+        }
+    }
+}  // namespace psh
+
+// -------------------------------------------------------------------------------------------------
+// Binary log encoding.
+// -------------------------------------------------------------------------------------------------
+
+namespace psh::impl {
+    psh_global constexpr u32 BINARY_LOG_SITE_DEFINITION = u32{1} << 31u;
+
+    /// Size of a record without any site definition nor arguments.
+    psh_global constexpr usize BINARY_LOG_RECORD_HEADER_SIZE = sizeof(u32) + sizeof(u32) + sizeof(f64);
+
+    /// Maximum length of each string of a call site definition, so that the definition always fits
+    /// in the record.
+    psh_global constexpr usize BINARY_LOG_MAX_SITE_STRING_LENGTH = BINARY_LOG_MAX_RECORD_SIZE / 4u;
+
+    psh_internal psh_inline void binary_log_encode(BinaryLogEncoder* encoder, void const* value, usize size) psh_no_except {
+        memcpy(encoder->buf + encoder->count, value, size);
+        encoder->count += size;
+    }
+
+    psh_internal void binary_log_encode_site_string(BinaryLogEncoder* encoder, cstring str) psh_no_except {
+        u16 length = static_cast<u16>(psh_min_value(cstring_length(str), BINARY_LOG_MAX_SITE_STRING_LENGTH));
+        binary_log_encode(encoder, &length, sizeof(length));
+        binary_log_encode(encoder, str, length);
+    }
+
+    psh_proc bool binary_log_begin(BinaryLogEncoder* encoder, BinaryLogSite* site) psh_no_except {
+        AsyncLogger* logger = atomic_load(&binary_logger, MemoryOrder::ACQUIRE);
+        if (logger == nullptr) {
+            return false;
+        }
+
+        // Intern the call site on its first call, racing threads agree on the first stored id.
+        u32 id = atomic_load(&site->id, MemoryOrder::RELAXED);
+        if (psh_unlikely(id == 0)) {
+            u32 new_id = atomic_fetch_add(&binary_log_site_count, 1u) + 1u;
+            if (atomic_compare_exchange(&site->id, &id, new_id)) {
+                id = new_id;
+            }
+        }
+        if (psh_unlikely(id > BINARY_LOG_MAX_SITE_COUNT)) {
+            return false;
+        }
+
+        // Threads racing on the first call of a site may all define it, which is harmless.
+        u32  generation   = atomic_load(&binary_logger_generation, MemoryOrder::ACQUIRE);
+        bool defines_site = (atomic_load(&site->defined_generation, MemoryOrder::ACQUIRE) != generation);
+
+        encoder->logger       = logger;
+        encoder->site         = site;
+        encoder->generation   = generation;
+        encoder->defines_site = defines_site;
+        encoder->truncated    = false;
+        encoder->count        = sizeof(u32);  // The size is written once the record is complete.
+
+        u32 site_id   = defines_site ? (id | BINARY_LOG_SITE_DEFINITION) : id;
+        f64 timestamp = current_time_in_seconds();
+        binary_log_encode(encoder, &site_id, sizeof(site_id));
+        binary_log_encode(encoder, &timestamp, sizeof(timestamp));
+
+        if (defines_site) {
+            u8 level = static_cast<u8>(site->level);
+            binary_log_encode(encoder, &level, sizeof(level));
+            binary_log_encode(encoder, &site->line, sizeof(site->line));
+            binary_log_encode_site_string(encoder, site->format);
+            binary_log_encode_site_string(encoder, site->file_name);
+            binary_log_encode_site_string(encoder, site->function_name);
+        }
+
+        return true;
+    }
+
+    psh_proc void binary_log_end(BinaryLogEncoder* encoder) psh_no_except {
+        u32 size = static_cast<u32>(encoder->count);
+        memcpy(encoder->buf, &size, sizeof(size));
+
+        async_logger_push(encoder->logger, encoder->buf, encoder->count);
+
+        // Any record reserved after this point is ordered after the definition in the sink.
+        if (encoder->defines_site) {
+            atomic_store(&encoder->site->defined_generation, encoder->generation, MemoryOrder::RELEASE);
+        }
+
+        if (encoder->site->level == LOG_LEVEL_FATAL) {
+            async_logger_flush(encoder->logger);
+        }
+    }
+
+    psh_proc void binary_log_pack_string(BinaryLogEncoder* encoder, cstring str) psh_no_except {
+        if (str == nullptr) {
+            str = "(null)";
+        }
+
+        usize length = cstring_length(str);
+        if (psh_unlikely(encoder->truncated || (encoder->count + 1u + sizeof(u16) + length > BINARY_LOG_MAX_RECORD_SIZE))) {
+            encoder->truncated = true;
+            return;
+        }
+
+        u16 encoded_length             = static_cast<u16>(length);
+        encoder->buf[encoder->count++] = BINARY_LOG_ARG_STRING;
+        binary_log_encode(encoder, &encoded_length, sizeof(encoded_length));
+        binary_log_encode(encoder, str, length);
+    }
+}  // namespace psh::impl
+
+namespace psh {
+    psh_proc Status init_binary_logger(AsyncLogger* logger, Arena* arena, LogSink sink, usize buffer_size) psh_no_except {
+        psh_validate_usage({
+            psh_assert_msg(buffer_size >= BINARY_LOGGER_MIN_BUFFER_SIZE, "The buffer of a binary logger should fit at least two records.");
+            psh_assert_msg(atomic_load(&impl::binary_logger) == nullptr, "A binary logger is already active.");
+        });
+
+        if (psh_unlikely(!impl::async_logger_start(logger, arena, sink, buffer_size))) {
+            return STATUS_FAILED;
+        }
+        logger->binary = true;
+
+        // The magic is written before any record can be pushed.
+        FatPtr<u8 const> magic = {BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC)};
+        impl::log_sink_write(sink, &magic, 1);
+
+        atomic_fetch_add(&impl::binary_logger_generation, 1u);
+        atomic_store(&impl::binary_logger, logger, MemoryOrder::RELEASE);
+        return STATUS_OK;
+    }
+
+    psh_proc Status init_binary_logger(AsyncLogger* logger, Arena* arena, cstring path, usize buffer_size) psh_no_except {
+        LogSink sink;
+        if (psh_unlikely(!impl::log_sink_open(path, &sink))) {
+            return STATUS_FAILED;
+        }
+
+        if (psh_unlikely(!init_binary_logger(logger, arena, sink, buffer_size))) {
+            impl::log_sink_close(sink);
+            return STATUS_FAILED;
+        }
+
+        logger->owns_sink = true;
+        return STATUS_OK;
+    }
+}  // namespace psh
+
+// -------------------------------------------------------------------------------------------------
+// Binary log decoding.
+// -------------------------------------------------------------------------------------------------
+
+namespace psh::impl {
+    psh_global constexpr usize BINARY_LOG_MAX_DECODED_LENGTH = 4096;
+    psh_global constexpr usize BINARY_LOG_MAX_SPEC_LENGTH    = 32;
+
+    constexpr Buffer<cstring, LOG_LEVEL_COUNT> BINARY_LOG_LEVEL_CSTRING = {
+        "[FATAL]",
+        "[ERROR]",
+        "[WARNING]",
+        "[INFO]",
+        "[DEBUG]",
+    };
+
+    struct BinaryLogDecodedSite {
+        cstring  format;
+        cstring  file_name;
+        cstring  function_name;
+        u32      line;
+        LogLevel level;
+        bool     defined;
+    };
+
+    struct BinaryLogReader {
+        u8 const* buf;
+        usize     count;
+        usize     offset;
+        bool      failed;
+    };
+
+    struct BinaryLogArg {
+        u8   type;
+        u64  bits;
+        f64  real;
+        char string[BINARY_LOG_MAX_RECORD_SIZE];
+    };
+
+    /// Decoded message being assembled.
+    struct BinaryLogLine {
+        char buf[BINARY_LOG_MAX_DECODED_LENGTH];
+        i32  length;
+    };
+
+    /// Conversion specifier being reconstructed.
+    struct BinaryLogSpec {
+        char  buf[BINARY_LOG_MAX_SPEC_LENGTH];
+        usize length;
+    };
+
+    psh_internal bool binary_log_read(BinaryLogReader* reader, void* value, usize size) psh_no_except {
+        if (reader->failed || (reader->count - reader->offset < size)) {
+            reader->failed = true;
+            return false;
+        }
+
+        memcpy(value, reader->buf + reader->offset, size);
+        reader->offset += size;
+        return true;
+    }
+
+    /// Read a string into a zero-terminated buffer.
+    psh_internal bool binary_log_read_string(BinaryLogReader* reader, char* buf, usize buf_size) psh_no_except {
+        u16 length = 0;
+        if (!binary_log_read(reader, &length, sizeof(length))) {
+            return false;
+        }
+
+        if (psh_unlikely(static_cast<usize>(length) >= buf_size)) {
+            reader->failed = true;
+            return false;
+        }
+
+        if (!binary_log_read(reader, buf, length)) {
+            return false;
+        }
+
+        buf[length] = 0;
+        return true;
+    }
+
+    /// Read a string of a call site definition, to be kept alive in the arena.
+    psh_internal cstring binary_log_read_site_string(BinaryLogReader* reader, Arena* arena) psh_no_except {
+        u16 length = 0;
+        if (!binary_log_read(reader, &length, sizeof(length))) {
+            return nullptr;
+        }
+
+        char* str = memory_alloc_uninit<char>(arena, static_cast<usize>(length) + 1u);
+        if (psh_unlikely(str == nullptr) || !binary_log_read(reader, str, length)) {
+            reader->failed = true;
+            return nullptr;
+        }
+
+        str[length] = 0;
+        return str;
+    }
+
+    psh_internal bool binary_log_read_arg(BinaryLogReader* reader, BinaryLogArg* arg) psh_no_except {
+        if (!binary_log_read(reader, &arg->type, sizeof(arg->type))) {
+            return false;
+        }
+
+        switch (arg->type) {
+            case BINARY_LOG_ARG_I32: {
+                i32 value = 0;
+                binary_log_read(reader, &value, sizeof(value));
+                arg->bits = static_cast<u64>(static_cast<i64>(value));
+                break;
+            }
+            case BINARY_LOG_ARG_U32: {
+                u32 value = 0;
+                binary_log_read(reader, &value, sizeof(value));
+                arg->bits = value;
+                break;
+            }
+            case BINARY_LOG_ARG_I64:
+            case BINARY_LOG_ARG_U64:
+            case BINARY_LOG_ARG_POINTER: {
+                binary_log_read(reader, &arg->bits, sizeof(arg->bits));
+                break;
+            }
+            case BINARY_LOG_ARG_F64: {
+                binary_log_read(reader, &arg->real, sizeof(arg->real));
+                break;
+            }
+            case BINARY_LOG_ARG_STRING: {
+                binary_log_read_string(reader, arg->string, sizeof(arg->string));
+                break;
+            }
+            default: {
+                reader->failed = true;
+                break;
+            }
+        }
+
+        return !reader->failed;
+    }
+
+    /// Append formatted text to the line.
+    ///
+    /// Note: This procedure deliberately lacks the format attribute, since the conversion specifiers
+    ///       given to it are reconstructed at runtime.
+    psh_internal void binary_log_line_append(BinaryLogLine* line, cstring fmt, ...) psh_no_except {
+        // Keep space for the trailing line feed.
+        i32 remaining = static_cast<i32>(BINARY_LOG_MAX_DECODED_LENGTH - 1u) - line->length;
+        if (remaining <= 1) {
+            return;
+        }
+
+        va_list args;
+        va_start(args, fmt);
+        i32 length = string_format_list(line->buf + line->length, remaining, fmt, args);
+        va_end(args);
+
+        if (length > 0) {
+            line->length += psh_min_value(length, remaining - 1);
+        }
+    }
+
+    psh_internal psh_inline void binary_log_spec_push(BinaryLogSpec* spec, char c) psh_no_except {
+        // Only the spec terminator and the conversion characters are pushed once the buffer is full.
+        if (spec->length < BINARY_LOG_MAX_SPEC_LENGTH - 4u) {
+            spec->buf[spec->length++] = c;
+        }
+    }
+
+    psh_internal psh_inline bool binary_log_is_integer(u8 type) psh_no_except {
+        return (type == BINARY_LOG_ARG_I32) || (type == BINARY_LOG_ARG_U32) || (type == BINARY_LOG_ARG_I64)
+               || (type == BINARY_LOG_ARG_U64);
+    }
+
+    /// Format the arguments of a record according to the format string of its call site.
+    ///
+    /// Each conversion specifier is rebuilt with the length modifier matching the encoded type of
+    /// its argument, so that the decoding doesn't depend on the integer sizes of the platform that
+    /// produced the logs.
+    psh_internal void binary_log_format_message(BinaryLogLine* line, cstring format, BinaryLogReader* args) psh_no_except {
+        BinaryLogArg arg;
+
+        cstring c = format;
+        while (*c != 0) {
+            if (*c != '%') {
+                cstring literal_end = c;
+                while ((*literal_end != 0) && (*literal_end != '%')) {
+                    ++literal_end;
+                }
+                binary_log_line_append(line, "%.*s", static_cast<i32>(literal_end - c), c);
+                c = literal_end;
+                continue;
+            }
+
+            cstring spec_start = c++;
+            if (*c == '%') {
+                binary_log_line_append(line, "%%");
+                ++c;
+                continue;
+            }
+
+            BinaryLogSpec spec;
+            spec.length  = 0;
+            bool valid   = true;
+            bool missing = false;
+            binary_log_spec_push(&spec, '%');
+
+            while ((*c == '-') || (*c == '+') || (*c == ' ') || (*c == '#') || (*c == '0')) {
+                binary_log_spec_push(&spec, *c++);
+            }
+
+            // Parse the width and the precision, replacing stars by their arguments.
+            for (u32 part = 0; part < 2; ++part) {
+                if (part == 1) {
+                    if (*c != '.') {
+                        break;
+                    }
+                    binary_log_spec_push(&spec, *c++);
+                }
+
+                if (*c == '*') {
+                    ++c;
+                    if (binary_log_read_arg(args, &arg) && binary_log_is_integer(arg.type)) {
+                        char  value[16];
+                        i32   value_length = string_format(value, static_cast<i32>(sizeof(value)), "%d", static_cast<i32>(arg.bits));
+                        for (i32 idx = 0; idx < value_length; ++idx) {
+                            binary_log_spec_push(&spec, value[idx]);
+                        }
+                    } else {
+                        valid = false;
+                    }
+                } else {
+                    while ((*c >= '0') && (*c <= '9')) {
+                        binary_log_spec_push(&spec, *c++);
+                    }
+                }
+            }
+
+            // The length modifiers are replaced according to the type of the argument.
+            while ((*c == 'h') || (*c == 'l') || (*c == 'j') || (*c == 'z') || (*c == 't') || (*c == 'L')) {
+                ++c;
+            }
+
+            char conversion = *c;
+            if (conversion == 0) {
+                binary_log_line_append(line, "%s", spec_start);
+                break;
+            }
+            ++c;
+
+            if (valid && !binary_log_read_arg(args, &arg)) {
+                valid   = false;
+                missing = true;
+            }
+
+            if (valid) {
+                switch (conversion) {
+                    case 'd':
+                    case 'i':
+                    case 'u':
+                    case 'o':
+                    case 'x':
+                    case 'X':
+                    case 'c': {
+                        if (!binary_log_is_integer(arg.type)) {
+                            valid = false;
+                        } else if ((arg.type == BINARY_LOG_ARG_I32) || (conversion == 'c')) {
+                            binary_log_spec_push(&spec, conversion);
+                            spec.buf[spec.length] = 0;
+                            binary_log_line_append(line, spec.buf, static_cast<i32>(arg.bits));
+                        } else if (arg.type == BINARY_LOG_ARG_U32) {
+                            binary_log_spec_push(&spec, conversion);
+                            spec.buf[spec.length] = 0;
+                            binary_log_line_append(line, spec.buf, static_cast<u32>(arg.bits));
+                        } else {
+                            spec.buf[spec.length++] = 'l';
+                            spec.buf[spec.length++] = 'l';
+                            spec.buf[spec.length++] = conversion;
+                            spec.buf[spec.length]   = 0;
+                            binary_log_line_append(line, spec.buf, static_cast<unsigned long long>(arg.bits));
+                        }
+                        break;
+                    }
+                    case 'f':
+                    case 'F':
+                    case 'e':
+                    case 'E':
+                    case 'g':
+                    case 'G':
+                    case 'a':
+                    case 'A': {
+                        if (arg.type != BINARY_LOG_ARG_F64) {
+                            valid = false;
+                            break;
+                        }
+                        binary_log_spec_push(&spec, conversion);
+                        spec.buf[spec.length] = 0;
+                        binary_log_line_append(line, spec.buf, arg.real);
+                        break;
+                    }
+                    case 's': {
+                        if (arg.type != BINARY_LOG_ARG_STRING) {
+                            valid = false;
+                            break;
+                        }
+                        binary_log_spec_push(&spec, conversion);
+                        spec.buf[spec.length] = 0;
+                        binary_log_line_append(line, spec.buf, arg.string);
+                        break;
+                    }
+                    case 'p': {
+                        if ((arg.type != BINARY_LOG_ARG_POINTER) && !binary_log_is_integer(arg.type)) {
+                            valid = false;
+                            break;
+                        }
+                        binary_log_spec_push(&spec, conversion);
+                        spec.buf[spec.length] = 0;
+                        binary_log_line_append(line, spec.buf, reinterpret_cast<void*>(static_cast<uptr>(arg.bits)));
+                        break;
+                    }
+                    default: {
+                        valid = false;
+                        break;
+                    }
+                }
+            }
+
+            if (!valid) {
+                cstring reason = missing ? "missing argument" : "invalid argument";
+                binary_log_line_append(line, "<%.*s: %s>", static_cast<i32>(c - spec_start), spec_start, reason);
+            }
+        }
+    }
+}  // namespace psh::impl
+
+namespace psh {
+    psh_proc Status binary_log_decode(Arena* arena, FatPtr<u8 const> data, LogWriter* writer, void* context) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(arena);
+            psh_assert_not_null(writer);
+        });
+
+        // Table of the call sites of the current session, indexed by their identifiers.
+        DynamicArray<impl::BinaryLogDecodedSite> sites = make_dynamic_array<impl::BinaryLogDecodedSite>(arena);
+
+        impl::BinaryLogReader reader = {.buf = data.buf, .count = data.count, .offset = 0, .failed = false};
+        impl::BinaryLogLine   line;
+        bool                  all_decoded = true;
+
+        while (reader.offset < reader.count) {
+            // A new logging session starts, with its own site identifiers.
+            if ((reader.count - reader.offset >= sizeof(BINARY_LOG_MAGIC))
+                && (memcmp(reader.buf + reader.offset, BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC)) == 0)) {
+                reader.offset += sizeof(BINARY_LOG_MAGIC);
+                dynamic_array_clear(&sites);
+                continue;
+            }
+
+            u32 size = 0;
+            if (!impl::binary_log_read(&reader, &size, sizeof(size))
+                || (size < impl::BINARY_LOG_RECORD_HEADER_SIZE)
+                || (size - sizeof(size) > reader.count - reader.offset)) {
+                psh_log_error_fmt("Malformed binary log record at offset %zu.", reader.offset);
+                return STATUS_FAILED;
+            }
+
+            impl::BinaryLogReader record = {
+                .buf    = reader.buf + reader.offset - sizeof(size),
+                .count  = size,
+                .offset = sizeof(size),
+                .failed = false,
+            };
+            reader.offset += size - sizeof(size);
+
+            u32 site_id   = 0;
+            f64 timestamp = 0.0;
+            impl::binary_log_read(&record, &site_id, sizeof(site_id));
+            impl::binary_log_read(&record, &timestamp, sizeof(timestamp));
+
+            u32 id = site_id & ~impl::BINARY_LOG_SITE_DEFINITION;
+            if ((site_id & impl::BINARY_LOG_SITE_DEFINITION) != 0) {
+                u8  level       = 0;
+                u32 line_number = 0;
+                impl::binary_log_read(&record, &level, sizeof(level));
+                impl::binary_log_read(&record, &line_number, sizeof(line_number));
+
+                impl::BinaryLogDecodedSite site;
+                site.format        = impl::binary_log_read_site_string(&record, arena);
+                site.file_name     = impl::binary_log_read_site_string(&record, arena);
+                site.function_name = impl::binary_log_read_site_string(&record, arena);
+                site.line          = line_number;
+                site.level         = static_cast<impl::LogLevel>(level);
+                site.defined       = !record.failed && (level < impl::LOG_LEVEL_COUNT);
+
+                // The identifier comes straight from the data, don't let it drive the allocation.
+                if (id > BINARY_LOG_MAX_SITE_COUNT) {
+                    all_decoded = false;
+                    continue;
+                }
+                while (sites.count <= id) {
+                    impl::BinaryLogDecodedSite undefined_site = {};
+                    if (psh_unlikely(!dynamic_array_push(&sites, undefined_site))) {
+                        return STATUS_FAILED;
+                    }
+                }
+                sites[id] = site;
+            }
+
+            if ((id >= sites.count) || !sites[id].defined || record.failed) {
+                all_decoded = false;
+                continue;
+            }
+
+            impl::BinaryLogDecodedSite const& site = sites[id];
+
+            line.length = 0;
+            impl::binary_log_line_append(
+                &line,
+                "%.6f %s [%s:%u:%s] ",
+                timestamp,
+                impl::BINARY_LOG_LEVEL_CSTRING[site.level],
+                site.file_name,
+                site.line,
+                site.function_name);
+            impl::binary_log_format_message(&line, site.format, &record);
+            line.buf[line.length++] = '\n';
+            line.buf[line.length]   = 0;
+
+            impl::LogInfo info = {
+                .file_name     = site.file_name,
+                .function_name = site.function_name,
+                .line          = site.line,
+                .level         = site.level,
+            };
+            writer(context, info, line.buf, static_cast<usize>(line.length));
+        }
+
+        return all_decoded ? STATUS_OK : STATUS_FAILED;
+    }
+}  // namespace psh
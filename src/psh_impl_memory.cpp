@@ -30,10 +30,28 @@
 #include "psh_math.hpp"
 #include "psh_platform.hpp"
 
+#if PSH_ARCH_SIMD_AVX2
+#    include <immintrin.h>
+#endif
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+#    include <stdarg.h>
+#    include <stdio.h>
+#    include "psh_atomic.hpp"
+#    if PSH_ENABLE_USE_STB_SPRINTF
+#        include "psh_string.hpp"
+#    endif
+#endif
+
 #if PSH_OS_WINDOWS
 #    include <Windows.h>
 #elif PSH_OS_UNIX
 #    include <sys/mman.h>
+#    include <unistd.h>
+#    if PSH_OS_LINUX
+#        include <fcntl.h>
+#        include <sys/syscall.h>
+#    endif
 #endif
 
 #if PSH_ENABLE_ASSERT_NO_MEMORY_ERROR
@@ -47,26 +65,149 @@
         return {}
 #endif
 
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+#    define psh_impl_log_allocation_site_of_failure(site) \
+        psh_log_error_fmt("Failed allocation requested at %s:%u (%s).", (site).file_name, (site).line, (site).function_name)
+#endif
+
 namespace psh {
     // -------------------------------------------------------------------------------------------------
     // Virtual memory.
     // -------------------------------------------------------------------------------------------------
 
+    namespace impl {
+        /// Touch every page of a range, forcing the system to back it with physical memory.
+        psh_internal void memory_virtual_prefault(u8* memory, usize size_bytes) psh_no_except {
+            usize        page_size = memory_virtual_page_size();
+            u8 volatile* pages     = memory;
+            for (usize offset = 0; offset < size_bytes; offset += page_size) {
+                pages[offset] = pages[offset];
+            }
+        }
+
+#if PSH_OS_WINDOWS
+        psh_internal u8* memory_virtual_alloc_on_node(usize size_bytes, DWORD allocation_type, DWORD protection, i32 numa_node) psh_no_except {
+            if (numa_node != VIRTUAL_MEMORY_ANY_NUMA_NODE) {
+                LPVOID buf = VirtualAllocExNuma(GetCurrentProcess(), nullptr, size_bytes, allocation_type, protection, static_cast<DWORD>(numa_node));
+                if (psh_likely(buf != nullptr)) {
+                    return reinterpret_cast<u8*>(buf);
+                }
+                psh_log_error_fmt("OS failed to allocate memory on NUMA node %d with error code: %lu", numa_node, GetLastError());
+            }
+            return reinterpret_cast<u8*>(VirtualAlloc(nullptr, size_bytes, allocation_type, protection));
+        }
+#elif PSH_OS_LINUX
+        // Memory policy binding pages to a set of nodes, as defined by linux/mempolicy.h.
+        psh_global constexpr i32   LINUX_MPOL_BIND       = 2;
+        psh_global constexpr usize LINUX_MAX_NUMA_NODES  = 1024;
+        psh_global constexpr usize LINUX_NODE_MASK_WIDTH = 8 * sizeof(unsigned long);
+
+        psh_internal void memory_virtual_advise_huge_pages(u8* memory, usize size_bytes) psh_no_except {
+            if (psh_unlikely(madvise(memory, size_bytes, MADV_HUGEPAGE) == -1)) {
+                psh_log_warning_fmt("OS refused transparent huge pages due to: %s", strerror(errno));
+            }
+        }
+
+        psh_internal void memory_virtual_bind_numa_node(u8* memory, usize size_bytes, i32 numa_node) psh_no_except {
+            if ((numa_node < 0) || (static_cast<usize>(numa_node) >= LINUX_MAX_NUMA_NODES)) {
+                psh_log_error_fmt("Unable to bind memory to the invalid NUMA node %d.", numa_node);
+                return;
+            }
+
+            unsigned long node_mask[LINUX_MAX_NUMA_NODES / LINUX_NODE_MASK_WIDTH] = {};
+            node_mask[static_cast<usize>(numa_node) / LINUX_NODE_MASK_WIDTH] =
+                1ul << (static_cast<usize>(numa_node) % LINUX_NODE_MASK_WIDTH);
+
+            // The kernel reads one bit less than the given amount of nodes.
+            long result = syscall(SYS_mbind, memory, size_bytes, LINUX_MPOL_BIND, node_mask, LINUX_MAX_NUMA_NODES + 1u, 0u);
+            if (psh_unlikely(result == -1)) {
+                psh_log_error_fmt("OS failed to bind memory to NUMA node %d due to: %s", numa_node, strerror(errno));
+            }
+        }
+#endif
+    }  // namespace impl
+
+    psh_proc usize memory_virtual_alloc_size(usize size_bytes, VirtualMemoryOptions options) psh_no_except {
+        if ((options.flags & VIRTUAL_MEMORY_FLAG_HUGE_PAGES) == 0) {
+            return size_bytes;
+        }
+
+        usize huge_page_size = memory_virtual_huge_page_size();
+        if (huge_page_size == 0) {
+            return size_bytes;
+        }
+        return ((size_bytes + huge_page_size - 1u) / huge_page_size) * huge_page_size;
+    }
+
     // @TODO: We should round this up to a multiple of a page-size.
-    psh_proc u8* memory_virtual_alloc(usize size_bytes) psh_no_except {
+    psh_proc u8* memory_virtual_alloc(usize size_bytes, VirtualMemoryOptions options) psh_no_except {
+        usize alloc_size = memory_virtual_alloc_size(size_bytes, options);
+        bool  huge_pages = ((options.flags & VIRTUAL_MEMORY_FLAG_HUGE_PAGES) != 0);
+        bool  prefault   = ((options.flags & VIRTUAL_MEMORY_FLAG_PREFAULT) != 0);
+
         u8* buf;
 #if PSH_OS_WINDOWS
-        buf = reinterpret_cast<u8*>(VirtualAlloc(nullptr, size_bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+        buf = nullptr;
+        if (huge_pages && (memory_virtual_huge_page_size() != 0)) {
+            buf = impl::memory_virtual_alloc_on_node(alloc_size, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE, options.numa_node);
+            if (buf == nullptr) {
+                psh_log_warning_fmt("OS failed to allocate large pages with error code: %lu", GetLastError());
+            }
+        }
+        if (buf == nullptr) {
+            buf = impl::memory_virtual_alloc_on_node(alloc_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE, options.numa_node);
+            if ((buf != nullptr) && prefault) {
+                impl::memory_virtual_prefault(buf, alloc_size);
+            }
+        }
 
 #    if PSH_ENABLE_ASSERT_NO_MEMORY_ERROR
         psh_assert_fmt(buf != nullptr, "OS failed to allocate memory with error code: %lu", GetLastError());
 #    endif
 #elif PSH_OS_UNIX
-        buf = reinterpret_cast<u8*>(mmap(nullptr, size_bytes, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
+        i32  map_flags = MAP_ANONYMOUS | MAP_PRIVATE;
+        bool populated = false;
+#    if PSH_OS_LINUX
+        // Pages faulted in by the mapping would escape both the huge page advice and the binding.
+        bool transparent = ((options.flags & VIRTUAL_MEMORY_FLAG_TRANSPARENT_HUGE_PAGES) != 0);
+        bool bind        = (options.numa_node != VIRTUAL_MEMORY_ANY_NUMA_NODE);
+
+        void* result = MAP_FAILED;
+        if (huge_pages && (alloc_size != 0)) {
+            populated = prefault && !bind;
+            result    = mmap(nullptr, alloc_size, PROT_READ | PROT_WRITE, map_flags | MAP_HUGETLB | (populated ? MAP_POPULATE : 0), -1, 0);
+            if (result == MAP_FAILED) {
+                psh_log_warning_fmt("OS failed to allocate huge pages due to: %s", strerror(errno));
+                transparent = true;
+            }
+        }
+        if (result == MAP_FAILED) {
+            populated = prefault && !transparent && !bind;
+            result    = mmap(nullptr, alloc_size, PROT_READ | PROT_WRITE, map_flags | (populated ? MAP_POPULATE : 0), -1, 0);
+            if ((result != MAP_FAILED) && transparent) {
+                impl::memory_virtual_advise_huge_pages(reinterpret_cast<u8*>(result), alloc_size);
+            }
+        }
+        if ((result != MAP_FAILED) && bind) {
+            impl::memory_virtual_bind_numa_node(reinterpret_cast<u8*>(result), alloc_size, options.numa_node);
+        }
+#    else
+        psh_discard_value(huge_pages);
+        void* result = mmap(nullptr, alloc_size, PROT_READ | PROT_WRITE, map_flags, -1, 0);
+#    endif
 
 #    if PSH_ENABLE_ASSERT_NO_MEMORY_ERROR
-        psh_assert_fmt(reinterpret_cast<void*>(buf) != MAP_FAILED, "OS failed to allocate memory due to: %s", strerror(errno));
+        psh_assert_fmt(result != MAP_FAILED, "OS failed to allocate memory due to: %s", strerror(errno));
 #    endif
+        if (psh_unlikely(result == MAP_FAILED)) {
+            psh_log_error_fmt("OS failed to allocate memory due to: %s", strerror(errno));
+            result = nullptr;
+        }
+
+        buf = reinterpret_cast<u8*>(result);
+        if ((buf != nullptr) && prefault && !populated) {
+            impl::memory_virtual_prefault(buf, alloc_size);
+        }
 #endif
         return buf;
     }
@@ -93,269 +234,2030 @@ namespace psh {
 #endif
     }
 
-    // -------------------------------------------------------------------------------------------------
-    // Memory moves.
-    // -------------------------------------------------------------------------------------------------
+    psh_proc usize memory_virtual_page_size() psh_no_except {
+        usize page_size;
+#if PSH_OS_WINDOWS
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        page_size = static_cast<usize>(info.dwPageSize);
+#elif PSH_OS_UNIX
+        page_size = static_cast<usize>(sysconf(_SC_PAGESIZE));
+#endif
+        return page_size;
+    }
 
-    psh_proc void memory_set(u8* memory, usize size_bytes, i32 fill) psh_no_except {
-        psh_paranoid_validate_usage(psh_assert_not_null(memory));
+    namespace impl {
+        /// Marks the cached huge page size as not yet read from the system.
+        psh_internal constexpr usize HUGE_PAGE_SIZE_UNKNOWN = ~usize{0};
 
-        if (psh_unlikely(size_bytes == 0)) {
-            return;
+        psh_internal Atomic<usize> huge_page_size_cache = {HUGE_PAGE_SIZE_UNKNOWN};
+
+        psh_internal usize memory_virtual_read_huge_page_size() psh_no_except {
+            usize huge_page_size = 0;
+#if PSH_OS_WINDOWS
+            huge_page_size = static_cast<usize>(GetLargePageMinimum());
+#elif PSH_OS_LINUX
+            // The default huge page size is listed by the kernel memory information as "Hugepagesize: N kB".
+            i32 fd = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+            if (psh_unlikely(fd == -1)) {
+                return 0;
+            }
+
+            char  info[4096];
+            usize info_size = 0;
+            while (info_size < sizeof(info) - 1u) {
+                isize read_size = read(fd, info + info_size, sizeof(info) - 1u - info_size);
+                if (read_size <= 0) {
+                    break;
+                }
+                info_size += static_cast<usize>(read_size);
+            }
+            close(fd);
+            info[info_size] = 0;
+
+            cstring field = strstr(info, "Hugepagesize:");
+            if (field != nullptr) {
+                field += sizeof("Hugepagesize:") - 1u;
+                while (*field == ' ') {
+                    ++field;
+                }
+                for (; ('0' <= *field) && (*field <= '9'); ++field) {
+                    huge_page_size = 10u * huge_page_size + static_cast<usize>(*field - '0');
+                }
+                huge_page_size *= 1024u;
+            }
+#endif
+            return huge_page_size;
+        }
+    }  // namespace impl
+
+    psh_proc usize memory_virtual_huge_page_size() psh_no_except {
+        // Reading the size can go through the file system, so it is only done on the first call.
+        // Racing first calls read the same value, so none of them needs to wait for the others.
+        usize huge_page_size = atomic_load(&impl::huge_page_size_cache, MemoryOrder::RELAXED);
+        if (psh_unlikely(huge_page_size == impl::HUGE_PAGE_SIZE_UNKNOWN)) {
+            huge_page_size = impl::memory_virtual_read_huge_page_size();
+            atomic_store(&impl::huge_page_size_cache, huge_page_size, MemoryOrder::RELAXED);
+        }
+        return huge_page_size;
+    }
+
+    psh_proc u8* memory_virtual_reserve(usize size_bytes, VirtualMemoryOptions options) psh_no_except {
+        u8* buf;
+#if PSH_OS_WINDOWS
+        // Large pages can't be committed separately from their reservation.
+        buf = impl::memory_virtual_alloc_on_node(size_bytes, MEM_RESERVE, PAGE_NOACCESS, options.numa_node);
+        if (psh_unlikely(buf == nullptr)) {
+            psh_log_error_fmt("OS failed to reserve memory with error code: %lu", GetLastError());
+        }
+#elif PSH_OS_UNIX
+        void* result = mmap(nullptr, size_bytes, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_NORESERVE, -1, 0);
+        if (psh_unlikely(result == MAP_FAILED)) {
+            psh_log_error_fmt("OS failed to reserve memory due to: %s", strerror(errno));
+            result = nullptr;
         }
+        buf = reinterpret_cast<u8*>(result);
 
-        psh_discard_value(memset(memory, fill, size_bytes));
+#    if PSH_OS_LINUX
+        if (buf != nullptr) {
+            u32 huge_flags = VIRTUAL_MEMORY_FLAG_HUGE_PAGES | VIRTUAL_MEMORY_FLAG_TRANSPARENT_HUGE_PAGES;
+            if ((options.flags & huge_flags) != 0) {
+                impl::memory_virtual_advise_huge_pages(buf, size_bytes);
+            }
+            if (options.numa_node != VIRTUAL_MEMORY_ANY_NUMA_NODE) {
+                impl::memory_virtual_bind_numa_node(buf, size_bytes, options.numa_node);
+            }
+        }
+#    else
+        psh_discard_value(options);
+#    endif
+#endif
+        return buf;
     }
 
-    psh_proc void memory_copy(u8* psh_no_alias dst, u8 const* psh_no_alias src, usize size_bytes) psh_no_except {
-        psh_paranoid_validate_usage({
-            psh_assert_not_null(dst);
-            psh_assert_not_null(src);
-            psh_assert_no_alias(src, dst);
-        });
+    psh_proc Status memory_virtual_commit(u8* memory, usize size_bytes, bool prefault) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(memory));
 
         if (psh_unlikely(size_bytes == 0)) {
-            return;
+            return STATUS_OK;
         }
 
-#if PSH_ENABLE_ASSERT_MEMCPY_NO_OVERLAP
-        psh_assert_msg(
-            (dst + size_bytes > src) || (dst < src + size_bytes),
-            "Source and destination overlap in copy region, which is undefined behaviour when using libc memcpy.");
+#if PSH_OS_WINDOWS
+        if (psh_unlikely(VirtualAlloc(memory, size_bytes, MEM_COMMIT, PAGE_READWRITE) == nullptr)) {
+            psh_log_error_fmt("OS failed to commit memory with error code: %lu", GetLastError());
+            return STATUS_FAILED;
+        }
+#elif PSH_OS_UNIX
+        if (psh_unlikely(mprotect(memory, size_bytes, PROT_READ | PROT_WRITE) == -1)) {
+            psh_log_error_fmt("OS failed to commit memory due to: %s", strerror(errno));
+            return STATUS_FAILED;
+        }
 #endif
 
-        psh_discard_value(memcpy(dst, src, size_bytes));
+        if (prefault) {
+            impl::memory_virtual_prefault(memory, size_bytes);
+        }
+        return STATUS_OK;
     }
 
-    psh_proc void memory_move(u8* psh_no_alias dst, u8 const* psh_no_alias src, usize size_bytes) psh_no_except {
-        psh_paranoid_validate_usage({
-            psh_assert_not_null(dst);
-            psh_assert_not_null(src);
-            psh_assert_no_alias(src, dst);
-        });
+    psh_proc void memory_virtual_decommit(u8* memory, usize size_bytes) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(memory));
 
         if (psh_unlikely(size_bytes == 0)) {
             return;
         }
 
-        psh_discard_value(memmove(dst, src, size_bytes));
+#if PSH_OS_WINDOWS
+        if (psh_unlikely(VirtualFree(memory, size_bytes, MEM_DECOMMIT) == FALSE)) {
+            psh_log_error_fmt("OS failed to decommit memory with error code: %lu", GetLastError());
+        }
+#elif PSH_OS_UNIX
+        // Drop the physical pages before revoking the access to the range.
+        if (psh_unlikely(madvise(memory, size_bytes, MADV_DONTNEED) == -1)) {
+            psh_log_error_fmt("OS failed to decommit memory due to: %s", strerror(errno));
+        }
+        if (psh_unlikely(mprotect(memory, size_bytes, PROT_NONE) == -1)) {
+            psh_log_error_fmt("OS failed to protect decommitted memory due to: %s", strerror(errno));
+        }
+#endif
     }
 
     // -------------------------------------------------------------------------------------------------
-    // Memory alignment.
+    // Memory moves.
     // -------------------------------------------------------------------------------------------------
 
-    psh_proc u32 padding_with_header(
-        uptr ptr_addr,
-        u32  alignment,
-        u32  header_size,
-        u32  header_alignment) psh_no_except {
-        psh_validate_usage({
-            psh_assert_fmt(
-                psh_is_pow_of_two(alignment),
-                "Expected the element alignment to be a power of two (got %u).",
-                alignment);
-            psh_assert_fmt(
-                psh_is_pow_of_two(header_alignment),
-                "Expected the header alignment to be a power of two (got %u).",
-                header_alignment);
-        });
+    // The bulk kernels are only reached for ranges larger than MEMORY_SMALL_SIZE, which is at least
+    // the size of a block, so the first and last blocks of a range can always be loaded whole. The
+    // range is processed in blocks, the last of which overlaps the previous one: that block is loaded
+    // before anything is stored so that the same loops also serve overlapping moves.
 
-        // Calculate the padding necessary for the alignment of the new block of memory.
-        u32 padding   = 0;
-        u32 mod_align = static_cast<u32>(ptr_addr & (static_cast<usize>(alignment) - 1u));  // @NOTE: Same as ptr_addr % alignment.
-        if (mod_align != 0) {
-            padding += alignment - mod_align;
+    namespace impl {
+#if PSH_ARCH_SIMD_AVX2
+        using MemoryBlock = __m256i;
+
+        psh_proc psh_inline MemoryBlock memory_block_load(u8 const* src) psh_no_except {
+            return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src));
         }
-        ptr_addr += padding;
+        psh_proc psh_inline void memory_block_store(u8* dst, MemoryBlock block) psh_no_except {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), block);
+        }
+        psh_proc psh_inline void memory_block_stream(u8* dst, MemoryBlock block) psh_no_except {
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), block);
+        }
+        psh_proc psh_inline MemoryBlock memory_block_broadcast(u8 fill) psh_no_except {
+            return _mm256_set1_epi8(static_cast<char>(fill));
+        }
+#elif PSH_ARCH_SIMD_SSE2
+        using MemoryBlock = __m128i;
 
-        // Padding necessary for the header alignment.
-        u32 mod_header = static_cast<u32>(ptr_addr & (static_cast<usize>(header_alignment) - 1u));  // @NOTE: Same as ptr_addr % header_alignment.
-        if (mod_header != 0) {
-            padding += header_alignment - mod_header;
+        psh_proc psh_inline MemoryBlock memory_block_load(u8 const* src) psh_no_except {
+            return _mm_loadu_si128(reinterpret_cast<__m128i const*>(src));
+        }
+        psh_proc psh_inline void memory_block_store(u8* dst, MemoryBlock block) psh_no_except {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), block);
+        }
+        psh_proc psh_inline void memory_block_stream(u8* dst, MemoryBlock block) psh_no_except {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst), block);
         }
+        psh_proc psh_inline MemoryBlock memory_block_broadcast(u8 fill) psh_no_except {
+            return _mm_set1_epi8(static_cast<char>(fill));
+        }
+#elif PSH_ARCH_SIMD_NEON
+        using MemoryBlock = uint8x16_t;
 
-        // The padding should at least contain the header.
-        padding += header_size;
+        psh_proc psh_inline MemoryBlock memory_block_load(u8 const* src) psh_no_except {
+            return vld1q_u8(src);
+        }
+        psh_proc psh_inline void memory_block_store(u8* dst, MemoryBlock block) psh_no_except {
+            vst1q_u8(dst, block);
+        }
+        psh_proc psh_inline MemoryBlock memory_block_broadcast(u8 fill) psh_no_except {
+            return vdupq_n_u8(fill);
+        }
+#else
+        using MemoryBlock = u64;
 
-        return padding;
-    }
+        psh_proc psh_inline MemoryBlock memory_block_load(u8 const* src) psh_no_except {
+            return memory_load_unaligned<u64>(src);
+        }
+        psh_proc psh_inline void memory_block_store(u8* dst, MemoryBlock block) psh_no_except {
+            memory_store_unaligned(dst, block);
+        }
+        psh_proc psh_inline MemoryBlock memory_block_broadcast(u8 fill) psh_no_except {
+            return u64{fill} * 0x0101010101010101ull;
+        }
+#endif
 
-    psh_proc uptr align_forward(uptr ptr_addr, u32 alignment) psh_no_except {
-        psh_paranoid_validate_usage(psh_assert_fmt(psh_is_pow_of_two(alignment), "Expected alignment (%u) to be a power of two.", alignment));
+        psh_global constexpr usize MEMORY_BLOCK_SIZE = sizeof(MemoryBlock);
+        static_assert(MEMORY_BLOCK_SIZE <= MEMORY_SMALL_SIZE, "Bulk kernels expect ranges of at least a block.");
 
-        usize mod_align = ptr_addr & (static_cast<usize>(alignment) - 1u);  // @NOTE: Same as ptr_addr % alignment.
-        if (mod_align != 0) {
-            ptr_addr += alignment - mod_align;
+#if PSH_ARCH_SIMD_SSE2
+        /// Write the bulk of the destination with cache-bypassing stores. The first block is written
+        /// with a regular store so that the streaming stores can start at an aligned address.
+        psh_internal void memory_copy_non_temporal(u8* psh_no_alias dst, u8 const* psh_no_alias src, usize size_bytes) psh_no_except {
+            MemoryBlock last = memory_block_load(src + size_bytes - MEMORY_BLOCK_SIZE);
+            memory_block_store(dst, memory_block_load(src));
+
+            usize idx = MEMORY_BLOCK_SIZE - (reinterpret_cast<uptr>(dst) & (MEMORY_BLOCK_SIZE - 1u));
+            for (; idx + MEMORY_BLOCK_SIZE <= size_bytes; idx += MEMORY_BLOCK_SIZE) {
+                psh_prefetch(src + idx + 8u * MEMORY_BLOCK_SIZE);
+                memory_block_stream(dst + idx, memory_block_load(src + idx));
+            }
+            _mm_sfence();
+
+            memory_block_store(dst + size_bytes - MEMORY_BLOCK_SIZE, last);
         }
 
-        return ptr_addr;
-    }
+        psh_internal void memory_set_non_temporal(u8* memory, usize size_bytes, u8 fill) psh_no_except {
+            MemoryBlock pattern = memory_block_broadcast(fill);
+            memory_block_store(memory, pattern);
 
-    // -------------------------------------------------------------------------------------------------
-    // Arena allocator implementation.
-    // -------------------------------------------------------------------------------------------------
+            usize idx = MEMORY_BLOCK_SIZE - (reinterpret_cast<uptr>(memory) & (MEMORY_BLOCK_SIZE - 1u));
+            for (; idx + MEMORY_BLOCK_SIZE <= size_bytes; idx += MEMORY_BLOCK_SIZE) {
+                memory_block_stream(memory + idx, pattern);
+            }
+            _mm_sfence();
 
-    psh_proc Arena make_owned_arena(usize capacity) psh_no_except {
-        u8* buf = memory_virtual_alloc(capacity);
-        return Arena{
-            .buf      = buf,
-            .capacity = (buf != nullptr) ? capacity : 0,
-            .offset   = 0,
-        };
-    }
+            memory_block_store(memory + size_bytes - MEMORY_BLOCK_SIZE, pattern);
+        }
+#endif
 
-    psh_proc void destroy_owned_arena(Arena* arena) psh_no_except {
-        psh_paranoid_validate_usage(psh_assert_not_null(arena));
+#if PSH_ENABLE_FREESTANDING_MEMORY
+        /// Copy from the lowest to the highest address, valid whenever dst <= src.
+        psh_internal void memory_move_forward(u8* dst, u8 const* src, usize size_bytes) psh_no_except {
+            MemoryBlock last = memory_block_load(src + size_bytes - MEMORY_BLOCK_SIZE);
+            for (usize idx = 0; idx + MEMORY_BLOCK_SIZE < size_bytes; idx += MEMORY_BLOCK_SIZE) {
+                memory_block_store(dst + idx, memory_block_load(src + idx));
+            }
+            memory_block_store(dst + size_bytes - MEMORY_BLOCK_SIZE, last);
+        }
 
-        usize capacity  = arena->capacity;
-        arena->capacity = 0;
-        memory_virtual_free(arena->buf, capacity);
-    }
+        /// Copy from the highest to the lowest address, valid whenever dst >= src.
+        psh_internal void memory_move_backward(u8* dst, u8 const* src, usize size_bytes) psh_no_except {
+            MemoryBlock first = memory_block_load(src);
+            for (usize idx = size_bytes; idx > MEMORY_BLOCK_SIZE; idx -= MEMORY_BLOCK_SIZE) {
+                memory_block_store(dst + idx - MEMORY_BLOCK_SIZE, memory_block_load(src + idx - MEMORY_BLOCK_SIZE));
+            }
+            memory_block_store(dst, first);
+        }
+#endif
 
-    // -------------------------------------------------------------------------------------------------
-    // Stack memory allocator implementation.
-    // -------------------------------------------------------------------------------------------------
+        psh_proc void memory_set_bulk(u8* memory, usize size_bytes, u8 fill) psh_no_except {
+#if PSH_ARCH_SIMD_SSE2
+            if (size_bytes >= PSH_MEMORY_NON_TEMPORAL_THRESHOLD) {
+                memory_set_non_temporal(memory, size_bytes, fill);
+                return;
+            }
+#endif
 
-    u8* Stack::top() psh_no_except {
-        psh_paranoid_validate_usage(psh_assert_msg(this->buf != nullptr, "Stack uninitialised."));
+#if PSH_ENABLE_FREESTANDING_MEMORY
+            MemoryBlock pattern = memory_block_broadcast(fill);
+            for (usize idx = 0; idx + MEMORY_BLOCK_SIZE < size_bytes; idx += MEMORY_BLOCK_SIZE) {
+                memory_block_store(memory + idx, pattern);
+            }
+            memory_block_store(memory + size_bytes - MEMORY_BLOCK_SIZE, pattern);
+#else
+            psh_discard_value(memset(memory, fill, size_bytes));
+#endif
+        }
 
-        return this->buf + this->previous_offset;
-    }
+        psh_proc void memory_copy_bulk(u8* psh_no_alias dst, u8 const* psh_no_alias src, usize size_bytes) psh_no_except {
+#if PSH_ARCH_SIMD_SSE2
+            if (size_bytes >= PSH_MEMORY_NON_TEMPORAL_THRESHOLD) {
+                memory_copy_non_temporal(dst, src, size_bytes);
+                return;
+            }
+#endif
 
-    StackHeader const* Stack::top_header() const psh_no_except {
-        psh_paranoid_validate_usage(psh_assert_msg(this->buf != nullptr, "Stack uninitialised."));
+#if PSH_ENABLE_FREESTANDING_MEMORY
+            memory_move_forward(dst, src, size_bytes);
+#else
+            psh_discard_value(memcpy(dst, src, size_bytes));
+#endif
+        }
 
-        return reinterpret_cast<StackHeader const*>(pointer_add_bytes(this->buf, this->previous_offset - psh_usize_of(StackHeader)));
-    }
+        psh_proc void memory_move_bulk(u8* dst, u8 const* src, usize size_bytes) psh_no_except {
+            bool disjoint = (dst + size_bytes <= src) || (src + size_bytes <= dst);
+            if (disjoint) {
+                memory_copy_bulk(dst, src, size_bytes);
+                return;
+            }
 
-    usize Stack::top_size() const psh_no_except {
-        StackHeader const* header = this->top_header();
-        return (header == nullptr) ? 0 : header->capacity;
-    }
+#if PSH_ENABLE_FREESTANDING_MEMORY
+            if (dst <= src) {
+                memory_move_forward(dst, src, size_bytes);
+            } else {
+                memory_move_backward(dst, src, size_bytes);
+            }
+#else
+            psh_discard_value(memmove(dst, src, size_bytes));
+#endif
+        }
+    }  // namespace impl
 
-    usize Stack::top_previous_offset() const psh_no_except {
-        StackHeader const* header = this->top_header();
-        return (header == nullptr) ? 0 : header->previous_offset;
-    }
+    // -------------------------------------------------------------------------------------------------
+    // Memory search.
+    //
+    // Each procedure compares whole blocks against the broadcasted value and extracts a bit mask of
+    // the matching bytes, whose trailing zero count gives the byte offset of the first match within
+    // the block. The remaining elements are compared one at a time.
+    // -------------------------------------------------------------------------------------------------
 
-    StackHeader const* Stack::header_of(u8 const* block) const psh_no_except {
-        psh_validate_usage(psh_assert_not_null(block));
-        psh_paranoid_validate_usage(psh_assert_msg(this->buf != nullptr, "Stack uninitialised."));
+#if PSH_ARCH_SIMD_NEON
+    namespace impl {
+        /// Compress a 16-byte comparison result into a 64-bit mask with 4 bits per byte.
+        psh_proc psh_inline u64 neon_byte_mask(uint8x16_t cmp) psh_no_except {
+            uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+            return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+        }
+    }  // namespace impl
+#endif
 
-        u8 const* memory_start = this->buf;
-        u8 const* block_header = block + psh_usize_of(StackHeader);
+    psh_proc isize memory_find_u8(u8 const* memory, usize count, u8 value) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_msg((count == 0) || (memory != nullptr), "Null memory with non-zero count."));
 
-        bool valid = (block >= memory_start)
-                     && (block <= memory_start + this->capacity)
-                     && (block <= memory_start + this->previous_offset)
-                     && (block_header >= memory_start);
+        usize idx = 0;
 
-        return valid ? reinterpret_cast<StackHeader const*>(block_header) : nullptr;
-    }
+#if PSH_ARCH_SIMD_AVX2
+        __m256i value_256 = _mm256_set1_epi8(static_cast<char>(value));
+        for (; idx + 32u <= count; idx += 32u) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(memory + idx));
+            u32     mask  = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, value_256)));
+            if (mask != 0) {
+                return static_cast<isize>(idx + bit_count_trailing_zeros(mask));
+            }
+        }
+#endif
+#if PSH_ARCH_SIMD_SSE2
+        __m128i value_128 = _mm_set1_epi8(static_cast<char>(value));
+        for (; idx + 16u <= count; idx += 16u) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(memory + idx));
+            u32     mask  = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, value_128)));
+            if (mask != 0) {
+                return static_cast<isize>(idx + bit_count_trailing_zeros(mask));
+            }
+        }
+#elif PSH_ARCH_SIMD_NEON
+        uint8x16_t value_128 = vdupq_n_u8(value);
+        for (; idx + 16u <= count; idx += 16u) {
+            u64 mask = impl::neon_byte_mask(vceqq_u8(vld1q_u8(memory + idx), value_128));
+            if (mask != 0) {
+                return static_cast<isize>(idx + bit_count_trailing_zeros(mask) / 4u);
+            }
+        }
+#endif
 
-    usize Stack::size_of(u8 const* block) const psh_no_except {
-        StackHeader const* header = this->header_of(block);
-        return (header == nullptr) ? 0 : header->capacity;
+        for (; idx < count; ++idx) {
+            if (memory[idx] == value) {
+                return static_cast<isize>(idx);
+            }
+        }
+        return -1;
     }
 
-    usize Stack::previous_offset_of(u8 const* block) const psh_no_except {
-        StackHeader const* header = this->header_of(block);
-        return (header == nullptr) ? 0 : header->previous_offset;
-    }
+    psh_proc isize memory_find_u32(u32 const* memory, usize count, u32 value) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_msg((count == 0) || (memory != nullptr), "Null memory with non-zero count."));
 
-    Status Stack::pop() psh_no_except {
-        if (psh_unlikely(this->previous_offset == 0)) {
-            return STATUS_FAILED;
+        usize idx = 0;
+
+#if PSH_ARCH_SIMD_AVX2
+        __m256i value_256 = _mm256_set1_epi32(static_cast<i32>(value));
+        for (; idx + 8u <= count; idx += 8u) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(memory + idx));
+            u32     mask  = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi32(block, value_256)));
+            if (mask != 0) {
+                return static_cast<isize>(idx + bit_count_trailing_zeros(mask) / 4u);
+            }
+        }
+#endif
+#if PSH_ARCH_SIMD_SSE2
+        __m128i value_128 = _mm_set1_epi32(static_cast<i32>(value));
+        for (; idx + 4u <= count; idx += 4u) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(memory + idx));
+            u32     mask  = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi32(block, value_128)));
+            if (mask != 0) {
+                return static_cast<isize>(idx + bit_count_trailing_zeros(mask) / 4u);
+            }
+        }
+#elif PSH_ARCH_SIMD_NEON
+        uint32x4_t value_128 = vdupq_n_u32(value);
+        for (; idx + 4u <= count; idx += 4u) {
+            uint8x16_t cmp  = vreinterpretq_u8_u32(vceqq_u32(vld1q_u32(memory + idx), value_128));
+            u64        mask = impl::neon_byte_mask(cmp);
+            if (mask != 0) {
+                return static_cast<isize>(idx + bit_count_trailing_zeros(mask) / 16u);
+            }
         }
+#endif
 
-        u8 const*          top        = pointer_add_bytes(this->buf, this->previous_offset);
-        StackHeader const* top_header = reinterpret_cast<StackHeader const*>(pointer_const_subtract_bytes(top, psh_isize_of(StackHeader)));
+        for (; idx < count; ++idx) {
+            if (memory[idx] == value) {
+                return static_cast<isize>(idx);
+            }
+        }
+        return -1;
+    }
 
-        this->offset          = this->previous_offset - top_header->padding;
-        this->previous_offset = top_header->previous_offset;
+    psh_proc isize memory_find_u64(u64 const* memory, usize count, u64 value) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_msg((count == 0) || (memory != nullptr), "Null memory with non-zero count."));
+
+        usize idx = 0;
+
+#if PSH_ARCH_SIMD_AVX2
+        __m256i value_256 = _mm256_set1_epi64x(static_cast<i64>(value));
+        for (; idx + 4u <= count; idx += 4u) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(memory + idx));
+            u32     mask  = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi64(block, value_256)));
+            if (mask != 0) {
+                return static_cast<isize>(idx + bit_count_trailing_zeros(mask) / 8u);
+            }
+        }
+#endif
+#if PSH_ARCH_SIMD_SSE2
+        // SSE2 lacks 64-bit comparisons: both 32-bit halves of an element should match.
+        __m128i value_128 = _mm_set1_epi64x(static_cast<i64>(value));
+        for (; idx + 2u <= count; idx += 2u) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(memory + idx));
+            __m128i cmp   = _mm_cmpeq_epi32(block, value_128);
+            cmp           = _mm_and_si128(cmp, _mm_shuffle_epi32(cmp, _MM_SHUFFLE(2, 3, 0, 1)));
+            u32 mask      = static_cast<u32>(_mm_movemask_epi8(cmp));
+            if (mask != 0) {
+                return static_cast<isize>(idx + bit_count_trailing_zeros(mask) / 8u);
+            }
+        }
+#elif PSH_ARCH_SIMD_NEON
+        uint32x4_t value_128 = vreinterpretq_u32_u64(vdupq_n_u64(value));
+        for (; idx + 2u <= count; idx += 2u) {
+            uint32x4_t cmp = vceqq_u32(vreinterpretq_u32_u64(vld1q_u64(memory + idx)), value_128);
+            cmp            = vandq_u32(cmp, vrev64q_u32(cmp));
+            u64 mask       = impl::neon_byte_mask(vreinterpretq_u8_u32(cmp));
+            if (mask != 0) {
+                return static_cast<isize>(idx + bit_count_trailing_zeros(mask) / 32u);
+            }
+        }
+#endif
+
+        for (; idx < count; ++idx) {
+            if (memory[idx] == value) {
+                return static_cast<isize>(idx);
+            }
+        }
+        return -1;
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Bit set kernels.
+    // -------------------------------------------------------------------------------------------------
+
+    namespace impl {
+        psh_proc void bit_words_and(u64* dst, u64 const* src, usize word_count) psh_no_except {
+            usize idx = 0;
+#if PSH_ARCH_SIMD_AVX2
+            for (; idx + 4u <= word_count; idx += 4u) {
+                __m256i d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst + idx));
+                __m256i s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + idx));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + idx), _mm256_and_si256(d, s));
+            }
+#endif
+#if PSH_ARCH_SIMD_SSE2
+            for (; idx + 2u <= word_count; idx += 2u) {
+                __m128i d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + idx));
+                __m128i s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + idx));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + idx), _mm_and_si128(d, s));
+            }
+#elif PSH_ARCH_SIMD_NEON
+            for (; idx + 2u <= word_count; idx += 2u) {
+                vst1q_u64(dst + idx, vandq_u64(vld1q_u64(dst + idx), vld1q_u64(src + idx)));
+            }
+#endif
+            for (; idx < word_count; ++idx) {
+                dst[idx] &= src[idx];
+            }
+        }
+
+        psh_proc void bit_words_or(u64* dst, u64 const* src, usize word_count) psh_no_except {
+            usize idx = 0;
+#if PSH_ARCH_SIMD_AVX2
+            for (; idx + 4u <= word_count; idx += 4u) {
+                __m256i d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst + idx));
+                __m256i s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + idx));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + idx), _mm256_or_si256(d, s));
+            }
+#endif
+#if PSH_ARCH_SIMD_SSE2
+            for (; idx + 2u <= word_count; idx += 2u) {
+                __m128i d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + idx));
+                __m128i s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + idx));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + idx), _mm_or_si128(d, s));
+            }
+#elif PSH_ARCH_SIMD_NEON
+            for (; idx + 2u <= word_count; idx += 2u) {
+                vst1q_u64(dst + idx, vorrq_u64(vld1q_u64(dst + idx), vld1q_u64(src + idx)));
+            }
+#endif
+            for (; idx < word_count; ++idx) {
+                dst[idx] |= src[idx];
+            }
+        }
+
+        psh_proc void bit_words_xor(u64* dst, u64 const* src, usize word_count) psh_no_except {
+            usize idx = 0;
+#if PSH_ARCH_SIMD_AVX2
+            for (; idx + 4u <= word_count; idx += 4u) {
+                __m256i d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst + idx));
+                __m256i s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + idx));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + idx), _mm256_xor_si256(d, s));
+            }
+#endif
+#if PSH_ARCH_SIMD_SSE2
+            for (; idx + 2u <= word_count; idx += 2u) {
+                __m128i d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + idx));
+                __m128i s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + idx));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + idx), _mm_xor_si128(d, s));
+            }
+#elif PSH_ARCH_SIMD_NEON
+            for (; idx + 2u <= word_count; idx += 2u) {
+                vst1q_u64(dst + idx, veorq_u64(vld1q_u64(dst + idx), vld1q_u64(src + idx)));
+            }
+#endif
+            for (; idx < word_count; ++idx) {
+                dst[idx] ^= src[idx];
+            }
+        }
+
+        psh_proc void bit_words_andnot(u64* dst, u64 const* src, usize word_count) psh_no_except {
+            usize idx = 0;
+#if PSH_ARCH_SIMD_AVX2
+            for (; idx + 4u <= word_count; idx += 4u) {
+                __m256i d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst + idx));
+                __m256i s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + idx));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + idx), _mm256_andnot_si256(s, d));
+            }
+#endif
+#if PSH_ARCH_SIMD_SSE2
+            for (; idx + 2u <= word_count; idx += 2u) {
+                __m128i d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + idx));
+                __m128i s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + idx));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + idx), _mm_andnot_si128(s, d));
+            }
+#elif PSH_ARCH_SIMD_NEON
+            for (; idx + 2u <= word_count; idx += 2u) {
+                vst1q_u64(dst + idx, vbicq_u64(vld1q_u64(dst + idx), vld1q_u64(src + idx)));
+            }
+#endif
+            for (; idx < word_count; ++idx) {
+                dst[idx] &= ~src[idx];
+            }
+        }
+
+        psh_proc usize bit_words_count_ones(u64 const* words, usize word_count) psh_no_except {
+            // Four independent accumulators allow the population counts to be pipelined.
+            usize count[4] = {0, 0, 0, 0};
+            usize idx      = 0;
+            for (; idx + 4u <= word_count; idx += 4u) {
+                count[0] += bit_count_ones(words[idx]);
+                count[1] += bit_count_ones(words[idx + 1u]);
+                count[2] += bit_count_ones(words[idx + 2u]);
+                count[3] += bit_count_ones(words[idx + 3u]);
+            }
+            for (; idx < word_count; ++idx) {
+                count[0] += bit_count_ones(words[idx]);
+            }
+            return count[0] + count[1] + count[2] + count[3];
+        }
+
+        psh_proc isize bit_words_find_next(u64 const* words, usize bit_count, usize start) psh_no_except {
+            if (start >= bit_count) {
+                return -1;
+            }
+
+            usize word_count = bit_word_count_for(bit_count);
+            usize word_idx   = start / BIT_WORD_SIZE;
+
+            // Discard the bits of the first word that come before the start position.
+            u64 word = words[word_idx] & (~u64{0} << (start % BIT_WORD_SIZE));
+            while (word == 0) {
+                ++word_idx;
+                if (word_idx == word_count) {
+                    return -1;
+                }
+                word = words[word_idx];
+            }
+            return static_cast<isize>(word_idx * BIT_WORD_SIZE + bit_count_trailing_zeros(word));
+        }
+
+        psh_proc usize bit_words_rank(u64 const* words, usize idx) psh_no_except {
+            usize full_words = idx / BIT_WORD_SIZE;
+            usize rank       = bit_words_count_ones(words, full_words);
+
+            usize tail = idx % BIT_WORD_SIZE;
+            if (tail != 0) {
+                rank += bit_count_ones(words[full_words] & ((u64{1} << tail) - 1u));
+            }
+            return rank;
+        }
+
+        psh_proc isize bit_words_select(u64 const* words, usize word_count, usize n) psh_no_except {
+            for (usize idx = 0; idx < word_count; ++idx) {
+                usize ones = bit_count_ones(words[idx]);
+                if (n < ones) {
+                    return static_cast<isize>(idx * BIT_WORD_SIZE + bit_select(words[idx], static_cast<u32>(n)));
+                }
+                n -= ones;
+            }
+            return -1;
+        }
+    }  // namespace impl
+
+    // -------------------------------------------------------------------------------------------------
+    // Memory alignment.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc u32 padding_with_header(
+        uptr ptr_addr,
+        u32  alignment,
+        u32  header_size,
+        u32  header_alignment) psh_no_except {
+        psh_validate_usage({
+            psh_assert_fmt(
+                psh_is_pow_of_two(alignment),
+                "Expected the element alignment to be a power of two (got %u).",
+                alignment);
+            psh_assert_fmt(
+                psh_is_pow_of_two(header_alignment),
+                "Expected the header alignment to be a power of two (got %u).",
+                header_alignment);
+        });
+
+        // Calculate the padding necessary for the alignment of the new block of memory.
+        u32 padding   = 0;
+        u32 mod_align = static_cast<u32>(ptr_addr & (static_cast<usize>(alignment) - 1u));  // @NOTE: Same as ptr_addr % alignment.
+        if (mod_align != 0) {
+            padding += alignment - mod_align;
+        }
+        ptr_addr += padding;
+
+        // Padding necessary for the header alignment.
+        u32 mod_header = static_cast<u32>(ptr_addr & (static_cast<usize>(header_alignment) - 1u));  // @NOTE: Same as ptr_addr % header_alignment.
+        if (mod_header != 0) {
+            padding += header_alignment - mod_header;
+        }
+
+        // The padding should at least contain the header.
+        padding += header_size;
+
+        return padding;
+    }
+
+    psh_proc uptr align_forward(uptr ptr_addr, u32 alignment) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_fmt(psh_is_pow_of_two(alignment), "Expected alignment (%u) to be a power of two.", alignment));
+
+        usize mod_align = ptr_addr & (static_cast<usize>(alignment) - 1u);  // @NOTE: Same as ptr_addr % alignment.
+        if (mod_align != 0) {
+            ptr_addr += alignment - mod_align;
+        }
+
+        return ptr_addr;
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Hashing.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc u64 hash_bytes(u8 const* bytes, usize size_bytes, u64 seed) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_msg((size_bytes == 0) || (bytes != nullptr), "Null bytes with non-zero size."));
+
+        constexpr u64 MULTIPLIER = 0x9DDFEA08EB382D69ull;
+
+        u64 hash = seed ^ (static_cast<u64>(size_bytes) * MULTIPLIER);
+
+        // Consume the bytes in 8-byte words. The memcpy avoids any alignment requirements on the
+        // input and gets compiled down to a single load.
+        usize word_count = size_bytes / sizeof(u64);
+        for (usize idx = 0; idx < word_count; ++idx) {
+            u64 word;
+            psh_discard_value(memcpy(&word, bytes + idx * sizeof(u64), sizeof(u64)));
+            hash = (hash ^ hash_mix(word)) * MULTIPLIER;
+        }
+
+        usize remaining = size_bytes - word_count * sizeof(u64);
+        if (remaining != 0) {
+            u64 word = 0;
+            psh_discard_value(memcpy(&word, bytes + word_count * sizeof(u64), remaining));
+            hash = (hash ^ hash_mix(word)) * MULTIPLIER;
+        }
+
+        return hash_mix(hash);
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Arena allocator implementation.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc Arena make_owned_arena(usize capacity, VirtualMemoryOptions options) psh_no_except {
+        u8* buf = memory_virtual_alloc(capacity, options);
+        return Arena{
+            .buf      = buf,
+            .capacity = (buf != nullptr) ? memory_virtual_alloc_size(capacity, options) : 0,
+            .offset   = 0,
+        };
+    }
+
+    psh_proc Arena make_reserved_arena(
+        usize                reserve_size,
+        usize                commit_chunk_size,
+        usize                decommit_threshold,
+        VirtualMemoryOptions options) psh_no_except {
+        usize page_size = memory_virtual_page_size();
+        reserve_size    = psh_max_value(align_forward(reserve_size, static_cast<u32>(page_size)), page_size);
+
+        u8* buf = memory_virtual_reserve(reserve_size, options);
+        if (psh_unlikely(buf == nullptr)) {
+            return Arena{.buf = nullptr};
+        }
+
+        Arena arena = {
+            .buf                = buf,
+            .capacity           = 0,
+            .offset             = 0,
+            .reserved           = reserve_size,
+            .commit_chunk_size  = psh_max_value(align_forward(commit_chunk_size, static_cast<u32>(page_size)), page_size),
+            .decommit_threshold = decommit_threshold,
+            .commit_prefault    = ((options.flags & VIRTUAL_MEMORY_FLAG_PREFAULT) != 0),
+        };
+
+        // Commit the first chunk up-front, allowing the arena to be used just like any other.
+        if (psh_unlikely(!impl::arena_commit(&arena, 1))) {
+            memory_virtual_free(buf, reserve_size);
+            return Arena{.buf = nullptr};
+        }
+
+        return arena;
+    }
+
+    // @NOTE: Sub-arena blocks are aligned to a cache line so that two threads using adjacent
+    //        sub-arenas never write to the same cache line.
+    psh_global constexpr u32 SUB_ARENA_ALIGNMENT = 64;
+
+    namespace impl {
+        /// Give the memory of a block of a chained arena back to where it came from.
+        psh_internal void arena_release_block(Arena* parent, u8* block, usize size_bytes) psh_no_except {
+            if (parent == nullptr) {
+                memory_virtual_free(block, size_bytes);
+                return;
+            }
+
+            // Only the last allocation of the parent can be reclaimed.
+            if (block + size_bytes == parent->buf + parent->offset) {
+                parent->offset = static_cast<usize>(block - parent->buf);
+            }
+        }
+    }  // namespace impl
+
+    psh_proc Arena make_chained_arena(usize first_block_size, Arena* parent) psh_no_except {
+        u8* buf = (parent != nullptr) ? memory_alloc_align_uninit(parent, first_block_size, SUB_ARENA_ALIGNMENT)
+                                      : memory_virtual_alloc(first_block_size);
+        return Arena{
+            .buf          = buf,
+            .capacity     = (buf != nullptr) ? first_block_size : 0,
+            .offset       = 0,
+            .chain_parent = parent,
+            .chained      = true,
+        };
+    }
+
+    psh_proc void destroy_owned_arena(Arena* arena) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(arena));
+
+        if (arena->chained) {
+            impl::arena_unchain_blocks(arena, nullptr);
+            impl::arena_release_block(arena->chain_parent, arena->buf, arena->capacity);
+            arena->capacity = 0;
+            arena->offset   = 0;
+            return;
+        }
+
+        usize size_bytes = psh_max_value(arena->capacity, arena->reserved);
+        arena->capacity  = 0;
+        arena->reserved  = 0;
+        memory_virtual_free(arena->buf, size_bytes);
+    }
+
+    namespace impl {
+        /// Scratch arenas of a thread, whose memory is released at the thread exit.
+        struct ThreadScratchArenas {
+            Arena arenas[SCRATCH_ARENA_COUNT] = {};
+
+            ~ThreadScratchArenas() psh_no_except {
+                for (usize idx = 0; idx < SCRATCH_ARENA_COUNT; ++idx) {
+                    if (this->arenas[idx].buf != nullptr) {
+                        destroy_owned_arena(&this->arenas[idx]);
+                    }
+                }
+            }
+        };
+
+        psh_internal thread_local ThreadScratchArenas thread_scratch_arenas;
+
+        psh_proc Arena* scratch_arena_acquire(Arena* const* conflicts, usize conflict_count) psh_no_except {
+            psh_validate_usage({
+                psh_assert_msg((conflict_count == 0) || (conflicts != nullptr), "Null conflicts with non-zero count.");
+                psh_assert_fmt(
+                    conflict_count < SCRATCH_ARENA_COUNT,
+                    "At most %zu conflicting arenas can be avoided (got %zu).",
+                    SCRATCH_ARENA_COUNT - 1u,
+                    conflict_count);
+            });
+
+            Arena* arenas = thread_scratch_arenas.arenas;
+            for (usize idx = 0; idx < SCRATCH_ARENA_COUNT; ++idx) {
+                Arena* arena = arenas + idx;
+
+                bool conflicting = false;
+                for (usize conflict_idx = 0; conflict_idx < conflict_count; ++conflict_idx) {
+                    conflicting = conflicting || (conflicts[conflict_idx] == arena);
+                }
+                if (conflicting) {
+                    continue;
+                }
+
+                // The reserved range is only requested by the first use of the arena.
+                if (psh_unlikely(arena->buf == nullptr)) {
+                    *arena = make_reserved_arena(SCRATCH_ARENA_RESERVE_SIZE);
+                }
+                return arena;
+            }
+
+            // Only reachable when usage validation is disabled, there's no way to avoid aliasing.
+            return arenas;
+        }
+    }  // namespace impl
+
+    psh_proc Arena make_sub_arena(AtomicArena* parent, usize capacity psh_impl_alloc_site_param) psh_no_except {
+        return make_arena(memory_alloc_align(parent, capacity, SUB_ARENA_ALIGNMENT psh_impl_alloc_site_arg), capacity);
+    }
+
+    psh_proc Arena make_sub_arena(Arena* parent, usize capacity psh_impl_alloc_site_param) psh_no_except {
+        return make_arena(memory_alloc_align(parent, capacity, SUB_ARENA_ALIGNMENT psh_impl_alloc_site_arg), capacity);
+    }
+
+    namespace impl {
+        psh_proc Status arena_commit(Arena* arena, usize min_capacity) psh_no_except {
+            psh_paranoid_validate_usage(psh_assert_not_null(arena));
+
+            usize capacity = arena->capacity;
+            if (min_capacity <= capacity) {
+                return STATUS_OK;
+            }
+
+            if (psh_unlikely(min_capacity > arena->reserved)) {
+                return STATUS_FAILED;
+            }
+
+            // Commit whole chunks, without going past the end of the reserved range.
+            usize chunk_size   = arena->commit_chunk_size;
+            usize new_capacity = ((min_capacity + chunk_size - 1u) / chunk_size) * chunk_size;
+            new_capacity       = psh_min_value(new_capacity, arena->reserved);
+
+            if (psh_unlikely(!memory_virtual_commit(arena->buf + capacity, new_capacity - capacity, arena->commit_prefault))) {
+                return STATUS_FAILED;
+            }
+
+            arena->capacity = new_capacity;
+            return STATUS_OK;
+        }
+
+        psh_proc void arena_decommit_excess(Arena* arena) psh_no_except {
+            psh_paranoid_validate_usage({
+                psh_assert_not_null(arena);
+                psh_assert_msg(arena->reserved != 0, "Only arenas with reserved memory can be decommitted.");
+            });
+
+            usize keep_size = align_forward(arena->decommit_threshold, static_cast<u32>(memory_virtual_page_size()));
+            keep_size       = psh_max_value(keep_size, arena->offset);
+            if (keep_size >= arena->capacity) {
+                return;
+            }
+
+            memory_virtual_decommit(arena->buf + keep_size, arena->capacity - keep_size);
+            arena->capacity = keep_size;
+        }
+
+        psh_proc Status arena_chain_block(Arena* arena, usize size_bytes, u32 alignment) psh_no_except {
+            psh_paranoid_validate_usage({
+                psh_assert_not_null(arena);
+                psh_assert_msg(arena->chained, "Only chained arenas can link new blocks.");
+            });
+
+            // The block should fit its header and the padding required by the allocation.
+            usize required_size = psh_usize_of(ArenaBlockHeader) + static_cast<usize>(alignment) + size_bytes;
+            usize block_size    = psh_max_value(2u * arena->capacity, required_size);
+
+            Arena* parent = arena->chain_parent;
+            u8*    block;
+            if (parent != nullptr) {
+                block = memory_alloc_align_uninit(parent, block_size, SUB_ARENA_ALIGNMENT);
+            } else {
+                block_size = align_forward(block_size, static_cast<u32>(memory_virtual_page_size()));
+                block      = memory_virtual_alloc(block_size);
+            }
+            if (psh_unlikely(block == nullptr)) {
+                return STATUS_FAILED;
+            }
+
+            ArenaBlockHeader* header = reinterpret_cast<ArenaBlockHeader*>(block);
+            *header                  = ArenaBlockHeader{
+                .previous          = arena->chain_block,
+                .previous_buf      = arena->buf,
+                .previous_capacity = arena->capacity,
+                .previous_offset   = arena->offset,
+                .previous_reserved = arena->reserved,
+            };
+
+            arena->buf         = block;
+            arena->capacity    = block_size;
+            arena->offset      = psh_usize_of(ArenaBlockHeader);
+            arena->reserved    = 0;
+            arena->chain_block = header;
+            return STATUS_OK;
+        }
+
+        psh_proc void arena_unchain_blocks(Arena* arena, u8 const* until_buf) psh_no_except {
+            psh_paranoid_validate_usage(psh_assert_not_null(arena));
+
+            while ((arena->chain_block != nullptr) && (arena->buf != until_buf)) {
+                ArenaBlockHeader header = *arena->chain_block;
+                arena_release_block(arena->chain_parent, arena->buf, arena->capacity);
+
+                arena->buf         = header.previous_buf;
+                arena->capacity    = header.previous_capacity;
+                arena->offset      = header.previous_offset;
+                arena->reserved    = header.previous_reserved;
+                arena->chain_block = header.previous;
+            }
+
+            psh_paranoid_validate_usage({
+                psh_assert_msg(
+                    (until_buf == nullptr) || (arena->buf == until_buf),
+                    "The block of the checkpoint doesn't belong to the arena anymore.");
+            });
+        }
+    }  // namespace impl
+
+    // -------------------------------------------------------------------------------------------------
+    // Stack memory allocator implementation.
+    // -------------------------------------------------------------------------------------------------
+
+    u8* Stack::top() psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_msg(this->buf != nullptr, "Stack uninitialised."));
+
+        return this->buf + this->previous_offset;
+    }
+
+    StackHeader const* Stack::top_header() const psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_msg(this->buf != nullptr, "Stack uninitialised."));
+
+        return reinterpret_cast<StackHeader const*>(pointer_add_bytes(this->buf, this->previous_offset - psh_usize_of(StackHeader)));
+    }
+
+    usize Stack::top_size() const psh_no_except {
+        StackHeader const* header = this->top_header();
+        return (header == nullptr) ? 0 : header->capacity;
+    }
+
+    usize Stack::top_previous_offset() const psh_no_except {
+        StackHeader const* header = this->top_header();
+        return (header == nullptr) ? 0 : header->previous_offset;
+    }
+
+    StackHeader const* Stack::header_of(u8 const* block) const psh_no_except {
+        psh_validate_usage(psh_assert_not_null(block));
+        psh_paranoid_validate_usage(psh_assert_msg(this->buf != nullptr, "Stack uninitialised."));
+
+        u8 const* memory_start = this->buf;
+        u8 const* block_header = block + psh_usize_of(StackHeader);
+
+        bool valid = (block >= memory_start)
+                     && (block <= memory_start + this->capacity)
+                     && (block <= memory_start + this->previous_offset)
+                     && (block_header >= memory_start);
+
+        return valid ? reinterpret_cast<StackHeader const*>(block_header) : nullptr;
+    }
+
+    usize Stack::size_of(u8 const* block) const psh_no_except {
+        StackHeader const* header = this->header_of(block);
+        return (header == nullptr) ? 0 : header->capacity;
+    }
+
+    usize Stack::previous_offset_of(u8 const* block) const psh_no_except {
+        StackHeader const* header = this->header_of(block);
+        return (header == nullptr) ? 0 : header->previous_offset;
+    }
+
+    Status Stack::pop() psh_no_except {
+        if (psh_unlikely(this->previous_offset == 0)) {
+            return STATUS_FAILED;
+        }
+
+        u8 const*          top        = pointer_add_bytes(this->buf, this->previous_offset);
+        StackHeader const* top_header = reinterpret_cast<StackHeader const*>(pointer_const_subtract_bytes(top, psh_isize_of(StackHeader)));
+
+        this->offset          = this->previous_offset - top_header->padding;
+        this->previous_offset = top_header->previous_offset;
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        ++this->stats.free_count;
+#endif
+        return STATUS_OK;
+    }
+
+    Status Stack::clear_at(u8 const* block) psh_no_except {
+        u8* this_buf = this->buf;
+
+        // Check if the block is within the allocator's memory.
+        bool is_within_region = (block >= this_buf) || (block < pointer_add_bytes(this_buf, this->previous_offset));
+        if (psh_unlikely((block == nullptr) || !is_within_region)) {
+            return STATUS_FAILED;
+        }
+
+        StackHeader const* header = reinterpret_cast<StackHeader const*>(block - psh_usize_of(StackHeader));
+
+        this->previous_offset = header->previous_offset;
+        this->offset          = no_wrap_sub(
+            no_wrap_sub(reinterpret_cast<uptr>(block), header->padding),
+            reinterpret_cast<uptr>(this_buf));
+
+        return STATUS_OK;
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Memory manager implementation.
+    // -------------------------------------------------------------------------------------------------
+
+    void MemoryManager::init(
+        usize                capacity_bytes,
+        MemoryManagerBackend backend_,
+        usize                reserve_size,
+        VirtualMemoryOptions options) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_msg(this->allocation_count == 0, "MemoryManager already initialised."));
+
+        usize page_size     = memory_virtual_page_size();
+        usize reserve_bytes = static_cast<usize>(align_forward(psh_max_value(reserve_size, capacity_bytes), static_cast<u32>(page_size)));
+        usize commit_bytes  = static_cast<usize>(align_forward(capacity_bytes, static_cast<u32>(page_size)));
+
+        bool prefault = ((options.flags & VIRTUAL_MEMORY_FLAG_PREFAULT) != 0);
+        u8*  memory   = memory_virtual_reserve(reserve_bytes, options);
+        if (psh_unlikely((memory != nullptr) && (commit_bytes != 0) && !memory_virtual_commit(memory, commit_bytes, prefault))) {
+            memory_virtual_free(memory, reserve_bytes);
+            memory = nullptr;
+        }
+        if (psh_unlikely(memory == nullptr)) {
+            psh_log_error_fmt("MemoryManager unable to reserve %zu bytes of memory.", reserve_bytes);
+            reserve_bytes = 0;
+            commit_bytes  = 0;
+        }
+
+        this->backend         = backend_;
+        this->buf             = memory;
+        this->reserved        = reserve_bytes;
+        this->committed       = commit_bytes;
+        this->peak_used_bytes = 0;
+        this->commit_prefault = prefault;
+
+        if (backend_ == MemoryManagerBackend::TLSF) {
+            psh_discard_value(init_tlsf(&this->general_allocator, memory, (memory != nullptr) ? capacity_bytes : 0));
+        } else {
+            this->allocator.init(memory, capacity_bytes);
+        }
+    }
+
+    void MemoryManager::destroy() psh_no_except {
+        if (this->buf != nullptr) {
+            memory_virtual_free(this->buf, this->reserved);
+        }
+
+        this->allocation_count = 0;
+        this->allocator        = Stack{};
+        this->buf              = nullptr;
+        this->reserved         = 0;
+        this->committed        = 0;
+        this->general_allocator.buf      = nullptr;
+        this->general_allocator.capacity = 0;
+        this->general_allocator.sentinel = nullptr;
+    }
+
+    Status MemoryManager::pop() psh_no_except {
+        psh_validate_usage(psh_assert_msg(this->backend == MemoryManagerBackend::STACK, "Only managers backed by a stack can pop blocks."));
+
+        Status st = this->allocator.pop();
+        if (psh_likely(st == STATUS_OK)) {
+            --this->allocation_count;
+        }
+        return st;
+    }
+
+    Status MemoryManager::clear_until(u8 const* block) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(block);
+            psh_assert_msg(this->backend == MemoryManagerBackend::STACK, "Only managers backed by a stack can clear blocks.");
+        });
+
+        u8 const* memory_start = this->allocator.buf;
+
+        // Check if the block lies within the allocator's memory.
+        if (psh_unlikely((block < memory_start) || (block > memory_start + this->allocator.previous_offset))) {
+            cstring fail_reason = (block > memory_start + this->allocator.capacity)
+                                      ? "MemoryManager::clear_until called with a pointer outside of the stack "
+                                        "memory_start region."
+                                      : "MemoryManager::clear_until called with a pointer to an already free region "
+                                        "of the stack memory_start.";
+            psh_log_error(fail_reason);
+            return STATUS_FAILED;
+        }
+
+        // Pop the top memory block until popping block or reaching the end of the allocator.
+        //
+        // @NOTE: If we were given the incorrect address, we end up clearing the whole memory.
+        for (;;) {
+            u8 const* top_block = this->allocator.top();
+            if (psh_unlikely(top_block == memory_start)) {
+                break;
+            }
+            if (psh_likely(this->allocator.pop() == STATUS_OK)) {
+                --this->allocation_count;
+            }
+            if (psh_unlikely(top_block == block)) {
+                break;
+            }
+        }
+
+        return STATUS_OK;
+    }
+
+    Status MemoryManager::resize(usize new_capacity) psh_no_except {
+        if (psh_unlikely(new_capacity > this->reserved)) {
+            psh_log_error_fmt(
+                "MemoryManager unable to resize to %zu bytes, only %zu bytes were reserved.",
+                new_capacity,
+                this->reserved);
+            return STATUS_FAILED;
+        }
+
+        if (psh_unlikely((this->backend == MemoryManagerBackend::STACK) && (new_capacity < this->allocator.offset))) {
+            psh_log_error_fmt(
+                "MemoryManager unable to shrink to %zu bytes, %zu bytes are still in use.",
+                new_capacity,
+                this->allocator.offset);
+            return STATUS_FAILED;
+        }
+
+        usize page_size     = memory_virtual_page_size();
+        usize new_committed = static_cast<usize>(align_forward(new_capacity, static_cast<u32>(page_size)));
+
+        // Memory has to be committed before being handed to the allocator.
+        if (new_committed > this->committed) {
+            if (psh_unlikely(!memory_virtual_commit(this->buf + this->committed, new_committed - this->committed, this->commit_prefault))) {
+                psh_log_error_fmt("MemoryManager unable to commit memory for a capacity of %zu bytes.", new_capacity);
+                return STATUS_FAILED;
+            }
+            this->committed = new_committed;
+        }
+
+        if (this->backend == MemoryManagerBackend::TLSF) {
+            if (!tlsf_resize(&this->general_allocator, new_capacity)) {
+                return STATUS_FAILED;
+            }
+        } else {
+            this->allocator.capacity = new_capacity;
+        }
+
+        if (new_committed < this->committed) {
+            memory_virtual_decommit(this->buf + new_committed, this->committed - new_committed);
+            this->committed = new_committed;
+        }
+
+        return STATUS_OK;
+    }
+
+    MemoryManagerStats MemoryManager::stats() const psh_no_except {
+        MemoryManagerStats result;
+        result.allocation_count = this->allocation_count;
+        result.reserved         = this->reserved;
+
+        if (this->backend == MemoryManagerBackend::TLSF) {
+            result.used_bytes         = this->general_allocator.used_bytes;
+            result.peak_used_bytes    = this->general_allocator.peak_used_bytes;
+            result.largest_free_block = tlsf_largest_free_block(&this->general_allocator);
+            result.capacity           = this->general_allocator.capacity;
+        } else {
+            result.used_bytes         = this->allocator.offset;
+            result.peak_used_bytes    = psh_max_value(this->peak_used_bytes, this->allocator.offset);
+            result.largest_free_block = this->allocator.capacity - this->allocator.offset;
+            result.capacity           = this->allocator.capacity;
+        }
+
+        return result;
+    }
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+    AllocatorStats const* MemoryManager::allocator_stats() const psh_no_except {
+        return (this->backend == MemoryManagerBackend::TLSF) ? &this->general_allocator.stats : &this->allocator.stats;
+    }
+#endif
+
+    void MemoryManager::clear() psh_no_except {
+        this->allocation_count = 0;
+        this->peak_used_bytes  = 0;
+
+        if (this->backend == MemoryManagerBackend::TLSF) {
+            psh_discard_value(init_tlsf(&this->general_allocator, this->buf, this->general_allocator.capacity));
+        } else {
+            this->allocator.clear();
+        }
+    }
+
+    psh_proc Status memory_free(MemoryManager* memory_manager, u8* block) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(memory_manager));
+
+        if (psh_unlikely(block == nullptr)) {
+            return STATUS_OK;
+        }
+
+        if (memory_manager->backend == MemoryManagerBackend::TLSF) {
+            memory_free(&memory_manager->general_allocator, block);
+            --memory_manager->allocation_count;
+            return STATUS_OK;
+        }
+
+        if (psh_unlikely(block != memory_manager->allocator.top())) {
+            psh_log_error("Memory managers backed by a stack can only free their last allocated block.");
+            return STATUS_FAILED;
+        }
+
+        return memory_manager->pop();
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // TLSF allocator implementation.
+    // -------------------------------------------------------------------------------------------------
+
+    namespace impl {
+        psh_global constexpr usize TLSF_BLOCK_FREE_BIT      = 1u << 0;
+        psh_global constexpr usize TLSF_BLOCK_PREV_FREE_BIT = 1u << 1;
+        psh_global constexpr usize TLSF_BLOCK_FLAGS         = TLSF_BLOCK_FREE_BIT | TLSF_BLOCK_PREV_FREE_BIT;
+
+        /// Bytes of a block in use that aren't part of its memory: the size field.
+        psh_global constexpr usize TLSF_BLOCK_OVERHEAD = psh_usize_of(usize);
+
+        /// Offset from the start of a block header to its memory.
+        psh_global constexpr usize TLSF_BLOCK_START_OFFSET = psh_usize_of(TlsfBlock*) + psh_usize_of(usize);
+
+        /// A free block has to be able to store its free list links, while its prev_physical field
+        /// lies within the previous block.
+        psh_global constexpr usize TLSF_BLOCK_MIN_SIZE = psh_usize_of(TlsfBlock) - psh_usize_of(TlsfBlock*);
+
+        psh_global constexpr usize TLSF_SMALL_BLOCK_SIZE = usize{1} << TLSF_FL_INDEX_SHIFT;
+        psh_global constexpr u64   TLSF_BLOCK_MAX_SIZE   = u64{1} << TLSF_FL_INDEX_MAX;
+
+        static_assert(TLSF_ALIGN_SIZE == TLSF_SMALL_BLOCK_SIZE / TLSF_SL_INDEX_COUNT, "Small blocks should be linearly mapped.");
+        static_assert(TLSF_FL_INDEX_COUNT <= 64, "The first level bitmap should fit a u64.");
+
+        psh_internal psh_inline usize tlsf_block_get_size(TlsfBlock const* block) psh_no_except {
+            return block->size & ~TLSF_BLOCK_FLAGS;
+        }
+
+        psh_internal psh_inline void tlsf_block_set_size(TlsfBlock* block, usize size) psh_no_except {
+            block->size = size | (block->size & TLSF_BLOCK_FLAGS);
+        }
+
+        psh_internal psh_inline bool tlsf_block_is_free(TlsfBlock const* block) psh_no_except {
+            return (block->size & TLSF_BLOCK_FREE_BIT) != 0;
+        }
+
+        psh_internal psh_inline bool tlsf_block_is_prev_free(TlsfBlock const* block) psh_no_except {
+            return (block->size & TLSF_BLOCK_PREV_FREE_BIT) != 0;
+        }
+
+        psh_internal psh_inline u8* tlsf_block_to_ptr(TlsfBlock const* block) psh_no_except {
+            return reinterpret_cast<u8*>(const_cast<TlsfBlock*>(block)) + TLSF_BLOCK_START_OFFSET;
+        }
+
+        psh_internal psh_inline TlsfBlock* tlsf_block_from_ptr(u8 const* ptr) psh_no_except {
+            return reinterpret_cast<TlsfBlock*>(const_cast<u8*>(ptr) - TLSF_BLOCK_START_OFFSET);
+        }
+
+        psh_internal psh_inline TlsfBlock* tlsf_block_at(u8* ptr) psh_no_except {
+            return reinterpret_cast<TlsfBlock*>(ptr);
+        }
+
+        /// Get the next physical block, whose header starts at the last bytes of the block memory.
+        psh_internal psh_inline TlsfBlock* tlsf_block_next(TlsfBlock const* block) psh_no_except {
+            return tlsf_block_at(tlsf_block_to_ptr(block) + tlsf_block_get_size(block) - TLSF_BLOCK_OVERHEAD);
+        }
+
+        psh_internal psh_inline TlsfBlock* tlsf_block_link_next(TlsfBlock* block) psh_no_except {
+            TlsfBlock* next     = tlsf_block_next(block);
+            next->prev_physical = block;
+            return next;
+        }
+
+        psh_internal psh_inline void tlsf_block_mark_as_free(TlsfBlock* block) psh_no_except {
+            TlsfBlock* next = tlsf_block_link_next(block);
+            next->size |= TLSF_BLOCK_PREV_FREE_BIT;
+            block->size |= TLSF_BLOCK_FREE_BIT;
+        }
+
+        psh_internal psh_inline void tlsf_block_mark_as_used(TlsfBlock* block) psh_no_except {
+            TlsfBlock* next = tlsf_block_next(block);
+            next->size &= ~TLSF_BLOCK_PREV_FREE_BIT;
+            block->size &= ~TLSF_BLOCK_FREE_BIT;
+        }
+
+        psh_internal psh_inline usize tlsf_align_down(usize size, usize alignment) psh_no_except {
+            return size & ~(alignment - 1u);
+        }
+
+        /// Round a requested size up to the allocator granularity and minimum block size.
+        ///
+        /// Return: The adjusted size, or zero if the request can't be satisfied by any block.
+        psh_internal usize tlsf_adjust_request_size(usize size, usize alignment) psh_no_except {
+            if ((size == 0) || (static_cast<u64>(size) >= TLSF_BLOCK_MAX_SIZE - alignment)) {
+                return 0;
+            }
+            usize aligned = static_cast<usize>(align_forward(size, static_cast<u32>(alignment)));
+            return psh_max_value(aligned, TLSF_BLOCK_MIN_SIZE);
+        }
+
+        /// Get the indices of the list where blocks of a given size are stored.
+        psh_internal void tlsf_mapping_insert(usize size, u32* fl, u32* sl) psh_no_except {
+            if (size < TLSF_SMALL_BLOCK_SIZE) {
+                *fl = 0;
+                *sl = static_cast<u32>(size / TLSF_ALIGN_SIZE);
+            } else {
+                u32 last_bit = 63u - bit_count_leading_zeros(static_cast<u64>(size));
+                *sl          = static_cast<u32>(size >> (last_bit - TLSF_SL_INDEX_COUNT_LOG2)) ^ TLSF_SL_INDEX_COUNT;
+                *fl          = last_bit - (TLSF_FL_INDEX_SHIFT - 1u);
+            }
+        }
+
+        /// Get the indices of the first list whose blocks are all at least as large as a given size.
+        psh_internal void tlsf_mapping_search(usize size, u32* fl, u32* sl) psh_no_except {
+            if (size >= TLSF_SMALL_BLOCK_SIZE) {
+                u32 last_bit = 63u - bit_count_leading_zeros(static_cast<u64>(size));
+                size += (usize{1} << (last_bit - TLSF_SL_INDEX_COUNT_LOG2)) - 1u;
+            }
+            tlsf_mapping_insert(size, fl, sl);
+        }
+
+        psh_internal TlsfBlock* tlsf_search_suitable_block(Tlsf* tlsf, u32* fl, u32* sl) psh_no_except {
+            if (*fl >= TLSF_FL_INDEX_COUNT) {
+                return nullptr;
+            }
+
+            u32 sl_map = tlsf->sl_bitmap[*fl] & (~0u << *sl);
+            if (sl_map == 0) {
+                // No block in the first level class, look for the next non-empty one.
+                u64 fl_map = tlsf->fl_bitmap & (~u64{0} << (*fl + 1u));
+                if (fl_map == 0) {
+                    return nullptr;
+                }
+
+                *fl    = bit_count_trailing_zeros(fl_map);
+                sl_map = tlsf->sl_bitmap[*fl];
+            }
+
+            *sl = bit_count_trailing_zeros(sl_map);
+            return tlsf->free_lists[*fl][*sl];
+        }
+
+        psh_internal void tlsf_remove_free_block(Tlsf* tlsf, TlsfBlock* block, u32 fl, u32 sl) psh_no_except {
+            TlsfBlock* prev = block->prev_free;
+            TlsfBlock* next = block->next_free;
+            if (next != nullptr) {
+                next->prev_free = prev;
+            }
+            if (prev != nullptr) {
+                prev->next_free = next;
+            }
+
+            if (tlsf->free_lists[fl][sl] == block) {
+                tlsf->free_lists[fl][sl] = next;
+                if (next == nullptr) {
+                    tlsf->sl_bitmap[fl] &= ~(1u << sl);
+                    if (tlsf->sl_bitmap[fl] == 0) {
+                        tlsf->fl_bitmap &= ~(u64{1} << fl);
+                    }
+                }
+            }
+        }
+
+        psh_internal void tlsf_insert_free_block(Tlsf* tlsf, TlsfBlock* block, u32 fl, u32 sl) psh_no_except {
+            TlsfBlock* head  = tlsf->free_lists[fl][sl];
+            block->next_free = head;
+            block->prev_free = nullptr;
+            if (head != nullptr) {
+                head->prev_free = block;
+            }
+
+            tlsf->free_lists[fl][sl] = block;
+            tlsf->fl_bitmap |= u64{1} << fl;
+            tlsf->sl_bitmap[fl] |= 1u << sl;
+        }
+
+        psh_internal void tlsf_block_remove(Tlsf* tlsf, TlsfBlock* block) psh_no_except {
+            u32 fl, sl;
+            tlsf_mapping_insert(tlsf_block_get_size(block), &fl, &sl);
+            tlsf_remove_free_block(tlsf, block, fl, sl);
+        }
+
+        psh_internal void tlsf_block_insert(Tlsf* tlsf, TlsfBlock* block) psh_no_except {
+            u32 fl, sl;
+            tlsf_mapping_insert(tlsf_block_get_size(block), &fl, &sl);
+            tlsf_insert_free_block(tlsf, block, fl, sl);
+        }
+
+        psh_internal psh_inline bool tlsf_block_can_split(TlsfBlock const* block, usize size) psh_no_except {
+            return tlsf_block_get_size(block) >= psh_usize_of(TlsfBlock) + size;
+        }
+
+        /// Split a block in two, at a given size, returning the remaining free block.
+        psh_internal TlsfBlock* tlsf_block_split(TlsfBlock* block, usize size) psh_no_except {
+            TlsfBlock* remaining      = tlsf_block_at(tlsf_block_to_ptr(block) + size - TLSF_BLOCK_OVERHEAD);
+            usize      remaining_size = tlsf_block_get_size(block) - (size + TLSF_BLOCK_OVERHEAD);
+
+            remaining->size = remaining_size;
+            tlsf_block_set_size(block, size);
+            tlsf_block_mark_as_free(remaining);
+
+            return remaining;
+        }
+
+        /// Merge a block into its previous physical block.
+        psh_internal TlsfBlock* tlsf_block_absorb(TlsfBlock* prev, TlsfBlock* block) psh_no_except {
+            prev->size += tlsf_block_get_size(block) + TLSF_BLOCK_OVERHEAD;
+            psh_discard_value(tlsf_block_link_next(prev));
+            return prev;
+        }
+
+        psh_internal TlsfBlock* tlsf_block_merge_prev(Tlsf* tlsf, TlsfBlock* block) psh_no_except {
+            if (tlsf_block_is_prev_free(block)) {
+                TlsfBlock* prev = block->prev_physical;
+                tlsf_block_remove(tlsf, prev);
+                block = tlsf_block_absorb(prev, block);
+            }
+            return block;
+        }
+
+        psh_internal TlsfBlock* tlsf_block_merge_next(Tlsf* tlsf, TlsfBlock* block) psh_no_except {
+            TlsfBlock* next = tlsf_block_next(block);
+            if (tlsf_block_is_free(next)) {
+                tlsf_block_remove(tlsf, next);
+                block = tlsf_block_absorb(block, next);
+            }
+            return block;
+        }
+
+        /// Give the trailing memory of a free block back to the free lists.
+        psh_internal void tlsf_block_trim_free(Tlsf* tlsf, TlsfBlock* block, usize size) psh_no_except {
+            if (tlsf_block_can_split(block, size)) {
+                TlsfBlock* remaining = tlsf_block_split(block, size);
+                psh_discard_value(tlsf_block_link_next(block));
+                remaining->size |= TLSF_BLOCK_PREV_FREE_BIT;
+                tlsf_block_insert(tlsf, remaining);
+            }
+        }
+
+        /// Give the trailing memory of a block in use back to the free lists.
+        psh_internal void tlsf_block_trim_used(Tlsf* tlsf, TlsfBlock* block, usize size) psh_no_except {
+            if (tlsf_block_can_split(block, size)) {
+                TlsfBlock* remaining = tlsf_block_split(block, size);
+                remaining->size &= ~TLSF_BLOCK_PREV_FREE_BIT;
+                remaining = tlsf_block_merge_next(tlsf, remaining);
+                tlsf_block_insert(tlsf, remaining);
+            }
+        }
+
+        /// Give the leading memory of a free block back to the free lists, returning the block
+        /// starting after the given size.
+        psh_internal TlsfBlock* tlsf_block_trim_free_leading(Tlsf* tlsf, TlsfBlock* block, usize size) psh_no_except {
+            TlsfBlock* remaining = block;
+            if (tlsf_block_can_split(block, size)) {
+                remaining = tlsf_block_split(block, size - TLSF_BLOCK_OVERHEAD);
+                remaining->size |= TLSF_BLOCK_PREV_FREE_BIT;
+                psh_discard_value(tlsf_block_link_next(block));
+                tlsf_block_insert(tlsf, block);
+            }
+            return remaining;
+        }
+
+        psh_internal TlsfBlock* tlsf_locate_free(Tlsf* tlsf, usize size) psh_no_except {
+            if (size == 0) {
+                return nullptr;
+            }
+
+            u32 fl, sl;
+            tlsf_mapping_search(size, &fl, &sl);
+
+            TlsfBlock* block = tlsf_search_suitable_block(tlsf, &fl, &sl);
+            if (block != nullptr) {
+                tlsf_remove_free_block(tlsf, block, fl, sl);
+            }
+            return block;
+        }
+
+        psh_internal void tlsf_track_usage(Tlsf* tlsf, usize used_bytes) psh_no_except {
+            tlsf->used_bytes      = used_bytes;
+            tlsf->peak_used_bytes = psh_max_value(tlsf->peak_used_bytes, used_bytes);
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+            tlsf->stats.peak_used_bytes = psh_max_value(tlsf->stats.peak_used_bytes, used_bytes);
+#endif
+        }
+
+        /// Mark a block as free, merging it with its free neighbours.
+        psh_internal void tlsf_release_block(Tlsf* tlsf, TlsfBlock* block) psh_no_except {
+            tlsf_block_mark_as_free(block);
+            block = tlsf_block_merge_prev(tlsf, block);
+            block = tlsf_block_merge_next(tlsf, block);
+            tlsf_block_insert(tlsf, block);
+        }
+    }  // namespace impl
+
+    psh_proc Status init_tlsf(Tlsf* tlsf, u8* buf, usize capacity) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(tlsf);
+            psh_assert_msg((reinterpret_cast<uptr>(buf) & (impl::TLSF_ALIGN_SIZE - 1u)) == 0, "TLSF memory should be 8 byte aligned.");
+        });
+
+        tlsf->buf              = buf;
+        tlsf->capacity         = 0;
+        tlsf->sentinel         = nullptr;
+        tlsf->allocation_count = 0;
+        tlsf->used_bytes       = 0;
+        tlsf->peak_used_bytes  = 0;
+        tlsf->fl_bitmap        = 0;
+        memory_set(reinterpret_cast<u8*>(tlsf->sl_bitmap), psh_usize_of(tlsf->sl_bitmap), 0);
+        memory_set(reinterpret_cast<u8*>(tlsf->free_lists), psh_usize_of(tlsf->free_lists), 0);
+
+        // The managed memory is a single free block followed by a zero sized sentinel block in use.
+        usize min_capacity = impl::TLSF_BLOCK_START_OFFSET + impl::TLSF_BLOCK_MIN_SIZE + impl::TLSF_BLOCK_OVERHEAD;
+        if (psh_unlikely((buf == nullptr) || (capacity < min_capacity))) {
+            psh_log_error_fmt("TLSF allocator unable to manage a memory region of %zu bytes.", capacity);
+            return STATUS_FAILED;
+        }
+
+        usize block_size = impl::tlsf_align_down(capacity - impl::TLSF_BLOCK_START_OFFSET - impl::TLSF_BLOCK_OVERHEAD, impl::TLSF_ALIGN_SIZE);
+        if (psh_unlikely(static_cast<u64>(block_size) >= impl::TLSF_BLOCK_MAX_SIZE)) {
+            psh_log_error_fmt("TLSF allocator unable to manage a memory region of %zu bytes.", capacity);
+            return STATUS_FAILED;
+        }
+
+        impl::TlsfBlock* block = impl::tlsf_block_at(buf);
+        block->size            = block_size | impl::TLSF_BLOCK_FREE_BIT;
+        impl::tlsf_block_insert(tlsf, block);
+
+        impl::TlsfBlock* sentinel = impl::tlsf_block_link_next(block);
+        sentinel->size            = impl::TLSF_BLOCK_PREV_FREE_BIT;
+
+        tlsf->capacity = capacity;
+        tlsf->sentinel = sentinel;
+        return STATUS_OK;
+    }
+
+    psh_proc Status tlsf_resize(Tlsf* tlsf, usize new_capacity) psh_no_except {
+        psh_validate_usage(psh_assert_msg((tlsf != nullptr) && (tlsf->sentinel != nullptr), "TLSF allocator isn't initialised."));
+
+        u8*              buf      = tlsf->buf;
+        u8*              new_end  = buf + new_capacity;
+        impl::TlsfBlock* sentinel = tlsf->sentinel;
+
+        if (new_capacity >= tlsf->capacity) {
+            // Turn the sentinel into a block spanning the new memory, which is then freed.
+            u8*   block_memory = impl::tlsf_block_to_ptr(sentinel);
+            usize block_size   = (new_end >= block_memory + impl::TLSF_BLOCK_OVERHEAD)
+                                     ? impl::tlsf_align_down(static_cast<usize>(new_end - block_memory) - impl::TLSF_BLOCK_OVERHEAD, impl::TLSF_ALIGN_SIZE)
+                                     : 0;
+            if (psh_unlikely(static_cast<u64>(block_size) >= impl::TLSF_BLOCK_MAX_SIZE)) {
+                psh_log_error_fmt("TLSF allocator unable to grow to %zu bytes.", new_capacity);
+                return STATUS_FAILED;
+            }
+
+            if (block_size >= impl::TLSF_BLOCK_MIN_SIZE) {
+                impl::tlsf_block_set_size(sentinel, block_size);
+
+                impl::TlsfBlock* new_sentinel = impl::tlsf_block_link_next(sentinel);
+                new_sentinel->size            = 0;
+                tlsf->sentinel                = new_sentinel;
+
+                impl::tlsf_release_block(tlsf, sentinel);
+            }
+
+            tlsf->capacity = new_capacity;
+            return STATUS_OK;
+        }
+
+        // The sentinel already fits the new capacity.
+        if (impl::tlsf_block_to_ptr(sentinel) <= new_end) {
+            tlsf->capacity = new_capacity;
+            return STATUS_OK;
+        }
+
+        // Otherwise, only the last block can be cut, as long as it's free.
+        impl::TlsfBlock* last = impl::tlsf_block_is_prev_free(sentinel) ? sentinel->prev_physical : nullptr;
+        if (psh_unlikely((last == nullptr) || (impl::tlsf_block_to_ptr(last) > new_end))) {
+            psh_log_error_fmt("TLSF allocator unable to shrink to %zu bytes, the memory is still in use.", new_capacity);
+            return STATUS_FAILED;
+        }
+
+        impl::tlsf_block_remove(tlsf, last);
+
+        u8*   last_memory = impl::tlsf_block_to_ptr(last);
+        usize last_size   = (new_end >= last_memory + impl::TLSF_BLOCK_OVERHEAD)
+                                ? impl::tlsf_align_down(static_cast<usize>(new_end - last_memory) - impl::TLSF_BLOCK_OVERHEAD, impl::TLSF_ALIGN_SIZE)
+                                : 0;
+        if (last_size >= impl::TLSF_BLOCK_MIN_SIZE) {
+            impl::tlsf_block_set_size(last, last_size);
+            tlsf->sentinel       = impl::tlsf_block_link_next(last);
+            tlsf->sentinel->size = impl::TLSF_BLOCK_PREV_FREE_BIT;
+            impl::tlsf_block_insert(tlsf, last);
+        } else {
+            // The last block is too small to be kept, it becomes the sentinel. Its previous block is
+            // in use, otherwise both would have been merged.
+            last->size     = 0;
+            tlsf->sentinel = last;
+        }
+
+        tlsf->capacity = new_capacity;
         return STATUS_OK;
     }
 
-    Status Stack::clear_at(u8 const* block) psh_no_except {
-        u8* this_buf = this->buf;
+    psh_proc usize tlsf_block_size(u8 const* block) psh_no_except {
+        return (block != nullptr) ? impl::tlsf_block_get_size(impl::tlsf_block_from_ptr(block)) : 0;
+    }
+
+    psh_proc usize tlsf_largest_free_block(Tlsf const* tlsf) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(tlsf));
+
+        if (tlsf->fl_bitmap == 0) {
+            return 0;
+        }
+
+        u32 fl = 63u - bit_count_leading_zeros(tlsf->fl_bitmap);
+        u32 sl = 31u - bit_count_leading_zeros(tlsf->sl_bitmap[fl]);
+
+        usize largest = 0;
+        for (impl::TlsfBlock const* block = tlsf->free_lists[fl][sl]; block != nullptr; block = block->next_free) {
+            largest = psh_max_value(largest, impl::tlsf_block_get_size(block));
+        }
+        return largest;
+    }
+
+    psh_proc u8* memory_alloc_align(Tlsf* tlsf, usize size_bytes, u32 alignment psh_impl_alloc_site_param) psh_no_except {
+        u8* memory = memory_alloc_align_uninit(tlsf, size_bytes, alignment psh_impl_alloc_site_arg);
+        if (psh_likely(memory != nullptr)) {
+            memory_set(memory, size_bytes, 0);
+        }
+        return memory;
+    }
+
+    psh_proc u8* memory_alloc_align_uninit(Tlsf* tlsf, usize size_bytes, u32 alignment psh_impl_alloc_site_param) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(tlsf);
+            psh_assert_fmt(psh_is_pow_of_two(alignment), "Expected alignment (%u) to be a power of two.", alignment);
+        });
+
+        if (psh_unlikely(size_bytes == 0)) {
+            return nullptr;
+        }
+
+        usize adjusted_size = impl::tlsf_adjust_request_size(size_bytes, impl::TLSF_ALIGN_SIZE);
+
+        // Over-allocate for larger alignments, so that the block can be shifted to an aligned
+        // address while leaving enough room to free the leading gap.
+        usize gap_min_size = psh_usize_of(impl::TlsfBlock);
+        usize request_size = adjusted_size;
+        if ((adjusted_size != 0) && (alignment > impl::TLSF_ALIGN_SIZE)) {
+            request_size = impl::tlsf_adjust_request_size(adjusted_size + alignment + gap_min_size, alignment);
+        }
+
+        impl::TlsfBlock* block = impl::tlsf_locate_free(tlsf, request_size);
+        if (psh_unlikely(block == nullptr)) {
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+            ++tlsf->stats.failed_count;
+            psh_impl_log_allocation_site_of_failure(psh_impl_alloc_site);
+#endif
+            psh_log_error_fmt(
+                "TLSF allocator unable to allocate %zu bytes (with %u bytes of alignment) of memory."
+                " The largest free block has %zu bytes.",
+                size_bytes,
+                alignment,
+                tlsf_largest_free_block(tlsf));
+            psh_impl_return_from_memory_error();
+        }
+
+        if (alignment > impl::TLSF_ALIGN_SIZE) {
+            uptr  memory_addr  = reinterpret_cast<uptr>(impl::tlsf_block_to_ptr(block));
+            uptr  aligned_addr = align_forward(memory_addr, alignment);
+            usize gap          = static_cast<usize>(aligned_addr - memory_addr);
+
+            // The gap must be able to hold a free block.
+            if ((gap != 0) && (gap < gap_min_size)) {
+                usize gap_remaining = gap_min_size - gap;
+                usize offset        = psh_max_value(gap_remaining, static_cast<usize>(alignment));
+                aligned_addr        = align_forward(aligned_addr + offset, alignment);
+                gap                 = static_cast<usize>(aligned_addr - memory_addr);
+            }
+
+            if (gap != 0) {
+                block = impl::tlsf_block_trim_free_leading(tlsf, block, gap);
+            }
+        }
+
+        impl::tlsf_block_trim_free(tlsf, block, adjusted_size);
+        impl::tlsf_block_mark_as_used(block);
+
+        ++tlsf->allocation_count;
+        impl::tlsf_track_usage(tlsf, tlsf->used_bytes + impl::tlsf_block_get_size(block) + impl::TLSF_BLOCK_OVERHEAD);
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        impl::memory_record_allocation(&tlsf->stats, psh_impl_alloc_site, size_bytes, impl::tlsf_block_get_size(block) - size_bytes, tlsf->used_bytes);
+#endif
+
+        // The memory past the requested size is always kept zeroed, so that growing the block in place
+        // never exposes stale data.
+        u8* memory = impl::tlsf_block_to_ptr(block);
+        memory_set(memory + size_bytes, impl::tlsf_block_get_size(block) - size_bytes, 0);
+        return memory;
+    }
+
+    psh_proc void memory_free(Tlsf* tlsf, u8* block) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(tlsf));
+
+        if (psh_unlikely(block == nullptr)) {
+            return;
+        }
+
+        psh_paranoid_validate_usage({
+            psh_assert_msg((block > tlsf->buf) && (block < tlsf->buf + tlsf->capacity), "Block isn't managed by the TLSF allocator.");
+            psh_assert_msg(!impl::tlsf_block_is_free(impl::tlsf_block_from_ptr(block)), "Block was already freed (double free error).");
+        });
+
+        impl::TlsfBlock* header = impl::tlsf_block_from_ptr(block);
+
+        --tlsf->allocation_count;
+        tlsf->used_bytes -= impl::tlsf_block_get_size(header) + impl::TLSF_BLOCK_OVERHEAD;
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        ++tlsf->stats.free_count;
+#endif
+
+        impl::tlsf_release_block(tlsf, header);
+    }
+
+    namespace impl {
+        psh_internal u8* tlsf_realloc(
+            Tlsf* tlsf,
+            u8*   block,
+            usize new_size_bytes,
+            u32   alignment,
+            bool  zero_new_memory psh_impl_alloc_site_param) psh_no_except {
+            psh_validate_usage(psh_assert_not_null(tlsf));
+
+            if (block == nullptr) {
+                return zero_new_memory ? memory_alloc_align(tlsf, new_size_bytes, alignment psh_impl_alloc_site_arg)
+                                       : memory_alloc_align_uninit(tlsf, new_size_bytes, alignment psh_impl_alloc_site_arg);
+            }
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+            ++tlsf->stats.realloc_count;
+#endif
+
+            impl::TlsfBlock* header        = impl::tlsf_block_from_ptr(block);
+            impl::TlsfBlock* next          = impl::tlsf_block_next(header);
+            usize            current_size  = impl::tlsf_block_get_size(header);
+            usize            adjusted_size = impl::tlsf_adjust_request_size(new_size_bytes, impl::TLSF_ALIGN_SIZE);
+            usize            combined_size = current_size + impl::tlsf_block_get_size(next) + impl::TLSF_BLOCK_OVERHEAD;
+            bool             is_aligned    = (reinterpret_cast<uptr>(block) & (static_cast<uptr>(alignment) - 1u)) == 0;
+
+            if (psh_unlikely(adjusted_size == 0)) {
+                psh_log_error_fmt("TLSF allocator unable to reallocate a block to %zu bytes.", new_size_bytes);
+                psh_impl_return_from_memory_error();
+            }
+
+            // Move the block if it can't be resized in place.
+            if (!is_aligned || ((adjusted_size > current_size) && (!impl::tlsf_block_is_free(next) || (adjusted_size > combined_size)))) {
+                u8* new_block = memory_alloc_align_uninit(tlsf, new_size_bytes, alignment psh_impl_alloc_site_arg);
+                if (new_block != nullptr) {
+                    usize copy_size = psh_min_value(current_size, new_size_bytes);
+                    memory_copy(new_block, block, copy_size);
+                    if (zero_new_memory) {
+                        memory_set(new_block + copy_size, new_size_bytes - copy_size, 0);
+                    }
+                    memory_free(tlsf, block);
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+                    tlsf->stats.realloc_copy_bytes += psh_min_value(current_size, new_size_bytes);
+#endif
+                }
+                return new_block;
+            }
+
+            usize used_bytes = tlsf->used_bytes - current_size;
 
-        // Check if the block is within the allocator's memory.
-        bool is_within_region = (block >= this_buf) || (block < pointer_add_bytes(this_buf, this->previous_offset));
-        if (psh_unlikely((block == nullptr) || !is_within_region)) {
-            return STATUS_FAILED;
-        }
+            if (adjusted_size > current_size) {
+                psh_discard_value(impl::tlsf_block_merge_next(tlsf, header));
+                impl::tlsf_block_mark_as_used(header);
+            }
+            impl::tlsf_block_trim_used(tlsf, header, adjusted_size);
+
+            usize new_size = impl::tlsf_block_get_size(header);
+            impl::tlsf_track_usage(tlsf, used_bytes + new_size);
+
+            // Zero-out the memory acquired by the block, as well as the memory left past the new size
+            // when shrinking, so that growing the block again never exposes stale data. Uninitialised
+            // reallocations only keep the memory past the requested size zeroed.
+            if (new_size > current_size) {
+                usize zero_start = zero_new_memory ? current_size : psh_max_value(current_size, new_size_bytes);
+                if (new_size > zero_start) {
+                    memory_set(block + zero_start, new_size - zero_start, 0);
+                }
+            }
+            if (new_size_bytes < current_size) {
+                memory_set(block + new_size_bytes, psh_min_value(current_size, new_size) - new_size_bytes, 0);
+            }
 
-        StackHeader const* header = reinterpret_cast<StackHeader const*>(block - psh_usize_of(StackHeader));
+            return block;
+        }
+    }  // namespace impl
 
-        this->previous_offset = header->previous_offset;
-        this->offset          = no_wrap_sub(
-            no_wrap_sub(reinterpret_cast<uptr>(block), header->padding),
-            reinterpret_cast<uptr>(this_buf));
+    psh_proc u8* memory_realloc_align(Tlsf* tlsf, u8* block, usize new_size_bytes, u32 alignment psh_impl_alloc_site_param) psh_no_except {
+        return impl::tlsf_realloc(tlsf, block, new_size_bytes, alignment, true psh_impl_alloc_site_arg);
+    }
 
-        return STATUS_OK;
+    psh_proc u8* memory_realloc_align_uninit(Tlsf* tlsf, u8* block, usize new_size_bytes, u32 alignment psh_impl_alloc_site_param) psh_no_except {
+        return impl::tlsf_realloc(tlsf, block, new_size_bytes, alignment, false psh_impl_alloc_site_arg);
     }
 
     // -------------------------------------------------------------------------------------------------
-    // Memory manager implementation.
+    // Pool allocator implementation.
     // -------------------------------------------------------------------------------------------------
 
-    void MemoryManager::init(usize capacity_bytes) psh_no_except {
-        psh_paranoid_validate_usage(psh_assert_msg(this->allocation_count == 0, "MemoryManager already initialised."));
+    psh_proc Status init_pool(Pool* pool, Arena* arena, usize block_size, u32 block_alignment, usize blocks_per_chunk) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(pool);
+            psh_assert_msg(block_size > 0, "Pool blocks should have a non-zero size.");
+            psh_assert_msg((block_alignment & (block_alignment - 1u)) == 0, "Pool block alignment should be a power of two.");
+            psh_assert_msg(blocks_per_chunk > 0, "Pool chunks should have at least one block.");
+        });
 
-        this->allocator.init(memory_virtual_alloc(capacity_bytes), capacity_bytes);
+        // Every block has to be able to hold a link of the free list.
+        u32 alignment = psh_max_value(block_alignment, static_cast<u32>(alignof(impl::PoolFreeBlock)));
+        block_size    = psh_max_value(block_size, psh_usize_of(impl::PoolFreeBlock));
+        block_size    = static_cast<usize>(align_forward(block_size, alignment));
+
+        pool->free_list        = nullptr;
+        pool->chunks           = nullptr;
+        pool->arena            = arena;
+        pool->block_size       = block_size;
+        pool->block_alignment  = alignment;
+        pool->blocks_per_chunk = blocks_per_chunk;
+        pool->block_count      = 0;
+        pool->free_count       = 0;
+        atomic_store(&pool->lock, 0u, MemoryOrder::RELAXED);
+
+        return impl::pool_grow(pool);
     }
 
-    void MemoryManager::destroy() psh_no_except {
-        memory_virtual_free(this->allocator.buf, this->allocator.capacity);
-    }
+    psh_proc void destroy_pool(Pool* pool) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(pool));
 
-    Status MemoryManager::pop() psh_no_except {
-        Status st = this->allocator.pop();
-        if (psh_likely(st == STATUS_OK)) {
-            --this->allocation_count;
+        impl::PoolChunk* chunk = pool->chunks;
+        while (chunk != nullptr) {
+            impl::PoolChunk* next = chunk->next;
+            memory_virtual_free(reinterpret_cast<u8*>(chunk), chunk->size_bytes);
+            chunk = next;
         }
-        return st;
+
+        pool->free_list   = nullptr;
+        pool->chunks      = nullptr;
+        pool->block_count = 0;
+        pool->free_count  = 0;
     }
 
-    Status MemoryManager::clear_until(u8 const* block) psh_no_except {
-        psh_validate_usage(psh_assert_not_null(block));
+    namespace impl {
+        psh_proc Status pool_grow(Pool* pool) psh_no_except {
+            usize block_size  = pool->block_size;
+            usize block_count = pool->blocks_per_chunk;
+            u8*   blocks      = nullptr;
+
+            if (pool->arena != nullptr) {
+                blocks = memory_alloc_align(pool->arena, block_count * block_size, pool->block_alignment);
+            } else {
+                // Leave room for the chunk header, filling the remaining pages with blocks.
+                usize page_size   = memory_virtual_page_size();
+                usize header_size = static_cast<usize>(align_forward(psh_usize_of(PoolChunk), pool->block_alignment));
+                usize chunk_size  = static_cast<usize>(align_forward(header_size + block_count * block_size, static_cast<u32>(page_size)));
+
+                u8* memory = memory_virtual_alloc(chunk_size);
+                if (memory != nullptr) {
+                    PoolChunk* chunk  = reinterpret_cast<PoolChunk*>(memory);
+                    chunk->next       = pool->chunks;
+                    chunk->size_bytes = chunk_size;
+                    pool->chunks      = chunk;
+
+                    blocks      = memory + header_size;
+                    block_count = (chunk_size - header_size) / block_size;
+                }
+            }
 
-        u8 const* memory_start = this->allocator.buf;
+            if (psh_unlikely(blocks == nullptr)) {
+                psh_log_error_fmt("Pool unable to acquire a chunk of %zu blocks of %zu bytes.", block_count, block_size);
+                psh_impl_return_from_memory_error();
+            }
 
-        // Check if the block lies within the allocator's memory.
-        if (psh_unlikely((block < memory_start) || (block > memory_start + this->allocator.previous_offset))) {
-            cstring fail_reason = (block > memory_start + this->allocator.capacity)
-                                      ? "MemoryManager::clear_until called with a pointer outside of the stack "
-                                        "memory_start region."
-                                      : "MemoryManager::clear_until called with a pointer to an already free region "
-                                        "of the stack memory_start.";
-            psh_log_error(fail_reason);
-            return STATUS_FAILED;
+            // Link the blocks in address order, so that consecutive allocations are contiguous.
+            for (usize idx = 0; idx + 1 < block_count; ++idx) {
+                reinterpret_cast<PoolFreeBlock*>(blocks + idx * block_size)->next = reinterpret_cast<PoolFreeBlock*>(blocks + (idx + 1) * block_size);
+            }
+            reinterpret_cast<PoolFreeBlock*>(blocks + (block_count - 1) * block_size)->next = pool->free_list;
+
+            pool->free_list = reinterpret_cast<PoolFreeBlock*>(blocks);
+            pool->block_count += block_count;
+            pool->free_count += block_count;
+
+            return STATUS_OK;
         }
 
-        // Pop the top memory block until popping block or reaching the end of the allocator.
-        //
-        // @NOTE: If we were given the incorrect address, we end up clearing the whole memory.
-        for (;;) {
-            u8 const* top_block = this->allocator.top();
-            if (psh_unlikely(top_block == memory_start)) {
-                break;
+        psh_internal void pool_lock(Pool* pool) psh_no_except {
+            while (atomic_exchange(&pool->lock, 1u, MemoryOrder::ACQUIRE) != 0) {
+                while (atomic_load(&pool->lock, MemoryOrder::RELAXED) != 0) {
+                    cpu_relax();
+                }
             }
-            if (psh_likely(this->allocator.pop() == STATUS_OK)) {
-                --this->allocation_count;
+        }
+
+        psh_internal void pool_unlock(Pool* pool) psh_no_except {
+            atomic_store(&pool->lock, 0u, MemoryOrder::RELEASE);
+        }
+
+        psh_proc Status pool_cache_refill(PoolCache* cache) psh_no_except {
+            Pool* pool        = cache->pool;
+            u32   batch_count = cache->capacity / 2;
+
+            pool_lock(pool);
+
+            if (pool->free_count < batch_count) {
+                if (psh_unlikely(!pool_grow(pool) && (pool->free_count == 0))) {
+                    pool_unlock(pool);
+                    return STATUS_FAILED;
+                }
             }
-            if (psh_unlikely(top_block == block)) {
-                break;
+            batch_count = static_cast<u32>(psh_min_value(static_cast<usize>(batch_count), pool->free_count));
+
+            // Detach the first blocks of the pool list.
+            PoolFreeBlock* first = pool->free_list;
+            PoolFreeBlock* last  = first;
+            for (u32 idx = 1; idx < batch_count; ++idx) {
+                last = last->next;
             }
+            pool->free_list = last->next;
+            pool->free_count -= batch_count;
+
+            pool_unlock(pool);
+
+            last->next       = cache->free_list;
+            cache->free_list = first;
+            cache->count += batch_count;
+
+            return STATUS_OK;
         }
 
-        return STATUS_OK;
-    }
+        psh_proc void pool_cache_drain(PoolCache* cache, u32 count) psh_no_except {
+            count = psh_min_value(count, cache->count);
+            if (count == 0) {
+                return;
+            }
 
-    void MemoryManager::clear() psh_no_except {
-        this->allocation_count = 0;
-        this->allocator.clear();
+            // Detach the batch from the cache list before touching the pool.
+            PoolFreeBlock* first = cache->free_list;
+            PoolFreeBlock* last  = first;
+            for (u32 idx = 1; idx < count; ++idx) {
+                last = last->next;
+            }
+            cache->free_list = last->next;
+            cache->count -= count;
+
+            Pool* pool = cache->pool;
+            pool_lock(pool);
+            last->next      = pool->free_list;
+            pool->free_list = first;
+            pool->free_count += count;
+            pool_unlock(pool);
+        }
+    }  // namespace impl
+
+    psh_proc void pool_cache_flush(PoolCache* cache) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(cache));
+        impl::pool_cache_drain(cache, cache->count);
     }
     // -------------------------------------------------------------------------------------------------
     // Memory manipulation procedures.
@@ -368,7 +2270,7 @@ namespace psh {
         // Only effectively remove if the element isn't the last one.
         u8 const* last_element_ptr = pointer_const_subtract_bytes(buf_end, static_cast<isize>(element_size));
         if (element_ptr != last_element_ptr) {
-            memory_move(element_ptr, last_element_ptr, element_size);
+            memory_copy(element_ptr, last_element_ptr, element_size);
         }
     }
 
@@ -379,9 +2281,57 @@ namespace psh {
         // Only effectively remove if the element isn't the last one.
         u8 const* last_element_ptr = pointer_const_subtract_bytes(buf_end, static_cast<isize>(element_size));
         if (element_ptr != last_element_ptr) {
-            u8 const* next_element_ptr = pointer_const_add_bytes(element_ptr, element_size);
-            memory_move(element_ptr, next_element_ptr, static_cast<usize>(pointer_offset(next_element_ptr, buf_end)));
+            // The element lies within the buffer, so neither pointer can be null here.
+            u8 const* next_element_ptr = element_ptr + element_size;
+            memory_move(element_ptr, next_element_ptr, static_cast<usize>(buf_end - next_element_ptr));
+        }
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Dynamic array resizing.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc usize dynamic_array_next_capacity(
+        DynamicArrayResizePolicy policy,
+        usize                    element_size,
+        usize                    current_capacity,
+        usize                    required_capacity) psh_no_except {
+        psh_validate_usage({
+            psh_assert_msg(element_size != 0, "Dynamic arrays can't hold elements of size zero.");
+            psh_assert_msg(
+                (policy.kind != DynamicArrayResize::FIXED_STEP) || (policy.step != 0),
+                "Fixed step resize policies should have a non-zero step.");
+        });
+
+        usize new_capacity = 0;
+        switch (policy.kind) {
+            case DynamicArrayResize::GEOMETRIC: {
+                usize factor = (policy.step != 0) ? policy.step : DYNARRAY_RESIZE_CAPACITY_GROWTH_FACTOR;
+                new_capacity = current_capacity * factor;
+                break;
+            }
+            case DynamicArrayResize::GOLDEN_RATIO: {
+                // Approximate the golden ratio by 1.625, which is cheap to compute.
+                new_capacity = current_capacity + current_capacity / 2u + current_capacity / 8u;
+                break;
+            }
+            case DynamicArrayResize::PAGE_GRANULAR: {
+                usize page_size  = (policy.step != 0) ? policy.step : DYNARRAY_DEFAULT_PAGE_SIZE;
+                usize size_bytes = psh_max_value(current_capacity * 2u, required_capacity) * element_size;
+                size_bytes       = ((size_bytes + page_size - 1u) / page_size) * page_size;
+                new_capacity     = size_bytes / element_size;
+                break;
+            }
+            case DynamicArrayResize::FIXED_STEP: {
+                new_capacity = current_capacity + policy.step;
+                break;
+            }
         }
+
+        // Small arrays should always make progress, regardless of the policy.
+        new_capacity = psh_max_value(new_capacity, current_capacity + 1u);
+        new_capacity = psh_max_value(new_capacity, DYNARRAY_DEFAULT_INITIAL_CAPACITY);
+        return psh_max_value(new_capacity, required_capacity);
     }
 
     // @TODO: integrate this with the PSH_ENABLE_ASSERT_NO_MEMORY_ERROR
@@ -398,7 +2348,15 @@ namespace psh {
     // @TODO: should we really do this? kinda cringe
 #define psh_impl_arena_is_empty(arena) (((arena)->capacity == 0) || ((arena)->buf == nullptr))
 
-    psh_proc u8* memory_alloc_align(Arena* arena, usize size_bytes, u32 alignment) psh_no_except {
+    psh_proc u8* memory_alloc_align(Arena* arena, usize size_bytes, u32 alignment psh_impl_alloc_site_param) psh_no_except {
+        u8* new_block = memory_alloc_align_uninit(arena, size_bytes, alignment psh_impl_alloc_site_arg);
+        if (psh_likely(new_block != nullptr)) {
+            memory_set(new_block, size_bytes, 0);
+        }
+        return new_block;
+    }
+
+    psh_proc u8* memory_alloc_align_uninit(Arena* arena, usize size_bytes, u32 alignment psh_impl_alloc_site_param) psh_no_except {
         psh_validate_usage(psh_assert_not_null(arena));
 
         if (psh_unlikely(size_bytes == 0)) {
@@ -409,23 +2367,106 @@ namespace psh {
         uptr memory_addr    = reinterpret_cast<uptr>(arena->buf);
         uptr new_block_addr = align_forward(memory_addr + arena->offset, alignment);
         if (psh_unlikely(new_block_addr + size_bytes > arena->capacity + memory_addr)) {
-            psh_impl_arena_report_out_of_memory(arena, size_bytes, alignment);
-            psh_impl_return_from_memory_error();
+            // Arenas with reserved memory may still be able to commit the required memory, and
+            // chained arenas can link a new block.
+            usize required_capacity = static_cast<usize>(size_bytes + new_block_addr - memory_addr);
+            bool  grown             = (arena->reserved != 0) && impl::arena_commit(arena, required_capacity);
+            if (!grown && arena->chained) {
+                grown          = impl::arena_chain_block(arena, size_bytes, alignment);
+                memory_addr    = reinterpret_cast<uptr>(arena->buf);
+                new_block_addr = align_forward(memory_addr + arena->offset, alignment);
+            }
+
+            if (!grown) {
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+                ++arena->stats.failed_count;
+                psh_log_error_fmt(
+                    "Arena peak usage of %zu bytes over %zu allocations.",
+                    arena->stats.peak_used_bytes,
+                    arena->stats.allocation_count);
+                psh_impl_log_allocation_site_of_failure(psh_impl_alloc_site);
+#endif
+                psh_impl_arena_report_out_of_memory(arena, size_bytes, alignment);
+                psh_impl_return_from_memory_error();
+            }
         }
 
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        usize padding = static_cast<usize>(new_block_addr - (memory_addr + arena->offset));
+#endif
+
         // Commit the new block of memory.
         arena->offset = static_cast<usize>(size_bytes + new_block_addr - memory_addr);
 
-        u8* new_block = reinterpret_cast<u8*>(new_block_addr);
-        memory_set(new_block, size_bytes, 0);
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        impl::memory_record_allocation(&arena->stats, psh_impl_alloc_site, size_bytes, padding, arena->offset);
+#endif
+
+        return reinterpret_cast<u8*>(new_block_addr);
+    }
+
+    psh_proc u8* memory_alloc_align(AtomicArena* arena, usize size_bytes, u32 alignment psh_impl_alloc_site_param) psh_no_except {
+        u8* new_block = memory_alloc_align_uninit(arena, size_bytes, alignment psh_impl_alloc_site_arg);
+        if (psh_likely(new_block != nullptr)) {
+            memory_set(new_block, size_bytes, 0);
+        }
         return new_block;
     }
 
+    psh_proc u8* memory_alloc_align_uninit(AtomicArena* arena, usize size_bytes, u32 alignment psh_impl_alloc_site_param) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(arena));
+
+        if (psh_unlikely(size_bytes == 0)) {
+            return nullptr;
+        }
+
+        uptr  memory_addr    = reinterpret_cast<uptr>(arena->buf);
+        usize offset         = atomic_load(&arena->offset, MemoryOrder::RELAXED);
+        uptr  new_block_addr = 0;
+
+        // Reserve the block by bumping the offset, retrying if another thread got to it first.
+        for (;;) {
+            new_block_addr = align_forward(memory_addr + offset, alignment);
+            if (psh_unlikely(new_block_addr + size_bytes > arena->capacity + memory_addr)) {
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+                psh_impl_log_allocation_site_of_failure(psh_impl_alloc_site);
+#endif
+                psh_log_error_fmt(
+                    "Atomic arena unable to allocate %zu bytes (with %u bytes of alignment) of memory."
+                    " The allocator has only %zu bytes remaining.",
+                    size_bytes,
+                    alignment,
+                    arena->capacity - offset);
+                psh_impl_return_from_memory_error();
+            }
+
+            usize new_offset = static_cast<usize>(size_bytes + new_block_addr - memory_addr);
+            if (atomic_compare_exchange(&arena->offset, &offset, new_offset, MemoryOrder::RELAXED)) {
+                break;
+            }
+        }
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        // The statistics of atomic arenas would require synchronisation, only the call site is tracked.
+        impl::memory_record_allocation(nullptr, psh_impl_alloc_site, size_bytes, 0, 0);
+#endif
+
+        return reinterpret_cast<u8*>(new_block_addr);
+    }
+
     //
     // @TODO: When asan is available, poison the non-allocated memory regions!!
     //
 
-    psh_proc u8* memory_alloc_align(Stack* stack, usize size_bytes, u32 alignment) psh_no_except {
+    psh_proc u8* memory_alloc_align(Stack* stack, usize size_bytes, u32 alignment psh_impl_alloc_site_param) psh_no_except {
+        u8* new_block = memory_alloc_align_uninit(stack, size_bytes, alignment psh_impl_alloc_site_arg);
+        if (psh_likely(new_block != nullptr)) {
+            memory_set(new_block, size_bytes, 0);
+        }
+        return new_block;
+    }
+
+    psh_proc u8* memory_alloc_align_uninit(Stack* stack, usize size_bytes, u32 alignment psh_impl_alloc_site_param) psh_no_except {
         psh_paranoid_validate_usage(psh_assert_not_null(stack));
 
         if (psh_unlikely(size_bytes == 0)) {
@@ -444,6 +2485,10 @@ namespace psh {
         usize required_bytes = padding + size_bytes;
 
         if (psh_unlikely(required_bytes > current_capacity - current_offset)) {
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+            ++stack->stats.failed_count;
+            psh_impl_log_allocation_site_of_failure(psh_impl_alloc_site);
+#endif
             psh_log_error_fmt(
                 "Unable to allocate %zu bytes of memory (%zu bytes required due to alignment and padding)."
                 " The stack allocator has only %zu bytes remaining.",
@@ -466,116 +2511,470 @@ namespace psh {
         stack->previous_offset = current_offset + padding;
         stack->offset          = current_offset + padding + size_bytes;
 
-        memory_set(new_block, size_bytes, 0);
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        impl::memory_record_allocation(&stack->stats, psh_impl_alloc_site, size_bytes, padding - psh_usize_of(StackHeader), stack->offset);
+#endif
+
         return new_block;
     }
 
+    namespace impl {
+        /// Allocate a new block and copy the old memory into it.
+        psh_internal u8* arena_realloc_move(
+            Arena* arena,
+            u8*    block,
+            usize  current_size_bytes,
+            usize  new_size_bytes,
+            u32    alignment,
+            bool   zero_new_memory psh_impl_alloc_site_param) psh_no_except {
+            u8* new_block = memory_alloc_align_uninit(arena, new_size_bytes, alignment psh_impl_alloc_site_arg);
+            if (psh_unlikely(new_block == nullptr)) {
+                return nullptr;
+            }
+
+            usize copy_size = psh_min_value(current_size_bytes, new_size_bytes);
+            memory_move(new_block, block, copy_size);
+            if (zero_new_memory) {
+                memory_set(new_block + copy_size, new_size_bytes - copy_size, 0);
+            }
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+            ++arena->stats.realloc_count;
+            arena->stats.realloc_copy_bytes += copy_size;
+#endif
+            return new_block;
+        }
+
+        psh_internal u8* arena_realloc(
+            Arena* arena,
+            u8*    block,
+            usize  current_size_bytes,
+            usize  new_size_bytes,
+            u32    alignment,
+            bool   zero_new_memory psh_impl_alloc_site_param) psh_no_except {
+            psh_paranoid_validate_usage(psh_assert_not_null(arena));
+            psh_validate_usage({
+                psh_assert_msg(block != nullptr, "Don't use realloc to allocate new memory.");
+                psh_assert_msg(current_size_bytes != 0, "Don't use realloc to allocate new memory.");
+                psh_assert_msg(new_size_bytes != 0, "Don't use realloc to free blocks of memory.");
+            });
+
+            uptr  memory_addr      = reinterpret_cast<uptr>(arena->buf);
+            uptr  memory_end       = memory_addr + arena->capacity;
+            usize memory_offset    = arena->offset;
+            uptr  free_memory_addr = memory_addr + memory_offset;
+
+            uptr block_addr = reinterpret_cast<uptr>(block);
+
+            // Check if the block lies within the allocator's memory. Blocks of chained arenas may
+            // also lie in one of the previous blocks of the arena, in which case they are moved.
+            bool in_current_block = (block_addr >= memory_addr) && (block_addr < memory_end);
+            if (psh_unlikely(!in_current_block)) {
+                if (!arena->chained) {
+                    psh_log_error("Pointer outside of the arena memory region.");
+                    psh_impl_return_from_memory_error();
+                }
+                return impl::arena_realloc_move(arena, block, current_size_bytes, new_size_bytes, alignment, zero_new_memory psh_impl_alloc_site_arg);
+            }
+
+            // Check if the block is already free.
+            if (psh_unlikely(block_addr >= free_memory_addr)) {
+                psh_log_error("Pointer to a free address of the arena memory region.");
+                psh_impl_return_from_memory_error();
+            }
+
+            if (psh_unlikely(current_size_bytes > memory_offset)) {
+                psh_log_error_fmt(
+                    "current_block_size (%zu) surpasses the current offset (%zu) of the arena, which isn't allowed.",
+                    current_size_bytes,
+                    memory_offset);
+                psh_impl_return_from_memory_error();
+            }
+
+            // If the block is the last allocated, just bump the offset.
+            if (block_addr == free_memory_addr - current_size_bytes) {
+                // Check if there is enough space, committing more memory if the arena has reserved memory.
+                usize required_capacity = static_cast<usize>(block_addr + new_size_bytes - memory_addr);
+                bool  fits              = (block_addr + new_size_bytes <= memory_end)
+                           || ((arena->reserved != 0) && impl::arena_commit(arena, required_capacity));
+                if (psh_unlikely(!fits && arena->chained)) {
+                    // Move the block to a new block of the arena, its old memory is discarded
+                    // along with the current block.
+                    return impl::arena_realloc_move(arena, block, current_size_bytes, new_size_bytes, alignment, zero_new_memory psh_impl_alloc_site_arg);
+                }
+                if (psh_unlikely(!fits)) {
+                    psh_log_error_fmt(
+                        "Unable to reallocate block from %zu bytes to %zu bytes.",
+                        current_size_bytes,
+                        new_size_bytes);
+                    psh_impl_return_from_memory_error();
+                }
+
+                arena->offset = static_cast<usize>(
+                    static_cast<isize>(memory_offset) + static_cast<isize>(new_size_bytes - current_size_bytes));
+
+                // The memory past the offset may hold data of blocks that were already discarded.
+                if (zero_new_memory && (new_size_bytes > current_size_bytes)) {
+                    memory_set(block + current_size_bytes, new_size_bytes - current_size_bytes, 0);
+                }
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+                ++arena->stats.realloc_count;
+                arena->stats.peak_used_bytes = psh_max_value(arena->stats.peak_used_bytes, arena->offset);
+#endif
+                return block;
+            }
+
+            return impl::arena_realloc_move(arena, block, current_size_bytes, new_size_bytes, alignment, zero_new_memory psh_impl_alloc_site_arg);
+        }
+
+        psh_internal u8* stack_realloc(
+            Stack* stack,
+            u8*    block,
+            usize  new_size_bytes,
+            u32    alignment,
+            bool   zero_new_memory psh_impl_alloc_site_param) psh_no_except {
+            psh_paranoid_validate_usage(psh_assert_not_null(stack));
+            psh_validate_usage({
+                psh_assert_msg(stack->buf != nullptr, "Stack uninitialised.");
+                psh_assert_msg(block != nullptr, "Don't use realloc to allocate new memory.");
+                psh_assert_msg(new_size_bytes != 0, "Don't use realloc to free existing memory blocks.");
+            });
+
+            // If ptr is the last allocated block, just adjust the offsets.
+            if (block == stack->top()) {
+                StackHeader* header       = reinterpret_cast<StackHeader*>(block - psh_usize_of(StackHeader));
+                usize        current_size = header->capacity;
+
+                if (psh_unlikely(new_size_bytes > stack->capacity - stack->previous_offset)) {
+                    psh_log_error_fmt(
+                        "Cannot reallocate memory from size %zu to %zu. Only %zu bytes of memory remaining.",
+                        current_size,
+                        new_size_bytes,
+                        stack->capacity - stack->offset);
+                    psh_impl_return_from_memory_error();
+                }
+
+                stack->offset    = stack->previous_offset + new_size_bytes;
+                header->capacity = new_size_bytes;
+
+                // The memory past the offset may hold data of blocks that were already popped.
+                if (zero_new_memory && (new_size_bytes > current_size)) {
+                    memory_set(block + current_size, new_size_bytes - current_size, 0);
+                }
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+                ++stack->stats.realloc_count;
+                stack->stats.peak_used_bytes = psh_max_value(stack->stats.peak_used_bytes, stack->offset);
+#endif
+                return block;
+            }
+
+            // Check if the address is within the allocator's memory.
+            if (psh_unlikely((block < stack->buf) || (block >= stack->buf + stack->capacity))) {
+                psh_log_error("Pointer outside of the memory region managed by the stack allocator.");
+                psh_impl_return_from_memory_error();
+            }
+
+            // Check if the address is already free.
+            if (psh_unlikely(block >= stack->buf + stack->offset)) {
+                psh_log_error("Called with a free block of memory (use-after-free error).");
+                psh_impl_return_from_memory_error();
+            }
+
+            StackHeader const* header = reinterpret_cast<StackHeader const*>(block - psh_usize_of(StackHeader));
+
+            // Check memory availability.
+            if (psh_unlikely(new_size_bytes > stack->capacity - stack->offset)) {
+                psh_log_error_fmt(
+                    "Cannot reallocate memory from size %zu to %zu. Only %zu bytes of memory remaining.",
+                    header->capacity,
+                    new_size_bytes,
+                    stack->capacity - stack->offset);
+                psh_impl_return_from_memory_error();
+            }
+
+            u8* new_block = memory_alloc_align_uninit(stack, new_size_bytes, alignment psh_impl_alloc_site_arg);
+            if (psh_unlikely(new_block == nullptr)) {
+                return nullptr;
+            }
+
+            usize const copy_size = psh_min_value(header->capacity, new_size_bytes);
+            memory_copy(new_block, block, copy_size);
+            if (zero_new_memory) {
+                memory_set(new_block + copy_size, new_size_bytes - copy_size, 0);
+            }
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+            ++stack->stats.realloc_count;
+            stack->stats.realloc_copy_bytes += copy_size;
+#endif
+
+            return new_block;
+        }
+    }  // namespace impl
+
     psh_proc u8* memory_realloc_align(
         Arena* arena,
         u8*    block,
         usize  current_size_bytes,
         usize  new_size_bytes,
-        u32    alignment) psh_no_except {
-        psh_paranoid_validate_usage(psh_assert_not_null(arena));
-        psh_validate_usage({
-            psh_assert_msg(block != nullptr, "Don't use realloc to allocate new memory.");
-            psh_assert_msg(current_size_bytes != 0, "Don't use realloc to allocate new memory.");
-            psh_assert_msg(new_size_bytes != 0, "Don't use realloc to free blocks of memory.");
-        });
+        u32    alignment psh_impl_alloc_site_param) psh_no_except {
+        return impl::arena_realloc(arena, block, current_size_bytes, new_size_bytes, alignment, true psh_impl_alloc_site_arg);
+    }
+
+    psh_proc u8* memory_realloc_align_uninit(
+        Arena* arena,
+        u8*    block,
+        usize  current_size_bytes,
+        usize  new_size_bytes,
+        u32    alignment psh_impl_alloc_site_param) psh_no_except {
+        return impl::arena_realloc(arena, block, current_size_bytes, new_size_bytes, alignment, false psh_impl_alloc_site_arg);
+    }
 
-        uptr  memory_addr      = reinterpret_cast<uptr>(arena->buf);
-        uptr  memory_end       = memory_addr + arena->capacity;
-        usize memory_offset    = arena->offset;
-        uptr  free_memory_addr = memory_addr + memory_offset;
+    psh_proc u8* memory_realloc_align(Stack* stack, u8* block, usize new_size_bytes, u32 alignment psh_impl_alloc_site_param) psh_no_except {
+        return impl::stack_realloc(stack, block, new_size_bytes, alignment, true psh_impl_alloc_site_arg);
+    }
 
-        uptr block_addr = reinterpret_cast<uptr>(block);
+    psh_proc u8* memory_realloc_align_uninit(Stack* stack, u8* block, usize new_size_bytes, u32 alignment psh_impl_alloc_site_param) psh_no_except {
+        return impl::stack_realloc(stack, block, new_size_bytes, alignment, false psh_impl_alloc_site_arg);
+    }
 
-        // Check if the block lies within the allocator's memory.
-        if (psh_unlikely((block_addr < memory_addr) || (block_addr >= memory_end))) {
-            psh_log_error("Pointer outside of the arena memory region.");
-            psh_impl_return_from_memory_error();
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+    // -------------------------------------------------------------------------------------------------
+    // Allocation instrumentation.
+    // -------------------------------------------------------------------------------------------------
+
+    namespace impl {
+        /// Open addressing table of the call sites of allocations, shared by all threads.
+        ///
+        /// Sites are identified by their file name and line. The file name is compared by value since
+        /// the same file may be referred to by distinct strings in distinct translation units.
+        struct AllocationSiteTable {
+            AllocationSiteStats sites[MEMORY_INSTRUMENTATION_MAX_SITES];
+            usize               count;
+            usize               dropped_allocation_count;
+            usize               dropped_bytes_allocated;
+            Atomic<u32>         lock;
+        };
+
+        static_assert(psh_is_pow_of_two(MEMORY_INSTRUMENTATION_MAX_SITES), "The site table capacity should be a power of two.");
+
+        psh_internal AllocationSiteTable allocation_site_table = {};
+
+        psh_internal void allocation_site_table_lock() psh_no_except {
+            while (atomic_exchange(&allocation_site_table.lock, 1u, MemoryOrder::ACQUIRE) != 0) {
+                while (atomic_load(&allocation_site_table.lock, MemoryOrder::RELAXED) != 0) {
+                    cpu_relax();
+                }
+            }
         }
 
-        // Check if the block is already free.
-        if (psh_unlikely(block_addr >= free_memory_addr)) {
-            psh_log_error("Pointer to a free address of the arena memory region.");
-            psh_impl_return_from_memory_error();
+        psh_internal void allocation_site_table_unlock() psh_no_except {
+            atomic_store(&allocation_site_table.lock, 0u, MemoryOrder::RELEASE);
         }
 
-        if (psh_unlikely(current_size_bytes > memory_offset)) {
-            psh_log_error_fmt(
-                "current_block_size (%zu) surpasses the current offset (%zu) of the arena, which isn't allowed.",
-                current_size_bytes,
-                memory_offset);
-            psh_impl_return_from_memory_error();
+        psh_internal bool allocation_site_equal(SourceLocation const& lhs, SourceLocation const& rhs) psh_no_except {
+            return (lhs.line == rhs.line)
+                   && ((lhs.file_name == rhs.file_name) || (strcmp(lhs.file_name, rhs.file_name) == 0));
         }
 
-        // If the block is the last allocated, just bump the offset.
-        if (block_addr == free_memory_addr - current_size_bytes) {
-            // Check if there is enough space.
-            if (psh_unlikely(block_addr + new_size_bytes > memory_end)) {
-                psh_log_error_fmt(
-                    "Unable to reallocate block from %zu bytes to %zu bytes.",
-                    current_size_bytes,
-                    new_size_bytes);
-                psh_impl_return_from_memory_error();
+        psh_internal void allocation_site_record(SourceLocation const& site, usize size_bytes) psh_no_except {
+            u64   hash = hash_bytes(reinterpret_cast<u8 const*>(site.file_name), strlen(site.file_name)) ^ hash_mix(site.line);
+            usize mask = MEMORY_INSTRUMENTATION_MAX_SITES - 1u;
+
+            allocation_site_table_lock();
+
+            AllocationSiteTable* table = &allocation_site_table;
+            for (usize probe = 0, idx = static_cast<usize>(hash) & mask; probe < MEMORY_INSTRUMENTATION_MAX_SITES;
+                 ++probe, idx = (idx + 1u) & mask) {
+                AllocationSiteStats* entry = &table->sites[idx];
+
+                if (entry->location.file_name == nullptr) {
+                    entry->location = site;
+                    ++table->count;
+                } else if (!allocation_site_equal(entry->location, site)) {
+                    continue;
+                }
+
+                ++entry->allocation_count;
+                entry->bytes_allocated += size_bytes;
+
+                allocation_site_table_unlock();
+                return;
             }
 
-            arena->offset = static_cast<usize>(
-                static_cast<isize>(memory_offset) + static_cast<isize>(new_size_bytes - current_size_bytes));
-            return block;
+            ++table->dropped_allocation_count;
+            table->dropped_bytes_allocated += size_bytes;
+
+            allocation_site_table_unlock();
         }
 
-        // Allocate a new block and copy old memory.
-        u8* new_block = memory_alloc_align(arena, new_size_bytes, alignment);
-        memory_move(new_block, block, psh_min_value(current_size_bytes, new_size_bytes));
+        /// Collect the indices of the used entries of the site table, sorted by decreasing number of
+        /// bytes allocated. Should be called with the table locked.
+        psh_internal usize allocation_sites_sorted(u16* indices) psh_no_except {
+            AllocationSiteTable const* table = &allocation_site_table;
+
+            usize count = 0;
+            for (usize idx = 0; idx < MEMORY_INSTRUMENTATION_MAX_SITES; ++idx) {
+                if (table->sites[idx].location.file_name == nullptr) {
+                    continue;
+                }
+
+                // Insertion sort, reports aren't expected to be in any hot path.
+                usize pos = count++;
+                while ((pos > 0) && (table->sites[indices[pos - 1]].bytes_allocated < table->sites[idx].bytes_allocated)) {
+                    indices[pos] = indices[pos - 1];
+                    --pos;
+                }
+                indices[pos] = static_cast<u16>(idx);
+            }
 
-        return new_block;
-    }
+            return count;
+        }
 
-    psh_proc u8* memory_realloc_align(Stack* stack, u8* block, usize new_size_bytes, u32 alignment) psh_no_except {
-        psh_paranoid_validate_usage(psh_assert_not_null(stack));
+        psh_internal void default_memory_report_writer(void* context, char const* msg, usize length) psh_no_except {
+            psh_discard_value(context);
+            psh_discard_value(fwrite(msg, 1, length, stderr));
+        }
+
+        psh_internal psh_attribute_fmt(3) void memory_report_line(MemoryReportWriter* writer, void* context, cstring fmt, ...) psh_no_except {
+            char    line[256];
+            va_list args;
+            va_start(args, fmt);
+#    if PSH_ENABLE_USE_STB_SPRINTF
+            i32 length = string_format_list(line, static_cast<i32>(psh_usize_of(line)), fmt, args);
+#    else
+            i32 length = vsnprintf(line, sizeof(line), fmt, args);
+#    endif
+            va_end(args);
+
+            if (psh_unlikely(length <= 0)) {
+                return;
+            }
+
+            // Keep the line feed of truncated lines.
+            usize line_length = psh_min_value(static_cast<usize>(length), sizeof(line) - 2);
+            if (line[line_length - 1] != '\n') {
+                line[line_length++] = '\n';
+            }
+            writer(context, line, line_length);
+        }
+
+        psh_proc void memory_record_allocation(
+            AllocatorStats*       stats,
+            SourceLocation const& site,
+            usize                 size_bytes,
+            usize                 padding_bytes,
+            usize                 used_bytes) psh_no_except {
+            if (stats != nullptr) {
+                ++stats->allocation_count;
+                stats->bytes_allocated += size_bytes;
+                stats->padding_bytes += padding_bytes;
+                stats->peak_used_bytes = psh_max_value(stats->peak_used_bytes, used_bytes);
+            }
+
+            allocation_site_record(site, size_bytes);
+        }
+    }  // namespace impl
+
+    psh_proc void memory_report_allocator_stats(
+        cstring               name,
+        AllocatorStats const* stats,
+        MemoryReportWriter*   writer,
+        void*                 context) psh_no_except {
         psh_validate_usage({
-            psh_assert_msg(stack->buf != nullptr, "Stack uninitialised.");
-            psh_assert_msg(block != nullptr, "Don't use realloc to allocate new memory.");
-            psh_assert_msg(new_size_bytes != 0, "Don't use realloc to free existing memory blocks.");
+            psh_assert_not_null(name);
+            psh_assert_not_null(stats);
         });
 
-        // If ptr is the last allocated block, just adjust the offsets.
-        if (block == stack->top()) {
-            stack->offset = stack->previous_offset + new_size_bytes;
-            return block;
+        if (writer == nullptr) {
+            writer = impl::default_memory_report_writer;
         }
 
-        // Check if the address is within the allocator's memory.
-        if (psh_unlikely((block < stack->buf) || (block >= stack->buf + stack->capacity))) {
-            psh_log_error("Pointer outside of the memory region managed by the stack allocator.");
-            psh_impl_return_from_memory_error();
-        }
+        impl::memory_report_line(writer, context, "Allocator '%s':\n", name);
+        impl::memory_report_line(
+            writer,
+            context,
+            "    allocations: %zu (%zu failed, %zu freed)\n",
+            stats->allocation_count,
+            stats->failed_count,
+            stats->free_count);
+        impl::memory_report_line(writer, context, "    bytes allocated: %zu\n", stats->bytes_allocated);
+        impl::memory_report_line(writer, context, "    padding bytes: %zu\n", stats->padding_bytes);
+        impl::memory_report_line(writer, context, "    peak used bytes: %zu\n", stats->peak_used_bytes);
+        impl::memory_report_line(
+            writer,
+            context,
+            "    reallocations: %zu (%zu bytes copied)\n",
+            stats->realloc_count,
+            stats->realloc_copy_bytes);
+    }
 
-        // Check if the address is already free.
-        if (psh_unlikely(block >= stack->buf + stack->offset)) {
-            psh_log_error("Called with a free block of memory (use-after-free error).");
-            psh_impl_return_from_memory_error();
+    psh_proc void memory_report_allocation_sites(MemoryReportWriter* writer, void* context) psh_no_except {
+        if (writer == nullptr) {
+            writer = impl::default_memory_report_writer;
         }
 
-        StackHeader const* header = reinterpret_cast<StackHeader const*>(block + psh_usize_of(StackHeader));
+        // Copy the sites before writing, so that the writer is free to allocate.
+        u16                 indices[MEMORY_INSTRUMENTATION_MAX_SITES];
+        AllocationSiteStats sites[MEMORY_INSTRUMENTATION_MAX_SITES];
 
-        // Check memory availability.
-        if (psh_unlikely(new_size_bytes > stack->capacity - stack->offset)) {
-            psh_log_error_fmt(
-                "Cannot reallocate memory from size %zu to %zu. Only %zu bytes of memory remaining.",
-                header->capacity,
-                new_size_bytes,
-                stack->capacity - stack->offset);
-            psh_impl_return_from_memory_error();
+        impl::allocation_site_table_lock();
+        usize count                    = impl::allocation_sites_sorted(indices);
+        usize dropped_allocation_count = impl::allocation_site_table.dropped_allocation_count;
+        usize dropped_bytes_allocated  = impl::allocation_site_table.dropped_bytes_allocated;
+        for (usize idx = 0; idx < count; ++idx) {
+            sites[idx] = impl::allocation_site_table.sites[indices[idx]];
+        }
+        impl::allocation_site_table_unlock();
+
+        impl::memory_report_line(writer, context, "Allocation sites (%zu), sorted by bytes allocated:\n", count);
+        for (usize idx = 0; idx < count; ++idx) {
+            AllocationSiteStats const& site = sites[idx];
+            impl::memory_report_line(
+                writer,
+                context,
+                "    %12zu bytes %8zu allocations at %s:%u (%s)\n",
+                site.bytes_allocated,
+                site.allocation_count,
+                site.location.file_name,
+                site.location.line,
+                site.location.function_name);
+        }
+
+        if (dropped_allocation_count != 0) {
+            impl::memory_report_line(
+                writer,
+                context,
+                "    %12zu bytes %8zu allocations at untracked sites\n",
+                dropped_bytes_allocated,
+                dropped_allocation_count);
         }
+    }
 
-        u8* new_block = memory_alloc_align(stack, new_size_bytes, alignment);
+    psh_proc usize memory_allocation_sites(AllocationSiteStats* sites, usize max_count) psh_no_except {
+        psh_validate_usage(psh_assert_msg((max_count == 0) || (sites != nullptr), "Null sites with a non-zero count."));
 
-        usize const copy_size = psh_min_value(header->capacity, new_size_bytes);
-        memory_copy(reinterpret_cast<u8*>(new_block), reinterpret_cast<u8 const*>(block), copy_size);
+        u16 indices[MEMORY_INSTRUMENTATION_MAX_SITES];
 
-        return new_block;
+        impl::allocation_site_table_lock();
+        usize count = psh_min_value(impl::allocation_sites_sorted(indices), max_count);
+        for (usize idx = 0; idx < count; ++idx) {
+            sites[idx] = impl::allocation_site_table.sites[indices[idx]];
+        }
+        impl::allocation_site_table_unlock();
+
+        return count;
+    }
+
+    psh_proc void memory_reset_allocation_sites() psh_no_except {
+        impl::allocation_site_table_lock();
+        memory_set(reinterpret_cast<u8*>(impl::allocation_site_table.sites), psh_usize_of(impl::allocation_site_table.sites), 0);
+        impl::allocation_site_table.count                    = 0;
+        impl::allocation_site_table.dropped_allocation_count = 0;
+        impl::allocation_site_table.dropped_bytes_allocated  = 0;
+        impl::allocation_site_table_unlock();
     }
+#endif
 }  // namespace psh
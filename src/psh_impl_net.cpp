@@ -0,0 +1,1102 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Implementation of the networking module.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include "psh_net.hpp"
+
+#include <errno.h>
+#include <string.h>
+#include "psh_core.hpp"
+#include "psh_debug.hpp"
+#include "psh_platform.hpp"
+
+#if PSH_OS_WINDOWS
+#    include <WinSock2.h>
+#    include <WS2tcpip.h>
+#    if PSH_COMPILER_MSVC
+#        pragma comment(lib, "Ws2_32.lib")
+#    endif
+#else
+#    include <arpa/inet.h>
+#    include <fcntl.h>
+#    include <netinet/in.h>
+#    include <netinet/tcp.h>
+#    include <sys/socket.h>
+#    include <unistd.h>
+#endif
+
+#if PSH_OS_LINUX
+#    include <sys/epoll.h>
+#elif PSH_OS_APPLE
+#    include <sys/event.h>
+#endif
+
+namespace psh::impl {
+    static_assert(sizeof(sockaddr_in6) <= NET_ADDRESS_MAX_SIZE, "NetAddress can't hold an IPv6 address.");
+
+    /// Number of datagrams transferred by each recvmmsg and sendmmsg call.
+    psh_internal constexpr u32 NET_DATAGRAM_CHUNK_SIZE = 32;
+
+    /// Largest number of bytes transferred by a single call, which takes an int on Windows.
+    psh_internal constexpr usize NET_TRANSFER_MAX_SIZE = 0x7FFFFFFF;
+
+#if PSH_OS_WINDOWS
+    using NativeSocket = SOCKET;
+    using AddressSize  = int;
+
+    psh_internal constexpr NativeSocket NET_INVALID_SOCKET = INVALID_SOCKET;
+
+    psh_internal psh_inline i32 net_last_error() psh_no_except {
+        return WSAGetLastError();
+    }
+
+    psh_internal psh_inline bool net_error_would_block(i32 error) psh_no_except {
+        return (error == WSAEWOULDBLOCK);
+    }
+
+    psh_internal psh_inline bool net_error_interrupted(i32 error) psh_no_except {
+        return (error == WSAEINTR);
+    }
+
+    psh_internal psh_inline bool net_error_closed(i32 error) psh_no_except {
+        return (error == WSAECONNRESET) || (error == WSAECONNABORTED) || (error == WSAESHUTDOWN);
+    }
+
+    psh_internal psh_inline void net_close_native(NativeSocket handle) psh_no_except {
+        closesocket(handle);
+    }
+
+#    define psh_impl_log_net_error(msg, error) psh_log_error_fmt(msg " due to the error: %d", error)
+#else
+    using NativeSocket = i32;
+    using AddressSize  = socklen_t;
+
+    psh_internal constexpr NativeSocket NET_INVALID_SOCKET = -1;
+
+    psh_internal psh_inline i32 net_last_error() psh_no_except {
+        return errno;
+    }
+
+    psh_internal psh_inline bool net_error_would_block(i32 error) psh_no_except {
+        return (error == EAGAIN) || (error == EWOULDBLOCK);
+    }
+
+    psh_internal psh_inline bool net_error_interrupted(i32 error) psh_no_except {
+        return (error == EINTR);
+    }
+
+    psh_internal psh_inline bool net_error_closed(i32 error) psh_no_except {
+        return (error == ECONNRESET) || (error == EPIPE) || (error == ECONNABORTED);
+    }
+
+    psh_internal psh_inline void net_close_native(NativeSocket handle) psh_no_except {
+        close(handle);
+    }
+
+#    define psh_impl_log_net_error(msg, error) psh_log_error_fmt(msg " due to the error: %s", strerror(error))
+#endif
+
+    // Writing to a connection closed by the peer shouldn't raise SIGPIPE, which terminates the
+    // process by default. macOS lacks MSG_NOSIGNAL and sets SO_NOSIGPIPE on each socket instead.
+#if PSH_OS_LINUX
+    psh_internal constexpr i32 NET_SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    psh_internal constexpr i32 NET_SEND_FLAGS = 0;
+#endif
+
+    psh_internal psh_inline NativeSocket net_native(Socket const* socket) psh_no_except {
+        return static_cast<NativeSocket>(socket->handle);
+    }
+
+    psh_internal psh_inline sockaddr const* net_sockaddr(NetAddress const* address) psh_no_except {
+        return reinterpret_cast<sockaddr const*>(address->storage);
+    }
+
+    psh_internal psh_inline sockaddr* net_sockaddr(NetAddress* address) psh_no_except {
+        return reinterpret_cast<sockaddr*>(address->storage);
+    }
+
+    psh_internal psh_inline NetStatus net_status_from_error(i32 error) psh_no_except {
+        if (net_error_would_block(error)) {
+            return NET_STATUS_WOULD_BLOCK;
+        }
+        if (net_error_closed(error)) {
+            return NET_STATUS_CLOSED;
+        }
+        return NET_STATUS_FAILED;
+    }
+
+#if !PSH_OS_LINUX
+    /// Make a socket non-blocking, not inherited by child processes and, on macOS, not raising
+    /// SIGPIPE. Linux sockets are configured on creation instead.
+    psh_internal Status net_configure_socket(NativeSocket handle) psh_no_except {
+#    if PSH_OS_WINDOWS
+        u_long non_blocking = 1;
+        return (ioctlsocket(handle, FIONBIO, &non_blocking) == 0);
+#    else
+        i32 flags = fcntl(handle, F_GETFL, 0);
+        if ((flags == -1) || (fcntl(handle, F_SETFL, flags | O_NONBLOCK) == -1)) {
+            return STATUS_FAILED;
+        }
+        if (fcntl(handle, F_SETFD, FD_CLOEXEC) == -1) {
+            return STATUS_FAILED;
+        }
+#        if PSH_OS_APPLE
+        i32 enable = 1;
+        if (setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable)) == -1) {
+            return STATUS_FAILED;
+        }
+#        endif
+        return STATUS_OK;
+#    endif
+    }
+#endif
+
+    psh_internal Status net_open_socket(Socket* socket, NetAddress const* address, i32 type, i32 protocol) psh_no_except {
+        i32 const family = net_sockaddr(address)->sa_family;
+
+#if PSH_OS_WINDOWS
+        NativeSocket handle = WSASocketW(family, type, protocol, nullptr, 0, WSA_FLAG_NO_HANDLE_INHERIT);
+#elif PSH_OS_LINUX
+        NativeSocket handle = ::socket(family, type | SOCK_NONBLOCK | SOCK_CLOEXEC, protocol);
+#else
+        NativeSocket handle = ::socket(family, type, protocol);
+#endif
+        if (psh_unlikely(handle == NET_INVALID_SOCKET)) {
+            psh_impl_log_net_error("Unable to create a socket", net_last_error());
+            return STATUS_FAILED;
+        }
+
+#if !PSH_OS_LINUX
+        if (psh_unlikely(!net_configure_socket(handle))) {
+            psh_impl_log_net_error("Unable to configure a socket", net_last_error());
+            net_close_native(handle);
+            return STATUS_FAILED;
+        }
+#endif
+
+        socket->handle = static_cast<decltype(socket->handle)>(handle);
+        return STATUS_OK;
+    }
+}  // namespace psh::impl
+
+namespace psh {
+    psh_proc Status init_net() psh_no_except {
+#if PSH_OS_WINDOWS
+        WSADATA data;
+        i32     error = WSAStartup(MAKEWORD(2, 2), &data);
+        if (psh_unlikely(error != 0)) {
+            psh_impl_log_net_error("Unable to initialise Winsock", error);
+            return STATUS_FAILED;
+        }
+#endif
+        return STATUS_OK;
+    }
+
+    psh_proc void destroy_net() psh_no_except {
+#if PSH_OS_WINDOWS
+        WSACleanup();
+#endif
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Addresses.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc NetAddress make_net_address_ipv4(u8 a, u8 b, u8 c, u8 d, u16 port) psh_no_except {
+        NetAddress address = {};
+
+        sockaddr_in* ipv4     = reinterpret_cast<sockaddr_in*>(address.storage);
+        ipv4->sin_family      = AF_INET;
+        ipv4->sin_port        = htons(port);
+        ipv4->sin_addr.s_addr = htonl((static_cast<u32>(a) << 24) | (static_cast<u32>(b) << 16) | (static_cast<u32>(c) << 8) | d);
+
+        address.size = static_cast<u32>(sizeof(sockaddr_in));
+        return address;
+    }
+
+    psh_proc Status net_address_parse(String host, u16 port, NetAddress* address) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(address));
+
+        // The parser expects a zero-terminated string, long enough for any IPv6 address.
+        char host_buf[INET6_ADDRSTRLEN];
+        if (host.count >= psh_usize_of(host_buf)) {
+            return STATUS_FAILED;
+        }
+        memory_copy(reinterpret_cast<u8*>(host_buf), reinterpret_cast<u8 const*>(host.buf), host.count);
+        host_buf[host.count] = 0;
+
+        NetAddress parsed = {};
+
+        sockaddr_in* ipv4 = reinterpret_cast<sockaddr_in*>(parsed.storage);
+        if (inet_pton(AF_INET, host_buf, &ipv4->sin_addr) == 1) {
+            ipv4->sin_family = AF_INET;
+            ipv4->sin_port   = htons(port);
+            parsed.size      = static_cast<u32>(sizeof(sockaddr_in));
+            *address         = parsed;
+            return STATUS_OK;
+        }
+
+        sockaddr_in6* ipv6 = reinterpret_cast<sockaddr_in6*>(parsed.storage);
+        if (inet_pton(AF_INET6, host_buf, &ipv6->sin6_addr) == 1) {
+            ipv6->sin6_family = AF_INET6;
+            ipv6->sin6_port   = htons(port);
+            parsed.size       = static_cast<u32>(sizeof(sockaddr_in6));
+            *address          = parsed;
+            return STATUS_OK;
+        }
+
+        return STATUS_FAILED;
+    }
+
+    psh_proc u16 net_address_port(NetAddress const* address) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(address));
+
+        // The port lies at the same position for both families.
+        return ntohs(reinterpret_cast<sockaddr_in const*>(address->storage)->sin_port);
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Sockets.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc Status net_tcp_listen(Socket* listener, NetAddress const* address, u32 backlog) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(listener);
+            psh_assert_not_null(address);
+        });
+
+        if (psh_unlikely(!impl::net_open_socket(listener, address, SOCK_STREAM, IPPROTO_TCP))) {
+            return STATUS_FAILED;
+        }
+        impl::NativeSocket handle = impl::net_native(listener);
+
+        // Allow restarted servers to bind to their port while old connections are timing out. On
+        // Windows, this would allow other sockets to steal the port, which is excluded by default.
+#if !PSH_OS_WINDOWS
+        i32 enable = 1;
+        psh_discard_value(setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)));
+#endif
+
+        i32 const backlog_count = static_cast<i32>(psh_min_value(backlog, u32{SOMAXCONN}));
+        if (psh_unlikely(
+                (bind(handle, impl::net_sockaddr(address), static_cast<impl::AddressSize>(address->size)) != 0)
+                || (listen(handle, backlog_count) != 0))) {
+            psh_impl_log_net_error("Unable to listen for connections", impl::net_last_error());
+            net_close(listener);
+            return STATUS_FAILED;
+        }
+
+        return STATUS_OK;
+    }
+
+    psh_proc NetStatus net_tcp_accept(Socket const* listener, Socket* connection, NetAddress* peer_address) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(listener);
+            psh_assert_not_null(connection);
+        });
+
+        NetAddress          peer      = {};
+        impl::AddressSize   peer_size = static_cast<impl::AddressSize>(NET_ADDRESS_MAX_SIZE);
+        impl::NativeSocket  handle;
+        for (;;) {
+#if PSH_OS_LINUX
+            handle = accept4(impl::net_native(listener), impl::net_sockaddr(&peer), &peer_size, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+            handle = accept(impl::net_native(listener), impl::net_sockaddr(&peer), &peer_size);
+#endif
+            if (psh_likely(handle != impl::NET_INVALID_SOCKET)) {
+                break;
+            }
+
+            i32 error = impl::net_last_error();
+            if (impl::net_error_interrupted(error)) {
+                continue;
+            }
+
+            // Connections aborted before being accepted are simply skipped.
+            if (impl::net_error_would_block(error) || impl::net_error_closed(error)) {
+                return NET_STATUS_WOULD_BLOCK;
+            }
+
+            psh_impl_log_net_error("Unable to accept a connection", error);
+            return NET_STATUS_FAILED;
+        }
+
+#if !PSH_OS_LINUX
+        // Sockets accepted on Windows inherit the non-blocking mode of the listener, but not
+        // elsewhere.
+        if (psh_unlikely(!impl::net_configure_socket(handle))) {
+            psh_impl_log_net_error("Unable to configure an accepted connection", impl::net_last_error());
+            impl::net_close_native(handle);
+            return NET_STATUS_FAILED;
+        }
+#endif
+
+        connection->handle = static_cast<decltype(connection->handle)>(handle);
+        if (peer_address != nullptr) {
+            peer.size     = static_cast<u32>(peer_size);
+            *peer_address = peer;
+        }
+        return NET_STATUS_OK;
+    }
+
+    psh_proc NetStatus net_tcp_connect(Socket* connection, NetAddress const* address) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(connection);
+            psh_assert_not_null(address);
+        });
+
+        if (psh_unlikely(!impl::net_open_socket(connection, address, SOCK_STREAM, IPPROTO_TCP))) {
+            return NET_STATUS_FAILED;
+        }
+
+        i32 result = connect(impl::net_native(connection), impl::net_sockaddr(address), static_cast<impl::AddressSize>(address->size));
+        if (result == 0) {
+            return NET_STATUS_OK;
+        }
+
+        i32 error = impl::net_last_error();
+#if PSH_OS_WINDOWS
+        bool in_progress = (error == WSAEWOULDBLOCK);
+#else
+        bool in_progress = (error == EINPROGRESS) || (error == EINTR);
+#endif
+        if (psh_likely(in_progress)) {
+            return NET_STATUS_WOULD_BLOCK;
+        }
+
+        psh_impl_log_net_error("Unable to connect", error);
+        net_close(connection);
+        return NET_STATUS_FAILED;
+    }
+
+    psh_proc Status net_tcp_finish_connect(Socket const* connection) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(connection));
+
+        i32               error      = 0;
+        impl::AddressSize error_size = static_cast<impl::AddressSize>(sizeof(error));
+        if (psh_unlikely(
+                getsockopt(impl::net_native(connection), SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &error_size)
+                != 0)) {
+            error = impl::net_last_error();
+        }
+
+        if (psh_unlikely(error != 0)) {
+            psh_impl_log_net_error("Unable to connect", error);
+            return STATUS_FAILED;
+        }
+        return STATUS_OK;
+    }
+
+    psh_proc Status net_tcp_set_no_delay(Socket const* connection, bool no_delay) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(connection));
+
+        i32 value = static_cast<i32>(no_delay);
+        return (setsockopt(impl::net_native(connection), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char const*>(&value), sizeof(value)) == 0);
+    }
+
+    psh_proc Status net_udp_open(Socket* socket, NetAddress const* address) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(socket);
+            psh_assert_not_null(address);
+        });
+
+        if (psh_unlikely(!impl::net_open_socket(socket, address, SOCK_DGRAM, IPPROTO_UDP))) {
+            return STATUS_FAILED;
+        }
+
+        if (psh_unlikely(bind(impl::net_native(socket), impl::net_sockaddr(address), static_cast<impl::AddressSize>(address->size)) != 0)) {
+            psh_impl_log_net_error("Unable to bind a UDP socket", impl::net_last_error());
+            net_close(socket);
+            return STATUS_FAILED;
+        }
+
+        return STATUS_OK;
+    }
+
+    psh_proc void net_close(Socket* socket) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(socket));
+
+        if (impl::net_native(socket) != impl::NET_INVALID_SOCKET) {
+            impl::net_close_native(impl::net_native(socket));
+        }
+        *socket = Socket{};
+    }
+
+    psh_proc Status net_local_address(Socket const* socket, NetAddress* address) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(socket);
+            psh_assert_not_null(address);
+        });
+
+        NetAddress        local      = {};
+        impl::AddressSize local_size = static_cast<impl::AddressSize>(NET_ADDRESS_MAX_SIZE);
+        if (psh_unlikely(getsockname(impl::net_native(socket), impl::net_sockaddr(&local), &local_size) != 0)) {
+            psh_impl_log_net_error("Unable to obtain the address of a socket", impl::net_last_error());
+            return STATUS_FAILED;
+        }
+
+        local.size = static_cast<u32>(local_size);
+        *address   = local;
+        return STATUS_OK;
+    }
+
+    psh_proc NetStatus net_send(Socket const* socket, FatPtr<u8 const> data, usize* sent_count) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(socket);
+            psh_assert_not_null(sent_count);
+        });
+
+        usize size = psh_min_value(data.count, impl::NET_TRANSFER_MAX_SIZE);
+        for (;;) {
+#if PSH_OS_WINDOWS
+            isize result = send(impl::net_native(socket), reinterpret_cast<char const*>(data.buf), static_cast<i32>(size), 0);
+#else
+            isize result = send(impl::net_native(socket), data.buf, size, impl::NET_SEND_FLAGS);
+#endif
+            if (psh_likely(result >= 0)) {
+                *sent_count = static_cast<usize>(result);
+                return NET_STATUS_OK;
+            }
+
+            i32 error = impl::net_last_error();
+            if (!impl::net_error_interrupted(error)) {
+                *sent_count = 0;
+                return impl::net_status_from_error(error);
+            }
+        }
+    }
+
+    psh_proc NetStatus net_receive(Socket const* socket, FatPtr<u8> buf, usize* received_count) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(socket);
+            psh_assert_not_null(received_count);
+            psh_assert_msg(buf.count != 0, "Receiving into an empty buffer can't tell closed connections apart.");
+        });
+
+        usize size = psh_min_value(buf.count, impl::NET_TRANSFER_MAX_SIZE);
+        for (;;) {
+#if PSH_OS_WINDOWS
+            isize result = recv(impl::net_native(socket), reinterpret_cast<char*>(buf.buf), static_cast<i32>(size), 0);
+#else
+            isize result = recv(impl::net_native(socket), buf.buf, size, 0);
+#endif
+            if (psh_likely(result > 0)) {
+                *received_count = static_cast<usize>(result);
+                return NET_STATUS_OK;
+            }
+
+            *received_count = 0;
+            if (result == 0) {
+                return NET_STATUS_CLOSED;
+            }
+
+            i32 error = impl::net_last_error();
+            if (!impl::net_error_interrupted(error)) {
+                return impl::net_status_from_error(error);
+            }
+        }
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Datagrams.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc NetBatchResult net_udp_send_batch(Socket const* socket, FatPtr<NetDatagram const> datagrams) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(socket));
+
+        NetBatchResult result = {};
+
+#if PSH_OS_LINUX
+        mmsghdr messages[impl::NET_DATAGRAM_CHUNK_SIZE];
+        iovec   iovecs[impl::NET_DATAGRAM_CHUNK_SIZE];
+        while (result.count < datagrams.count) {
+            u32 chunk_size = static_cast<u32>(psh_min_value(datagrams.count - result.count, usize{impl::NET_DATAGRAM_CHUNK_SIZE}));
+            for (u32 idx = 0; idx < chunk_size; ++idx) {
+                NetDatagram const* datagram = &datagrams.buf[result.count + idx];
+
+                iovecs[idx]   = iovec{.iov_base = datagram->buf, .iov_len = datagram->count};
+                messages[idx] = mmsghdr{
+                    .msg_hdr = msghdr{
+                        .msg_name       = const_cast<u8*>(datagram->address.storage),
+                        .msg_namelen    = datagram->address.size,
+                        .msg_iov        = &iovecs[idx],
+                        .msg_iovlen     = 1,
+                        .msg_control    = nullptr,
+                        .msg_controllen = 0,
+                        .msg_flags      = 0,
+                    },
+                    .msg_len = 0,
+                };
+            }
+
+            i32 sent = sendmmsg(impl::net_native(socket), messages, chunk_size, impl::NET_SEND_FLAGS);
+            if (psh_unlikely(sent < 0)) {
+                i32 error = impl::net_last_error();
+                if (impl::net_error_interrupted(error)) {
+                    continue;
+                }
+                result.status = impl::net_status_from_error(error);
+                break;
+            }
+
+            result.count += static_cast<u32>(sent);
+            if (static_cast<u32>(sent) < chunk_size) {
+                result.status = NET_STATUS_WOULD_BLOCK;
+                break;
+            }
+        }
+#else
+        while (result.count < datagrams.count) {
+            NetDatagram const* datagram = &datagrams.buf[result.count];
+#    if PSH_OS_WINDOWS
+            i32 sent = sendto(
+                impl::net_native(socket),
+                reinterpret_cast<char const*>(datagram->buf),
+                static_cast<i32>(datagram->count),
+                0,
+                impl::net_sockaddr(&datagram->address),
+                static_cast<impl::AddressSize>(datagram->address.size));
+#    else
+            isize sent = sendto(
+                impl::net_native(socket),
+                datagram->buf,
+                datagram->count,
+                impl::NET_SEND_FLAGS,
+                impl::net_sockaddr(&datagram->address),
+                static_cast<impl::AddressSize>(datagram->address.size));
+#    endif
+            if (psh_unlikely(sent < 0)) {
+                i32 error = impl::net_last_error();
+                if (impl::net_error_interrupted(error)) {
+                    continue;
+                }
+                result.status = impl::net_status_from_error(error);
+                break;
+            }
+            ++result.count;
+        }
+#endif
+
+        if (psh_unlikely(result.status == NET_STATUS_FAILED)) {
+            psh_impl_log_net_error("Unable to send datagrams", impl::net_last_error());
+        }
+        return result;
+    }
+
+    psh_proc NetBatchResult net_udp_receive_batch(Socket const* socket, FatPtr<NetDatagram> datagrams) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(socket));
+
+        NetBatchResult result = {};
+
+#if PSH_OS_LINUX
+        mmsghdr messages[impl::NET_DATAGRAM_CHUNK_SIZE];
+        iovec   iovecs[impl::NET_DATAGRAM_CHUNK_SIZE];
+        while (result.count < datagrams.count) {
+            u32 chunk_size = static_cast<u32>(psh_min_value(datagrams.count - result.count, usize{impl::NET_DATAGRAM_CHUNK_SIZE}));
+            for (u32 idx = 0; idx < chunk_size; ++idx) {
+                NetDatagram* datagram = &datagrams.buf[result.count + idx];
+
+                iovecs[idx]   = iovec{.iov_base = datagram->buf, .iov_len = datagram->capacity};
+                messages[idx] = mmsghdr{
+                    .msg_hdr = msghdr{
+                        .msg_name       = datagram->address.storage,
+                        .msg_namelen    = static_cast<socklen_t>(NET_ADDRESS_MAX_SIZE),
+                        .msg_iov        = &iovecs[idx],
+                        .msg_iovlen     = 1,
+                        .msg_control    = nullptr,
+                        .msg_controllen = 0,
+                        .msg_flags      = 0,
+                    },
+                    .msg_len = 0,
+                };
+            }
+
+            i32 received = recvmmsg(impl::net_native(socket), messages, chunk_size, MSG_DONTWAIT, nullptr);
+            if (received < 0) {
+                i32 error = impl::net_last_error();
+                if (impl::net_error_interrupted(error)) {
+                    continue;
+                }
+                result.status = impl::net_status_from_error(error);
+                break;
+            }
+
+            for (u32 idx = 0; idx < static_cast<u32>(received); ++idx) {
+                NetDatagram* datagram  = &datagrams.buf[result.count + idx];
+                datagram->count        = psh_min_value(static_cast<usize>(messages[idx].msg_len), datagram->capacity);
+                datagram->address.size = messages[idx].msg_hdr.msg_namelen;
+            }
+
+            result.count += static_cast<u32>(received);
+            if (static_cast<u32>(received) < chunk_size) {
+                break;
+            }
+        }
+#else
+        while (result.count < datagrams.count) {
+            NetDatagram*      datagram     = &datagrams.buf[result.count];
+            impl::AddressSize address_size = static_cast<impl::AddressSize>(NET_ADDRESS_MAX_SIZE);
+#    if PSH_OS_WINDOWS
+            i32 received = recvfrom(
+                impl::net_native(socket),
+                reinterpret_cast<char*>(datagram->buf),
+                static_cast<i32>(psh_min_value(datagram->capacity, impl::NET_TRANSFER_MAX_SIZE)),
+                0,
+                impl::net_sockaddr(&datagram->address),
+                &address_size);
+
+            // Truncated datagrams are reported as errors by Windows, though their start is received.
+            if ((received < 0) && (impl::net_last_error() == WSAEMSGSIZE)) {
+                received = static_cast<i32>(psh_min_value(datagram->capacity, impl::NET_TRANSFER_MAX_SIZE));
+            }
+#    else
+            isize received = recvfrom(
+                impl::net_native(socket),
+                datagram->buf,
+                datagram->capacity,
+                0,
+                impl::net_sockaddr(&datagram->address),
+                &address_size);
+#    endif
+            if (received < 0) {
+                i32 error = impl::net_last_error();
+                if (impl::net_error_interrupted(error)) {
+                    continue;
+                }
+                // Windows reports datagrams that couldn't be delivered by a previous send as a reset.
+                result.status = impl::net_status_from_error(error);
+                break;
+            }
+
+            datagram->count        = static_cast<usize>(received);
+            datagram->address.size = static_cast<u32>(address_size);
+            ++result.count;
+        }
+#endif
+
+        // Running out of pending datagrams after receiving some isn't a failure.
+        if ((result.status == NET_STATUS_WOULD_BLOCK) && (result.count != 0)) {
+            result.status = NET_STATUS_OK;
+        }
+        if (psh_unlikely(result.status == NET_STATUS_FAILED)) {
+            psh_impl_log_net_error("Unable to receive datagrams", impl::net_last_error());
+        }
+        return result;
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Event loop.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc Status init_net_poller(NetPoller* poller, Arena* arena, u32 capacity) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(poller);
+            psh_assert_not_null(arena);
+            psh_assert_msg(capacity != 0, "A poller should be able to watch at least one socket.");
+        });
+
+        ArenaCheckpoint arena_checkpoint = make_arena_checkpoint(arena);
+
+        *poller          = NetPoller{};
+        poller->capacity = capacity;
+
+#if PSH_OS_LINUX
+        poller->native_events = reinterpret_cast<u8*>(memory_alloc<epoll_event>(arena, capacity));
+        poller->fd            = epoll_create1(EPOLL_CLOEXEC);
+        poller->backend       = NET_POLLER_BACKEND_EPOLL;
+        bool created          = (poller->fd != -1);
+#elif PSH_OS_APPLE
+        poller->native_events = reinterpret_cast<u8*>(memory_alloc<struct kevent>(arena, capacity));
+        poller->fd            = kqueue();
+        poller->backend       = NET_POLLER_BACKEND_KQUEUE;
+        bool created          = (poller->fd != -1) && (fcntl(poller->fd, F_SETFD, FD_CLOEXEC) != -1);
+#else
+        poller->native_events = reinterpret_cast<u8*>(memory_alloc<WSAPOLLFD>(arena, capacity));
+        poller->user_data     = memory_alloc<void*>(arena, capacity);
+        poller->backend       = NET_POLLER_BACKEND_WSAPOLL;
+        bool created          = (poller->user_data != nullptr);
+#endif
+
+        if (psh_unlikely(!created || (poller->native_events == nullptr))) {
+            psh_impl_log_net_error("Unable to create a poller", impl::net_last_error());
+            destroy_net_poller(poller);
+            arena_checkpoint_restore(arena_checkpoint);
+            return STATUS_FAILED;
+        }
+
+        return STATUS_OK;
+    }
+
+    psh_proc void destroy_net_poller(NetPoller* poller) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(poller));
+
+#if !PSH_OS_WINDOWS
+        if (poller->fd != -1) {
+            close(poller->fd);
+        }
+#endif
+        *poller = NetPoller{};
+    }
+
+#if PSH_OS_LINUX
+    namespace impl {
+        psh_internal Status net_poller_control(NetPoller* poller, i32 operation, Socket const* socket, u32 interest, void* user_data) psh_no_except {
+            u32 events = 0;
+            if ((interest & NET_EVENT_READ) != 0) {
+                events |= EPOLLIN | EPOLLRDHUP;
+            }
+            if ((interest & NET_EVENT_WRITE) != 0) {
+                events |= EPOLLOUT;
+            }
+
+            epoll_event event = {.events = events, .data = {.ptr = user_data}};
+            if (psh_unlikely(epoll_ctl(poller->fd, operation, net_native(socket), &event) != 0)) {
+                psh_impl_log_net_error("Unable to register a socket to the poller", net_last_error());
+                return STATUS_FAILED;
+            }
+            return STATUS_OK;
+        }
+    }  // namespace impl
+#elif PSH_OS_APPLE
+    namespace impl {
+        /// Add or delete the read and write filters of a socket. A filter that isn't registered
+        /// yet can't be deleted, which is ignored.
+        psh_internal Status net_poller_control(NetPoller* poller, Socket const* socket, u32 interest, void* user_data) psh_no_except {
+            struct kevent changes[2];
+            u16 const     read_action  = ((interest & NET_EVENT_READ) != 0) ? (EV_ADD | EV_ENABLE) : EV_DELETE;
+            u16 const     write_action = ((interest & NET_EVENT_WRITE) != 0) ? (EV_ADD | EV_ENABLE) : EV_DELETE;
+            EV_SET(&changes[0], net_native(socket), EVFILT_READ, read_action | EV_RECEIPT, 0, 0, user_data);
+            EV_SET(&changes[1], net_native(socket), EVFILT_WRITE, write_action | EV_RECEIPT, 0, 0, user_data);
+
+            struct kevent receipts[2];
+            i32           receipt_count = kevent(poller->fd, changes, 2, receipts, 2, nullptr);
+            if (psh_unlikely(receipt_count < 0)) {
+                psh_impl_log_net_error("Unable to register a socket to the poller", net_last_error());
+                return STATUS_FAILED;
+            }
+
+            for (i32 idx = 0; idx < receipt_count; ++idx) {
+                i32 error = static_cast<i32>(receipts[idx].data);
+                if (((receipts[idx].flags & EV_ERROR) != 0) && (error != 0) && (error != ENOENT)) {
+                    psh_impl_log_net_error("Unable to register a socket to the poller", error);
+                    return STATUS_FAILED;
+                }
+            }
+            return STATUS_OK;
+        }
+    }  // namespace impl
+#else
+    namespace impl {
+        psh_internal psh_inline i16 net_poll_events(u32 interest) psh_no_except {
+            i16 events = 0;
+            if ((interest & NET_EVENT_READ) != 0) {
+                events |= POLLRDNORM;
+            }
+            if ((interest & NET_EVENT_WRITE) != 0) {
+                events |= POLLWRNORM;
+            }
+            return events;
+        }
+
+        psh_internal u32 net_poller_find(NetPoller const* poller, Socket const* socket) psh_no_except {
+            WSAPOLLFD const* entries = reinterpret_cast<WSAPOLLFD const*>(poller->native_events);
+            for (u32 idx = 0; idx < poller->count; ++idx) {
+                if (entries[idx].fd == net_native(socket)) {
+                    return idx;
+                }
+            }
+            return poller->count;
+        }
+    }  // namespace impl
+#endif
+
+    psh_proc Status net_poller_add(NetPoller* poller, Socket const* socket, u32 interest, void* user_data) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(poller);
+            psh_assert_not_null(socket);
+        });
+
+        if (psh_unlikely(poller->count == poller->capacity)) {
+            psh_log_error_fmt("Unable to register a socket to the poller, which is full (%u sockets).", poller->capacity);
+            return STATUS_FAILED;
+        }
+
+#if PSH_OS_LINUX
+        Status status = impl::net_poller_control(poller, EPOLL_CTL_ADD, socket, interest, user_data);
+#elif PSH_OS_APPLE
+        Status status = impl::net_poller_control(poller, socket, interest, user_data);
+#else
+        WSAPOLLFD* entries              = reinterpret_cast<WSAPOLLFD*>(poller->native_events);
+        entries[poller->count]          = WSAPOLLFD{.fd = impl::net_native(socket), .events = impl::net_poll_events(interest), .revents = 0};
+        poller->user_data[poller->count] = user_data;
+        Status status                   = STATUS_OK;
+#endif
+
+        if (psh_likely(status)) {
+            ++poller->count;
+        }
+        return status;
+    }
+
+    psh_proc Status net_poller_modify(NetPoller* poller, Socket const* socket, u32 interest, void* user_data) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(poller);
+            psh_assert_not_null(socket);
+        });
+
+#if PSH_OS_LINUX
+        return impl::net_poller_control(poller, EPOLL_CTL_MOD, socket, interest, user_data);
+#elif PSH_OS_APPLE
+        return impl::net_poller_control(poller, socket, interest, user_data);
+#else
+        u32 idx = impl::net_poller_find(poller, socket);
+        if (psh_unlikely(idx == poller->count)) {
+            psh_log_error("Unable to modify a socket not registered to the poller.");
+            return STATUS_FAILED;
+        }
+
+        reinterpret_cast<WSAPOLLFD*>(poller->native_events)[idx].events = impl::net_poll_events(interest);
+        poller->user_data[idx]                                            = user_data;
+        return STATUS_OK;
+#endif
+    }
+
+    psh_proc Status net_poller_remove(NetPoller* poller, Socket const* socket) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(poller);
+            psh_assert_not_null(socket);
+        });
+
+#if PSH_OS_LINUX
+        // Kernels before 2.6.9 required a non-null event, even if unused.
+        epoll_event event  = {};
+        Status      status = (epoll_ctl(poller->fd, EPOLL_CTL_DEL, impl::net_native(socket), &event) == 0);
+#elif PSH_OS_APPLE
+        Status status = impl::net_poller_control(poller, socket, 0, nullptr);
+#else
+        // Move the last entry into the place of the removed one.
+        u32    idx    = impl::net_poller_find(poller, socket);
+        Status status = (idx != poller->count);
+        if (psh_likely(status)) {
+            WSAPOLLFD* entries     = reinterpret_cast<WSAPOLLFD*>(poller->native_events);
+            entries[idx]           = entries[poller->count - 1u];
+            poller->user_data[idx] = poller->user_data[poller->count - 1u];
+        }
+#endif
+
+        if (psh_unlikely(!status)) {
+            psh_log_error("Unable to remove a socket from the poller.");
+            return STATUS_FAILED;
+        }
+
+        --poller->count;
+        return STATUS_OK;
+    }
+
+    psh_proc u32 net_poller_wait(NetPoller* poller, FatPtr<NetEvent> events, i32 timeout_ms) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(poller));
+
+        u32 const max_count = static_cast<u32>(psh_min_value(events.count, static_cast<usize>(poller->capacity)));
+        if (max_count == 0) {
+            return 0;
+        }
+
+#if PSH_OS_LINUX
+        epoll_event* native_events = reinterpret_cast<epoll_event*>(poller->native_events);
+        i32          ready_count   = epoll_wait(poller->fd, native_events, static_cast<i32>(max_count), timeout_ms);
+        if (psh_unlikely(ready_count < 0)) {
+            // Being interrupted by a signal counts as a timeout.
+            if (!impl::net_error_interrupted(impl::net_last_error())) {
+                psh_impl_log_net_error("Unable to wait for the poller", impl::net_last_error());
+            }
+            return 0;
+        }
+
+        for (i32 idx = 0; idx < ready_count; ++idx) {
+            u32 native_flags = native_events[idx].events;
+            u32 flags        = 0;
+            if ((native_flags & EPOLLIN) != 0) {
+                flags |= NET_EVENT_READ;
+            }
+            if ((native_flags & EPOLLOUT) != 0) {
+                flags |= NET_EVENT_WRITE;
+            }
+            if ((native_flags & (EPOLLHUP | EPOLLRDHUP)) != 0) {
+                flags |= NET_EVENT_HANG_UP;
+            }
+            if ((native_flags & EPOLLERR) != 0) {
+                flags |= NET_EVENT_ERROR;
+            }
+            events.buf[idx] = NetEvent{.user_data = native_events[idx].data.ptr, .flags = flags};
+        }
+        return static_cast<u32>(ready_count);
+#elif PSH_OS_APPLE
+        timespec  timeout     = {.tv_sec = timeout_ms / 1000, .tv_nsec = (timeout_ms % 1000) * 1'000'000};
+        timespec* timeout_ptr = (timeout_ms < 0) ? nullptr : &timeout;
+
+        struct kevent* native_events = reinterpret_cast<struct kevent*>(poller->native_events);
+        i32            ready_count   = kevent(poller->fd, nullptr, 0, native_events, static_cast<i32>(max_count), timeout_ptr);
+        if (psh_unlikely(ready_count < 0)) {
+            if (!impl::net_error_interrupted(impl::net_last_error())) {
+                psh_impl_log_net_error("Unable to wait for the poller", impl::net_last_error());
+            }
+            return 0;
+        }
+
+        for (i32 idx = 0; idx < ready_count; ++idx) {
+            struct kevent const* native = &native_events[idx];
+
+            u32 flags = (native->filter == EVFILT_READ) ? NET_EVENT_READ : NET_EVENT_WRITE;
+            if ((native->flags & EV_EOF) != 0) {
+                flags |= NET_EVENT_HANG_UP;
+                if (native->fflags != 0) {
+                    flags |= NET_EVENT_ERROR;
+                }
+            }
+            if ((native->flags & EV_ERROR) != 0) {
+                flags |= NET_EVENT_ERROR;
+            }
+            events.buf[idx] = NetEvent{.user_data = native->udata, .flags = flags};
+        }
+        return static_cast<u32>(ready_count);
+#else
+        // WSAPoll rejects empty sets of sockets.
+        if (poller->count == 0) {
+            if (timeout_ms != 0) {
+                Sleep((timeout_ms < 0) ? INFINITE : static_cast<DWORD>(timeout_ms));
+            }
+            return 0;
+        }
+
+        WSAPOLLFD* entries     = reinterpret_cast<WSAPOLLFD*>(poller->native_events);
+        i32        ready_count = WSAPoll(entries, poller->count, timeout_ms);
+        if (psh_unlikely(ready_count < 0)) {
+            psh_impl_log_net_error("Unable to wait for the poller", impl::net_last_error());
+            return 0;
+        }
+
+        u32 event_count = 0;
+        for (u32 idx = 0; (idx < poller->count) && (event_count < max_count); ++idx) {
+            i16 native_flags = entries[idx].revents;
+            if (native_flags == 0) {
+                continue;
+            }
+
+            u32 flags = 0;
+            if ((native_flags & POLLRDNORM) != 0) {
+                flags |= NET_EVENT_READ;
+            }
+            if ((native_flags & POLLWRNORM) != 0) {
+                flags |= NET_EVENT_WRITE;
+            }
+            if ((native_flags & POLLHUP) != 0) {
+                flags |= NET_EVENT_HANG_UP;
+            }
+            if ((native_flags & (POLLERR | POLLNVAL)) != 0) {
+                flags |= NET_EVENT_ERROR;
+            }
+            events.buf[event_count++] = NetEvent{.user_data = poller->user_data[idx], .flags = flags};
+        }
+        return event_count;
+#endif
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Connection buffers.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc Status init_net_buffer(NetBuffer* buffer, Pool* pool) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(buffer);
+            psh_assert_not_null(pool);
+        });
+
+        // The contents are always written by a receive before being read.
+        u8* block = pool_alloc_block_uninit(pool);
+        if (psh_unlikely(block == nullptr)) {
+            return STATUS_FAILED;
+        }
+
+        *buffer = NetBuffer{.buf = block, .capacity = pool->block_size};
+        return STATUS_OK;
+    }
+
+    psh_proc void destroy_net_buffer(NetBuffer* buffer, Pool* pool) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(buffer);
+            psh_assert_not_null(pool);
+        });
+
+        pool_free_block(pool, buffer->buf);
+        *buffer = NetBuffer{};
+    }
+
+    psh_proc NetStatus net_buffer_receive(NetBuffer* buffer, Socket const* socket) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(buffer);
+            psh_assert_not_null(socket);
+        });
+
+        // Make room by moving the unconsumed bytes to the start of the block, only once the end of
+        // the block is reached, so that most receives don't move any memory.
+        if (buffer->end == buffer->capacity) {
+            if (buffer->begin == 0) {
+                return NET_STATUS_BUFFER_FULL;
+            }
+
+            usize pending_count = buffer->end - buffer->begin;
+            memory_move(buffer->buf, buffer->buf + buffer->begin, pending_count);
+            buffer->begin = 0;
+            buffer->end   = pending_count;
+        }
+
+        usize     received_count = 0;
+        NetStatus status         = net_receive(socket, FatPtr<u8>{buffer->buf + buffer->end, buffer->capacity - buffer->end}, &received_count);
+        buffer->end             += received_count;
+        return status;
+    }
+
+    psh_proc bool net_buffer_next_line(NetBuffer* buffer, String* line) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(buffer);
+            psh_assert_not_null(line);
+        });
+
+        String contents  = net_buffer_contents(buffer);
+        isize  delimiter = string_find_char(contents, '\n');
+        if (delimiter == -1) {
+            return false;
+        }
+
+        usize line_count = static_cast<usize>(delimiter);
+        if ((line_count != 0) && (contents.buf[line_count - 1u] == '\r')) {
+            --line_count;
+        }
+
+        *line = String{contents.buf, line_count};
+        net_buffer_consume(buffer, static_cast<usize>(delimiter) + 1u);
+        return true;
+    }
+}  // namespace psh
@@ -0,0 +1,204 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+///
+/// Description: Implementation of the profiling zones and the Chrome trace export.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include "psh_profile.hpp"
+
+#include "psh_atomic.hpp"
+#include "psh_debug.hpp"
+#include "psh_memory.hpp"
+#include "psh_streams.hpp"
+#include "psh_string.hpp"
+
+namespace psh {
+    namespace impl {
+        /// Singly linked list of the buffers of all registered threads.
+        psh_global Atomic<ProfileThreadBuffer*> profile_thread_list = {};
+
+        psh_global Atomic<u32> profile_thread_count = {};
+
+        psh_internal thread_local ProfileThreadBuffer* profile_current_thread = nullptr;
+
+        psh_proc void profile_record(cstring name, u64 begin, u64 end) psh_no_except {
+            ProfileThreadBuffer* buffer = profile_current_thread;
+            if (psh_unlikely(buffer == nullptr)) {
+                return;
+            }
+
+            ProfileEvent* event = &buffer->events[buffer->count & buffer->mask];
+            event->name         = name;
+            event->begin        = begin;
+            event->end          = end;
+            ++buffer->count;
+        }
+
+        psh_internal Status profile_append_json_string(StringBuilder* builder, cstring str) psh_no_except {
+            Status status = string_builder_append_char(builder, '"');
+            for (cstring c = str; (*c != 0) && status; ++c) {
+                if ((*c == '"') || (*c == '\\')) {
+                    status = string_builder_append_char(builder, '\\') && string_builder_append_char(builder, *c);
+                } else if (static_cast<u8>(*c) < 0x20) {
+                    status = string_builder_append_fmt(builder, "\\u%04x", static_cast<u32>(*c));
+                } else {
+                    status = string_builder_append_char(builder, *c);
+                }
+            }
+            return status && string_builder_append_char(builder, '"');
+        }
+
+        /// Index of the oldest event still kept by the ring buffer.
+        psh_internal psh_inline u64 profile_first_event(ProfileThreadBuffer const* buffer) psh_no_except {
+            u64 capacity = static_cast<u64>(buffer->mask) + 1u;
+            return (buffer->count > capacity) ? (buffer->count - capacity) : 0;
+        }
+    }  // namespace impl
+
+    psh_proc Status profile_register_thread(Arena* arena, u32 event_capacity, cstring thread_name) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(arena));
+        psh_validate_usage({
+            psh_assert_fmt(psh_is_pow_of_two(event_capacity), "Event capacity (%u) should be a power of two.", event_capacity);
+            psh_assert_msg(impl::profile_current_thread == nullptr, "The calling thread is already registered with the profiler.");
+        });
+
+        u32 thread_id = atomic_fetch_add(&impl::profile_thread_count, 1u, MemoryOrder::RELAXED);
+
+        // Take over the buffer of a thread that unregistered, if any has enough capacity.
+        ProfileThreadBuffer* head = atomic_load(&impl::profile_thread_list, MemoryOrder::ACQUIRE);
+        for (ProfileThreadBuffer* buffer = head; buffer != nullptr; buffer = buffer->next) {
+            u32 released = 1;
+            if ((buffer->mask >= event_capacity - 1u)
+                && atomic_compare_exchange(&buffer->released, &released, 0u, MemoryOrder::ACQUIRE)) {
+                buffer->count       = 0;
+                buffer->thread_id   = thread_id;
+                buffer->thread_name = thread_name;
+
+                impl::profile_current_thread = buffer;
+                return STATUS_OK;
+            }
+        }
+
+        ProfileThreadBuffer* buffer = memory_alloc<ProfileThreadBuffer>(arena, 1);
+        ProfileEvent*        events = memory_alloc_uninit<ProfileEvent>(arena, event_capacity);
+        if (psh_unlikely((buffer == nullptr) || (events == nullptr))) {
+            return STATUS_FAILED;
+        }
+
+        buffer->events      = events;
+        buffer->count       = 0;
+        buffer->mask        = event_capacity - 1u;
+        buffer->thread_id   = thread_id;
+        buffer->thread_name = thread_name;
+
+        do {
+            buffer->next = head;
+        } while (!atomic_compare_exchange(&impl::profile_thread_list, &head, buffer, MemoryOrder::RELEASE));
+
+        impl::profile_current_thread = buffer;
+        return STATUS_OK;
+    }
+
+    psh_proc void profile_unregister_thread() psh_no_except {
+        ProfileThreadBuffer* buffer = impl::profile_current_thread;
+        if (buffer != nullptr) {
+            impl::profile_current_thread = nullptr;
+            atomic_store(&buffer->released, 1u, MemoryOrder::RELEASE);
+        }
+    }
+
+    psh_proc void profile_clear_thread() psh_no_except {
+        if (impl::profile_current_thread != nullptr) {
+            impl::profile_current_thread->count = 0;
+        }
+    }
+
+    psh_proc ProfileThreadBuffer* profile_thread_buffer() psh_no_except {
+        return impl::profile_current_thread;
+    }
+
+    psh_proc Status profile_write_chrome_trace(Arena* scratch, cstring path) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(scratch);
+            psh_assert_not_null(path);
+        });
+
+        ArenaCheckpoint checkpoint = make_arena_checkpoint(scratch);
+        psh_defer(arena_checkpoint_restore(checkpoint));
+
+        ProfileThreadBuffer* threads = atomic_load(&impl::profile_thread_list, MemoryOrder::ACQUIRE);
+
+        // Timestamps are written relative to the earliest event, keeping their precision as doubles.
+        u64 origin = ~u64{0};
+        for (ProfileThreadBuffer const* buffer = threads; buffer != nullptr; buffer = buffer->next) {
+            for (u64 idx = impl::profile_first_event(buffer); idx < buffer->count; ++idx) {
+                origin = psh_min_value(origin, buffer->events[idx & buffer->mask].begin);
+            }
+        }
+
+        FileWriter writer;
+        FileStatus file_status = open_file_writer(&writer, scratch, path);
+        if (psh_unlikely(file_status != FILE_STATUS_OK)) {
+            psh_log_error_fmt("Unable to open the trace file %s: %s.", path, file_status_to_string(file_status).buf);
+            return STATUS_FAILED;
+        }
+
+        f64           us_per_tick = 1e6 / static_cast<f64>(cpu_timestamp_frequency());
+        StringBuilder builder     = make_string_builder(scratch, 256);
+        Status        status      = file_writer_write(&writer, psh_comptime_make_string("{\"traceEvents\":["));
+        cstring       separator   = "\n";
+
+        for (ProfileThreadBuffer const* buffer = threads; (buffer != nullptr) && status; buffer = buffer->next) {
+            if (buffer->thread_name != nullptr) {
+                string_builder_clear(&builder);
+                status = string_builder_append_fmt(&builder, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", separator, buffer->thread_id)
+                         && impl::profile_append_json_string(&builder, buffer->thread_name)
+                         && string_builder_append(&builder, psh_comptime_make_string("}}"))
+                         && file_writer_write(&writer, string_builder_to_string(&builder));
+                separator = ",\n";
+            }
+
+            for (u64 idx = impl::profile_first_event(buffer); (idx < buffer->count) && status; ++idx) {
+                ProfileEvent const* event = &buffer->events[idx & buffer->mask];
+
+                string_builder_clear(&builder);
+                status = string_builder_append_fmt(&builder, "%s{\"name\":", separator)
+                         && impl::profile_append_json_string(&builder, event->name)
+                         && string_builder_append_fmt(&builder, ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":", buffer->thread_id)
+                         && string_builder_append_f64(&builder, static_cast<f64>(event->begin - origin) * us_per_tick, 3)
+                         && string_builder_append(&builder, psh_comptime_make_string(",\"dur\":"))
+                         && string_builder_append_f64(&builder, static_cast<f64>(event->end - event->begin) * us_per_tick, 3)
+                         && string_builder_append_char(&builder, '}')
+                         && file_writer_write(&writer, string_builder_to_string(&builder));
+                separator = ",\n";
+            }
+        }
+
+        status = status && file_writer_write(&writer, psh_comptime_make_string("\n],\"displayTimeUnit\":\"ns\"}\n"));
+        status = close_file_writer(&writer) && status;
+
+        if (psh_unlikely(!status)) {
+            psh_log_error_fmt("Failed to write the trace file %s.", path);
+        }
+        return status;
+    }
+}  // namespace psh
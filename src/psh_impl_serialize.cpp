@@ -0,0 +1,370 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+///
+/// Description: Implementation of the serialization module.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include "psh_serialize.hpp"
+
+#include <string.h>
+#include "psh_core.hpp"
+#include "psh_debug.hpp"
+#include "psh_platform.hpp"
+
+namespace psh {
+    namespace impl {
+        psh_internal constexpr u8 SERIAL_ZERO_PADDING[SERIAL_SECTION_ALIGNMENT] = {};
+
+        /// Checksum of the contents of a section made of two parts.
+        psh_internal u64 serial_checksum(FatPtr<u8 const> first_part, FatPtr<u8 const> second_part) psh_no_except {
+            u64 first_hash = hash_bytes(first_part.buf, first_part.count);
+            return hash_bytes(second_part.buf, second_part.count, first_hash);
+        }
+
+        psh_internal Status serial_write_padding(FileWriter* file_writer, usize size_bytes) psh_no_except {
+            while (size_bytes != 0) {
+                usize chunk_size = psh_min_value(size_bytes, SERIAL_SECTION_ALIGNMENT);
+                if (psh_unlikely(!file_writer_write(file_writer, FatPtr<u8 const>{SERIAL_ZERO_PADDING, chunk_size}))) {
+                    return STATUS_FAILED;
+                }
+                size_bytes -= chunk_size;
+            }
+            return STATUS_OK;
+        }
+
+        /// Split the contents of a section into the parts covered by its checksum.
+        psh_internal void serial_section_parts(
+            SerialFile const*    file,
+            SerialSection const* section,
+            FatPtr<u8 const>*    first_part,
+            FatPtr<u8 const>*    second_part) psh_no_except {
+            u8 const* contents = file->content.buf + section->offset;
+            usize     size     = static_cast<usize>(section->size);
+
+            if (section->kind == SERIAL_SECTION_KIND_HASH_MAP) {
+                usize slots_size = static_cast<usize>(section->capacity * section->element_size);
+                usize ctrl_start = static_cast<usize>(align_forward(slots_size, static_cast<u32>(HASH_MAP_GROUP_WIDTH)));
+                *first_part      = FatPtr<u8 const>{contents, slots_size};
+                *second_part     = FatPtr<u8 const>{contents + ctrl_start, size - ctrl_start};
+            } else {
+                *first_part  = FatPtr<u8 const>{contents, size};
+                *second_part = FatPtr<u8 const>{nullptr, 0};
+            }
+        }
+
+        /// Check that a directory entry describes contents lying within the file.
+        psh_internal bool serial_section_is_valid(SerialSection const* section, u64 file_size) psh_no_except {
+            if ((memchr(section->name, 0, SERIAL_SECTION_NAME_MAX_SIZE) == nullptr)
+                || ((section->offset % SERIAL_SECTION_ALIGNMENT) != 0)
+                || (section->offset > file_size)
+                || (section->size > file_size - section->offset)) {
+                return false;
+            }
+
+            u64 size = section->size;
+            switch (section->kind) {
+                case SERIAL_SECTION_KIND_ARRAY: {
+                    return (section->element_size != 0) && (section->count == section->capacity)
+                           && (section->count <= size / section->element_size) && (section->count * section->element_size == size);
+                }
+                case SERIAL_SECTION_KIND_HASH_MAP: {
+                    u64 capacity = section->capacity;
+                    if ((section->element_size == 0) || (section->count > capacity) || (capacity > size)
+                        || ((capacity != 0) && (!psh_is_pow_of_two(capacity) || (capacity < HASH_MAP_GROUP_WIDTH)))) {
+                        return false;
+                    }
+                    u64 slots_size = capacity * section->element_size;
+                    return (capacity <= size / section->element_size)
+                           && (align_forward(static_cast<uptr>(slots_size), static_cast<u32>(HASH_MAP_GROUP_WIDTH)) + capacity == size);
+                }
+                case SERIAL_SECTION_KIND_ARENA: {
+                    return (section->element_size == 1) && (section->count == size) && (section->capacity == size);
+                }
+                default: return false;
+            }
+        }
+
+        psh_proc void serial_writer_add_section(
+            SerialWriter*     writer,
+            String            name,
+            SerialSectionKind kind,
+            usize             element_size,
+            usize             count,
+            usize             capacity,
+            FatPtr<u8 const>  first_part,
+            FatPtr<u8 const>  second_part,
+            usize             second_part_alignment) psh_no_except {
+            psh_validate_usage({
+                psh_assert_not_null(writer);
+                psh_assert_fmt(
+                    (name.count != 0) && (name.count < SERIAL_SECTION_NAME_MAX_SIZE),
+                    "Section names should have between 1 and %zu characters.",
+                    SERIAL_SECTION_NAME_MAX_SIZE - 1u);
+                for (impl::SerialPendingSection const& pending : writer->sections) {
+                    psh_assert_msg(!string_equal(make_string(pending.entry.name), name), "Section name already in use.");
+                }
+            });
+
+            usize second_part_offset = static_cast<usize>(align_forward(first_part.count, static_cast<u32>(second_part_alignment)));
+            usize size               = (second_part.count != 0) ? (second_part_offset + second_part.count) : first_part.count;
+
+            SerialPendingSection pending = {
+                .entry =
+                    SerialSection{
+                        .name         = {},
+                        .kind         = kind,
+                        .element_size = static_cast<u32>(element_size),
+                        .count        = count,
+                        .capacity     = capacity,
+                        .offset       = writer->contents_size,
+                        .size         = size,
+                        .checksum     = serial_checksum(first_part, second_part),
+                    },
+                .parts              = {first_part, second_part},
+                .second_part_offset = second_part_offset,
+            };
+            memory_copy(reinterpret_cast<u8*>(pending.entry.name), reinterpret_cast<u8 const*>(name.buf), name.count);
+
+            if (psh_unlikely(!dynamic_array_push(&writer->sections, pending))) {
+                psh_log_error_fmt("Unable to add the serialized section %.*s, out of memory.", static_cast<i32>(name.count), name.buf);
+                return;
+            }
+            writer->contents_size = align_forward(writer->contents_size + size, static_cast<u32>(SERIAL_SECTION_ALIGNMENT));
+        }
+    }  // namespace impl
+
+    // -------------------------------------------------------------------------------------------------
+    // Writing serialized files.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc void init_serial_writer(SerialWriter* writer, Arena* arena) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(writer));
+
+        *writer = SerialWriter{
+            .sections      = make_dynamic_array<impl::SerialPendingSection>(arena),
+            .contents_size = 0,
+        };
+    }
+
+    psh_proc void serial_writer_add_arena(SerialWriter* writer, String name, Arena const* arena) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(arena);
+            psh_assert_msg(arena->chain_block == nullptr, "Chained arenas beyond their first block can't be snapshotted.");
+        });
+
+        FatPtr<u8 const> memory = {arena->buf, arena->offset};
+        impl::serial_writer_add_section(writer, name, SERIAL_SECTION_KIND_ARENA, 1, arena->offset, arena->offset, memory, {}, 1);
+    }
+
+    psh_proc SerialStatus write_serial_file(SerialWriter const* writer, Arena* arena, cstring path) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(writer);
+            psh_assert_not_null(path);
+        });
+
+        ArenaCheckpoint arena_checkpoint = make_arena_checkpoint(arena);
+
+        // The contents follow the directory, their offsets being relative to the end of it.
+        usize section_count  = writer->sections.count;
+        usize directory_size = section_count * sizeof(SerialSection);
+        u64   contents_start = align_forward(sizeof(SerialHeader) + directory_size, static_cast<u32>(SERIAL_SECTION_ALIGNMENT));
+
+        SerialSection* directory = memory_alloc_uninit<SerialSection>(arena, section_count);
+        if (psh_unlikely((section_count != 0) && (directory == nullptr))) {
+            return SERIAL_STATUS_FAILED_TO_WRITE;
+        }
+        for (usize idx = 0; idx < section_count; ++idx) {
+            directory[idx] = writer->sections.buf[idx].entry;
+            directory[idx].offset += contents_start;
+        }
+
+        SerialHeader header = {
+            .magic              = SERIAL_MAGIC,
+            .version            = SERIAL_VERSION,
+            .section_count      = static_cast<u32>(section_count),
+            .section_size       = static_cast<u32>(sizeof(SerialSection)),
+            .file_size          = contents_start + writer->contents_size,
+            .directory_checksum = hash_bytes(reinterpret_cast<u8 const*>(directory), directory_size),
+        };
+
+        FileWriter file_writer;
+        if (psh_unlikely(open_file_writer(&file_writer, arena, path) != FILE_STATUS_OK)) {
+            arena_checkpoint_restore(arena_checkpoint);
+            return SERIAL_STATUS_FAILED_TO_OPEN;
+        }
+
+        Status status = file_writer_write(&file_writer, FatPtr<u8 const>{reinterpret_cast<u8 const*>(&header), sizeof(header)});
+        status        = status && file_writer_write(&file_writer, FatPtr<u8 const>{reinterpret_cast<u8 const*>(directory), directory_size});
+        status        = status && impl::serial_write_padding(&file_writer, contents_start - sizeof(header) - directory_size);
+
+        u64 position = contents_start;
+        for (usize idx = 0; status && (idx < section_count); ++idx) {
+            impl::SerialPendingSection const* pending = &writer->sections.buf[idx];
+
+            status = impl::serial_write_padding(&file_writer, directory[idx].offset - position);
+            status = status && file_writer_write(&file_writer, pending->parts[0]);
+            if (status && (pending->parts[1].count != 0)) {
+                status = impl::serial_write_padding(&file_writer, pending->second_part_offset - pending->parts[0].count);
+                status = status && file_writer_write(&file_writer, pending->parts[1]);
+            }
+            position = directory[idx].offset + directory[idx].size;
+        }
+        status = status && impl::serial_write_padding(&file_writer, header.file_size - position);
+        status = close_file_writer(&file_writer) && status;
+
+        arena_checkpoint_restore(arena_checkpoint);
+
+        if (psh_unlikely(!status)) {
+            psh_log_error_fmt("Unable to write the serialized file %s.", path);
+            return SERIAL_STATUS_FAILED_TO_WRITE;
+        }
+        return SERIAL_STATUS_OK;
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Loading serialized files.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc SerialStatus open_serial_file(SerialFile* file, cstring path, u32 flags) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(file);
+            psh_assert_not_null(path);
+        });
+
+        u32           hints  = ((flags & SERIAL_OPEN_FLAG_WILL_NEED) != 0) ? MAP_FILE_HINT_WILL_NEED : MAP_FILE_HINT_RANDOM;
+        FileMapResult mapped = map_file(path, hints);
+        if (psh_unlikely(mapped.status != FILE_STATUS_OK)) {
+            return SERIAL_STATUS_FAILED_TO_OPEN;
+        }
+
+        // Mapped files start at a page boundary, so the header and directory are suitably aligned.
+        FatPtr<u8 const>    content = mapped.content;
+        SerialHeader const* header  = reinterpret_cast<SerialHeader const*>(content.buf);
+
+        bool valid = (content.count >= sizeof(SerialHeader))
+                     && (header->magic == SERIAL_MAGIC)
+                     && (header->version == SERIAL_VERSION)
+                     && (header->section_size == sizeof(SerialSection))
+                     && (header->file_size == content.count)
+                     && (header->section_count <= (content.count - sizeof(SerialHeader)) / sizeof(SerialSection));
+
+        SerialSection const* sections = reinterpret_cast<SerialSection const*>(content.buf + sizeof(SerialHeader));
+        if (valid) {
+            usize directory_size = header->section_count * sizeof(SerialSection);
+            valid                = (hash_bytes(reinterpret_cast<u8 const*>(sections), directory_size) == header->directory_checksum);
+        }
+        for (u32 idx = 0; valid && (idx < header->section_count); ++idx) {
+            valid = impl::serial_section_is_valid(&sections[idx], content.count);
+        }
+
+        if (psh_unlikely(!valid)) {
+            psh_log_error_fmt("The file %s isn't a valid serialized file.", path);
+            unmap_file(content);
+            return SERIAL_STATUS_INVALID_FORMAT;
+        }
+
+        *file = SerialFile{
+            .content  = content,
+            .header   = header,
+            .sections = sections,
+        };
+
+        if ((flags & SERIAL_OPEN_FLAG_VERIFY_CONTENTS) != 0) {
+            for (u32 idx = 0; idx < header->section_count; ++idx) {
+                if (psh_unlikely(!serial_file_verify_section(file, &sections[idx]))) {
+                    psh_log_error_fmt("The section %s of the serialized file %s is corrupted.", sections[idx].name, path);
+                    close_serial_file(file);
+                    return SERIAL_STATUS_CORRUPTED;
+                }
+            }
+        }
+
+        return SERIAL_STATUS_OK;
+    }
+
+    psh_proc void close_serial_file(SerialFile* file) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(file));
+
+        unmap_file(file->content);
+        *file = SerialFile{};
+    }
+
+    psh_proc SerialSection const* serial_file_find_section(SerialFile const* file, String name) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(file));
+
+        u32 section_count = (file->header != nullptr) ? file->header->section_count : 0;
+        for (u32 idx = 0; idx < section_count; ++idx) {
+            SerialSection const* section = &file->sections[idx];
+            if (string_equal(make_string(section->name), name)) {
+                return section;
+            }
+        }
+        return nullptr;
+    }
+
+    psh_proc Status serial_file_verify_section(SerialFile const* file, SerialSection const* section) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(file);
+            psh_assert_not_null(section);
+        });
+
+        FatPtr<u8 const> first_part;
+        FatPtr<u8 const> second_part;
+        impl::serial_section_parts(file, section, &first_part, &second_part);
+        return (impl::serial_checksum(first_part, second_part) == section->checksum);
+    }
+
+    psh_proc SerialSection const* impl::serial_file_find_section_of(
+        SerialFile const* file,
+        String            name,
+        SerialSectionKind kind,
+        usize             element_size) psh_no_except {
+        SerialSection const* section = serial_file_find_section(file, name);
+        if (psh_unlikely(section == nullptr)) {
+            psh_log_error_fmt("The serialized file has no section named %.*s.", static_cast<i32>(name.count), name.buf);
+            return nullptr;
+        }
+        if (psh_unlikely((section->kind != kind) || (section->element_size != element_size))) {
+            psh_log_error_fmt(
+                "The serialized section %s has kind %u and element size %u, but kind %u and element size %zu were expected.",
+                section->name,
+                section->kind,
+                section->element_size,
+                static_cast<u32>(kind),
+                element_size);
+            return nullptr;
+        }
+        return section;
+    }
+
+    psh_proc Status serial_file_get_arena(SerialFile const* file, String name, FatPtr<u8 const>* memory) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(memory));
+
+        SerialSection const* section = impl::serial_file_find_section_of(file, name, SERIAL_SECTION_KIND_ARENA, 1);
+        if (psh_unlikely(section == nullptr)) {
+            return STATUS_FAILED;
+        }
+
+        *memory = FatPtr<u8 const>{file->content.buf + section->offset, static_cast<usize>(section->size)};
+        return STATUS_OK;
+    }
+}  // namespace psh
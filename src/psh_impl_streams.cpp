@@ -24,7 +24,10 @@
 
 #include "psh_streams.hpp"
 
+#include <errno.h>
 #include <stdio.h>
+#include <string.h>
+#include "psh_atomic.hpp"
 #include "psh_core.hpp"
 #include "psh_platform.hpp"
 
@@ -32,11 +35,22 @@
 #    include <Windows.h>
 #    define PSH_IMPL_PATH_MAX_CHAR_COUNT MAX_PATH
 #elif PSH_OS_UNIX
+#    include <fcntl.h>
 #    include <limits.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
 #    include <unistd.h>
 #    define PSH_IMPL_PATH_MAX_CHAR_COUNT PATH_MAX
 #endif
 
+#if PSH_OS_LINUX && __has_include(<linux/io_uring.h>)
+#    define PSH_IMPL_ASYNC_IO_URING 1
+#    include <linux/io_uring.h>
+#    include <sys/syscall.h>
+#else
+#    define PSH_IMPL_ASYNC_IO_URING 0
+#endif
+
 // @TODO(luiz): Substitute the perror calls with psh_log_fmt taking the error strings via a
 //       thread safe alternative to strerror.
 
@@ -58,6 +72,439 @@ namespace psh::impl {
                || (flag == OPEN_FILE_FLAG_READ_BIN_EXTENDED)
                || (flag == OPEN_FILE_FLAG_WRITE_EXTENDED);
     }
+
+#if PSH_OS_WINDOWS
+    using NativeFile = HANDLE;
+#elif PSH_OS_UNIX
+    using NativeFile = i32;
+#endif
+
+    /// Read at most size bytes from a file into a buffer.
+    ///
+    /// Return: The number of bytes read, zero at the end of the file, or -1 if the read failed.
+    psh_internal isize native_file_read(NativeFile file, u8* buf, usize size) psh_no_except {
+#if PSH_OS_WINDOWS
+        DWORD read_size  = static_cast<DWORD>(psh_min_value(size, usize{0x80000000}));
+        DWORD bytes_read = 0;
+        if (psh_unlikely(!ReadFile(file, buf, read_size, &bytes_read, nullptr))) {
+            return -1;
+        }
+        return static_cast<isize>(bytes_read);
+#elif PSH_OS_UNIX
+        for (;;) {
+            isize bytes_read = read(file, buf, size);
+            if (psh_likely(bytes_read != -1) || (errno != EINTR)) {
+                return bytes_read;
+            }
+        }
+#endif
+    }
+
+    /// Write the whole contents of a buffer to a file, retrying on partial writes.
+    psh_internal bool native_file_write_all(NativeFile file, u8 const* buf, usize size) psh_no_except {
+        while (size > 0) {
+#if PSH_OS_WINDOWS
+            DWORD write_size    = static_cast<DWORD>(psh_min_value(size, usize{0x80000000}));
+            DWORD bytes_written = 0;
+            if (psh_unlikely(!WriteFile(file, buf, write_size, &bytes_written, nullptr))) {
+                return false;
+            }
+            usize written = static_cast<usize>(bytes_written);
+#elif PSH_OS_UNIX
+            isize bytes_written = write(file, buf, size);
+            if (psh_unlikely(bytes_written == -1)) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            usize written = static_cast<usize>(bytes_written);
+#endif
+            buf  += written;
+            size -= written;
+        }
+        return true;
+    }
+
+    /// Read more data into the reader buffer, moving the data not yet consumed to its start.
+    ///
+    /// Return: Whether any data was read.
+    psh_internal bool file_reader_refill(FileReader* reader) psh_no_except {
+        usize pending = reader->end - reader->begin;
+        if (reader->begin != 0) {
+            memory_move(reader->buf, reader->buf + reader->begin, pending);
+            reader->begin = 0;
+            reader->end   = pending;
+        }
+
+        isize bytes_read = native_file_read(reader->handle, reader->buf + reader->end, reader->capacity - reader->end);
+        if (psh_unlikely(bytes_read < 0)) {
+            psh_log_error("Unable to read from the file stream.");
+            reader->status = FILE_STATUS_FAILED_TO_READ;
+            return false;
+        }
+        if (bytes_read == 0) {
+            reader->end_of_file = true;
+            return false;
+        }
+
+        reader->end += static_cast<usize>(bytes_read);
+        return true;
+    }
+
+    /// Write a number of bytes from the start of the writer buffer.
+    psh_internal Status file_writer_write_buffer(FileWriter* writer, usize size) psh_no_except {
+        if (psh_unlikely(!native_file_write_all(writer->handle, writer->buf, size))) {
+            psh_log_error("Unable to write to the file stream.");
+            writer->status = FILE_STATUS_FAILED_TO_WRITE;
+            return STATUS_FAILED;
+        }
+        return STATUS_OK;
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Asynchronous I/O book-keeping.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_internal u32 async_io_acquire_slot(AsyncIo* io) psh_no_except {
+        u32 slot_idx = io->free_head;
+        if (psh_likely(slot_idx != ASYNC_IO_INVALID_SLOT)) {
+            io->free_head = io->slots[slot_idx].next;
+        }
+        return slot_idx;
+    }
+
+    psh_internal void async_io_release_slot(AsyncIo* io, u32 slot_idx) psh_no_except {
+        io->slots[slot_idx].next = io->free_head;
+        io->free_head            = slot_idx;
+    }
+
+    /// Append a finished operation to the list of completions waiting to be harvested.
+    psh_internal void async_io_push_completed(AsyncIo* io, u32 slot_idx, isize result) psh_no_except {
+        AsyncIoSlot* slot = &io->slots[slot_idx];
+        slot->result      = result;
+        slot->next        = ASYNC_IO_INVALID_SLOT;
+
+        if (io->completed_tail == ASYNC_IO_INVALID_SLOT) {
+            io->completed_head = slot_idx;
+        } else {
+            io->slots[io->completed_tail].next = slot_idx;
+        }
+        io->completed_tail = slot_idx;
+    }
+
+#if PSH_OS_UNIX
+    /// Run the operation of a slot synchronously, used when no asynchronous backend is available.
+    psh_internal isize async_io_run_sync(AsyncIoSlot const* slot) psh_no_except {
+        usize transferred = 0;
+        while (transferred < slot->size) {
+            off_t offset = static_cast<off_t>(slot->offset + transferred);
+            isize result = (slot->operation == ASYNC_IO_OPERATION_READ)
+                               ? pread(slot->file.handle, slot->buf + transferred, slot->size - transferred, offset)
+                               : pwrite(slot->file.handle, slot->buf + transferred, slot->size - transferred, offset);
+            if (result == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -1;
+            }
+            if (result == 0) {
+                break;  // End of file.
+            }
+            transferred += static_cast<usize>(result);
+        }
+        return static_cast<isize>(transferred);
+    }
+#endif
+
+#if PSH_IMPL_ASYNC_IO_URING
+    // -------------------------------------------------------------------------------------------------
+    // io_uring backend.
+    //
+    // The library talks to the kernel via the raw system calls, sharing with it a submission and a
+    // completion ring. Since at most one operation per slot is in flight, neither ring can overflow.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_internal bool io_uring_init(IoUring* ring, u32 entries) psh_no_except {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+
+        i32 fd = static_cast<i32>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return false;
+        }
+
+        // Plain read and write operations require Linux 5.6, which also introduced this feature.
+        if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+            close(fd);
+            return false;
+        }
+
+        usize sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+        usize cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        usize sqes_size    = params.sq_entries * sizeof(io_uring_sqe);
+
+        bool single_mmap = ((params.features & IORING_FEAT_SINGLE_MMAP) != 0);
+        if (single_mmap) {
+            sq_ring_size = psh_max_value(sq_ring_size, cq_ring_size);
+            cq_ring_size = sq_ring_size;
+        }
+
+        void* sq_ring = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sq_ring == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+
+        void* cq_ring = sq_ring;
+        if (!single_mmap) {
+            cq_ring = mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cq_ring == MAP_FAILED) {
+                munmap(sq_ring, sq_ring_size);
+                close(fd);
+                return false;
+            }
+        }
+
+        void* sqes = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            if (!single_mmap) {
+                munmap(cq_ring, cq_ring_size);
+            }
+            munmap(sq_ring, sq_ring_size);
+            close(fd);
+            return false;
+        }
+
+        u8* sq = reinterpret_cast<u8*>(sq_ring);
+        u8* cq = reinterpret_cast<u8*>(cq_ring);
+        *ring  = IoUring{
+             .fd           = fd,
+             .sq_ring      = sq,
+             .cq_ring      = cq,
+             .sqes         = reinterpret_cast<u8*>(sqes),
+             .sq_ring_size = sq_ring_size,
+             .cq_ring_size = single_mmap ? 0 : cq_ring_size,
+             .sqes_size    = sqes_size,
+             .sq_head      = reinterpret_cast<u32*>(sq + params.sq_off.head),
+             .sq_tail      = reinterpret_cast<u32*>(sq + params.sq_off.tail),
+             .sq_array     = reinterpret_cast<u32*>(sq + params.sq_off.array),
+             .cq_head      = reinterpret_cast<u32*>(cq + params.cq_off.head),
+             .cq_tail      = reinterpret_cast<u32*>(cq + params.cq_off.tail),
+             .cqes         = cq + params.cq_off.cqes,
+             .sq_mask      = *reinterpret_cast<u32*>(sq + params.sq_off.ring_mask),
+             .cq_mask      = *reinterpret_cast<u32*>(cq + params.cq_off.ring_mask),
+        };
+        return true;
+    }
+
+    psh_internal void io_uring_destroy(IoUring* ring) psh_no_except {
+        munmap(ring->sqes, ring->sqes_size);
+        if (ring->cq_ring_size != 0) {
+            munmap(ring->cq_ring, ring->cq_ring_size);
+        }
+        munmap(ring->sq_ring, ring->sq_ring_size);
+        close(ring->fd);
+        *ring = IoUring{};
+    }
+
+    /// Write the submission queue entry of a slot, the kernel only sees it once submitted.
+    psh_internal void io_uring_queue(IoUring* ring, AsyncIoSlot const* slot, u32 slot_idx) psh_no_except {
+        // The kernel only consumes entries, so the tail can be read without synchronisation.
+        u32 tail  = *ring->sq_tail;
+        u32 index = tail & ring->sq_mask;
+
+        io_uring_sqe* sqe = reinterpret_cast<io_uring_sqe*>(ring->sqes) + index;
+        memset(sqe, 0, sizeof(io_uring_sqe));
+        sqe->opcode    = (slot->operation == ASYNC_IO_OPERATION_READ) ? IORING_OP_READ : IORING_OP_WRITE;
+        sqe->fd        = slot->file.handle;
+        sqe->addr      = reinterpret_cast<uptr>(slot->buf);
+        sqe->len       = static_cast<u32>(slot->size);
+        sqe->off       = slot->offset;
+        sqe->user_data = slot_idx;
+
+        ring->sq_array[index] = index;
+        atomic_store(reinterpret_cast<Atomic<u32>*>(ring->sq_tail), tail + 1u, MemoryOrder::RELEASE);
+    }
+
+    psh_internal i32 io_uring_enter(IoUring* ring, u32 submit_count, u32 min_complete) psh_no_except {
+        u32 flags = (min_complete != 0) ? IORING_ENTER_GETEVENTS : 0u;
+        return static_cast<i32>(syscall(__NR_io_uring_enter, ring->fd, submit_count, min_complete, flags, nullptr, 0));
+    }
+
+    /// Move the entries of the completion ring to the list of completions.
+    ///
+    /// Return: The number of entries moved.
+    psh_internal u32 io_uring_reap(AsyncIo* io) psh_no_except {
+        IoUring* ring       = &io->ring;
+        u32      first_head = *ring->cq_head;
+        u32      head       = first_head;
+        u32      tail       = atomic_load(reinterpret_cast<Atomic<u32>*>(ring->cq_tail), MemoryOrder::ACQUIRE);
+
+        for (; head != tail; ++head) {
+            io_uring_cqe const* cqe = reinterpret_cast<io_uring_cqe const*>(ring->cqes) + (head & ring->cq_mask);
+            async_io_push_completed(io, static_cast<u32>(cqe->user_data), (cqe->res < 0) ? -1 : static_cast<isize>(cqe->res));
+        }
+
+        atomic_store(reinterpret_cast<Atomic<u32>*>(ring->cq_head), head, MemoryOrder::RELEASE);
+        return head - first_head;
+    }
+
+    /// Number of operations submitted to the kernel whose completion wasn't yet reaped.
+    psh_internal u32 io_uring_in_flight_count(AsyncIo const* io) psh_no_except {
+        u32 completed_count = 0;
+        for (u32 slot_idx = io->completed_head; slot_idx != ASYNC_IO_INVALID_SLOT; slot_idx = io->slots[slot_idx].next) {
+            ++completed_count;
+        }
+        return io->pending_count - io->queued_count - completed_count;
+    }
+#endif
+
+#if PSH_OS_WINDOWS
+    /// Move the finished operations of the completion port to the list of completions.
+    ///
+    /// Return: Whether the completion port could be queried.
+    psh_internal bool iocp_reap(AsyncIo* io, bool block) psh_no_except {
+        OVERLAPPED_ENTRY entries[32];
+        ULONG            entry_count = 0;
+
+        BOOL success = GetQueuedCompletionStatusEx(io->port, entries, 32, &entry_count, block ? INFINITE : 0, FALSE);
+        if (!success) {
+            return (GetLastError() == WAIT_TIMEOUT);
+        }
+
+        OVERLAPPED* overlapped = reinterpret_cast<OVERLAPPED*>(io->overlapped);
+        for (ULONG idx = 0; idx < entry_count; ++idx) {
+            OVERLAPPED* entry_overlapped = entries[idx].lpOverlapped;
+
+            // The internal field holds the status of the operation, where reaching the end of the
+            // file isn't considered a failure.
+            constexpr ULONG_PTR STATUS_END_OF_FILE_CODE = 0xC0000011;
+            isize               result                  = -1;
+            if (entry_overlapped->Internal == 0) {
+                result = static_cast<isize>(entries[idx].dwNumberOfBytesTransferred);
+            } else if (entry_overlapped->Internal == STATUS_END_OF_FILE_CODE) {
+                result = 0;
+            }
+
+            async_io_push_completed(io, static_cast<u32>(entry_overlapped - overlapped), result);
+        }
+        return true;
+    }
+#endif
+
+    /// Collect the operations finished by the backend.
+    ///
+    /// Parameters:
+    ///     * block: Whether to wait for at least one operation to finish.
+    ///
+    /// Return: Whether the backend could be queried.
+    psh_internal bool async_io_reap(AsyncIo* io, bool block) psh_no_except {
+        switch (io->backend) {
+#if PSH_IMPL_ASYNC_IO_URING
+            case ASYNC_IO_BACKEND_IO_URING: {
+                if (block) {
+                    // A busy ring has completions that couldn't be flushed, which are reaped below.
+                    i32 result = io_uring_enter(&io->ring, 0, 1);
+                    if (psh_unlikely((result < 0) && (errno != EINTR) && (errno != EBUSY))) {
+                        psh_log_error("Unable to wait for the completion of asynchronous operations.");
+                        return false;
+                    }
+                }
+                psh_discard_value(io_uring_reap(io));
+                return true;
+            }
+#endif
+#if PSH_OS_WINDOWS
+            case ASYNC_IO_BACKEND_IOCP: {
+                bool success = iocp_reap(io, block);
+                if (psh_unlikely(!success)) {
+                    psh_log_error_fmt("Unable to wait for the completion of asynchronous operations due to the error: %lu", GetLastError());
+                }
+                return success;
+            }
+#endif
+            default: {
+                // Synchronous operations are completed as soon as they are queued.
+                return !block;
+            }
+        }
+    }
+
+    psh_internal Status async_io_queue(
+        AsyncIo*         io,
+        AsyncFile const* file,
+        u8*              buf,
+        usize            size,
+        u64              offset,
+        void*            user_data,
+        AsyncIoOperation operation) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(io);
+            psh_assert_not_null(file);
+            psh_assert_msg((buf != nullptr) || (size == 0), "Null buffer with non-zero size.");
+            psh_assert_msg(size <= psh_gibibytes(usize{2}), "Asynchronous operations are limited to 2 GiB.");
+        });
+
+        u32 slot_idx = async_io_acquire_slot(io);
+        if (psh_unlikely(slot_idx == ASYNC_IO_INVALID_SLOT)) {
+            psh_log_error("Asynchronous I/O queue is full, completions should be harvested first.");
+            return STATUS_FAILED;
+        }
+
+        AsyncIoSlot* slot = &io->slots[slot_idx];
+        *slot             = AsyncIoSlot{
+                        .user_data = user_data,
+                        .buf       = buf,
+                        .result    = 0,
+                        .size      = size,
+                        .offset    = offset,
+                        .file      = *file,
+                        .operation = operation,
+                        .next      = ASYNC_IO_INVALID_SLOT,
+        };
+        ++io->pending_count;
+
+        switch (io->backend) {
+#if PSH_IMPL_ASYNC_IO_URING
+            case ASYNC_IO_BACKEND_IO_URING: {
+                io_uring_queue(&io->ring, slot, slot_idx);
+                ++io->queued_count;
+                break;
+            }
+#endif
+#if PSH_OS_WINDOWS
+            case ASYNC_IO_BACKEND_IOCP: {
+                // Overlapped operations start right away, there's no batching to be done.
+                OVERLAPPED* overlapped = reinterpret_cast<OVERLAPPED*>(io->overlapped) + slot_idx;
+                *overlapped            = {};
+                overlapped->Offset     = static_cast<DWORD>(offset);
+                overlapped->OffsetHigh = static_cast<DWORD>(offset >> 32u);
+
+                BOOL success = (operation == ASYNC_IO_OPERATION_READ)
+                                   ? ReadFile(file->handle, buf, static_cast<DWORD>(size), nullptr, overlapped)
+                                   : WriteFile(file->handle, buf, static_cast<DWORD>(size), nullptr, overlapped);
+
+                // Immediate failures aren't posted to the completion port.
+                if (!success) {
+                    DWORD error = GetLastError();
+                    if (error != ERROR_IO_PENDING) {
+                        async_io_push_completed(io, slot_idx, (error == ERROR_HANDLE_EOF) ? 0 : -1);
+                    }
+                }
+                break;
+            }
+#endif
+            default: {
+#if PSH_OS_UNIX
+                async_io_push_completed(io, slot_idx, async_io_run_sync(slot));
+#endif
+                break;
+            }
+        }
+
+        return STATUS_OK;
+    }
 }  // namespace psh::impl
 
 namespace psh {
@@ -68,11 +515,23 @@ namespace psh {
             psh_assert_msg(impl::has_read_permission(flag), "Cannot read file without opening with read permissions.");
         });
 
-        cstring mode = impl::OPEN_FILE_FLAG_TO_STR_MAP[flag];
-        FILE*   fhandle;
+        cstring mode    = impl::OPEN_FILE_FLAG_TO_STR_MAP[flag];
+        FILE*   fhandle = nullptr;
 
 #if PSH_OS_WINDOWS
-        fopen_s(&fhandle, path, mode);
+        {
+            // Paths are UTF-8 encoded, so they have to go through the wide character API, otherwise
+            // non-ASCII paths would be interpreted in the current code page.
+            ScratchArena scratch   = get_scratch(arena);
+            Array<u16>   wide_path = utf8_to_utf16(scratch.arena, make_string(path));
+            Array<u16>   wide_mode = utf8_to_utf16(scratch.arena, make_string(mode));
+            if (psh_likely((wide_path.buf != nullptr) && (wide_mode.buf != nullptr))) {
+                _wfopen_s(
+                    &fhandle,
+                    reinterpret_cast<wchar_t const*>(wide_path.buf),
+                    reinterpret_cast<wchar_t const*>(wide_mode.buf));
+            }
+        }
 #elif PSH_OS_UNIX
         fhandle = fopen(path, mode);
 #endif
@@ -100,10 +559,13 @@ namespace psh {
 
         ArenaCheckpoint arena_checkpoint = make_arena_checkpoint(arena);
 
-        Array<u8> content = make_array<u8>(arena, size);
+        // The whole buffer is overwritten by the read, so zeroing it beforehand would be wasted work.
+        Array<u8> content = make_array_uninit<u8>(arena, size);
 
         usize read_count = fread(content.buf, psh_usize_of(u8), content.count, fhandle);
-        psh_discard_value(read_count);  // @TODO: Maybe we should check this.
+        if (psh_unlikely(read_count < content.count)) {
+            memory_set(content.buf + read_count, content.count - read_count, 0);
+        }
 
         if (psh_unlikely(ferror(fhandle) != 0)) {
             perror("Couldn't read file.\n");
@@ -123,6 +585,678 @@ namespace psh {
         };
     }
 
+    psh_proc FileMapResult map_file(cstring path, u32 hints) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(path);
+            psh_assert_msg(
+                (hints & (MAP_FILE_HINT_SEQUENTIAL | MAP_FILE_HINT_RANDOM)) != (MAP_FILE_HINT_SEQUENTIAL | MAP_FILE_HINT_RANDOM),
+                "The sequential and random access hints are mutually exclusive.");
+        });
+
+#if PSH_OS_WINDOWS
+        DWORD file_flags = FILE_ATTRIBUTE_NORMAL;
+        if ((hints & MAP_FILE_HINT_SEQUENTIAL) != 0) {
+            file_flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+        } else if ((hints & MAP_FILE_HINT_RANDOM) != 0) {
+            file_flags |= FILE_FLAG_RANDOM_ACCESS;
+        }
+
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, file_flags, nullptr);
+        if (psh_unlikely(file == INVALID_HANDLE_VALUE)) {
+            return FileMapResult{.status = FILE_STATUS_FAILED_TO_OPEN};
+        }
+
+        LARGE_INTEGER file_size;
+        if (psh_unlikely(!GetFileSizeEx(file, &file_size))) {
+            psh_log_error_fmt("Unable to obtain the size of %s due to the error: %lu", path, GetLastError());
+            CloseHandle(file);
+            return FileMapResult{.status = FILE_STATUS_SIZE_UNKNOWN};
+        }
+
+        usize size = static_cast<usize>(file_size.QuadPart);
+        if (size == 0) {
+            CloseHandle(file);
+            return FileMapResult{.status = FILE_STATUS_OK};
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        u8*    buf     = nullptr;
+        if (psh_likely(mapping != nullptr)) {
+            buf = reinterpret_cast<u8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+
+        // The view keeps a reference to the mapping, so the handles can be released right away.
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+
+        if (psh_unlikely(buf == nullptr)) {
+            psh_log_error_fmt("Unable to map %s due to the error: %lu", path, GetLastError());
+            return FileMapResult{.status = FILE_STATUS_FAILED_TO_READ};
+        }
+
+        if ((hints & MAP_FILE_HINT_WILL_NEED) != 0) {
+            WIN32_MEMORY_RANGE_ENTRY range = {.VirtualAddress = buf, .NumberOfBytes = size};
+            psh_discard_value(PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0));
+        }
+#elif PSH_OS_UNIX
+        i32 fd = open(path, O_RDONLY);
+        if (psh_unlikely(fd == -1)) {
+            return FileMapResult{.status = FILE_STATUS_FAILED_TO_OPEN};
+        }
+
+        struct stat file_stat;
+        if (psh_unlikely(fstat(fd, &file_stat) == -1)) {
+            psh_log_error_fmt("Unable to obtain the size of %s due to the error:", path);
+            perror(nullptr);
+            close(fd);
+            return FileMapResult{.status = FILE_STATUS_SIZE_UNKNOWN};
+        }
+
+        usize size = static_cast<usize>(file_stat.st_size);
+        if (size == 0) {
+            close(fd);
+            return FileMapResult{.status = FILE_STATUS_OK};
+        }
+
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        // The mapping keeps a reference to the file, so the descriptor can be closed right away.
+        close(fd);
+
+        if (psh_unlikely(mapping == MAP_FAILED)) {
+            psh_log_error_fmt("Unable to map %s due to the error:", path);
+            perror(nullptr);
+            return FileMapResult{.status = FILE_STATUS_FAILED_TO_READ};
+        }
+
+        // The hints are advisory, failing to apply them isn't an error.
+        if ((hints & MAP_FILE_HINT_SEQUENTIAL) != 0) {
+            psh_discard_value(madvise(mapping, size, MADV_SEQUENTIAL));
+        } else if ((hints & MAP_FILE_HINT_RANDOM) != 0) {
+            psh_discard_value(madvise(mapping, size, MADV_RANDOM));
+        }
+        if ((hints & MAP_FILE_HINT_WILL_NEED) != 0) {
+            psh_discard_value(madvise(mapping, size, MADV_WILLNEED));
+        }
+
+        u8* buf = reinterpret_cast<u8*>(mapping);
+#endif
+
+        return FileMapResult{
+            .content = FatPtr<u8 const>{buf, size},
+            .status  = FILE_STATUS_OK,
+        };
+    }
+
+    psh_proc void unmap_file(FatPtr<u8 const> content) psh_no_except {
+        if (content.count == 0) {
+            return;
+        }
+
+#if PSH_OS_WINDOWS
+        if (psh_unlikely(!UnmapViewOfFile(content.buf))) {
+            psh_log_error_fmt("Unable to unmap file view due to the error: %lu", GetLastError());
+        }
+#elif PSH_OS_UNIX
+        if (psh_unlikely(munmap(const_cast<u8*>(content.buf), content.count) == -1)) {
+            psh_log_error("Unable to unmap file view due to the error:");
+            perror(nullptr);
+        }
+#endif
+    }
+
+    psh_proc FileStatus open_file_reader(FileReader* reader, cstring path, u8* buf, usize capacity) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(reader);
+            psh_assert_not_null(path);
+            psh_assert_msg((buf != nullptr) && (capacity != 0), "The reader requires a non-empty buffer.");
+        });
+
+#if PSH_OS_WINDOWS
+        HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (psh_unlikely(handle == INVALID_HANDLE_VALUE)) {
+            return FILE_STATUS_FAILED_TO_OPEN;
+        }
+#elif PSH_OS_UNIX
+        i32 handle = open(path, O_RDONLY);
+        if (psh_unlikely(handle == -1)) {
+            return FILE_STATUS_FAILED_TO_OPEN;
+        }
+#    if defined(POSIX_FADV_SEQUENTIAL)
+        psh_discard_value(posix_fadvise(handle, 0, 0, POSIX_FADV_SEQUENTIAL));
+#    endif
+#endif
+
+        *reader = FileReader{
+            .handle   = handle,
+            .buf      = buf,
+            .capacity = capacity,
+        };
+        return FILE_STATUS_OK;
+    }
+
+    psh_proc FileStatus open_file_reader(FileReader* reader, Arena* arena, cstring path, usize chunk_size) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(arena));
+
+        ArenaCheckpoint arena_checkpoint = make_arena_checkpoint(arena);
+
+        u8* buf = memory_alloc_uninit<u8>(arena, chunk_size);
+        if (psh_unlikely(buf == nullptr)) {
+            return FILE_STATUS_OUT_OF_MEMORY;
+        }
+
+        FileStatus status = open_file_reader(reader, path, buf, chunk_size);
+        if (psh_unlikely(status != FILE_STATUS_OK)) {
+            arena_checkpoint_restore(arena_checkpoint);
+        }
+        return status;
+    }
+
+    psh_proc void close_file_reader(FileReader* reader) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(reader));
+
+#if PSH_OS_WINDOWS
+        if (reader->handle != nullptr) {
+            CloseHandle(reader->handle);
+        }
+#elif PSH_OS_UNIX
+        if (reader->handle != -1) {
+            close(reader->handle);
+        }
+#endif
+        *reader = FileReader{};
+    }
+
+    psh_proc bool file_reader_next_chunk(FileReader* reader, FatPtr<u8 const>* chunk) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(reader);
+            psh_assert_not_null(chunk);
+        });
+
+        if (reader->begin == reader->end) {
+            if (reader->end_of_file) {
+                return false;
+            }
+
+            reader->begin = 0;
+            reader->end   = 0;
+            if (!impl::file_reader_refill(reader)) {
+                return false;
+            }
+        }
+
+        *chunk        = FatPtr<u8 const>{reader->buf + reader->begin, reader->end - reader->begin};
+        reader->begin = reader->end;
+        return true;
+    }
+
+    psh_proc bool file_reader_next_record(FileReader* reader, u8 delimiter, FatPtr<u8 const>* record) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(reader);
+            psh_assert_not_null(record);
+        });
+
+        // Number of bytes, past the start of the record, known not to contain the delimiter.
+        usize scanned = 0;
+        for (;;) {
+            u8 const* record_start = reader->buf + reader->begin;
+            usize     available    = reader->end - reader->begin;
+
+            isize found = memory_find_u8(record_start + scanned, available - scanned, delimiter);
+            if (found >= 0) {
+                usize record_length = scanned + static_cast<usize>(found);
+                *record             = FatPtr<u8 const>{record_start, record_length};
+                reader->begin      += record_length + 1u;
+                return true;
+            }
+            scanned = available;
+
+            bool buffer_full = (reader->begin == 0) && (reader->end == reader->capacity);
+            if (!reader->end_of_file && !buffer_full) {
+                if (impl::file_reader_refill(reader)) {
+                    continue;
+                }
+                if (psh_unlikely(reader->status != FILE_STATUS_OK)) {
+                    return false;
+                }
+            }
+
+            // Either the file ended without a trailing delimiter or the record doesn't fit the buffer.
+            if (reader->begin == reader->end) {
+                return false;
+            }
+            *record       = FatPtr<u8 const>{reader->buf + reader->begin, reader->end - reader->begin};
+            reader->begin = reader->end;
+            return true;
+        }
+    }
+
+    psh_proc bool file_reader_next_line(FileReader* reader, String* line) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(line));
+
+        FatPtr<u8 const> record;
+        if (!file_reader_next_record(reader, static_cast<u8>('\n'), &record)) {
+            return false;
+        }
+
+        if ((record.count != 0) && (record.buf[record.count - 1u] == static_cast<u8>('\r'))) {
+            --record.count;
+        }
+        *line = make_string(record);
+        return true;
+    }
+
+    psh_proc FileStatus open_file_writer(FileWriter* writer, Arena* arena, cstring path, usize buffer_size, u32 flags) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(writer);
+            psh_assert_not_null(arena);
+            psh_assert_not_null(path);
+            psh_assert_msg(buffer_size != 0, "The writer requires a non-empty buffer.");
+            psh_assert_msg(
+                (flags & (FILE_WRITER_FLAG_APPEND | FILE_WRITER_FLAG_DIRECT)) != (FILE_WRITER_FLAG_APPEND | FILE_WRITER_FLAG_DIRECT),
+                "Direct writes can't be appended to a file.");
+        });
+
+        bool append = ((flags & FILE_WRITER_FLAG_APPEND) != 0);
+        bool direct = ((flags & FILE_WRITER_FLAG_DIRECT) != 0);
+
+        // Unbuffered writes require the buffer to be block aligned.
+        u32 alignment = direct ? static_cast<u32>(FILE_DIRECT_IO_ALIGNMENT) : static_cast<u32>(alignof(u8));
+        if (direct) {
+            buffer_size = (buffer_size + FILE_DIRECT_IO_ALIGNMENT - 1u) & ~(FILE_DIRECT_IO_ALIGNMENT - 1u);
+        }
+
+        ArenaCheckpoint arena_checkpoint = make_arena_checkpoint(arena);
+
+        u8* buf = memory_alloc_align(arena, buffer_size, alignment);
+        if (psh_unlikely(buf == nullptr)) {
+            return FILE_STATUS_OUT_OF_MEMORY;
+        }
+
+#if PSH_OS_WINDOWS
+        DWORD  creation   = append ? OPEN_ALWAYS : CREATE_ALWAYS;
+        DWORD  attributes = FILE_ATTRIBUTE_NORMAL | (direct ? (FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH) : 0);
+        HANDLE handle     = CreateFileA(path, GENERIC_WRITE, 0, nullptr, creation, attributes, nullptr);
+        if (psh_unlikely(handle == INVALID_HANDLE_VALUE) && direct) {
+            direct = false;
+            handle = CreateFileA(path, GENERIC_WRITE, 0, nullptr, creation, FILE_ATTRIBUTE_NORMAL, nullptr);
+        }
+        if (psh_unlikely(handle == INVALID_HANDLE_VALUE)) {
+            arena_checkpoint_restore(arena_checkpoint);
+            return FILE_STATUS_FAILED_TO_OPEN;
+        }
+        if (append) {
+            psh_discard_value(SetFilePointerEx(handle, LARGE_INTEGER{}, nullptr, FILE_END));
+        }
+#elif PSH_OS_UNIX
+        i32 open_flags = O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC);
+        i32 handle     = -1;
+#    if defined(O_DIRECT)
+        if (direct) {
+            handle = open(path, open_flags | O_DIRECT, 0644);
+
+            // Some file systems, such as tmpfs, refuse unbuffered access.
+            if ((handle == -1) && (errno == EINVAL)) {
+                direct = false;
+            }
+        }
+#    endif
+        if (handle == -1) {
+            handle = open(path, open_flags, 0644);
+        }
+        if (psh_unlikely(handle == -1)) {
+            arena_checkpoint_restore(arena_checkpoint);
+            return FILE_STATUS_FAILED_TO_OPEN;
+        }
+#    if !defined(O_DIRECT) && defined(F_NOCACHE)
+        if (direct) {
+            direct = (fcntl(handle, F_NOCACHE, 1) != -1);
+        }
+#    elif !defined(O_DIRECT)
+        direct = false;
+#    endif
+#endif
+
+        *writer = FileWriter{
+            .handle   = handle,
+            .buf      = buf,
+            .capacity = buffer_size,
+            .direct   = direct,
+        };
+        return FILE_STATUS_OK;
+    }
+
+    psh_proc Status file_writer_flush(FileWriter* writer) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(writer));
+
+        usize flush_size = writer->count;
+        if (writer->direct) {
+            flush_size &= ~(FILE_DIRECT_IO_ALIGNMENT - 1u);
+        }
+        if (flush_size == 0) {
+            return STATUS_OK;
+        }
+
+        if (psh_unlikely(!impl::file_writer_write_buffer(writer, flush_size))) {
+            return STATUS_FAILED;
+        }
+
+        usize remaining = writer->count - flush_size;
+        if (remaining != 0) {
+            memory_move(writer->buf, writer->buf + flush_size, remaining);
+        }
+        writer->count   = remaining;
+        writer->offset += flush_size;
+        return STATUS_OK;
+    }
+
+    psh_proc Status file_writer_write(FileWriter* writer, FatPtr<u8 const> data) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(writer));
+
+        u8 const* src       = data.buf;
+        usize     remaining = data.count;
+        while (remaining != 0) {
+            // Large writes skip the intermediate copy when the buffer is empty.
+            if (!writer->direct && (writer->count == 0) && (remaining >= writer->capacity)) {
+                if (psh_unlikely(!impl::native_file_write_all(writer->handle, src, remaining))) {
+                    psh_log_error("Unable to write to the file stream.");
+                    writer->status = FILE_STATUS_FAILED_TO_WRITE;
+                    return STATUS_FAILED;
+                }
+                writer->offset += remaining;
+                break;
+            }
+
+            usize copy_size = psh_min_value(writer->capacity - writer->count, remaining);
+            memory_copy(writer->buf + writer->count, src, copy_size);
+            writer->count += copy_size;
+            src           += copy_size;
+            remaining     -= copy_size;
+
+            if ((writer->count == writer->capacity) && psh_unlikely(!file_writer_flush(writer))) {
+                return STATUS_FAILED;
+            }
+        }
+
+        return STATUS_OK;
+    }
+
+    psh_proc Status close_file_writer(FileWriter* writer) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(writer));
+
+        Status status = file_writer_flush(writer);
+
+        // Unbuffered writes are padded to a whole block, the padding is then truncated away.
+        if (status && writer->direct && (writer->count != 0)) {
+            usize padded_size = (writer->count + FILE_DIRECT_IO_ALIGNMENT - 1u) & ~(FILE_DIRECT_IO_ALIGNMENT - 1u);
+            memory_set(writer->buf + writer->count, padded_size - writer->count, 0);
+
+            status = impl::file_writer_write_buffer(writer, padded_size);
+            if (status) {
+                writer->offset += writer->count;
+                writer->count   = 0;
+
+#if PSH_OS_WINDOWS
+                LARGE_INTEGER file_end = {.QuadPart = static_cast<LONGLONG>(writer->offset)};
+                status = SetFilePointerEx(writer->handle, file_end, nullptr, FILE_BEGIN) && SetEndOfFile(writer->handle);
+#elif PSH_OS_UNIX
+                status = (ftruncate(writer->handle, static_cast<off_t>(writer->offset)) == 0);
+#endif
+                if (psh_unlikely(!status)) {
+                    psh_log_error("Unable to truncate the padding of the file stream.");
+                    writer->status = FILE_STATUS_FAILED_TO_WRITE;
+                }
+            }
+        }
+
+#if PSH_OS_WINDOWS
+        if (psh_unlikely(!CloseHandle(writer->handle))) {
+            psh_log_error("Unable to close the file stream.");
+            status = STATUS_FAILED;
+        }
+#elif PSH_OS_UNIX
+        if (psh_unlikely(close(writer->handle) == -1)) {
+            psh_log_error("Unable to close the file stream.");
+            status = STATUS_FAILED;
+        }
+#endif
+
+        *writer = FileWriter{};
+        return status;
+    }
+
+    psh_proc Status init_async_io(AsyncIo* io, Arena* arena, u32 queue_depth) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(io);
+            psh_assert_not_null(arena);
+            psh_assert_msg(psh_is_pow_of_two(queue_depth), "The queue depth should be a power of two.");
+        });
+
+#if PSH_OS_WINDOWS
+        ArenaCheckpoint arena_checkpoint = make_arena_checkpoint(arena);
+#endif
+
+        impl::AsyncIoSlot* slots = memory_alloc<impl::AsyncIoSlot>(arena, queue_depth);
+        if (psh_unlikely(slots == nullptr)) {
+            return STATUS_FAILED;
+        }
+
+        *io          = AsyncIo{};
+        io->slots    = slots;
+        io->capacity = queue_depth;
+        for (u32 idx = queue_depth; idx > 0; --idx) {
+            impl::async_io_release_slot(io, idx - 1u);
+        }
+
+#if PSH_OS_WINDOWS
+        io->overlapped = memory_alloc<OVERLAPPED>(arena, queue_depth);
+        io->port       = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+        if (psh_unlikely((io->overlapped == nullptr) || (io->port == nullptr))) {
+            psh_log_error_fmt("Unable to create an I/O completion port due to the error: %lu", GetLastError());
+            arena_checkpoint_restore(arena_checkpoint);
+            *io = AsyncIo{};
+            return STATUS_FAILED;
+        }
+        io->backend = ASYNC_IO_BACKEND_IOCP;
+#elif PSH_IMPL_ASYNC_IO_URING
+        // Kernels without io_uring, or where it is disabled, fall back to synchronous operations.
+        if (impl::io_uring_init(&io->ring, queue_depth)) {
+            io->backend = ASYNC_IO_BACKEND_IO_URING;
+        }
+#endif
+
+        return STATUS_OK;
+    }
+
+    psh_proc void destroy_async_io(AsyncIo* io) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(io));
+
+        Buffer<AsyncIoCompletion, 16> discarded;
+        while (io->pending_count != 0) {
+            if (async_io_wait(io, make_fat_ptr(&discarded), 1) == 0) {
+                break;
+            }
+        }
+
+#if PSH_OS_WINDOWS
+        if (io->port != nullptr) {
+            CloseHandle(io->port);
+        }
+#elif PSH_IMPL_ASYNC_IO_URING
+        if (io->backend == ASYNC_IO_BACKEND_IO_URING) {
+            impl::io_uring_destroy(&io->ring);
+        }
+#endif
+
+        *io = AsyncIo{};
+    }
+
+    psh_proc FileStatus async_io_open_file(AsyncIo* io, AsyncFile* file, cstring path, AsyncFileMode mode) psh_no_except {
+        psh_validate_usage({
+            psh_assert_not_null(io);
+            psh_assert_not_null(file);
+            psh_assert_not_null(path);
+        });
+
+        bool read_mode = (mode == ASYNC_FILE_MODE_READ);
+
+#if PSH_OS_WINDOWS
+        HANDLE handle = CreateFileA(
+            path,
+            read_mode ? GENERIC_READ : GENERIC_WRITE,
+            read_mode ? FILE_SHARE_READ : 0,
+            nullptr,
+            read_mode ? OPEN_EXISTING : CREATE_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED,
+            nullptr);
+        if (psh_unlikely(handle == INVALID_HANDLE_VALUE)) {
+            return FILE_STATUS_FAILED_TO_OPEN;
+        }
+        if (psh_unlikely(CreateIoCompletionPort(handle, io->port, 0, 0) == nullptr)) {
+            psh_log_error_fmt("Unable to associate %s to the I/O completion port due to the error: %lu", path, GetLastError());
+            CloseHandle(handle);
+            return FILE_STATUS_FAILED_TO_OPEN;
+        }
+#elif PSH_OS_UNIX
+        psh_discard_value(io);
+        i32 handle = read_mode ? open(path, O_RDONLY) : open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (psh_unlikely(handle == -1)) {
+            return FILE_STATUS_FAILED_TO_OPEN;
+        }
+#endif
+
+        file->handle = handle;
+        return FILE_STATUS_OK;
+    }
+
+    psh_proc void async_io_close_file(AsyncFile* file) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(file));
+
+#if PSH_OS_WINDOWS
+        if (file->handle != nullptr) {
+            CloseHandle(file->handle);
+        }
+#elif PSH_OS_UNIX
+        if (file->handle != -1) {
+            close(file->handle);
+        }
+#endif
+        *file = AsyncFile{};
+    }
+
+    psh_proc Status async_io_read(AsyncIo* io, AsyncFile const* file, u8* buf, usize size, u64 offset, void* user_data) psh_no_except {
+        return impl::async_io_queue(io, file, buf, size, offset, user_data, ASYNC_IO_OPERATION_READ);
+    }
+
+    psh_proc Status async_io_read_to_arena(
+        AsyncIo*         io,
+        Arena*           arena,
+        AsyncFile const* file,
+        usize            size,
+        u64              offset,
+        void*            user_data) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(arena));
+
+        ArenaCheckpoint arena_checkpoint = make_arena_checkpoint(arena);
+
+        u8* buf = memory_alloc_uninit<u8>(arena, size);
+        if (psh_unlikely(buf == nullptr)) {
+            return STATUS_FAILED;
+        }
+
+        Status status = async_io_read(io, file, buf, size, offset, user_data);
+        if (psh_unlikely(!status)) {
+            arena_checkpoint_restore(arena_checkpoint);
+        }
+        return status;
+    }
+
+    psh_proc Status async_io_write(AsyncIo* io, AsyncFile const* file, u8 const* buf, usize size, u64 offset, void* user_data) psh_no_except {
+        // The buffer is only read by write operations.
+        return impl::async_io_queue(io, file, const_cast<u8*>(buf), size, offset, user_data, ASYNC_IO_OPERATION_WRITE);
+    }
+
+    psh_proc Status async_io_submit(AsyncIo* io) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(io));
+
+#if PSH_IMPL_ASYNC_IO_URING
+        while ((io->backend == ASYNC_IO_BACKEND_IO_URING) && (io->queued_count != 0)) {
+            i32 submitted = impl::io_uring_enter(&io->ring, io->queued_count, 0);
+            if (psh_likely(submitted > 0)) {
+                io->queued_count -= static_cast<u32>(submitted);
+                continue;
+            }
+
+            i32 error = (submitted < 0) ? errno : 0;
+            if (error == EINTR) {
+                continue;
+            }
+
+            // The kernel is short on resources or on completion space, which is recovered by
+            // collecting finished operations, waiting for one of them if none finished yet.
+            if ((error == EAGAIN) || (error == EBUSY)) {
+                if (impl::io_uring_reap(io) != 0) {
+                    continue;
+                }
+                if (impl::io_uring_in_flight_count(io) != 0) {
+                    i32 result = impl::io_uring_enter(&io->ring, 0, 1);
+                    if ((result >= 0) || (errno == EINTR) || (errno == EBUSY)) {
+                        continue;
+                    }
+                }
+            }
+
+            // No progress can be made, the remaining operations are left queued.
+            psh_log_error_fmt("Unable to submit %u asynchronous operations.", io->queued_count);
+            return STATUS_FAILED;
+        }
+#endif
+
+        return STATUS_OK;
+    }
+
+    psh_proc u32 async_io_wait(AsyncIo* io, FatPtr<AsyncIoCompletion> completions, u32 min_count) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(io));
+
+        if (psh_unlikely(!async_io_submit(io))) {
+            return 0;
+        }
+
+        usize wait_count = psh_min_value(static_cast<usize>(psh_min_value(min_count, io->pending_count)), completions.count);
+        usize harvested  = 0;
+
+        bool success = impl::async_io_reap(io, false);
+        while (success) {
+            while ((io->completed_head != impl::ASYNC_IO_INVALID_SLOT) && (harvested < completions.count)) {
+                u32                      slot_idx = io->completed_head;
+                impl::AsyncIoSlot const* slot     = &io->slots[slot_idx];
+
+                completions[harvested++] = AsyncIoCompletion{
+                    .user_data = slot->user_data,
+                    .buf       = slot->buf,
+                    .result    = slot->result,
+                    .operation = slot->operation,
+                };
+
+                io->completed_head = slot->next;
+                if (io->completed_head == impl::ASYNC_IO_INVALID_SLOT) {
+                    io->completed_tail = impl::ASYNC_IO_INVALID_SLOT;
+                }
+                impl::async_io_release_slot(io, slot_idx);
+                --io->pending_count;
+            }
+
+            if (harvested >= wait_count) {
+                break;
+            }
+            success = impl::async_io_reap(io, true);
+        }
+
+        return static_cast<u32>(harvested);
+    }
+
     psh_proc DynamicString read_stdin(Arena* arena, u32 initial_buf_size, u32 read_chunk_size) psh_no_except {
         psh_validate_usage(psh_assert_not_null(arena));
 
@@ -198,14 +1332,52 @@ namespace psh {
         DynamicString absolute_path = make_dynamic_string(arena, PSH_IMPL_PATH_MAX_CHAR_COUNT);
 
 #if PSH_OS_WINDOWS
-        DWORD result = GetFullPathName(file_path, PSH_IMPL_PATH_MAX_CHAR_COUNT, absolute_path.buf, nullptr);
-        if (result == 0) {
-            psh_log_error_fmt(
-                "Unable to obtain the full path of %s due to the error: %lu",
-                file_path,
-                GetLastError());
+        {
+            // Resolve the path via the wide character API, so that non-ASCII paths aren't interpreted
+            // in the current code page, and transcode the result back to UTF-8.
+            ScratchArena scratch        = get_scratch(arena);
+            Array<u16>   wide_path      = utf8_to_utf16(scratch.arena, make_string(file_path));
+            wchar_t*     wide_full_path = memory_alloc_uninit<wchar_t>(scratch.arena, PSH_IMPL_PATH_MAX_CHAR_COUNT);
+            if (psh_unlikely((wide_path.buf == nullptr) || (wide_full_path == nullptr))) {
+                psh_log_error_fmt("Unable to convert the path %s to UTF-16.", file_path);
+                goto return_from_error;
+            }
 
-            goto return_from_error;
+            DWORD result = GetFullPathNameW(
+                reinterpret_cast<wchar_t const*>(wide_path.buf),
+                PSH_IMPL_PATH_MAX_CHAR_COUNT,
+                wide_full_path,
+                nullptr);
+            if ((result == 0) || (result >= PSH_IMPL_PATH_MAX_CHAR_COUNT)) {
+                psh_log_error_fmt(
+                    "Unable to obtain the full path of %s due to the error: %lu",
+                    file_path,
+                    GetLastError());
+
+                goto return_from_error;
+            }
+
+            String full_path = utf16_to_utf8(
+                scratch.arena,
+                FatPtr<u16 const>{reinterpret_cast<u16 const*>(wide_full_path), static_cast<usize>(result)});
+            if (psh_unlikely(full_path.buf == nullptr)) {
+                psh_log_error_fmt("Unable to convert the full path of %s to UTF-8.", file_path);
+                goto return_from_error;
+            }
+
+            // Non-ASCII characters may take more bytes in UTF-8 than code units in UTF-16.
+            if (full_path.count + 1 > absolute_path.capacity) {
+                if (psh_unlikely(dynamic_array_reserve(&absolute_path, full_path.count + 1) != STATUS_OK)) {
+                    goto return_from_error;
+                }
+            }
+
+            // Copy the zero terminator along with the path.
+            memory_copy(
+                reinterpret_cast<u8*>(absolute_path.buf),
+                reinterpret_cast<u8 const*>(full_path.buf),
+                full_path.count + 1);
+            absolute_path.count = full_path.count;
         }
 #elif PSH_OS_UNIX
         char const* result = realpath(file_path, absolute_path.buf);
@@ -215,6 +1387,7 @@ namespace psh {
 
             goto return_from_error;
         }
+        absolute_path.count = cstring_length(absolute_path.buf);
 #endif
 
         return absolute_path;
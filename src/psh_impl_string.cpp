@@ -24,9 +24,15 @@
 
 #include "psh_string.hpp"
 
+#include <stdlib.h>
 #include <string.h>
+#include "psh_bit.hpp"
 #include "psh_memory.hpp"
 
+#if PSH_ARCH_SIMD_AVX2
+#    include <immintrin.h>
+#endif
+
 // Due to STB code being public domain, we separate its implementation from the psh_string module.
 #include "psh_impl_stb_sprintf.cpp"
 
@@ -43,7 +49,12 @@ namespace psh {
         i32                 cmp = memcmp(lhs.buf, rhs.buf, psh_min_value(lhs.count, rhs.count));
         StringCompareResult result;
         if (cmp == 0) {
-            result = StringCompareResult::EQUAL;
+            // With equal common prefixes, the shorter string comes first.
+            if (lhs.count == rhs.count) {
+                result = StringCompareResult::EQUAL;
+            } else {
+                result = (lhs.count < rhs.count) ? StringCompareResult::LESS_THAN : StringCompareResult::GREATER_THAN;
+            }
         } else if (cmp < 0) {
             result = StringCompareResult::LESS_THAN;
         } else {
@@ -64,6 +75,139 @@ namespace psh {
         return are_equal;
     }
 
+    psh_proc isize string_find(String haystack, String needle) psh_no_except {
+        if (needle.count == 0) {
+            return 0;
+        }
+        if (needle.count > haystack.count) {
+            return -1;
+        }
+
+        u8 const* hay        = reinterpret_cast<u8 const*>(haystack.buf);
+        u8 const* ndl        = reinterpret_cast<u8 const*>(needle.buf);
+        usize     last       = needle.count - 1u;
+        usize     last_start = haystack.count - needle.count;  // Last position where the needle fits.
+        usize     idx        = 0;
+
+        // Compare the first and last characters of the needle against a block of candidate
+        // positions at once, only checking the middle characters for positions matching both.
+        usize middle_length = (needle.count > 2u) ? (needle.count - 2u) : 0u;
+
+#if PSH_ARCH_SIMD_AVX2
+        __m256i first_char_256 = _mm256_set1_epi8(static_cast<char>(ndl[0]));
+        __m256i last_char_256  = _mm256_set1_epi8(static_cast<char>(ndl[last]));
+        for (; idx + 32u <= last_start + 1u; idx += 32u) {
+            __m256i first_block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(hay + idx));
+            __m256i last_block  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(hay + idx + last));
+            __m256i matches     = _mm256_and_si256(
+                _mm256_cmpeq_epi8(first_block, first_char_256),
+                _mm256_cmpeq_epi8(last_block, last_char_256));
+
+            u32 mask = static_cast<u32>(_mm256_movemask_epi8(matches));
+            while (mask != 0) {
+                usize candidate = idx + bit_count_trailing_zeros(mask);
+                if (memcmp(hay + candidate + 1u, ndl + 1u, middle_length) == 0) {
+                    return static_cast<isize>(candidate);
+                }
+                mask &= mask - 1u;
+            }
+        }
+#endif
+#if PSH_ARCH_SIMD_SSE2
+        __m128i first_char_128 = _mm_set1_epi8(static_cast<char>(ndl[0]));
+        __m128i last_char_128  = _mm_set1_epi8(static_cast<char>(ndl[last]));
+        for (; idx + 16u <= last_start + 1u; idx += 16u) {
+            __m128i first_block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(hay + idx));
+            __m128i last_block  = _mm_loadu_si128(reinterpret_cast<__m128i const*>(hay + idx + last));
+            __m128i matches     = _mm_and_si128(
+                _mm_cmpeq_epi8(first_block, first_char_128),
+                _mm_cmpeq_epi8(last_block, last_char_128));
+
+            u32 mask = static_cast<u32>(_mm_movemask_epi8(matches));
+            while (mask != 0) {
+                usize candidate = idx + bit_count_trailing_zeros(mask);
+                if (memcmp(hay + candidate + 1u, ndl + 1u, middle_length) == 0) {
+                    return static_cast<isize>(candidate);
+                }
+                mask &= mask - 1u;
+            }
+        }
+#endif
+
+        // Jump between the occurrences of the first character of the needle.
+        while (idx <= last_start) {
+            isize found = memory_find_u8(hay + idx, last_start + 1u - idx, ndl[0]);
+            if (found < 0) {
+                break;
+            }
+
+            usize candidate = idx + static_cast<usize>(found);
+            if ((hay[candidate + last] == ndl[last]) && (memcmp(hay + candidate + 1u, ndl + 1u, middle_length) == 0)) {
+                return static_cast<isize>(candidate);
+            }
+            idx = candidate + 1u;
+        }
+
+        return -1;
+    }
+
+    psh_proc bool string_split_next(StringSplitter* splitter, String* token) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(splitter);
+            psh_assert_not_null(token);
+        });
+
+        if (splitter->exhausted) {
+            return false;
+        }
+
+        String remaining = splitter->remaining;
+        isize  found     = string_find_char(remaining, splitter->delimiter);
+        if (found < 0) {
+            *token              = remaining;
+            splitter->remaining = String{.buf = remaining.buf + remaining.count, .count = 0};
+            splitter->exhausted = true;
+        } else {
+            usize token_length  = static_cast<usize>(found);
+            *token              = String{.buf = remaining.buf, .count = token_length};
+            splitter->remaining = String{
+                .buf   = remaining.buf + token_length + 1u,
+                .count = remaining.count - token_length - 1u,
+            };
+        }
+
+        return true;
+    }
+
+    psh_proc Array<String> string_split(Arena* arena, String str, char delimiter) psh_no_except {
+        // Count the tokens ahead of time in order to allocate the exact amount of memory needed.
+        usize token_count = 1;
+        {
+            String rest = str;
+            isize  found;
+            while ((found = string_find_char(rest, delimiter)) >= 0) {
+                rest.buf   += found + 1;
+                rest.count -= static_cast<usize>(found) + 1u;
+                ++token_count;
+            }
+        }
+
+        Array<String> tokens = make_array_uninit<String>(arena, token_count);
+        if (psh_unlikely(tokens.buf == nullptr)) {
+            return tokens;
+        }
+
+        StringSplitter splitter = make_string_splitter(str, delimiter);
+        String         token;
+        usize          idx = 0;
+        while (string_split_next(&splitter, &token)) {
+            tokens.buf[idx++] = token;
+        }
+        psh_assert(idx == token_count);
+
+        return tokens;
+    }
+
     psh_proc Status join_strings(DynamicString& target, FatPtr<String const> join_strings, String join_element) psh_no_except {
         bool previously_empty = (target.count == 0);
 
@@ -170,4 +314,2258 @@ namespace psh {
         va_end(va);
         return result;
     }
+
+    // -------------------------------------------------------------------------------------------------
+    // Number formatting and parsing utilities.
+    // -------------------------------------------------------------------------------------------------
+
+    namespace impl {
+        psh_internal constexpr char DIGIT_PAIRS[] =
+            "00010203040506070809"
+            "10111213141516171819"
+            "20212223242526272829"
+            "30313233343536373839"
+            "40414243444546474849"
+            "50515253545556575859"
+            "60616263646566676869"
+            "70717273747576777879"
+            "80818283848586878889"
+            "90919293949596979899";
+
+        psh_internal constexpr u64 POW_TEN_U64[FORMAT_INTEGER_MAX_LENGTH] = {
+            1ull,
+            10ull,
+            100ull,
+            1000ull,
+            10000ull,
+            100000ull,
+            1000000ull,
+            10000000ull,
+            100000000ull,
+            1000000000ull,
+            10000000000ull,
+            100000000000ull,
+            1000000000000ull,
+            10000000000000ull,
+            100000000000000ull,
+            1000000000000000ull,
+            10000000000000000ull,
+            100000000000000000ull,
+            1000000000000000000ull,
+            10000000000000000000ull,
+        };
+
+        /// Powers of ten exactly representable as 64-bit floating point numbers.
+        psh_internal constexpr f64 POW_TEN_F64[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+        };
+
+        psh_internal constexpr u32 F64_SIGNIFICAND_BIT_COUNT = 52;
+        psh_internal constexpr u64 F64_SIGNIFICAND_MASK      = (u64{1} << F64_SIGNIFICAND_BIT_COUNT) - 1u;
+        psh_internal constexpr i32 F64_EXPONENT_BIAS         = 1023;
+        psh_internal constexpr i32 F64_INFINITE_EXPONENT     = 0x7FF;
+
+        /// Unsigned 128-bit integer split into its 64-bit halves.
+        struct U128 {
+            u64 high;
+            u64 low;
+        };
+
+#if defined(__SIZEOF_INT128__)
+        __extension__ typedef unsigned __int128 NativeU128;
+#endif
+
+        psh_internal psh_inline U128 multiply_u64_full(u64 lhs, u64 rhs) psh_no_except {
+#if defined(__SIZEOF_INT128__)
+            NativeU128 product = static_cast<NativeU128>(lhs) * static_cast<NativeU128>(rhs);
+            return U128{.high = static_cast<u64>(product >> 64), .low = static_cast<u64>(product)};
+#elif PSH_COMPILER_MSVC && PSH_ARCH_X64
+            u64 high;
+            u64 low = _umul128(lhs, rhs, &high);
+            return U128{.high = high, .low = low};
+#elif PSH_COMPILER_MSVC && PSH_ARCH_ARM
+            return U128{.high = __umulh(lhs, rhs), .low = lhs * rhs};
+#else
+            u64 const lhs_lo = lhs & 0xFFFFFFFFu;
+            u64 const lhs_hi = lhs >> 32;
+            u64 const rhs_lo = rhs & 0xFFFFFFFFu;
+            u64 const rhs_hi = rhs >> 32;
+
+            u64 const lo_lo = lhs_lo * rhs_lo;
+            u64 const hi_lo = lhs_hi * rhs_lo;
+            u64 const lo_hi = lhs_lo * rhs_hi;
+            u64 const hi_hi = lhs_hi * rhs_hi;
+
+            u64 const middle = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+            return U128{
+                .high = hi_hi + (hi_lo >> 32) + (middle >> 32),
+                .low  = (middle << 32) | (lo_lo & 0xFFFFFFFFu),
+            };
+#endif
+        }
+
+        psh_internal constexpr i32 POW_FIVE_128_MIN_EXPONENT = -342;
+        psh_internal constexpr i32 POW_FIVE_128_MAX_EXPONENT = 326;
+
+        /// Powers of five scaled by a power of two into the range [2^127, 2^128) and truncated: the
+        /// entry for 5^q is located at the index q - POW_FIVE_128_MIN_EXPONENT.
+        ///
+        /// Since 10^q = 5^q * 2^q, the entries are the normalized powers of ten as well.
+        psh_internal constexpr U128 POW_FIVE_128[POW_FIVE_128_MAX_EXPONENT - POW_FIVE_128_MIN_EXPONENT + 1] = {
+            {0xEEF453D6923BD65A, 0x113FAA2906A13B3F},
+            {0x9558B4661B6565F8, 0x4AC7CA59A424C507},
+            {0xBAAEE17FA23EBF76, 0x5D79BCF00D2DF649},
+            {0xE95A99DF8ACE6F53, 0xF4D82C2C107973DC},
+            {0x91D8A02BB6C10594, 0x79071B9B8A4BE869},
+            {0xB64EC836A47146F9, 0x9748E2826CDEE284},
+            {0xE3E27A444D8D98B7, 0xFD1B1B2308169B25},
+            {0x8E6D8C6AB0787F72, 0xFE30F0F5E50E20F7},
+            {0xB208EF855C969F4F, 0xBDBD2D335E51A935},
+            {0xDE8B2B66B3BC4723, 0xAD2C788035E61382},
+            {0x8B16FB203055AC76, 0x4C3BCB5021AFCC31},
+            {0xADDCB9E83C6B1793, 0xDF4ABE242A1BBF3D},
+            {0xD953E8624B85DD78, 0xD71D6DAD34A2AF0D},
+            {0x87D4713D6F33AA6B, 0x8672648C40E5AD68},
+            {0xA9C98D8CCB009506, 0x680EFDAF511F18C2},
+            {0xD43BF0EFFDC0BA48, 0x0212BD1B2566DEF2},
+            {0x84A57695FE98746D, 0x014BB630F7604B57},
+            {0xA5CED43B7E3E9188, 0x419EA3BD35385E2D},
+            {0xCF42894A5DCE35EA, 0x52064CAC828675B9},
+            {0x818995CE7AA0E1B2, 0x7343EFEBD1940993},
+            {0xA1EBFB4219491A1F, 0x1014EBE6C5F90BF8},
+            {0xCA66FA129F9B60A6, 0xD41A26E077774EF6},
+            {0xFD00B897478238D0, 0x8920B098955522B4},
+            {0x9E20735E8CB16382, 0x55B46E5F5D5535B0},
+            {0xC5A890362FDDBC62, 0xEB2189F734AA831D},
+            {0xF712B443BBD52B7B, 0xA5E9EC7501D523E4},
+            {0x9A6BB0AA55653B2D, 0x47B233C92125366E},
+            {0xC1069CD4EABE89F8, 0x999EC0BB696E840A},
+            {0xF148440A256E2C76, 0xC00670EA43CA250D},
+            {0x96CD2A865764DBCA, 0x380406926A5E5728},
+            {0xBC807527ED3E12BC, 0xC605083704F5ECF2},
+            {0xEBA09271E88D976B, 0xF7864A44C633682E},
+            {0x93445B8731587EA3, 0x7AB3EE6AFBE0211D},
+            {0xB8157268FDAE9E4C, 0x5960EA05BAD82964},
+            {0xE61ACF033D1A45DF, 0x6FB92487298E33BD},
+            {0x8FD0C16206306BAB, 0xA5D3B6D479F8E056},
+            {0xB3C4F1BA87BC8696, 0x8F48A4899877186C},
+            {0xE0B62E2929ABA83C, 0x331ACDABFE94DE87},
+            {0x8C71DCD9BA0B4925, 0x9FF0C08B7F1D0B14},
+            {0xAF8E5410288E1B6F, 0x07ECF0AE5EE44DD9},
+            {0xDB71E91432B1A24A, 0xC9E82CD9F69D6150},
+            {0x892731AC9FAF056E, 0xBE311C083A225CD2},
+            {0xAB70FE17C79AC6CA, 0x6DBD630A48AAF406},
+            {0xD64D3D9DB981787D, 0x092CBBCCDAD5B108},
+            {0x85F0468293F0EB4E, 0x25BBF56008C58EA5},
+            {0xA76C582338ED2621, 0xAF2AF2B80AF6F24E},
+            {0xD1476E2C07286FAA, 0x1AF5AF660DB4AEE1},
+            {0x82CCA4DB847945CA, 0x50D98D9FC890ED4D},
+            {0xA37FCE126597973C, 0xE50FF107BAB528A0},
+            {0xCC5FC196FEFD7D0C, 0x1E53ED49A96272C8},
+            {0xFF77B1FCBEBCDC4F, 0x25E8E89C13BB0F7A},
+            {0x9FAACF3DF73609B1, 0x77B191618C54E9AC},
+            {0xC795830D75038C1D, 0xD59DF5B9EF6A2417},
+            {0xF97AE3D0D2446F25, 0x4B0573286B44AD1D},
+            {0x9BECCE62836AC577, 0x4EE367F9430AEC32},
+            {0xC2E801FB244576D5, 0x229C41F793CDA73F},
+            {0xF3A20279ED56D48A, 0x6B43527578C1110F},
+            {0x9845418C345644D6, 0x830A13896B78AAA9},
+            {0xBE5691EF416BD60C, 0x23CC986BC656D553},
+            {0xEDEC366B11C6CB8F, 0x2CBFBE86B7EC8AA8},
+            {0x94B3A202EB1C3F39, 0x7BF7D71432F3D6A9},
+            {0xB9E08A83A5E34F07, 0xDAF5CCD93FB0CC53},
+            {0xE858AD248F5C22C9, 0xD1B3400F8F9CFF68},
+            {0x91376C36D99995BE, 0x23100809B9C21FA1},
+            {0xB58547448FFFFB2D, 0xABD40A0C2832A78A},
+            {0xE2E69915B3FFF9F9, 0x16C90C8F323F516C},
+            {0x8DD01FAD907FFC3B, 0xAE3DA7D97F6792E3},
+            {0xB1442798F49FFB4A, 0x99CD11CFDF41779C},
+            {0xDD95317F31C7FA1D, 0x40405643D711D583},
+            {0x8A7D3EEF7F1CFC52, 0x482835EA666B2572},
+            {0xAD1C8EAB5EE43B66, 0xDA3243650005EECF},
+            {0xD863B256369D4A40, 0x90BED43E40076A82},
+            {0x873E4F75E2224E68, 0x5A7744A6E804A291},
+            {0xA90DE3535AAAE202, 0x711515D0A205CB36},
+            {0xD3515C2831559A83, 0x0D5A5B44CA873E03},
+            {0x8412D9991ED58091, 0xE858790AFE9486C2},
+            {0xA5178FFF668AE0B6, 0x626E974DBE39A872},
+            {0xCE5D73FF402D98E3, 0xFB0A3D212DC8128F},
+            {0x80FA687F881C7F8E, 0x7CE66634BC9D0B99},
+            {0xA139029F6A239F72, 0x1C1FFFC1EBC44E80},
+            {0xC987434744AC874E, 0xA327FFB266B56220},
+            {0xFBE9141915D7A922, 0x4BF1FF9F0062BAA8},
+            {0x9D71AC8FADA6C9B5, 0x6F773FC3603DB4A9},
+            {0xC4CE17B399107C22, 0xCB550FB4384D21D3},
+            {0xF6019DA07F549B2B, 0x7E2A53A146606A48},
+            {0x99C102844F94E0FB, 0x2EDA7444CBFC426D},
+            {0xC0314325637A1939, 0xFA911155FEFB5308},
+            {0xF03D93EEBC589F88, 0x793555AB7EBA27CA},
+            {0x96267C7535B763B5, 0x4BC1558B2F3458DE},
+            {0xBBB01B9283253CA2, 0x9EB1AAEDFB016F16},
+            {0xEA9C227723EE8BCB, 0x465E15A979C1CADC},
+            {0x92A1958A7675175F, 0x0BFACD89EC191EC9},
+            {0xB749FAED14125D36, 0xCEF980EC671F667B},
+            {0xE51C79A85916F484, 0x82B7E12780E7401A},
+            {0x8F31CC0937AE58D2, 0xD1B2ECB8B0908810},
+            {0xB2FE3F0B8599EF07, 0x861FA7E6DCB4AA15},
+            {0xDFBDCECE67006AC9, 0x67A791E093E1D49A},
+            {0x8BD6A141006042BD, 0xE0C8BB2C5C6D24E0},
+            {0xAECC49914078536D, 0x58FAE9F773886E18},
+            {0xDA7F5BF590966848, 0xAF39A475506A899E},
+            {0x888F99797A5E012D, 0x6D8406C952429603},
+            {0xAAB37FD7D8F58178, 0xC8E5087BA6D33B83},
+            {0xD5605FCDCF32E1D6, 0xFB1E4A9A90880A64},
+            {0x855C3BE0A17FCD26, 0x5CF2EEA09A55067F},
+            {0xA6B34AD8C9DFC06F, 0xF42FAA48C0EA481E},
+            {0xD0601D8EFC57B08B, 0xF13B94DAF124DA26},
+            {0x823C12795DB6CE57, 0x76C53D08D6B70858},
+            {0xA2CB1717B52481ED, 0x54768C4B0C64CA6E},
+            {0xCB7DDCDDA26DA268, 0xA9942F5DCF7DFD09},
+            {0xFE5D54150B090B02, 0xD3F93B35435D7C4C},
+            {0x9EFA548D26E5A6E1, 0xC47BC5014A1A6DAF},
+            {0xC6B8E9B0709F109A, 0x359AB6419CA1091B},
+            {0xF867241C8CC6D4C0, 0xC30163D203C94B62},
+            {0x9B407691D7FC44F8, 0x79E0DE63425DCF1D},
+            {0xC21094364DFB5636, 0x985915FC12F542E4},
+            {0xF294B943E17A2BC4, 0x3E6F5B7B17B2939D},
+            {0x979CF3CA6CEC5B5A, 0xA705992CEECF9C42},
+            {0xBD8430BD08277231, 0x50C6FF782A838353},
+            {0xECE53CEC4A314EBD, 0xA4F8BF5635246428},
+            {0x940F4613AE5ED136, 0x871B7795E136BE99},
+            {0xB913179899F68584, 0x28E2557B59846E3F},
+            {0xE757DD7EC07426E5, 0x331AEADA2FE589CF},
+            {0x9096EA6F3848984F, 0x3FF0D2C85DEF7621},
+            {0xB4BCA50B065ABE63, 0x0FED077A756B53A9},
+            {0xE1EBCE4DC7F16DFB, 0xD3E8495912C62894},
+            {0x8D3360F09CF6E4BD, 0x64712DD7ABBBD95C},
+            {0xB080392CC4349DEC, 0xBD8D794D96AACFB3},
+            {0xDCA04777F541C567, 0xECF0D7A0FC5583A0},
+            {0x89E42CAAF9491B60, 0xF41686C49DB57244},
+            {0xAC5D37D5B79B6239, 0x311C2875C522CED5},
+            {0xD77485CB25823AC7, 0x7D633293366B828B},
+            {0x86A8D39EF77164BC, 0xAE5DFF9C02033197},
+            {0xA8530886B54DBDEB, 0xD9F57F830283FDFC},
+            {0xD267CAA862A12D66, 0xD072DF63C324FD7B},
+            {0x8380DEA93DA4BC60, 0x4247CB9E59F71E6D},
+            {0xA46116538D0DEB78, 0x52D9BE85F074E608},
+            {0xCD795BE870516656, 0x67902E276C921F8B},
+            {0x806BD9714632DFF6, 0x00BA1CD8A3DB53B6},
+            {0xA086CFCD97BF97F3, 0x80E8A40ECCD228A4},
+            {0xC8A883C0FDAF7DF0, 0x6122CD128006B2CD},
+            {0xFAD2A4B13D1B5D6C, 0x796B805720085F81},
+            {0x9CC3A6EEC6311A63, 0xCBE3303674053BB0},
+            {0xC3F490AA77BD60FC, 0xBEDBFC4411068A9C},
+            {0xF4F1B4D515ACB93B, 0xEE92FB5515482D44},
+            {0x991711052D8BF3C5, 0x751BDD152D4D1C4A},
+            {0xBF5CD54678EEF0B6, 0xD262D45A78A0635D},
+            {0xEF340A98172AACE4, 0x86FB897116C87C34},
+            {0x9580869F0E7AAC0E, 0xD45D35E6AE3D4DA0},
+            {0xBAE0A846D2195712, 0x8974836059CCA109},
+            {0xE998D258869FACD7, 0x2BD1A438703FC94B},
+            {0x91FF83775423CC06, 0x7B6306A34627DDCF},
+            {0xB67F6455292CBF08, 0x1A3BC84C17B1D542},
+            {0xE41F3D6A7377EECA, 0x20CABA5F1D9E4A93},
+            {0x8E938662882AF53E, 0x547EB47B7282EE9C},
+            {0xB23867FB2A35B28D, 0xE99E619A4F23AA43},
+            {0xDEC681F9F4C31F31, 0x6405FA00E2EC94D4},
+            {0x8B3C113C38F9F37E, 0xDE83BC408DD3DD04},
+            {0xAE0B158B4738705E, 0x9624AB50B148D445},
+            {0xD98DDAEE19068C76, 0x3BADD624DD9B0957},
+            {0x87F8A8D4CFA417C9, 0xE54CA5D70A80E5D6},
+            {0xA9F6D30A038D1DBC, 0x5E9FCF4CCD211F4C},
+            {0xD47487CC8470652B, 0x7647C3200069671F},
+            {0x84C8D4DFD2C63F3B, 0x29ECD9F40041E073},
+            {0xA5FB0A17C777CF09, 0xF468107100525890},
+            {0xCF79CC9DB955C2CC, 0x7182148D4066EEB4},
+            {0x81AC1FE293D599BF, 0xC6F14CD848405530},
+            {0xA21727DB38CB002F, 0xB8ADA00E5A506A7C},
+            {0xCA9CF1D206FDC03B, 0xA6D90811F0E4851C},
+            {0xFD442E4688BD304A, 0x908F4A166D1DA663},
+            {0x9E4A9CEC15763E2E, 0x9A598E4E043287FE},
+            {0xC5DD44271AD3CDBA, 0x40EFF1E1853F29FD},
+            {0xF7549530E188C128, 0xD12BEE59E68EF47C},
+            {0x9A94DD3E8CF578B9, 0x82BB74F8301958CE},
+            {0xC13A148E3032D6E7, 0xE36A52363C1FAF01},
+            {0xF18899B1BC3F8CA1, 0xDC44E6C3CB279AC1},
+            {0x96F5600F15A7B7E5, 0x29AB103A5EF8C0B9},
+            {0xBCB2B812DB11A5DE, 0x7415D448F6B6F0E7},
+            {0xEBDF661791D60F56, 0x111B495B3464AD21},
+            {0x936B9FCEBB25C995, 0xCAB10DD900BEEC34},
+            {0xB84687C269EF3BFB, 0x3D5D514F40EEA742},
+            {0xE65829B3046B0AFA, 0x0CB4A5A3112A5112},
+            {0x8FF71A0FE2C2E6DC, 0x47F0E785EABA72AB},
+            {0xB3F4E093DB73A093, 0x59ED216765690F56},
+            {0xE0F218B8D25088B8, 0x306869C13EC3532C},
+            {0x8C974F7383725573, 0x1E414218C73A13FB},
+            {0xAFBD2350644EEACF, 0xE5D1929EF90898FA},
+            {0xDBAC6C247D62A583, 0xDF45F746B74ABF39},
+            {0x894BC396CE5DA772, 0x6B8BBA8C328EB783},
+            {0xAB9EB47C81F5114F, 0x066EA92F3F326564},
+            {0xD686619BA27255A2, 0xC80A537B0EFEFEBD},
+            {0x8613FD0145877585, 0xBD06742CE95F5F36},
+            {0xA798FC4196E952E7, 0x2C48113823B73704},
+            {0xD17F3B51FCA3A7A0, 0xF75A15862CA504C5},
+            {0x82EF85133DE648C4, 0x9A984D73DBE722FB},
+            {0xA3AB66580D5FDAF5, 0xC13E60D0D2E0EBBA},
+            {0xCC963FEE10B7D1B3, 0x318DF905079926A8},
+            {0xFFBBCFE994E5C61F, 0xFDF17746497F7052},
+            {0x9FD561F1FD0F9BD3, 0xFEB6EA8BEDEFA633},
+            {0xC7CABA6E7C5382C8, 0xFE64A52EE96B8FC0},
+            {0xF9BD690A1B68637B, 0x3DFDCE7AA3C673B0},
+            {0x9C1661A651213E2D, 0x06BEA10CA65C084E},
+            {0xC31BFA0FE5698DB8, 0x486E494FCFF30A62},
+            {0xF3E2F893DEC3F126, 0x5A89DBA3C3EFCCFA},
+            {0x986DDB5C6B3A76B7, 0xF89629465A75E01C},
+            {0xBE89523386091465, 0xF6BBB397F1135823},
+            {0xEE2BA6C0678B597F, 0x746AA07DED582E2C},
+            {0x94DB483840B717EF, 0xA8C2A44EB4571CDC},
+            {0xBA121A4650E4DDEB, 0x92F34D62616CE413},
+            {0xE896A0D7E51E1566, 0x77B020BAF9C81D17},
+            {0x915E2486EF32CD60, 0x0ACE1474DC1D122E},
+            {0xB5B5ADA8AAFF80B8, 0x0D819992132456BA},
+            {0xE3231912D5BF60E6, 0x10E1FFF697ED6C69},
+            {0x8DF5EFABC5979C8F, 0xCA8D3FFA1EF463C1},
+            {0xB1736B96B6FD83B3, 0xBD308FF8A6B17CB2},
+            {0xDDD0467C64BCE4A0, 0xAC7CB3F6D05DDBDE},
+            {0x8AA22C0DBEF60EE4, 0x6BCDF07A423AA96B},
+            {0xAD4AB7112EB3929D, 0x86C16C98D2C953C6},
+            {0xD89D64D57A607744, 0xE871C7BF077BA8B7},
+            {0x87625F056C7C4A8B, 0x11471CD764AD4972},
+            {0xA93AF6C6C79B5D2D, 0xD598E40D3DD89BCF},
+            {0xD389B47879823479, 0x4AFF1D108D4EC2C3},
+            {0x843610CB4BF160CB, 0xCEDF722A585139BA},
+            {0xA54394FE1EEDB8FE, 0xC2974EB4EE658828},
+            {0xCE947A3DA6A9273E, 0x733D226229FEEA32},
+            {0x811CCC668829B887, 0x0806357D5A3F525F},
+            {0xA163FF802A3426A8, 0xCA07C2DCB0CF26F7},
+            {0xC9BCFF6034C13052, 0xFC89B393DD02F0B5},
+            {0xFC2C3F3841F17C67, 0xBBAC2078D443ACE2},
+            {0x9D9BA7832936EDC0, 0xD54B944B84AA4C0D},
+            {0xC5029163F384A931, 0x0A9E795E65D4DF11},
+            {0xF64335BCF065D37D, 0x4D4617B5FF4A16D5},
+            {0x99EA0196163FA42E, 0x504BCED1BF8E4E45},
+            {0xC06481FB9BCF8D39, 0xE45EC2862F71E1D6},
+            {0xF07DA27A82C37088, 0x5D767327BB4E5A4C},
+            {0x964E858C91BA2655, 0x3A6A07F8D510F86F},
+            {0xBBE226EFB628AFEA, 0x890489F70A55368B},
+            {0xEADAB0ABA3B2DBE5, 0x2B45AC74CCEA842E},
+            {0x92C8AE6B464FC96F, 0x3B0B8BC90012929D},
+            {0xB77ADA0617E3BBCB, 0x09CE6EBB40173744},
+            {0xE55990879DDCAABD, 0xCC420A6A101D0515},
+            {0x8F57FA54C2A9EAB6, 0x9FA946824A12232D},
+            {0xB32DF8E9F3546564, 0x47939822DC96ABF9},
+            {0xDFF9772470297EBD, 0x59787E2B93BC56F7},
+            {0x8BFBEA76C619EF36, 0x57EB4EDB3C55B65A},
+            {0xAEFAE51477A06B03, 0xEDE622920B6B23F1},
+            {0xDAB99E59958885C4, 0xE95FAB368E45ECED},
+            {0x88B402F7FD75539B, 0x11DBCB0218EBB414},
+            {0xAAE103B5FCD2A881, 0xD652BDC29F26A119},
+            {0xD59944A37C0752A2, 0x4BE76D3346F0495F},
+            {0x857FCAE62D8493A5, 0x6F70A4400C562DDB},
+            {0xA6DFBD9FB8E5B88E, 0xCB4CCD500F6BB952},
+            {0xD097AD07A71F26B2, 0x7E2000A41346A7A7},
+            {0x825ECC24C873782F, 0x8ED400668C0C28C8},
+            {0xA2F67F2DFA90563B, 0x728900802F0F32FA},
+            {0xCBB41EF979346BCA, 0x4F2B40A03AD2FFB9},
+            {0xFEA126B7D78186BC, 0xE2F610C84987BFA8},
+            {0x9F24B832E6B0F436, 0x0DD9CA7D2DF4D7C9},
+            {0xC6EDE63FA05D3143, 0x91503D1C79720DBB},
+            {0xF8A95FCF88747D94, 0x75A44C6397CE912A},
+            {0x9B69DBE1B548CE7C, 0xC986AFBE3EE11ABA},
+            {0xC24452DA229B021B, 0xFBE85BADCE996168},
+            {0xF2D56790AB41C2A2, 0xFAE27299423FB9C3},
+            {0x97C560BA6B0919A5, 0xDCCD879FC967D41A},
+            {0xBDB6B8E905CB600F, 0x5400E987BBC1C920},
+            {0xED246723473E3813, 0x290123E9AAB23B68},
+            {0x9436C0760C86E30B, 0xF9A0B6720AAF6521},
+            {0xB94470938FA89BCE, 0xF808E40E8D5B3E69},
+            {0xE7958CB87392C2C2, 0xB60B1D1230B20E04},
+            {0x90BD77F3483BB9B9, 0xB1C6F22B5E6F48C2},
+            {0xB4ECD5F01A4AA828, 0x1E38AEB6360B1AF3},
+            {0xE2280B6C20DD5232, 0x25C6DA63C38DE1B0},
+            {0x8D590723948A535F, 0x579C487E5A38AD0E},
+            {0xB0AF48EC79ACE837, 0x2D835A9DF0C6D851},
+            {0xDCDB1B2798182244, 0xF8E431456CF88E65},
+            {0x8A08F0F8BF0F156B, 0x1B8E9ECB641B58FF},
+            {0xAC8B2D36EED2DAC5, 0xE272467E3D222F3F},
+            {0xD7ADF884AA879177, 0x5B0ED81DCC6ABB0F},
+            {0x86CCBB52EA94BAEA, 0x98E947129FC2B4E9},
+            {0xA87FEA27A539E9A5, 0x3F2398D747B36224},
+            {0xD29FE4B18E88640E, 0x8EEC7F0D19A03AAD},
+            {0x83A3EEEEF9153E89, 0x1953CF68300424AC},
+            {0xA48CEAAAB75A8E2B, 0x5FA8C3423C052DD7},
+            {0xCDB02555653131B6, 0x3792F412CB06794D},
+            {0x808E17555F3EBF11, 0xE2BBD88BBEE40BD0},
+            {0xA0B19D2AB70E6ED6, 0x5B6ACEAEAE9D0EC4},
+            {0xC8DE047564D20A8B, 0xF245825A5A445275},
+            {0xFB158592BE068D2E, 0xEED6E2F0F0D56712},
+            {0x9CED737BB6C4183D, 0x55464DD69685606B},
+            {0xC428D05AA4751E4C, 0xAA97E14C3C26B886},
+            {0xF53304714D9265DF, 0xD53DD99F4B3066A8},
+            {0x993FE2C6D07B7FAB, 0xE546A8038EFE4029},
+            {0xBF8FDB78849A5F96, 0xDE98520472BDD033},
+            {0xEF73D256A5C0F77C, 0x963E66858F6D4440},
+            {0x95A8637627989AAD, 0xDDE7001379A44AA8},
+            {0xBB127C53B17EC159, 0x5560C018580D5D52},
+            {0xE9D71B689DDE71AF, 0xAAB8F01E6E10B4A6},
+            {0x9226712162AB070D, 0xCAB3961304CA70E8},
+            {0xB6B00D69BB55C8D1, 0x3D607B97C5FD0D22},
+            {0xE45C10C42A2B3B05, 0x8CB89A7DB77C506A},
+            {0x8EB98A7A9A5B04E3, 0x77F3608E92ADB242},
+            {0xB267ED1940F1C61C, 0x55F038B237591ED3},
+            {0xDF01E85F912E37A3, 0x6B6C46DEC52F6688},
+            {0x8B61313BBABCE2C6, 0x2323AC4B3B3DA015},
+            {0xAE397D8AA96C1B77, 0xABEC975E0A0D081A},
+            {0xD9C7DCED53C72255, 0x96E7BD358C904A21},
+            {0x881CEA14545C7575, 0x7E50D64177DA2E54},
+            {0xAA242499697392D2, 0xDDE50BD1D5D0B9E9},
+            {0xD4AD2DBFC3D07787, 0x955E4EC64B44E864},
+            {0x84EC3C97DA624AB4, 0xBD5AF13BEF0B113E},
+            {0xA6274BBDD0FADD61, 0xECB1AD8AEACDD58E},
+            {0xCFB11EAD453994BA, 0x67DE18EDA5814AF2},
+            {0x81CEB32C4B43FCF4, 0x80EACF948770CED7},
+            {0xA2425FF75E14FC31, 0xA1258379A94D028D},
+            {0xCAD2F7F5359A3B3E, 0x096EE45813A04330},
+            {0xFD87B5F28300CA0D, 0x8BCA9D6E188853FC},
+            {0x9E74D1B791E07E48, 0x775EA264CF55347D},
+            {0xC612062576589DDA, 0x95364AFE032A819D},
+            {0xF79687AED3EEC551, 0x3A83DDBD83F52204},
+            {0x9ABE14CD44753B52, 0xC4926A9672793542},
+            {0xC16D9A0095928A27, 0x75B7053C0F178293},
+            {0xF1C90080BAF72CB1, 0x5324C68B12DD6338},
+            {0x971DA05074DA7BEE, 0xD3F6FC16EBCA5E03},
+            {0xBCE5086492111AEA, 0x88F4BB1CA6BCF584},
+            {0xEC1E4A7DB69561A5, 0x2B31E9E3D06C32E5},
+            {0x9392EE8E921D5D07, 0x3AFF322E62439FCF},
+            {0xB877AA3236A4B449, 0x09BEFEB9FAD487C2},
+            {0xE69594BEC44DE15B, 0x4C2EBE687989A9B3},
+            {0x901D7CF73AB0ACD9, 0x0F9D37014BF60A10},
+            {0xB424DC35095CD80F, 0x538484C19EF38C94},
+            {0xE12E13424BB40E13, 0x2865A5F206B06FB9},
+            {0x8CBCCC096F5088CB, 0xF93F87B7442E45D3},
+            {0xAFEBFF0BCB24AAFE, 0xF78F69A51539D748},
+            {0xDBE6FECEBDEDD5BE, 0xB573440E5A884D1B},
+            {0x89705F4136B4A597, 0x31680A88F8953030},
+            {0xABCC77118461CEFC, 0xFDC20D2B36BA7C3D},
+            {0xD6BF94D5E57A42BC, 0x3D32907604691B4C},
+            {0x8637BD05AF6C69B5, 0xA63F9A49C2C1B10F},
+            {0xA7C5AC471B478423, 0x0FCF80DC33721D53},
+            {0xD1B71758E219652B, 0xD3C36113404EA4A8},
+            {0x83126E978D4FDF3B, 0x645A1CAC083126E9},
+            {0xA3D70A3D70A3D70A, 0x3D70A3D70A3D70A3},
+            {0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCC},
+            {0x8000000000000000, 0x0000000000000000},
+            {0xA000000000000000, 0x0000000000000000},
+            {0xC800000000000000, 0x0000000000000000},
+            {0xFA00000000000000, 0x0000000000000000},
+            {0x9C40000000000000, 0x0000000000000000},
+            {0xC350000000000000, 0x0000000000000000},
+            {0xF424000000000000, 0x0000000000000000},
+            {0x9896800000000000, 0x0000000000000000},
+            {0xBEBC200000000000, 0x0000000000000000},
+            {0xEE6B280000000000, 0x0000000000000000},
+            {0x9502F90000000000, 0x0000000000000000},
+            {0xBA43B74000000000, 0x0000000000000000},
+            {0xE8D4A51000000000, 0x0000000000000000},
+            {0x9184E72A00000000, 0x0000000000000000},
+            {0xB5E620F480000000, 0x0000000000000000},
+            {0xE35FA931A0000000, 0x0000000000000000},
+            {0x8E1BC9BF04000000, 0x0000000000000000},
+            {0xB1A2BC2EC5000000, 0x0000000000000000},
+            {0xDE0B6B3A76400000, 0x0000000000000000},
+            {0x8AC7230489E80000, 0x0000000000000000},
+            {0xAD78EBC5AC620000, 0x0000000000000000},
+            {0xD8D726B7177A8000, 0x0000000000000000},
+            {0x878678326EAC9000, 0x0000000000000000},
+            {0xA968163F0A57B400, 0x0000000000000000},
+            {0xD3C21BCECCEDA100, 0x0000000000000000},
+            {0x84595161401484A0, 0x0000000000000000},
+            {0xA56FA5B99019A5C8, 0x0000000000000000},
+            {0xCECB8F27F4200F3A, 0x0000000000000000},
+            {0x813F3978F8940984, 0x4000000000000000},
+            {0xA18F07D736B90BE5, 0x5000000000000000},
+            {0xC9F2C9CD04674EDE, 0xA400000000000000},
+            {0xFC6F7C4045812296, 0x4D00000000000000},
+            {0x9DC5ADA82B70B59D, 0xF020000000000000},
+            {0xC5371912364CE305, 0x6C28000000000000},
+            {0xF684DF56C3E01BC6, 0xC732000000000000},
+            {0x9A130B963A6C115C, 0x3C7F400000000000},
+            {0xC097CE7BC90715B3, 0x4B9F100000000000},
+            {0xF0BDC21ABB48DB20, 0x1E86D40000000000},
+            {0x96769950B50D88F4, 0x1314448000000000},
+            {0xBC143FA4E250EB31, 0x17D955A000000000},
+            {0xEB194F8E1AE525FD, 0x5DCFAB0800000000},
+            {0x92EFD1B8D0CF37BE, 0x5AA1CAE500000000},
+            {0xB7ABC627050305AD, 0xF14A3D9E40000000},
+            {0xE596B7B0C643C719, 0x6D9CCD05D0000000},
+            {0x8F7E32CE7BEA5C6F, 0xE4820023A2000000},
+            {0xB35DBF821AE4F38B, 0xDDA2802C8A800000},
+            {0xE0352F62A19E306E, 0xD50B2037AD200000},
+            {0x8C213D9DA502DE45, 0x4526F422CC340000},
+            {0xAF298D050E4395D6, 0x9670B12B7F410000},
+            {0xDAF3F04651D47B4C, 0x3C0CDD765F114000},
+            {0x88D8762BF324CD0F, 0xA5880A69FB6AC800},
+            {0xAB0E93B6EFEE0053, 0x8EEA0D047A457A00},
+            {0xD5D238A4ABE98068, 0x72A4904598D6D880},
+            {0x85A36366EB71F041, 0x47A6DA2B7F864750},
+            {0xA70C3C40A64E6C51, 0x999090B65F67D924},
+            {0xD0CF4B50CFE20765, 0xFFF4B4E3F741CF6D},
+            {0x82818F1281ED449F, 0xBFF8F10E7A8921A4},
+            {0xA321F2D7226895C7, 0xAFF72D52192B6A0D},
+            {0xCBEA6F8CEB02BB39, 0x9BF4F8A69F764490},
+            {0xFEE50B7025C36A08, 0x02F236D04753D5B4},
+            {0x9F4F2726179A2245, 0x01D762422C946590},
+            {0xC722F0EF9D80AAD6, 0x424D3AD2B7B97EF5},
+            {0xF8EBAD2B84E0D58B, 0xD2E0898765A7DEB2},
+            {0x9B934C3B330C8577, 0x63CC55F49F88EB2F},
+            {0xC2781F49FFCFA6D5, 0x3CBF6B71C76B25FB},
+            {0xF316271C7FC3908A, 0x8BEF464E3945EF7A},
+            {0x97EDD871CFDA3A56, 0x97758BF0E3CBB5AC},
+            {0xBDE94E8E43D0C8EC, 0x3D52EEED1CBEA317},
+            {0xED63A231D4C4FB27, 0x4CA7AAA863EE4BDD},
+            {0x945E455F24FB1CF8, 0x8FE8CAA93E74EF6A},
+            {0xB975D6B6EE39E436, 0xB3E2FD538E122B44},
+            {0xE7D34C64A9C85D44, 0x60DBBCA87196B616},
+            {0x90E40FBEEA1D3A4A, 0xBC8955E946FE31CD},
+            {0xB51D13AEA4A488DD, 0x6BABAB6398BDBE41},
+            {0xE264589A4DCDAB14, 0xC696963C7EED2DD1},
+            {0x8D7EB76070A08AEC, 0xFC1E1DE5CF543CA2},
+            {0xB0DE65388CC8ADA8, 0x3B25A55F43294BCB},
+            {0xDD15FE86AFFAD912, 0x49EF0EB713F39EBE},
+            {0x8A2DBF142DFCC7AB, 0x6E3569326C784337},
+            {0xACB92ED9397BF996, 0x49C2C37F07965404},
+            {0xD7E77A8F87DAF7FB, 0xDC33745EC97BE906},
+            {0x86F0AC99B4E8DAFD, 0x69A028BB3DED71A3},
+            {0xA8ACD7C0222311BC, 0xC40832EA0D68CE0C},
+            {0xD2D80DB02AABD62B, 0xF50A3FA490C30190},
+            {0x83C7088E1AAB65DB, 0x792667C6DA79E0FA},
+            {0xA4B8CAB1A1563F52, 0x577001B891185938},
+            {0xCDE6FD5E09ABCF26, 0xED4C0226B55E6F86},
+            {0x80B05E5AC60B6178, 0x544F8158315B05B4},
+            {0xA0DC75F1778E39D6, 0x696361AE3DB1C721},
+            {0xC913936DD571C84C, 0x03BC3A19CD1E38E9},
+            {0xFB5878494ACE3A5F, 0x04AB48A04065C723},
+            {0x9D174B2DCEC0E47B, 0x62EB0D64283F9C76},
+            {0xC45D1DF942711D9A, 0x3BA5D0BD324F8394},
+            {0xF5746577930D6500, 0xCA8F44EC7EE36479},
+            {0x9968BF6ABBE85F20, 0x7E998B13CF4E1ECB},
+            {0xBFC2EF456AE276E8, 0x9E3FEDD8C321A67E},
+            {0xEFB3AB16C59B14A2, 0xC5CFE94EF3EA101E},
+            {0x95D04AEE3B80ECE5, 0xBBA1F1D158724A12},
+            {0xBB445DA9CA61281F, 0x2A8A6E45AE8EDC97},
+            {0xEA1575143CF97226, 0xF52D09D71A3293BD},
+            {0x924D692CA61BE758, 0x593C2626705F9C56},
+            {0xB6E0C377CFA2E12E, 0x6F8B2FB00C77836C},
+            {0xE498F455C38B997A, 0x0B6DFB9C0F956447},
+            {0x8EDF98B59A373FEC, 0x4724BD4189BD5EAC},
+            {0xB2977EE300C50FE7, 0x58EDEC91EC2CB657},
+            {0xDF3D5E9BC0F653E1, 0x2F2967B66737E3ED},
+            {0x8B865B215899F46C, 0xBD79E0D20082EE74},
+            {0xAE67F1E9AEC07187, 0xECD8590680A3AA11},
+            {0xDA01EE641A708DE9, 0xE80E6F4820CC9495},
+            {0x884134FE908658B2, 0x3109058D147FDCDD},
+            {0xAA51823E34A7EEDE, 0xBD4B46F0599FD415},
+            {0xD4E5E2CDC1D1EA96, 0x6C9E18AC7007C91A},
+            {0x850FADC09923329E, 0x03E2CF6BC604DDB0},
+            {0xA6539930BF6BFF45, 0x84DB8346B786151C},
+            {0xCFE87F7CEF46FF16, 0xE612641865679A63},
+            {0x81F14FAE158C5F6E, 0x4FCB7E8F3F60C07E},
+            {0xA26DA3999AEF7749, 0xE3BE5E330F38F09D},
+            {0xCB090C8001AB551C, 0x5CADF5BFD3072CC5},
+            {0xFDCB4FA002162A63, 0x73D9732FC7C8F7F6},
+            {0x9E9F11C4014DDA7E, 0x2867E7FDDCDD9AFA},
+            {0xC646D63501A1511D, 0xB281E1FD541501B8},
+            {0xF7D88BC24209A565, 0x1F225A7CA91A4226},
+            {0x9AE757596946075F, 0x3375788DE9B06958},
+            {0xC1A12D2FC3978937, 0x0052D6B1641C83AE},
+            {0xF209787BB47D6B84, 0xC0678C5DBD23A49A},
+            {0x9745EB4D50CE6332, 0xF840B7BA963646E0},
+            {0xBD176620A501FBFF, 0xB650E5A93BC3D898},
+            {0xEC5D3FA8CE427AFF, 0xA3E51F138AB4CEBE},
+            {0x93BA47C980E98CDF, 0xC66F336C36B10137},
+            {0xB8A8D9BBE123F017, 0xB80B0047445D4184},
+            {0xE6D3102AD96CEC1D, 0xA60DC059157491E5},
+            {0x9043EA1AC7E41392, 0x87C89837AD68DB2F},
+            {0xB454E4A179DD1877, 0x29BABE4598C311FB},
+            {0xE16A1DC9D8545E94, 0xF4296DD6FEF3D67A},
+            {0x8CE2529E2734BB1D, 0x1899E4A65F58660C},
+            {0xB01AE745B101E9E4, 0x5EC05DCFF72E7F8F},
+            {0xDC21A1171D42645D, 0x76707543F4FA1F73},
+            {0x899504AE72497EBA, 0x6A06494A791C53A8},
+            {0xABFA45DA0EDBDE69, 0x0487DB9D17636892},
+            {0xD6F8D7509292D603, 0x45A9D2845D3C42B6},
+            {0x865B86925B9BC5C2, 0x0B8A2392BA45A9B2},
+            {0xA7F26836F282B732, 0x8E6CAC7768D7141E},
+            {0xD1EF0244AF2364FF, 0x3207D795430CD926},
+            {0x8335616AED761F1F, 0x7F44E6BD49E807B8},
+            {0xA402B9C5A8D3A6E7, 0x5F16206C9C6209A6},
+            {0xCD036837130890A1, 0x36DBA887C37A8C0F},
+            {0x802221226BE55A64, 0xC2494954DA2C9789},
+            {0xA02AA96B06DEB0FD, 0xF2DB9BAA10B7BD6C},
+            {0xC83553C5C8965D3D, 0x6F92829494E5ACC7},
+            {0xFA42A8B73ABBF48C, 0xCB772339BA1F17F9},
+            {0x9C69A97284B578D7, 0xFF2A760414536EFB},
+            {0xC38413CF25E2D70D, 0xFEF5138519684ABA},
+            {0xF46518C2EF5B8CD1, 0x7EB258665FC25D69},
+            {0x98BF2F79D5993802, 0xEF2F773FFBD97A61},
+            {0xBEEEFB584AFF8603, 0xAAFB550FFACFD8FA},
+            {0xEEAABA2E5DBF6784, 0x95BA2A53F983CF38},
+            {0x952AB45CFA97A0B2, 0xDD945A747BF26183},
+            {0xBA756174393D88DF, 0x94F971119AEEF9E4},
+            {0xE912B9D1478CEB17, 0x7A37CD5601AAB85D},
+            {0x91ABB422CCB812EE, 0xAC62E055C10AB33A},
+            {0xB616A12B7FE617AA, 0x577B986B314D6009},
+            {0xE39C49765FDF9D94, 0xED5A7E85FDA0B80B},
+            {0x8E41ADE9FBEBC27D, 0x14588F13BE847307},
+            {0xB1D219647AE6B31C, 0x596EB2D8AE258FC8},
+            {0xDE469FBD99A05FE3, 0x6FCA5F8ED9AEF3BB},
+            {0x8AEC23D680043BEE, 0x25DE7BB9480D5854},
+            {0xADA72CCC20054AE9, 0xAF561AA79A10AE6A},
+            {0xD910F7FF28069DA4, 0x1B2BA1518094DA04},
+            {0x87AA9AFF79042286, 0x90FB44D2F05D0842},
+            {0xA99541BF57452B28, 0x353A1607AC744A53},
+            {0xD3FA922F2D1675F2, 0x42889B8997915CE8},
+            {0x847C9B5D7C2E09B7, 0x69956135FEBADA11},
+            {0xA59BC234DB398C25, 0x43FAB9837E699095},
+            {0xCF02B2C21207EF2E, 0x94F967E45E03F4BB},
+            {0x8161AFB94B44F57D, 0x1D1BE0EEBAC278F5},
+            {0xA1BA1BA79E1632DC, 0x6462D92A69731732},
+            {0xCA28A291859BBF93, 0x7D7B8F7503CFDCFE},
+            {0xFCB2CB35E702AF78, 0x5CDA735244C3D43E},
+            {0x9DEFBF01B061ADAB, 0x3A0888136AFA64A7},
+            {0xC56BAEC21C7A1916, 0x088AAA1845B8FDD0},
+            {0xF6C69A72A3989F5B, 0x8AAD549E57273D45},
+            {0x9A3C2087A63F6399, 0x36AC54E2F678864B},
+            {0xC0CB28A98FCF3C7F, 0x84576A1BB416A7DD},
+            {0xF0FDF2D3F3C30B9F, 0x656D44A2A11C51D5},
+            {0x969EB7C47859E743, 0x9F644AE5A4B1B325},
+            {0xBC4665B596706114, 0x873D5D9F0DDE1FEE},
+            {0xEB57FF22FC0C7959, 0xA90CB506D155A7EA},
+            {0x9316FF75DD87CBD8, 0x09A7F12442D588F2},
+            {0xB7DCBF5354E9BECE, 0x0C11ED6D538AEB2F},
+            {0xE5D3EF282A242E81, 0x8F1668C8A86DA5FA},
+            {0x8FA475791A569D10, 0xF96E017D694487BC},
+            {0xB38D92D760EC4455, 0x37C981DCC395A9AC},
+            {0xE070F78D3927556A, 0x85BBE253F47B1417},
+            {0x8C469AB843B89562, 0x93956D7478CCEC8E},
+            {0xAF58416654A6BABB, 0x387AC8D1970027B2},
+            {0xDB2E51BFE9D0696A, 0x06997B05FCC0319E},
+            {0x88FCF317F22241E2, 0x441FECE3BDF81F03},
+            {0xAB3C2FDDEEAAD25A, 0xD527E81CAD7626C3},
+            {0xD60B3BD56A5586F1, 0x8A71E223D8D3B074},
+            {0x85C7056562757456, 0xF6872D5667844E49},
+            {0xA738C6BEBB12D16C, 0xB428F8AC016561DB},
+            {0xD106F86E69D785C7, 0xE13336D701BEBA52},
+            {0x82A45B450226B39C, 0xECC0024661173473},
+            {0xA34D721642B06084, 0x27F002D7F95D0190},
+            {0xCC20CE9BD35C78A5, 0x31EC038DF7B441F4},
+            {0xFF290242C83396CE, 0x7E67047175A15271},
+            {0x9F79A169BD203E41, 0x0F0062C6E984D386},
+            {0xC75809C42C684DD1, 0x52C07B78A3E60868},
+            {0xF92E0C3537826145, 0xA7709A56CCDF8A82},
+            {0x9BBCC7A142B17CCB, 0x88A66076400BB691},
+            {0xC2ABF989935DDBFE, 0x6ACFF893D00EA435},
+            {0xF356F7EBF83552FE, 0x0583F6B8C4124D43},
+            {0x98165AF37B2153DE, 0xC3727A337A8B704A},
+            {0xBE1BF1B059E9A8D6, 0x744F18C0592E4C5C},
+            {0xEDA2EE1C7064130C, 0x1162DEF06F79DF73},
+            {0x9485D4D1C63E8BE7, 0x8ADDCB5645AC2BA8},
+            {0xB9A74A0637CE2EE1, 0x6D953E2BD7173692},
+            {0xE8111C87C5C1BA99, 0xC8FA8DB6CCDD0437},
+            {0x910AB1D4DB9914A0, 0x1D9C9892400A22A2},
+            {0xB54D5E4A127F59C8, 0x2503BEB6D00CAB4B},
+            {0xE2A0B5DC971F303A, 0x2E44AE64840FD61D},
+            {0x8DA471A9DE737E24, 0x5CEAECFED289E5D2},
+            {0xB10D8E1456105DAD, 0x7425A83E872C5F47},
+            {0xDD50F1996B947518, 0xD12F124E28F77719},
+            {0x8A5296FFE33CC92F, 0x82BD6B70D99AAA6F},
+            {0xACE73CBFDC0BFB7B, 0x636CC64D1001550B},
+            {0xD8210BEFD30EFA5A, 0x3C47F7E05401AA4E},
+            {0x8714A775E3E95C78, 0x65ACFAEC34810A71},
+            {0xA8D9D1535CE3B396, 0x7F1839A741A14D0D},
+            {0xD31045A8341CA07C, 0x1EDE48111209A050},
+            {0x83EA2B892091E44D, 0x934AED0AAB460432},
+            {0xA4E4B66B68B65D60, 0xF81DA84D5617853F},
+            {0xCE1DE40642E3F4B9, 0x36251260AB9D668E},
+            {0x80D2AE83E9CE78F3, 0xC1D72B7C6B426019},
+            {0xA1075A24E4421730, 0xB24CF65B8612F81F},
+            {0xC94930AE1D529CFC, 0xDEE033F26797B627},
+            {0xFB9B7CD9A4A7443C, 0x169840EF017DA3B1},
+            {0x9D412E0806E88AA5, 0x8E1F289560EE864E},
+            {0xC491798A08A2AD4E, 0xF1A6F2BAB92A27E2},
+            {0xF5B5D7EC8ACB58A2, 0xAE10AF696774B1DB},
+            {0x9991A6F3D6BF1765, 0xACCA6DA1E0A8EF29},
+            {0xBFF610B0CC6EDD3F, 0x17FD090A58D32AF3},
+            {0xEFF394DCFF8A948E, 0xDDFC4B4CEF07F5B0},
+            {0x95F83D0A1FB69CD9, 0x4ABDAF101564F98E},
+            {0xBB764C4CA7A4440F, 0x9D6D1AD41ABE37F1},
+            {0xEA53DF5FD18D5513, 0x84C86189216DC5ED},
+            {0x92746B9BE2F8552C, 0x32FD3CF5B4E49BB4},
+            {0xB7118682DBB66A77, 0x3FBC8C33221DC2A1},
+            {0xE4D5E82392A40515, 0x0FABAF3FEAA5334A},
+            {0x8F05B1163BA6832D, 0x29CB4D87F2A7400E},
+            {0xB2C71D5BCA9023F8, 0x743E20E9EF511012},
+            {0xDF78E4B2BD342CF6, 0x914DA9246B255416},
+            {0x8BAB8EEFB6409C1A, 0x1AD089B6C2F7548E},
+            {0xAE9672ABA3D0C320, 0xA184AC2473B529B1},
+            {0xDA3C0F568CC4F3E8, 0xC9E5D72D90A2741E},
+            {0x8865899617FB1871, 0x7E2FA67C7A658892},
+            {0xAA7EEBFB9DF9DE8D, 0xDDBB901B98FEEAB7},
+            {0xD51EA6FA85785631, 0x552A74227F3EA565},
+            {0x8533285C936B35DE, 0xD53A88958F87275F},
+            {0xA67FF273B8460356, 0x8A892ABAF368F137},
+            {0xD01FEF10A657842C, 0x2D2B7569B0432D85},
+            {0x8213F56A67F6B29B, 0x9C3B29620E29FC73},
+            {0xA298F2C501F45F42, 0x8349F3BA91B47B8F},
+            {0xCB3F2F7642717713, 0x241C70A936219A73},
+            {0xFE0EFB53D30DD4D7, 0xED238CD383AA0110},
+            {0x9EC95D1463E8A506, 0xF4363804324A40AA},
+            {0xC67BB4597CE2CE48, 0xB143C6053EDCD0D5},
+            {0xF81AA16FDC1B81DA, 0xDD94B7868E94050A},
+            {0x9B10A4E5E9913128, 0xCA7CF2B4191C8326},
+            {0xC1D4CE1F63F57D72, 0xFD1C2F611F63A3F0},
+            {0xF24A01A73CF2DCCF, 0xBC633B39673C8CEC},
+            {0x976E41088617CA01, 0xD5BE0503E085D813},
+            {0xBD49D14AA79DBC82, 0x4B2D8644D8A74E18},
+            {0xEC9C459D51852BA2, 0xDDF8E7D60ED1219E},
+            {0x93E1AB8252F33B45, 0xCABB90E5C942B503},
+            {0xB8DA1662E7B00A17, 0x3D6A751F3B936243},
+            {0xE7109BFBA19C0C9D, 0x0CC512670A783AD4},
+            {0x906A617D450187E2, 0x27FB2B80668B24C5},
+            {0xB484F9DC9641E9DA, 0xB1F9F660802DEDF6},
+            {0xE1A63853BBD26451, 0x5E7873F8A0396973},
+            {0x8D07E33455637EB2, 0xDB0B487B6423E1E8},
+            {0xB049DC016ABC5E5F, 0x91CE1A9A3D2CDA62},
+            {0xDC5C5301C56B75F7, 0x7641A140CC7810FB},
+            {0x89B9B3E11B6329BA, 0xA9E904C87FCB0A9D},
+            {0xAC2820D9623BF429, 0x546345FA9FBDCD44},
+            {0xD732290FBACAF133, 0xA97C177947AD4095},
+            {0x867F59A9D4BED6C0, 0x49ED8EABCCCC485D},
+            {0xA81F301449EE8C70, 0x5C68F256BFFF5A74},
+            {0xD226FC195C6A2F8C, 0x73832EEC6FFF3111},
+            {0x83585D8FD9C25DB7, 0xC831FD53C5FF7EAB},
+            {0xA42E74F3D032F525, 0xBA3E7CA8B77F5E55},
+            {0xCD3A1230C43FB26F, 0x28CE1BD2E55F35EB},
+            {0x80444B5E7AA7CF85, 0x7980D163CF5B81B3},
+            {0xA0555E361951C366, 0xD7E105BCC332621F},
+            {0xC86AB5C39FA63440, 0x8DD9472BF3FEFAA7},
+            {0xFA856334878FC150, 0xB14F98F6F0FEB951},
+            {0x9C935E00D4B9D8D2, 0x6ED1BF9A569F33D3},
+            {0xC3B8358109E84F07, 0x0A862F80EC4700C8},
+            {0xF4A642E14C6262C8, 0xCD27BB612758C0FA},
+            {0x98E7E9CCCFBD7DBD, 0x8038D51CB897789C},
+            {0xBF21E44003ACDD2C, 0xE0470A63E6BD56C3},
+            {0xEEEA5D5004981478, 0x1858CCFCE06CAC74},
+            {0x95527A5202DF0CCB, 0x0F37801E0C43EBC8},
+            {0xBAA718E68396CFFD, 0xD30560258F54E6BA},
+            {0xE950DF20247C83FD, 0x47C6B82EF32A2069},
+            {0x91D28B7416CDD27E, 0x4CDC331D57FA5441},
+            {0xB6472E511C81471D, 0xE0133FE4ADF8E952},
+            {0xE3D8F9E563A198E5, 0x58180FDDD97723A6},
+            {0x8E679C2F5E44FF8F, 0x570F09EAA7EA7648},
+            {0xB201833B35D63F73, 0x2CD2CC6551E513DA},
+            {0xDE81E40A034BCF4F, 0xF8077F7EA65E58D1},
+            {0x8B112E86420F6191, 0xFB04AFAF27FAF782},
+            {0xADD57A27D29339F6, 0x79C5DB9AF1F9B563},
+            {0xD94AD8B1C7380874, 0x18375281AE7822BC},
+            {0x87CEC76F1C830548, 0x8F2293910D0B15B5},
+            {0xA9C2794AE3A3C69A, 0xB2EB3875504DDB22},
+            {0xD433179D9C8CB841, 0x5FA60692A46151EB},
+            {0x849FEEC281D7F328, 0xDBC7C41BA6BCD333},
+            {0xA5C7EA73224DEFF3, 0x12B9B522906C0800},
+            {0xCF39E50FEAE16BEF, 0xD768226B34870A00},
+            {0x81842F29F2CCE375, 0xE6A1158300D46640},
+            {0xA1E53AF46F801C53, 0x60495AE3C1097FD0},
+            {0xCA5E89B18B602368, 0x385BB19CB14BDFC4},
+            {0xFCF62C1DEE382C42, 0x46729E03DD9ED7B5},
+            {0x9E19DB92B4E31BA9, 0x6C07A2C26A8346D1},
+            {0xC5A05277621BE293, 0xC7098B7305241885},
+            {0xF70867153AA2DB38, 0xB8CBEE4FC66D1EA7},
+        };
+
+        psh_internal psh_inline U128 pow_five_128(i32 exponent) psh_no_except {
+            psh_paranoid_validate_usage({
+                psh_assert(exponent >= POW_FIVE_128_MIN_EXPONENT);
+                psh_assert(exponent <= POW_FIVE_128_MAX_EXPONENT);
+            });
+            return POW_FIVE_128[exponent - POW_FIVE_128_MIN_EXPONENT];
+        }
+
+        psh_internal psh_inline U128 u128_increment(U128 value) psh_no_except {
+            value.low  += 1u;
+            value.high += static_cast<u64>(value.low == 0);
+            return value;
+        }
+
+        /// Get the number of decimal digits of a value, where zero has a single digit.
+        psh_internal psh_inline u32 decimal_digit_count(u64 value) psh_no_except {
+            // Setting the lowest bit never changes the digit count, but spares zero from being special.
+            u64 const nonzero   = value | 1u;
+            u32 const bit_width = 64u - bit_count_leading_zeros(nonzero);
+
+            // The digit count is either floor(log10(2^bit_width)) or the next integer, where the
+            // logarithm is approximated by 1233 / 4096.
+            u32 const guess = (bit_width * 1233u) >> 12;
+            return guess + static_cast<u32>(nonzero >= POW_TEN_U64[guess]);
+        }
+
+        /// Write the digits of a value from the end of a buffer towards its start, two at a time.
+        ///
+        /// Return: The start of the written digits.
+        psh_internal char* format_digits_backwards(char* end, u64 value) psh_no_except {
+            char* cursor = end;
+            while (value >= 100) {
+                u64 pair  = (value % 100) * 2u;
+                value    /= 100;
+                cursor   -= 2;
+                cursor[0] = DIGIT_PAIRS[pair];
+                cursor[1] = DIGIT_PAIRS[pair + 1];
+            }
+            if (value >= 10) {
+                cursor   -= 2;
+                cursor[0] = DIGIT_PAIRS[value * 2u];
+                cursor[1] = DIGIT_PAIRS[value * 2u + 1];
+            } else {
+                *(--cursor) = static_cast<char>('0' + value);
+            }
+            return cursor;
+        }
+
+        /// Decimal floating point number whose value is significand * 10^exponent.
+        struct DecimalFloat {
+            u64 significand;
+            i32 exponent;
+        };
+
+        /// Multiply a value by a 128-bit factor and keep the upper 64 bits of the 192-bit product,
+        /// setting the lowest bit of the result whenever the discarded bits are non-zero.
+        psh_internal psh_inline u64 multiply_round_to_odd(U128 factor, u64 value) psh_no_except {
+            U128 const low  = multiply_u64_full(factor.low, value);
+            U128       high = multiply_u64_full(factor.high, value);
+
+            high.low  += low.high;
+            high.high += static_cast<u64>(high.low < low.high);
+            return high.high | static_cast<u64>(high.low > 1u);
+        }
+
+        /// Find the shortest decimal number that rounds to a given finite and non-zero floating point
+        /// value, using the Schubfach algorithm by Raffaello Giulietti.
+        ///
+        /// Parameters:
+        ///     * ieee_significand: Explicit significand bits of the value.
+        ///     * ieee_exponent: Biased exponent bits of the value.
+        psh_internal DecimalFloat f64_to_shortest_decimal(u64 ieee_significand, u32 ieee_exponent) psh_no_except {
+            u64 c;
+            i32 q;
+            if (ieee_exponent != 0) {
+                c = (u64{1} << F64_SIGNIFICAND_BIT_COUNT) | ieee_significand;
+                q = static_cast<i32>(ieee_exponent) - F64_EXPONENT_BIAS - static_cast<i32>(F64_SIGNIFICAND_BIT_COUNT);
+
+                // Small integers are their own shortest representation.
+                if ((-static_cast<i32>(F64_SIGNIFICAND_BIT_COUNT) <= q) && (q <= 0)) {
+                    u64 const fraction_mask = (u64{1} << -q) - 1u;
+                    if ((c & fraction_mask) == 0) {
+                        return DecimalFloat{.significand = c >> -q, .exponent = 0};
+                    }
+                }
+            } else {
+                c = ieee_significand;
+                q = 1 - F64_EXPONENT_BIAS - static_cast<i32>(F64_SIGNIFICAND_BIT_COUNT);
+            }
+
+            // The interval of decimals rounding to the value is closed when the significand is even,
+            // due to ties being rounded to even.
+            bool const is_even                  = (c % 2u) == 0;
+            bool const lower_boundary_is_closer = (ieee_significand == 0) && (ieee_exponent > 1);
+
+            // Boundaries of the rounding interval and the value itself, scaled by 4.
+            u64 const cbl = 4u * c - 2u + static_cast<u64>(lower_boundary_is_closer);
+            u64 const cb  = 4u * c;
+            u64 const cbr = 4u * c + 2u;
+
+            // The decimal exponent floor(log10(2^q)), or floor(log10(3/4 * 2^q)) when the lower
+            // boundary is closer, and the binary exponent floor(log2(10^-k)) are computed as fixed
+            // point products.
+            i32 const k = (q * 1262611 - (lower_boundary_is_closer ? 524031 : 0)) >> 22;
+            i32 const h = q + ((-k * 1741647) >> 19) + 1;
+
+            // Upper approximation of 10^-k.
+            U128 const g = u128_increment(pow_five_128(-k));
+
+            u64 const vbl = multiply_round_to_odd(g, cbl << h);
+            u64 const vb  = multiply_round_to_odd(g, cb << h);
+            u64 const vbr = multiply_round_to_odd(g, cbr << h);
+
+            u64 const lower = vbl + static_cast<u64>(!is_even);
+            u64 const upper = vbr - static_cast<u64>(!is_even);
+
+            // Try a decimal with one less digit first. At most one of its neighbours lies in the
+            // rounding interval.
+            u64 const s = vb / 4u;
+            if (s >= 10) {
+                u64 const  sp        = s / 10u;
+                bool const up_inside = lower <= 40u * sp;
+                bool const wp_inside = 40u * sp + 40u <= upper;
+                if (up_inside != wp_inside) {
+                    return DecimalFloat{.significand = sp + static_cast<u64>(wp_inside), .exponent = k + 1};
+                }
+            }
+
+            bool const u_inside = lower <= 4u * s;
+            bool const w_inside = 4u * s + 4u <= upper;
+            if (u_inside != w_inside) {
+                return DecimalFloat{.significand = s + static_cast<u64>(w_inside), .exponent = k};
+            }
+
+            // Both neighbours are in the interval, pick the closest one.
+            u64 const  mid      = 4u * s + 2u;
+            bool const round_up = (vb > mid) || ((vb == mid) && ((s & 1u) != 0));
+            return DecimalFloat{.significand = s + static_cast<u64>(round_up), .exponent = k};
+        }
+    }  // namespace impl
+
+    // -------------------------------------------------------------------------------------------------
+    // Number formatting.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc usize format_u64(char* buf, u64 value) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(buf));
+
+        // Knowing the length upfront allows the digits to be written in place.
+        u32 const length = impl::decimal_digit_count(value);
+        psh_discard_value(impl::format_digits_backwards(buf + length, value));
+        return length;
+    }
+
+    psh_proc usize format_i64(char* buf, i64 value) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(buf));
+
+        if (value >= 0) {
+            return format_u64(buf, static_cast<u64>(value));
+        }
+
+        // Negate in unsigned arithmetic so that the minimum value doesn't overflow.
+        buf[0] = '-';
+        return 1u + format_u64(buf + 1, 0ull - static_cast<u64>(value));
+    }
+
+    psh_proc usize format_f64(char* buf, f64 value, u32 precision) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(buf));
+        psh_validate_usage(psh_assert_fmt(
+            precision <= FORMAT_FLOAT_MAX_PRECISION,
+            "Precision %u surpasses the maximum of %u fractional digits.",
+            precision,
+            FORMAT_FLOAT_MAX_PRECISION));
+
+        u64 const scale        = impl::POW_TEN_U64[precision];
+        f64 const magnitude    = (value < 0.0) ? -value : value;
+        f64 const scaled_value = magnitude * static_cast<f64>(scale) + 0.5;
+
+        // Past 2^53 the scaled value isn't exact anymore and its trailing digits would be wrong, so
+        // these, infinities and NaNs are left to the general formatting procedure. The comparison
+        // is false for NaNs.
+        if (!(scaled_value < 9007199254740992.0)) {
+            char tmp[FORMAT_FLOAT_MAX_LENGTH + 1];
+            i32  length = string_format(tmp, static_cast<i32>(sizeof(tmp)), "%.*f", static_cast<i32>(precision), value);
+            memory_copy(reinterpret_cast<u8*>(buf), reinterpret_cast<u8 const*>(tmp), static_cast<usize>(length));
+            return static_cast<usize>(length);
+        }
+
+        u64 scaled   = static_cast<u64>(scaled_value);
+        u64 integral = scaled / scale;
+        u64 fraction = scaled % scale;
+
+        usize length = 0;
+        if (value < 0.0) {
+            buf[length++] = '-';
+        }
+        length += format_u64(buf + length, integral);
+
+        if (precision != 0) {
+            buf[length++] = '.';
+
+            // Write the fractional digits with their leading zeros.
+            char* fraction_end = buf + length + precision;
+            char* cursor       = impl::format_digits_backwards(fraction_end, fraction);
+            while (cursor > buf + length) {
+                *(--cursor) = '0';
+            }
+            length += precision;
+        }
+
+        return length;
+    }
+
+    psh_proc usize format_f64_shortest(char* buf, f64 value) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(buf));
+
+        u64 const bits             = __builtin_bit_cast(u64, value);
+        u64 const ieee_significand = bits & impl::F64_SIGNIFICAND_MASK;
+        u32 const ieee_exponent    = static_cast<u32>(bits >> impl::F64_SIGNIFICAND_BIT_COUNT) & 0x7FFu;
+
+        if ((ieee_exponent == impl::F64_INFINITE_EXPONENT) && (ieee_significand != 0)) {
+            memory_copy(reinterpret_cast<u8*>(buf), reinterpret_cast<u8 const*>("nan"), 3);
+            return 3;
+        }
+
+        usize length = 0;
+        if ((bits >> 63) != 0) {
+            buf[length++] = '-';
+        }
+
+        if (ieee_exponent == impl::F64_INFINITE_EXPONENT) {
+            memory_copy(reinterpret_cast<u8*>(buf + length), reinterpret_cast<u8 const*>("inf"), 3);
+            return length + 3;
+        }
+        if ((ieee_exponent == 0) && (ieee_significand == 0)) {
+            buf[length++] = '0';
+            return length;
+        }
+
+        impl::DecimalFloat decimal = impl::f64_to_shortest_decimal(ieee_significand, ieee_exponent);
+        while ((decimal.significand % 10u) == 0) {
+            decimal.significand /= 10u;
+            decimal.exponent    += 1;
+        }
+
+        char      digits[FORMAT_INTEGER_MAX_LENGTH];
+        u32 const digit_count = impl::decimal_digit_count(decimal.significand);
+        psh_discard_value(impl::format_digits_backwards(digits + digit_count, decimal.significand));
+
+        // Position of the decimal point relative to the first digit.
+        i32 const point = static_cast<i32>(digit_count) + decimal.exponent;
+
+        u8*       dst        = reinterpret_cast<u8*>(buf);
+        u8 const* src_digits = reinterpret_cast<u8 const*>(digits);
+        if ((0 < point) && (point <= 21)) {
+            usize const integral_count = static_cast<usize>(point);
+            if (integral_count >= digit_count) {
+                memory_copy(dst + length, src_digits, digit_count);
+                memory_set(dst + length + digit_count, integral_count - digit_count, '0');
+                length += integral_count;
+            } else {
+                memory_copy(dst + length, src_digits, integral_count);
+                length        += integral_count;
+                buf[length++]  = '.';
+                memory_copy(dst + length, src_digits + integral_count, digit_count - integral_count);
+                length += digit_count - integral_count;
+            }
+        } else if ((-5 <= point) && (point <= 0)) {
+            usize const zero_count = static_cast<usize>(-point);
+            buf[length++]          = '0';
+            buf[length++]          = '.';
+            memory_set(dst + length, zero_count, '0');
+            length += zero_count;
+            memory_copy(dst + length, src_digits, digit_count);
+            length += digit_count;
+        } else {
+            buf[length++] = digits[0];
+            if (digit_count > 1) {
+                buf[length++] = '.';
+                memory_copy(dst + length, src_digits + 1, digit_count - 1u);
+                length += digit_count - 1u;
+            }
+            buf[length++]  = 'e';
+            length        += format_i64(buf + length, point - 1);
+        }
+
+        return length;
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Number parsing.
+    // -------------------------------------------------------------------------------------------------
+
+    namespace impl {
+        /// Load eight characters into an integer, with the first character in the lowest byte.
+        psh_internal psh_inline u64 load_eight_chars(char const* chars) psh_no_except {
+            u64 chunk = memory_load_unaligned<u64>(reinterpret_cast<u8 const*>(chars));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+            chunk = __builtin_bswap64(chunk);
+#endif
+            return chunk;
+        }
+
+        /// Check if the eight characters of a chunk are all decimal digits.
+        psh_internal psh_inline bool chunk_is_eight_digits(u64 chunk) psh_no_except {
+            // Digits are the bytes 0x30 to 0x39: their high nibble is 3, and stays so after adding 6 to
+            // the byte only if the low nibble is at most 9.
+            u64 const high_nibbles       = chunk & 0xF0F0F0F0F0F0F0F0ull;
+            u64 const carry_high_nibbles = ((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4;
+            return (high_nibbles | carry_high_nibbles) == 0x3333333333333333ull;
+        }
+
+        /// Compute the value of a chunk of eight decimal digits by combining adjacent digits, then
+        /// adjacent pairs and finally the two halves, all within the same register.
+        psh_internal psh_inline u64 chunk_eight_digits_value(u64 chunk) psh_no_except {
+            constexpr u64 PAIR_MASK         = 0x000000FF000000FFull;
+            constexpr u64 LOW_PAIRS_FACTOR  = 100ull + (1000000ull << 32);
+            constexpr u64 HIGH_PAIRS_FACTOR = 1ull + (10000ull << 32);
+
+            chunk -= 0x3030303030303030ull;
+            chunk  = (chunk * 10u) + (chunk >> 8);
+            chunk  = (((chunk & PAIR_MASK) * LOW_PAIRS_FACTOR) + (((chunk >> 16) & PAIR_MASK) * HIGH_PAIRS_FACTOR)) >> 32;
+            return chunk & 0xFFFFFFFFu;
+        }
+
+        /// Consume the decimal digits at the start of a range, accumulating them to a value, eight at
+        /// a time whenever possible. Digits past the maximum count are consumed without being
+        /// accumulated.
+        ///
+        /// Parameters:
+        ///     * value: Value to accumulate the digits to, the arithmetic wraps on overflow.
+        ///     * digit_count: Number of digits accumulated so far, updated with the new digits.
+        ///     * max_digit_count: Maximum number of digits to be accumulated.
+        ///     * truncated: Set to true if a non-zero digit is consumed without being accumulated.
+        ///
+        /// Return: The end of the consumed digits.
+        psh_internal char const* parse_digits(
+            char const* cursor,
+            char const* end,
+            u64*        value,
+            u32*        digit_count,
+            u32         max_digit_count,
+            bool*       truncated) psh_no_except {
+            u64 accumulated = *value;
+            u32 count       = *digit_count;
+
+            while ((count + 8u <= max_digit_count) && (end - cursor >= 8)) {
+                u64 const chunk = load_eight_chars(cursor);
+                if (!chunk_is_eight_digits(chunk)) {
+                    break;
+                }
+                accumulated  = accumulated * 100000000u + chunk_eight_digits_value(chunk);
+                count       += 8u;
+                cursor      += 8;
+            }
+
+            for (; (cursor != end) && char_is_digit(*cursor); ++cursor) {
+                u64 const digit = static_cast<u64>(*cursor - '0');
+                if (count < max_digit_count) {
+                    accumulated = accumulated * 10u + digit;
+                    ++count;
+                } else if (digit != 0) {
+                    *truncated = true;
+                }
+            }
+
+            *value       = accumulated;
+            *digit_count = count;
+            return cursor;
+        }
+
+        /// Parse an unsigned decimal integer spanning the whole range.
+        psh_internal Status parse_u64_magnitude(char const* cursor, char const* end, u64* value) psh_no_except {
+            char const* const digits_start = cursor;
+            while ((cursor != end) && (*cursor == '0')) {
+                ++cursor;
+            }
+
+            // The accumulation may wrap for 20 digits, which is checked afterwards.
+            char const* const significant_start = cursor;
+            u64               magnitude         = 0;
+            u32               digit_count       = 0;
+            bool              truncated         = false;
+            cursor = parse_digits(cursor, end, &magnitude, &digit_count, FORMAT_INTEGER_MAX_LENGTH, &truncated);
+
+            if ((cursor != end) || (cursor == digits_start)) {
+                return STATUS_FAILED;
+            }
+            if (static_cast<usize>(cursor - significant_start) > FORMAT_INTEGER_MAX_LENGTH) {
+                return STATUS_FAILED;
+            }
+
+            // The maximum value has 20 digits and starts with a one, in which case the accumulated value
+            // is smaller than 10^19 only if it wrapped.
+            if ((digit_count == FORMAT_INTEGER_MAX_LENGTH)
+                && ((*significant_start != '1') || (magnitude < POW_TEN_U64[FORMAT_INTEGER_MAX_LENGTH - 1]))) {
+                return STATUS_FAILED;
+            }
+
+            *value = magnitude;
+            return STATUS_OK;
+        }
+
+        /// Binary floating point number given by the fields of its IEEE 754 representation.
+        struct BinaryFloat {
+            u64 significand;
+            i32 exponent;
+        };
+
+        /// Exponent of binary floats whose rounding couldn't be decided.
+        psh_internal constexpr i32 BINARY_FLOAT_UNDECIDED_EXPONENT = -1;
+
+        /// Maximum number of significant digits that fit a 64-bit integer.
+        psh_internal constexpr u32 PARSE_FLOAT_MAX_DIGIT_COUNT = 19;
+
+        /// Round w * 10^q to the nearest floating point number, using the Eisel-Lemire algorithm.
+        ///
+        /// The product of w by the 128-bit truncated power of five decides the result except for very
+        /// rare inputs, in which case the returned exponent is BINARY_FLOAT_UNDECIDED_EXPONENT.
+        psh_internal BinaryFloat decimal_to_binary(i64 q, u64 w) psh_no_except {
+            if ((w == 0) || (q < POW_FIVE_128_MIN_EXPONENT)) {
+                return BinaryFloat{.significand = 0, .exponent = 0};
+            }
+            if (q > 308) {
+                return BinaryFloat{.significand = 0, .exponent = F64_INFINITE_EXPONENT};
+            }
+
+            i32 const exponent10    = static_cast<i32>(q);
+            u32 const leading_zeros = bit_count_leading_zeros(w);
+            w <<= leading_zeros;
+
+            // The reciprocals of small powers of five are rounded up rather than truncated, so that the
+            // products of exact halfway cases are recognized below.
+            U128 power = pow_five_128(exponent10);
+            if ((-27 <= exponent10) && (exponent10 < 0)) {
+                power = u128_increment(power);
+            }
+
+            // Only the upper 55 bits of the product are needed: the lower half of the power only has to
+            // be accounted for when a carry could reach them.
+            constexpr u64 PRECISION_MASK = ~u64{0} >> (F64_SIGNIFICAND_BIT_COUNT + 3u);
+            U128          product        = multiply_u64_full(w, power.high);
+            if ((product.high & PRECISION_MASK) == PRECISION_MASK) {
+                U128 const low_product  = multiply_u64_full(w, power.low);
+                product.low            += low_product.high;
+                product.high           += static_cast<u64>(low_product.high > product.low);
+            }
+
+            if ((product.low == ~u64{0}) && ((exponent10 < -27) || (exponent10 > 55))) {
+                return BinaryFloat{.significand = 0, .exponent = BINARY_FLOAT_UNDECIDED_EXPONENT};
+            }
+
+            u32 const upper_bit = static_cast<u32>(product.high >> 63);
+            u32 const shift     = upper_bit + 64u - F64_SIGNIFICAND_BIT_COUNT - 3u;
+
+            // The binary exponent floor(log2(10^q)) + 63 is computed as a fixed point product.
+            i32 const power2    = (((152170 + 65536) * exponent10) >> 16) + 63;
+            u64       mantissa  = product.high >> shift;
+            i32       exponent2 = power2 + static_cast<i32>(upper_bit) - static_cast<i32>(leading_zeros) + F64_EXPONENT_BIAS;
+
+            if (exponent2 <= 0) {
+                // Subnormal numbers, which have no exact halfway cases.
+                if (-exponent2 + 1 >= 64) {
+                    return BinaryFloat{.significand = 0, .exponent = 0};
+                }
+                mantissa >>= -exponent2 + 1;
+                mantissa  += mantissa & 1u;
+                mantissa >>= 1;
+                return BinaryFloat{
+                    .significand = mantissa,
+                    .exponent    = (mantissa < (u64{1} << F64_SIGNIFICAND_BIT_COUNT)) ? 0 : 1,
+                };
+            }
+
+            // Exact halfway cases can only happen for small exponents, where they have to be rounded to
+            // even rather than up.
+            if ((product.low <= 1) && (-4 <= exponent10) && (exponent10 <= 23) && ((mantissa & 3u) == 1)
+                && ((mantissa << shift) == product.high)) {
+                mantissa &= ~u64{1};
+            }
+
+            mantissa  += mantissa & 1u;
+            mantissa >>= 1;
+            if (mantissa >= (u64{2} << F64_SIGNIFICAND_BIT_COUNT)) {
+                mantissa = u64{1} << F64_SIGNIFICAND_BIT_COUNT;
+                ++exponent2;
+            }
+            mantissa &= F64_SIGNIFICAND_MASK;
+
+            if (exponent2 >= F64_INFINITE_EXPONENT) {
+                return BinaryFloat{.significand = 0, .exponent = F64_INFINITE_EXPONENT};
+            }
+            return BinaryFloat{.significand = mantissa, .exponent = exponent2};
+        }
+
+        /// Maximum number of significant digits given to strtod: halfway points between floating
+        /// point numbers have at most 767 significant digits, so that the remaining digits can be
+        /// replaced by a single non-zero digit without changing the rounding.
+        psh_internal constexpr usize PARSE_FLOAT_FALLBACK_MAX_DIGIT_COUNT = 768;
+
+        /// Parse a floating point number already validated by string_to_f64 via strtod, which needs
+        /// the number to be zero-terminated and reasonably sized.
+        ///
+        /// Parameters:
+        ///     * mantissa: The sign and digits of the number, with its optional decimal point.
+        ///     * explicit_exponent: Value of the exponent written after the mantissa.
+        psh_internal f64 parse_f64_fallback(String mantissa, i64 explicit_exponent) psh_no_except {
+            char  buf[1 + PARSE_FLOAT_FALLBACK_MAX_DIGIT_COUNT + 1 + 1 + FORMAT_INTEGER_MAX_LENGTH + 1];
+            usize length = 0;
+
+            char const* cursor = mantissa.buf;
+            char const* end    = mantissa.buf + mantissa.count;
+            if ((*cursor == '-') || (*cursor == '+')) {
+                buf[length++] = *cursor++;
+            }
+
+            // Gather the value as an integer with a decimal exponent.
+            i64   exponent    = explicit_exponent;
+            usize digit_count = 0;
+            bool  in_fraction = false;
+            bool  sticky      = false;
+            for (; cursor != end; ++cursor) {
+                char const c = *cursor;
+                if (c == '.') {
+                    in_fraction = true;
+                } else if ((digit_count == 0) && (c == '0')) {
+                    exponent -= static_cast<i64>(in_fraction);
+                } else if (digit_count < PARSE_FLOAT_FALLBACK_MAX_DIGIT_COUNT) {
+                    buf[length++]  = c;
+                    exponent      -= static_cast<i64>(in_fraction);
+                    ++digit_count;
+                } else {
+                    sticky   |= (c != '0');
+                    exponent += static_cast<i64>(!in_fraction);
+                }
+            }
+            if (sticky) {
+                buf[length++] = '1';
+                --exponent;
+            }
+            if (digit_count == 0) {
+                buf[length++] = '0';
+            }
+
+            buf[length++]  = 'e';
+            length        += format_i64(buf + length, exponent);
+            buf[length]    = 0;
+            return strtod(buf, nullptr);
+        }
+
+        /// Check if a string matches a lowercase string, ignoring the case of the former.
+        psh_internal bool string_equal_lowercase(String str, cstring lowercase) psh_no_except {
+            usize idx = 0;
+            for (; (idx < str.count) && (lowercase[idx] != 0); ++idx) {
+                if (char_to_lower(str.buf[idx]) != lowercase[idx]) {
+                    return false;
+                }
+            }
+            return (idx == str.count) && (lowercase[idx] == 0);
+        }
+    }  // namespace impl
+
+    psh_proc Status string_to_u64(String str, u64* value) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(value));
+
+        char const* cursor = str.buf;
+        char const* end    = str.buf + str.count;
+        if ((cursor != end) && (*cursor == '+')) {
+            ++cursor;
+        }
+
+        return impl::parse_u64_magnitude(cursor, end, value);
+    }
+
+    psh_proc Status string_to_i64(String str, i64* value) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(value));
+
+        char const* cursor   = str.buf;
+        char const* end      = str.buf + str.count;
+        bool        negative = false;
+        if ((cursor != end) && ((*cursor == '-') || (*cursor == '+'))) {
+            negative = (*cursor == '-');
+            ++cursor;
+        }
+
+        u64 magnitude;
+        if (!impl::parse_u64_magnitude(cursor, end, &magnitude)) {
+            return STATUS_FAILED;
+        }
+
+        u64 const max_magnitude = (u64{1} << 63) - static_cast<u64>(!negative);
+        if (magnitude > max_magnitude) {
+            return STATUS_FAILED;
+        }
+
+        // Negate in unsigned arithmetic so that the minimum value doesn't overflow.
+        *value = static_cast<i64>(negative ? (0ull - magnitude) : magnitude);
+        return STATUS_OK;
+    }
+
+    psh_proc Status string_to_f64(String str, f64* value) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(value));
+
+        char const* cursor   = str.buf;
+        char const* end      = str.buf + str.count;
+        bool        negative = false;
+        if ((cursor != end) && ((*cursor == '-') || (*cursor == '+'))) {
+            negative = (*cursor == '-');
+            ++cursor;
+        }
+
+        if ((cursor != end) && !char_is_digit(*cursor) && (*cursor != '.')) {
+            String const name = {cursor, static_cast<usize>(end - cursor)};
+
+            f64 special;
+            if (impl::string_equal_lowercase(name, "inf") || impl::string_equal_lowercase(name, "infinity")) {
+                special = __builtin_bit_cast(f64, u64{0x7FF0000000000000});
+            } else if (impl::string_equal_lowercase(name, "nan")) {
+                special = __builtin_bit_cast(f64, u64{0x7FF8000000000000});
+            } else {
+                return STATUS_FAILED;
+            }
+
+            *value = negative ? -special : special;
+            return STATUS_OK;
+        }
+
+        // Accumulate the first significant digits, keeping track of the decimal exponent. Leading
+        // zeros are skipped so that they don't count as significant.
+        char const* const digits_start = cursor;
+        u64               significand  = 0;
+        u32               digit_count  = 0;
+        bool              truncated    = false;
+        i64               exponent     = 0;
+
+        while ((cursor != end) && (*cursor == '0')) {
+            ++cursor;
+        }
+        char const* const integral_start = cursor;
+        cursor    = impl::parse_digits(cursor, end, &significand, &digit_count, impl::PARSE_FLOAT_MAX_DIGIT_COUNT, &truncated);
+        exponent += static_cast<i64>(cursor - integral_start) - static_cast<i64>(digit_count);
+
+        bool has_digits = (cursor != digits_start);
+        if ((cursor != end) && (*cursor == '.')) {
+            ++cursor;
+
+            char const* const fraction_start = cursor;
+            if (digit_count == 0) {
+                while ((cursor != end) && (*cursor == '0')) {
+                    ++cursor;
+                }
+            }
+            exponent -= static_cast<i64>(cursor - fraction_start);
+
+            u32 const integral_digit_count = digit_count;
+            cursor      = impl::parse_digits(cursor, end, &significand, &digit_count, impl::PARSE_FLOAT_MAX_DIGIT_COUNT, &truncated);
+            exponent   -= static_cast<i64>(digit_count - integral_digit_count);
+            has_digits |= (cursor != fraction_start);
+        }
+        if (!has_digits) {
+            return STATUS_FAILED;
+        }
+
+        char const* const mantissa_end      = cursor;
+        i64               explicit_exponent = 0;
+        if ((cursor != end) && ((*cursor == 'e') || (*cursor == 'E'))) {
+            ++cursor;
+
+            bool negative_exponent = false;
+            if ((cursor != end) && ((*cursor == '-') || (*cursor == '+'))) {
+                negative_exponent = (*cursor == '-');
+                ++cursor;
+            }
+
+            // Exponents this large already overflow or underflow any significand, so there's no point
+            // in accumulating any further.
+            char const* const exponent_start = cursor;
+            for (; (cursor != end) && char_is_digit(*cursor); ++cursor) {
+                if (explicit_exponent < 0x10000) {
+                    explicit_exponent = explicit_exponent * 10 + (*cursor - '0');
+                }
+            }
+            if (cursor == exponent_start) {
+                return STATUS_FAILED;
+            }
+
+            explicit_exponent  = negative_exponent ? -explicit_exponent : explicit_exponent;
+            exponent          += explicit_exponent;
+        }
+        if (cursor != end) {
+            return STATUS_FAILED;
+        }
+
+        // Both the significand and the power of ten are exact, so a single rounding takes place.
+        if (!truncated && (significand <= (u64{1} << 53)) && (-22 <= exponent) && (exponent <= 22)) {
+            f64 magnitude = static_cast<f64>(significand);
+            magnitude     = (exponent < 0) ? (magnitude / impl::POW_TEN_F64[-exponent]) : (magnitude * impl::POW_TEN_F64[exponent]);
+            *value        = negative ? -magnitude : magnitude;
+            return STATUS_OK;
+        }
+
+        // Digits past the 19th can only be ignored if rounding up the significand gives the same result.
+        impl::BinaryFloat binary = impl::decimal_to_binary(exponent, significand);
+        if (truncated && (binary.exponent != impl::BINARY_FLOAT_UNDECIDED_EXPONENT)) {
+            impl::BinaryFloat const upper = impl::decimal_to_binary(exponent, significand + 1u);
+            if ((upper.significand != binary.significand) || (upper.exponent != binary.exponent)) {
+                binary.exponent = impl::BINARY_FLOAT_UNDECIDED_EXPONENT;
+            }
+        }
+
+        if (psh_unlikely(binary.exponent == impl::BINARY_FLOAT_UNDECIDED_EXPONENT)) {
+            *value = impl::parse_f64_fallback(String{str.buf, static_cast<usize>(mantissa_end - str.buf)}, explicit_exponent);
+            return STATUS_OK;
+        }
+
+        u64 const bits = (static_cast<u64>(negative) << 63)
+                         | (static_cast<u64>(binary.exponent) << impl::F64_SIGNIFICAND_BIT_COUNT) | binary.significand;
+        *value = __builtin_bit_cast(f64, bits);
+        return STATUS_OK;
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // UTF-8 encoding.
+    // -------------------------------------------------------------------------------------------------
+
+#if PSH_ARCH_SIMD_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+#    define PSH_IMPL_UTF8_NEON 1
+#else
+#    define PSH_IMPL_UTF8_NEON 0
+#endif
+
+    namespace impl {
+        psh_internal constexpr u64 UTF8_HIGH_BITS = 0x8080808080808080ull;
+
+        /// Decode the sequence at the start of a range of bytes, following the well-formed byte
+        /// sequences table of the Unicode standard.
+        ///
+        /// Return: The length of the sequence, or zero if it isn't well-formed.
+        psh_internal psh_inline u32 utf8_decode_sequence(u8 const* bytes, usize count, u32* codepoint) psh_no_except {
+            u32 const lead = bytes[0];
+            if (lead < 0x80) {
+                *codepoint = lead;
+                return 1;
+            }
+
+            // Continuation bytes and leads of overlong two byte sequences.
+            if (lead < 0xC2) {
+                return 0;
+            }
+
+            if (lead < 0xE0) {
+                if ((count < 2) || ((bytes[1] & 0xC0) != 0x80)) {
+                    return 0;
+                }
+                *codepoint = ((lead & 0x1Fu) << 6) | (bytes[1] & 0x3Fu);
+                return 2;
+            }
+
+            // The range of the second byte excludes overlong encodings, surrogates and code points
+            // past U+10FFFF.
+            if (lead < 0xF0) {
+                if (count < 3) {
+                    return 0;
+                }
+                u32 const second_min = (lead == 0xE0) ? 0xA0u : 0x80u;
+                u32 const second_max = (lead == 0xED) ? 0x9Fu : 0xBFu;
+                if ((bytes[1] < second_min) || (bytes[1] > second_max) || ((bytes[2] & 0xC0) != 0x80)) {
+                    return 0;
+                }
+                *codepoint = ((lead & 0x0Fu) << 12) | ((bytes[1] & 0x3Fu) << 6) | (bytes[2] & 0x3Fu);
+                return 3;
+            }
+
+            if (lead < 0xF5) {
+                if (count < 4) {
+                    return 0;
+                }
+                u32 const second_min = (lead == 0xF0) ? 0x90u : 0x80u;
+                u32 const second_max = (lead == 0xF4) ? 0x8Fu : 0xBFu;
+                if ((bytes[1] < second_min) || (bytes[1] > second_max) || ((bytes[2] & 0xC0) != 0x80)
+                    || ((bytes[3] & 0xC0) != 0x80)) {
+                    return 0;
+                }
+                *codepoint = ((lead & 0x07u) << 18) | ((bytes[1] & 0x3Fu) << 12) | ((bytes[2] & 0x3Fu) << 6)
+                             | (bytes[3] & 0x3Fu);
+                return 4;
+            }
+
+            return 0;
+        }
+
+#if !PSH_ARCH_SIMD_AVX2 && !PSH_IMPL_UTF8_NEON
+        psh_internal bool utf8_is_valid_scalar(u8 const* bytes, usize count) psh_no_except {
+            usize idx = 0;
+            while (idx < count) {
+                // Skip runs of ASCII characters, eight at a time.
+                if ((idx + 8u <= count) && ((memory_load_unaligned<u64>(bytes + idx) & UTF8_HIGH_BITS) == 0)) {
+                    idx += 8u;
+                    continue;
+                }
+
+                u32 codepoint;
+                u32 length = utf8_decode_sequence(bytes + idx, count - idx, &codepoint);
+                if (length == 0) {
+                    return false;
+                }
+                idx += length;
+            }
+            return true;
+        }
+#endif
+
+        // Validation via lookup tables, from "Validating UTF-8 In Less Than One Instruction Per Byte"
+        // by John Keiser and Daniel Lemire.
+        //
+        // Invalid sequences of two bytes are classified by looking up the high and low nibbles of the
+        // first byte and the high nibble of the second byte, where each table lookup gives the set of
+        // errors that could be happening. The bits set in all three lookups are the actual errors.
+        // The only error not detectable from pairs of bytes is a missing or extra continuation byte
+        // after a two byte sequence, which is checked by comparing the lead bytes two and three
+        // positions behind against the continuation bytes.
+
+        psh_internal constexpr u8 UTF8_TOO_SHORT      = 1u << 0;  // 11______ 0_______ or 11______ 11______
+        psh_internal constexpr u8 UTF8_TOO_LONG       = 1u << 1;  // 0_______ 10______
+        psh_internal constexpr u8 UTF8_OVERLONG_3     = 1u << 2;  // 11100000 100_____
+        psh_internal constexpr u8 UTF8_TOO_LARGE      = 1u << 3;  // 11110100 1001____, 11110100 101_____, ...
+        psh_internal constexpr u8 UTF8_SURROGATE      = 1u << 4;  // 11101101 101_____
+        psh_internal constexpr u8 UTF8_OVERLONG_2     = 1u << 5;  // 1100000_ 10______
+        psh_internal constexpr u8 UTF8_TOO_LARGE_1000 = 1u << 6;  // 11110101 1000____, 1111011_ 1000____, ...
+        psh_internal constexpr u8 UTF8_OVERLONG_4     = 1u << 6;  // 11110000 1000____
+        psh_internal constexpr u8 UTF8_TWO_CONTINUES  = 1u << 7;  // 10______ 10______
+        psh_internal constexpr u8 UTF8_CARRY          = UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTINUES;
+
+        psh_internal constexpr u8 UTF8_FIRST_HIGH_NIBBLE_ERRORS[16] = {
+            // 0_______ ________
+            UTF8_TOO_LONG,
+            UTF8_TOO_LONG,
+            UTF8_TOO_LONG,
+            UTF8_TOO_LONG,
+            UTF8_TOO_LONG,
+            UTF8_TOO_LONG,
+            UTF8_TOO_LONG,
+            UTF8_TOO_LONG,
+            // 10______ ________
+            UTF8_TWO_CONTINUES,
+            UTF8_TWO_CONTINUES,
+            UTF8_TWO_CONTINUES,
+            UTF8_TWO_CONTINUES,
+            // 1100____ ________
+            UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+            // 1101____ ________
+            UTF8_TOO_SHORT,
+            // 1110____ ________
+            UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+            // 1111____ ________
+            UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+        };
+
+        psh_internal constexpr u8 UTF8_FIRST_LOW_NIBBLE_ERRORS[16] = {
+            // ____0000 ________
+            UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+            // ____0001 ________
+            UTF8_CARRY | UTF8_OVERLONG_2,
+            // ____001_ ________
+            UTF8_CARRY,
+            UTF8_CARRY,
+            // ____0100 ________
+            UTF8_CARRY | UTF8_TOO_LARGE,
+            // ____0101 ________
+            UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+            // ____011_ ________
+            UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+            UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+            // ____1___ ________
+            UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+            UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+            UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+            UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+            UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+            // ____1101 ________
+            UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+            UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+            UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        };
+
+        psh_internal constexpr u8 UTF8_SECOND_HIGH_NIBBLE_ERRORS[16] = {
+            // ________ 0_______
+            UTF8_TOO_SHORT,
+            UTF8_TOO_SHORT,
+            UTF8_TOO_SHORT,
+            UTF8_TOO_SHORT,
+            UTF8_TOO_SHORT,
+            UTF8_TOO_SHORT,
+            UTF8_TOO_SHORT,
+            UTF8_TOO_SHORT,
+            // ________ 1000____
+            UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUES | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+            // ________ 1001____
+            UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUES | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+            // ________ 101_____
+            UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUES | UTF8_SURROGATE | UTF8_TOO_LARGE,
+            UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUES | UTF8_SURROGATE | UTF8_TOO_LARGE,
+            // ________ 11______
+            UTF8_TOO_SHORT,
+            UTF8_TOO_SHORT,
+            UTF8_TOO_SHORT,
+            UTF8_TOO_SHORT,
+        };
+
+        /// Upper bounds of the last three bytes of a block that doesn't end amid a sequence.
+        psh_internal constexpr u8 UTF8_INCOMPLETE_BOUNDS[32] = {
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+        };
+
+#if PSH_ARCH_SIMD_AVX2
+        using Utf8Block = __m256i;
+
+        psh_internal psh_inline __m256i utf8_broadcast_table(u8 const* table) psh_no_except {
+            return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(table)));
+        }
+
+        struct Utf8Validator {
+            __m256i first_high_nibble_errors  = utf8_broadcast_table(UTF8_FIRST_HIGH_NIBBLE_ERRORS);
+            __m256i first_low_nibble_errors   = utf8_broadcast_table(UTF8_FIRST_LOW_NIBBLE_ERRORS);
+            __m256i second_high_nibble_errors = utf8_broadcast_table(UTF8_SECOND_HIGH_NIBBLE_ERRORS);
+            __m256i incomplete_bounds         = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(UTF8_INCOMPLETE_BOUNDS));
+            __m256i error                     = _mm256_setzero_si256();
+            __m256i previous_block            = _mm256_setzero_si256();
+            __m256i previous_incomplete       = _mm256_setzero_si256();
+        };
+
+        psh_internal psh_inline __m256i utf8_load_block(u8 const* bytes) psh_no_except {
+            return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(bytes));
+        }
+
+        psh_internal psh_inline void utf8_validate_block(Utf8Validator* validator, __m256i block) psh_no_except {
+            if (_mm256_movemask_epi8(block) == 0) {
+                // An ASCII block can only be invalid if the previous block ended amid a sequence.
+                validator->error = _mm256_or_si256(validator->error, validator->previous_incomplete);
+            } else {
+                // Bytes shifted by one, two and three positions, carrying the end of the previous block.
+                __m256i const carried = _mm256_permute2x128_si256(validator->previous_block, block, 0x21);
+                __m256i const prev1   = _mm256_alignr_epi8(block, carried, 15);
+                __m256i const prev2   = _mm256_alignr_epi8(block, carried, 14);
+                __m256i const prev3   = _mm256_alignr_epi8(block, carried, 13);
+
+                __m256i const low_nibble_mask = _mm256_set1_epi8(0x0F);
+                __m256i const first_high      = _mm256_shuffle_epi8(
+                    validator->first_high_nibble_errors,
+                    _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble_mask));
+                __m256i const first_low =
+                    _mm256_shuffle_epi8(validator->first_low_nibble_errors, _mm256_and_si256(prev1, low_nibble_mask));
+                __m256i const second_high = _mm256_shuffle_epi8(
+                    validator->second_high_nibble_errors,
+                    _mm256_and_si256(_mm256_srli_epi16(block, 4), low_nibble_mask));
+                __m256i const special_cases = _mm256_and_si256(_mm256_and_si256(first_high, first_low), second_high);
+
+                // Only leads of three and four byte sequences are left with their high bit set.
+                __m256i const is_third_byte  = _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xE0 - 0x80));
+                __m256i const is_fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xF0 - 0x80));
+                __m256i const must_continue  = _mm256_and_si256(
+                    _mm256_or_si256(is_third_byte, is_fourth_byte),
+                    _mm256_set1_epi8(static_cast<char>(0x80)));
+
+                validator->error               = _mm256_or_si256(validator->error, _mm256_xor_si256(must_continue, special_cases));
+                validator->previous_incomplete = _mm256_subs_epu8(block, validator->incomplete_bounds);
+            }
+            validator->previous_block = block;
+        }
+
+        psh_internal psh_inline bool utf8_validator_finish(Utf8Validator* validator) psh_no_except {
+            __m256i const error = _mm256_or_si256(validator->error, validator->previous_incomplete);
+            return _mm256_testz_si256(error, error) != 0;
+        }
+#elif PSH_IMPL_UTF8_NEON
+        using Utf8Block = uint8x16_t;
+
+        struct Utf8Validator {
+            uint8x16_t first_high_nibble_errors  = vld1q_u8(UTF8_FIRST_HIGH_NIBBLE_ERRORS);
+            uint8x16_t first_low_nibble_errors   = vld1q_u8(UTF8_FIRST_LOW_NIBBLE_ERRORS);
+            uint8x16_t second_high_nibble_errors = vld1q_u8(UTF8_SECOND_HIGH_NIBBLE_ERRORS);
+            uint8x16_t incomplete_bounds         = vld1q_u8(UTF8_INCOMPLETE_BOUNDS + 16);
+            uint8x16_t error                     = vdupq_n_u8(0);
+            uint8x16_t previous_block            = vdupq_n_u8(0);
+            uint8x16_t previous_incomplete       = vdupq_n_u8(0);
+        };
+
+        psh_internal psh_inline uint8x16_t utf8_load_block(u8 const* bytes) psh_no_except {
+            return vld1q_u8(bytes);
+        }
+
+        psh_internal psh_inline void utf8_validate_block(Utf8Validator* validator, uint8x16_t block) psh_no_except {
+            if (vmaxvq_u8(block) < 0x80) {
+                // An ASCII block can only be invalid if the previous block ended amid a sequence.
+                validator->error = vorrq_u8(validator->error, validator->previous_incomplete);
+            } else {
+                // Bytes shifted by one, two and three positions, carrying the end of the previous block.
+                uint8x16_t const prev1 = vextq_u8(validator->previous_block, block, 15);
+                uint8x16_t const prev2 = vextq_u8(validator->previous_block, block, 14);
+                uint8x16_t const prev3 = vextq_u8(validator->previous_block, block, 13);
+
+                uint8x16_t const first_high  = vqtbl1q_u8(validator->first_high_nibble_errors, vshrq_n_u8(prev1, 4));
+                uint8x16_t const first_low   = vqtbl1q_u8(validator->first_low_nibble_errors, vandq_u8(prev1, vdupq_n_u8(0x0F)));
+                uint8x16_t const second_high = vqtbl1q_u8(validator->second_high_nibble_errors, vshrq_n_u8(block, 4));
+                uint8x16_t const special_cases = vandq_u8(vandq_u8(first_high, first_low), second_high);
+
+                // Only leads of three and four byte sequences are left with their high bit set.
+                uint8x16_t const is_third_byte  = vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80));
+                uint8x16_t const is_fourth_byte = vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80));
+                uint8x16_t const must_continue  = vandq_u8(vorrq_u8(is_third_byte, is_fourth_byte), vdupq_n_u8(0x80));
+
+                validator->error               = vorrq_u8(validator->error, veorq_u8(must_continue, special_cases));
+                validator->previous_incomplete = vqsubq_u8(block, validator->incomplete_bounds);
+            }
+            validator->previous_block = block;
+        }
+
+        psh_internal psh_inline bool utf8_validator_finish(Utf8Validator* validator) psh_no_except {
+            return vmaxvq_u8(vorrq_u8(validator->error, validator->previous_incomplete)) == 0;
+        }
+#endif
+
+        /// Count the bytes of a range that start a code point, which are those that aren't
+        /// continuation bytes.
+        psh_internal usize utf8_count_leading_bytes(u8 const* bytes, usize count) psh_no_except {
+            usize leading_count = 0;
+            usize idx           = 0;
+
+#if PSH_ARCH_SIMD_AVX2
+            __m256i const max_continuation_256 = _mm256_set1_epi8(-65);
+            for (; idx + 32u <= count; idx += 32u) {
+                __m256i const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(bytes + idx));
+                u32 const     mask  = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(block, max_continuation_256)));
+                leading_count      += bit_count_ones(mask);
+            }
+#endif
+#if PSH_ARCH_SIMD_SSE2
+            __m128i const max_continuation_128 = _mm_set1_epi8(-65);
+            for (; idx + 16u <= count; idx += 16u) {
+                __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes + idx));
+                u32 const     mask  = static_cast<u32>(_mm_movemask_epi8(_mm_cmpgt_epi8(block, max_continuation_128)));
+                leading_count      += bit_count_ones(mask);
+            }
+#elif PSH_IMPL_UTF8_NEON
+            int8x16_t const max_continuation = vdupq_n_s8(-65);
+            for (; idx + 16u <= count; idx += 16u) {
+                uint8x16_t const is_leading = vcgtq_s8(vld1q_s8(reinterpret_cast<i8 const*>(bytes + idx)), max_continuation);
+                leading_count += vaddvq_u8(vshrq_n_u8(is_leading, 7));
+            }
+#endif
+
+            // The continuation bytes 10______ are the only ones with the high bit set and the
+            // following bit clear.
+            for (; idx + 8u <= count; idx += 8u) {
+                u64 const chunk        = memory_load_unaligned<u64>(bytes + idx);
+                u64 const continuation = chunk & ~(chunk << 1) & UTF8_HIGH_BITS;
+                leading_count         += 8u - bit_count_ones(continuation);
+            }
+            for (; idx < count; ++idx) {
+                leading_count += static_cast<usize>((bytes[idx] & 0xC0) != 0x80);
+            }
+
+            return leading_count;
+        }
+
+        /// Count the UTF-16 code units needed for a valid UTF-8 string: a single unit per code
+        /// point, apart from the four byte sequences which become surrogate pairs.
+        psh_internal usize utf8_utf16_length(u8 const* bytes, usize count) psh_no_except {
+            usize four_byte_count = 0;
+            usize idx             = 0;
+            for (; idx + 8u <= count; idx += 8u) {
+                u64 const chunk  = memory_load_unaligned<u64>(bytes + idx);
+                four_byte_count += bit_count_ones(chunk & (chunk << 1) & (chunk << 2) & (chunk << 3) & UTF8_HIGH_BITS);
+            }
+            for (; idx < count; ++idx) {
+                four_byte_count += static_cast<usize>(bytes[idx] >= 0xF0);
+            }
+            return utf8_count_leading_bytes(bytes, count) + four_byte_count;
+        }
+
+        psh_internal psh_inline usize utf8_encode_unchecked(u8* buf, u32 codepoint) psh_no_except {
+            if (codepoint < 0x80) {
+                buf[0] = static_cast<u8>(codepoint);
+                return 1;
+            }
+            if (codepoint < 0x800) {
+                buf[0] = static_cast<u8>(0xC0 | (codepoint >> 6));
+                buf[1] = static_cast<u8>(0x80 | (codepoint & 0x3F));
+                return 2;
+            }
+            if (codepoint < 0x10000) {
+                buf[0] = static_cast<u8>(0xE0 | (codepoint >> 12));
+                buf[1] = static_cast<u8>(0x80 | ((codepoint >> 6) & 0x3F));
+                buf[2] = static_cast<u8>(0x80 | (codepoint & 0x3F));
+                return 3;
+            }
+            buf[0] = static_cast<u8>(0xF0 | (codepoint >> 18));
+            buf[1] = static_cast<u8>(0x80 | ((codepoint >> 12) & 0x3F));
+            buf[2] = static_cast<u8>(0x80 | ((codepoint >> 6) & 0x3F));
+            buf[3] = static_cast<u8>(0x80 | (codepoint & 0x3F));
+            return 4;
+        }
+
+        psh_internal psh_inline bool utf16_is_high_surrogate(u32 unit) psh_no_except {
+            return (unit & 0xFC00) == 0xD800;
+        }
+
+        psh_internal psh_inline bool utf16_is_low_surrogate(u32 unit) psh_no_except {
+            return (unit & 0xFC00) == 0xDC00;
+        }
+    }  // namespace impl
+
+    psh_proc bool utf8_is_ascii(String str) psh_no_except {
+        u8 const* bytes = reinterpret_cast<u8 const*>(str.buf);
+        usize     idx   = 0;
+
+#if PSH_ARCH_SIMD_AVX2
+        for (; idx + 64u <= str.count; idx += 64u) {
+            __m256i const first  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(bytes + idx));
+            __m256i const second = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(bytes + idx + 32u));
+            if (_mm256_movemask_epi8(_mm256_or_si256(first, second)) != 0) {
+                return false;
+            }
+        }
+#endif
+#if PSH_ARCH_SIMD_SSE2
+        for (; idx + 16u <= str.count; idx += 16u) {
+            if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes + idx))) != 0) {
+                return false;
+            }
+        }
+#elif PSH_IMPL_UTF8_NEON
+        for (; idx + 16u <= str.count; idx += 16u) {
+            if (vmaxvq_u8(vld1q_u8(bytes + idx)) >= 0x80) {
+                return false;
+            }
+        }
+#endif
+
+        u64 high_bits = 0;
+        for (; idx + 8u <= str.count; idx += 8u) {
+            high_bits |= impl::memory_load_unaligned<u64>(bytes + idx);
+        }
+        for (; idx < str.count; ++idx) {
+            high_bits |= bytes[idx];
+        }
+        return (high_bits & impl::UTF8_HIGH_BITS) == 0;
+    }
+
+    psh_proc bool utf8_is_valid(String str) psh_no_except {
+        u8 const* bytes = reinterpret_cast<u8 const*>(str.buf);
+
+#if PSH_ARCH_SIMD_AVX2 || PSH_IMPL_UTF8_NEON
+        constexpr usize BLOCK_SIZE = sizeof(impl::Utf8Block);
+
+        impl::Utf8Validator validator;
+
+        usize idx = 0;
+        for (; idx + BLOCK_SIZE <= str.count; idx += BLOCK_SIZE) {
+            impl::utf8_validate_block(&validator, impl::utf8_load_block(bytes + idx));
+        }
+
+        // Pad the remaining bytes with ASCII zeros, which end any sequence left unfinished.
+        if (idx < str.count) {
+            u8 tail[BLOCK_SIZE] = {};
+            memory_copy(tail, bytes + idx, str.count - idx);
+            impl::utf8_validate_block(&validator, impl::utf8_load_block(tail));
+        }
+
+        return impl::utf8_validator_finish(&validator);
+#else
+        return impl::utf8_is_valid_scalar(bytes, str.count);
+#endif
+    }
+
+    psh_proc usize utf8_codepoint_count(String str) psh_no_except {
+        return impl::utf8_count_leading_bytes(reinterpret_cast<u8 const*>(str.buf), str.count);
+    }
+
+    psh_proc bool utf8_decode_next(String* remaining, u32* codepoint) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(remaining);
+            psh_assert_not_null(codepoint);
+        });
+
+        if (remaining->count == 0) {
+            return false;
+        }
+
+        u32 length = impl::utf8_decode_sequence(reinterpret_cast<u8 const*>(remaining->buf), remaining->count, codepoint);
+        if (psh_unlikely(length == 0)) {
+            *codepoint = UTF8_REPLACEMENT_CODEPOINT;
+            length     = 1;
+        }
+
+        remaining->buf   += length;
+        remaining->count -= length;
+        return true;
+    }
+
+    psh_proc usize utf8_encode(char* buf, u32 codepoint) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(buf));
+
+        bool const is_surrogate = (0xD800 <= codepoint) && (codepoint <= 0xDFFF);
+        if (psh_unlikely(is_surrogate || (codepoint > 0x10FFFF))) {
+            codepoint = UTF8_REPLACEMENT_CODEPOINT;
+        }
+        return impl::utf8_encode_unchecked(reinterpret_cast<u8*>(buf), codepoint);
+    }
+
+    psh_proc Array<u16> utf8_to_utf16(Arena* arena, String str) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(arena));
+
+        if (!utf8_is_valid(str)) {
+            return Array<u16>{};
+        }
+
+        u8 const*   bytes       = reinterpret_cast<u8 const*>(str.buf);
+        usize const units_count = impl::utf8_utf16_length(bytes, str.count);
+
+        // Account for the zero terminator, which isn't part of the resulting array.
+        u16* units = memory_alloc_uninit<u16>(arena, units_count + 1u);
+        if (psh_unlikely(units == nullptr)) {
+            return Array<u16>{};
+        }
+
+        usize idx      = 0;
+        usize unit_idx = 0;
+        while (idx < str.count) {
+            // Widen runs of ASCII characters.
+#if PSH_ARCH_SIMD_SSE2
+            if (idx + 16u <= str.count) {
+                __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes + idx));
+                if (_mm_movemask_epi8(block) == 0) {
+                    __m128i const zero = _mm_setzero_si128();
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(units + unit_idx), _mm_unpacklo_epi8(block, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(units + unit_idx + 8u), _mm_unpackhi_epi8(block, zero));
+                    idx      += 16u;
+                    unit_idx += 16u;
+                    continue;
+                }
+            }
+#endif
+            if (idx + 8u <= str.count) {
+                u64 const chunk = impl::memory_load_unaligned<u64>(bytes + idx);
+                if ((chunk & impl::UTF8_HIGH_BITS) == 0) {
+                    for (usize byte_idx = 0; byte_idx < 8u; ++byte_idx) {
+                        units[unit_idx + byte_idx] = static_cast<u16>((chunk >> (8u * byte_idx)) & 0xFFu);
+                    }
+                    idx      += 8u;
+                    unit_idx += 8u;
+                    continue;
+                }
+            }
+
+            u32 codepoint = 0;
+            idx += impl::utf8_decode_sequence(bytes + idx, str.count - idx, &codepoint);
+            if (codepoint < 0x10000) {
+                units[unit_idx++] = static_cast<u16>(codepoint);
+            } else {
+                codepoint         -= 0x10000;
+                units[unit_idx++]  = static_cast<u16>(0xD800 | (codepoint >> 10));
+                units[unit_idx++]  = static_cast<u16>(0xDC00 | (codepoint & 0x3FF));
+            }
+        }
+        psh_assert(unit_idx == units_count);
+
+        units[units_count] = 0;
+        return Array<u16>{.buf = units, .count = units_count};
+    }
+
+    psh_proc String utf16_to_utf8(Arena* arena, FatPtr<u16 const> str) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(arena));
+
+        // Compute the length of the result while checking that all surrogates are paired.
+        usize length = 0;
+        for (usize idx = 0; idx < str.count; ++idx) {
+            u32 const unit = str.buf[idx];
+            if (unit < 0x80) {
+                length += 1;
+            } else if (unit < 0x800) {
+                length += 2;
+            } else if (impl::utf16_is_high_surrogate(unit)) {
+                if ((idx + 1u == str.count) || !impl::utf16_is_low_surrogate(str.buf[idx + 1u])) {
+                    return String{};
+                }
+                length += 4;
+                ++idx;
+            } else if (impl::utf16_is_low_surrogate(unit)) {
+                return String{};
+            } else {
+                length += 3;
+            }
+        }
+
+        u8* buf = memory_alloc_uninit<u8>(arena, length + 1u);
+        if (psh_unlikely(buf == nullptr)) {
+            return String{};
+        }
+
+        usize byte_idx = 0;
+        for (usize idx = 0; idx < str.count; ++idx) {
+            u32 codepoint = str.buf[idx];
+            if (impl::utf16_is_high_surrogate(codepoint)) {
+                codepoint = 0x10000 + (((codepoint & 0x3FF) << 10) | (str.buf[++idx] & 0x3FFu));
+            }
+            byte_idx += impl::utf8_encode_unchecked(buf + byte_idx, codepoint);
+        }
+        psh_assert(byte_idx == length);
+
+        buf[length] = 0;
+        return String{reinterpret_cast<cstring>(buf), length};
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // String builder.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc StringBuilder make_string_builder(Arena* arena, usize initial_capacity) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(arena));
+
+        // Every write to the buffer precedes any read, so it doesn't need to be zeroed.
+        usize capacity = psh_max_value(initial_capacity, usize{1});
+        char* buf      = memory_alloc_uninit<char>(arena, capacity);
+        return StringBuilder{
+            .buf      = buf,
+            .arena    = arena,
+            .count    = 0,
+            .capacity = (buf != nullptr) ? capacity : 0,
+        };
+    }
+
+    psh_proc Status string_builder_reserve(StringBuilder* builder, usize additional_count) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(builder));
+
+        // Keep room for the zero terminator.
+        usize required_capacity = builder->count + additional_count + 1u;
+        usize capacity          = builder->capacity;
+        if (psh_likely(required_capacity <= capacity)) {
+            return STATUS_OK;
+        }
+
+        usize new_capacity = psh_max_value(capacity * 2u, required_capacity);
+        char* new_buf      = (capacity == 0) ? memory_alloc_uninit<char>(builder->arena, new_capacity)
+                                             : memory_realloc_uninit<char>(builder->arena, builder->buf, capacity, new_capacity);
+        if (psh_unlikely(new_buf == nullptr)) {
+            return STATUS_FAILED;
+        }
+
+        builder->buf      = new_buf;
+        builder->capacity = new_capacity;
+        return STATUS_OK;
+    }
+
+    psh_proc Status string_builder_append(StringBuilder* builder, String str) psh_no_except {
+        if (psh_unlikely(!string_builder_reserve(builder, str.count))) {
+            return STATUS_FAILED;
+        }
+
+        memory_copy(reinterpret_cast<u8*>(builder->buf + builder->count), reinterpret_cast<u8 const*>(str.buf), str.count);
+        builder->count += str.count;
+        return STATUS_OK;
+    }
+
+    psh_proc Status string_builder_append_char(StringBuilder* builder, char c) psh_no_except {
+        if (psh_unlikely(!string_builder_reserve(builder, 1))) {
+            return STATUS_FAILED;
+        }
+
+        builder->buf[builder->count++] = c;
+        return STATUS_OK;
+    }
+
+    psh_proc Status string_builder_append_u64(StringBuilder* builder, u64 value) psh_no_except {
+        if (psh_unlikely(!string_builder_reserve(builder, FORMAT_INTEGER_MAX_LENGTH))) {
+            return STATUS_FAILED;
+        }
+
+        builder->count += format_u64(builder->buf + builder->count, value);
+        return STATUS_OK;
+    }
+
+    psh_proc Status string_builder_append_i64(StringBuilder* builder, i64 value) psh_no_except {
+        if (psh_unlikely(!string_builder_reserve(builder, FORMAT_INTEGER_MAX_LENGTH))) {
+            return STATUS_FAILED;
+        }
+
+        builder->count += format_i64(builder->buf + builder->count, value);
+        return STATUS_OK;
+    }
+
+    psh_proc Status string_builder_append_f64(StringBuilder* builder, f64 value, u32 precision) psh_no_except {
+        if (psh_unlikely(!string_builder_reserve(builder, FORMAT_FLOAT_MAX_LENGTH))) {
+            return STATUS_FAILED;
+        }
+
+        builder->count += format_f64(builder->buf + builder->count, value, precision);
+        return STATUS_OK;
+    }
+
+    psh_proc Status string_builder_append_f64_shortest(StringBuilder* builder, f64 value) psh_no_except {
+        if (psh_unlikely(!string_builder_reserve(builder, FORMAT_FLOAT_SHORTEST_MAX_LENGTH))) {
+            return STATUS_FAILED;
+        }
+
+        builder->count += format_f64_shortest(builder->buf + builder->count, value);
+        return STATUS_OK;
+    }
+
+    namespace impl {
+        struct StringBuilderFormatContext {
+            StringBuilder* builder;
+            Status         status;
+        };
+
+        /// Commit the characters written by the formatter to the builder and hand it the next chunk
+        /// of the builder's buffer.
+        psh_internal char* string_builder_format_callback(cstring buf, void* user, i32 len) psh_no_except {
+            StringBuilderFormatContext* context = reinterpret_cast<StringBuilderFormatContext*>(user);
+            StringBuilder*              builder = context->builder;
+
+            psh_assert(buf == builder->buf + builder->count);
+            builder->count += static_cast<usize>(len);
+
+            if (psh_unlikely(!string_builder_reserve(builder, PSH_IMPL_MIN_LENGTH_PER_CALLBACK))) {
+                context->status = STATUS_FAILED;
+                return nullptr;
+            }
+            return builder->buf + builder->count;
+        }
+    }  // namespace impl
+
+    psh_proc psh_attribute_disable_asan Status string_builder_append_fmt_list(StringBuilder* builder, cstring fmt, va_list va) psh_no_except {
+        if (psh_unlikely(!string_builder_reserve(builder, PSH_IMPL_MIN_LENGTH_PER_CALLBACK))) {
+            return STATUS_FAILED;
+        }
+
+        impl::StringBuilderFormatContext context = {.builder = builder, .status = STATUS_OK};
+        impl::string_format_list_with_callback(
+            impl::string_builder_format_callback,
+            &context,
+            builder->buf + builder->count,
+            fmt,
+            va);
+        return context.status;
+    }
+
+    psh_proc psh_attribute_disable_asan Status string_builder_append_fmt(StringBuilder* builder, cstring fmt, ...) psh_no_except {
+        va_list va;
+        va_start(va, fmt);
+
+        Status status = string_builder_append_fmt_list(builder, fmt, va);
+
+        va_end(va);
+        return status;
+    }
+
+    psh_proc Status string_builder_join(StringBuilder* builder, FatPtr<String const> strings, String separator) psh_no_except {
+        if (strings.count == 0) {
+            return STATUS_OK;
+        }
+
+        usize total_count = (strings.count - 1u) * separator.count;
+        for (String const& str : strings) {
+            total_count += str.count;
+        }
+        if (psh_unlikely(!string_builder_reserve(builder, total_count))) {
+            return STATUS_FAILED;
+        }
+
+        u8* cursor = reinterpret_cast<u8*>(builder->buf + builder->count);
+        for (usize idx = 0; idx < strings.count; ++idx) {
+            if ((idx != 0) && (separator.count != 0)) {
+                memory_copy(cursor, reinterpret_cast<u8 const*>(separator.buf), separator.count);
+                cursor += separator.count;
+            }
+            memory_copy(cursor, reinterpret_cast<u8 const*>(strings.buf[idx].buf), strings.buf[idx].count);
+            cursor += strings.buf[idx].count;
+        }
+
+        builder->count += total_count;
+        return STATUS_OK;
+    }
 }  // namespace psh
@@ -0,0 +1,530 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Implementation of the threading primitives and the job system.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include "psh_thread.hpp"
+
+#include "psh_debug.hpp"
+#include "psh_platform.hpp"
+
+#if PSH_OS_WINDOWS
+#    include <Windows.h>
+#elif PSH_OS_UNIX
+#    include <sched.h>
+#    include <string.h>
+#    include <unistd.h>
+#endif
+
+namespace psh {
+    // -------------------------------------------------------------------------------------------------
+    // Threads.
+    // -------------------------------------------------------------------------------------------------
+
+    namespace impl {
+#if PSH_OS_WINDOWS
+        psh_internal DWORD WINAPI thread_entry(LPVOID arg) psh_no_except {
+            Thread* thread = reinterpret_cast<Thread*>(arg);
+            thread->proc(thread->arg);
+            return 0;
+        }
+#elif PSH_OS_UNIX
+        psh_internal void* thread_entry(void* arg) psh_no_except {
+            Thread* thread = reinterpret_cast<Thread*>(arg);
+            thread->proc(thread->arg);
+            return nullptr;
+        }
+#endif
+    }  // namespace impl
+
+    psh_proc Status thread_create(Thread* thread, ThreadProc* proc, void* arg) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(thread);
+            psh_assert_not_null(proc);
+        });
+
+        thread->proc = proc;
+        thread->arg  = arg;
+
+#if PSH_OS_WINDOWS
+        thread->handle = CreateThread(nullptr, 0, impl::thread_entry, thread, 0, nullptr);
+        if (psh_unlikely(thread->handle == nullptr)) {
+            psh_log_error_fmt("Failed to create thread with error code: %lu", GetLastError());
+            return STATUS_FAILED;
+        }
+#elif PSH_OS_UNIX
+        i32 result = pthread_create(&thread->handle, nullptr, impl::thread_entry, thread);
+        if (psh_unlikely(result != 0)) {
+            psh_log_error_fmt("Failed to create thread due to: %s", strerror(result));
+            return STATUS_FAILED;
+        }
+#endif
+        return STATUS_OK;
+    }
+
+    psh_proc void thread_join(Thread* thread) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(thread));
+
+#if PSH_OS_WINDOWS
+        WaitForSingleObject(thread->handle, INFINITE);
+        CloseHandle(thread->handle);
+        thread->handle = nullptr;
+#elif PSH_OS_UNIX
+        i32 result = pthread_join(thread->handle, nullptr);
+        if (psh_unlikely(result != 0)) {
+            psh_log_error_fmt("Failed to join thread due to: %s", strerror(result));
+        }
+#endif
+    }
+
+    psh_proc void thread_yield() psh_no_except {
+#if PSH_OS_WINDOWS
+        psh_discard_value(SwitchToThread());
+#elif PSH_OS_UNIX
+        psh_discard_value(sched_yield());
+#endif
+    }
+
+    psh_proc u32 thread_hardware_count() psh_no_except {
+        u32 count;
+#if PSH_OS_WINDOWS
+        count = static_cast<u32>(GetActiveProcessorCount(ALL_PROCESSOR_GROUPS));
+#elif PSH_OS_UNIX
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        count       = (online > 0) ? static_cast<u32>(online) : 1u;
+#endif
+        return psh_max_value(count, 1u);
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Synchronisation primitives.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc void init_mutex(Mutex* mutex) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(mutex));
+#if PSH_OS_WINDOWS
+        InitializeSRWLock(reinterpret_cast<PSRWLOCK>(&mutex->handle));
+#elif PSH_OS_UNIX
+        psh_discard_value(pthread_mutex_init(&mutex->handle, nullptr));
+#endif
+    }
+
+    psh_proc void destroy_mutex(Mutex* mutex) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(mutex));
+#if PSH_OS_WINDOWS
+        mutex->handle = nullptr;
+#elif PSH_OS_UNIX
+        psh_discard_value(pthread_mutex_destroy(&mutex->handle));
+#endif
+    }
+
+    psh_proc void mutex_lock(Mutex* mutex) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(mutex));
+#if PSH_OS_WINDOWS
+        AcquireSRWLockExclusive(reinterpret_cast<PSRWLOCK>(&mutex->handle));
+#elif PSH_OS_UNIX
+        psh_discard_value(pthread_mutex_lock(&mutex->handle));
+#endif
+    }
+
+    psh_proc void mutex_unlock(Mutex* mutex) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(mutex));
+#if PSH_OS_WINDOWS
+        ReleaseSRWLockExclusive(reinterpret_cast<PSRWLOCK>(&mutex->handle));
+#elif PSH_OS_UNIX
+        psh_discard_value(pthread_mutex_unlock(&mutex->handle));
+#endif
+    }
+
+    psh_proc bool mutex_try_lock(Mutex* mutex) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(mutex));
+#if PSH_OS_WINDOWS
+        return (TryAcquireSRWLockExclusive(reinterpret_cast<PSRWLOCK>(&mutex->handle)) != 0);
+#elif PSH_OS_UNIX
+        return (pthread_mutex_trylock(&mutex->handle) == 0);
+#endif
+    }
+
+    psh_proc void init_condition_variable(ConditionVariable* cv) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(cv));
+#if PSH_OS_WINDOWS
+        InitializeConditionVariable(reinterpret_cast<PCONDITION_VARIABLE>(&cv->handle));
+#elif PSH_OS_UNIX
+        psh_discard_value(pthread_cond_init(&cv->handle, nullptr));
+#endif
+    }
+
+    psh_proc void destroy_condition_variable(ConditionVariable* cv) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(cv));
+#if PSH_OS_WINDOWS
+        cv->handle = nullptr;
+#elif PSH_OS_UNIX
+        psh_discard_value(pthread_cond_destroy(&cv->handle));
+#endif
+    }
+
+    psh_proc void condition_variable_wait(ConditionVariable* cv, Mutex* mutex) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(cv);
+            psh_assert_not_null(mutex);
+        });
+#if PSH_OS_WINDOWS
+        psh_discard_value(SleepConditionVariableSRW(
+            reinterpret_cast<PCONDITION_VARIABLE>(&cv->handle),
+            reinterpret_cast<PSRWLOCK>(&mutex->handle),
+            INFINITE,
+            0));
+#elif PSH_OS_UNIX
+        psh_discard_value(pthread_cond_wait(&cv->handle, &mutex->handle));
+#endif
+    }
+
+    psh_proc void condition_variable_signal(ConditionVariable* cv) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(cv));
+#if PSH_OS_WINDOWS
+        WakeConditionVariable(reinterpret_cast<PCONDITION_VARIABLE>(&cv->handle));
+#elif PSH_OS_UNIX
+        psh_discard_value(pthread_cond_signal(&cv->handle));
+#endif
+    }
+
+    psh_proc void condition_variable_broadcast(ConditionVariable* cv) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(cv));
+#if PSH_OS_WINDOWS
+        WakeAllConditionVariable(reinterpret_cast<PCONDITION_VARIABLE>(&cv->handle));
+#elif PSH_OS_UNIX
+        psh_discard_value(pthread_cond_broadcast(&cv->handle));
+#endif
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Job deque implementation.
+    //
+    // Implementation of the deque presented in "Correct and Efficient Work-Stealing for Weak Memory
+    // Models" by N. M. Lê, A. Pop, A. Cohen, F. Z. Nardelli. The owner of the deque is the only one
+    // allowed to push and pop jobs, any other thread may steal.
+    // -------------------------------------------------------------------------------------------------
+
+    namespace impl {
+        psh_internal void job_slot_write(JobSlot* slot, Job job) psh_no_except {
+            atomic_store(&slot->proc, job.proc, MemoryOrder::RELAXED);
+            atomic_store(&slot->data, job.data, MemoryOrder::RELAXED);
+            atomic_store(&slot->counter, job.counter, MemoryOrder::RELAXED);
+        }
+
+        psh_internal Job job_slot_read(JobSlot const* slot) psh_no_except {
+            return Job{
+                .proc    = atomic_load(&slot->proc, MemoryOrder::RELAXED),
+                .data    = atomic_load(&slot->data, MemoryOrder::RELAXED),
+                .counter = atomic_load(&slot->counter, MemoryOrder::RELAXED),
+            };
+        }
+
+        psh_internal bool job_deque_push(JobDeque* deque, Job job) psh_no_except {
+            i64 bottom = atomic_load(&deque->bottom, MemoryOrder::RELAXED);
+            i64 top    = atomic_load(&deque->top, MemoryOrder::ACQUIRE);
+            if (psh_unlikely(bottom - top > deque->mask)) {
+                return false;
+            }
+
+            job_slot_write(&deque->slots[bottom & deque->mask], job);
+            atomic_fence(MemoryOrder::RELEASE);
+            atomic_store(&deque->bottom, bottom + 1, MemoryOrder::RELAXED);
+            return true;
+        }
+
+        psh_internal bool job_deque_pop(JobDeque* deque, Job* job) psh_no_except {
+            i64 bottom = atomic_load(&deque->bottom, MemoryOrder::RELAXED) - 1;
+            atomic_store(&deque->bottom, bottom, MemoryOrder::RELAXED);
+            atomic_fence(MemoryOrder::SEQ_CST);
+            i64 top = atomic_load(&deque->top, MemoryOrder::RELAXED);
+
+            if (top > bottom) {
+                // Empty deque.
+                atomic_store(&deque->bottom, bottom + 1, MemoryOrder::RELAXED);
+                return false;
+            }
+
+            *job = job_slot_read(&deque->slots[bottom & deque->mask]);
+            if (top != bottom) {
+                return true;
+            }
+
+            // Last job of the deque, race against the thieves for it.
+            bool won = atomic_compare_exchange(&deque->top, &top, top + 1, MemoryOrder::SEQ_CST);
+            atomic_store(&deque->bottom, bottom + 1, MemoryOrder::RELAXED);
+            return won;
+        }
+
+        psh_internal bool job_deque_steal(JobDeque* deque, Job* job) psh_no_except {
+            i64 top = atomic_load(&deque->top, MemoryOrder::ACQUIRE);
+            atomic_fence(MemoryOrder::SEQ_CST);
+            i64 bottom = atomic_load(&deque->bottom, MemoryOrder::ACQUIRE);
+
+            if (top >= bottom) {
+                return false;
+            }
+
+            *job = job_slot_read(&deque->slots[top & deque->mask]);
+            return atomic_compare_exchange(&deque->top, &top, top + 1, MemoryOrder::SEQ_CST);
+        }
+    }  // namespace impl
+
+    // -------------------------------------------------------------------------------------------------
+    // Job system implementation.
+    // -------------------------------------------------------------------------------------------------
+
+    namespace impl {
+        psh_internal thread_local JobWorker* current_worker = nullptr;
+
+        psh_internal u32 worker_random(JobWorker* worker) psh_no_except {
+            // Xorshift32.
+            u32 x = worker->rng_state;
+            x ^= x << 13u;
+            x ^= x >> 17u;
+            x ^= x << 5u;
+            worker->rng_state = x;
+            return x;
+        }
+
+        psh_internal bool worker_find_job(JobWorker* worker, Job* job) psh_no_except {
+            JobSystem* job_system = worker->system;
+
+            bool found = job_deque_pop(&worker->deque, job);
+
+            u32 worker_count = job_system->worker_count;
+            if (!found && (worker_count > 1)) {
+                for (u32 attempt = 0; attempt < JOB_SYSTEM_MAX_STEAL_ATTEMPTS * worker_count; ++attempt) {
+                    u32 victim = worker_random(worker) % worker_count;
+                    if (victim == worker->index) {
+                        continue;
+                    }
+                    if (job_deque_steal(&job_system->workers[victim].deque, job)) {
+                        found = true;
+                        break;
+                    }
+                }
+            }
+
+            if (found) {
+                psh_discard_value(atomic_fetch_sub(&job_system->queued_count, 1u));
+            }
+            return found;
+        }
+
+        psh_internal void worker_run_job(JobWorker* worker, Job job) psh_no_except {
+            {
+                ScratchArena scratch{&worker->scratch};
+                job.proc(job.data, scratch.arena);
+            }
+
+            if (job.counter != nullptr) {
+                psh_discard_value(atomic_fetch_sub(&job.counter->pending, 1u, MemoryOrder::RELEASE));
+            }
+        }
+
+        psh_internal void worker_main(void* arg) psh_no_except {
+            JobWorker* worker     = reinterpret_cast<JobWorker*>(arg);
+            JobSystem* job_system = worker->system;
+            current_worker        = worker;
+
+            u32 spin_count = 0;
+            while (atomic_load(&job_system->running, MemoryOrder::ACQUIRE) != 0) {
+                Job job;
+                if (worker_find_job(worker, &job)) {
+                    worker_run_job(worker, job);
+                    spin_count = 0;
+                    continue;
+                }
+
+                if (spin_count < JOB_SYSTEM_SPIN_COUNT_BEFORE_IDLE) {
+                    ++spin_count;
+                    cpu_relax();
+                    continue;
+                }
+                spin_count = 0;
+
+                // Sleep until a new job is queued. The idle count is incremented before checking for
+                // queued jobs, so that a submitter either sees an idle worker to be woken up, or the
+                // worker sees the new job.
+                mutex_lock(&job_system->idle_mutex);
+                psh_discard_value(atomic_fetch_add(&job_system->idle_count, 1u));
+                while ((atomic_load(&job_system->running) != 0) && (atomic_load(&job_system->queued_count) == 0)) {
+                    condition_variable_wait(&job_system->idle_cv, &job_system->idle_mutex);
+                }
+                psh_discard_value(atomic_fetch_sub(&job_system->idle_count, 1u));
+                mutex_unlock(&job_system->idle_mutex);
+            }
+
+            current_worker = nullptr;
+        }
+
+        psh_internal void job_system_stop(JobSystem* job_system, u32 thread_count) psh_no_except {
+            atomic_store(&job_system->running, 0u, MemoryOrder::RELEASE);
+
+            mutex_lock(&job_system->idle_mutex);
+            condition_variable_broadcast(&job_system->idle_cv);
+            mutex_unlock(&job_system->idle_mutex);
+
+            // The worker of index zero is the thread that created the job system.
+            for (u32 idx = 1; idx < thread_count; ++idx) {
+                thread_join(&job_system->workers[idx].thread);
+            }
+
+            destroy_condition_variable(&job_system->idle_cv);
+            destroy_mutex(&job_system->idle_mutex);
+            current_worker = nullptr;
+        }
+    }  // namespace impl
+
+    psh_proc Status init_job_system(
+        JobSystem* job_system,
+        Arena*     arena,
+        u32        worker_count,
+        usize      scratch_size,
+        u32        deque_capacity) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(job_system);
+            psh_assert_not_null(arena);
+        });
+        psh_validate_usage({
+            psh_assert_fmt(psh_is_pow_of_two(deque_capacity), "Deque capacity (%u) should be a power of two.", deque_capacity);
+            psh_assert_msg(impl::current_worker == nullptr, "The calling thread is already a job system worker.");
+        });
+
+        if (worker_count == 0) {
+            worker_count = thread_hardware_count();
+        }
+
+        JobWorker* workers = memory_alloc<JobWorker>(arena, worker_count);
+        if (psh_unlikely(workers == nullptr)) {
+            return STATUS_FAILED;
+        }
+
+        for (u32 idx = 0; idx < worker_count; ++idx) {
+            JobWorker*     worker  = &workers[idx];
+            impl::JobSlot* slots   = memory_alloc<impl::JobSlot>(arena, deque_capacity);
+            Arena          scratch = make_sub_arena(arena, scratch_size);
+            if (psh_unlikely((slots == nullptr) || (scratch.buf == nullptr))) {
+                return STATUS_FAILED;
+            }
+
+            worker->deque.slots = slots;
+            worker->deque.mask  = static_cast<i64>(deque_capacity) - 1;
+            worker->scratch     = scratch;
+            worker->system      = job_system;
+            worker->index       = idx;
+            worker->rng_state   = 0x9E3779B9u * (idx + 1u);
+        }
+
+        job_system->workers      = workers;
+        job_system->worker_count = worker_count;
+        atomic_store(&job_system->queued_count, 0u);
+        atomic_store(&job_system->idle_count, 0u);
+        atomic_store(&job_system->running, 1u);
+        init_mutex(&job_system->idle_mutex);
+        init_condition_variable(&job_system->idle_cv);
+
+        impl::current_worker = &workers[0];
+
+        for (u32 idx = 1; idx < worker_count; ++idx) {
+            if (psh_unlikely(!thread_create(&workers[idx].thread, impl::worker_main, &workers[idx]))) {
+                impl::job_system_stop(job_system, idx);
+                job_system->worker_count = 0;
+                return STATUS_FAILED;
+            }
+        }
+
+        return STATUS_OK;
+    }
+
+    psh_proc void destroy_job_system(JobSystem* job_system) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(job_system));
+
+        if (job_system->worker_count == 0) {
+            return;
+        }
+
+        impl::job_system_stop(job_system, job_system->worker_count);
+        job_system->worker_count = 0;
+    }
+
+    psh_proc void job_system_submit(JobSystem* job_system, JobProc* proc, void* data, JobCounter* counter) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(job_system);
+            psh_assert_not_null(proc);
+        });
+
+        JobWorker* worker = impl::current_worker;
+        psh_validate_usage(psh_assert_msg(
+            (worker != nullptr) && (worker->system == job_system),
+            "Jobs should only be submitted by workers of the job system."));
+
+        if (counter != nullptr) {
+            psh_discard_value(atomic_fetch_add(&counter->pending, 1u, MemoryOrder::RELAXED));
+        }
+
+        impl::Job job = {.proc = proc, .data = data, .counter = counter};
+
+        // Account for the job before it is visible to thieves, so that the queued count never wraps.
+        psh_discard_value(atomic_fetch_add(&job_system->queued_count, 1u));
+        if (psh_unlikely(!impl::job_deque_push(&worker->deque, job))) {
+            psh_discard_value(atomic_fetch_sub(&job_system->queued_count, 1u));
+            impl::worker_run_job(worker, job);
+            return;
+        }
+
+        if (atomic_load(&job_system->idle_count) != 0) {
+            mutex_lock(&job_system->idle_mutex);
+            condition_variable_signal(&job_system->idle_cv);
+            mutex_unlock(&job_system->idle_mutex);
+        }
+    }
+
+    psh_proc void job_system_wait(JobSystem* job_system, JobCounter* counter) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(job_system);
+            psh_assert_not_null(counter);
+        });
+
+        JobWorker* worker     = job_system_current_worker(job_system);
+        u32        spin_count = 0;
+        while (atomic_load(&counter->pending, MemoryOrder::ACQUIRE) != 0) {
+            impl::Job job;
+            if ((worker != nullptr) && impl::worker_find_job(worker, &job)) {
+                impl::worker_run_job(worker, job);
+                spin_count = 0;
+            } else if (spin_count < JOB_SYSTEM_SPIN_COUNT_BEFORE_IDLE) {
+                ++spin_count;
+                cpu_relax();
+            } else {
+                // The remaining jobs are being run by other workers, give them the processor.
+                thread_yield();
+            }
+        }
+    }
+
+    psh_proc JobWorker* job_system_current_worker(JobSystem* job_system) psh_no_except {
+        JobWorker* worker = impl::current_worker;
+        return ((worker != nullptr) && (worker->system == job_system)) ? worker : nullptr;
+    }
+}  // namespace psh
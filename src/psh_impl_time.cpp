@@ -24,6 +24,7 @@
 
 #include "psh_time.hpp"
 
+#include "psh_atomic.hpp"
 #include "psh_platform.hpp"
 
 #if PSH_OS_WINDOWS
@@ -61,6 +62,79 @@ namespace psh {
         return curr_time;
     }
 
+    psh_proc u64 os_timer_ticks() psh_no_except {
+        u64 ticks = 0;
+
+#if PSH_OS_WINDOWS
+        LARGE_INTEGER counter;
+        if (psh_likely(QueryPerformanceCounter(&counter) != 0)) {
+            ticks = static_cast<u64>(counter.QuadPart);
+        }
+#elif PSH_OS_UNIX
+        timespec time_spec;
+        if (psh_likely(clock_gettime(CLOCK_MONOTONIC, &time_spec) == 0)) {
+            ticks = static_cast<u64>(time_spec.tv_sec) * 1'000'000'000ull + static_cast<u64>(time_spec.tv_nsec);
+        }
+#endif
+
+        return ticks;
+    }
+
+    psh_proc u64 os_timer_frequency() psh_no_except {
+#if PSH_OS_WINDOWS
+        LARGE_INTEGER frequency;
+        if (psh_likely(QueryPerformanceFrequency(&frequency) != 0)) {
+            return static_cast<u64>(frequency.QuadPart);
+        }
+        return 1;
+#else
+        return 1'000'000'000ull;
+#endif
+    }
+
+    namespace impl {
+        psh_internal Atomic<u64> cpu_timestamp_frequency_cache = {};
+
+        /// Measure the number of timestamp counter ticks elapsed during 10 milliseconds of the
+        /// operating system clock.
+        psh_proc u64 calibrate_cpu_timestamp_frequency() psh_no_except {
+            u64 os_frequency = os_timer_frequency();
+            u64 os_wait      = os_frequency / 100;
+
+            u64 os_begin  = os_timer_ticks();
+            u64 cpu_begin = cpu_timestamp_counter();
+
+            u64 os_elapsed = 0;
+            while (os_elapsed < os_wait) {
+                os_elapsed = os_timer_ticks() - os_begin;
+            }
+            u64 cpu_elapsed = cpu_timestamp_counter() - cpu_begin;
+
+            if (psh_unlikely(os_elapsed == 0)) {
+                return os_frequency;
+            }
+            return static_cast<u64>((static_cast<f64>(cpu_elapsed) * static_cast<f64>(os_frequency)) / static_cast<f64>(os_elapsed));
+        }
+    }  // namespace impl
+
+    psh_proc u64 cpu_timestamp_frequency() psh_no_except {
+#if defined(__aarch64__) && !PSH_COMPILER_MSVC
+        u64 frequency;
+        __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(frequency));
+        return frequency;
+#elif PSH_ARCH_X64
+        // Concurrent first calls may both calibrate, which is harmless.
+        u64 frequency = atomic_load(&impl::cpu_timestamp_frequency_cache, MemoryOrder::RELAXED);
+        if (psh_unlikely(frequency == 0)) {
+            frequency = impl::calibrate_cpu_timestamp_frequency();
+            atomic_store(&impl::cpu_timestamp_frequency_cache, frequency, MemoryOrder::RELAXED);
+        }
+        return frequency;
+#else
+        return os_timer_frequency();
+#endif
+    }
+
     psh_proc void sleep_milliseconds(f64 ms) psh_no_except {
 #if PSH_OS_WINDOWS
         u32 ms_count = ((0.0 < ms) && (ms < 1.0)) ? 1 : static_cast<u32>(ms);
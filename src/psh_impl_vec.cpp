@@ -26,7 +26,108 @@
 
 #include <math.h>
 
-// @TODO: improve matrix operations by using SIMD.
+// Division and square root on vectors are only available for 64-bit ARM.
+#if PSH_ARCH_SIMD_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+#    define PSH_IMPL_VEC_NEON_A64 1
+#else
+#    define PSH_IMPL_VEC_NEON_A64 0
+#endif
+
+namespace psh::impl {
+    // -------------------------------------------------------------------------------------------------
+    // Kernels of the 4-dimensional column-major matrix operations.
+    //
+    // The matrix buffer is seen as four groups of four contiguous components, which are exactly the
+    // rows of the vectorised operations:
+    //
+    //     mat_mul(m, v)[r]       = sum_k m.buf[k * 4 + r] * v[k]
+    //     mat_mul(lhs, rhs)[r, c] = sum_k lhs.buf[r * 4 + k] * rhs.buf[k * 4 + c]
+    //
+    // Both are computed as sums of whole groups scaled by broadcast components.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_internal psh_inline void colmat4_mul_vec4(f32* psh_no_alias out, f32 const* m, f32 const* v) psh_no_except {
+#if PSH_ARCH_SIMD_SSE2
+        __m128 result = _mm_mul_ps(_mm_loadu_ps(m), _mm_set1_ps(v[0]));
+        result        = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m + 4), _mm_set1_ps(v[1])));
+        result        = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m + 8), _mm_set1_ps(v[2])));
+        result        = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_set1_ps(v[3])));
+        _mm_storeu_ps(out, result);
+#elif PSH_ARCH_SIMD_NEON
+        float32x4_t result = vmulq_n_f32(vld1q_f32(m), v[0]);
+        result             = vmlaq_n_f32(result, vld1q_f32(m + 4), v[1]);
+        result             = vmlaq_n_f32(result, vld1q_f32(m + 8), v[2]);
+        result             = vmlaq_n_f32(result, vld1q_f32(m + 12), v[3]);
+        vst1q_f32(out, result);
+#else
+        f32 x = v[0];
+        f32 y = v[1];
+        f32 z = v[2];
+        f32 w = v[3];
+        for (u32 r = 0; r < 4; ++r) {
+            out[r] = (m[r] * x) + (m[4 + r] * y) + (m[8 + r] * z) + (m[12 + r] * w);
+        }
+#endif
+    }
+
+#if PSH_ARCH_SIMD_AVX
+    /// Load a group of four components into both lanes of a register.
+    psh_internal psh_inline __m256 colmat4_duplicate_group(f32 const* group) psh_no_except {
+        __m128 g = _mm_loadu_ps(group);
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(g), g, 1);
+    }
+#endif
+
+    psh_internal psh_inline void colmat4_mul(f32* psh_no_alias out, f32 const* lhs, f32 const* rhs) psh_no_except {
+#if PSH_ARCH_SIMD_AVX
+        // Compute two groups at a time, with the groups of the right-hand side duplicated in both
+        // lanes and the lhs components of each group broadcast to their own lane.
+        __m256 rhs0 = colmat4_duplicate_group(rhs);
+        __m256 rhs1 = colmat4_duplicate_group(rhs + 4);
+        __m256 rhs2 = colmat4_duplicate_group(rhs + 8);
+        __m256 rhs3 = colmat4_duplicate_group(rhs + 12);
+        for (u32 r = 0; r < 16; r += 8) {
+            __m256 l      = _mm256_loadu_ps(lhs + r);
+            __m256 result = _mm256_mul_ps(_mm256_shuffle_ps(l, l, 0x00), rhs0);
+            result        = _mm256_add_ps(result, _mm256_mul_ps(_mm256_shuffle_ps(l, l, 0x55), rhs1));
+            result        = _mm256_add_ps(result, _mm256_mul_ps(_mm256_shuffle_ps(l, l, 0xAA), rhs2));
+            result        = _mm256_add_ps(result, _mm256_mul_ps(_mm256_shuffle_ps(l, l, 0xFF), rhs3));
+            _mm256_storeu_ps(out + r, result);
+        }
+#elif PSH_ARCH_SIMD_SSE2
+        __m128 rhs0 = _mm_loadu_ps(rhs);
+        __m128 rhs1 = _mm_loadu_ps(rhs + 4);
+        __m128 rhs2 = _mm_loadu_ps(rhs + 8);
+        __m128 rhs3 = _mm_loadu_ps(rhs + 12);
+        for (u32 r = 0; r < 16; r += 4) {
+            __m128 l      = _mm_loadu_ps(lhs + r);
+            __m128 result = _mm_mul_ps(_mm_shuffle_ps(l, l, 0x00), rhs0);
+            result        = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(l, l, 0x55), rhs1));
+            result        = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(l, l, 0xAA), rhs2));
+            result        = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(l, l, 0xFF), rhs3));
+            _mm_storeu_ps(out + r, result);
+        }
+#elif PSH_ARCH_SIMD_NEON
+        float32x4_t rhs0 = vld1q_f32(rhs);
+        float32x4_t rhs1 = vld1q_f32(rhs + 4);
+        float32x4_t rhs2 = vld1q_f32(rhs + 8);
+        float32x4_t rhs3 = vld1q_f32(rhs + 12);
+        for (u32 r = 0; r < 16; r += 4) {
+            float32x4_t result = vmulq_n_f32(rhs0, lhs[r]);
+            result             = vmlaq_n_f32(result, rhs1, lhs[r + 1]);
+            result             = vmlaq_n_f32(result, rhs2, lhs[r + 2]);
+            result             = vmlaq_n_f32(result, rhs3, lhs[r + 3]);
+            vst1q_f32(out + r, result);
+        }
+#else
+        for (u32 r = 0; r < 16; r += 4) {
+            for (u32 c = 0; c < 4; ++c) {
+                out[r + c] = (lhs[r] * rhs[c]) + (lhs[r + 1] * rhs[4 + c]) + (lhs[r + 2] * rhs[8 + c]) + (lhs[r + 3] * rhs[12 + c]);
+            }
+        }
+#endif
+    }
+}  // namespace psh::impl
 
 namespace psh {
     // -------------------------------------------------------------------------------------------------
@@ -87,38 +188,298 @@ namespace psh {
     }
 
     psh_proc Vec4 mat_mul(ColMat4 m, Vec4 v) psh_no_except {
-        return Vec4{
-            (m.buf[0] * v.x) + (m.buf[4] * v.y) + (m.buf[8] * v.z) + (m.buf[12] * v.w),
-            (m.buf[1] * v.x) + (m.buf[5] * v.y) + (m.buf[9] * v.z) + (m.buf[13] * v.w),
-            (m.buf[2] * v.x) + (m.buf[6] * v.y) + (m.buf[10] * v.z) + (m.buf[14] * v.w),
-            (m.buf[3] * v.x) + (m.buf[7] * v.y) + (m.buf[11] * v.z) + (m.buf[15] * v.w),
-        };
+        Vec4 result;
+        impl::colmat4_mul_vec4(&result.x, m.buf, &v.x);
+        return result;
     }
 
     psh_proc ColMat4 mat_mul(ColMat4 lhs, ColMat4 rhs) psh_no_except {
-        // clang-format off
-        return ColMat4{
-            // Row 1.
-            (lhs.buf[0] * rhs.buf[0]) + (lhs.buf[1] * rhs.buf[4]) + (lhs.buf[2] * rhs.buf[8])  + (lhs.buf[3] * rhs.buf[12]),
-            (lhs.buf[0] * rhs.buf[1]) + (lhs.buf[1] * rhs.buf[5]) + (lhs.buf[2] * rhs.buf[9])  + (lhs.buf[3] * rhs.buf[13]),
-            (lhs.buf[0] * rhs.buf[2]) + (lhs.buf[1] * rhs.buf[6]) + (lhs.buf[2] * rhs.buf[10]) + (lhs.buf[3] * rhs.buf[14]),
-            (lhs.buf[0] * rhs.buf[3]) + (lhs.buf[1] * rhs.buf[7]) + (lhs.buf[2] * rhs.buf[11]) + (lhs.buf[3] * rhs.buf[15]),
-            // Row 2.
-            (lhs.buf[4] * rhs.buf[0]) + (lhs.buf[5] * rhs.buf[4]) + (lhs.buf[6] * rhs.buf[8])  + (lhs.buf[7] * rhs.buf[12]),
-            (lhs.buf[4] * rhs.buf[1]) + (lhs.buf[5] * rhs.buf[5]) + (lhs.buf[6] * rhs.buf[9])  + (lhs.buf[7] * rhs.buf[13]),
-            (lhs.buf[4] * rhs.buf[2]) + (lhs.buf[5] * rhs.buf[6]) + (lhs.buf[6] * rhs.buf[10]) + (lhs.buf[7] * rhs.buf[14]),
-            (lhs.buf[4] * rhs.buf[3]) + (lhs.buf[5] * rhs.buf[7]) + (lhs.buf[6] * rhs.buf[11]) + (lhs.buf[7] * rhs.buf[15]),
-            // Row 3.
-            (lhs.buf[8] * rhs.buf[0]) + (lhs.buf[9] * rhs.buf[4]) + (lhs.buf[10] * rhs.buf[8])  + (lhs.buf[11] * rhs.buf[12]),
-            (lhs.buf[8] * rhs.buf[1]) + (lhs.buf[9] * rhs.buf[5]) + (lhs.buf[10] * rhs.buf[9])  + (lhs.buf[11] * rhs.buf[13]),
-            (lhs.buf[8] * rhs.buf[2]) + (lhs.buf[9] * rhs.buf[6]) + (lhs.buf[10] * rhs.buf[10]) + (lhs.buf[11] * rhs.buf[14]),
-            (lhs.buf[8] * rhs.buf[3]) + (lhs.buf[9] * rhs.buf[7]) + (lhs.buf[10] * rhs.buf[11]) + (lhs.buf[11] * rhs.buf[15]),
-            // Row 4.
-            (lhs.buf[12] * rhs.buf[0]) + (lhs.buf[13] * rhs.buf[4]) + (lhs.buf[14] * rhs.buf[8])  + (lhs.buf[15] * rhs.buf[12]),
-            (lhs.buf[12] * rhs.buf[1]) + (lhs.buf[13] * rhs.buf[5]) + (lhs.buf[14] * rhs.buf[9])  + (lhs.buf[15] * rhs.buf[13]),
-            (lhs.buf[12] * rhs.buf[2]) + (lhs.buf[13] * rhs.buf[6]) + (lhs.buf[14] * rhs.buf[10]) + (lhs.buf[15] * rhs.buf[14]),
-            (lhs.buf[12] * rhs.buf[3]) + (lhs.buf[13] * rhs.buf[7]) + (lhs.buf[14] * rhs.buf[11]) + (lhs.buf[15] * rhs.buf[15]),
-        };
-        // clang-format on
+        ColMat4 result;
+        impl::colmat4_mul(result.buf, lhs.buf, rhs.buf);
+        return result;
+    }
+
+    psh_proc void mat_mul(FatPtr<Vec4> out, ColMat4 m, FatPtr<Vec4 const> vectors) psh_no_except {
+        psh_validate_usage(psh_assert_msg(out.count == vectors.count, "The output should have the same count as the input."));
+
+        // Each vector is copied before the store, so the output may alias the input.
+        for (usize idx = 0; idx < vectors.count; ++idx) {
+            Vec4 v = vectors.buf[idx];
+            impl::colmat4_mul_vec4(&out.buf[idx].x, m.buf, &v.x);
+        }
+    }
+
+    psh_proc void mat_mul(FatPtr<ColMat4> out, ColMat4 lhs, FatPtr<ColMat4 const> rhs) psh_no_except {
+        psh_validate_usage(psh_assert_msg(out.count == rhs.count, "The output should have the same count as the input."));
+
+        for (usize idx = 0; idx < rhs.count; ++idx) {
+            ColMat4 r = rhs.buf[idx];
+            impl::colmat4_mul(out.buf[idx].buf, lhs.buf, r.buf);
+        }
+    }
+}  // namespace psh
+
+// -------------------------------------------------------------------------------------------------
+// Structure-of-arrays streams of vectors.
+// -------------------------------------------------------------------------------------------------
+
+namespace psh {
+    psh_proc Vec3Stream make_vec3_stream(Arena* arena, usize count) psh_no_except {
+        psh_validate_usage(psh_assert_not_null(arena));
+
+        ArenaCheckpoint checkpoint = make_arena_checkpoint(arena);
+
+        Vec3Stream stream;
+        stream.x = reinterpret_cast<f32*>(memory_alloc_align(arena, count * sizeof(f32), VEC_STREAM_ALIGNMENT));
+        stream.y = reinterpret_cast<f32*>(memory_alloc_align(arena, count * sizeof(f32), VEC_STREAM_ALIGNMENT));
+        stream.z = reinterpret_cast<f32*>(memory_alloc_align(arena, count * sizeof(f32), VEC_STREAM_ALIGNMENT));
+        if (psh_unlikely((stream.x == nullptr) || (stream.y == nullptr) || (stream.z == nullptr))) {
+            arena_checkpoint_restore(checkpoint);
+            return Vec3Stream{};
+        }
+
+        stream.count = count;
+        return stream;
+    }
+
+    psh_proc void vec3_stream_from_aos(Vec3Stream out, FatPtr<Vec3 const> vectors) psh_no_except {
+        psh_validate_usage(psh_assert_msg(out.count == vectors.count, "The stream should have the same count as the array."));
+
+        // The array is seen as a sequence of interleaved coordinates.
+        f32 const* src   = reinterpret_cast<f32 const*>(vectors.buf);
+        usize      count = vectors.count;
+        usize      idx   = 0;
+
+#if PSH_ARCH_SIMD_SSE2
+        // Transpose groups of 4 vectors spread over 3 registers:
+        //     a = [x0 y0 z0 x1], b = [y1 z1 x2 y2], c = [z2 x3 y3 z3].
+        for (; idx + 4 <= count; idx += 4) {
+            __m128 a = _mm_loadu_ps(src + 3 * idx);
+            __m128 b = _mm_loadu_ps(src + 3 * idx + 4);
+            __m128 c = _mm_loadu_ps(src + 3 * idx + 8);
+
+            __m128 x_hi = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));  // [x2 x2 x3 x3]
+            __m128 y_lo = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));  // [y0 y0 y1 y1]
+            __m128 y_hi = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));  // [y2 y2 y3 y3]
+            __m128 z_lo = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));  // [z0 z0 z1 z1]
+
+            _mm_storeu_ps(out.x + idx, _mm_shuffle_ps(a, x_hi, _MM_SHUFFLE(2, 0, 3, 0)));
+            _mm_storeu_ps(out.y + idx, _mm_shuffle_ps(y_lo, y_hi, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(out.z + idx, _mm_shuffle_ps(z_lo, c, _MM_SHUFFLE(3, 0, 2, 0)));
+        }
+#elif PSH_ARCH_SIMD_NEON
+        for (; idx + 4 <= count; idx += 4) {
+            float32x4x3_t v = vld3q_f32(src + 3 * idx);
+            vst1q_f32(out.x + idx, v.val[0]);
+            vst1q_f32(out.y + idx, v.val[1]);
+            vst1q_f32(out.z + idx, v.val[2]);
+        }
+#endif
+
+        for (; idx < count; ++idx) {
+            out.x[idx] = vectors.buf[idx].x;
+            out.y[idx] = vectors.buf[idx].y;
+            out.z[idx] = vectors.buf[idx].z;
+        }
+    }
+
+    psh_proc void vec3_stream_to_aos(FatPtr<Vec3> out, Vec3Stream stream) psh_no_except {
+        psh_validate_usage(psh_assert_msg(out.count == stream.count, "The array should have the same count as the stream."));
+
+        f32*  dst   = reinterpret_cast<f32*>(out.buf);
+        usize count = stream.count;
+        usize idx   = 0;
+
+#if PSH_ARCH_SIMD_SSE2
+        for (; idx + 4 <= count; idx += 4) {
+            __m128 x = _mm_loadu_ps(stream.x + idx);
+            __m128 y = _mm_loadu_ps(stream.y + idx);
+            __m128 z = _mm_loadu_ps(stream.z + idx);
+
+            __m128 xy_lo = _mm_unpacklo_ps(x, y);                                // [x0 y0 x1 y1]
+            __m128 xy_hi = _mm_unpackhi_ps(x, y);                                // [x2 y2 x3 y3]
+            __m128 zx    = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));        // [z0 z0 x1 x1]
+            __m128 yz    = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));        // [y1 y1 z1 z1]
+            __m128 zx_hi = _mm_shuffle_ps(z, xy_hi, _MM_SHUFFLE(2, 2, 2, 2));    // [z2 z2 x3 x3]
+            __m128 yz_hi = _mm_shuffle_ps(xy_hi, z, _MM_SHUFFLE(3, 3, 3, 3));    // [y3 y3 z3 z3]
+
+            _mm_storeu_ps(dst + 3 * idx, _mm_shuffle_ps(xy_lo, zx, _MM_SHUFFLE(2, 0, 1, 0)));
+            _mm_storeu_ps(dst + 3 * idx + 4, _mm_shuffle_ps(yz, xy_hi, _MM_SHUFFLE(1, 0, 2, 0)));
+            _mm_storeu_ps(dst + 3 * idx + 8, _mm_shuffle_ps(zx_hi, yz_hi, _MM_SHUFFLE(2, 0, 2, 0)));
+        }
+#elif PSH_ARCH_SIMD_NEON
+        for (; idx + 4 <= count; idx += 4) {
+            float32x4x3_t v;
+            v.val[0] = vld1q_f32(stream.x + idx);
+            v.val[1] = vld1q_f32(stream.y + idx);
+            v.val[2] = vld1q_f32(stream.z + idx);
+            vst3q_f32(dst + 3 * idx, v);
+        }
+#endif
+
+        for (; idx < count; ++idx) {
+            out.buf[idx] = Vec3{stream.x[idx], stream.y[idx], stream.z[idx]};
+        }
+    }
+
+    psh_proc void batch_mat_mul(Vec3Stream out, ColMat4 m, Vec3Stream vectors, f32 w) psh_no_except {
+        psh_validate_usage(psh_assert_msg(out.count == vectors.count, "The output should have the same count as the input."));
+
+        // Fold the fourth coordinate into the translation column.
+        f32 tx = m.buf[12] * w;
+        f32 ty = m.buf[13] * w;
+        f32 tz = m.buf[14] * w;
+
+        usize count = vectors.count;
+        usize idx   = 0;
+
+#if PSH_ARCH_SIMD_AVX
+        for (; idx + 8 <= count; idx += 8) {
+            __m256 x = _mm256_loadu_ps(vectors.x + idx);
+            __m256 y = _mm256_loadu_ps(vectors.y + idx);
+            __m256 z = _mm256_loadu_ps(vectors.z + idx);
+
+            __m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m.buf[0]), x), _mm256_mul_ps(_mm256_set1_ps(m.buf[4]), y)), _mm256_mul_ps(_mm256_set1_ps(m.buf[8]), z)), _mm256_set1_ps(tx));
+            __m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m.buf[1]), x), _mm256_mul_ps(_mm256_set1_ps(m.buf[5]), y)), _mm256_mul_ps(_mm256_set1_ps(m.buf[9]), z)), _mm256_set1_ps(ty));
+            __m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m.buf[2]), x), _mm256_mul_ps(_mm256_set1_ps(m.buf[6]), y)), _mm256_mul_ps(_mm256_set1_ps(m.buf[10]), z)), _mm256_set1_ps(tz));
+
+            _mm256_storeu_ps(out.x + idx, rx);
+            _mm256_storeu_ps(out.y + idx, ry);
+            _mm256_storeu_ps(out.z + idx, rz);
+        }
+#endif
+#if PSH_ARCH_SIMD_SSE2
+        for (; idx + 4 <= count; idx += 4) {
+            __m128 x = _mm_loadu_ps(vectors.x + idx);
+            __m128 y = _mm_loadu_ps(vectors.y + idx);
+            __m128 z = _mm_loadu_ps(vectors.z + idx);
+
+            __m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m.buf[0]), x), _mm_mul_ps(_mm_set1_ps(m.buf[4]), y)), _mm_mul_ps(_mm_set1_ps(m.buf[8]), z)), _mm_set1_ps(tx));
+            __m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m.buf[1]), x), _mm_mul_ps(_mm_set1_ps(m.buf[5]), y)), _mm_mul_ps(_mm_set1_ps(m.buf[9]), z)), _mm_set1_ps(ty));
+            __m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m.buf[2]), x), _mm_mul_ps(_mm_set1_ps(m.buf[6]), y)), _mm_mul_ps(_mm_set1_ps(m.buf[10]), z)), _mm_set1_ps(tz));
+
+            _mm_storeu_ps(out.x + idx, rx);
+            _mm_storeu_ps(out.y + idx, ry);
+            _mm_storeu_ps(out.z + idx, rz);
+        }
+#elif PSH_ARCH_SIMD_NEON
+        for (; idx + 4 <= count; idx += 4) {
+            float32x4_t x = vld1q_f32(vectors.x + idx);
+            float32x4_t y = vld1q_f32(vectors.y + idx);
+            float32x4_t z = vld1q_f32(vectors.z + idx);
+
+            float32x4_t rx = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(tx), x, m.buf[0]), y, m.buf[4]), z, m.buf[8]);
+            float32x4_t ry = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(ty), x, m.buf[1]), y, m.buf[5]), z, m.buf[9]);
+            float32x4_t rz = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(tz), x, m.buf[2]), y, m.buf[6]), z, m.buf[10]);
+
+            vst1q_f32(out.x + idx, rx);
+            vst1q_f32(out.y + idx, ry);
+            vst1q_f32(out.z + idx, rz);
+        }
+#endif
+
+        for (; idx < count; ++idx) {
+            f32 x = vectors.x[idx];
+            f32 y = vectors.y[idx];
+            f32 z = vectors.z[idx];
+
+            out.x[idx] = (m.buf[0] * x) + (m.buf[4] * y) + (m.buf[8] * z) + tx;
+            out.y[idx] = (m.buf[1] * x) + (m.buf[5] * y) + (m.buf[9] * z) + ty;
+            out.z[idx] = (m.buf[2] * x) + (m.buf[6] * y) + (m.buf[10] * z) + tz;
+        }
+    }
+
+    psh_proc void batch_normalise(Vec3Stream out, Vec3Stream vectors) psh_no_except {
+        psh_validate_usage(psh_assert_msg(out.count == vectors.count, "The output should have the same count as the input."));
+
+        usize count = vectors.count;
+        usize idx   = 0;
+
+#if PSH_ARCH_SIMD_AVX
+        __m256 zero_range_avx = _mm256_set1_ps(F32_IS_ZERO_RANGE);
+        for (; idx + 8 <= count; idx += 8) {
+            __m256 x = _mm256_loadu_ps(vectors.x + idx);
+            __m256 y = _mm256_loadu_ps(vectors.y + idx);
+            __m256 z = _mm256_loadu_ps(vectors.z + idx);
+
+            __m256 len     = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+            __m256 nonzero = _mm256_cmp_ps(len, zero_range_avx, _CMP_GE_OQ);
+
+            _mm256_storeu_ps(out.x + idx, _mm256_and_ps(_mm256_div_ps(x, len), nonzero));
+            _mm256_storeu_ps(out.y + idx, _mm256_and_ps(_mm256_div_ps(y, len), nonzero));
+            _mm256_storeu_ps(out.z + idx, _mm256_and_ps(_mm256_div_ps(z, len), nonzero));
+        }
+#endif
+#if PSH_ARCH_SIMD_SSE2
+        __m128 zero_range = _mm_set1_ps(F32_IS_ZERO_RANGE);
+        for (; idx + 4 <= count; idx += 4) {
+            __m128 x = _mm_loadu_ps(vectors.x + idx);
+            __m128 y = _mm_loadu_ps(vectors.y + idx);
+            __m128 z = _mm_loadu_ps(vectors.z + idx);
+
+            __m128 len     = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+            __m128 nonzero = _mm_cmpge_ps(len, zero_range);
+
+            _mm_storeu_ps(out.x + idx, _mm_and_ps(_mm_div_ps(x, len), nonzero));
+            _mm_storeu_ps(out.y + idx, _mm_and_ps(_mm_div_ps(y, len), nonzero));
+            _mm_storeu_ps(out.z + idx, _mm_and_ps(_mm_div_ps(z, len), nonzero));
+        }
+#elif PSH_IMPL_VEC_NEON_A64
+        float32x4_t zero_range = vdupq_n_f32(F32_IS_ZERO_RANGE);
+        for (; idx + 4 <= count; idx += 4) {
+            float32x4_t x = vld1q_f32(vectors.x + idx);
+            float32x4_t y = vld1q_f32(vectors.y + idx);
+            float32x4_t z = vld1q_f32(vectors.z + idx);
+
+            float32x4_t len     = vsqrtq_f32(vmlaq_f32(vmlaq_f32(vmulq_f32(x, x), y, y), z, z));
+            uint32x4_t  nonzero = vcgeq_f32(len, zero_range);
+
+            vst1q_f32(out.x + idx, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vdivq_f32(x, len)), nonzero)));
+            vst1q_f32(out.y + idx, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vdivq_f32(y, len)), nonzero)));
+            vst1q_f32(out.z + idx, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vdivq_f32(z, len)), nonzero)));
+        }
+#endif
+
+        for (; idx < count; ++idx) {
+            vec3_stream_set(out, idx, vec3_stream_get(vectors, idx).normalised());
+        }
+    }
+
+    psh_proc void batch_dot(FatPtr<f32> out, Vec3Stream lhs, Vec3Stream rhs) psh_no_except {
+        psh_validate_usage({
+            psh_assert_msg(lhs.count == rhs.count, "The streams should have the same count.");
+            psh_assert_msg(out.count == lhs.count, "The output should have the same count as the input.");
+        });
+
+        usize count = lhs.count;
+        usize idx   = 0;
+
+#if PSH_ARCH_SIMD_AVX
+        for (; idx + 8 <= count; idx += 8) {
+            __m256 dot = _mm256_mul_ps(_mm256_loadu_ps(lhs.x + idx), _mm256_loadu_ps(rhs.x + idx));
+            dot        = _mm256_add_ps(dot, _mm256_mul_ps(_mm256_loadu_ps(lhs.y + idx), _mm256_loadu_ps(rhs.y + idx)));
+            dot        = _mm256_add_ps(dot, _mm256_mul_ps(_mm256_loadu_ps(lhs.z + idx), _mm256_loadu_ps(rhs.z + idx)));
+            _mm256_storeu_ps(out.buf + idx, dot);
+        }
+#endif
+#if PSH_ARCH_SIMD_SSE2
+        for (; idx + 4 <= count; idx += 4) {
+            __m128 dot = _mm_mul_ps(_mm_loadu_ps(lhs.x + idx), _mm_loadu_ps(rhs.x + idx));
+            dot        = _mm_add_ps(dot, _mm_mul_ps(_mm_loadu_ps(lhs.y + idx), _mm_loadu_ps(rhs.y + idx)));
+            dot        = _mm_add_ps(dot, _mm_mul_ps(_mm_loadu_ps(lhs.z + idx), _mm_loadu_ps(rhs.z + idx)));
+            _mm_storeu_ps(out.buf + idx, dot);
+        }
+#elif PSH_ARCH_SIMD_NEON
+        for (; idx + 4 <= count; idx += 4) {
+            float32x4_t dot = vmulq_f32(vld1q_f32(lhs.x + idx), vld1q_f32(rhs.x + idx));
+            dot             = vmlaq_f32(dot, vld1q_f32(lhs.y + idx), vld1q_f32(rhs.y + idx));
+            dot             = vmlaq_f32(dot, vld1q_f32(lhs.z + idx), vld1q_f32(rhs.z + idx));
+            vst1q_f32(out.buf + idx, dot);
+        }
+#endif
+
+        for (; idx < count; ++idx) {
+            out.buf[idx] = (lhs.x[idx] * rhs.x[idx]) + (lhs.y[idx] * rhs.y[idx]) + (lhs.z[idx] * rhs.z[idx]);
+        }
     }
 }  // namespace psh
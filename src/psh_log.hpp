@@ -0,0 +1,399 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Asynchronous logging backend.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+///
+/// The asynchronous logger replaces the default log writer, which writes each message to the
+/// standard error stream on the calling thread. Logging threads only copy their formatted message
+/// into a lock-free ring buffer, while a background flusher thread writes batches of messages to
+/// the sink with a single vectored write.
+///
+/// Binary logging goes further by skipping the formatting of the messages altogether, see the
+/// binary logging section below.
+
+#pragma once
+
+#include "psh_atomic.hpp"
+#include "psh_core.hpp"
+#include "psh_debug.hpp"
+#include "psh_memory.hpp"
+#include "psh_platform.hpp"
+#include "psh_thread.hpp"
+#include "psh_time.hpp"
+
+namespace psh {
+    /// Native file the logs are written to: a file descriptor on Unix, and a file handle on Windows.
+#if PSH_OS_WINDOWS
+    using LogSink = void*;
+#elif PSH_OS_UNIX
+    using LogSink = i32;
+#endif
+
+    /// Get the sink of the standard error stream.
+    psh_proc LogSink log_sink_stderr() psh_no_except;
+
+    psh_global constexpr usize ASYNC_LOGGER_DEFAULT_BUFFER_SIZE = psh_mebibytes(1);
+
+    /// Logger handing the messages over to a background flusher thread.
+    ///
+    /// The ring buffer is a sequence of records, each composed of an 8-byte header followed by the
+    /// message. Producers reserve records by atomically advancing the tail, and publish them by
+    /// setting the committed bit of the header once the message is copied. The flusher writes the
+    /// committed records in order, zeroes their memory, and advances the head.
+    struct AsyncLogger {
+        u8*   buf      = nullptr;
+        usize capacity = 0;
+
+        /// Position up to which the buffer was reserved by producers.
+        alignas(CACHE_LINE_SIZE) Atomic<u64> tail = {};
+
+        /// Position up to which the buffer was written to the sink.
+        alignas(CACHE_LINE_SIZE) Atomic<u64> head = {};
+
+        Atomic<u32>       running          = {};
+        Atomic<u32>       flusher_sleeping = {};
+        Mutex             mutex;
+        ConditionVariable cv;
+        Thread            flusher;
+        LogSink           sink;
+        bool              owns_sink = false;
+
+        /// Whether the logger receives binary log records instead of text messages.
+        bool binary = false;
+    };
+
+    /// Initialise an asynchronous logger, which becomes the destination of all log messages until
+    /// destroyed.
+    ///
+    /// Parameters:
+    ///     * logger: Logger to be initialised, it should outlive its flusher thread.
+    ///     * arena: Arena providing the ring buffer, it should outlive the logger.
+    ///     * sink: File where the logs are written to, it isn't closed by the logger.
+    ///     * buffer_size: Size of the ring buffer, should be a power of two. Messages longer than
+    ///                    half of the buffer are truncated. If the buffer fills up, logging threads
+    ///                    wait for the flusher to catch up.
+    psh_proc Status init_async_logger(
+        AsyncLogger* logger,
+        Arena*       arena,
+        LogSink      sink        = log_sink_stderr(),
+        usize        buffer_size = ASYNC_LOGGER_DEFAULT_BUFFER_SIZE) psh_no_except;
+
+    /// Initialise an asynchronous logger appending its messages to the file at the given path.
+    psh_proc Status init_async_logger(
+        AsyncLogger* logger,
+        Arena*       arena,
+        cstring      path,
+        usize        buffer_size = ASYNC_LOGGER_DEFAULT_BUFFER_SIZE) psh_no_except;
+
+    /// Write all pending messages, join the flusher thread, and restore the default log writer.
+    ///
+    /// If the logger is a binary logger, binary log calls are discarded from now on.
+    psh_proc void destroy_async_logger(AsyncLogger* logger) psh_no_except;
+
+    /// Block until all messages logged before the call are written to the sink.
+    ///
+    /// Fatal messages are always flushed before the log call returns.
+    psh_proc void async_logger_flush(AsyncLogger* logger) psh_no_except;
+
+    /// Log writer enqueuing the messages to the asynchronous logger given as context.
+    psh_proc void async_logger_write(void* context, impl::LogInfo const& info, char const* msg, usize length) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Binary logging.
+    //
+    // Binary log calls don't format their messages: each record holds the identifier of its call
+    // site, a timestamp obtained via current_time_in_seconds, and the raw values of the arguments.
+    // The format string, location, and level of a call site are only written alongside the first
+    // record of the site reaching the binary logger. The logs are then turned into text offline by
+    // binary_log_decode, which is also available as the tools/psh_log_decoder program.
+    //
+    // Record layout, in native byte order:
+    //
+    //     u32 size          Size of the whole record in bytes.
+    //     u32 site_id       Identifier of the call site, its highest bit flags a site definition.
+    //     f64 timestamp     Time of the call, in seconds.
+    //     [definition]      Level as u8, line as u32, then the format, file name, and function name
+    //                       strings of the call site.
+    //     [arguments]       A BinaryLogArgType tag as u8 followed by the value, for each argument.
+    //
+    // Strings are encoded as a u16 length followed by their characters. Each logging session starts
+    // with the BINARY_LOG_MAGIC bytes, which never match the size of a record, so that a file may
+    // be appended to by multiple sessions.
+    //
+    // Usage example:
+    //
+    //     AsyncLogger logger;
+    //     init_binary_logger(&logger, &arena, "trace.bin");
+    //
+    //     psh_log_binary_debug("Processed %u entities in %f seconds.", entity_count, elapsed);
+    //
+    //     destroy_async_logger(&logger);
+    // -------------------------------------------------------------------------------------------------
+
+    psh_global constexpr usize BINARY_LOG_MAX_RECORD_SIZE = 1024;
+
+    /// Maximum number of call sites of binary log calls in a program. Calls from sites past this
+    /// limit are discarded, and the decoder rejects the definitions of such sites.
+    psh_global constexpr u32 BINARY_LOG_MAX_SITE_COUNT = u32{1} << 16u;
+    psh_global constexpr u8  BINARY_LOG_MAGIC[8]       = {'P', 'S', 'H', 'B', 'L', 'O', 'G', '1'};
+
+    /// Minimum buffer size of a binary logger, so that a record of maximum size fits in half of it.
+    psh_global constexpr usize BINARY_LOGGER_MIN_BUFFER_SIZE = 4 * BINARY_LOG_MAX_RECORD_SIZE;
+
+    enum BinaryLogArgType : u8 {
+        BINARY_LOG_ARG_I32 = 1,
+        BINARY_LOG_ARG_U32,
+        BINARY_LOG_ARG_I64,
+        BINARY_LOG_ARG_U64,
+        BINARY_LOG_ARG_F64,
+        BINARY_LOG_ARG_STRING,
+        BINARY_LOG_ARG_POINTER,
+    };
+
+    /// Initialise an asynchronous logger receiving the records of all binary log calls until
+    /// destroyed. The default log writer is untouched, text and binary logs never share a sink.
+    ///
+    /// Parameters:
+    ///     * logger: Logger to be initialised, it should outlive its flusher thread.
+    ///     * arena: Arena providing the ring buffer, it should outlive the logger.
+    ///     * sink: File where the records are written to, it isn't closed by the logger.
+    ///     * buffer_size: Size of the ring buffer, should be a power of two no smaller than
+    ///                    BINARY_LOGGER_MIN_BUFFER_SIZE.
+    psh_proc Status init_binary_logger(
+        AsyncLogger* logger,
+        Arena*       arena,
+        LogSink      sink,
+        usize        buffer_size = ASYNC_LOGGER_DEFAULT_BUFFER_SIZE) psh_no_except;
+
+    /// Initialise a binary logger appending its records to the file at the given path.
+    psh_proc Status init_binary_logger(
+        AsyncLogger* logger,
+        Arena*       arena,
+        cstring      path,
+        usize        buffer_size = ASYNC_LOGGER_DEFAULT_BUFFER_SIZE) psh_no_except;
+
+    /// Decode binary log records into text messages.
+    ///
+    /// Each message is handed to the writer formatted as the text logs, prefixed by its timestamp.
+    /// Records of unknown call sites are skipped, as well as arguments not matching the conversion
+    /// specifiers of their format.
+    ///
+    /// Parameters:
+    ///     * arena: Arena used for the table of call sites.
+    ///     * data: Contents of a binary log file.
+    ///     * writer: Procedure receiving the decoded messages.
+    ///     * context: Context passed to the writer.
+    ///
+    /// Return: Whether all records were successfully decoded.
+    psh_proc Status binary_log_decode(Arena* arena, FatPtr<u8 const> data, LogWriter* writer, void* context = nullptr) psh_no_except;
+}  // namespace psh
+
+namespace psh::impl {
+    /// Static description of a binary log call site.
+    struct BinaryLogSite {
+        cstring  format;
+        cstring  file_name;
+        cstring  function_name;
+        u32      line;
+        LogLevel level;
+
+        /// Identifier of the site, assigned on its first call.
+        Atomic<u32> id = {};
+
+        /// Generation of the binary logger that last received the definition of the site.
+        Atomic<u32> defined_generation = {};
+    };
+
+    /// Record being encoded on the stack of the logging thread.
+    struct BinaryLogEncoder {
+        AsyncLogger*   logger;
+        BinaryLogSite* site;
+        u32            generation;
+        bool           defines_site;
+        bool           truncated;
+        usize          count;
+        u8             buf[BINARY_LOG_MAX_RECORD_SIZE];
+    };
+
+    /// Start the encoding of a record.
+    ///
+    /// Return: Whether the record should be encoded, which is false if there's no binary logger.
+    psh_proc bool binary_log_begin(BinaryLogEncoder* encoder, BinaryLogSite* site) psh_no_except;
+
+    /// Hand the encoded record over to the binary logger.
+    psh_proc void binary_log_end(BinaryLogEncoder* encoder) psh_no_except;
+
+    /// Append an argument to the record. Arguments not fitting the record are dropped, along with
+    /// all arguments following them.
+    psh_proc psh_inline void binary_log_pack_value(
+        BinaryLogEncoder* encoder,
+        BinaryLogArgType  type,
+        void const*       value,
+        usize             size) psh_no_except {
+        if (psh_unlikely(encoder->truncated || (encoder->count + 1u + size > BINARY_LOG_MAX_RECORD_SIZE))) {
+            encoder->truncated = true;
+            return;
+        }
+
+        encoder->buf[encoder->count] = type;
+        memory_copy(encoder->buf + encoder->count + 1u, reinterpret_cast<u8 const*>(value), size);
+        encoder->count += 1u + size;
+    }
+
+    psh_proc void binary_log_pack_string(BinaryLogEncoder* encoder, cstring str) psh_no_except;
+
+    // Overloads for each fundamental type, integers are widened to either 32 or 64 bits.
+
+    psh_proc psh_inline void binary_log_pack_i32(BinaryLogEncoder* encoder, i32 value) psh_no_except {
+        binary_log_pack_value(encoder, BINARY_LOG_ARG_I32, &value, sizeof(value));
+    }
+    psh_proc psh_inline void binary_log_pack_u32(BinaryLogEncoder* encoder, u32 value) psh_no_except {
+        binary_log_pack_value(encoder, BINARY_LOG_ARG_U32, &value, sizeof(value));
+    }
+    psh_proc psh_inline void binary_log_pack_i64(BinaryLogEncoder* encoder, i64 value) psh_no_except {
+        binary_log_pack_value(encoder, BINARY_LOG_ARG_I64, &value, sizeof(value));
+    }
+    psh_proc psh_inline void binary_log_pack_u64(BinaryLogEncoder* encoder, u64 value) psh_no_except {
+        binary_log_pack_value(encoder, BINARY_LOG_ARG_U64, &value, sizeof(value));
+    }
+
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, bool value) psh_no_except {
+        binary_log_pack_i32(encoder, static_cast<i32>(value));
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, char value) psh_no_except {
+        binary_log_pack_i32(encoder, static_cast<i32>(value));
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, signed char value) psh_no_except {
+        binary_log_pack_i32(encoder, static_cast<i32>(value));
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, short value) psh_no_except {
+        binary_log_pack_i32(encoder, static_cast<i32>(value));
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, int value) psh_no_except {
+        binary_log_pack_i32(encoder, static_cast<i32>(value));
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, long value) psh_no_except {
+        binary_log_pack_i64(encoder, static_cast<i64>(value));
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, long long value) psh_no_except {
+        binary_log_pack_i64(encoder, static_cast<i64>(value));
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, unsigned char value) psh_no_except {
+        binary_log_pack_u32(encoder, static_cast<u32>(value));
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, unsigned short value) psh_no_except {
+        binary_log_pack_u32(encoder, static_cast<u32>(value));
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, unsigned int value) psh_no_except {
+        binary_log_pack_u32(encoder, static_cast<u32>(value));
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, unsigned long value) psh_no_except {
+        binary_log_pack_u64(encoder, static_cast<u64>(value));
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, unsigned long long value) psh_no_except {
+        binary_log_pack_u64(encoder, static_cast<u64>(value));
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, double value) psh_no_except {
+        binary_log_pack_value(encoder, BINARY_LOG_ARG_F64, &value, sizeof(value));
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, float value) psh_no_except {
+        binary_log_pack(encoder, static_cast<double>(value));
+    }
+
+    /// Strings are copied into the record, they should be zero-terminated.
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, char const* str) psh_no_except {
+        binary_log_pack_string(encoder, str);
+    }
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, char* str) psh_no_except {
+        binary_log_pack_string(encoder, str);
+    }
+
+    /// Any other pointer is logged by its address.
+    template <typename T>
+    psh_proc psh_inline void binary_log_pack(BinaryLogEncoder* encoder, T* ptr) psh_no_except {
+        u64 address = static_cast<u64>(reinterpret_cast<uptr>(ptr));
+        binary_log_pack_value(encoder, BINARY_LOG_ARG_POINTER, &address, sizeof(address));
+    }
+
+    template <typename... Args>
+    psh_proc void binary_log(BinaryLogSite* site, Args... args) psh_no_except {
+        BinaryLogEncoder encoder;
+        if (!binary_log_begin(&encoder, site)) {
+            return;
+        }
+        (binary_log_pack(&encoder, args), ...);
+        binary_log_end(&encoder);
+    }
+
+    /// Never called, only lets the compiler check the arguments against the format string.
+    psh_proc psh_inline psh_attribute_fmt(1) void binary_log_check_format(cstring fmt, ...) psh_no_except {
+        psh_discard_value(fmt);
+    }
+}  // namespace psh::impl
+
+// -------------------------------------------------------------------------------------------------
+// Binary logging macros.
+//
+// The call site description is stored in a static variable, so that its identifier is kept
+// across calls. Calls whose level is less severe than PSH_LOG_MIN_LEVEL are compiled out.
+// -------------------------------------------------------------------------------------------------
+
+#define psh_impl_log_binary(log_level, fmt, ...)                                          \
+    do {                                                                                  \
+        if (false) {                                                                      \
+            psh::impl::binary_log_check_format(fmt __VA_OPT__(, ) __VA_ARGS__);           \
+        }                                                                                 \
+        static psh::impl::BinaryLogSite psh_binary_log_site_ = {                          \
+            .format        = fmt,                                                         \
+            .file_name     = psh_source_file_name(),                                      \
+            .function_name = psh_source_function_name(),                                  \
+            .line          = psh_source_line_number(),                                    \
+            .level         = log_level,                                                   \
+        };                                                                                \
+        psh::impl::binary_log(&psh_binary_log_site_ __VA_OPT__(, ) __VA_ARGS__);          \
+    } while (0)
+
+#if PSH_LOG_MIN_LEVEL >= PSH_LOG_LEVEL_FATAL
+#    define psh_log_binary_fatal(fmt, ...) psh_impl_log_binary(psh::impl::LOG_LEVEL_FATAL, fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#    define psh_log_binary_fatal(fmt, ...) 0
+#endif
+#if PSH_LOG_MIN_LEVEL >= PSH_LOG_LEVEL_ERROR
+#    define psh_log_binary_error(fmt, ...) psh_impl_log_binary(psh::impl::LOG_LEVEL_ERROR, fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#    define psh_log_binary_error(fmt, ...) 0
+#endif
+#if PSH_LOG_MIN_LEVEL >= PSH_LOG_LEVEL_WARNING
+#    define psh_log_binary_warning(fmt, ...) psh_impl_log_binary(psh::impl::LOG_LEVEL_WARNING, fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#    define psh_log_binary_warning(fmt, ...) 0
+#endif
+#if PSH_LOG_MIN_LEVEL >= PSH_LOG_LEVEL_INFO
+#    define psh_log_binary_info(fmt, ...) psh_impl_log_binary(psh::impl::LOG_LEVEL_INFO, fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#    define psh_log_binary_info(fmt, ...) 0
+#endif
+#if PSH_LOG_MIN_LEVEL >= PSH_LOG_LEVEL_DEBUG
+#    define psh_log_binary_debug(fmt, ...) psh_impl_log_binary(psh::impl::LOG_LEVEL_DEBUG, fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#    define psh_log_binary_debug(fmt, ...) 0
+#endif
@@ -24,8 +24,22 @@
 
 #pragma once
 
+#include "psh_atomic.hpp"
+#include "psh_bit.hpp"
 #include "psh_core.hpp"
 #include "psh_debug.hpp"
+#include "psh_platform.hpp"
+
+#if PSH_COMPILER_MSVC && !PSH_COMPILER_CLANG
+#    include <string.h>
+#    pragma intrinsic(memcpy)
+#endif
+
+#if PSH_ARCH_SIMD_SSE2
+#    include <emmintrin.h>
+#elif PSH_ARCH_SIMD_NEON
+#    include <arm_neon.h>
+#endif
 
 namespace psh {
     // -------------------------------------------------------------------------------------------------
@@ -44,39 +58,325 @@ namespace psh {
 
     // -------------------------------------------------------------------------------------------------
     // Virtual memory handling.
-    //
-    // TODO: add procedures for reserving/commiting memory separately.
     // -------------------------------------------------------------------------------------------------
 
+    /// Get the size of a page of virtual memory of the system.
+    psh_proc usize memory_virtual_page_size() psh_no_except;
+
+    /// Get the size of the huge pages of the system, or zero if the system has none. The size is
+    /// read from the system on the first call only.
+    psh_proc usize memory_virtual_huge_page_size() psh_no_except;
+
+    /// Paging options of a range of virtual memory.
+    enum VirtualMemoryFlag : u32 {
+        VIRTUAL_MEMORY_FLAG_NONE = 0,
+
+        /// Back the memory with huge pages reserved by the system (MAP_HUGETLB on Linux,
+        /// MEM_LARGE_PAGES on Windows, which requires the lock pages in memory privilege). The size
+        /// of the memory is rounded up to a multiple of the huge page size. If no huge page is
+        /// available, the memory falls back to transparent huge pages.
+        VIRTUAL_MEMORY_FLAG_HUGE_PAGES = 1u << 0,
+
+        /// Ask the system to back the memory with huge pages whenever possible (madvise with
+        /// MADV_HUGEPAGE). Only available on Linux, ignored elsewhere.
+        VIRTUAL_MEMORY_FLAG_TRANSPARENT_HUGE_PAGES = 1u << 1,
+
+        /// Fault in all of the committed pages at allocation time (MAP_POPULATE on Linux), avoiding
+        /// page faults when the memory is first touched.
+        VIRTUAL_MEMORY_FLAG_PREFAULT = 1u << 2,
+    };
+
+    /// Value of VirtualMemoryOptions::numa_node letting the system choose where the memory lives.
+    psh_global constexpr i32 VIRTUAL_MEMORY_ANY_NUMA_NODE = -1;
+
+    /// Placement and paging options of a range of virtual memory.
+    struct VirtualMemoryOptions {
+        /// Mask of VirtualMemoryFlag values.
+        u32 flags = VIRTUAL_MEMORY_FLAG_NONE;
+
+        /// NUMA node to which the physical memory is bound (mbind on Linux, VirtualAllocExNuma on
+        /// Windows). Binding failures are logged and leave the placement to the system.
+        i32 numa_node = VIRTUAL_MEMORY_ANY_NUMA_NODE;
+    };
+
     /// Reserve and commit a virtual block of memory.
     ///
     /// The memory allocated is always initialised to zero.
     ///
     /// Directly calls the respective system call for allocating memory. Should be
     /// used for large allocations, if you want small allocations, malloc is the way to go.
-    psh_proc u8* memory_virtual_alloc(usize size_bytes) psh_no_except;
+    ///
+    /// Parameters:
+    ///     * size_bytes: Size of the block. If huge pages are requested, the block is large enough
+    ///                   to hold memory_virtual_alloc_size(size_bytes, options) bytes, which is the
+    ///                   size that should be passed to memory_virtual_free.
+    ///     * options: Placement and paging options of the block.
+    psh_proc u8* memory_virtual_alloc(usize size_bytes, VirtualMemoryOptions options = {}) psh_no_except;
+
+    /// Get the actual size of a block of virtual memory allocated with the given options.
+    psh_proc usize memory_virtual_alloc_size(usize size_bytes, VirtualMemoryOptions options) psh_no_except;
 
     /// Release and decommit all memory.
     psh_proc void memory_virtual_free(u8* memory, usize size_bytes) psh_no_except;
 
+    /// Reserve a range of virtual addresses without committing any physical memory to it.
+    ///
+    /// The reserved range cannot be accessed until committed via memory_virtual_commit, and should
+    /// be released via memory_virtual_free.
+    ///
+    /// Reserved memory is committed in regular pages, so both huge page flags ask for transparent
+    /// huge pages, while the NUMA node binding applies to all of the memory committed later. The
+    /// prefault flag has no effect on the reservation, see memory_virtual_commit.
+    psh_proc u8* memory_virtual_reserve(usize size_bytes, VirtualMemoryOptions options = {}) psh_no_except;
+
+    /// Commit physical memory to a range of previously reserved addresses.
+    ///
+    /// Parameters:
+    ///     * memory: Page-aligned start of the range to be committed.
+    ///     * size_bytes: Size of the range, which will be rounded up to a multiple of the page size.
+    ///     * prefault: Whether to fault in the pages of the range right away.
+    psh_proc Status memory_virtual_commit(u8* memory, usize size_bytes, bool prefault = false) psh_no_except;
+
+    /// Return the physical memory of a range of committed addresses to the system, keeping the
+    /// range reserved. The contents of the range are lost.
+    ///
+    /// Parameters:
+    ///     * memory: Page-aligned start of the range to be decommitted.
+    ///     * size_bytes: Size of the range, which will be rounded up to a multiple of the page size.
+    psh_proc void memory_virtual_decommit(u8* memory, usize size_bytes) psh_no_except;
+
     // -------------------------------------------------------------------------------------------------
     // Raw memory manipulation.
     // -------------------------------------------------------------------------------------------------
 
+    // Ranges of at most MEMORY_SMALL_SIZE bytes are handled inline by a pair of overlapping loads
+    // and stores from each end of the range. Larger ranges are handled by out-of-line kernels that
+    // either forward to libc or, when PSH_ENABLE_FREESTANDING_MEMORY is set, use the library's own
+    // SIMD loops. Ranges larger than PSH_MEMORY_NON_TEMPORAL_THRESHOLD are written with
+    // non-temporal stores on x64.
+
+    psh_global constexpr usize MEMORY_SMALL_SIZE = 32;
+
+    /// Maximum size in bytes of the fixed size operations that are expanded inline.
+    psh_global constexpr usize MEMORY_FIXED_INLINE_MAX_SIZE = 256;
+
+    namespace impl {
+#if PSH_COMPILER_MSVC && !PSH_COMPILER_CLANG
+        // MSVC expands memcpy as an intrinsic for constant sizes.
+#    define psh_impl_builtin_memcpy(dst, src, size) memcpy((dst), (src), (size))
+#else
+#    define psh_impl_builtin_memcpy(dst, src, size) __builtin_memcpy((dst), (src), (size))
+#endif
+
+        /// Unaligned word-sized load and store, compiled into a single move instruction.
+        template <typename T>
+        psh_proc psh_inline T memory_load_unaligned(u8 const* src) psh_no_except {
+            T value;
+            psh_impl_builtin_memcpy(&value, src, sizeof(T));
+            return value;
+        }
+        template <typename T>
+        psh_proc psh_inline void memory_store_unaligned(u8* dst, T value) psh_no_except {
+            psh_impl_builtin_memcpy(dst, &value, sizeof(T));
+        }
+
+#undef psh_impl_builtin_memcpy
+
+        /// Copy up to MEMORY_SMALL_SIZE bytes. All loads happen before any store, so the regions
+        /// are allowed to overlap.
+        psh_proc psh_inline void memory_move_small(u8* dst, u8 const* src, usize size_bytes) psh_no_except {
+            if (size_bytes > 16u) {
+                u64 a = memory_load_unaligned<u64>(src);
+                u64 b = memory_load_unaligned<u64>(src + 8u);
+                u64 c = memory_load_unaligned<u64>(src + size_bytes - 16u);
+                u64 d = memory_load_unaligned<u64>(src + size_bytes - 8u);
+                memory_store_unaligned(dst, a);
+                memory_store_unaligned(dst + 8u, b);
+                memory_store_unaligned(dst + size_bytes - 16u, c);
+                memory_store_unaligned(dst + size_bytes - 8u, d);
+            } else if (size_bytes >= 8u) {
+                u64 a = memory_load_unaligned<u64>(src);
+                u64 b = memory_load_unaligned<u64>(src + size_bytes - 8u);
+                memory_store_unaligned(dst, a);
+                memory_store_unaligned(dst + size_bytes - 8u, b);
+            } else if (size_bytes >= 4u) {
+                u32 a = memory_load_unaligned<u32>(src);
+                u32 b = memory_load_unaligned<u32>(src + size_bytes - 4u);
+                memory_store_unaligned(dst, a);
+                memory_store_unaligned(dst + size_bytes - 4u, b);
+            } else if (size_bytes != 0) {
+                u8 a = src[0];
+                u8 b = src[size_bytes / 2u];
+                u8 c = src[size_bytes - 1u];
+                dst[0]                = a;
+                dst[size_bytes / 2u]  = b;
+                dst[size_bytes - 1u]  = c;
+            }
+        }
+
+        /// Set up to MEMORY_SMALL_SIZE bytes.
+        psh_proc psh_inline void memory_set_small(u8* memory, usize size_bytes, u8 fill) psh_no_except {
+            u64 pattern = u64{fill} * 0x0101010101010101ull;
+            if (size_bytes > 16u) {
+                memory_store_unaligned(memory, pattern);
+                memory_store_unaligned(memory + 8u, pattern);
+                memory_store_unaligned(memory + size_bytes - 16u, pattern);
+                memory_store_unaligned(memory + size_bytes - 8u, pattern);
+            } else if (size_bytes >= 8u) {
+                memory_store_unaligned(memory, pattern);
+                memory_store_unaligned(memory + size_bytes - 8u, pattern);
+            } else if (size_bytes >= 4u) {
+                memory_store_unaligned(memory, static_cast<u32>(pattern));
+                memory_store_unaligned(memory + size_bytes - 4u, static_cast<u32>(pattern));
+            } else if (size_bytes != 0) {
+                memory[0]               = fill;
+                memory[size_bytes / 2u] = fill;
+                memory[size_bytes - 1u] = fill;
+            }
+        }
+
+        psh_proc void memory_set_bulk(u8* memory, usize size_bytes, u8 fill) psh_no_except;
+        psh_proc void memory_copy_bulk(u8* psh_no_alias dst, u8 const* psh_no_alias src, usize size_bytes) psh_no_except;
+        psh_proc void memory_move_bulk(u8* dst, u8 const* src, usize size_bytes) psh_no_except;
+    }  // namespace impl
+
     /// Set the value of a given range of bytes.
-    psh_proc void memory_set(u8* memory, usize size_bytes, i32 fill) psh_no_except;
+    psh_proc psh_inline void memory_set(u8* memory, usize size_bytes, i32 fill) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(memory));
+
+        if (size_bytes <= MEMORY_SMALL_SIZE) {
+            impl::memory_set_small(memory, size_bytes, static_cast<u8>(fill));
+        } else {
+            impl::memory_set_bulk(memory, size_bytes, static_cast<u8>(fill));
+        }
+    }
+
+    /// Copy non-overlapping memory regions.
+    psh_proc psh_inline void memory_copy(u8* psh_no_alias dst, u8 const* psh_no_alias src, usize size_bytes) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(dst);
+            psh_assert_not_null(src);
+            psh_assert_no_alias(src, dst);
+        });
+
+#if PSH_ENABLE_ASSERT_MEMCPY_NO_OVERLAP
+        psh_assert_msg(
+            (size_bytes == 0) || (dst + size_bytes <= src) || (src + size_bytes <= dst),
+            "Source and destination overlap in copy region, use memory_move instead.");
+#endif
+
+        if (size_bytes <= MEMORY_SMALL_SIZE) {
+            impl::memory_move_small(dst, src, size_bytes);
+        } else {
+            impl::memory_copy_bulk(dst, src, size_bytes);
+        }
+    }
+
+    /// Copy possibly-overlapping memory regions.
+    psh_proc psh_inline void memory_move(u8* dst, u8 const* src, usize size_bytes) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(dst);
+            psh_assert_not_null(src);
+        });
+
+        if (size_bytes <= MEMORY_SMALL_SIZE) {
+            impl::memory_move_small(dst, src, size_bytes);
+        } else {
+            impl::memory_move_bulk(dst, src, size_bytes);
+        }
+    }
+
+    /// Set a range of bytes whose size is known at compile time.
+    ///
+    /// Sizes of up to MEMORY_FIXED_INLINE_MAX_SIZE bytes are expanded inline into a sequence of
+    /// 16-byte stores, without calling into libc.
+    template <usize size_bytes>
+    psh_proc psh_inline void memory_set_fixed(u8* memory, u8 fill) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(memory));
+
+        if constexpr (size_bytes <= MEMORY_SMALL_SIZE) {
+            impl::memory_set_small(memory, size_bytes, fill);
+        } else if constexpr (size_bytes <= MEMORY_FIXED_INLINE_MAX_SIZE) {
+            u64 pattern = u64{fill} * 0x0101010101010101ull;
+            for (usize offset = 0; offset + 16u <= size_bytes; offset += 16u) {
+                impl::memory_store_unaligned(memory + offset, pattern);
+                impl::memory_store_unaligned(memory + offset + 8u, pattern);
+            }
+            if constexpr ((size_bytes % 16u) != 0) {
+                impl::memory_set_small(memory + size_bytes - 16u, 16u, fill);
+            }
+        } else {
+            impl::memory_set_bulk(memory, size_bytes, fill);
+        }
+    }
+
+    /// Copy non-overlapping memory regions whose size is known at compile time.
+    ///
+    /// Sizes of up to MEMORY_FIXED_INLINE_MAX_SIZE bytes are expanded inline into a sequence of
+    /// 16-byte moves, without calling into libc.
+    template <usize size_bytes>
+    psh_proc psh_inline void memory_copy_fixed(u8* psh_no_alias dst, u8 const* psh_no_alias src) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(dst);
+            psh_assert_not_null(src);
+            psh_assert_no_alias(src, dst);
+        });
+
+        if constexpr (size_bytes <= MEMORY_SMALL_SIZE) {
+            impl::memory_move_small(dst, src, size_bytes);
+        } else if constexpr (size_bytes <= MEMORY_FIXED_INLINE_MAX_SIZE) {
+            for (usize offset = 0; offset + 16u <= size_bytes; offset += 16u) {
+                impl::memory_store_unaligned(dst + offset, impl::memory_load_unaligned<u64>(src + offset));
+                impl::memory_store_unaligned(dst + offset + 8u, impl::memory_load_unaligned<u64>(src + offset + 8u));
+            }
+            if constexpr ((size_bytes % 16u) != 0) {
+                impl::memory_move_small(dst + size_bytes - 16u, src + size_bytes - 16u, 16u);
+            }
+        } else {
+            impl::memory_copy_bulk(dst, src, size_bytes);
+        }
+    }
+
+    /// Copy possibly-overlapping memory regions whose size is known at compile time.
+    template <usize size_bytes>
+    psh_proc psh_inline void memory_move_fixed(u8* dst, u8 const* src) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(dst);
+            psh_assert_not_null(src);
+        });
+
+        if constexpr (size_bytes <= MEMORY_SMALL_SIZE) {
+            impl::memory_move_small(dst, src, size_bytes);
+        } else if constexpr (size_bytes <= MEMORY_FIXED_INLINE_MAX_SIZE) {
+            // Stage the source in a local buffer, which the compiler keeps in registers.
+            u8 staging[size_bytes];
+            memory_copy_fixed<size_bytes>(staging, src);
+            memory_copy_fixed<size_bytes>(dst, staging);
+        } else {
+            impl::memory_move_bulk(dst, src, size_bytes);
+        }
+    }
 
     /// Zero-out all of the members of a given structure.
     template <typename T>
     psh_proc psh_inline void zero_struct(T* s) psh_no_except {
-        memory_set(reinterpret_cast<u8*>(s), psh_usize_of(T), 0);
+        memory_set_fixed<psh_usize_of(T)>(reinterpret_cast<u8*>(s), 0);
     }
 
-    /// Copy non-overlapping memory regions.
-    psh_proc void memory_copy(u8* psh_no_alias dst, u8 const* psh_no_alias src, usize size_bytes) psh_no_except;
+    /// Copy the bytes of a structure into another.
+    template <typename T>
+    psh_proc psh_inline void copy_struct(T* psh_no_alias dst, T const* psh_no_alias src) psh_no_except {
+        memory_copy_fixed<psh_usize_of(T)>(reinterpret_cast<u8*>(dst), reinterpret_cast<u8 const*>(src));
+    }
 
-    /// Copy possibly-overlapping memory regions.
-    psh_proc void memory_move(u8* psh_no_alias dst, u8 const* psh_no_alias src, usize size_bytes) psh_no_except;
+    /// Find the index of the first occurrence of a value in a range of memory.
+    ///
+    /// The range is scanned in blocks of 16 or 32 bytes when SSE2, AVX2 or NEON are available.
+    ///
+    /// Return: The index of the first match, or -1 if the value isn't present.
+    psh_proc isize memory_find_u8(u8 const* memory, usize count, u8 value) psh_no_except;
+    psh_proc isize memory_find_u32(u32 const* memory, usize count, u32 value) psh_no_except;
+    psh_proc isize memory_find_u64(u64 const* memory, usize count, u64 value) psh_no_except;
 
     // -------------------------------------------------------------------------------------------------
     // Alignment utilities.
@@ -114,6 +414,143 @@ namespace psh {
     ///         by alignment.
     psh_proc uptr align_forward(uptr ptr, u32 alignment) psh_no_except;
 
+    // -------------------------------------------------------------------------------------------------
+    // Allocation instrumentation.
+    //
+    // When PSH_ENABLE_MEMORY_INSTRUMENTATION is set, each allocator keeps statistics of its usage in
+    // a stats member, and every allocation is attributed to the call site of the allocation
+    // procedure, which is passed as an extra defaulted argument. Otherwise, neither the statistics
+    // nor the extra argument exist, leaving the allocators untouched.
+    //
+    // Allocations done by the Presheaf containers are attributed to the container procedures.
+    //
+    // Usage example:
+    //
+    //     Arena frame_arena = make_owned_arena(psh_mebibytes(8));
+    //     // Run a few frames...
+    //
+    //     memory_report_allocator_stats("frame arena", &frame_arena.stats);
+    //     memory_report_allocation_sites();
+    // -------------------------------------------------------------------------------------------------
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+// Call site arguments of the allocation procedures: the declaration, with its default values, the
+// definition parameters, and the forwarding of the arguments to another allocation procedure.
+//
+// @NOTE: The location is passed as separate arguments since GCC evaluates the source location
+//        builtins at the declaration, rather than at the call site, when they are part of an
+//        aggregate initialiser in a default argument.
+#    define psh_impl_alloc_site_decl                                       \
+        , cstring alloc_site_file     = psh_source_file_name(),            \
+          cstring alloc_site_function = psh_source_caller_function_name(), \
+          u32     alloc_site_line     = psh_source_line_number()
+#    define psh_impl_alloc_site_param \
+        , cstring alloc_site_file, cstring alloc_site_function, u32 alloc_site_line
+#    define psh_impl_alloc_site_arg , alloc_site_file, alloc_site_function, alloc_site_line
+
+// Source location of the call site, within a procedure declared with the call site arguments.
+#    define psh_impl_alloc_site                   \
+        psh::SourceLocation {                     \
+            .file_name     = alloc_site_file,     \
+            .function_name = alloc_site_function, \
+            .line          = alloc_site_line,     \
+        }
+#else
+#    define psh_impl_alloc_site_decl
+#    define psh_impl_alloc_site_param
+#    define psh_impl_alloc_site_arg
+#endif
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+    /// Usage statistics of an allocator.
+    struct AllocatorStats {
+        /// Number of successful and failed allocations.
+        usize allocation_count = 0;
+        usize failed_count     = 0;
+
+        /// Number of blocks given back, for allocators that are able to free individual blocks.
+        usize free_count = 0;
+
+        /// Total number of bytes requested by all allocations.
+        usize bytes_allocated = 0;
+
+        /// Total number of bytes wasted by all allocations in order to align their blocks or round
+        /// their sizes, excluding block headers.
+        usize padding_bytes = 0;
+
+        /// Highest amount of memory in use by the allocator at any given time, including padding
+        /// and headers. This is the capacity the allocator needed so far.
+        usize peak_used_bytes = 0;
+
+        /// Number of reallocations, and the number of bytes copied by those that had to move their
+        /// block.
+        usize realloc_count      = 0;
+        usize realloc_copy_bytes = 0;
+    };
+
+    /// Statistics of the allocations done at a given call site.
+    struct AllocationSiteStats {
+        SourceLocation location;
+        usize          allocation_count;
+        usize          bytes_allocated;
+    };
+
+    /// Maximum number of distinct call sites tracked, allocations from any further sites are only
+    /// counted in aggregate.
+    psh_global constexpr usize MEMORY_INSTRUMENTATION_MAX_SITES = 1024;
+
+    /// Procedure receiving each line of a memory report.
+    ///
+    /// Parameters:
+    ///     * context: Context passed alongside the writer.
+    ///     * msg: Line of the report, including its trailing line feed. It is only valid during the call.
+    ///     * length: Number of characters of the line.
+    using MemoryReportWriter = void(void* context, char const* msg, usize length);
+
+    /// Write the statistics of an allocator.
+    ///
+    /// Parameters:
+    ///     * name: Name identifying the allocator in the report.
+    ///     * stats: Statistics of the allocator.
+    ///     * writer: Destination of the report. If null, the report is written to the standard error
+    ///               stream.
+    ///     * context: Context passed to the writer.
+    psh_proc void memory_report_allocator_stats(
+        cstring               name,
+        AllocatorStats const* stats,
+        MemoryReportWriter*   writer  = nullptr,
+        void*                 context = nullptr) psh_no_except;
+
+    /// Write the statistics of all call sites of allocations, sorted by the number of bytes
+    /// allocated, with the same destination semantics as memory_report_allocator_stats.
+    psh_proc void memory_report_allocation_sites(MemoryReportWriter* writer = nullptr, void* context = nullptr) psh_no_except;
+
+    /// Copy the statistics of the call sites that allocated the most bytes.
+    ///
+    /// Return: The number of call sites written.
+    psh_proc usize memory_allocation_sites(AllocationSiteStats* sites, usize max_count) psh_no_except;
+
+    /// Forget all recorded call sites.
+    psh_proc void memory_reset_allocation_sites() psh_no_except;
+
+    namespace impl {
+        /// Record a successful allocation of an allocator.
+        ///
+        /// Parameters:
+        ///     * stats: Statistics of the allocator, or null if the allocator has none.
+        ///     * site: Call site of the allocation.
+        ///     * size_bytes: Number of bytes requested.
+        ///     * padding_bytes: Number of bytes lost to the alignment of the block.
+        ///     * used_bytes: Memory in use by the allocator after the allocation.
+        psh_proc void memory_record_allocation(
+            AllocatorStats*       stats,
+            SourceLocation const& site,
+            usize                 size_bytes,
+            usize                 padding_bytes,
+            usize                 used_bytes) psh_no_except;
+    }  // namespace impl
+#endif
+
     // -------------------------------------------------------------------------------------------------
     // Arena memory allocator.
     // -------------------------------------------------------------------------------------------------
@@ -128,6 +565,17 @@ namespace psh {
     struct ArenaCheckpoint {
         Arena* arena;
         usize  saved_offset;
+        u8*    saved_buf;  // Block of a chained arena in which the checkpoint was made.
+    };
+
+    /// Header placed at the start of each block linked by a chained arena, recording the state of
+    /// the arena in the previous block.
+    struct ArenaBlockHeader {
+        ArenaBlockHeader* previous;  // Null if the previous block is the first block of the arena.
+        u8*               previous_buf;
+        usize             previous_capacity;
+        usize             previous_offset;
+        usize             previous_reserved;
     };
 
     /// Arena allocator
@@ -135,14 +583,57 @@ namespace psh {
     /// The arena allocator is great for the management of temporary allocation of memory, since an
     /// allocation takes nothing more than incrementing an offset.
     ///
+    /// An arena created via make_reserved_arena only commits the memory it needs: the capacity is the
+    /// amount of memory committed so far, which grows in multiples of commit_chunk_size until the
+    /// whole reserved range has been committed. If decommit_threshold is non-zero, clearing the
+    /// arena will return to the system all committed memory above the threshold.
+    ///
+    /// An arena created via make_chained_arena never runs out of memory: when an allocation doesn't
+    /// fit, a new block is linked to the arena, taken from virtual memory or from a parent arena. The
+    /// blocks grow geometrically, and a block is always big enough for the allocation that caused
+    /// it. The buf, capacity and offset members always describe the current block. Restoring a
+    /// checkpoint, destroying a scratch arena or clearing the arena unlinks the blocks that were
+    /// chained after the matching point, giving their memory back.
+    ///
     /// @NOTE: - The arena does not own memory, thus it is not responsible for the freeing of it.
-    ///        - All allocation procedures will zero-out the whole allocated block.
+    ///        - All allocation procedures will zero-out the whole allocated block, except for
+    ///          the _uninit variants.
     struct Arena {
         u8*   buf;
-        usize capacity = 0;
-        usize offset   = 0;
+        usize capacity           = 0;
+        usize offset             = 0;
+        usize reserved           = 0;
+        usize commit_chunk_size  = 0;
+        usize decommit_threshold = 0;
+        bool  commit_prefault    = false;  // Whether committed chunks are faulted in right away.
+
+        ArenaBlockHeader* chain_block  = nullptr;  // Header of the current block, null while in the first block.
+        Arena*            chain_parent = nullptr;  // Source of the blocks, or null to use virtual memory.
+        bool              chained      = false;
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        AllocatorStats stats = {};
+#endif
     };
 
+    /// Default amount of memory committed at once by arenas with reserved memory.
+    psh_global constexpr usize ARENA_DEFAULT_COMMIT_CHUNK_SIZE = psh_kibibytes(64);
+
+    namespace impl {
+        /// Commit memory to a reserved arena so that its capacity is at least a given size.
+        psh_proc Status arena_commit(Arena* arena, usize min_capacity) psh_no_except;
+
+        /// Decommit all arena memory exceeding the arena decommit threshold.
+        psh_proc void arena_decommit_excess(Arena* arena) psh_no_except;
+
+        /// Link a new block to a chained arena, big enough for an allocation of a given size and
+        /// alignment.
+        psh_proc Status arena_chain_block(Arena* arena, usize size_bytes, u32 alignment) psh_no_except;
+
+        /// Unlink the blocks of a chained arena until its current block is the one starting at a
+        /// given address, or until the first block if the address is null.
+        psh_proc void arena_unchain_blocks(Arena* arena, u8 const* until_buf) psh_no_except;
+    }  // namespace impl
+
     psh_proc psh_inline Arena make_arena(u8* buf, usize capacity) psh_no_except {
         return Arena{
             .buf      = buf,
@@ -159,20 +650,74 @@ namespace psh {
     }
 
     /// Reset the offset of the allocator.
+    ///
+    /// If the arena has a decommit threshold and its committed memory exceeds it, the excess
+    /// memory is decommitted.
     psh_proc psh_inline void arena_clear(Arena* arena) psh_no_except {
         psh_paranoid_validate_usage(psh_assert_not_null(arena));
+
+        if (psh_unlikely(arena->chain_block != nullptr)) {
+            impl::arena_unchain_blocks(arena, nullptr);
+        }
         arena->offset = 0;
+
+        if (psh_unlikely((arena->decommit_threshold != 0) && (arena->capacity > arena->decommit_threshold))) {
+            impl::arena_decommit_excess(arena);
+        }
     }
 
     /// Make an arena that owns its memory.
     ///
+    /// Parameters:
+    ///     * capacity: Capacity of the arena, which is rounded up to a multiple of the huge page
+    ///                 size if huge pages are requested.
+    ///     * options: Placement and paging options of the memory of the arena.
+    ///
     /// Since the arena is not aware of the ownership, this function call has to be paired
     /// with destroy_owned_arena.
-    psh_proc Arena make_owned_arena(usize capacity) psh_no_except;
+    psh_proc Arena make_owned_arena(usize capacity, VirtualMemoryOptions options = {}) psh_no_except;
+
+    /// Make an arena that owns a reserved range of virtual memory, committing memory only when
+    /// needed by the allocations.
+    ///
+    /// Parameters:
+    ///     * reserve_size: Size of the range of reserved virtual memory, this is the arena's maximum
+    ///                     capacity. Reserving is cheap, the size can be as large as the address
+    ///                     space allows.
+    ///     * commit_chunk_size: Granularity in which memory is committed, rounded up to a multiple
+    ///                          of the page size.
+    ///     * decommit_threshold: Maximum amount of committed memory to be kept by arena_clear. If
+    ///                           zero, the memory is never decommitted.
+    ///     * options: Placement and paging options of the reserved memory, see
+    ///                memory_virtual_reserve. If prefaulting is requested, each committed chunk is
+    ///                faulted in as it gets committed.
+    ///
+    /// Since the arena is not aware of the ownership, this function call has to be paired
+    /// with destroy_owned_arena.
+    psh_proc Arena make_reserved_arena(
+        usize                reserve_size,
+        usize                commit_chunk_size  = ARENA_DEFAULT_COMMIT_CHUNK_SIZE,
+        usize                decommit_threshold = 0,
+        VirtualMemoryOptions options            = {}) psh_no_except;
+
+    /// Make an arena that links new blocks of memory whenever it runs out of memory.
+    ///
+    /// Parameters:
+    ///     * first_block_size: Capacity of the first block, which should fit the common workload of
+    ///                         the arena.
+    ///     * parent: Arena providing the memory of the blocks, it should outlive the arena. If null,
+    ///               the blocks are taken from virtual memory. A block can only be given back to
+    ///               the parent if it is still the last allocation of the parent, otherwise it
+    ///               lives until the parent is cleared.
+    ///
+    /// Since the arena is not aware of the ownership, this function call has to be paired
+    /// with destroy_owned_arena.
+    psh_proc Arena make_chained_arena(usize first_block_size, Arena* parent = nullptr) psh_no_except;
 
     /// Free the memory of an arena that owns its memory.
     ///
-    /// This function should only be called for arenas that where created by make_owned_arena.
+    /// This function should only be called for arenas that where created by make_owned_arena,
+    /// make_reserved_arena or make_chained_arena.
     psh_proc void destroy_owned_arena(Arena* arena) psh_no_except;
 
     /// Create a restorable checkpoint for the arena. This is a more flexible alternative to the
@@ -182,13 +727,19 @@ namespace psh {
         return ArenaCheckpoint{
             .arena        = arena,
             .saved_offset = arena->offset,
+            .saved_buf    = arena->buf,
         };
     }
 
     /// Restore the arena state to a given checkpoint.
     psh_proc psh_inline void arena_checkpoint_restore(ArenaCheckpoint checkpoint) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(checkpoint.arena));
+
+        if (psh_unlikely(checkpoint.arena->buf != checkpoint.saved_buf)) {
+            impl::arena_unchain_blocks(checkpoint.arena, checkpoint.saved_buf);
+        }
+
         psh_paranoid_validate_usage({
-            psh_assert_not_null(checkpoint.arena);
             psh_assert_fmt(
                 checkpoint.saved_offset <= checkpoint.arena->offset,
                 "Invalid checkpoint. Cannot restore the arena to an offset (%zu) bigger than the current (%zu).",
@@ -211,14 +762,19 @@ namespace psh {
     struct ScratchArena {
         Arena* arena = nullptr;
         usize  saved_offset;
+        u8*    saved_buf;
 
         psh_inline ScratchArena(Arena* arena_) psh_no_except {
             psh_paranoid_validate_usage(psh_assert_not_null(arena_));
             this->arena        = arena_;
             this->saved_offset = arena_->offset;
+            this->saved_buf    = arena_->buf;
         }
 
         psh_inline ~ScratchArena() psh_no_except {
+            if (psh_unlikely(this->arena->buf != this->saved_buf)) {
+                impl::arena_unchain_blocks(this->arena, this->saved_buf);
+            }
             this->arena->offset = this->saved_offset;
         }
 
@@ -227,6 +783,90 @@ namespace psh {
         ScratchArena& operator=(ScratchArena&) = delete;
     };
 
+    // -------------------------------------------------------------------------------------------------
+    // Thread local scratch arenas.
+    //
+    // Each thread owns a small pool of reserved arenas for temporary allocations, created on first
+    // use and released when the thread exits. A procedure that needs temporary memory asks for a
+    // scratch arena that doesn't conflict with the arenas it received for its persistent results:
+    //
+    //     String make_report(Arena* persistent, Data const* data) {
+    //         ScratchArena scratch = get_scratch(persistent);
+    //         ... temporary allocations via scratch.arena ...
+    //         ... the result is allocated via persistent ...
+    //     }
+    //
+    // Since a scratch arena is never the arena of a caller's persistent results, the callee can
+    // freely allocate into any of the arenas it received, including a scratch arena of its caller,
+    // without its results being discarded when its own scratch goes out of scope. A procedure takes
+    // at most SCRATCH_ARENA_COUNT - 1 conflicting arenas.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_global constexpr usize SCRATCH_ARENA_COUNT = 2;
+
+    /// Address space reserved by each scratch arena, which 32-bit targets can't spare in gibibytes.
+    psh_global constexpr usize SCRATCH_ARENA_RESERVE_SIZE =
+        (sizeof(usize) >= sizeof(u64)) ? static_cast<usize>(psh_gibibytes(8ull)) : psh_mebibytes(usize{256});
+
+    namespace impl {
+        /// Find a scratch arena of the calling thread that isn't any of the given arenas.
+        psh_proc Arena* scratch_arena_acquire(Arena* const* conflicts, usize conflict_count) psh_no_except;
+    }  // namespace impl
+
+    /// Get a scratch arena of the calling thread, distinct from the given conflicting arenas.
+    psh_proc psh_inline ScratchArena get_scratch() psh_no_except {
+        return ScratchArena{impl::scratch_arena_acquire(nullptr, 0)};
+    }
+    psh_proc psh_inline ScratchArena get_scratch(Arena* conflict) psh_no_except {
+        return ScratchArena{impl::scratch_arena_acquire(&conflict, 1)};
+    }
+    psh_proc psh_inline ScratchArena get_scratch(Arena* const* conflicts, usize conflict_count) psh_no_except {
+        return ScratchArena{impl::scratch_arena_acquire(conflicts, conflict_count)};
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Thread safe arena allocator.
+    // -------------------------------------------------------------------------------------------------
+
+    /// Arena allocator that can be shared between threads.
+    ///
+    /// Allocations reserve their memory block by atomically bumping the offset of the arena, there
+    /// are no locks involved. Since every allocation has to touch the shared offset, threads doing
+    /// many small allocations should instead carve a sub-arena out of the atomic arena via
+    /// make_sub_arena and allocate from it without any synchronisation.
+    ///
+    /// @NOTE: - The arena does not own memory, thus it is not responsible for the freeing of it.
+    ///        - All allocation procedures will zero-out the whole allocated block, except for
+    ///          the _uninit variants.
+    ///        - Clearing the arena is not thread safe, it should only be done when no other
+    ///          thread is using the arena.
+    struct AtomicArena {
+        u8*           buf;
+        usize         capacity = 0;
+        Atomic<usize> offset   = {};
+    };
+
+    psh_proc psh_inline AtomicArena make_atomic_arena(u8* buf, usize capacity) psh_no_except {
+        return AtomicArena{
+            .buf      = buf,
+            .capacity = (buf != nullptr) ? capacity : 0,
+            .offset   = {0},
+        };
+    }
+
+    /// Reset the offset of the allocator.
+    psh_proc psh_inline void atomic_arena_clear(AtomicArena* arena) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(arena));
+        atomic_store(&arena->offset, usize{0}, MemoryOrder::RELEASE);
+    }
+
+    /// Create a sub-arena whose memory is a block allocated from a parent arena.
+    ///
+    /// The sub-arena memory is alive for as long as the parent memory is. If the parent has no memory
+    /// left for the sub-arena, the resulting arena has no capacity.
+    psh_proc Arena make_sub_arena(AtomicArena* parent, usize capacity psh_impl_alloc_site_decl) psh_no_except;
+    psh_proc Arena make_sub_arena(Arena* parent, usize capacity psh_impl_alloc_site_decl) psh_no_except;
+
     // -------------------------------------------------------------------------------------------------
     // Stack memory allocator.
     // -------------------------------------------------------------------------------------------------
@@ -290,6 +930,9 @@ namespace psh {
         usize capacity        = 0;
         usize offset          = 0;
         usize previous_offset = 0;
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        AllocatorStats stats = {};
+#endif
 
         psh_inline void init(u8* buf_, usize capacity_) psh_no_except {
             psh_paranoid_validate_usage(psh_assert_msg(this->capacity == 0, "Stack already initialised."));
@@ -344,122 +987,674 @@ namespace psh {
     };
 
     // -------------------------------------------------------------------------------------------------
-    // Memory allocation manager based on the stack allocator.
+    // Pool memory allocator.
     // -------------------------------------------------------------------------------------------------
 
-    // @TODO: Add the following capabilities
-    // - Resizing.
-    // - Reserving memory without commiting.
-    // - Commiting memory manually.
-    // - More memory statistics for debugging purposes.
+    namespace impl {
+        /// Free block of a pool, linked to the next free block through the memory of the block itself.
+        struct PoolFreeBlock {
+            PoolFreeBlock* next;
+        };
 
-    /// A stack allocator manager that can be used as the central memory resource of an application.
-    struct MemoryManager {
-        usize allocation_count = 0;
-        Stack allocator        = {};
+        /// Header of a chunk of blocks acquired from virtual memory.
+        struct PoolChunk {
+            PoolChunk* next;
+            usize      size_bytes;
+        };
+    }  // namespace impl
 
-        /// Allocate memory and initialise the underlying memory allocator.
-        void init(usize capacity) psh_no_except;
+    psh_global constexpr usize POOL_DEFAULT_BLOCKS_PER_CHUNK = 256;
 
-        /// Free all acquired memory.
-        void destroy() psh_no_except;
+    /// Pool allocator of fixed size blocks.
+    ///
+    /// The free blocks are kept in an intrusive list, so that both allocating and freeing a block take
+    /// constant time, no matter the order in which blocks are freed. Whenever the list runs out of
+    /// blocks, the pool acquires a new chunk of blocks, either from its arena or, if the pool has no
+    /// arena, directly from virtual memory.
+    ///
+    /// Threads sharing a pool should only access it via a PoolCache owned by each thread. In that
+    /// case, the arena of the pool, if any, shouldn't be used by any other thread while the pool is
+    /// alive. Prefer pools backed by virtual memory for such use cases.
+    ///
+    /// @NOTE: - Chunks taken from an arena are only given back when the arena itself is cleared.
+    ///        - All allocation procedures will zero-out the whole allocated block, except for
+    ///          the _uninit variants.
+    struct Pool {
+        impl::PoolFreeBlock* free_list        = nullptr;
+        impl::PoolChunk*     chunks           = nullptr;
+        Arena*               arena            = nullptr;
+        usize                block_size       = 0;
+        u32                  block_alignment  = 0;
+        usize                blocks_per_chunk = 0;
+        usize                block_count      = 0;
+        usize                free_count       = 0;
+        Atomic<u32>          lock             = {};
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        AllocatorStats stats = {};
+#endif
+    };
 
-        /// Try to free the last allocated block of memory.
-        Status pop() psh_no_except;
+    /// Initialise a pool of fixed size blocks.
+    ///
+    /// Parameters:
+    ///     * arena: Arena providing the chunks of the pool, it should outlive the pool. If null, the
+    ///              chunks are allocated from virtual memory.
+    ///     * block_size: Size of each block, rounded up to hold at least a pointer.
+    ///     * block_alignment: Alignment of each block, it should be a power of two.
+    ///     * blocks_per_chunk: Number of blocks acquired each time the pool runs out of blocks. Chunks
+    ///                         allocated from virtual memory are rounded up to fill whole pages.
+    psh_proc Status init_pool(
+        Pool*  pool,
+        Arena* arena,
+        usize  block_size,
+        u32    block_alignment,
+        usize  blocks_per_chunk = POOL_DEFAULT_BLOCKS_PER_CHUNK) psh_no_except;
 
-        /// Try to reset the allocator offset until the specified memory block.
-        ///
-        /// Note: If the caller passes a pointer to a wrong address and we can't tell that easily,
-        ///       the stack will be *completely cleaned*, beware!
-        ///
-        /// Parameters:
-        ///     - block: Pointer to the memory block that should be freed (all blocks above
-        ///              the given one will also be freed). If this pointer is null, outside of
-        ///              the stack allocator buffer, or already free, the program return false and
-        ///              won't panic.
-        Status clear_until(u8 const* block) psh_no_except;
+    /// Initialise a pool whose blocks hold objects of type T.
+    template <typename T>
+    psh_proc psh_inline Status init_pool(Pool* pool, Arena* arena, usize blocks_per_chunk = POOL_DEFAULT_BLOCKS_PER_CHUNK) psh_no_except {
+        return init_pool(pool, arena, psh_usize_of(T), alignof(T), blocks_per_chunk);
+    }
 
-        /// Resets the manager by zeroing the memory offset and statistics.
-        void clear() psh_no_except;
+    /// Release the chunks acquired from virtual memory and reset the pool.
+    ///
+    /// All blocks of the pool are invalidated, including the ones held by caches.
+    psh_proc void destroy_pool(Pool* pool) psh_no_except;
 
-        // @NOTE: Required when compiling as a DLL since the compiler will require all standard member
-        //        functions to be defined.
-        MemoryManager& operator=(MemoryManager&) = delete;
-    };
+    namespace impl {
+        /// Acquire a new chunk of blocks, adding them to the free list of the pool.
+        psh_proc Status pool_grow(Pool* pool) psh_no_except;
+    }  // namespace impl
 
-    // -------------------------------------------------------------------------------------------------
-    // Memory handling using the Presheaf custom allocators.
-    // -------------------------------------------------------------------------------------------------
+    /// Allocate a block from the pool without zeroing its contents.
+    ///
+    /// The first bytes of the block hold the link of the free list of the pool, so the block should
+    /// be assumed to contain garbage.
+    psh_proc psh_inline u8* pool_alloc_block_uninit(Pool* pool psh_impl_alloc_site_decl) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(pool));
+
+        if (psh_unlikely(pool->free_list == nullptr) && !impl::pool_grow(pool)) {
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+            ++pool->stats.failed_count;
+#endif
+            return nullptr;
+        }
 
-    /// Allocate a new block of memory with a given alignment.
-    psh_proc u8* memory_alloc_align(Arena* arena, usize size_bytes, u32 alignment) psh_no_except;
-    psh_proc u8* memory_alloc_align(Stack* stack, usize size_bytes, u32 alignment) psh_no_except;
+        impl::PoolFreeBlock* free_block = pool->free_list;
+        pool->free_list                 = free_block->next;
+        --pool->free_count;
 
-    /// Allocates a new block of memory capable of holding a certain count of elements of a
-    /// given type.
-    template <typename T>
-    psh_proc psh_inline T* memory_alloc(Arena* arena, usize count) psh_no_except {
-        return reinterpret_cast<T*>(memory_alloc_align(arena, psh_usize_of(T) * count, alignof(T)));
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        impl::memory_record_allocation(&pool->stats, psh_impl_alloc_site, pool->block_size, 0, (pool->block_count - pool->free_count) * pool->block_size);
+#endif
+
+        return reinterpret_cast<u8*>(free_block);
     }
-    template <typename T>
-    psh_proc psh_inline T* memory_alloc(Stack* stack, usize count) psh_no_except {
-        return reinterpret_cast<T*>(memory_alloc_align(stack, psh_usize_of(T) * count, alignof(T)));
+
+    /// Allocate a zeroed block from the pool.
+    psh_proc psh_inline u8* pool_alloc_block(Pool* pool psh_impl_alloc_site_decl) psh_no_except {
+        u8* block = pool_alloc_block_uninit(pool psh_impl_alloc_site_arg);
+        if (psh_likely(block != nullptr)) {
+            memory_set(block, pool->block_size, 0);
+        }
+        return block;
     }
-    template <typename T>
-    psh_proc psh_inline T* memory_alloc(MemoryManager* memory_manager, usize count) psh_no_except {
-        if (memory_manager == nullptr) {
-            return nullptr;
+
+    /// Give a block back to the pool. Freeing a null block is a no-op.
+    psh_proc psh_inline void pool_free_block(Pool* pool, u8* block) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(pool);
+            psh_assert_msg(
+                (reinterpret_cast<uptr>(block) & (pool->block_alignment - 1u)) == 0,
+                "Pointer isn't aligned as a block of the pool.");
+        });
+
+        if (psh_unlikely(block == nullptr)) {
+            return;
         }
 
-        T* const new_block = memory_alloc<T>(&memory_manager->allocator, count);
-        memory_manager->allocation_count += static_cast<usize>(new_block != nullptr);
-        return new_block;
+        impl::PoolFreeBlock* free_block = reinterpret_cast<impl::PoolFreeBlock*>(block);
+        free_block->next                = pool->free_list;
+        pool->free_list                 = free_block;
+        ++pool->free_count;
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        ++pool->stats.free_count;
+#endif
     }
 
-    /// Reallocate an existing block of memory with a given alignment.
-    psh_proc u8* memory_realloc_align(
-        Arena* arena,
-        u8*    block,
-        usize  current_size_bytes,
-        usize  new_size_bytes,
-        u32    alignment) psh_no_except;
-    psh_proc u8* memory_realloc_align(
-        Stack* stack,
-        u8*    block,
-        usize  new_size_bytes,
-        u32    alignment) psh_no_except;
+    template <typename T>
+    psh_proc psh_inline T* pool_alloc(Pool* pool psh_impl_alloc_site_decl) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(pool);
+            psh_assert_msg(psh_usize_of(T) <= pool->block_size, "Type doesn't fit in the blocks of the pool.");
+            psh_assert_msg(alignof(T) <= pool->block_alignment, "Type alignment exceeds the alignment of the pool.");
+        });
+        return reinterpret_cast<T*>(pool_alloc_block(pool psh_impl_alloc_site_arg));
+    }
 
-    /// Reallocate a block of memory of a given type.
-    ///
-    /// Parameters:
-    ///     - block: Pointer to the start of the memory block to be resized.
-    ///     - current_count: The current number of entities of type T that fits in the block.
-    ///     - new_count: Number of entities of type T that the new memory block should be
-    ///                  able to contain.
     template <typename T>
-    psh_proc psh_inline T* memory_realloc(Arena* arena, T* block, usize current_count, usize new_count) psh_no_except {
-        return reinterpret_cast<T*>(memory_realloc_align(
+    psh_proc psh_inline void pool_free(Pool* pool, T* object) psh_no_except {
+        pool_free_block(pool, reinterpret_cast<u8*>(object));
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Thread-local cache of pool blocks.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_global constexpr u32 POOL_CACHE_DEFAULT_CAPACITY = 64;
+
+    /// Front-end of a pool shared between threads.
+    ///
+    /// Each thread owns a cache holding up to capacity free blocks, so that most allocations and frees
+    /// don't synchronise with other threads. When empty, the cache takes half of its capacity in
+    /// blocks from the pool, and when full, it gives half of its blocks back to the pool, holding the
+    /// lock of the pool only while the batch is moved.
+    ///
+    /// A cache is typically a thread_local variable. Its blocks should be given back to the pool via
+    /// pool_cache_flush before the thread exits.
+    ///
+    /// When instrumented, the allocations done via a cache are only recorded in the statistics of the
+    /// cache, since the pool statistics aren't synchronised.
+    struct PoolCache {
+        Pool*                pool      = nullptr;
+        impl::PoolFreeBlock* free_list = nullptr;
+        u32                  count     = 0;
+        u32                  capacity  = POOL_CACHE_DEFAULT_CAPACITY;
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        AllocatorStats stats = {};
+#endif
+    };
+
+    psh_proc psh_inline PoolCache make_pool_cache(Pool* pool, u32 capacity = POOL_CACHE_DEFAULT_CAPACITY) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(pool);
+            psh_assert_msg(capacity >= 2, "Pool caches should be able to hold at least two blocks.");
+        });
+        return PoolCache{
+            .pool      = pool,
+            .free_list = nullptr,
+            .count     = 0,
+            .capacity  = capacity,
+        };
+    }
+
+    /// Give all blocks held by the cache back to the pool.
+    psh_proc void pool_cache_flush(PoolCache* cache) psh_no_except;
+
+    namespace impl {
+        /// Move a batch of blocks from the pool to an empty cache.
+        psh_proc Status pool_cache_refill(PoolCache* cache) psh_no_except;
+
+        /// Move a given number of blocks from the cache back to its pool.
+        psh_proc void pool_cache_drain(PoolCache* cache, u32 count) psh_no_except;
+    }  // namespace impl
+
+    /// Allocate a block via the cache, only touching the pool if the cache is empty. The contents of
+    /// the block aren't zeroed.
+    psh_proc psh_inline u8* pool_alloc_block_uninit(PoolCache* cache psh_impl_alloc_site_decl) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(cache));
+
+        if (psh_unlikely(cache->free_list == nullptr) && !impl::pool_cache_refill(cache)) {
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+            ++cache->stats.failed_count;
+#endif
+            return nullptr;
+        }
+
+        impl::PoolFreeBlock* free_block = cache->free_list;
+        cache->free_list                = free_block->next;
+        --cache->count;
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        // Blocks may be freed by caches other than the one that allocated them.
+        usize blocks_in_use = cache->stats.allocation_count - psh_min_value(cache->stats.free_count, cache->stats.allocation_count);
+        impl::memory_record_allocation(&cache->stats, psh_impl_alloc_site, cache->pool->block_size, 0, (blocks_in_use + 1) * cache->pool->block_size);
+#endif
+
+        return reinterpret_cast<u8*>(free_block);
+    }
+
+    /// Allocate a zeroed block via the cache.
+    psh_proc psh_inline u8* pool_alloc_block(PoolCache* cache psh_impl_alloc_site_decl) psh_no_except {
+        u8* block = pool_alloc_block_uninit(cache psh_impl_alloc_site_arg);
+        if (psh_likely(block != nullptr)) {
+            memory_set(block, cache->pool->block_size, 0);
+        }
+        return block;
+    }
+
+    /// Give a block back via the cache, only touching the pool if the cache is full. Freeing a null
+    /// block is a no-op.
+    ///
+    /// The block may have been allocated by any cache of the same pool.
+    psh_proc psh_inline void pool_free_block(PoolCache* cache, u8* block) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(cache);
+            psh_assert_msg(
+                (reinterpret_cast<uptr>(block) & (cache->pool->block_alignment - 1u)) == 0,
+                "Pointer isn't aligned as a block of the pool.");
+        });
+
+        if (psh_unlikely(block == nullptr)) {
+            return;
+        }
+
+        if (psh_unlikely(cache->count == cache->capacity)) {
+            impl::pool_cache_drain(cache, cache->capacity / 2);
+        }
+
+        impl::PoolFreeBlock* free_block = reinterpret_cast<impl::PoolFreeBlock*>(block);
+        free_block->next                = cache->free_list;
+        cache->free_list                = free_block;
+        ++cache->count;
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        ++cache->stats.free_count;
+#endif
+    }
+
+    template <typename T>
+    psh_proc psh_inline T* pool_alloc(PoolCache* cache psh_impl_alloc_site_decl) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(cache);
+            psh_assert_msg(psh_usize_of(T) <= cache->pool->block_size, "Type doesn't fit in the blocks of the pool.");
+            psh_assert_msg(alignof(T) <= cache->pool->block_alignment, "Type alignment exceeds the alignment of the pool.");
+        });
+        return reinterpret_cast<T*>(pool_alloc_block(cache psh_impl_alloc_site_arg));
+    }
+
+    template <typename T>
+    psh_proc psh_inline void pool_free(PoolCache* cache, T* object) psh_no_except {
+        pool_free_block(cache, reinterpret_cast<u8*>(object));
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Two-level segregated fit memory allocator.
+    // -------------------------------------------------------------------------------------------------
+
+    namespace impl {
+        /// Header of a block managed by the TLSF allocator.
+        ///
+        /// Memory layout:
+        ///
+        ///     |prev_physical|size|       memory       |
+        ///                        ^                    ^
+        ///                        |-------size---------|-> next block, whose prev_physical field
+        ///                                                 overlaps the last bytes of the memory.
+        ///
+        /// Only the size field is overhead for blocks in use: the previous physical block pointer is
+        /// only valid when the previous block is free, and the free list links are only valid when
+        /// the block itself is free. The two lowest bits of the size flag whether the block and the
+        /// previous physical block are free.
+        struct TlsfBlock {
+            TlsfBlock* prev_physical;
+            usize      size;
+            TlsfBlock* next_free;
+            TlsfBlock* prev_free;
+        };
+
+        psh_global constexpr u32   TLSF_ALIGN_SIZE_LOG2     = 3;
+        psh_global constexpr usize TLSF_ALIGN_SIZE          = usize{1} << TLSF_ALIGN_SIZE_LOG2;
+        psh_global constexpr u32   TLSF_SL_INDEX_COUNT_LOG2 = 5;
+        psh_global constexpr u32   TLSF_SL_INDEX_COUNT      = 1u << TLSF_SL_INDEX_COUNT_LOG2;
+        psh_global constexpr u32   TLSF_FL_INDEX_MAX        = 40;
+        psh_global constexpr u32   TLSF_FL_INDEX_SHIFT      = TLSF_SL_INDEX_COUNT_LOG2 + TLSF_ALIGN_SIZE_LOG2;
+        psh_global constexpr u32   TLSF_FL_INDEX_COUNT      = TLSF_FL_INDEX_MAX - TLSF_FL_INDEX_SHIFT + 1;
+    }  // namespace impl
+
+    /// General purpose allocator based on the two-level segregated fit algorithm.
+    ///
+    /// Free blocks are kept in lists segregated by size: the first level splits sizes into power of
+    /// two ranges, and the second level linearly splits each range into 32 classes. A bitmap of the
+    /// non-empty lists allows allocations to find a large enough block with a couple of bit scans,
+    /// while freed blocks are immediately merged with their free neighbours. Both allocation and
+    /// freeing take constant time, and the waste is bounded by the size class granularity.
+    ///
+    /// @NOTE: - The allocator does not own memory, thus it is not responsible for the freeing of it.
+    ///        - All allocation procedures will zero-out the whole allocated block, except for
+    ///          the _uninit variants.
+    struct Tlsf {
+        u8*              buf              = nullptr;
+        usize            capacity         = 0;
+        impl::TlsfBlock* sentinel         = nullptr;
+        usize            allocation_count = 0;
+        usize            used_bytes       = 0;
+        usize            peak_used_bytes  = 0;
+        u64              fl_bitmap        = 0;
+        u32              sl_bitmap[impl::TLSF_FL_INDEX_COUNT];
+        impl::TlsfBlock* free_lists[impl::TLSF_FL_INDEX_COUNT][impl::TLSF_SL_INDEX_COUNT];
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        AllocatorStats stats = {};
+#endif
+    };
+
+    /// Initialise the allocator, managing a given memory buffer.
+    ///
+    /// Parameters:
+    ///     * buf: Memory to be managed, aligned to at least 8 bytes.
+    ///     * capacity: Size of the memory buffer.
+    psh_proc Status init_tlsf(Tlsf* tlsf, u8* buf, usize capacity) psh_no_except;
+
+    /// Change the size of the memory managed by the allocator, keeping all allocated blocks.
+    ///
+    /// When growing, the memory past the current capacity should be valid up to the new capacity.
+    /// Shrinking only succeeds if the memory being cut isn't part of any allocated block.
+    psh_proc Status tlsf_resize(Tlsf* tlsf, usize new_capacity) psh_no_except;
+
+    /// Get the usable size of an allocated block, which may be larger than the requested size.
+    psh_proc usize tlsf_block_size(u8 const* block) psh_no_except;
+
+    /// Get the size of the largest block that can currently be allocated without alignment padding.
+    psh_proc usize tlsf_largest_free_block(Tlsf const* tlsf) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Memory allocation manager.
+    // -------------------------------------------------------------------------------------------------
+
+    /// Allocator used by a memory manager to distribute its memory.
+    enum struct MemoryManagerBackend {
+        /// Blocks can only be freed in LIFO order, via pop and clear_until.
+        STACK,
+
+        /// Blocks can be freed in any order, via memory_free.
+        TLSF,
+    };
+
+    struct MemoryManagerStats {
+        usize allocation_count;
+        usize used_bytes;
+        usize peak_used_bytes;
+        usize largest_free_block;
+        usize capacity;
+        usize reserved;
+    };
+
+    /// A memory manager that can be used as the central memory resource of an application.
+    ///
+    /// The manager reserves a range of virtual memory up-front and only commits the memory within
+    /// its current capacity, which can later be changed via resize without moving any block.
+    struct MemoryManager {
+        usize                allocation_count  = 0;
+        Stack                allocator         = {};
+        Tlsf                 general_allocator = {};
+        MemoryManagerBackend backend           = MemoryManagerBackend::STACK;
+        u8*                  buf               = nullptr;
+        usize                reserved          = 0;
+        usize                committed         = 0;
+        usize                peak_used_bytes   = 0;
+        bool                 commit_prefault   = false;
+
+        /// Reserve and commit memory and initialise the underlying memory allocator.
+        ///
+        /// Parameters:
+        ///     - capacity: Amount of memory committed up-front.
+        ///     - backend: Allocator used to distribute the memory.
+        ///     - reserve_size: Maximum capacity the manager may be resized to. If smaller than the
+        ///                     capacity, the capacity is used.
+        ///     - options: Placement and paging options of the reserved memory, see
+        ///                memory_virtual_reserve. Prefaulting applies to the memory committed at
+        ///                initialisation and by later resizes.
+        void init(
+            usize                capacity,
+            MemoryManagerBackend backend_     = MemoryManagerBackend::STACK,
+            usize                reserve_size = 0,
+            VirtualMemoryOptions options      = {}) psh_no_except;
+
+        /// Free all acquired memory.
+        void destroy() psh_no_except;
+
+        /// Try to free the last allocated block of memory.
+        ///
+        /// Only available for managers backed by a stack.
+        Status pop() psh_no_except;
+
+        /// Try to reset the allocator offset until the specified memory block.
+        ///
+        /// Only available for managers backed by a stack.
+        ///
+        /// Note: If the caller passes a pointer to a wrong address and we can't tell that easily,
+        ///       the stack will be *completely cleaned*, beware!
+        ///
+        /// Parameters:
+        ///     - block: Pointer to the memory block that should be freed (all blocks above
+        ///              the given one will also be freed). If this pointer is null, outside of
+        ///              the stack allocator buffer, or already free, the program return false and
+        ///              won't panic.
+        Status clear_until(u8 const* block) psh_no_except;
+
+        /// Change the capacity of the manager, committing or decommitting memory as needed.
+        ///
+        /// The capacity can't exceed the reserved memory, nor cut through memory in use.
+        Status resize(usize new_capacity) psh_no_except;
+
+        /// Get the current memory statistics of the manager.
+        MemoryManagerStats stats() const psh_no_except;
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        /// Get the instrumentation statistics of the allocator backing the manager.
+        AllocatorStats const* allocator_stats() const psh_no_except;
+#endif
+
+        /// Resets the manager by zeroing the memory offset and statistics.
+        void clear() psh_no_except;
+
+        // @NOTE: Required when compiling as a DLL since the compiler will require all standard member
+        //        functions to be defined.
+        MemoryManager& operator=(MemoryManager&) = delete;
+    };
+
+    // -------------------------------------------------------------------------------------------------
+    // Memory handling using the Presheaf custom allocators.
+    // -------------------------------------------------------------------------------------------------
+
+    /// Allocate a new block of memory with a given alignment.
+    psh_proc u8* memory_alloc_align(Arena* arena, usize size_bytes, u32 alignment psh_impl_alloc_site_decl) psh_no_except;
+    psh_proc u8* memory_alloc_align(Stack* stack, usize size_bytes, u32 alignment psh_impl_alloc_site_decl) psh_no_except;
+    psh_proc u8* memory_alloc_align(AtomicArena* arena, usize size_bytes, u32 alignment psh_impl_alloc_site_decl) psh_no_except;
+    psh_proc u8* memory_alloc_align(Tlsf* tlsf, usize size_bytes, u32 alignment psh_impl_alloc_site_decl) psh_no_except;
+
+    /// Allocate a new block of memory with a given alignment, without zeroing its contents.
+    ///
+    /// Prefer these variants when the whole block is going to be overwritten right away, such as
+    /// when reading a file or copying data into the block.
+    psh_proc u8* memory_alloc_align_uninit(Arena* arena, usize size_bytes, u32 alignment psh_impl_alloc_site_decl) psh_no_except;
+    psh_proc u8* memory_alloc_align_uninit(Stack* stack, usize size_bytes, u32 alignment psh_impl_alloc_site_decl) psh_no_except;
+    psh_proc u8* memory_alloc_align_uninit(AtomicArena* arena, usize size_bytes, u32 alignment psh_impl_alloc_site_decl) psh_no_except;
+    psh_proc u8* memory_alloc_align_uninit(Tlsf* tlsf, usize size_bytes, u32 alignment psh_impl_alloc_site_decl) psh_no_except;
+
+    /// Allocates a new block of memory capable of holding a certain count of elements of a
+    /// given type.
+    template <typename T>
+    psh_proc psh_inline T* memory_alloc(Arena* arena, usize count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_alloc_align(arena, psh_usize_of(T) * count, alignof(T) psh_impl_alloc_site_arg));
+    }
+    template <typename T>
+    psh_proc psh_inline T* memory_alloc(Stack* stack, usize count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_alloc_align(stack, psh_usize_of(T) * count, alignof(T) psh_impl_alloc_site_arg));
+    }
+    template <typename T>
+    psh_proc psh_inline T* memory_alloc(AtomicArena* arena, usize count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_alloc_align(arena, psh_usize_of(T) * count, alignof(T) psh_impl_alloc_site_arg));
+    }
+    template <typename T>
+    psh_proc psh_inline T* memory_alloc(Tlsf* tlsf, usize count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_alloc_align(tlsf, psh_usize_of(T) * count, alignof(T) psh_impl_alloc_site_arg));
+    }
+    template <typename T>
+    psh_proc psh_inline T* memory_alloc(MemoryManager* memory_manager, usize count psh_impl_alloc_site_decl) psh_no_except {
+        if (memory_manager == nullptr) {
+            return nullptr;
+        }
+
+        T* new_block;
+        if (memory_manager->backend == MemoryManagerBackend::TLSF) {
+            new_block = memory_alloc<T>(&memory_manager->general_allocator, count psh_impl_alloc_site_arg);
+        } else {
+            new_block                       = memory_alloc<T>(&memory_manager->allocator, count psh_impl_alloc_site_arg);
+            memory_manager->peak_used_bytes = psh_max_value(memory_manager->peak_used_bytes, memory_manager->allocator.offset);
+        }
+
+        memory_manager->allocation_count += static_cast<usize>(new_block != nullptr);
+        return new_block;
+    }
+
+    /// Allocates a new block of memory capable of holding a certain count of elements of a given
+    /// type, without zeroing its contents.
+    template <typename T>
+    psh_proc psh_inline T* memory_alloc_uninit(Arena* arena, usize count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_alloc_align_uninit(arena, psh_usize_of(T) * count, alignof(T) psh_impl_alloc_site_arg));
+    }
+    template <typename T>
+    psh_proc psh_inline T* memory_alloc_uninit(Stack* stack, usize count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_alloc_align_uninit(stack, psh_usize_of(T) * count, alignof(T) psh_impl_alloc_site_arg));
+    }
+    template <typename T>
+    psh_proc psh_inline T* memory_alloc_uninit(AtomicArena* arena, usize count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_alloc_align_uninit(arena, psh_usize_of(T) * count, alignof(T) psh_impl_alloc_site_arg));
+    }
+    template <typename T>
+    psh_proc psh_inline T* memory_alloc_uninit(Tlsf* tlsf, usize count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_alloc_align_uninit(tlsf, psh_usize_of(T) * count, alignof(T) psh_impl_alloc_site_arg));
+    }
+    template <typename T>
+    psh_proc psh_inline T* memory_alloc_uninit(MemoryManager* memory_manager, usize count psh_impl_alloc_site_decl) psh_no_except {
+        if (memory_manager == nullptr) {
+            return nullptr;
+        }
+
+        T* new_block;
+        if (memory_manager->backend == MemoryManagerBackend::TLSF) {
+            new_block = memory_alloc_uninit<T>(&memory_manager->general_allocator, count psh_impl_alloc_site_arg);
+        } else {
+            new_block                       = memory_alloc_uninit<T>(&memory_manager->allocator, count psh_impl_alloc_site_arg);
+            memory_manager->peak_used_bytes = psh_max_value(memory_manager->peak_used_bytes, memory_manager->allocator.offset);
+        }
+
+        memory_manager->allocation_count += static_cast<usize>(new_block != nullptr);
+        return new_block;
+    }
+
+    /// Reallocate an existing block of memory with a given alignment.
+    psh_proc u8* memory_realloc_align(
+        Arena* arena,
+        u8*    block,
+        usize  current_size_bytes,
+        usize  new_size_bytes,
+        u32    alignment psh_impl_alloc_site_decl) psh_no_except;
+    psh_proc u8* memory_realloc_align(
+        Stack* stack,
+        u8*    block,
+        usize  new_size_bytes,
+        u32    alignment psh_impl_alloc_site_decl) psh_no_except;
+
+    /// Reallocate a block of the TLSF allocator, growing or shrinking it in place whenever possible.
+    ///
+    /// If the block is null, a new block is allocated.
+    psh_proc u8* memory_realloc_align(
+        Tlsf* tlsf,
+        u8*   block,
+        usize new_size_bytes,
+        u32   alignment psh_impl_alloc_site_decl) psh_no_except;
+
+    /// Reallocate an existing block of memory with a given alignment, leaving the memory past the
+    /// contents of the original block uninitialised.
+    psh_proc u8* memory_realloc_align_uninit(
+        Arena* arena,
+        u8*    block,
+        usize  current_size_bytes,
+        usize  new_size_bytes,
+        u32    alignment psh_impl_alloc_site_decl) psh_no_except;
+    psh_proc u8* memory_realloc_align_uninit(
+        Stack* stack,
+        u8*    block,
+        usize  new_size_bytes,
+        u32    alignment psh_impl_alloc_site_decl) psh_no_except;
+    psh_proc u8* memory_realloc_align_uninit(
+        Tlsf* tlsf,
+        u8*   block,
+        usize new_size_bytes,
+        u32   alignment psh_impl_alloc_site_decl) psh_no_except;
+
+    /// Reallocate a block of memory of a given type.
+    ///
+    /// Parameters:
+    ///     - block: Pointer to the start of the memory block to be resized.
+    ///     - current_count: The current number of entities of type T that fits in the block.
+    ///     - new_count: Number of entities of type T that the new memory block should be
+    ///                  able to contain.
+    template <typename T>
+    psh_proc psh_inline T* memory_realloc(Arena* arena, T* block, usize current_count, usize new_count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_realloc_align(
             arena,
             reinterpret_cast<u8*>(block),
             psh_usize_of(T) * current_count,
             psh_usize_of(T) * new_count,
-            alignof(T)));
+            alignof(T) psh_impl_alloc_site_arg));
     }
     template <typename T>
-    psh_proc psh_inline T* memory_realloc(Stack* stack, T* block, usize new_count) psh_no_except {
-        return reinterpret_cast<T*>(memory_realloc_align(stack, block, psh_usize_of(T) * new_count));
+    psh_proc psh_inline T* memory_realloc(Stack* stack, T* block, usize new_count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_realloc_align(stack, reinterpret_cast<u8*>(block), psh_usize_of(T) * new_count, alignof(T) psh_impl_alloc_site_arg));
     }
     template <typename T>
-    psh_proc psh_inline T* memory_realloc(MemoryManager* memory_manager, T* block, usize new_count) psh_no_except {
+    psh_proc psh_inline T* memory_realloc(Tlsf* tlsf, T* block, usize new_count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_realloc_align(tlsf, reinterpret_cast<u8*>(block), psh_usize_of(T) * new_count, alignof(T) psh_impl_alloc_site_arg));
+    }
+    template <typename T>
+    psh_proc psh_inline T* memory_realloc(MemoryManager* memory_manager, T* block, usize new_count psh_impl_alloc_site_decl) psh_no_except {
         if (memory_manager == nullptr) {
             return nullptr;
         }
 
-        T* const new_block = memory_realloc<T>(&memory_manager->allocator, block, new_count);
+        // The TLSF allocator releases the previous block when moving it.
+        if (memory_manager->backend == MemoryManagerBackend::TLSF) {
+            T* const new_block = memory_realloc<T>(&memory_manager->general_allocator, block, new_count psh_impl_alloc_site_arg);
+            memory_manager->allocation_count += static_cast<usize>((block == nullptr) && (new_block != nullptr));
+            return new_block;
+        }
+
+        T* const new_block = memory_realloc<T>(&memory_manager->allocator, block, new_count psh_impl_alloc_site_arg);
         memory_manager->allocation_count += static_cast<usize>(new_block != block);
+        memory_manager->peak_used_bytes = psh_max_value(memory_manager->peak_used_bytes, memory_manager->allocator.offset);
         return new_block;
     }
 
+    /// Reallocate a block of memory of a given type, leaving the new elements uninitialised.
+    template <typename T>
+    psh_proc psh_inline T* memory_realloc_uninit(Arena* arena, T* block, usize current_count, usize new_count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_realloc_align_uninit(
+            arena,
+            reinterpret_cast<u8*>(block),
+            psh_usize_of(T) * current_count,
+            psh_usize_of(T) * new_count,
+            alignof(T) psh_impl_alloc_site_arg));
+    }
+    template <typename T>
+    psh_proc psh_inline T* memory_realloc_uninit(Stack* stack, T* block, usize new_count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_realloc_align_uninit(stack, reinterpret_cast<u8*>(block), psh_usize_of(T) * new_count, alignof(T) psh_impl_alloc_site_arg));
+    }
+    template <typename T>
+    psh_proc psh_inline T* memory_realloc_uninit(Tlsf* tlsf, T* block, usize new_count psh_impl_alloc_site_decl) psh_no_except {
+        return reinterpret_cast<T*>(memory_realloc_align_uninit(tlsf, reinterpret_cast<u8*>(block), psh_usize_of(T) * new_count, alignof(T) psh_impl_alloc_site_arg));
+    }
+
+    /// Free a block of memory allocated by the TLSF allocator. Freeing a null block is a no-op.
+    psh_proc void memory_free(Tlsf* tlsf, u8* block) psh_no_except;
+
+    /// Free a block of memory given by the memory manager.
+    ///
+    /// Managers backed by a stack can only free their last allocated block.
+    psh_proc Status memory_free(MemoryManager* memory_manager, u8* block) psh_no_except;
+
+    template <typename T>
+    psh_proc psh_inline void memory_free(Tlsf* tlsf, T* block) psh_no_except {
+        memory_free(tlsf, reinterpret_cast<u8*>(block));
+    }
+    template <typename T>
+    psh_proc psh_inline Status memory_free(MemoryManager* memory_manager, T* block) psh_no_except {
+        return memory_free(memory_manager, reinterpret_cast<u8*>(block));
+    }
+
     // -------------------------------------------------------------------------------------------------
     // Common code-generation for index-based/iterator access to Presheaf containers.
     //
@@ -696,6 +1891,17 @@ namespace psh {
         };
     }
 
+    /// Create an array whose elements are left uninitialised, should be used when all elements are
+    /// going to be written right away.
+    template <typename T>
+    psh_proc psh_inline Array<T> make_array_uninit(Arena* arena, usize count) psh_no_except {
+        T* buf = memory_alloc_uninit<T>(arena, count);
+        return Array<T>{
+            .buf   = buf,
+            .count = (buf != nullptr) ? count : 0,
+        };
+    }
+
     template <typename T>
     psh_proc psh_inline void init_array(Array<T>* array, Arena* arena, usize count) psh_no_except {
         psh_paranoid_validate_usage({
@@ -725,7 +1931,8 @@ namespace psh {
 
     template <typename T>
     psh_proc psh_inline PushArray<T> make_push_array(Arena* arena, usize max_count) psh_no_except {
-        T* buf = memory_alloc<T>(arena, max_count);
+        // Elements are only readable once pushed, so there's no need to zero the buffer.
+        T* buf = memory_alloc_uninit<T>(arena, max_count);
         return PushArray<T>{
             .buf       = buf,
             .count     = 0,
@@ -740,7 +1947,7 @@ namespace psh {
             psh_assert_msg(push_array->max_count == 0, "Already initialised.");
         });
 
-        T* buf      = memory_alloc<T>(arena, max_count);
+        T* buf      = memory_alloc_uninit<T>(arena, max_count);
         *push_array = {
             .buf       = buf,
             .count     = 0,
@@ -779,7 +1986,8 @@ namespace psh {
 
     /// Effectively bump the element count by one and return the offset to the first new empty element.
     ///
-    /// Note: This procedure won't cleanup the previous values (if any) in these new elements.
+    /// Note: This procedure won't cleanup the previous values (if any) in these new elements, which
+    ///       may be uninitialised memory.
     template <typename T>
     psh_proc psh_inline usize push_array_push_empty(PushArray<T>* push_array, usize empty_count = 1) psh_no_except {
         psh_paranoid_validate_usage(psh_assert_not_null(push_array));
@@ -841,73 +2049,171 @@ namespace psh {
 
     psh_global constexpr usize DYNARRAY_DEFAULT_INITIAL_CAPACITY      = 4;
     psh_global constexpr usize DYNARRAY_RESIZE_CAPACITY_GROWTH_FACTOR = 2;
+    psh_global constexpr usize DYNARRAY_DEFAULT_PAGE_SIZE             = psh_kibibytes(4);
+
+    /// Strategy used to compute the new capacity of a dynamic array when it runs out of space.
+    enum struct DynamicArrayResize {
+        /// Multiply the capacity by the step, or by DYNARRAY_RESIZE_CAPACITY_GROWTH_FACTOR if the
+        /// step is zero.
+        GEOMETRIC,
+
+        /// Multiply the capacity by roughly the golden ratio, which allows an arena-backed array
+        /// that got moved to fit a future request in the memory of its previous blocks.
+        GOLDEN_RATIO,
+
+        /// Double the capacity, rounding the size of the buffer up to a multiple of the step, or of
+        /// DYNARRAY_DEFAULT_PAGE_SIZE if the step is zero.
+        PAGE_GRANULAR,
+
+        /// Add a fixed number of elements, given by the step, to the capacity.
+        FIXED_STEP,
+    };
+
+    struct DynamicArrayResizePolicy {
+        DynamicArrayResize kind = DynamicArrayResize::GEOMETRIC;
+        usize              step = 0;
+    };
+
+    /// Resize policy of newly created dynamic arrays of a given element type.
+    ///
+    /// The policy may be specialised for a type before any dynamic array of the type is created:
+    ///
+    ///     template <>
+    ///     constexpr DynamicArrayResizePolicy DYNARRAY_DEFAULT_RESIZE_POLICY<Event> = {
+    ///         .kind = DynamicArrayResize::FIXED_STEP,
+    ///         .step = 1024,
+    ///     };
+    template <typename T>
+    constexpr DynamicArrayResizePolicy DYNARRAY_DEFAULT_RESIZE_POLICY = {};
+
+    /// Compute the capacity a dynamic array should grow to.
+    ///
+    /// Parameters:
+    ///     * policy: Resize policy of the array.
+    ///     * element_size: Size of the elements of the array, in bytes.
+    ///     * current_capacity: Current capacity of the array.
+    ///     * required_capacity: Minimum capacity the array should have after growing.
+    psh_proc usize dynamic_array_next_capacity(
+        DynamicArrayResizePolicy policy,
+        usize                    element_size,
+        usize                    current_capacity,
+        usize                    required_capacity) psh_no_except;
+
+    /// Policy for the memory acquired by a dynamic array when its capacity grows.
+    ///
+    /// Zeroed growth keeps every element past the count zeroed, which dynamic strings rely upon for
+    /// their null terminator. Uninitialised growth skips the zeroing of the unused capacity, which is
+    /// preferable for arrays whose elements are always pushed before being read.
+    enum struct DynamicArrayGrowth {
+        ZEROED,
+        UNINITIALISED,
+    };
 
     /// Run-time variable length array.
     ///
     /// A dynamic array has its lifetime bound to its associated arena.
     template <typename T>
     struct DynamicArray {
-        T*     buf;
-        Arena* arena;
-        usize  capacity = 0;
-        usize  count    = 0;
+        T*                       buf;
+        Arena*                   arena;
+        usize                    capacity = 0;
+        usize                    count    = 0;
+        DynamicArrayGrowth       growth   = DynamicArrayGrowth::ZEROED;
+        DynamicArrayResizePolicy resize   = DYNARRAY_DEFAULT_RESIZE_POLICY<T>;
 
         psh_impl_generate_container_boilerplate(T, this->buf, this->count)
     };
 
     template <typename T>
     psh_proc psh_inline DynamicArray<T> make_dynamic_array(
-        Arena* arena,
-        usize  capacity = DYNARRAY_DEFAULT_INITIAL_CAPACITY) psh_no_except {
-        T* buf = memory_alloc<T>(arena, capacity);
+        Arena*             arena,
+        usize              capacity = DYNARRAY_DEFAULT_INITIAL_CAPACITY,
+        DynamicArrayGrowth growth   = DynamicArrayGrowth::ZEROED) psh_no_except {
+        T* buf = (growth == DynamicArrayGrowth::ZEROED) ? memory_alloc<T>(arena, capacity) : memory_alloc_uninit<T>(arena, capacity);
         return DynamicArray<T>{
             .buf      = buf,
             .arena    = arena,
             .capacity = (buf != nullptr) ? capacity : 0,
             .count    = 0,
+            .growth   = growth,
         };
     }
 
     /// initialise the dynamic array with a given capacity.
     template <typename T>
     psh_proc psh_inline void init_dynamic_array(
-        DynamicArray<T>* darray,
-        Arena*           arena,
-        usize            capacity = DYNARRAY_DEFAULT_INITIAL_CAPACITY) psh_no_except {
+        DynamicArray<T>*   darray,
+        Arena*             arena,
+        usize              capacity = DYNARRAY_DEFAULT_INITIAL_CAPACITY,
+        DynamicArrayGrowth growth   = DynamicArrayGrowth::ZEROED) psh_no_except {
         psh_paranoid_validate_usage({
             psh_assert_not_null(darray);
             psh_assert_msg(darray->count == 0, "DynamicArray already initialised.");
         });
 
-        T* buf  = memory_alloc<T>(arena, capacity);
+        T* buf  = (growth == DynamicArrayGrowth::ZEROED) ? memory_alloc<T>(arena, capacity) : memory_alloc_uninit<T>(arena, capacity);
         *darray = {
             .buf      = buf,
             .arena    = arena,
             .capacity = (buf != nullptr) ? capacity : 0,
             .count    = 0,
+            .growth   = growth,
         };
     }
 
-    /// Grow the capacity of the dynamic array underlying buffer.
+    namespace impl {
+        /// Allocate or resize the buffer of the dynamic array according to its growth policy.
+        template <typename T>
+        psh_proc psh_inline T* dynamic_array_resize_buffer(DynamicArray<T>* darray, usize new_capacity) psh_no_except {
+            Arena* arena            = darray->arena;
+            usize  current_capacity = darray->capacity;
+            bool   zeroed           = (darray->growth == DynamicArrayGrowth::ZEROED);
+
+            if (current_capacity == 0) {
+                return zeroed ? memory_alloc<T>(arena, new_capacity) : memory_alloc_uninit<T>(arena, new_capacity);
+            }
+            return zeroed ? memory_realloc<T>(arena, darray->buf, current_capacity, new_capacity)
+                          : memory_realloc_uninit<T>(arena, darray->buf, current_capacity, new_capacity);
+        }
+    }  // namespace impl
+
+    namespace impl {
+        /// Check whether the buffer of the dynamic array is the last block allocated by its arena,
+        /// in which case it can be resized without moving.
+        template <typename T>
+        psh_proc psh_inline bool dynamic_array_is_arena_top(DynamicArray<T> const* darray) psh_no_except {
+            Arena const* arena = darray->arena;
+            return (darray->capacity != 0)
+                   && (reinterpret_cast<u8 const*>(darray->buf + darray->capacity) == arena->buf + arena->offset);
+        }
+    }  // namespace impl
+
+    /// Grow the capacity of the dynamic array underlying buffer according to its resize policy.
+    ///
+    /// If the buffer is the last block of the arena, the array grows in place. In that case, when
+    /// the arena can't be extended to the capacity given by the policy, the array takes all of the
+    /// remaining memory of the arena instead of moving, as long as it suffices for the required
+    /// capacity.
+    ///
+    /// Parameters:
+    ///     * required_capacity: Minimum capacity of the array after growing.
     template <typename T>
-    psh_proc Status dynamic_array_grow(
-        DynamicArray<T>* darray,
-        u32              growth_factor = DYNARRAY_RESIZE_CAPACITY_GROWTH_FACTOR) psh_no_except {
+    psh_proc Status dynamic_array_grow(DynamicArray<T>* darray, usize required_capacity = 0) psh_no_except {
         psh_paranoid_validate_usage(psh_assert_not_null(darray));
 
-        usize  new_capacity      = 0;
-        T*     new_buf           = nullptr;
-        Arena* arena             = darray->arena;
-        usize  previous_capacity = darray->capacity;
+        usize previous_capacity = darray->capacity;
+        usize new_capacity      = dynamic_array_next_capacity(darray->resize, psh_usize_of(T), previous_capacity, required_capacity);
 
-        if (psh_likely(previous_capacity != 0)) {
-            new_capacity = previous_capacity * growth_factor;
-            new_buf      = memory_realloc<T>(arena, darray->buf, previous_capacity, new_capacity);
-        } else {
-            new_capacity = DYNARRAY_DEFAULT_INITIAL_CAPACITY;
-            new_buf      = memory_alloc<T>(arena, new_capacity);
+        Arena const* arena = darray->arena;
+        if (impl::dynamic_array_is_arena_top(darray) && (arena->reserved == 0)) {
+            usize available_count = previous_capacity + (arena->capacity - arena->offset) / psh_usize_of(T);
+            if ((new_capacity > available_count) && (psh_max_value(required_capacity, previous_capacity + 1) <= available_count)) {
+                new_capacity = available_count;
+            }
         }
 
+        T* new_buf = impl::dynamic_array_resize_buffer(darray, new_capacity);
+
         Status status = (new_buf != nullptr);
         if (psh_likely(status)) {
             darray->buf      = new_buf;
@@ -926,14 +2232,7 @@ namespace psh {
         psh_paranoid_validate_usage(psh_assert_not_null(darray));
         psh_validate_usage(psh_assert_msg(darray->capacity < new_capacity, "DynamicArray doesn't shrink."));
 
-        T*     new_buf          = nullptr;
-        Arena* arena            = darray->arena;
-        usize  current_capacity = darray->capacity;
-        if (current_capacity == 0) {
-            new_buf = memory_alloc<T>(arena, new_capacity);
-        } else {
-            new_buf = memory_realloc<T>(arena, darray->buf, current_capacity, new_capacity);
-        }
+        T* new_buf = impl::dynamic_array_resize_buffer(darray, new_capacity);
 
         Status status = (new_buf != nullptr);
         if (psh_likely(status)) {
@@ -973,7 +2272,7 @@ namespace psh {
 
         Status status = STATUS_OK;
         if (darray->capacity < new_elements.count + previous_count) {
-            status = dynamic_array_reserve(darray, previous_count + new_elements.count);
+            status = dynamic_array_grow(darray, previous_count + new_elements.count);
         }
 
         if (psh_likely(status)) {
@@ -1009,7 +2308,442 @@ namespace psh {
         darray->count = 0;
     }
 
-    // -------------------------------------------------------------------------------------------------
+    /// Give the unused capacity of the dynamic array back to its arena.
+    ///
+    /// Arenas can only reclaim their last block, so the capacity is kept as is if the buffer isn't
+    /// the last allocation of the arena.
+    ///
+    /// Return: Whether the capacity now matches the element count.
+    template <typename T>
+    psh_proc Status dynamic_array_shrink_to_fit(DynamicArray<T>* darray) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(darray));
+
+        usize count    = darray->count;
+        usize capacity = darray->capacity;
+        if (count == capacity) {
+            return STATUS_OK;
+        }
+        if (!impl::dynamic_array_is_arena_top(darray)) {
+            return STATUS_FAILED;
+        }
+
+        // Reallocations can't free blocks, so an empty array rolls the arena back to the start of
+        // its buffer, which lies in the current block of the arena.
+        if (count == 0) {
+            Arena* arena = darray->arena;
+            arena_checkpoint_restore(ArenaCheckpoint{
+                .arena        = arena,
+                .saved_offset = static_cast<usize>(reinterpret_cast<u8*>(darray->buf) - arena->buf),
+                .saved_buf    = arena->buf,
+            });
+            darray->capacity = 0;
+            return STATUS_OK;
+        }
+
+        T* new_buf = memory_realloc<T>(darray->arena, darray->buf, capacity, count);
+        psh_assert(new_buf == darray->buf);
+
+        darray->capacity = count;
+        return STATUS_OK;
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Dynamically sized array with stable element addresses.
+    // -------------------------------------------------------------------------------------------------
+
+    /// Segment of contiguous elements of a stable array.
+    template <typename T>
+    struct StableArraySegment {
+        StableArraySegment* previous;
+        StableArraySegment* next;
+        T*                  buf;
+        usize               count    = 0;
+        usize               capacity = 0;
+
+        psh_impl_generate_container_boilerplate(T, this->buf, this->count)
+    };
+
+    /// Run-time variable length array whose elements are never moved.
+    ///
+    /// The elements are stored in a linked list of segments allocated from the arena, so growing the
+    /// array never copies the existing elements nor invalidates pointers to them. Each new segment
+    /// doubles the capacity of the array, keeping the number of segments logarithmic in the number
+    /// of elements. Segments are kept when the array is cleared, and are reused by later pushes.
+    ///
+    /// The elements can be iterated per segment:
+    ///
+    ///     for (StableArraySegment<T>* segment = sarray.first; segment != nullptr; segment = segment->next) {
+    ///         for (T& element : *segment) { ... }
+    ///     }
+    template <typename T>
+    struct StableArray {
+        StableArraySegment<T>* first = nullptr;
+        StableArraySegment<T>* last  = nullptr;  // Segment holding the last element.
+        Arena*                 arena;
+        usize                  count                  = 0;
+        usize                  capacity               = 0;
+        usize                  first_segment_capacity = DYNARRAY_DEFAULT_INITIAL_CAPACITY;
+
+        psh_inline T& operator[](usize idx) psh_no_except;
+        psh_inline T const& operator[](usize idx) const psh_no_except;
+    };
+
+    /// Create a stable array, its first segment is only allocated by the first push.
+    template <typename T>
+    psh_proc psh_inline StableArray<T> make_stable_array(
+        Arena* arena,
+        usize  first_segment_capacity = DYNARRAY_DEFAULT_INITIAL_CAPACITY) psh_no_except {
+        psh_validate_usage(psh_assert_msg(first_segment_capacity != 0, "Stable array segments should hold at least one element."));
+        return StableArray<T>{
+            .first                  = nullptr,
+            .last                   = nullptr,
+            .arena                  = arena,
+            .count                  = 0,
+            .capacity               = 0,
+            .first_segment_capacity = first_segment_capacity,
+        };
+    }
+
+    /// Get a pointer to the element at a given index.
+    template <typename T>
+    psh_proc T* stable_array_at(StableArray<T> const* sarray, usize idx) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(sarray));
+        psh_validate_usage(psh_assert_bounds_check(idx, sarray->count));
+
+        // Every segment preceding the last one is full.
+        StableArraySegment<T>* segment = sarray->first;
+        while (idx >= segment->capacity) {
+            idx     -= segment->capacity;
+            segment  = segment->next;
+        }
+        return segment->buf + idx;
+    }
+
+    template <typename T>
+    psh_inline T& StableArray<T>::operator[](usize idx) psh_no_except {
+        return *stable_array_at(this, idx);
+    }
+    template <typename T>
+    psh_inline T const& StableArray<T>::operator[](usize idx) const psh_no_except {
+        return *stable_array_at(this, idx);
+    }
+
+    /// Insert a new element to the end of the stable array.
+    ///
+    /// Return: A pointer to the inserted element, which stays valid for the lifetime of the array,
+    ///         or null if a new segment couldn't be allocated.
+    template <typename T>
+    psh_proc T* stable_array_push(StableArray<T>* sarray, T new_element) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(sarray));
+
+        StableArraySegment<T>* segment = sarray->last;
+        if ((segment == nullptr) || (segment->count == segment->capacity)) {
+            StableArraySegment<T>* next = (segment != nullptr) ? segment->next : sarray->first;
+
+            // Allocate a new segment if there are no segments left from a previous clear.
+            if (next == nullptr) {
+                usize segment_capacity = (sarray->capacity != 0) ? sarray->capacity : sarray->first_segment_capacity;
+
+                ArenaCheckpoint checkpoint = make_arena_checkpoint(sarray->arena);
+
+                next = memory_alloc<StableArraySegment<T>>(sarray->arena, 1);
+                T* buf = (next != nullptr) ? memory_alloc_uninit<T>(sarray->arena, segment_capacity) : nullptr;
+                if (psh_unlikely(buf == nullptr)) {
+                    arena_checkpoint_restore(checkpoint);
+                    return nullptr;
+                }
+
+                *next = {
+                    .previous = segment,
+                    .next     = nullptr,
+                    .buf      = buf,
+                    .count    = 0,
+                    .capacity = segment_capacity,
+                };
+                if (segment != nullptr) {
+                    segment->next = next;
+                } else {
+                    sarray->first = next;
+                }
+                sarray->capacity += segment_capacity;
+            }
+
+            segment      = next;
+            sarray->last = segment;
+        }
+
+        T* element = segment->buf + segment->count;
+        *element   = new_element;
+        ++segment->count;
+        ++sarray->count;
+        return element;
+    }
+
+    /// Try to pop the last element of the stable array.
+    template <typename T>
+    psh_proc Status stable_array_pop(StableArray<T>* sarray) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(sarray));
+
+        if (psh_unlikely(sarray->count == 0)) {
+            return STATUS_FAILED;
+        }
+
+        StableArraySegment<T>* segment = sarray->last;
+        --segment->count;
+        --sarray->count;
+
+        if ((segment->count == 0) && (segment->previous != nullptr)) {
+            sarray->last = segment->previous;
+        }
+        return STATUS_OK;
+    }
+
+    /// Clear the stable array, keeping its segments for future pushes.
+    template <typename T>
+    psh_proc void stable_array_clear(StableArray<T>* sarray) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(sarray));
+
+        for (StableArraySegment<T>* segment = sarray->first; segment != nullptr; segment = segment->next) {
+            segment->count = 0;
+        }
+        sarray->last  = sarray->first;
+        sarray->count = 0;
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Slot map.
+    //
+    // Densely packed elements referred to by generational handles. A handle names a slot, which
+    // holds the position of its element in the dense array and a generation that is bumped whenever
+    // the element is removed. A handle whose generation doesn't match the slot is stale, so handles
+    // outlive the growth of the arrays and the reordering of the dense elements caused by removals.
+    //
+    // The elements can be iterated contiguously, in no particular order:
+    //
+    //     for (T& element : map.values) { ... }
+    // -------------------------------------------------------------------------------------------------
+
+    psh_global constexpr u32 SLOT_HANDLE_INDEX_BIT_COUNT      = 20;
+    psh_global constexpr u32 SLOT_HANDLE_GENERATION_BIT_COUNT = 32 - SLOT_HANDLE_INDEX_BIT_COUNT;
+    psh_global constexpr u32 SLOT_HANDLE_MAX_INDEX            = (1u << SLOT_HANDLE_INDEX_BIT_COUNT) - 1u;
+    psh_global constexpr u32 SLOT_HANDLE_MAX_GENERATION       = (1u << SLOT_HANDLE_GENERATION_BIT_COUNT) - 1u;
+    psh_global constexpr u32 SLOT_MAP_NO_FREE_SLOT            = ~u32{0};
+
+    /// Reference to an element of a slot map, packing the slot index in the lower bits and its
+    /// generation in the upper bits. Generations start at one, so the zero handle is never valid.
+    struct SlotHandle {
+        u32 value = 0;
+    };
+
+    psh_proc psh_inline u32 slot_handle_index(SlotHandle handle) psh_no_except {
+        return handle.value & SLOT_HANDLE_MAX_INDEX;
+    }
+
+    psh_proc psh_inline u32 slot_handle_generation(SlotHandle handle) psh_no_except {
+        return handle.value >> SLOT_HANDLE_INDEX_BIT_COUNT;
+    }
+
+    psh_proc psh_inline bool slot_handle_is_null(SlotHandle handle) psh_no_except {
+        return handle.value == 0;
+    }
+
+    psh_proc psh_inline bool operator==(SlotHandle lhs, SlotHandle rhs) psh_no_except {
+        return lhs.value == rhs.value;
+    }
+
+    struct SlotMapSlot {
+        u32 generation;
+        u32 dense_idx;  // Index of the element, or of the next free slot if the slot is unused.
+    };
+
+    template <typename T>
+    struct SlotMap {
+        DynamicArray<T>           values;
+        DynamicArray<u32>         dense_slots;  // Slot index of each of the values.
+        DynamicArray<SlotMapSlot> slots;
+        u32                       free_head = SLOT_MAP_NO_FREE_SLOT;
+        usize                     count     = 0;
+    };
+
+    template <typename T>
+    psh_proc psh_inline SlotMap<T> make_slot_map(Arena* arena, usize capacity = DYNARRAY_DEFAULT_INITIAL_CAPACITY) psh_no_except {
+        return SlotMap<T>{
+            .values      = make_dynamic_array<T>(arena, capacity, DynamicArrayGrowth::UNINITIALISED),
+            .dense_slots = make_dynamic_array<u32>(arena, capacity, DynamicArrayGrowth::UNINITIALISED),
+            .slots       = make_dynamic_array<SlotMapSlot>(arena, capacity, DynamicArrayGrowth::UNINITIALISED),
+            .free_head   = SLOT_MAP_NO_FREE_SLOT,
+            .count       = 0,
+        };
+    }
+
+    namespace impl {
+        psh_proc psh_inline SlotHandle make_slot_handle(u32 slot_idx, u32 generation) psh_no_except {
+            return SlotHandle{.value = (generation << SLOT_HANDLE_INDEX_BIT_COUNT) | slot_idx};
+        }
+
+        /// Bump the generation of a slot, skipping zero when it wraps around.
+        psh_proc psh_inline u32 slot_map_next_generation(u32 generation) psh_no_except {
+            return (generation == SLOT_HANDLE_MAX_GENERATION) ? 1u : (generation + 1u);
+        }
+
+        template <typename T>
+        psh_proc psh_inline SlotMapSlot* slot_map_live_slot(SlotMap<T> const* map, SlotHandle handle) psh_no_except {
+            u32 slot_idx = slot_handle_index(handle);
+            if (slot_idx >= map->slots.count) {
+                return nullptr;
+            }
+
+            // The generation of a free slot may wrap around back to the one of a stale handle, so the
+            // slot is only trusted if its element points back to it.
+            SlotMapSlot* slot = map->slots.buf + slot_idx;
+            if (slot->generation != slot_handle_generation(handle)) {
+                return nullptr;
+            }
+            u32 dense_idx = slot->dense_idx;
+            bool occupied = (dense_idx < map->count) && (map->dense_slots.buf[dense_idx] == slot_idx);
+            return occupied ? slot : nullptr;
+        }
+    }  // namespace impl
+
+    /// Insert a new element into the slot map.
+    ///
+    /// Return: The handle to the new element, or a null handle if either the memory couldn't be
+    ///         acquired or all of the SLOT_HANDLE_MAX_INDEX + 1 slots are in use.
+    template <typename T>
+    psh_proc SlotHandle slot_map_insert(SlotMap<T>* map, T value) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        u32 dense_idx = static_cast<u32>(map->values.count);
+
+        // Acquire the memory for the dense element before touching the slots.
+        Status status = dynamic_array_push(&map->values, value);
+        if (psh_likely(status)) {
+            status = dynamic_array_push(&map->dense_slots, 0u);
+            if (psh_unlikely(!status)) {
+                psh_discard_value(dynamic_array_pop(&map->values));
+            }
+        }
+        if (psh_unlikely(!status)) {
+            return SlotHandle{};
+        }
+
+        u32 slot_idx = map->free_head;
+        if (slot_idx != SLOT_MAP_NO_FREE_SLOT) {
+            map->free_head = map->slots.buf[slot_idx].dense_idx;
+        } else {
+            usize slot_count = map->slots.count;
+            if (psh_likely(slot_count <= SLOT_HANDLE_MAX_INDEX)) {
+                status = dynamic_array_push(&map->slots, SlotMapSlot{.generation = 1, .dense_idx = 0});
+            } else {
+                psh_log_error_fmt("Slot map ran out of slots: the handles can't address more than %u slots.", SLOT_HANDLE_MAX_INDEX + 1u);
+                status = STATUS_FAILED;
+            }
+
+            if (psh_unlikely(!status)) {
+                psh_discard_value(dynamic_array_pop(&map->values));
+                psh_discard_value(dynamic_array_pop(&map->dense_slots));
+                return SlotHandle{};
+            }
+            slot_idx = static_cast<u32>(slot_count);
+        }
+
+        SlotMapSlot* slot               = map->slots.buf + slot_idx;
+        slot->dense_idx                 = dense_idx;
+        map->dense_slots.buf[dense_idx] = slot_idx;
+        ++map->count;
+
+        return impl::make_slot_handle(slot_idx, slot->generation);
+    }
+
+    /// Get a pointer to the element referred to by a handle.
+    ///
+    /// Note: The pointer is only valid until the next insertion or removal, the handle should be
+    ///       kept instead.
+    ///
+    /// Return: The element, or null if the handle is stale.
+    template <typename T>
+    psh_proc psh_inline T* slot_map_find(SlotMap<T>* map, SlotHandle handle) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        SlotMapSlot* slot = impl::slot_map_live_slot(map, handle);
+        return (slot != nullptr) ? (map->values.buf + slot->dense_idx) : nullptr;
+    }
+    template <typename T>
+    psh_proc psh_inline T const* slot_map_find(SlotMap<T> const* map, SlotHandle handle) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        SlotMapSlot* slot = impl::slot_map_live_slot(map, handle);
+        return (slot != nullptr) ? (map->values.buf + slot->dense_idx) : nullptr;
+    }
+
+    template <typename T>
+    psh_proc psh_inline bool slot_map_contains(SlotMap<T> const* map, SlotHandle handle) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+        return impl::slot_map_live_slot(map, handle) != nullptr;
+    }
+
+    /// Get the handle of the element at a given index of the dense array of values.
+    template <typename T>
+    psh_proc psh_inline SlotHandle slot_map_handle_at(SlotMap<T> const* map, usize dense_idx) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+        psh_validate_usage(psh_assert_bounds_check(dense_idx, map->count));
+
+        u32 slot_idx = map->dense_slots.buf[dense_idx];
+        return impl::make_slot_handle(slot_idx, map->slots.buf[slot_idx].generation);
+    }
+
+    /// Remove the element referred to by a handle, invalidating the handle.
+    ///
+    /// The last element of the dense array takes the place of the removed one.
+    ///
+    /// Return: Whether the handle referred to an element of the map.
+    template <typename T>
+    psh_proc bool slot_map_remove(SlotMap<T>* map, SlotHandle handle) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        SlotMapSlot* slot = impl::slot_map_live_slot(map, handle);
+        if (slot == nullptr) {
+            return false;
+        }
+
+        u32 dense_idx = slot->dense_idx;
+        u32 last_idx  = static_cast<u32>(map->count - 1u);
+        if (dense_idx != last_idx) {
+            u32 moved_slot_idx                       = map->dense_slots.buf[last_idx];
+            map->values.buf[dense_idx]               = map->values.buf[last_idx];
+            map->dense_slots.buf[dense_idx]          = moved_slot_idx;
+            map->slots.buf[moved_slot_idx].dense_idx = dense_idx;
+        }
+        map->values.count      = last_idx;
+        map->dense_slots.count = last_idx;
+        --map->count;
+
+        slot->generation = impl::slot_map_next_generation(slot->generation);
+        slot->dense_idx  = map->free_head;
+        map->free_head   = slot_handle_index(handle);
+
+        return true;
+    }
+
+    /// Remove all elements of the slot map, invalidating all of the handles.
+    template <typename T>
+    psh_proc void slot_map_clear(SlotMap<T>* map) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        for (usize idx = 0; idx < map->count; ++idx) {
+            u32          slot_idx = map->dense_slots.buf[idx];
+            SlotMapSlot* slot     = map->slots.buf + slot_idx;
+            slot->generation      = impl::slot_map_next_generation(slot->generation);
+            slot->dense_idx       = map->free_head;
+            map->free_head        = slot_idx;
+        }
+
+        map->values.count      = 0;
+        map->dense_slots.count = 0;
+        map->count             = 0;
+    }
+
+    // -------------------------------------------------------------------------------------------------
     // Memory manipulation procedures common to all containers.
     // -------------------------------------------------------------------------------------------------
 
@@ -1087,4 +2821,642 @@ namespace psh {
             reinterpret_cast<u8*>(buf + idx),
             psh_usize_of(T));
     }
+
+    // -------------------------------------------------------------------------------------------------
+    // Bit sets.
+    //
+    // Bits are packed into 64-bit words, the bit of index idx being the bit (idx % 64) of the word
+    // (idx / 64). The bits of the last word past the bit count are always kept at zero, so that
+    // counts and searches can operate on whole words. Bulk operations between sets process multiple
+    // words at once when SIMD instructions are available.
+    //
+    // Iteration over the set bits:
+    //
+    //     for (isize idx = bit_array_find_next(&bits, 0); idx != -1; idx = bit_array_find_next(&bits, idx + 1)) {
+    //         ... use idx ...
+    //     }
+    // -------------------------------------------------------------------------------------------------
+
+    psh_global constexpr usize BIT_WORD_SIZE = psh_type_bit_count(u64);
+
+    namespace impl {
+        psh_proc psh_inline usize bit_word_count_for(usize bit_count) psh_no_except {
+            return (bit_count + BIT_WORD_SIZE - 1u) / BIT_WORD_SIZE;
+        }
+
+        /// Mask of the bits of the last word that are part of the set.
+        psh_proc psh_inline u64 bit_last_word_mask(usize bit_count) psh_no_except {
+            usize tail = bit_count % BIT_WORD_SIZE;
+            return (tail == 0) ? ~u64{0} : ((u64{1} << tail) - 1u);
+        }
+
+        psh_proc void bit_words_and(u64* dst, u64 const* src, usize word_count) psh_no_except;
+        psh_proc void bit_words_or(u64* dst, u64 const* src, usize word_count) psh_no_except;
+        psh_proc void bit_words_xor(u64* dst, u64 const* src, usize word_count) psh_no_except;
+        psh_proc void bit_words_andnot(u64* dst, u64 const* src, usize word_count) psh_no_except;
+        psh_proc usize bit_words_count_ones(u64 const* words, usize word_count) psh_no_except;
+        psh_proc isize bit_words_find_next(u64 const* words, usize bit_count, usize start) psh_no_except;
+        psh_proc usize bit_words_rank(u64 const* words, usize idx) psh_no_except;
+        psh_proc isize bit_words_select(u64 const* words, usize word_count, usize n) psh_no_except;
+
+        psh_proc psh_inline void bit_words_fill(u64* words, usize bit_count, bool value) psh_no_except {
+            usize word_count = bit_word_count_for(bit_count);
+            memory_set(reinterpret_cast<u8*>(words), word_count * psh_usize_of(u64), value ? 0xFF : 0);
+            if (value && (word_count != 0)) {
+                words[word_count - 1u] &= bit_last_word_mask(bit_count);
+            }
+        }
+    }  // namespace impl
+
+    /// Set of bits with a compile-time known size.
+    template <usize bit_count_>
+    struct BitSet {
+        static constexpr usize bit_count  = bit_count_;
+        static constexpr usize word_count = (bit_count_ + BIT_WORD_SIZE - 1u) / BIT_WORD_SIZE;
+
+        Buffer<u64, word_count> words = {};
+    };
+
+    /// Set of bits with a run-time known size, whose lifetime is bound to the lifetime of the arena
+    /// that allocated it.
+    struct BitArray {
+        u64*  words;
+        usize bit_count  = 0;
+        usize word_count = 0;
+    };
+
+    /// Create a bit array with all of its bits cleared.
+    psh_proc psh_inline BitArray make_bit_array(Arena* arena, usize bit_count) psh_no_except {
+        usize word_count = impl::bit_word_count_for(bit_count);
+        u64*  words      = memory_alloc<u64>(arena, word_count);
+        return BitArray{
+            .words      = words,
+            .bit_count  = (words != nullptr) ? bit_count : 0,
+            .word_count = (words != nullptr) ? word_count : 0,
+        };
+    }
+
+    psh_proc psh_inline bool bit_array_test(BitArray const* bits, usize idx) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        psh_assert_bounds_check(idx, bits->bit_count);
+        return static_cast<bool>((bits->words[idx / BIT_WORD_SIZE] >> (idx % BIT_WORD_SIZE)) & 1u);
+    }
+
+    psh_proc psh_inline void bit_array_set(BitArray* bits, usize idx) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        psh_assert_bounds_check(idx, bits->bit_count);
+        bits->words[idx / BIT_WORD_SIZE] |= u64{1} << (idx % BIT_WORD_SIZE);
+    }
+
+    psh_proc psh_inline void bit_array_clear(BitArray* bits, usize idx) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        psh_assert_bounds_check(idx, bits->bit_count);
+        bits->words[idx / BIT_WORD_SIZE] &= ~(u64{1} << (idx % BIT_WORD_SIZE));
+    }
+
+    psh_proc psh_inline void bit_array_toggle(BitArray* bits, usize idx) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        psh_assert_bounds_check(idx, bits->bit_count);
+        bits->words[idx / BIT_WORD_SIZE] ^= u64{1} << (idx % BIT_WORD_SIZE);
+    }
+
+    /// Set all bits to a given value.
+    psh_proc psh_inline void bit_array_fill(BitArray* bits, bool value) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        impl::bit_words_fill(bits->words, bits->bit_count, value);
+    }
+
+    /// Number of bits set to 1.
+    psh_proc psh_inline usize bit_array_count_ones(BitArray const* bits) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        return impl::bit_words_count_ones(bits->words, bits->word_count);
+    }
+
+    /// Index of the first set bit at or after the start index, or -1 if there is none.
+    psh_proc psh_inline isize bit_array_find_next(BitArray const* bits, usize start) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        return impl::bit_words_find_next(bits->words, bits->bit_count, start);
+    }
+
+    /// Number of set bits whose index is less than the given one.
+    psh_proc psh_inline usize bit_array_rank(BitArray const* bits, usize idx) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        psh_validate_usage(psh_assert_fmt(idx <= bits->bit_count, "Rank index (%zu) past the bit count (%zu).", idx, bits->bit_count));
+        return impl::bit_words_rank(bits->words, idx);
+    }
+
+    /// Index of the n-th set bit, counting from zero, or -1 if there are no more than n set bits.
+    psh_proc psh_inline isize bit_array_select(BitArray const* bits, usize n) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        return impl::bit_words_select(bits->words, bits->word_count, n);
+    }
+
+    /// Bulk operations, storing the result in the destination set. Both sets should have the same
+    /// bit count, and may be the same set.
+    psh_proc psh_inline void bit_array_and(BitArray* dst, BitArray const* src) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(dst);
+            psh_assert_not_null(src);
+        });
+        psh_validate_usage(psh_assert_msg(dst->bit_count == src->bit_count, "Bit arrays should have the same bit count."));
+        impl::bit_words_and(dst->words, src->words, dst->word_count);
+    }
+    psh_proc psh_inline void bit_array_or(BitArray* dst, BitArray const* src) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(dst);
+            psh_assert_not_null(src);
+        });
+        psh_validate_usage(psh_assert_msg(dst->bit_count == src->bit_count, "Bit arrays should have the same bit count."));
+        impl::bit_words_or(dst->words, src->words, dst->word_count);
+    }
+    psh_proc psh_inline void bit_array_xor(BitArray* dst, BitArray const* src) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(dst);
+            psh_assert_not_null(src);
+        });
+        psh_validate_usage(psh_assert_msg(dst->bit_count == src->bit_count, "Bit arrays should have the same bit count."));
+        impl::bit_words_xor(dst->words, src->words, dst->word_count);
+    }
+
+    /// Clear the bits of the destination that are set in the source.
+    psh_proc psh_inline void bit_array_andnot(BitArray* dst, BitArray const* src) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(dst);
+            psh_assert_not_null(src);
+        });
+        psh_validate_usage(psh_assert_msg(dst->bit_count == src->bit_count, "Bit arrays should have the same bit count."));
+        impl::bit_words_andnot(dst->words, src->words, dst->word_count);
+    }
+
+    // The fixed size bit set has the same set of operations, where the bit counts of the operands
+    // of the bulk operations are checked by their types.
+
+    template <usize bit_count>
+    psh_proc psh_inline bool bit_set_test(BitSet<bit_count> const* bits, usize idx) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        psh_assert_bounds_check(idx, bit_count);
+        return static_cast<bool>((bits->words.buf[idx / BIT_WORD_SIZE] >> (idx % BIT_WORD_SIZE)) & 1u);
+    }
+
+    template <usize bit_count>
+    psh_proc psh_inline void bit_set_set(BitSet<bit_count>* bits, usize idx) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        psh_assert_bounds_check(idx, bit_count);
+        bits->words.buf[idx / BIT_WORD_SIZE] |= u64{1} << (idx % BIT_WORD_SIZE);
+    }
+
+    template <usize bit_count>
+    psh_proc psh_inline void bit_set_clear(BitSet<bit_count>* bits, usize idx) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        psh_assert_bounds_check(idx, bit_count);
+        bits->words.buf[idx / BIT_WORD_SIZE] &= ~(u64{1} << (idx % BIT_WORD_SIZE));
+    }
+
+    template <usize bit_count>
+    psh_proc psh_inline void bit_set_toggle(BitSet<bit_count>* bits, usize idx) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        psh_assert_bounds_check(idx, bit_count);
+        bits->words.buf[idx / BIT_WORD_SIZE] ^= u64{1} << (idx % BIT_WORD_SIZE);
+    }
+
+    template <usize bit_count>
+    psh_proc psh_inline void bit_set_fill(BitSet<bit_count>* bits, bool value) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        impl::bit_words_fill(bits->words.buf, bit_count, value);
+    }
+
+    template <usize bit_count>
+    psh_proc psh_inline usize bit_set_count_ones(BitSet<bit_count> const* bits) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        return impl::bit_words_count_ones(bits->words.buf, BitSet<bit_count>::word_count);
+    }
+
+    template <usize bit_count>
+    psh_proc psh_inline isize bit_set_find_next(BitSet<bit_count> const* bits, usize start) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        return impl::bit_words_find_next(bits->words.buf, bit_count, start);
+    }
+
+    template <usize bit_count>
+    psh_proc psh_inline usize bit_set_rank(BitSet<bit_count> const* bits, usize idx) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        psh_validate_usage(psh_assert_fmt(idx <= bit_count, "Rank index (%zu) past the bit count (%zu).", idx, bit_count));
+        return impl::bit_words_rank(bits->words.buf, idx);
+    }
+
+    template <usize bit_count>
+    psh_proc psh_inline isize bit_set_select(BitSet<bit_count> const* bits, usize n) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(bits));
+        return impl::bit_words_select(bits->words.buf, BitSet<bit_count>::word_count, n);
+    }
+
+    template <usize bit_count>
+    psh_proc psh_inline void bit_set_and(BitSet<bit_count>* dst, BitSet<bit_count> const* src) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(dst);
+            psh_assert_not_null(src);
+        });
+        impl::bit_words_and(dst->words.buf, src->words.buf, BitSet<bit_count>::word_count);
+    }
+    template <usize bit_count>
+    psh_proc psh_inline void bit_set_or(BitSet<bit_count>* dst, BitSet<bit_count> const* src) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(dst);
+            psh_assert_not_null(src);
+        });
+        impl::bit_words_or(dst->words.buf, src->words.buf, BitSet<bit_count>::word_count);
+    }
+    template <usize bit_count>
+    psh_proc psh_inline void bit_set_xor(BitSet<bit_count>* dst, BitSet<bit_count> const* src) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(dst);
+            psh_assert_not_null(src);
+        });
+        impl::bit_words_xor(dst->words.buf, src->words.buf, BitSet<bit_count>::word_count);
+    }
+    template <usize bit_count>
+    psh_proc psh_inline void bit_set_andnot(BitSet<bit_count>* dst, BitSet<bit_count> const* src) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(dst);
+            psh_assert_not_null(src);
+        });
+        impl::bit_words_andnot(dst->words.buf, src->words.buf, BitSet<bit_count>::word_count);
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Hashing.
+    //
+    // The hash map is able to work with any key type K for which there exists a procedure
+    // hash_value(K) returning a u64 and, in case K has no adequate operator==, a procedure
+    // hash_key_equal(K, K). These can be declared in the namespace of K and will be found at the
+    // point of instantiation of the hash map procedures.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_global constexpr u64 HASH_DEFAULT_SEED = 0x9E3779B97F4A7C15ull;
+
+    /// Scramble the bits of a 64-bit value, making each input bit affect every output bit.
+    ///
+    /// This is the finalisation step of MurmurHash3.
+    psh_proc psh_inline constexpr u64 hash_mix(u64 value) psh_no_except {
+        value ^= value >> 33u;
+        value *= 0xFF51AFD7ED558CCDull;
+        value ^= value >> 33u;
+        value *= 0xC4CEB9FE1A85EC53ull;
+        value ^= value >> 33u;
+        return value;
+    }
+
+    /// Hash an arbitrary sequence of bytes.
+    psh_proc u64 hash_bytes(u8 const* bytes, usize size_bytes, u64 seed = HASH_DEFAULT_SEED) psh_no_except;
+
+    psh_proc psh_inline u64 hash_value(u8 value) psh_no_except { return hash_mix(static_cast<u64>(value)); }
+    psh_proc psh_inline u64 hash_value(u16 value) psh_no_except { return hash_mix(static_cast<u64>(value)); }
+    psh_proc psh_inline u64 hash_value(u32 value) psh_no_except { return hash_mix(static_cast<u64>(value)); }
+    psh_proc psh_inline u64 hash_value(u64 value) psh_no_except { return hash_mix(value); }
+    psh_proc psh_inline u64 hash_value(i8 value) psh_no_except { return hash_mix(static_cast<u64>(value)); }
+    psh_proc psh_inline u64 hash_value(i16 value) psh_no_except { return hash_mix(static_cast<u64>(value)); }
+    psh_proc psh_inline u64 hash_value(i32 value) psh_no_except { return hash_mix(static_cast<u64>(value)); }
+    psh_proc psh_inline u64 hash_value(i64 value) psh_no_except { return hash_mix(static_cast<u64>(value)); }
+    template <typename T>
+    psh_proc psh_inline u64 hash_value(T const* ptr) psh_no_except {
+        return hash_mix(static_cast<u64>(reinterpret_cast<uptr>(ptr)));
+    }
+
+    template <typename T>
+    psh_proc psh_inline bool hash_key_equal(T lhs, T rhs) psh_no_except {
+        return (lhs == rhs);
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Hash map.
+    // -------------------------------------------------------------------------------------------------
+
+    /// Number of control bytes probed at once when searching the hash map.
+    psh_global constexpr usize HASH_MAP_GROUP_WIDTH             = 16;
+    psh_global constexpr usize HASH_MAP_DEFAULT_INITIAL_CAPACITY = 16;
+
+    /// Control byte values.
+    ///
+    /// A slot in use has a control byte with the high bit cleared, holding the lower 7 bits of the
+    /// hash of its key. Free slots are always marked by a control byte with the high bit set.
+    psh_global constexpr u8 HASH_MAP_CTRL_EMPTY   = 0x80;
+    psh_global constexpr u8 HASH_MAP_CTRL_DELETED = 0xFE;
+
+    template <typename K, typename V>
+    struct HashMapSlot {
+        K key;
+        V value;
+    };
+
+    /// Hash map with open addressing.
+    ///
+    /// The control bytes and slots are flat arrays with a capacity that is always a power of two
+    /// and a multiple of HASH_MAP_GROUP_WIDTH. Each key is associated with a starting group of
+    /// control bytes and the whole group is compared against the key's hash byte in a single SIMD
+    /// comparison (when available). Only the slots whose control bytes match have their keys
+    /// compared, so a lookup will typically touch the cache line of the control group and the one
+    /// of the slot itself.
+    ///
+    /// The hash map has its lifetime bound to the lifetime of its associated arena. When growing,
+    /// the previous memory blocks are left in the arena.
+    ///
+    /// Note: Pointers to the values of the map are invalidated whenever the map grows.
+    template <typename K, typename V>
+    struct HashMap {
+        u8*                ctrl;
+        HashMapSlot<K, V>* slots;
+        Arena*             arena;
+        usize              capacity        = 0;
+        usize              count           = 0;
+        usize              tombstone_count = 0;
+    };
+
+    namespace impl {
+        /// Bit mask of the control bytes of a group that are equal to a given hash byte.
+        psh_proc psh_inline u32 hash_map_group_match(u8 const* group, u8 hash_byte) psh_no_except {
+#if PSH_ARCH_SIMD_SSE2
+            __m128i ctrl = _mm_load_si128(reinterpret_cast<__m128i const*>(group));
+            return static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(hash_byte)))));
+#elif PSH_ARCH_SIMD_NEON
+            constexpr u8 BIT_WEIGHTS[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+
+            uint8x16_t matches = vandq_u8(vceqq_u8(vld1q_u8(group), vdupq_n_u8(hash_byte)), vld1q_u8(BIT_WEIGHTS));
+            uint8x8_t  sum     = vpadd_u8(vget_low_u8(matches), vget_high_u8(matches));
+            sum                = vpadd_u8(sum, sum);
+            sum                = vpadd_u8(sum, sum);
+            return static_cast<u32>(vget_lane_u16(vreinterpret_u16_u8(sum), 0));
+#else
+            u32 mask = 0;
+            for (u32 idx = 0; idx < HASH_MAP_GROUP_WIDTH; ++idx) {
+                mask |= static_cast<u32>(group[idx] == hash_byte) << idx;
+            }
+            return mask;
+#endif
+        }
+
+        /// Bit mask of the free control bytes of a group, either empty or deleted.
+        psh_proc psh_inline u32 hash_map_group_match_free(u8 const* group) psh_no_except {
+#if PSH_ARCH_SIMD_SSE2
+            return static_cast<u32>(_mm_movemask_epi8(_mm_load_si128(reinterpret_cast<__m128i const*>(group))));
+#else
+            u32 mask = 0;
+            for (u32 idx = 0; idx < HASH_MAP_GROUP_WIDTH; ++idx) {
+                mask |= static_cast<u32>(group[idx] >> 7u) << idx;
+            }
+            return mask;
+#endif
+        }
+
+        psh_proc psh_inline u32 hash_map_group_match_empty(u8 const* group) psh_no_except {
+            return hash_map_group_match(group, HASH_MAP_CTRL_EMPTY);
+        }
+
+        /// Compute the capacity needed for the hash map to hold a given number of elements without
+        /// exceeding the maximum load factor of 7/8.
+        psh_proc psh_inline usize hash_map_capacity_for(usize element_count) psh_no_except {
+            usize capacity = HASH_MAP_GROUP_WIDTH;
+            while (capacity * 7u < element_count * 8u) {
+                capacity *= 2u;
+            }
+            return capacity;
+        }
+
+        psh_proc psh_inline u8 hash_map_hash_byte(u64 hash) psh_no_except {
+            return static_cast<u8>(hash & 0x7F);
+        }
+
+        psh_proc psh_inline usize hash_map_first_group(u64 hash, usize group_mask) psh_no_except {
+            return static_cast<usize>(hash >> 7u) & group_mask;
+        }
+
+        /// Find the first free slot in the probing sequence of a given hash.
+        template <typename K, typename V>
+        psh_proc usize hash_map_find_free_slot(HashMap<K, V> const* map, u64 hash) psh_no_except {
+            usize group_mask = (map->capacity / HASH_MAP_GROUP_WIDTH) - 1u;
+            usize group      = hash_map_first_group(hash, group_mask);
+
+            // @NOTE: The load factor is always kept below 1, so there is always a free slot.
+            for (usize probe = 1;; ++probe) {
+                u32 free_mask = hash_map_group_match_free(map->ctrl + group * HASH_MAP_GROUP_WIDTH);
+                if (free_mask != 0) {
+                    return group * HASH_MAP_GROUP_WIDTH + bit_count_trailing_zeros(free_mask);
+                }
+                group = (group + probe) & group_mask;
+            }
+        }
+
+        /// Find the slot index of a key, returning -1 if the key isn't present.
+        template <typename K, typename V>
+        psh_proc isize hash_map_find_slot(HashMap<K, V> const* map, K key, u64 hash) psh_no_except {
+            if (psh_unlikely(map->capacity == 0)) {
+                return -1;
+            }
+
+            u8    hash_byte   = hash_map_hash_byte(hash);
+            usize group_count = map->capacity / HASH_MAP_GROUP_WIDTH;
+            usize group_mask  = group_count - 1u;
+            usize group       = hash_map_first_group(hash, group_mask);
+
+            // @NOTE: Triangular probing visits every group exactly once when the group count is a
+            //        power of two.
+            for (usize probe = 1; probe <= group_count; ++probe) {
+                u8 const* group_ctrl = map->ctrl + group * HASH_MAP_GROUP_WIDTH;
+
+                for (u32 match = hash_map_group_match(group_ctrl, hash_byte); match != 0; match &= match - 1u) {
+                    usize slot_idx = group * HASH_MAP_GROUP_WIDTH + bit_count_trailing_zeros(match);
+                    if (psh_likely(hash_key_equal(map->slots[slot_idx].key, key))) {
+                        return static_cast<isize>(slot_idx);
+                    }
+                }
+
+                // A key is never placed past a group with an empty slot.
+                if (psh_likely(hash_map_group_match_empty(group_ctrl) != 0)) {
+                    break;
+                }
+
+                group = (group + probe) & group_mask;
+            }
+
+            return -1;
+        }
+    }  // namespace impl
+
+    /// Rebuild the hash map with a new capacity, discarding all tombstones.
+    template <typename K, typename V>
+    psh_proc Status hash_map_rehash(HashMap<K, V>* map, usize new_capacity) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+        psh_validate_usage({
+            psh_assert_fmt(
+                psh_is_pow_of_two(new_capacity) && (new_capacity >= HASH_MAP_GROUP_WIDTH),
+                "Hash map capacity (%zu) should be a power of two of at least %zu.",
+                new_capacity,
+                HASH_MAP_GROUP_WIDTH);
+            psh_assert_msg(map->count * 8u <= new_capacity * 7u, "Hash map capacity too small for its elements.");
+        });
+
+        // Slots are only read when their control byte is full, so neither buffer needs zeroing.
+        u8*                new_ctrl  = memory_alloc_align_uninit(map->arena, new_capacity, HASH_MAP_GROUP_WIDTH);
+        HashMapSlot<K, V>* new_slots = memory_alloc_uninit<HashMapSlot<K, V>>(map->arena, new_capacity);
+        if (psh_unlikely((new_ctrl == nullptr) || (new_slots == nullptr))) {
+            return STATUS_FAILED;
+        }
+        memory_set(new_ctrl, new_capacity, HASH_MAP_CTRL_EMPTY);
+
+        HashMap<K, V> new_map = {
+            .ctrl            = new_ctrl,
+            .slots           = new_slots,
+            .arena           = map->arena,
+            .capacity        = new_capacity,
+            .count           = map->count,
+            .tombstone_count = 0,
+        };
+
+        u8 const*                ctrl  = map->ctrl;
+        HashMapSlot<K, V> const* slots = map->slots;
+        for (usize idx = 0; idx < map->capacity; ++idx) {
+            if ((ctrl[idx] & HASH_MAP_CTRL_EMPTY) != 0) {
+                continue;
+            }
+
+            u64   hash     = hash_value(slots[idx].key);
+            usize slot_idx = impl::hash_map_find_free_slot(&new_map, hash);
+
+            new_ctrl[slot_idx]  = impl::hash_map_hash_byte(hash);
+            new_slots[slot_idx] = slots[idx];
+        }
+
+        *map = new_map;
+        return STATUS_OK;
+    }
+
+    /// Create a hash map with enough capacity to hold a given number of elements.
+    template <typename K, typename V>
+    psh_proc psh_inline HashMap<K, V> make_hash_map(
+        Arena* arena,
+        usize  capacity = HASH_MAP_DEFAULT_INITIAL_CAPACITY) psh_no_except {
+        HashMap<K, V> map = {.ctrl = nullptr, .slots = nullptr, .arena = arena};
+        psh_discard_value(hash_map_rehash(&map, impl::hash_map_capacity_for(capacity)));
+        return map;
+    }
+
+    /// Initialise the hash map with enough capacity to hold a given number of elements.
+    template <typename K, typename V>
+    psh_proc psh_inline void init_hash_map(
+        HashMap<K, V>* map,
+        Arena*         arena,
+        usize          capacity = HASH_MAP_DEFAULT_INITIAL_CAPACITY) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(map);
+            psh_assert_msg(map->capacity == 0, "HashMap already initialised.");
+        });
+
+        *map = make_hash_map<K, V>(arena, capacity);
+    }
+
+    /// Ensure that the hash map can hold a given number of elements without growing.
+    template <typename K, typename V>
+    psh_proc Status hash_map_reserve(HashMap<K, V>* map, usize element_count) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        usize new_capacity = impl::hash_map_capacity_for(element_count);
+        if (new_capacity <= map->capacity) {
+            return STATUS_OK;
+        }
+        return hash_map_rehash(map, new_capacity);
+    }
+
+    /// Find the value associated with a key.
+    ///
+    /// Return: A pointer to the value, or null if the key isn't in the map.
+    template <typename K, typename V>
+    psh_proc V* hash_map_find(HashMap<K, V>* map, K key) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        isize slot_idx = impl::hash_map_find_slot(map, key, hash_value(key));
+        return (slot_idx != -1) ? &map->slots[slot_idx].value : nullptr;
+    }
+    template <typename K, typename V>
+    psh_proc V const* hash_map_find(HashMap<K, V> const* map, K key) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        isize slot_idx = impl::hash_map_find_slot(map, key, hash_value(key));
+        return (slot_idx != -1) ? &map->slots[slot_idx].value : nullptr;
+    }
+
+    template <typename K, typename V>
+    psh_proc psh_inline bool hash_map_contains(HashMap<K, V> const* map, K key) psh_no_except {
+        return (hash_map_find(map, key) != nullptr);
+    }
+
+    /// Insert a key-value pair into the hash map. If the key is already present, its value is
+    /// overwritten.
+    template <typename K, typename V>
+    psh_proc Status hash_map_insert(HashMap<K, V>* map, K key, V value) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        u64   hash     = hash_value(key);
+        isize slot_idx = impl::hash_map_find_slot(map, key, hash);
+        if (slot_idx != -1) {
+            map->slots[slot_idx].value = value;
+            return STATUS_OK;
+        }
+
+        // Keep the load factor, accounting for tombstones, below 7/8. If the tombstones are the
+        // reason for the high load, a rehash with the same capacity suffices.
+        usize capacity = map->capacity;
+        if ((map->count + map->tombstone_count + 1u) * 8u > capacity * 7u) {
+            usize new_capacity = capacity;
+            if (capacity == 0) {
+                new_capacity = impl::hash_map_capacity_for(1);
+            } else if ((map->count + 1u) * 16u > capacity * 7u) {
+                new_capacity = 2u * capacity;  // Already a power of two that fits the new element.
+            }
+            if (psh_unlikely(!hash_map_rehash(map, new_capacity))) {
+                return STATUS_FAILED;
+            }
+        }
+
+        usize free_idx = impl::hash_map_find_free_slot(map, hash);
+        map->tombstone_count -= static_cast<usize>(map->ctrl[free_idx] == HASH_MAP_CTRL_DELETED);
+        map->ctrl[free_idx]  = impl::hash_map_hash_byte(hash);
+        map->slots[free_idx] = HashMapSlot<K, V>{key, value};
+        ++map->count;
+
+        return STATUS_OK;
+    }
+
+    /// Try to remove a key from the hash map.
+    ///
+    /// Return: Whether the key was present in the hash map.
+    template <typename K, typename V>
+    psh_proc Status hash_map_remove(HashMap<K, V>* map, K key) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        isize slot_idx = impl::hash_map_find_slot(map, key, hash_value(key));
+        if (slot_idx == -1) {
+            return STATUS_FAILED;
+        }
+
+        // If the group of the slot still has an empty slot, no probing sequence went past it, and
+        // the slot can be directly marked as empty.
+        usize     group      = static_cast<usize>(slot_idx) & ~(HASH_MAP_GROUP_WIDTH - 1u);
+        bool      has_empty  = (impl::hash_map_group_match_empty(map->ctrl + group) != 0);
+        map->ctrl[slot_idx]  = has_empty ? HASH_MAP_CTRL_EMPTY : HASH_MAP_CTRL_DELETED;
+        map->tombstone_count += static_cast<usize>(!has_empty);
+        --map->count;
+
+        return STATUS_OK;
+    }
+
+    /// Remove all elements of the hash map, keeping its capacity.
+    template <typename K, typename V>
+    psh_proc void hash_map_clear(HashMap<K, V>* map) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        if (map->capacity != 0) {
+            memory_set(map->ctrl, map->capacity, HASH_MAP_CTRL_EMPTY);
+        }
+        map->count           = 0;
+        map->tombstone_count = 0;
+    }
 }  // namespace psh
@@ -0,0 +1,340 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Non-blocking TCP and UDP sockets driven by a readiness event loop.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#pragma once
+
+#include "psh_core.hpp"
+#include "psh_memory.hpp"
+#include "psh_platform.hpp"
+#include "psh_string.hpp"
+
+namespace psh {
+    // -------------------------------------------------------------------------------------------------
+    // Network status.
+    // -------------------------------------------------------------------------------------------------
+
+    enum NetStatus {
+        NET_STATUS_OK,
+
+        /// The operation can't make progress until the socket becomes ready again.
+        NET_STATUS_WOULD_BLOCK,
+
+        /// The peer closed or reset the connection.
+        NET_STATUS_CLOSED,
+
+        /// The receive buffer has no room left, even after discarding its consumed bytes.
+        NET_STATUS_BUFFER_FULL,
+
+        NET_STATUS_FAILED,
+    };
+
+    psh_proc psh_inline String net_status_to_string(NetStatus status) psh_no_except {
+        String string = {};
+        switch (status) {
+            case NET_STATUS_OK:          string = psh::make_string("psh::NET_STATUS_OK"); break;
+            case NET_STATUS_WOULD_BLOCK: string = psh::make_string("psh::NET_STATUS_WOULD_BLOCK"); break;
+            case NET_STATUS_CLOSED:      string = psh::make_string("psh::NET_STATUS_CLOSED"); break;
+            case NET_STATUS_BUFFER_FULL: string = psh::make_string("psh::NET_STATUS_BUFFER_FULL"); break;
+            case NET_STATUS_FAILED:      string = psh::make_string("psh::NET_STATUS_FAILED"); break;
+        }
+        return string;
+    }
+
+    /// Initialise the networking subsystem of the operating system, required on Windows before any
+    /// socket is created. Every call should be paired with a call to destroy_net.
+    psh_proc Status init_net() psh_no_except;
+    psh_proc void   destroy_net() psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Addresses.
+    // -------------------------------------------------------------------------------------------------
+
+    /// Size in bytes of the largest socket address supported, that of an IPv6 address.
+    psh_global constexpr usize NET_ADDRESS_MAX_SIZE = 28;
+
+    /// IPv4 or IPv6 address with a port, stored in the native socket address format.
+    struct NetAddress {
+        alignas(8) u8 storage[NET_ADDRESS_MAX_SIZE] = {};
+        u32 size                                    = 0;
+    };
+
+    psh_proc NetAddress make_net_address_ipv4(u8 a, u8 b, u8 c, u8 d, u16 port) psh_no_except;
+
+    /// Parse a numeric IPv4 address, as in "127.0.0.1", or IPv6 address, as in "::1".
+    ///
+    /// Note: Host names aren't resolved.
+    ///
+    /// Return: STATUS_FAILED if the host isn't a numeric address.
+    psh_proc Status net_address_parse(String host, u16 port, NetAddress* address) psh_no_except;
+
+    psh_proc u16 net_address_port(NetAddress const* address) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Sockets.
+    //
+    // All sockets are created in non-blocking mode: operations that can't be completed right away
+    // return NET_STATUS_WOULD_BLOCK, and should be retried once a NetPoller reports the socket as
+    // ready.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_global constexpr u32 NET_DEFAULT_BACKLOG = 128;
+
+    struct Socket {
+#if PSH_OS_WINDOWS
+        uptr handle = ~uptr{0};
+#else
+        i32 handle = -1;
+#endif
+    };
+
+    /// Create a TCP socket listening for connections on a given address. Port zero picks any free
+    /// port, which can be queried via net_local_address.
+    psh_proc Status net_tcp_listen(Socket* listener, NetAddress const* address, u32 backlog = NET_DEFAULT_BACKLOG) psh_no_except;
+
+    /// Accept a pending connection of a listening socket.
+    ///
+    /// Parameters:
+    ///     * peer_address: Optionally receives the address of the peer.
+    psh_proc NetStatus net_tcp_accept(Socket const* listener, Socket* connection, NetAddress* peer_address = nullptr) psh_no_except;
+
+    /// Start connecting a TCP socket to a given address.
+    ///
+    /// Return: NET_STATUS_OK if connected right away. NET_STATUS_WOULD_BLOCK if the connection is in
+    ///         progress, in which case the socket becomes writable once it is established or failed,
+    ///         and net_tcp_finish_connect tells which happened.
+    psh_proc NetStatus net_tcp_connect(Socket* connection, NetAddress const* address) psh_no_except;
+
+    /// Check the outcome of a connection started by net_tcp_connect.
+    psh_proc Status net_tcp_finish_connect(Socket const* connection) psh_no_except;
+
+    /// Disable the coalescing of small writes, sending them as soon as possible.
+    psh_proc Status net_tcp_set_no_delay(Socket const* connection, bool no_delay) psh_no_except;
+
+    /// Create a UDP socket bound to a given address.
+    psh_proc Status net_udp_open(Socket* socket, NetAddress const* address) psh_no_except;
+
+    /// Close a socket, which should be removed from any poller beforehand.
+    psh_proc void net_close(Socket* socket) psh_no_except;
+
+    /// Obtain the address that a socket is bound to.
+    psh_proc Status net_local_address(Socket const* socket, NetAddress* address) psh_no_except;
+
+    /// Send bytes through a connected socket.
+    ///
+    /// Parameters:
+    ///     * sent_count: Receives the number of bytes sent, which may be less than requested.
+    psh_proc NetStatus net_send(Socket const* socket, FatPtr<u8 const> data, usize* sent_count) psh_no_except;
+
+    /// Receive bytes from a connected socket.
+    ///
+    /// Parameters:
+    ///     * received_count: Receives the number of bytes written to the buffer.
+    ///
+    /// Return: NET_STATUS_CLOSED once the peer has closed the connection and all of its bytes were
+    ///         received.
+    psh_proc NetStatus net_receive(Socket const* socket, FatPtr<u8> buf, usize* received_count) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Datagrams.
+    //
+    // Batches are transferred via recvmmsg and sendmmsg on Linux, paying a single system call for
+    // many datagrams. Other platforms transfer each datagram of a batch with its own system call.
+    // -------------------------------------------------------------------------------------------------
+
+    struct NetDatagram {
+        u8*        buf;
+        usize      capacity = 0;  ///< Size of the buffer, only used when receiving.
+        usize      count    = 0;  ///< Size of the datagram.
+        NetAddress address  = {};  ///< Destination when sending, source when receiving.
+    };
+
+    struct NetBatchResult {
+        u32       count  = 0;  ///< Number of datagrams transferred.
+        NetStatus status = NET_STATUS_OK;
+    };
+
+    /// Send a batch of datagrams through a UDP socket, in order.
+    ///
+    /// Return: The number of datagrams sent, with the status of the first datagram that couldn't be
+    ///         sent, if any.
+    psh_proc NetBatchResult net_udp_send_batch(Socket const* socket, FatPtr<NetDatagram const> datagrams) psh_no_except;
+
+    /// Receive datagrams of a UDP socket, filling the count and address of each datagram.
+    ///
+    /// Datagrams larger than the capacity of their buffer are truncated.
+    ///
+    /// Return: The number of datagrams received. The status is NET_STATUS_WOULD_BLOCK when no
+    ///         datagram was pending.
+    psh_proc NetBatchResult net_udp_receive_batch(Socket const* socket, FatPtr<NetDatagram> datagrams) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Event loop.
+    //
+    // A poller watches for sockets becoming ready to be read from or written to, with backends
+    // epoll on Linux, kqueue on macOS and WSAPoll on Windows. Readiness is level-triggered: a
+    // socket keeps being reported while it stays ready.
+    //
+    // Usage example:
+    //
+    //     NetPoller poller;
+    //     init_net_poller(&poller, &arena);
+    //     net_poller_add(&poller, &listener, NET_EVENT_READ, &listener);
+    //
+    //     Buffer<NetEvent, 64> events;
+    //     for (;;) {
+    //         u32 count = net_poller_wait(&poller, make_fat_ptr(&events), -1);
+    //         for (u32 idx = 0; idx < count; ++idx) {
+    //             // Accept connections, or receive on the connection held by the user data.
+    //         }
+    //     }
+    // -------------------------------------------------------------------------------------------------
+
+    psh_global constexpr u32 NET_POLLER_DEFAULT_CAPACITY = 256;
+
+    enum NetEventFlag : u32 {
+        NET_EVENT_READ    = 1u << 0,
+        NET_EVENT_WRITE   = 1u << 1,
+        NET_EVENT_HANG_UP = 1u << 2,  ///< The peer closed the connection, only reported.
+        NET_EVENT_ERROR   = 1u << 3,  ///< The socket has a pending error, only reported.
+    };
+
+    struct NetEvent {
+        void* user_data;
+        u32   flags;
+    };
+
+    enum NetPollerBackend {
+        NET_POLLER_BACKEND_EPOLL,
+        NET_POLLER_BACKEND_KQUEUE,
+        NET_POLLER_BACKEND_WSAPOLL,
+    };
+
+    struct NetPoller {
+        u8*              native_events = nullptr;  ///< Events in the format of the backend.
+        void**           user_data     = nullptr;  ///< User data of each registered socket, for WSAPoll only.
+        u32              capacity      = 0;
+        u32              count         = 0;  ///< Number of registered sockets.
+        NetPollerBackend backend       = NET_POLLER_BACKEND_EPOLL;
+#if !PSH_OS_WINDOWS
+        i32 fd = -1;
+#endif
+    };
+
+    /// Initialise a poller.
+    ///
+    /// Parameters:
+    ///     * arena: Arena providing the event buffers of the poller, it should outlive it.
+    ///     * capacity: Maximum number of sockets registered at once.
+    psh_proc Status init_net_poller(NetPoller* poller, Arena* arena, u32 capacity = NET_POLLER_DEFAULT_CAPACITY) psh_no_except;
+
+    psh_proc void destroy_net_poller(NetPoller* poller) psh_no_except;
+
+    /// Watch a socket for the events of a mask of NetEventFlag values.
+    ///
+    /// Parameters:
+    ///     * user_data: Value passed back with the events of the socket.
+    psh_proc Status net_poller_add(NetPoller* poller, Socket const* socket, u32 interest, void* user_data) psh_no_except;
+
+    /// Change the events watched for a registered socket.
+    psh_proc Status net_poller_modify(NetPoller* poller, Socket const* socket, u32 interest, void* user_data) psh_no_except;
+
+    psh_proc Status net_poller_remove(NetPoller* poller, Socket const* socket) psh_no_except;
+
+    /// Wait for registered sockets to become ready.
+    ///
+    /// With kqueue, a socket watched for both reading and writing may be reported by two events.
+    ///
+    /// Parameters:
+    ///     * events: Receives the events of the ready sockets.
+    ///     * timeout_ms: Maximum time to wait, where a negative value waits indefinitely and zero
+    ///                   doesn't wait at all.
+    ///
+    /// Return: The number of events written, which is zero if the wait timed out or failed.
+    psh_proc u32 net_poller_wait(NetPoller* poller, FatPtr<NetEvent> events, i32 timeout_ms) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Connection buffers.
+    //
+    // Each connection receives into a block of a pool shared by all connections, so that buffers are
+    // recycled in constant time as connections come and go. Messages are parsed in place: the
+    // contents of the buffer are handed out as string views, and only the bytes left unconsumed are
+    // moved to the start of the block when more room is needed.
+    //
+    // Usage example:
+    //
+    //     NetBuffer buffer;
+    //     init_net_buffer(&buffer, &connection_pool);
+    //
+    //     // Once the connection is readable.
+    //     net_buffer_receive(&buffer, &connection);
+    //     String line;
+    //     while (net_buffer_next_line(&buffer, &line)) {
+    //         // Handle the request line, which is a view into the buffer.
+    //     }
+    //
+    //     destroy_net_buffer(&buffer, &connection_pool);
+    // -------------------------------------------------------------------------------------------------
+
+    struct NetBuffer {
+        u8*   buf;
+        usize capacity = 0;
+        usize begin    = 0;  ///< Start of the bytes not yet consumed.
+        usize end      = 0;  ///< End of the bytes received.
+    };
+
+    /// Take a block from the pool as the memory of the buffer, whose capacity is the block size.
+    psh_proc Status init_net_buffer(NetBuffer* buffer, Pool* pool) psh_no_except;
+
+    /// Give the block of the buffer back to its pool.
+    psh_proc void destroy_net_buffer(NetBuffer* buffer, Pool* pool) psh_no_except;
+
+    /// Receive bytes from a connected socket into the free space of the buffer.
+    ///
+    /// Return: NET_STATUS_BUFFER_FULL if all of the buffer holds bytes not yet consumed.
+    psh_proc NetStatus net_buffer_receive(NetBuffer* buffer, Socket const* socket) psh_no_except;
+
+    /// View of the bytes received but not yet consumed, valid until the next receive.
+    psh_proc psh_inline String net_buffer_contents(NetBuffer const* buffer) psh_no_except {
+        return String{reinterpret_cast<cstring>(buffer->buf + buffer->begin), buffer->end - buffer->begin};
+    }
+
+    /// Mark the first bytes of the contents as consumed.
+    psh_proc psh_inline void net_buffer_consume(NetBuffer* buffer, usize count) psh_no_except {
+        psh_validate_usage(psh_assert_msg(count <= buffer->end - buffer->begin, "Consuming more bytes than received."));
+
+        buffer->begin += count;
+        if (buffer->begin == buffer->end) {
+            buffer->begin = 0;
+            buffer->end   = 0;
+        }
+    }
+
+    /// Consume the next line of the contents, terminated by "\n" or "\r\n".
+    ///
+    /// Parameters:
+    ///     * line: Receives the line without its terminator, a view valid until the next receive.
+    ///
+    /// Return: Whether a whole line was received.
+    psh_proc bool net_buffer_next_line(NetBuffer* buffer, String* line) psh_no_except;
+}  // namespace psh
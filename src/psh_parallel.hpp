@@ -0,0 +1,333 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Data-parallel algorithms running on the job system.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+
+#pragma once
+
+#include "psh_algorithms.hpp"
+#include "psh_core.hpp"
+#include "psh_memory.hpp"
+#include "psh_thread.hpp"
+
+/// Default amount of bytes of a chunk of work processed by a single job: small enough to fit
+/// the L2 cache of most processors.
+#ifndef PARALLEL_FOR_DEFAULT_CHUNK_SIZE
+#    define PARALLEL_FOR_DEFAULT_CHUNK_SIZE psh_kibibytes(64)
+#endif
+
+/// Element count below which the parallel sort falls back to a sequential sort.
+#ifndef PARALLEL_SORT_SEQUENTIAL_CUTOFF
+#    define PARALLEL_SORT_SEQUENTIAL_CUTOFF 8192u
+#endif
+
+namespace psh {
+    /// Procedure applied to each chunk of a range.
+    ///
+    /// Parameters:
+    ///     * chunk: Slice of the range.
+    ///     * chunk_start: Index of the first element of the chunk in the whole range.
+    ///     * context: User data.
+    template <typename T>
+    using ParallelForFn = void(FatPtr<T> chunk, usize chunk_start, void* context);
+
+    /// Procedure reducing a chunk of a range to a single value.
+    template <typename T, typename R>
+    using ParallelReduceChunkFn = R(FatPtr<T const> chunk, void* context);
+
+    /// Procedure combining two partial reductions.
+    template <typename R>
+    using ParallelCombineFn = R(R lhs, R rhs, void* context);
+
+    namespace impl {
+        /// Get the number of elements of type T per chunk of the given size in bytes.
+        template <typename T>
+        psh_proc psh_inline usize parallel_chunk_count(usize chunk_size) psh_no_except {
+            return psh_max_value(chunk_size / psh_usize_of(T), usize{1});
+        }
+
+        template <typename T>
+        struct ParallelForTask {
+            ParallelForFn<T>* fn;
+            void*             context;
+            FatPtr<T>         chunk;
+            usize             chunk_start;
+        };
+
+        template <typename T>
+        psh_proc void parallel_for_job(void* data, Arena* scratch) psh_no_except {
+            psh_discard_value(scratch);
+            ParallelForTask<T>* task = reinterpret_cast<ParallelForTask<T>*>(data);
+            task->fn(task->chunk, task->chunk_start, task->context);
+        }
+
+        template <typename T, typename R>
+        struct ParallelReduceTask {
+            ParallelReduceChunkFn<T, R>* fn;
+            void*                        context;
+            FatPtr<T const>              chunk;
+            R                            result;
+        };
+
+        template <typename T, typename R>
+        psh_proc void parallel_reduce_job(void* data, Arena* scratch) psh_no_except {
+            psh_discard_value(scratch);
+            ParallelReduceTask<T, R>* task = reinterpret_cast<ParallelReduceTask<T, R>*>(data);
+            task->result                   = task->fn(task->chunk, task->context);
+        }
+
+        template <typename T>
+        struct ParallelSortTask {
+            T*    data;
+            T*    scratch;
+            usize start;
+            usize mid;
+            usize end;
+        };
+
+        template <typename T>
+        psh_proc void parallel_sort_run_job(void* data, Arena* scratch) psh_no_except {
+            psh_discard_value(scratch);
+            ParallelSortTask<T>* task  = reinterpret_cast<ParallelSortTask<T>*>(data);
+            usize                count = task->end - task->start;
+            merge_sort(FatPtr<T>{task->data + task->start, count}, FatPtr<T>{task->scratch + task->start, count});
+        }
+
+        template <typename T>
+        psh_proc void parallel_sort_copy_back(FatPtr<T> chunk, usize chunk_start, void* context) psh_no_except {
+            T* dst = reinterpret_cast<T*>(context) + chunk_start;
+            for (usize idx = 0; idx < chunk.count; ++idx) {
+                dst[idx] = chunk.buf[idx];
+            }
+        }
+
+        template <typename T>
+        psh_proc void parallel_sort_merge_job(void* data, Arena* scratch) psh_no_except {
+            psh_discard_value(scratch);
+            ParallelSortTask<T>* task = reinterpret_cast<ParallelSortTask<T>*>(data);
+            merge_sorted(
+                task->data + task->start,
+                task->mid - task->start,
+                task->data + task->mid,
+                task->end - task->mid,
+                task->scratch + task->start);
+        }
+    }  // namespace impl
+
+    /// Apply a procedure to every chunk of a range, distributing the chunks among the workers of the
+    /// job system. Returns once all chunks have been processed.
+    ///
+    /// The bookkeeping memory is taken from the scratch arena of the calling worker.
+    ///
+    /// Parameters:
+    ///     * job_system: Job system whose worker is calling the procedure.
+    ///     * data: Range to be processed.
+    ///     * fn: Procedure applied to each chunk.
+    ///     * context: User data passed to each call of the procedure.
+    ///     * chunk_size: Size in bytes of each chunk.
+    template <typename T>
+    psh_proc void parallel_for(
+        JobSystem*        job_system,
+        FatPtr<T>         data,
+        ParallelForFn<T>* fn,
+        void*             context,
+        usize             chunk_size = PARALLEL_FOR_DEFAULT_CHUNK_SIZE) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(fn));
+
+        JobWorker* worker = job_system_current_worker(job_system);
+        psh_validate_usage(psh_assert_msg(worker != nullptr, "parallel_for should be called by a job system worker."));
+
+        usize chunk_count = impl::parallel_chunk_count<T>(chunk_size);
+        usize task_count  = (data.count + chunk_count - 1u) / chunk_count;
+        if (task_count <= 1) {
+            fn(data, 0, context);
+            return;
+        }
+
+        ScratchArena scratch{&worker->scratch};
+
+        impl::ParallelForTask<T>* tasks = memory_alloc<impl::ParallelForTask<T>>(scratch.arena, task_count);
+        if (psh_unlikely(tasks == nullptr)) {
+            fn(data, 0, context);
+            return;
+        }
+
+        JobCounter counter = {};
+        for (usize idx = 0; idx < task_count; ++idx) {
+            usize start = idx * chunk_count;
+            tasks[idx]  = impl::ParallelForTask<T>{
+                .fn          = fn,
+                .context     = context,
+                .chunk       = FatPtr<T>{data.buf + start, psh_min_value(chunk_count, data.count - start)},
+                .chunk_start = start,
+            };
+            job_system_submit(job_system, impl::parallel_for_job<T>, &tasks[idx], &counter);
+        }
+        job_system_wait(job_system, &counter);
+    }
+
+    /// Reduce a range to a single value in parallel.
+    ///
+    /// Each chunk of the range is reduced by a job, and the partial results are then combined in
+    /// order by the calling thread.
+    ///
+    /// Parameters:
+    ///     * job_system: Job system whose worker is calling the procedure.
+    ///     * data: Range to be reduced.
+    ///     * identity: Result for an empty range.
+    ///     * reduce_chunk: Procedure reducing a chunk to a single value.
+    ///     * combine: Associative procedure combining two partial results.
+    ///     * context: User data passed to both reduce_chunk and combine.
+    ///     * chunk_size: Size in bytes of each chunk.
+    template <typename T, typename R>
+    psh_proc R parallel_reduce(
+        JobSystem*                   job_system,
+        FatPtr<T const>              data,
+        R                            identity,
+        ParallelReduceChunkFn<T, R>* reduce_chunk,
+        ParallelCombineFn<R>*        combine,
+        void*                        context,
+        usize                        chunk_size = PARALLEL_FOR_DEFAULT_CHUNK_SIZE) psh_no_except {
+        psh_paranoid_validate_usage({
+            psh_assert_not_null(reduce_chunk);
+            psh_assert_not_null(combine);
+        });
+
+        if (data.count == 0) {
+            return identity;
+        }
+
+        JobWorker* worker = job_system_current_worker(job_system);
+        psh_validate_usage(psh_assert_msg(worker != nullptr, "parallel_reduce should be called by a job system worker."));
+
+        usize chunk_count = impl::parallel_chunk_count<T>(chunk_size);
+        usize task_count  = (data.count + chunk_count - 1u) / chunk_count;
+        if (task_count <= 1) {
+            return combine(identity, reduce_chunk(data, context), context);
+        }
+
+        ScratchArena scratch{&worker->scratch};
+
+        impl::ParallelReduceTask<T, R>* tasks = memory_alloc<impl::ParallelReduceTask<T, R>>(scratch.arena, task_count);
+        if (psh_unlikely(tasks == nullptr)) {
+            return combine(identity, reduce_chunk(data, context), context);
+        }
+
+        JobCounter counter = {};
+        for (usize idx = 0; idx < task_count; ++idx) {
+            usize start = idx * chunk_count;
+            tasks[idx]  = impl::ParallelReduceTask<T, R>{
+                .fn      = reduce_chunk,
+                .context = context,
+                .chunk   = FatPtr<T const>{data.buf + start, psh_min_value(chunk_count, data.count - start)},
+                .result  = identity,
+            };
+            job_system_submit(job_system, impl::parallel_reduce_job<T, R>, &tasks[idx], &counter);
+        }
+        job_system_wait(job_system, &counter);
+
+        R result = identity;
+        for (usize idx = 0; idx < task_count; ++idx) {
+            result = combine(result, tasks[idx].result, context);
+        }
+        return result;
+    }
+
+    /// Stable parallel sort.
+    ///
+    /// The range is split into one run per worker (with a minimum of PARALLEL_SORT_SEQUENTIAL_CUTOFF
+    /// elements per run), each run is merge sorted by its own job, and then pairs of runs are merged
+    /// in parallel until a single run is left.
+    ///
+    /// Parameters:
+    ///     * job_system: Job system whose worker is calling the procedure.
+    ///     * arena: Arena providing the scratch buffer, of the same size as the data.
+    ///     * data: Elements to be sorted.
+    ///
+    /// Return: Whether the arena had enough memory for the scratch buffer.
+    template <typename T>
+    psh_proc Status parallel_sort(JobSystem* job_system, Arena* arena, FatPtr<T> data) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(job_system));
+
+        usize count = data.count;
+        if (count <= PARALLEL_SORT_SEQUENTIAL_CUTOFF) {
+            return merge_sort(arena, data);
+        }
+
+        ScratchArena scratch_arena{arena};
+
+        T* scratch = memory_alloc<T>(scratch_arena.arena, count);
+        if (psh_unlikely(scratch == nullptr)) {
+            return STATUS_FAILED;
+        }
+
+        // Split the range into a power of two number of runs, at least one per worker.
+        usize run_count = 1;
+        while ((run_count < job_system->worker_count) && (count / (2u * run_count) >= PARALLEL_SORT_SEQUENTIAL_CUTOFF)) {
+            run_count *= 2u;
+        }
+
+        impl::ParallelSortTask<T>* tasks = memory_alloc<impl::ParallelSortTask<T>>(scratch_arena.arena, run_count);
+        if (psh_unlikely(tasks == nullptr)) {
+            return STATUS_FAILED;
+        }
+
+        usize run_size = (count + run_count - 1u) / run_count;
+
+        JobCounter counter = {};
+        for (usize idx = 0; idx < run_count; ++idx) {
+            usize start = psh_min_value(idx * run_size, count);
+            usize end   = psh_min_value(start + run_size, count);
+            tasks[idx]  = impl::ParallelSortTask<T>{.data = data.buf, .scratch = scratch, .start = start, .mid = end, .end = end};
+            job_system_submit(job_system, impl::parallel_sort_run_job<T>, &tasks[idx], &counter);
+        }
+        job_system_wait(job_system, &counter);
+
+        // Merge pairs of runs, alternating between the data and scratch buffers.
+        T* src = data.buf;
+        T* dst = scratch;
+        for (usize width = run_size; width < count; width *= 2u) {
+            usize merge_count = 0;
+            for (usize start = 0; start < count; start += 2u * width) {
+                usize mid = psh_min_value(start + width, count);
+                usize end = psh_min_value(start + 2u * width, count);
+
+                tasks[merge_count] = impl::ParallelSortTask<T>{.data = src, .scratch = dst, .start = start, .mid = mid, .end = end};
+                job_system_submit(job_system, impl::parallel_sort_merge_job<T>, &tasks[merge_count], &counter);
+                ++merge_count;
+            }
+            job_system_wait(job_system, &counter);
+
+            T* tmp = src;
+            src    = dst;
+            dst    = tmp;
+        }
+
+        if (src != data.buf) {
+            FatPtr<T> sorted = {src, count};
+            parallel_for(job_system, sorted, impl::parallel_sort_copy_back<T>, data.buf);
+        }
+
+        return STATUS_OK;
+    }
+}  // namespace psh
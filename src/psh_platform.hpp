@@ -41,7 +41,7 @@
 #if defined(__x86_64__) || defined(_M_X64) || defined(__amd64__)
 #    undef PSH_ARCH_X64
 #    define PSH_ARCH_X64 1
-#elif defined(__arm__) || defined(_ARM_) || defined(_ARM_ARCH)
+#elif defined(__arm__) || defined(_ARM_) || defined(_ARM_ARCH) || defined(__aarch64__) || defined(_M_ARM64)
 #    undef PSH_ARCH_ARM
 #    define PSH_ARCH_ARM 1
 #endif
@@ -240,7 +240,7 @@
 #endif
 
 // Detect SIMD availability in ARM processors.
-#if PSH_ARCH_ARM && defined(__ARM_NEON)
+#if PSH_ARCH_ARM && (defined(__ARM_NEON) || defined(_M_ARM64))
 #    undef PSH_ARCH_SIMD_NEON
 #    define PSH_ARCH_SIMD_NEON 1
 #endif
@@ -343,10 +343,16 @@
 #    define psh_source_function_name() "<unknown name>"
 #endif
 
+/// Query the file name, line number and function name of the current line.
+///
+/// Unlike psh_source_function_name, these can be used as default arguments, in which case they
+/// refer to the call site instead.
 #if PSH_COMPILER_CLANG || PSH_COMPILER_GCC || PSH_COMPILER_MSVC
-#    define psh_source_file_name()   __builtin_FILE()
-#    define psh_source_line_number() __builtin_LINE()
+#    define psh_source_file_name()            __builtin_FILE()
+#    define psh_source_line_number()          __builtin_LINE()
+#    define psh_source_caller_function_name() __builtin_FUNCTION()
 #else
-#    define psh_source_file_name()   "<unknown file>"
-#    define psh_source_line_number() 0
+#    define psh_source_file_name()            "<unknown file>"
+#    define psh_source_line_number()          0
+#    define psh_source_caller_function_name() "<unknown name>"
 #endif
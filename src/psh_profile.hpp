@@ -0,0 +1,148 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+///
+/// Description: Instrumented profiling zones with Chrome trace export.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+///
+/// Usage example:
+///
+///     profile_register_thread(&arena);
+///
+///     psh_profile_begin(load_assets);
+///     ... load the assets ...
+///     psh_profile_end(load_assets);
+///
+///     {
+///         psh_profile_scope(update);
+///         ... the zone ends together with the scope ...
+///     }
+///
+///     profile_write_chrome_trace(&arena, "trace.json");
+///
+/// The resulting file can be opened with chrome://tracing or https://ui.perfetto.dev. The zone macros
+/// compile to nothing unless PSH_ENABLE_PROFILING is set, while the procedures are always available.
+
+#pragma once
+
+#include "psh_atomic.hpp"
+#include "psh_core.hpp"
+#include "psh_defer.hpp"
+#include "psh_time.hpp"
+
+namespace psh {
+    // Forward declaration.
+    struct Arena;
+
+    psh_global constexpr u32 PROFILE_DEFAULT_EVENT_CAPACITY = 1u << 16;
+
+    /// Zone that has been opened but not yet recorded.
+    struct ProfileZone {
+        cstring name;
+        u64     begin;
+    };
+
+    struct ProfileEvent {
+        cstring name;
+        u64     begin;
+        u64     end;
+    };
+
+    /// Ring buffer of the events recorded by a single thread.
+    ///
+    /// Once the buffer is full, the oldest events are overwritten. The buffer of an unregistered
+    /// thread keeps its events until another thread registers and takes it over.
+    struct ProfileThreadBuffer {
+        ProfileEvent*        events;
+        u64                  count;  ///< Total number of events recorded by the thread.
+        u32                  mask;
+        u32                  thread_id;
+        cstring              thread_name;
+        ProfileThreadBuffer* next;
+        Atomic<u32>          released;  ///< Whether the owning thread unregistered.
+    };
+
+    /// Register the calling thread with the profiler, allowing it to record zones.
+    ///
+    /// Zones on threads that aren't registered are silently discarded. The buffer of a thread that
+    /// unregistered is reused if it has enough capacity, otherwise a new one is acquired from the
+    /// arena, so threads that come and go should call profile_unregister_thread before exiting.
+    ///
+    /// Parameters:
+    ///     * arena: Arena providing the event buffer, it should outlive the profiler usage.
+    ///     * event_capacity: Number of events kept by the thread, should be a power of two.
+    ///     * thread_name: Optional name displayed by the trace viewer, should have static lifetime.
+    psh_proc Status profile_register_thread(
+        Arena*  arena,
+        u32     event_capacity = PROFILE_DEFAULT_EVENT_CAPACITY,
+        cstring thread_name    = nullptr) psh_no_except;
+
+    /// Stop recording the zones of the calling thread, handing its buffer over to the next thread to
+    /// register. The recorded events are kept until then.
+    psh_proc void profile_unregister_thread() psh_no_except;
+
+    /// Discard all events recorded by the calling thread.
+    psh_proc void profile_clear_thread() psh_no_except;
+
+    /// Get the event buffer of the calling thread, or null if the thread isn't registered.
+    psh_proc ProfileThreadBuffer* profile_thread_buffer() psh_no_except;
+
+    namespace impl {
+        psh_proc void profile_record(cstring name, u64 begin, u64 end) psh_no_except;
+    }
+
+    /// Open a zone, the name should have static lifetime.
+    psh_proc psh_inline ProfileZone profile_zone_begin(cstring name) psh_no_except {
+        return ProfileZone{.name = name, .begin = cpu_timestamp_counter()};
+    }
+
+    /// Close a zone, recording it into the event buffer of the calling thread.
+    psh_proc psh_inline void profile_zone_end(ProfileZone zone) psh_no_except {
+        impl::profile_record(zone.name, zone.begin, cpu_timestamp_counter());
+    }
+
+    /// Write the events of all registered threads to a file in the Chrome trace event format.
+    ///
+    /// The threads recording events should be quiescent while the trace is written.
+    ///
+    /// Parameters:
+    ///     * scratch: Arena used for the writer buffer, its memory is released once the trace is written.
+    ///     * path: Zero-terminated path to the output file.
+    psh_proc Status profile_write_chrome_trace(Arena* scratch, cstring path) psh_no_except;
+}  // namespace psh
+
+// -------------------------------------------------------------------------------------------------
+// Zone macros.
+//
+// The zone name is an identifier, so that the begin and end of a zone are paired at compile time.
+// -------------------------------------------------------------------------------------------------
+
+#if PSH_ENABLE_PROFILING
+#    define psh_profile_begin(zone) psh::ProfileZone psh_profile_zone_##zone = psh::profile_zone_begin(#zone)
+#    define psh_profile_end(zone)   psh::profile_zone_end(psh_profile_zone_##zone)
+#    define psh_profile_scope(zone) \
+        psh_profile_begin(zone);    \
+        psh_defer(psh_profile_end(zone))
+#else
+#    define psh_profile_begin(zone) static_cast<void>(0)
+#    define psh_profile_end(zone)   static_cast<void>(0)
+#    define psh_profile_scope(zone) static_cast<void>(0)
+#endif
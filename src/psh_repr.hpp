@@ -45,30 +45,19 @@ namespace psh {
             return make_dynamic_string(arena, psh_comptime_make_string("0b0"));
         }
 
-        // @TODO: First construct a local char[BIT_COUNT] buffer then copy everything to
-        //        the resulting representaiton string.
         constexpr i32 BIT_COUNT = psh_type_bit_count(T);
 
-        DynamicString repr = make_dynamic_string(arena, 2 + BIT_COUNT + 1);
+        // Build the representation on the stack, copying it to the arena all at once.
+        char digits[2 + BIT_COUNT];
+        digits[0] = '0';
+        digits[1] = 'b';
 
-        repr.buf[0] = '0';
-        repr.buf[1] = 'b';
-        repr.count += 2;
-
-        // @TODO: We can make better, right?
-        i32 leading_zeros_count = 0;
-        for (i32 idx = BIT_COUNT - 1; idx >= 0; --idx) {
-            if (psh_bit_at(val, idx) == 0) {
-                ++leading_zeros_count;
-            } else {
-                break;
-            }
-        }
-
-        for (i32 idx = BIT_COUNT - 1 - leading_zeros_count; idx >= 0; --idx) {
-            repr[repr.count++] = digit_to_char(psh_bit_at(val, idx));
+        i32   highest_bit = static_cast<i32>(BIT_COUNT - 1u - bit_count_leading_zeros(static_cast<u64>(val) << (64 - BIT_COUNT)));
+        usize count       = 2;
+        for (i32 idx = highest_bit; idx >= 0; --idx) {
+            digits[count++] = digit_to_char(static_cast<u8>(psh_bit_at(val, idx)));
         }
 
-        return repr;
+        return make_dynamic_string(arena, String{digits, count});
     }
 }  // namespace psh
@@ -0,0 +1,333 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+///
+/// Description: Binary serialization of containers and arenas, loaded in place from mapped files.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#pragma once
+
+#include "psh_core.hpp"
+#include "psh_memory.hpp"
+#include "psh_platform.hpp"
+#include "psh_streams.hpp"
+#include "psh_string.hpp"
+
+namespace psh {
+    // -------------------------------------------------------------------------------------------------
+    // Serialized files.
+    //
+    // A serialized file is made of a header, a directory of named sections, and the contents of
+    // each section. Sections refer to their contents via offsets from the start of the file, and
+    // the contents are stored in the exact memory layout of the running program, so that loading
+    // a file amounts to mapping it into memory: arrays and hash maps are used directly from the
+    // mapped pages, without any deserialization pass.
+    //
+    // The header holds a checksum of the directory, which is always verified when opening a file,
+    // and each section holds a checksum of its own contents, which is only verified on request
+    // since it requires reading the whole file.
+    //
+    // The format is native to the machine writing it: elements are stored with the endianness and
+    // layout of the writer, and should be trivially copyable types without pointers. Hash maps are
+    // loaded with their original layout, so their keys should hash to the same value in every
+    // process, which excludes pointer keys.
+    //
+    // Usage example:
+    //
+    //     SerialWriter writer;
+    //     init_serial_writer(&writer, &arena);
+    //     serial_writer_add_array(&writer, make_string("ids"), make_const_fat_ptr(&ids));
+    //     serial_writer_add_hash_map(&writer, make_string("id_to_score"), &id_to_score);
+    //     write_serial_file(&writer, &arena, "tables.bin");
+    //
+    //     SerialFile file;
+    //     if (open_serial_file(&file, "tables.bin") == SERIAL_STATUS_OK) {
+    //         FatPtr<u32 const> ids;
+    //         HashMap<u32, f32> id_to_score;
+    //         serial_file_get_array(&file, make_string("ids"), &ids);
+    //         serial_file_get_hash_map(&file, make_string("id_to_score"), &id_to_score);
+    //         ...
+    //         close_serial_file(&file);
+    //     }
+    // -------------------------------------------------------------------------------------------------
+
+    /// Identifier of serialized files, the bytes "PSHS" in little endian order.
+    psh_global constexpr u32 SERIAL_MAGIC   = 0x53485350;
+    psh_global constexpr u32 SERIAL_VERSION = 1;
+
+    /// Alignment of the contents of every section, relative to the start of the file.
+    psh_global constexpr usize SERIAL_SECTION_ALIGNMENT = 64;
+
+    /// Maximum size of a section name, including its zero terminator.
+    psh_global constexpr usize SERIAL_SECTION_NAME_MAX_SIZE = 32;
+
+    enum SerialStatus {
+        SERIAL_STATUS_OK,
+        SERIAL_STATUS_FAILED_TO_OPEN,
+        SERIAL_STATUS_FAILED_TO_WRITE,
+
+        /// The file isn't a serialized file, was written by an incompatible version, or is truncated.
+        SERIAL_STATUS_INVALID_FORMAT,
+
+        /// The contents of the file don't match their checksums.
+        SERIAL_STATUS_CORRUPTED,
+    };
+
+    psh_proc psh_inline String serial_status_to_string(SerialStatus status) psh_no_except {
+        String string = {};
+        switch (status) {
+            case SERIAL_STATUS_OK:              string = psh::make_string("psh::SERIAL_STATUS_OK"); break;
+            case SERIAL_STATUS_FAILED_TO_OPEN:  string = psh::make_string("psh::SERIAL_STATUS_FAILED_TO_OPEN"); break;
+            case SERIAL_STATUS_FAILED_TO_WRITE: string = psh::make_string("psh::SERIAL_STATUS_FAILED_TO_WRITE"); break;
+            case SERIAL_STATUS_INVALID_FORMAT:  string = psh::make_string("psh::SERIAL_STATUS_INVALID_FORMAT"); break;
+            case SERIAL_STATUS_CORRUPTED:       string = psh::make_string("psh::SERIAL_STATUS_CORRUPTED"); break;
+        }
+        return string;
+    }
+
+    enum SerialSectionKind : u32 {
+        SERIAL_SECTION_KIND_ARRAY,
+        SERIAL_SECTION_KIND_HASH_MAP,
+        SERIAL_SECTION_KIND_ARENA,
+    };
+
+    /// Header found at the start of every serialized file.
+    struct SerialHeader {
+        u32 magic;
+        u32 version;
+        u32 section_count;
+        u32 section_size;        ///< Size of each entry of the directory, following the header.
+        u64 file_size;
+        u64 directory_checksum;  ///< Hash of the directory entries.
+    };
+
+    /// Entry of the directory of sections.
+    struct SerialSection {
+        char name[SERIAL_SECTION_NAME_MAX_SIZE];
+        u32  kind;
+        u32  element_size;  ///< Size of the elements, or of the key-value slots of hash maps.
+        u64  count;         ///< Number of elements, or of bytes of arena snapshots.
+        u64  capacity;      ///< Number of slots of hash maps, equal to the count otherwise.
+        u64  offset;        ///< Position of the contents, relative to the start of the file.
+        u64  size;          ///< Size of the contents, including any padding between its parts.
+        u64  checksum;      ///< Hash of the contents, excluding padding.
+    };
+
+    // -------------------------------------------------------------------------------------------------
+    // Writing serialized files.
+    // -------------------------------------------------------------------------------------------------
+
+    struct SerialWriter;
+
+    namespace impl {
+        /// Section waiting to be written, whose contents are made of at most two separate parts.
+        struct SerialPendingSection {
+            SerialSection    entry;
+            FatPtr<u8 const> parts[2];
+            usize            second_part_offset;  ///< Position of the second part, relative to the contents.
+        };
+
+        psh_proc void serial_writer_add_section(
+            SerialWriter*     writer,
+            String            name,
+            SerialSectionKind kind,
+            usize             element_size,
+            usize             count,
+            usize             capacity,
+            FatPtr<u8 const>  first_part,
+            FatPtr<u8 const>  second_part,
+            usize             second_part_alignment) psh_no_except;
+    }  // namespace impl
+
+    /// Collection of sections to be written to a serialized file.
+    ///
+    /// The writer only keeps references to the contents of its sections, which are copied when the
+    /// file gets written, so they should be kept alive and unchanged until then.
+    struct SerialWriter {
+        DynamicArray<impl::SerialPendingSection> sections;
+        u64                                      contents_size = 0;  ///< Size of the contents added so far.
+    };
+
+    /// Initialise a writer whose book-keeping memory is provided by an arena.
+    psh_proc void init_serial_writer(SerialWriter* writer, Arena* arena) psh_no_except;
+
+    /// Add a section holding a sequence of elements.
+    ///
+    /// Parameters:
+    ///     * name: Unique name of the section, with less than SERIAL_SECTION_NAME_MAX_SIZE characters.
+    ///     * elements: Contents of the section, kept alive until the file is written.
+    template <typename T>
+    psh_proc psh_inline void serial_writer_add_array(SerialWriter* writer, String name, FatPtr<T const> elements) psh_no_except {
+        static_assert(alignof(T) <= SERIAL_SECTION_ALIGNMENT, "Elements are over-aligned for serialization.");
+
+        FatPtr<u8 const> bytes = {reinterpret_cast<u8 const*>(elements.buf), elements.count * psh_usize_of(T)};
+        impl::serial_writer_add_section(writer, name, SERIAL_SECTION_KIND_ARRAY, psh_usize_of(T), elements.count, elements.count, bytes, {}, 1);
+    }
+    template <typename T>
+    psh_proc psh_inline void serial_writer_add_array(SerialWriter* writer, String name, Array<T> const* array) psh_no_except {
+        serial_writer_add_array(writer, name, FatPtr<T const>{array->buf, array->count});
+    }
+    template <typename T>
+    psh_proc psh_inline void serial_writer_add_array(SerialWriter* writer, String name, DynamicArray<T> const* darray) psh_no_except {
+        serial_writer_add_array(writer, name, FatPtr<T const>{darray->buf, darray->count});
+    }
+
+    /// Add a section holding the slots and control bytes of a hash map.
+    template <typename K, typename V>
+    psh_proc psh_inline void serial_writer_add_hash_map(SerialWriter* writer, String name, HashMap<K, V> const* map) psh_no_except {
+        using Slot = HashMapSlot<K, V>;
+        static_assert(alignof(Slot) <= SERIAL_SECTION_ALIGNMENT, "Slots are over-aligned for serialization.");
+
+        usize            slot_size = psh_usize_of(Slot);
+        FatPtr<u8 const> slots     = {reinterpret_cast<u8 const*>(map->slots), map->capacity * slot_size};
+        FatPtr<u8 const> ctrl      = {map->ctrl, map->capacity};
+        impl::serial_writer_add_section(
+            writer,
+            name,
+            SERIAL_SECTION_KIND_HASH_MAP,
+            slot_size,
+            map->count,
+            map->capacity,
+            slots,
+            ctrl,
+            HASH_MAP_GROUP_WIDTH);
+    }
+
+    /// Add a section holding a snapshot of all of the memory in use by an arena.
+    ///
+    /// The arena contents are loaded at an arbitrary address, so any data structure within the
+    /// arena that should survive the round-trip must refer to its parts via offsets relative to
+    /// the start of the arena rather than via pointers. Chained arenas can't be snapshotted.
+    psh_proc void serial_writer_add_arena(SerialWriter* writer, String name, Arena const* arena) psh_no_except;
+
+    /// Write the header, the directory and the contents of all sections to a file.
+    ///
+    /// Parameters:
+    ///     * arena: Arena providing the temporary write buffer.
+    ///     * path: A zero-terminated string containing the path to the file, which is overwritten.
+    psh_proc SerialStatus write_serial_file(SerialWriter const* writer, Arena* arena, cstring path) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Loading serialized files.
+    // -------------------------------------------------------------------------------------------------
+
+    enum SerialOpenFlag : u32 {
+        SERIAL_OPEN_FLAG_NONE = 0,
+
+        /// Verify the checksum of the contents of every section, reading the whole file.
+        SERIAL_OPEN_FLAG_VERIFY_CONTENTS = 1u << 0,
+
+        /// Ask the system to read the whole file ahead of time, see MAP_FILE_HINT_WILL_NEED.
+        SERIAL_OPEN_FLAG_WILL_NEED = 1u << 1,
+    };
+
+    /// Serialized file mapped into read-only memory.
+    struct SerialFile {
+        FatPtr<u8 const>     content  = {};
+        SerialHeader const*  header   = nullptr;
+        SerialSection const* sections = nullptr;
+    };
+
+    /// Map a serialized file into memory and validate its header and directory.
+    ///
+    /// Parameters:
+    ///     * file: File to be initialised, which should be closed via close_serial_file if the
+    ///             call succeeds.
+    ///     * path: A zero-terminated string containing the path to the file.
+    ///     * flags: Combination of SerialOpenFlag flags.
+    psh_proc SerialStatus open_serial_file(SerialFile* file, cstring path, u32 flags = SERIAL_OPEN_FLAG_NONE) psh_no_except;
+
+    /// Unmap the file. Any container obtained from the file is invalidated.
+    psh_proc void close_serial_file(SerialFile* file) psh_no_except;
+
+    /// Find a section by its name.
+    ///
+    /// Return: The directory entry of the section, or null if there is no section with the name.
+    psh_proc SerialSection const* serial_file_find_section(SerialFile const* file, String name) psh_no_except;
+
+    /// Verify the checksum of the contents of a section.
+    psh_proc Status serial_file_verify_section(SerialFile const* file, SerialSection const* section) psh_no_except;
+
+    namespace impl {
+        /// Find a section of a given kind and element size, logging the reason of any mismatch.
+        psh_proc SerialSection const* serial_file_find_section_of(
+            SerialFile const* file,
+            String            name,
+            SerialSectionKind kind,
+            usize             element_size) psh_no_except;
+    }  // namespace impl
+
+    /// Get a view of the elements of an array section.
+    ///
+    /// Return: Whether the file has an array section with the given name and element size.
+    template <typename T>
+    psh_proc Status serial_file_get_array(SerialFile const* file, String name, FatPtr<T const>* elements) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(elements));
+
+        SerialSection const* section = impl::serial_file_find_section_of(file, name, SERIAL_SECTION_KIND_ARRAY, psh_usize_of(T));
+        if (psh_unlikely(section == nullptr)) {
+            return STATUS_FAILED;
+        }
+
+        *elements = FatPtr<T const>{
+            reinterpret_cast<T const*>(file->content.buf + section->offset),
+            static_cast<usize>(section->count),
+        };
+        return STATUS_OK;
+    }
+
+    /// Get a hash map whose slots and control bytes live in the mapped file.
+    ///
+    /// The resulting map has no arena and lives in read-only memory: it should only be accessed
+    /// via const procedures, such as hash_map_find, and never modified.
+    ///
+    /// Return: Whether the file has a hash map section with the given name and slot size.
+    template <typename K, typename V>
+    psh_proc Status serial_file_get_hash_map(SerialFile const* file, String name, HashMap<K, V>* map) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(map));
+
+        using Slot                   = HashMapSlot<K, V>;
+        SerialSection const* section = impl::serial_file_find_section_of(file, name, SERIAL_SECTION_KIND_HASH_MAP, psh_usize_of(Slot));
+        if (psh_unlikely(section == nullptr)) {
+            return STATUS_FAILED;
+        }
+
+        // The control bytes follow the slots, aligned to the width of a group.
+        u8 const* contents   = file->content.buf + section->offset;
+        usize     slots_size = static_cast<usize>(section->capacity) * psh_usize_of(Slot);
+        usize     ctrl_start = static_cast<usize>(align_forward(slots_size, static_cast<u32>(HASH_MAP_GROUP_WIDTH)));
+
+        *map = HashMap<K, V>{
+            .ctrl            = const_cast<u8*>(contents + ctrl_start),
+            .slots           = reinterpret_cast<Slot*>(const_cast<u8*>(contents)),
+            .arena           = nullptr,
+            .capacity        = static_cast<usize>(section->capacity),
+            .count           = static_cast<usize>(section->count),
+            .tombstone_count = 0,
+        };
+        return STATUS_OK;
+    }
+
+    /// Get a view of the memory of an arena snapshot.
+    ///
+    /// Return: Whether the file has an arena section with the given name.
+    psh_proc Status serial_file_get_arena(SerialFile const* file, String name, FatPtr<u8 const>* memory) psh_no_except;
+}  // namespace psh
@@ -26,6 +26,7 @@
 
 #include "psh_core.hpp"
 #include "psh_memory.hpp"
+#include "psh_platform.hpp"
 #include "psh_string.hpp"
 
 namespace psh {
@@ -80,6 +81,7 @@ namespace psh {
     enum FileStatus {
         FILE_STATUS_FAILED_TO_OPEN,
         FILE_STATUS_FAILED_TO_READ,
+        FILE_STATUS_FAILED_TO_WRITE,
         FILE_STATUS_OUT_OF_MEMORY,
         FILE_STATUS_SIZE_UNKNOWN,
         FILE_STATUS_OK,
@@ -90,6 +92,7 @@ namespace psh {
         switch (status) {
             case FILE_STATUS_FAILED_TO_OPEN: string = psh::make_string("psh::FILE_STATUS_FAILED_TO_OPEN"); break;
             case FILE_STATUS_FAILED_TO_READ: string = psh::make_string("psh::FILE_STATUS_FAILED_TO_READ"); break;
+            case FILE_STATUS_FAILED_TO_WRITE: string = psh::make_string("psh::FILE_STATUS_FAILED_TO_WRITE"); break;
             case FILE_STATUS_OUT_OF_MEMORY:  string = psh::make_string("psh::FILE_STATUS_OUT_OF_MEMORY"); break;
             case FILE_STATUS_SIZE_UNKNOWN:   string = psh::make_string("psh::FILE_STATUS_SIZE_UNKNOWN"); break;
             case FILE_STATUS_OK:             string = psh::make_string("psh::FILE_STATUS_OK"); break;
@@ -110,6 +113,382 @@ namespace psh {
     ///     - flag: Can be any flag with read permission.
     psh_proc FileReadResult read_file(Arena* arena, cstring path, OpenFileFlag flag = OPEN_FILE_FLAG_READ_BIN) psh_no_except;
 
+    // -------------------------------------------------------------------------------------------------
+    // Memory mapped files.
+    //
+    // Mapping a file gives read-only access to its contents directly from the operating system page
+    // cache, without zeroing or copying the data into an arena. The pages are only loaded when first
+    // touched, which makes this the preferred way of reading large input files.
+    //
+    // The contents can be viewed as a string via make_string, for instance:
+    //
+    //     FileMapResult mapped = map_file("input.txt", MAP_FILE_HINT_SEQUENTIAL);
+    //     String        text   = make_string(mapped.content);
+    //     ...
+    //     unmap_file(mapped.content);
+    // -------------------------------------------------------------------------------------------------
+
+    /// Hints to the operating system about the access pattern of a mapped file.
+    enum MapFileHint : u32 {
+        MAP_FILE_HINT_NONE = 0,
+
+        /// The contents will be read from start to end, pages may be read ahead aggressively and
+        /// freed soon after being accessed.
+        MAP_FILE_HINT_SEQUENTIAL = 1u << 0,
+
+        /// The contents will be accessed in no particular order, disabling read ahead.
+        MAP_FILE_HINT_RANDOM = 1u << 1,
+
+        /// The whole contents will be needed soon, so they should be read ahead of time.
+        MAP_FILE_HINT_WILL_NEED = 1u << 2,
+    };
+
+    struct FileMapResult {
+        FatPtr<u8 const> content = {};
+        FileStatus       status  = {};
+    };
+
+    /// Map the contents of a file into read-only memory.
+    ///
+    /// Empty files result in an empty content with an OK status, no mapping is created.
+    ///
+    /// Parameters:
+    ///     - path: A zero-terminated string containing the path to the file to be mapped.
+    ///     - hints: Combination of MapFileHint flags.
+    psh_proc FileMapResult map_file(cstring path, u32 hints = MAP_FILE_HINT_NONE) psh_no_except;
+
+    /// Release the mapping of a file created by map_file.
+    psh_proc void unmap_file(FatPtr<u8 const> content) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Streaming file reader and buffered file writer.
+    //
+    // Both keep a fixed size buffer, provided either by the user or by an arena, so that files of
+    // any size can be processed in constant memory.
+    //
+    // Usage example:
+    //
+    //     FileReader reader;
+    //     if (open_file_reader(&reader, &arena, "input.csv") == FILE_STATUS_OK) {
+    //         String line;
+    //         while (file_reader_next_line(&reader, &line)) {
+    //             // The line is a view into the reader buffer, valid until the next read.
+    //         }
+    //         close_file_reader(&reader);
+    //     }
+    // -------------------------------------------------------------------------------------------------
+
+    psh_global constexpr usize FILE_READER_DEFAULT_CHUNK_SIZE  = psh_kibibytes(64);
+    psh_global constexpr usize FILE_WRITER_DEFAULT_BUFFER_SIZE = psh_kibibytes(64);
+
+    /// Alignment required for the buffers, sizes and offsets of unbuffered writes. This is the
+    /// largest logical block size found in practice.
+    psh_global constexpr usize FILE_DIRECT_IO_ALIGNMENT = 4096;
+
+    struct FileReader {
+#if PSH_OS_WINDOWS
+        void* handle = nullptr;
+#elif PSH_OS_UNIX
+        i32 handle = -1;
+#endif
+        u8*        buf         = nullptr;
+        usize      capacity    = 0;
+        usize      begin       = 0;  ///< Start of the data not yet consumed.
+        usize      end         = 0;  ///< End of the data read into the buffer.
+        bool       end_of_file = false;
+        FileStatus status      = FILE_STATUS_OK;
+    };
+
+    /// Open a file for streaming reads into a user provided buffer.
+    ///
+    /// Parameters:
+    ///     - reader: Reader to be initialised.
+    ///     - path: A zero-terminated string containing the path to the file to be read.
+    ///     - buf: Buffer receiving the file chunks, it should outlive the reader.
+    ///     - capacity: Size of the buffer, which is also the maximum length of a line or record.
+    psh_proc FileStatus open_file_reader(FileReader* reader, cstring path, u8* buf, usize capacity) psh_no_except;
+
+    /// Open a file for streaming reads into a buffer allocated by an arena.
+    psh_proc FileStatus open_file_reader(
+        FileReader* reader,
+        Arena*      arena,
+        cstring     path,
+        usize       chunk_size = FILE_READER_DEFAULT_CHUNK_SIZE) psh_no_except;
+
+    psh_proc void close_file_reader(FileReader* reader) psh_no_except;
+
+    /// Get the next chunk of the file, of at most the buffer capacity.
+    ///
+    /// The chunk is a view into the reader buffer, valid until the next read operation.
+    ///
+    /// Return: Whether a chunk was obtained. This is false at the end of the file or if the read
+    ///         failed, in which case the reader status is set accordingly.
+    psh_proc bool file_reader_next_chunk(FileReader* reader, FatPtr<u8 const>* chunk) psh_no_except;
+
+    /// Get the next record of the file ended by a given delimiter, which isn't included in the record.
+    ///
+    /// The record is a view into the reader buffer, valid until the next read operation. Records
+    /// longer than the buffer capacity are split into pieces of the buffer capacity.
+    ///
+    /// Return: Whether a record was obtained. This is false at the end of the file or if the read
+    ///         failed, in which case the reader status is set accordingly.
+    psh_proc bool file_reader_next_record(FileReader* reader, u8 delimiter, FatPtr<u8 const>* record) psh_no_except;
+
+    /// Get the next line of the file, excluding the line feed and a preceding carriage return.
+    psh_proc bool file_reader_next_line(FileReader* reader, String* line) psh_no_except;
+
+    enum FileWriterFlag : u32 {
+        FILE_WRITER_FLAG_NONE = 0,
+
+        /// Write to the end of the file instead of overwriting its contents.
+        FILE_WRITER_FLAG_APPEND = 1u << 0,
+
+        /// Bypass the operating system page cache via O_DIRECT, F_NOCACHE or FILE_FLAG_NO_BUFFERING.
+        ///
+        /// The buffer is flushed in multiples of FILE_DIRECT_IO_ALIGNMENT bytes and the file is
+        /// truncated to its actual size once closed. If the file system doesn't support unbuffered
+        /// writes, the writer falls back to regular writes. Can't be combined with appending.
+        FILE_WRITER_FLAG_DIRECT = 1u << 1,
+    };
+
+    struct FileWriter {
+#if PSH_OS_WINDOWS
+        void* handle = nullptr;
+#elif PSH_OS_UNIX
+        i32 handle = -1;
+#endif
+        u8*        buf      = nullptr;
+        usize      capacity = 0;
+        usize      count    = 0;  ///< Number of bytes in the buffer waiting to be written.
+        u64        offset   = 0;  ///< Number of bytes written to the file so far.
+        bool       direct   = false;
+        FileStatus status   = FILE_STATUS_OK;
+    };
+
+    /// Open a file for buffered writes.
+    ///
+    /// Parameters:
+    ///     - writer: Writer to be initialised.
+    ///     - arena: Arena providing the writer buffer, it should outlive the writer.
+    ///     - path: A zero-terminated string containing the path to the file to be written. The file
+    ///             is created if it doesn't exist.
+    ///     - buffer_size: Size of the buffer, rounded up to FILE_DIRECT_IO_ALIGNMENT for direct writes.
+    ///     - flags: Combination of FileWriterFlag flags.
+    psh_proc FileStatus open_file_writer(
+        FileWriter* writer,
+        Arena*      arena,
+        cstring     path,
+        usize       buffer_size = FILE_WRITER_DEFAULT_BUFFER_SIZE,
+        u32         flags       = FILE_WRITER_FLAG_NONE) psh_no_except;
+
+    /// Flush the buffered data and close the file.
+    psh_proc Status close_file_writer(FileWriter* writer) psh_no_except;
+
+    /// Append data to the writer, writing to the file whenever the buffer becomes full.
+    psh_proc Status file_writer_write(FileWriter* writer, FatPtr<u8 const> data) psh_no_except;
+    psh_proc psh_inline Status file_writer_write(FileWriter* writer, String str) psh_no_except {
+        return file_writer_write(writer, FatPtr<u8 const>{reinterpret_cast<u8 const*>(str.buf), str.count});
+    }
+
+    /// Write the buffered data to the file.
+    ///
+    /// Direct writers keep the trailing data that doesn't fill a whole block in the buffer.
+    psh_proc Status file_writer_flush(FileWriter* writer) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Asynchronous file I/O.
+    //
+    // Reads and writes are queued into an AsyncIo context and submitted in batches, the calling
+    // thread being free to do other work until it harvests their completions. The backend is
+    // io_uring on Linux and I/O completion ports on Windows. Where neither is available, such as
+    // on kernels without io_uring, the operations are run synchronously when submitted.
+    //
+    // A context isn't meant to be shared between threads, each thread doing I/O, such as each
+    // worker of a JobSystem, should own its own context.
+    //
+    // Usage example:
+    //
+    //     AsyncIo io;
+    //     init_async_io(&io, &arena);
+    //
+    //     AsyncFile file;
+    //     async_io_open_file(&io, &file, "input.bin", ASYNC_FILE_MODE_READ);
+    //     for (u64 idx = 0; idx < chunk_count; ++idx) {
+    //         async_io_read_to_arena(&io, &arena, &file, chunk_size, idx * chunk_size, &chunks[idx]);
+    //     }
+    //     async_io_submit(&io);
+    //
+    //     Buffer<AsyncIoCompletion, 16> completions;
+    //     while (async_io_pending_count(&io) != 0) {
+    //         u32 count = async_io_wait(&io, make_fat_ptr(&completions), 1);
+    //         // Process the completed chunks while the remaining reads are in flight.
+    //     }
+    //
+    //     async_io_close_file(&file);
+    //     destroy_async_io(&io);
+    // -------------------------------------------------------------------------------------------------
+
+    psh_global constexpr u32 ASYNC_IO_DEFAULT_QUEUE_DEPTH = 64;
+
+    enum AsyncIoBackend {
+        ASYNC_IO_BACKEND_SYNC,
+        ASYNC_IO_BACKEND_IO_URING,
+        ASYNC_IO_BACKEND_IOCP,
+    };
+
+    enum AsyncFileMode {
+        /// Open an existing file for reading.
+        ASYNC_FILE_MODE_READ,
+
+        /// Open a file for writing, creating it if needed and erasing its previous contents.
+        ASYNC_FILE_MODE_WRITE,
+    };
+
+    enum AsyncIoOperation {
+        ASYNC_IO_OPERATION_READ,
+        ASYNC_IO_OPERATION_WRITE,
+    };
+
+    struct AsyncFile {
+#if PSH_OS_WINDOWS
+        void* handle = nullptr;
+#elif PSH_OS_UNIX
+        i32 handle = -1;
+#endif
+    };
+
+    struct AsyncIoCompletion {
+        void*            user_data;
+        u8*              buf;
+        isize            result;  ///< Number of bytes transferred, or -1 if the operation failed.
+        AsyncIoOperation operation;
+    };
+
+    namespace impl {
+        psh_global constexpr u32 ASYNC_IO_INVALID_SLOT = ~u32{0};
+
+        /// Book-keeping of an operation in flight.
+        struct AsyncIoSlot {
+            void*            user_data;
+            u8*              buf;
+            isize            result;
+            usize            size;
+            u64              offset;
+            AsyncFile        file;
+            AsyncIoOperation operation;
+            u32              next;  ///< Next slot of the free or completed lists.
+        };
+
+        /// Memory shared with the kernel by an io_uring instance.
+        struct IoUring {
+            i32   fd           = -1;
+            u8*   sq_ring      = nullptr;
+            u8*   cq_ring      = nullptr;
+            u8*   sqes         = nullptr;
+            usize sq_ring_size = 0;
+            usize cq_ring_size = 0;
+            usize sqes_size    = 0;
+            u32*  sq_head;
+            u32*  sq_tail;
+            u32*  sq_array;
+            u32*  cq_head;
+            u32*  cq_tail;
+            u8*   cqes;
+            u32   sq_mask;
+            u32   cq_mask;
+        };
+    }  // namespace impl
+
+    struct AsyncIo {
+        impl::AsyncIoSlot* slots;
+        u32                capacity       = 0;
+        u32                free_head      = impl::ASYNC_IO_INVALID_SLOT;
+        u32                completed_head = impl::ASYNC_IO_INVALID_SLOT;
+        u32                completed_tail = impl::ASYNC_IO_INVALID_SLOT;
+        u32                queued_count   = 0;  ///< Operations not yet submitted.
+        u32                pending_count  = 0;  ///< Operations not yet harvested.
+        AsyncIoBackend     backend        = ASYNC_IO_BACKEND_SYNC;
+#if PSH_OS_LINUX
+        impl::IoUring ring;
+#elif PSH_OS_WINDOWS
+        void* port       = nullptr;
+        void* overlapped = nullptr;
+#endif
+    };
+
+    /// Initialise an asynchronous I/O context.
+    ///
+    /// Parameters:
+    ///     * io: Context to be initialised.
+    ///     * arena: Arena providing the book-keeping memory of the context, it should outlive it.
+    ///     * queue_depth: Maximum number of operations in flight, should be a power of two.
+    psh_proc Status init_async_io(AsyncIo* io, Arena* arena, u32 queue_depth = ASYNC_IO_DEFAULT_QUEUE_DEPTH) psh_no_except;
+
+    /// Release the resources of the context. Operations still in flight are waited for.
+    psh_proc void destroy_async_io(AsyncIo* io) psh_no_except;
+
+    /// Open a file for asynchronous operations on a given context.
+    psh_proc FileStatus async_io_open_file(AsyncIo* io, AsyncFile* file, cstring path, AsyncFileMode mode) psh_no_except;
+
+    /// Close a file, all of its operations should be completed beforehand.
+    psh_proc void async_io_close_file(AsyncFile* file) psh_no_except;
+
+    /// Queue the read of a range of a file into a buffer.
+    ///
+    /// The operation only starts once submitted. The buffer should be kept alive until the
+    /// completion of the operation is harvested.
+    ///
+    /// Parameters:
+    ///     * buf: Destination buffer, with at least size bytes.
+    ///     * size: Number of bytes to read, at most 2 GiB.
+    ///     * offset: Position of the file where the read starts.
+    ///     * user_data: Value passed back with the completion.
+    ///
+    /// Return: Whether the operation was queued, which fails if the queue is full.
+    psh_proc Status async_io_read(
+        AsyncIo*         io,
+        AsyncFile const* file,
+        u8*              buf,
+        usize            size,
+        u64              offset,
+        void*            user_data) psh_no_except;
+
+    /// Queue the read of a range of a file into a buffer allocated by an arena.
+    psh_proc Status async_io_read_to_arena(
+        AsyncIo*         io,
+        Arena*           arena,
+        AsyncFile const* file,
+        usize            size,
+        u64              offset,
+        void*            user_data) psh_no_except;
+
+    /// Queue the write of a buffer into a range of a file, see async_io_read.
+    psh_proc Status async_io_write(
+        AsyncIo*         io,
+        AsyncFile const* file,
+        u8 const*        buf,
+        usize            size,
+        u64              offset,
+        void*            user_data) psh_no_except;
+
+    /// Submit all queued operations to the operating system with a single call, without blocking.
+    psh_proc Status async_io_submit(AsyncIo* io) psh_no_except;
+
+    /// Harvest finished operations, submitting any queued ones beforehand.
+    ///
+    /// Parameters:
+    ///     * completions: Receives the completed operations.
+    ///     * min_count: Minimum number of completions to wait for, clamped to the number of
+    ///                  operations pending. If zero, the call doesn't block.
+    ///
+    /// Return: The number of completions written.
+    psh_proc u32 async_io_wait(AsyncIo* io, FatPtr<AsyncIoCompletion> completions, u32 min_count) psh_no_except;
+
+    /// Number of operations whose completions weren't harvested yet.
+    psh_proc psh_inline u32 async_io_pending_count(AsyncIo const* io) psh_no_except {
+        return io->pending_count;
+    }
+
     /// Read the standard input stream bytes to a string.
     psh_proc DynamicString read_stdin(Arena* arena, u32 initial_buf_size = 128, u32 read_chunk_size = 64) psh_no_except;
 
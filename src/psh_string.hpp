@@ -135,6 +135,11 @@ namespace psh {
         return String{string.buf, string.count};
     }
 
+    /// View a range of bytes, such as file contents, as a string.
+    psh_proc psh_inline String make_string(FatPtr<u8 const> bytes) psh_no_except {
+        return String{reinterpret_cast<cstring>(bytes.buf), bytes.count};
+    }
+
     psh_proc psh_inline DynamicString make_dynamic_string(Arena* arena, usize initial_capacity) psh_no_except {
         return make_dynamic_array<char>(arena, initial_capacity);
     }
@@ -198,6 +203,306 @@ namespace psh {
         return string_equal(lhs, String{rhs, RHS_LENGTH - 1u});
     }
 
+    // -------------------------------------------------------------------------------------------------
+    // String search.
+    // -------------------------------------------------------------------------------------------------
+
+    /// Find the first occurrence of a character in a string.
+    ///
+    /// Return: The index of the character, or -1 if not found.
+    psh_proc psh_inline isize string_find_char(String str, char c) psh_no_except {
+        return memory_find_u8(reinterpret_cast<u8 const*>(str.buf), str.count, static_cast<u8>(c));
+    }
+
+    /// Find the first occurrence of a substring in a string.
+    ///
+    /// The search filters candidate positions by comparing the first and last characters of the
+    /// needle against whole blocks of the haystack, only then comparing the full needle.
+    ///
+    /// Return: The index of the start of the substring, or -1 if not found. An empty needle is
+    ///         found at index zero.
+    psh_proc isize string_find(String haystack, String needle) psh_no_except;
+    template <usize NEEDLE_LENGTH>
+    psh_proc psh_inline isize string_find(String haystack, char const (&needle)[NEEDLE_LENGTH]) psh_no_except {
+        return string_find(haystack, String{needle, NEEDLE_LENGTH - 1u});
+    }
+
+    /// State of the splitting of a string into tokens delimited by a given character.
+    ///
+    /// Every string, including an empty one, is made of at least one token, so exhaustion is
+    /// tracked apart from the remaining string.
+    struct StringSplitter {
+        String remaining;  ///< Part of the string following the last delimiter consumed.
+        char   delimiter;
+        bool   exhausted = false;
+    };
+
+    psh_proc psh_inline StringSplitter make_string_splitter(String str, char delimiter) psh_no_except {
+        return StringSplitter{.remaining = str, .delimiter = delimiter, .exhausted = false};
+    }
+
+    /// Split off the next token of a string.
+    ///
+    /// Parameters:
+    ///     * splitter: State of the splitting, whose remaining string gets updated to the part
+    ///                 following the delimiter.
+    ///     * token: Receives the part of the remaining string preceding the delimiter.
+    ///
+    /// Return: Whether a token was obtained, which is false only when the string is exhausted.
+    ///
+    /// Example:
+    ///
+    /// StringSplitter splitter = make_string_splitter(make_string("a,b,,c"), ',');
+    /// String         token;
+    /// while (string_split_next(&splitter, &token)) {
+    ///     // Yields "a", "b", "" and "c".
+    /// }
+    psh_proc bool string_split_next(StringSplitter* splitter, String* token) psh_no_except;
+
+    /// Split a string into all of its tokens delimited by a given character.
+    ///
+    /// The tokens are views into the original string, which should outlive the array.
+    psh_proc Array<String> string_split(Arena* arena, String str, char delimiter) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // String hashing.
+    //
+    // Allows strings to be used as keys of a HashMap. Notice that the map only stores the string
+    // view, the memory of the string should outlive the map.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_proc psh_inline u64 hash_value(String str) psh_no_except {
+        return hash_bytes(reinterpret_cast<u8 const*>(str.buf), str.count);
+    }
+
+    psh_proc psh_inline bool hash_key_equal(String lhs, String rhs) psh_no_except {
+        return string_equal(lhs, rhs);
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Static string tables.
+    //
+    // Perfect hash tables built at compile time from a fixed set of keys, such as command or header
+    // names, mapping a string to the index of the matching key with a single hash and a single
+    // string comparison.
+    //
+    // The table uses hash-and-displace: each key is first assigned to a bucket by its hash, and each
+    // bucket receives a seed, found at compile time, that displaces all of its keys into free slots.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_global constexpr u32 STATIC_STRING_TABLE_EMPTY_SLOT = ~0u;
+
+    /// Upper bound on the seeds tried for each bucket while building a static string table.
+    psh_global constexpr u32 STATIC_STRING_TABLE_MAX_SEED = 1u << 16;
+
+    namespace impl {
+        /// Little-endian load of a given amount of bytes of a string, usable in constant
+        /// expressions. At run time words of four and eight bytes compile into a single load,
+        /// byte-swapped on big-endian targets so that both hashes agree.
+        psh_proc psh_inline constexpr u64 static_string_load(cstring buf, usize size) psh_no_except {
+            if (!__builtin_is_constant_evaluated()) {
+                if (size == 8u) {
+                    u64 word = memory_load_unaligned<u64>(reinterpret_cast<u8 const*>(buf));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+                    word = __builtin_bswap64(word);
+#endif
+                    return word;
+                }
+                if (size == 4u) {
+                    u32 word = memory_load_unaligned<u32>(reinterpret_cast<u8 const*>(buf));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+                    word = __builtin_bswap32(word);
+#endif
+                    return static_cast<u64>(word);
+                }
+            }
+
+            u64 word = 0;
+            for (usize idx = 0; idx < size; ++idx) {
+                word |= static_cast<u64>(static_cast<u8>(buf[idx])) << (8u * idx);
+            }
+            return word;
+        }
+
+        psh_proc psh_inline constexpr u64 static_string_hash_step(u64 hash, u64 word) psh_no_except {
+            hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+            return hash ^ (hash >> 32u);
+        }
+
+        /// Hash of a string usable in constant expressions. Strings of at least eight bytes are
+        /// consumed in words, the last of which may overlap its predecessor, while shorter strings
+        /// are packed into a single word.
+        psh_proc psh_inline constexpr u64 static_string_hash(String str) psh_no_except {
+            u64   hash  = HASH_DEFAULT_SEED ^ static_cast<u64>(str.count);
+            usize count = str.count;
+            if (count >= 8u) {
+                for (usize idx = 0; idx + 8u < count; idx += 8u) {
+                    hash = static_string_hash_step(hash, static_string_load(str.buf + idx, 8u));
+                }
+                hash = static_string_hash_step(hash, static_string_load(str.buf + count - 8u, 8u));
+            } else if (count >= 4u) {
+                u64 word = static_string_load(str.buf, 4u) | (static_string_load(str.buf + count - 4u, 4u) << 32u);
+                hash     = static_string_hash_step(hash, word);
+            } else if (count > 0u) {
+                u64 word = static_string_load(str.buf, 1u)
+                           | (static_string_load(str.buf + count / 2u, 1u) << 8u)
+                           | (static_string_load(str.buf + count - 1u, 1u) << 16u);
+                hash = static_string_hash_step(hash, word);
+            }
+            return hash;
+        }
+
+        psh_proc psh_inline constexpr bool static_string_equal(String lhs, String rhs) psh_no_except {
+            if (lhs.count != rhs.count) {
+                return false;
+            }
+            for (usize idx = 0; idx < lhs.count; ++idx) {
+                if (lhs.buf[idx] != rhs.buf[idx]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        psh_proc psh_inline constexpr usize static_string_table_round_pow2(usize value) psh_no_except {
+            usize pow2 = 1;
+            while (pow2 < value) {
+                pow2 <<= 1u;
+            }
+            return pow2;
+        }
+
+        psh_proc psh_inline constexpr usize static_string_table_bucket(u64 hash, usize bucket_count) psh_no_except {
+            return static_cast<usize>(hash) & (bucket_count - 1u);
+        }
+
+        psh_proc psh_inline constexpr usize static_string_table_slot(u64 hash, u32 seed, usize slot_count) psh_no_except {
+            u64 displaced = (hash ^ (static_cast<u64>(seed) * HASH_DEFAULT_SEED)) * 0xC4CEB9FE1A85EC53ull;
+            return static_cast<usize>(displaced >> 32u) & (slot_count - 1u);
+        }
+    }  // namespace impl
+
+    /// Perfect hash table over a compile-time known set of keys.
+    ///
+    /// The keys are stored as views, their memory should outlive the table, which is always the
+    /// case for string literals.
+    template <usize KEY_COUNT>
+    struct StaticStringTable {
+        static_assert(KEY_COUNT > 0, "A static string table requires at least one key.");
+
+        static constexpr usize key_count    = KEY_COUNT;
+        static constexpr usize bucket_count = impl::static_string_table_round_pow2(KEY_COUNT);
+        static constexpr usize slot_count   = impl::static_string_table_round_pow2(2u * KEY_COUNT);
+
+        String keys[key_count]     = {};
+        u32    seeds[bucket_count] = {};
+        u32    slots[slot_count]   = {};
+    };
+
+    /// Build a static string table, meant to be evaluated at compile time.
+    ///
+    /// The keys should be created with psh_comptime_make_string, so that their characters can be
+    /// read at compile time, and must be distinct. The index of each key in the table is its
+    /// position in the given array. Lookups accept any string, such as the ones created by
+    /// make_string from character buffers.
+    ///
+    /// Example:
+    ///
+    /// psh_global constexpr String METHODS[] = {
+    ///     psh_comptime_make_string("GET"),
+    ///     psh_comptime_make_string("POST"),
+    ///     psh_comptime_make_string("DELETE"),
+    /// };
+    /// psh_global constexpr StaticStringTable<3> METHOD_TABLE = make_static_string_table(METHODS);
+    ///
+    /// assert(static_string_table_find(&METHOD_TABLE, make_string("POST")) == 1);
+    template <usize KEY_COUNT>
+    psh_proc constexpr StaticStringTable<KEY_COUNT> make_static_string_table(String const (&keys)[KEY_COUNT]) psh_no_except {
+        using Table = StaticStringTable<KEY_COUNT>;
+
+        Table table = {};
+        for (usize idx = 0; idx < Table::slot_count; ++idx) {
+            table.slots[idx] = STATIC_STRING_TABLE_EMPTY_SLOT;
+        }
+
+        u64 hashes[KEY_COUNT]                 = {};
+        u32 bucket_sizes[Table::bucket_count] = {};
+        u32 bucket_order[Table::bucket_count] = {};
+        for (usize idx = 0; idx < KEY_COUNT; ++idx) {
+            table.keys[idx] = keys[idx];
+            hashes[idx]     = impl::static_string_hash(keys[idx]);
+            bucket_sizes[impl::static_string_table_bucket(hashes[idx], Table::bucket_count)] += 1u;
+
+            for (usize other = 0; other < idx; ++other) {
+                psh_assert_msg(!impl::static_string_equal(keys[idx], keys[other]), "Static string table keys should be distinct.");
+            }
+        }
+
+        // Place the largest buckets first, while most of the slots are still free.
+        for (usize idx = 0; idx < Table::bucket_count; ++idx) {
+            usize pos = idx;
+            for (; (pos > 0) && (bucket_sizes[bucket_order[pos - 1u]] < bucket_sizes[idx]); --pos) {
+                bucket_order[pos] = bucket_order[pos - 1u];
+            }
+            bucket_order[pos] = static_cast<u32>(idx);
+        }
+
+        usize bucket_keys[KEY_COUNT]  = {};
+        usize bucket_slots[KEY_COUNT] = {};
+        for (usize order_idx = 0; order_idx < Table::bucket_count; ++order_idx) {
+            usize bucket = bucket_order[order_idx];
+            if (bucket_sizes[bucket] == 0) {
+                break;
+            }
+
+            usize size = 0;
+            for (usize idx = 0; idx < KEY_COUNT; ++idx) {
+                if (impl::static_string_table_bucket(hashes[idx], Table::bucket_count) == bucket) {
+                    bucket_keys[size++] = idx;
+                }
+            }
+
+            bool placed = false;
+            for (u32 seed = 0; !placed && (seed < STATIC_STRING_TABLE_MAX_SEED); ++seed) {
+                placed = true;
+                for (usize key_idx = 0; placed && (key_idx < size); ++key_idx) {
+                    usize slot = impl::static_string_table_slot(hashes[bucket_keys[key_idx]], seed, Table::slot_count);
+                    placed &= (table.slots[slot] == STATIC_STRING_TABLE_EMPTY_SLOT);
+                    for (usize prev = 0; placed && (prev < key_idx); ++prev) {
+                        placed &= (bucket_slots[prev] != slot);
+                    }
+                    bucket_slots[key_idx] = slot;
+                }
+
+                if (placed) {
+                    table.seeds[bucket] = seed;
+                    for (usize key_idx = 0; key_idx < size; ++key_idx) {
+                        table.slots[bucket_slots[key_idx]] = static_cast<u32>(bucket_keys[key_idx]);
+                    }
+                }
+            }
+            psh_assert_msg(placed, "Unable to find a perfect hash for the static string table.");
+        }
+
+        return table;
+    }
+
+    /// Find the index of a key in a static string table.
+    ///
+    /// Return: The index of the key matching the string, or -1 if the string isn't a key.
+    template <usize KEY_COUNT>
+    psh_proc psh_inline isize static_string_table_find(StaticStringTable<KEY_COUNT> const* table, String str) psh_no_except {
+        using Table = StaticStringTable<KEY_COUNT>;
+
+        u64 hash = impl::static_string_hash(str);
+        u32 seed = table->seeds[impl::static_string_table_bucket(hash, Table::bucket_count)];
+        u32 key  = table->slots[impl::static_string_table_slot(hash, seed, Table::slot_count)];
+        if ((key == STATIC_STRING_TABLE_EMPTY_SLOT) || !string_equal(table->keys[key], str)) {
+            return -1;
+        }
+        return static_cast<isize>(key);
+    }
+
     // -------------------------------------------------------------------------------------------------
     // String formatting.
     //
@@ -212,4 +517,199 @@ namespace psh {
     /// Convert an arg list into a buffer. This function always returns a zero-terminated string
     /// (unlike regular snprintf).
     psh_proc psh_attribute_fmt(3) i32 string_format(char* buf, i32 count, cstring fmt, ...) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Number formatting.
+    //
+    // Fast alternatives to string_format for the formatting of a single number. The output isn't
+    // zero-terminated.
+    // -------------------------------------------------------------------------------------------------
+
+    /// Maximum number of characters written when formatting a 64-bit integer.
+    psh_global constexpr usize FORMAT_INTEGER_MAX_LENGTH = 20;
+
+    /// Maximum number of fractional digits supported by format_f64.
+    psh_global constexpr u32 FORMAT_FLOAT_MAX_PRECISION = 15;
+
+    /// Maximum number of characters written when formatting a floating point number.
+    psh_global constexpr usize FORMAT_FLOAT_MAX_LENGTH = 2 + 308 + 1 + FORMAT_FLOAT_MAX_PRECISION;
+
+    /// Write the decimal representation of an integer.
+    ///
+    /// Parameters:
+    ///     * buf: Buffer with space for at least FORMAT_INTEGER_MAX_LENGTH characters.
+    ///
+    /// Return: The number of characters written.
+    psh_proc usize format_u64(char* buf, u64 value) psh_no_except;
+    psh_proc usize format_i64(char* buf, i64 value) psh_no_except;
+
+    /// Write the fixed-point decimal representation of a floating point number, as done by "%.*f".
+    ///
+    /// Values whose scaled magnitude is below 2^53, and thus exactly representable, are formatted
+    /// without going through string_format. The scaling itself is rounded, so the last digit may
+    /// differ by one from string_format, which also rounds ties to even instead of away from zero.
+    ///
+    /// Parameters:
+    ///     * buf: Buffer with space for at least FORMAT_FLOAT_MAX_LENGTH characters.
+    ///     * precision: Number of fractional digits, at most FORMAT_FLOAT_MAX_PRECISION.
+    ///
+    /// Return: The number of characters written.
+    psh_proc usize format_f64(char* buf, f64 value, u32 precision = 6) psh_no_except;
+
+    /// Maximum number of characters written by format_f64_shortest.
+    psh_global constexpr usize FORMAT_FLOAT_SHORTEST_MAX_LENGTH = 25;
+
+    /// Write the shortest decimal representation of a floating point number that parses back to the
+    /// exact same value.
+    ///
+    /// Magnitudes in the range [1e-6, 1e21) are written in fixed-point notation, such as "0.001" or
+    /// "1250", and all others in scientific notation, such as "1.5e-7" or "1e21". Infinities and
+    /// NaNs are written as "inf", "-inf" and "nan".
+    ///
+    /// Parameters:
+    ///     * buf: Buffer with space for at least FORMAT_FLOAT_SHORTEST_MAX_LENGTH characters.
+    ///
+    /// Return: The number of characters written.
+    psh_proc usize format_f64_shortest(char* buf, f64 value) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Number parsing.
+    //
+    // The whole string has to be the number, without surrounding whitespace, so that tokens obtained
+    // via string_split_next can be parsed directly. The output value is left untouched when parsing
+    // fails.
+    // -------------------------------------------------------------------------------------------------
+
+    /// Parse a decimal integer with an optional leading sign, where unsigned integers only accept a
+    /// plus sign.
+    ///
+    /// Return: STATUS_FAILED if the string isn't an integer or if its value doesn't fit the type.
+    psh_proc Status string_to_u64(String str, u64* value) psh_no_except;
+    psh_proc Status string_to_i64(String str, i64* value) psh_no_except;
+
+    /// Parse a decimal floating point number, rounding to the nearest representable value.
+    ///
+    /// Accepts an optional sign, digits with an optional decimal point and an optional exponent, as
+    /// in "1", "-0.25", ".5e-3" or "6.02E23", as well as "inf", "infinity" and "nan" in any case.
+    /// Values out of range become infinities or zeros.
+    ///
+    /// Note: The rare inputs whose rounding can't be decided with 128-bit products are handed over
+    ///       to strtod, which assumes the "C" locale.
+    ///
+    /// Return: STATUS_FAILED if the string isn't a floating point number.
+    psh_proc Status string_to_f64(String str, f64* value) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // UTF-8 encoding.
+    //
+    // Validation follows the well-formed byte sequences of the Unicode standard, rejecting overlong
+    // encodings, surrogates and code points past U+10FFFF. Whenever AVX2 or AArch64 NEON are
+    // available, the validator checks whole blocks of bytes at a time via lookup tables.
+    // -------------------------------------------------------------------------------------------------
+
+    psh_global constexpr u32   UTF8_REPLACEMENT_CODEPOINT = 0xFFFD;
+    psh_global constexpr usize UTF8_MAX_ENCODED_LENGTH    = 4;
+
+    /// Check if all characters of a string are ASCII.
+    psh_proc bool utf8_is_ascii(String str) psh_no_except;
+
+    /// Check if a string is a well-formed UTF-8 sequence.
+    psh_proc bool utf8_is_valid(String str) psh_no_except;
+
+    /// Count the code points of a string.
+    ///
+    /// Note: The string is assumed to be valid UTF-8, otherwise the result is only an estimate.
+    psh_proc usize utf8_codepoint_count(String str) psh_no_except;
+
+    /// Decode the code point at the start of a string and advance the string past it.
+    ///
+    /// Ill-formed sequences decode as UTF8_REPLACEMENT_CODEPOINT, skipping a single byte, so that
+    /// decoding always makes progress.
+    ///
+    /// Return: Whether a code point was decoded, false once the string is empty.
+    psh_proc bool utf8_decode_next(String* remaining, u32* codepoint) psh_no_except;
+
+    /// Encode a code point, replacing surrogates and values past U+10FFFF by
+    /// UTF8_REPLACEMENT_CODEPOINT.
+    ///
+    /// Parameters:
+    ///     * buf: Buffer with space for at least UTF8_MAX_ENCODED_LENGTH characters.
+    ///
+    /// Return: The number of characters written.
+    psh_proc usize utf8_encode(char* buf, u32 codepoint) psh_no_except;
+
+    /// Transcode a UTF-8 string into a zero-terminated UTF-16 string, as expected by the wide
+    /// character APIs of Windows.
+    ///
+    /// Return: The code units, not counting the zero terminator. The buffer is null if the string
+    ///         isn't valid UTF-8 or if the arena runs out of memory.
+    psh_proc Array<u16> utf8_to_utf16(Arena* arena, String str) psh_no_except;
+
+    /// Transcode a UTF-16 string into a zero-terminated UTF-8 string.
+    ///
+    /// Return: The resulting string, whose buffer is null if the input has unpaired surrogates or if
+    ///         the arena runs out of memory.
+    psh_proc String utf16_to_utf8(Arena* arena, FatPtr<u16 const> str) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // String builder.
+    //
+    // The builder appends its contents to a single buffer allocated from an arena. While the buffer
+    // is the last block of the arena, growing it only bumps the offset of the arena, never copying
+    // the string built so far. The buffer always has room for a zero terminator.
+    //
+    // Usage example:
+    //
+    //     StringBuilder builder = make_string_builder(&arena);
+    //     string_builder_append(&builder, make_string("id: "));
+    //     string_builder_append_u64(&builder, id);
+    //     string_builder_append_fmt(&builder, ", name: %s", name);
+    //     String result = string_builder_to_string(&builder);
+    // -------------------------------------------------------------------------------------------------
+
+    psh_global constexpr usize STRING_BUILDER_DEFAULT_CAPACITY = 64;
+
+    struct StringBuilder {
+        char*  buf;
+        Arena* arena;
+        usize  count    = 0;
+        usize  capacity = 0;
+    };
+
+    psh_proc StringBuilder make_string_builder(Arena* arena, usize initial_capacity = STRING_BUILDER_DEFAULT_CAPACITY) psh_no_except;
+
+    /// Ensure that the builder can receive a given number of characters without growing.
+    psh_proc Status string_builder_reserve(StringBuilder* builder, usize additional_count) psh_no_except;
+
+    psh_proc Status string_builder_append(StringBuilder* builder, String str) psh_no_except;
+    psh_proc Status string_builder_append_char(StringBuilder* builder, char c) psh_no_except;
+    psh_proc Status string_builder_append_u64(StringBuilder* builder, u64 value) psh_no_except;
+    psh_proc Status string_builder_append_i64(StringBuilder* builder, i64 value) psh_no_except;
+    psh_proc Status string_builder_append_f64(StringBuilder* builder, f64 value, u32 precision = 6) psh_no_except;
+    psh_proc Status string_builder_append_f64_shortest(StringBuilder* builder, f64 value) psh_no_except;
+
+    /// Append formatted output, which is written in chunks directly to the buffer of the builder.
+    psh_proc Status string_builder_append_fmt_list(StringBuilder* builder, cstring fmt, va_list va) psh_no_except;
+    psh_proc psh_attribute_fmt(2) Status string_builder_append_fmt(StringBuilder* builder, cstring fmt, ...) psh_no_except;
+
+    /// Append a collection of strings with a separator in between them, growing the builder at most
+    /// once.
+    psh_proc Status string_builder_join(StringBuilder* builder, FatPtr<String const> strings, String separator = {}) psh_no_except;
+
+    /// Get a zero-terminated view of the contents of the builder.
+    ///
+    /// The view is invalidated by any further append to the builder.
+    psh_proc psh_inline String string_builder_to_string(StringBuilder const* builder) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(builder));
+        if (builder->capacity == 0) {
+            return String{"", 0};
+        }
+        builder->buf[builder->count] = 0;
+        return String{builder->buf, builder->count};
+    }
+
+    psh_proc psh_inline void string_builder_clear(StringBuilder* builder) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(builder));
+        builder->count = 0;
+    }
 }  // namespace psh
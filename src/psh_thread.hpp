@@ -0,0 +1,478 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Threading primitives and a work-stealing job system.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#pragma once
+
+#include "psh_atomic.hpp"
+#include "psh_core.hpp"
+#include "psh_memory.hpp"
+#include "psh_platform.hpp"
+
+#if PSH_OS_UNIX
+#    include <pthread.h>
+#endif
+
+namespace psh {
+    // -------------------------------------------------------------------------------------------------
+    // Threads.
+    // -------------------------------------------------------------------------------------------------
+
+    using ThreadProc = void(void* arg);
+
+    /// Handle to an OS thread.
+    ///
+    /// The thread structure is referenced by the running thread, so it has to outlive the thread
+    /// until it is joined.
+    struct Thread {
+#if PSH_OS_WINDOWS
+        void* handle = nullptr;
+#elif PSH_OS_UNIX
+        pthread_t handle;
+#endif
+        ThreadProc* proc = nullptr;
+        void*       arg  = nullptr;
+    };
+
+    /// Create a thread running a given procedure.
+    ///
+    /// Parameters:
+    ///     * thread: Thread structure to be initialised, it should outlive the thread.
+    ///     * proc: Procedure to be executed by the thread.
+    ///     * arg: Argument passed to the procedure.
+    psh_proc Status thread_create(Thread* thread, ThreadProc* proc, void* arg) psh_no_except;
+
+    /// Wait for a thread to be finished, releasing its resources.
+    psh_proc void thread_join(Thread* thread) psh_no_except;
+
+    /// Yield the remaining time slice of the current thread.
+    psh_proc void thread_yield() psh_no_except;
+
+    /// Get the number of hardware threads available to the process.
+    psh_proc u32 thread_hardware_count() psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Synchronisation primitives.
+    //
+    // On Windows, these are slim reader/writer locks and condition variables, which are pointer
+    // sized and require no destruction.
+    // -------------------------------------------------------------------------------------------------
+
+    struct Mutex {
+#if PSH_OS_WINDOWS
+        void* handle = nullptr;
+#elif PSH_OS_UNIX
+        pthread_mutex_t handle;
+#endif
+    };
+
+    psh_proc void init_mutex(Mutex* mutex) psh_no_except;
+    psh_proc void destroy_mutex(Mutex* mutex) psh_no_except;
+    psh_proc void mutex_lock(Mutex* mutex) psh_no_except;
+    psh_proc void mutex_unlock(Mutex* mutex) psh_no_except;
+
+    /// Try to lock the mutex without blocking.
+    ///
+    /// Return: Whether the mutex was acquired.
+    psh_proc bool mutex_try_lock(Mutex* mutex) psh_no_except;
+
+    struct ConditionVariable {
+#if PSH_OS_WINDOWS
+        void* handle = nullptr;
+#elif PSH_OS_UNIX
+        pthread_cond_t handle;
+#endif
+    };
+
+    psh_proc void init_condition_variable(ConditionVariable* cv) psh_no_except;
+    psh_proc void destroy_condition_variable(ConditionVariable* cv) psh_no_except;
+
+    /// Atomically unlock the mutex and wait for the condition variable to be signaled, locking the
+    /// mutex again before returning.
+    ///
+    /// Note: Spurious wake-ups may happen, the condition should always be checked in a loop.
+    psh_proc void condition_variable_wait(ConditionVariable* cv, Mutex* mutex) psh_no_except;
+
+    /// Wake up a single thread waiting on the condition variable.
+    psh_proc void condition_variable_signal(ConditionVariable* cv) psh_no_except;
+
+    /// Wake up all threads waiting on the condition variable.
+    psh_proc void condition_variable_broadcast(ConditionVariable* cv) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Bounded lock-free queues.
+    //
+    // Both queues have a fixed power of two capacity and store their elements by copy, so the
+    // element type should be trivially copyable. The indices written by distinct threads are kept
+    // in distinct cache lines.
+    // -------------------------------------------------------------------------------------------------
+
+    /// Wait-free single-producer single-consumer ring buffer.
+    ///
+    /// Each side keeps a cached copy of the index owned by the other side, only reloading it once
+    /// the queue seems to be full (or empty), which avoids bouncing the cache line of the other side
+    /// on each operation.
+    template <typename T>
+    struct SpscQueue {
+        T*  buf;
+        u64 mask = 0;
+
+        /// Index of the next element to be popped, written by the consumer.
+        alignas(CACHE_LINE_SIZE) Atomic<u64> head = {};
+        u64 cached_tail                           = 0;
+
+        /// Index of the next element to be pushed, written by the producer.
+        alignas(CACHE_LINE_SIZE) Atomic<u64> tail = {};
+        u64 cached_head                           = 0;
+    };
+
+    /// Initialise a queue on top of an existing storage, whose count should be a power of two.
+    template <typename T>
+    psh_proc psh_inline void init_spsc_queue(SpscQueue<T>* queue, FatPtr<T> storage) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(queue));
+        psh_validate_usage(psh_assert_fmt(psh_is_pow_of_two(storage.count), "Queue capacity (%zu) should be a power of two.", storage.count));
+
+        queue->buf         = storage.buf;
+        queue->mask        = static_cast<u64>(storage.count) - 1u;
+        queue->cached_tail = 0;
+        queue->cached_head = 0;
+        atomic_store(&queue->head, u64{0}, MemoryOrder::RELAXED);
+        atomic_store(&queue->tail, u64{0}, MemoryOrder::RELAXED);
+    }
+    template <typename T>
+    psh_proc psh_inline void init_spsc_queue(SpscQueue<T>* queue, Array<T> storage) psh_no_except {
+        init_spsc_queue(queue, FatPtr<T>{storage.buf, storage.count});
+    }
+    template <typename T, usize count>
+    psh_proc psh_inline void init_spsc_queue(SpscQueue<T>* queue, Buffer<T, count>* storage) psh_no_except {
+        init_spsc_queue(queue, FatPtr<T>{storage->buf, count});
+    }
+
+    /// Initialise a queue whose storage is allocated by an arena.
+    template <typename T>
+    psh_proc psh_inline Status init_spsc_queue(SpscQueue<T>* queue, Arena* arena, usize capacity) psh_no_except {
+        T* buf = memory_alloc_uninit<T>(arena, capacity);
+        if (psh_unlikely(buf == nullptr)) {
+            return STATUS_FAILED;
+        }
+        init_spsc_queue(queue, FatPtr<T>{buf, capacity});
+        return STATUS_OK;
+    }
+
+    /// Push an element to the queue, should only be called by the producer.
+    ///
+    /// Return: Whether the element was pushed, which fails if the queue is full.
+    template <typename T>
+    psh_proc psh_inline bool spsc_queue_push(SpscQueue<T>* queue, T const& value) psh_no_except {
+        u64 tail = atomic_load(&queue->tail, MemoryOrder::RELAXED);
+        if (psh_unlikely(tail - queue->cached_head > queue->mask)) {
+            queue->cached_head = atomic_load(&queue->head, MemoryOrder::ACQUIRE);
+            if (tail - queue->cached_head > queue->mask) {
+                return false;
+            }
+        }
+
+        queue->buf[tail & queue->mask] = value;
+        atomic_store(&queue->tail, tail + 1u, MemoryOrder::RELEASE);
+        return true;
+    }
+
+    /// Pop the oldest element of the queue, should only be called by the consumer.
+    ///
+    /// Return: Whether an element was popped, which fails if the queue is empty.
+    template <typename T>
+    psh_proc psh_inline bool spsc_queue_pop(SpscQueue<T>* queue, T* value) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(value));
+
+        u64 head = atomic_load(&queue->head, MemoryOrder::RELAXED);
+        if (psh_unlikely(head == queue->cached_tail)) {
+            queue->cached_tail = atomic_load(&queue->tail, MemoryOrder::ACQUIRE);
+            if (head == queue->cached_tail) {
+                return false;
+            }
+        }
+
+        *value = queue->buf[head & queue->mask];
+        atomic_store(&queue->head, head + 1u, MemoryOrder::RELEASE);
+        return true;
+    }
+
+    /// Number of elements in the queue, which may already be outdated if the other side is active.
+    template <typename T>
+    psh_proc psh_inline usize spsc_queue_count(SpscQueue<T> const* queue) psh_no_except {
+        u64 head = atomic_load(&queue->head, MemoryOrder::ACQUIRE);
+        u64 tail = atomic_load(&queue->tail, MemoryOrder::ACQUIRE);
+        return static_cast<usize>(tail - head);
+    }
+
+    /// Slot of a multi-producer multi-consumer queue.
+    ///
+    /// The sequence tells the state of the cell: it is equal to the position of the element to be
+    /// pushed when the cell is free, and one past that position once the element is published.
+    template <typename T>
+    struct MpmcQueueCell {
+        Atomic<u64> sequence;
+        T           value;
+    };
+
+    /// Bounded multi-producer multi-consumer ring buffer, following the design of Dmitry Vyukov.
+    ///
+    /// Producers and consumers claim positions by a compare-and-swap on their own index, and hand
+    /// off each element through the sequence number of its cell. The queue is lock-free but not
+    /// wait-free: a thread preempted between claiming a position and publishing its cell holds back
+    /// the threads waiting for that same cell.
+    template <typename T>
+    struct MpmcQueue {
+        MpmcQueueCell<T>* cells;
+        u64               mask = 0;
+
+        alignas(CACHE_LINE_SIZE) Atomic<u64> enqueue_position = {};
+        alignas(CACHE_LINE_SIZE) Atomic<u64> dequeue_position = {};
+    };
+
+    /// Initialise a queue on top of an existing storage, whose count should be a power of two.
+    template <typename T>
+    psh_proc psh_inline void init_mpmc_queue(MpmcQueue<T>* queue, FatPtr<MpmcQueueCell<T>> storage) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(queue));
+        psh_validate_usage(psh_assert_fmt(psh_is_pow_of_two(storage.count), "Queue capacity (%zu) should be a power of two.", storage.count));
+
+        for (usize idx = 0; idx < storage.count; ++idx) {
+            atomic_store(&storage.buf[idx].sequence, static_cast<u64>(idx), MemoryOrder::RELAXED);
+        }
+
+        queue->cells = storage.buf;
+        queue->mask  = static_cast<u64>(storage.count) - 1u;
+        atomic_store(&queue->enqueue_position, u64{0}, MemoryOrder::RELAXED);
+        atomic_store(&queue->dequeue_position, u64{0}, MemoryOrder::RELEASE);
+    }
+    template <typename T>
+    psh_proc psh_inline void init_mpmc_queue(MpmcQueue<T>* queue, Array<MpmcQueueCell<T>> storage) psh_no_except {
+        init_mpmc_queue(queue, FatPtr<MpmcQueueCell<T>>{storage.buf, storage.count});
+    }
+    template <typename T, usize count>
+    psh_proc psh_inline void init_mpmc_queue(MpmcQueue<T>* queue, Buffer<MpmcQueueCell<T>, count>* storage) psh_no_except {
+        init_mpmc_queue(queue, FatPtr<MpmcQueueCell<T>>{storage->buf, count});
+    }
+
+    /// Initialise a queue whose storage is allocated by an arena.
+    template <typename T>
+    psh_proc psh_inline Status init_mpmc_queue(MpmcQueue<T>* queue, Arena* arena, usize capacity) psh_no_except {
+        MpmcQueueCell<T>* cells = memory_alloc_uninit<MpmcQueueCell<T>>(arena, capacity);
+        if (psh_unlikely(cells == nullptr)) {
+            return STATUS_FAILED;
+        }
+        init_mpmc_queue(queue, FatPtr<MpmcQueueCell<T>>{cells, capacity});
+        return STATUS_OK;
+    }
+
+    /// Push an element to the queue.
+    ///
+    /// Return: Whether the element was pushed, which fails if the queue is full.
+    template <typename T>
+    psh_proc psh_inline bool mpmc_queue_push(MpmcQueue<T>* queue, T const& value) psh_no_except {
+        MpmcQueueCell<T>* cell;
+        u64               position = atomic_load(&queue->enqueue_position, MemoryOrder::RELAXED);
+        for (;;) {
+            cell         = &queue->cells[position & queue->mask];
+            u64 sequence = atomic_load(&cell->sequence, MemoryOrder::ACQUIRE);
+            i64 diff     = static_cast<i64>(sequence - position);
+
+            if (diff == 0) {
+                if (atomic_compare_exchange(&queue->enqueue_position, &position, position + 1u, MemoryOrder::RELAXED)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = atomic_load(&queue->enqueue_position, MemoryOrder::RELAXED);
+            }
+        }
+
+        cell->value = value;
+        atomic_store(&cell->sequence, position + 1u, MemoryOrder::RELEASE);
+        return true;
+    }
+
+    /// Pop the oldest element of the queue.
+    ///
+    /// Return: Whether an element was popped, which fails if the queue is empty.
+    template <typename T>
+    psh_proc psh_inline bool mpmc_queue_pop(MpmcQueue<T>* queue, T* value) psh_no_except {
+        psh_paranoid_validate_usage(psh_assert_not_null(value));
+
+        MpmcQueueCell<T>* cell;
+        u64               position = atomic_load(&queue->dequeue_position, MemoryOrder::RELAXED);
+        for (;;) {
+            cell         = &queue->cells[position & queue->mask];
+            u64 sequence = atomic_load(&cell->sequence, MemoryOrder::ACQUIRE);
+            i64 diff     = static_cast<i64>(sequence - (position + 1u));
+
+            if (diff == 0) {
+                if (atomic_compare_exchange(&queue->dequeue_position, &position, position + 1u, MemoryOrder::RELAXED)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = atomic_load(&queue->dequeue_position, MemoryOrder::RELAXED);
+            }
+        }
+
+        *value = cell->value;
+        atomic_store(&cell->sequence, position + queue->mask + 1u, MemoryOrder::RELEASE);
+        return true;
+    }
+
+    // -------------------------------------------------------------------------------------------------
+    // Job system.
+    //
+    // Each worker owns a Chase-Lev work-stealing deque: the worker pushes and pops jobs at the bottom
+    // of its own deque, while idle workers steal jobs from the top of the deques of other workers.
+    // This keeps the common path, a worker running the jobs it spawned, free of contention.
+    //
+    // The thread that initialises the job system is the worker of index zero. Jobs should only be
+    // submitted by this thread or by jobs themselves.
+    //
+    // Usage example:
+    //
+    //     JobSystem js;
+    //     init_job_system(&js, &arena);
+    //
+    //     JobCounter counter = {};
+    //     for (usize idx = 0; idx < count; ++idx) {
+    //         job_system_submit(&js, process_item, &items[idx], &counter);
+    //     }
+    //     job_system_wait(&js, &counter);
+    //
+    //     destroy_job_system(&js);
+    // -------------------------------------------------------------------------------------------------
+
+    /// Procedure executed by a job.
+    ///
+    /// Parameters:
+    ///     * data: User data associated with the job.
+    ///     * scratch: Scratch arena of the worker running the job. All allocations made by the job
+    ///                are discarded once the job finishes.
+    using JobProc = void(void* data, Arena* scratch);
+
+    /// Counter of the jobs pending completion.
+    ///
+    /// The counter should outlive the jobs associated with it.
+    struct JobCounter {
+        Atomic<u32> pending = {};
+    };
+
+    psh_global constexpr u32   JOB_DEQUE_DEFAULT_CAPACITY        = 4096;
+    psh_global constexpr usize JOB_WORKER_DEFAULT_SCRATCH_SIZE   = psh_kibibytes(256);
+    psh_global constexpr u32   JOB_SYSTEM_MAX_STEAL_ATTEMPTS     = 4;
+    psh_global constexpr u32   JOB_SYSTEM_SPIN_COUNT_BEFORE_IDLE = 64;
+
+    namespace impl {
+        /// Slot of a job deque.
+        ///
+        /// The fields are atomics since the slot may be read by a thief while the owner reuses it.
+        /// The read is then discarded by the thief, which fails to claim the slot.
+        struct JobSlot {
+            Atomic<JobProc*>    proc;
+            Atomic<void*>       data;
+            Atomic<JobCounter*> counter;
+        };
+
+        struct Job {
+            JobProc*    proc;
+            void*       data;
+            JobCounter* counter;
+        };
+
+        /// Bounded Chase-Lev deque.
+        struct JobDeque {
+            JobSlot*    slots;
+            i64         mask;
+            Atomic<i64> top    = {};
+            Atomic<i64> bottom = {};
+        };
+    }  // namespace impl
+
+    struct JobSystem;
+
+    struct JobWorker {
+        impl::JobDeque deque;
+        Arena          scratch;
+        JobSystem*     system;
+        Thread         thread;
+        u32            index;
+        u32            rng_state;
+    };
+
+    struct JobSystem {
+        JobWorker*        workers;
+        u32               worker_count = 0;
+        Atomic<u32>       running      = {};
+        Atomic<u32>       queued_count = {};
+        Atomic<u32>       idle_count   = {};
+        Mutex             idle_mutex;
+        ConditionVariable idle_cv;
+    };
+
+    /// Initialise the job system and spawn its worker threads.
+    ///
+    /// Parameters:
+    ///     * job_system: Job system to be initialised.
+    ///     * arena: Arena providing the memory of the workers, their deques and scratch arenas. It
+    ///              should outlive the job system.
+    ///     * worker_count: Number of workers, including the calling thread. If zero, one worker is
+    ///                     created for each hardware thread.
+    ///     * scratch_size: Size of the scratch arena of each worker.
+    ///     * deque_capacity: Maximum number of jobs queued per worker, should be a power of two.
+    psh_proc Status init_job_system(
+        JobSystem* job_system,
+        Arena*     arena,
+        u32        worker_count   = 0,
+        usize      scratch_size   = JOB_WORKER_DEFAULT_SCRATCH_SIZE,
+        u32        deque_capacity = JOB_DEQUE_DEFAULT_CAPACITY) psh_no_except;
+
+    /// Wait for all workers to finish their current jobs and join their threads.
+    ///
+    /// Jobs still queued are not executed, the user should wait for their jobs before destroying
+    /// the job system.
+    psh_proc void destroy_job_system(JobSystem* job_system) psh_no_except;
+
+    /// Queue a job to be run by the job system.
+    ///
+    /// If the deque of the current worker is full, the job is executed immediately by the caller.
+    ///
+    /// Parameters:
+    ///     * proc: Procedure to be run.
+    ///     * data: Data passed to the procedure, it should be kept alive until the job is completed.
+    ///     * counter: Optional counter to be decremented when the job completes.
+    psh_proc void job_system_submit(JobSystem* job_system, JobProc* proc, void* data, JobCounter* counter) psh_no_except;
+
+    /// Wait for the completion of all jobs of a counter.
+    ///
+    /// The waiting thread runs queued jobs, stealing from other workers if needed, while the counter
+    /// isn't zero.
+    psh_proc void job_system_wait(JobSystem* job_system, JobCounter* counter) psh_no_except;
+
+    /// Get the worker of the calling thread, or null if the thread isn't a worker of the job system.
+    psh_proc JobWorker* job_system_current_worker(JobSystem* job_system) psh_no_except;
+}  // namespace psh
@@ -25,10 +25,61 @@
 #pragma once
 
 #include "psh_core.hpp"
+#include "psh_platform.hpp"
+
+#if PSH_COMPILER_MSVC && !PSH_COMPILER_CLANG
+#    include <intrin.h>
+#endif
 
 namespace psh {
     psh_proc f64 current_time_in_seconds() psh_no_except;
 
+    /// Read the monotonic clock of the operating system, in ticks of os_timer_frequency.
+    ///
+    /// This is backed by QueryPerformanceCounter on Windows and clock_gettime on Unix, where the
+    /// ticks are nanoseconds.
+    psh_proc u64 os_timer_ticks() psh_no_except;
+
+    /// Number of ticks per second of the operating system monotonic clock.
+    psh_proc u64 os_timer_frequency() psh_no_except;
+
+    /// Read the timestamp counter of the processor.
+    ///
+    /// The counter ticks at a constant rate on modern x64 processors, regardless of the current
+    /// clock frequency, and is only meaningful for differences between readings on the same core.
+    /// On ARM the virtual counter of the generic timer is read instead. Platforms without a
+    /// counter fall back to the monotonic clock, in nanoseconds.
+    psh_proc psh_inline u64 cpu_timestamp_counter() psh_no_except {
+#if PSH_COMPILER_MSVC && !PSH_COMPILER_CLANG && PSH_ARCH_X64
+        return __rdtsc();
+#elif PSH_ARCH_X64
+        return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+        u64 counter;
+        __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(counter));
+        return counter;
+#else
+        return os_timer_ticks();
+#endif
+    }
+
+    /// Number of ticks per second of the timestamp counter.
+    ///
+    /// On x64 the frequency isn't exposed by the processor, so the first call calibrates it against
+    /// the operating system clock, which takes about 10 milliseconds. The result is cached for the
+    /// remaining calls. Platforms without a counter report os_timer_frequency.
+    psh_proc u64 cpu_timestamp_frequency() psh_no_except;
+
+    /// Convert a difference of ticks into seconds, given the tick frequency.
+    psh_proc psh_inline f64 ticks_to_seconds(u64 ticks, u64 frequency) psh_no_except {
+        return static_cast<f64>(ticks) / static_cast<f64>(frequency);
+    }
+
+    /// Convert a difference of ticks into nanoseconds, given the tick frequency.
+    psh_proc psh_inline f64 ticks_to_nanoseconds(u64 ticks, u64 frequency) psh_no_except {
+        return (static_cast<f64>(ticks) * 1e9) / static_cast<f64>(frequency);
+    }
+
     /// Suspend the current thread by a certain number of milliseconds.
     ///
     /// The timeout parameter is just a hint for the OS, there is no guarantee that the thread
@@ -28,9 +28,23 @@
 #include <math.h>
 #include "psh_core.hpp"
 #include "psh_math.hpp"
+#include "psh_memory.hpp"
+#include "psh_platform.hpp"
+
+#if PSH_ARCH_SIMD_AVX
+#    include <immintrin.h>
+#elif PSH_ARCH_SIMD_SSE2
+#    include <emmintrin.h>
+#elif PSH_ARCH_SIMD_NEON
+#    include <arm_neon.h>
+#endif
+
+// The 4-dimensional vectors and matrices fill whole SIMD registers, their operations are written
+// with SSE2/AVX or NEON intrinsics whenever the target supports them, with a scalar fallback
+// otherwise. The 2 and 3-dimensional types are kept scalar, since loading and shuffling their
+// components in and out of registers costs as much as the arithmetic itself.
 
 namespace psh {
-    // @TODO: I should write all of the code below with SIMD support...
 
     // -------------------------------------------------------------------------------------------------
     // Floating point vectors.
@@ -169,7 +183,80 @@ namespace psh {
         f32 z = 0.0f;
         f32 w = 0.0f;
 
-        // @TODO Write associated methods.
+        /// Check if the components of the vector are inside the floating point zero range.
+        psh_inline bool is_zero(f32 zero_range) const psh_no_except {
+            return approx_equal(x, 0.0f, zero_range) && approx_equal(y, 0.0f, zero_range)
+                   && approx_equal(z, 0.0f, zero_range) && approx_equal(w, 0.0f, zero_range);
+        }
+
+        /// Euclidean inner product.
+        psh_inline f32 dot(Vec4 other) const psh_no_except {
+#if PSH_ARCH_SIMD_SSE2
+            __m128 prod = _mm_mul_ps(_mm_loadu_ps(&x), _mm_loadu_ps(&other.x));
+            __m128 sum  = _mm_add_ps(prod, _mm_shuffle_ps(prod, prod, _MM_SHUFFLE(2, 3, 0, 1)));
+            sum         = _mm_add_ss(sum, _mm_movehl_ps(sum, sum));
+            return _mm_cvtss_f32(sum);
+#elif PSH_ARCH_SIMD_NEON
+            float32x4_t prod = vmulq_f32(vld1q_f32(&x), vld1q_f32(&other.x));
+            float32x2_t sum  = vadd_f32(vget_low_f32(prod), vget_high_f32(prod));
+            return vget_lane_f32(vpadd_f32(sum, sum), 0);
+#else
+            return x * other.x + y * other.y + z * other.z + w * other.w;
+#endif
+        }
+
+        /// Get the normalised vector.
+        psh_inline Vec4 normalised() const psh_no_except {
+            f32 len = sqrtf(this->dot(*this));
+
+            if (psh_unlikely(approx_equal(len, 0.0f))) {
+                return Vec4{};
+            }
+
+            Vec4 result;
+#if PSH_ARCH_SIMD_SSE2
+            _mm_storeu_ps(&result.x, _mm_div_ps(_mm_loadu_ps(&x), _mm_set1_ps(len)));
+#elif PSH_ARCH_SIMD_NEON
+            vst1q_f32(&result.x, vmulq_n_f32(vld1q_f32(&x), 1.0f / len));
+#else
+            result = Vec4{x / len, y / len, z / len, w / len};
+#endif
+            return result;
+        }
+
+        psh_inline Vec4& operator+=(Vec4 other) psh_no_except {
+            x += other.x;
+            y += other.y;
+            z += other.z;
+            w += other.w;
+            return *this;
+        }
+        psh_inline Vec4& operator-=(Vec4 other) psh_no_except {
+            x -= other.x;
+            y -= other.y;
+            z -= other.z;
+            w -= other.w;
+            return *this;
+        }
+        psh_inline Vec4& operator*=(Vec4 other) psh_no_except {
+            x *= other.x;
+            y *= other.y;
+            z *= other.z;
+            w *= other.w;
+            return *this;
+        }
+        psh_inline Vec4& operator*=(f32 scalar) psh_no_except {
+            x *= scalar;
+            y *= scalar;
+            z *= scalar;
+            w *= scalar;
+            return *this;
+        }
+        psh_inline Vec4 operator+(Vec4 other) const psh_no_except { return Vec4{x + other.x, y + other.y, z + other.z, w + other.w}; }
+        psh_inline Vec4 operator-(Vec4 other) const psh_no_except { return Vec4{x - other.x, y - other.y, z - other.z, w - other.w}; }
+        psh_inline Vec4 operator*(Vec4 other) const psh_no_except { return Vec4{x * other.x, y * other.y, z * other.z, w * other.w}; }
+        psh_inline Vec4 operator*(f32 scalar) const psh_no_except { return Vec4{x * scalar, y * scalar, z * scalar, w * scalar}; }
+        psh_inline Vec4 operator-() const psh_no_except { return Vec4{-x, -y, -z, -w}; }
     };
 
     // -------------------------------------------------------------------------------------------------
@@ -530,4 +617,89 @@ namespace psh {
 
     /// Multiply a pair of 4D square column-major matrices.
     psh_proc ColMat4 mat_mul(ColMat4 lhs, ColMat4 rhs) psh_no_except;
+
+    /// Left-multiply a batch of 4D vectors by the same 4D square column-major matrix.
+    ///
+    /// Parameters:
+    ///     * out: Receives each of the transformed vectors, may be the same memory as the input.
+    ///     * m: Transformation applied to the vectors.
+    ///     * vectors: Vectors to be transformed, should have the same count as the output.
+    psh_proc void mat_mul(FatPtr<Vec4> out, ColMat4 m, FatPtr<Vec4 const> vectors) psh_no_except;
+
+    /// Multiply the same 4D square column-major matrix by each matrix of a batch, yielding
+    /// mat_mul(lhs, rhs[idx]) for each index.
+    ///
+    /// Parameters:
+    ///     * out: Receives each of the products, may be the same memory as the input.
+    ///     * lhs: Left-hand side of all products.
+    ///     * rhs: Right-hand side of each product, should have the same count as the output.
+    psh_proc void mat_mul(FatPtr<ColMat4> out, ColMat4 lhs, FatPtr<ColMat4 const> rhs) psh_no_except;
+
+    // -------------------------------------------------------------------------------------------------
+    // Structure-of-arrays streams of vectors.
+    //
+    // A stream stores each coordinate of its vectors in a separate array, so that a single SIMD
+    // instruction operates on the same coordinate of 4 (SSE2, NEON) or 8 (AVX) consecutive vectors,
+    // without any lane being wasted on shuffles.
+    //
+    // The batch procedures accept the same stream as both input and output, but streams partially
+    // overlapping each other result in undefined behaviour.
+    //
+    // Usage example:
+    //
+    //     Vec3Stream positions = make_vec3_stream(&arena, entity_count);
+    //     vec3_stream_from_aos(positions, make_const_fat_ptr(&entity_positions));
+    //     batch_mat_mul(positions, model_to_world, positions);
+    // -------------------------------------------------------------------------------------------------
+
+    /// Alignment of the coordinate arrays allocated by make_vec3_stream, fitting a cache line.
+    psh_global constexpr u32 VEC_STREAM_ALIGNMENT = 64;
+
+    /// Stream of 3D vectors in floating-point space.
+    struct Vec3Stream {
+        f32*  x     = nullptr;
+        f32*  y     = nullptr;
+        f32*  z     = nullptr;
+        usize count = 0;
+    };
+
+    /// Allocate a stream of vectors, whose coordinates are left uninitialised.
+    ///
+    /// Return: The stream, which is empty if the allocation fails.
+    psh_proc Vec3Stream make_vec3_stream(Arena* arena, usize count) psh_no_except;
+
+    psh_proc psh_inline Vec3 vec3_stream_get(Vec3Stream stream, usize idx) psh_no_except {
+        psh_assert_bounds_check(idx, stream.count);
+        return Vec3{stream.x[idx], stream.y[idx], stream.z[idx]};
+    }
+
+    psh_proc psh_inline void vec3_stream_set(Vec3Stream stream, usize idx, Vec3 v) psh_no_except {
+        psh_assert_bounds_check(idx, stream.count);
+        stream.x[idx] = v.x;
+        stream.y[idx] = v.y;
+        stream.z[idx] = v.z;
+    }
+
+    /// Scatter an array of vectors into a stream of the same count.
+    psh_proc void vec3_stream_from_aos(Vec3Stream out, FatPtr<Vec3 const> vectors) psh_no_except;
+
+    /// Gather a stream of vectors into an array of the same count.
+    psh_proc void vec3_stream_to_aos(FatPtr<Vec3> out, Vec3Stream stream) psh_no_except;
+
+    /// Left-multiply each vector of a stream, taken in homogeneous coordinates, by a 4D square
+    /// column-major matrix. The fourth coordinate of the result is discarded.
+    ///
+    /// Parameters:
+    ///     * out: Receives the transformed vectors, should have the same count as the input.
+    ///     * m: Transformation applied to the vectors.
+    ///     * vectors: Stream of vectors to be transformed.
+    ///     * w: Fourth coordinate of the vectors, 1 for points and 0 for directions.
+    psh_proc void batch_mat_mul(Vec3Stream out, ColMat4 m, Vec3Stream vectors, f32 w = 1.0f) psh_no_except;
+
+    /// Normalise each vector of a stream. Vectors of zero length become the zero vector, just as
+    /// with Vec3::normalised.
+    psh_proc void batch_normalise(Vec3Stream out, Vec3Stream vectors) psh_no_except;
+
+    /// Compute the Euclidean inner product of each pair of vectors of two streams.
+    psh_proc void batch_dot(FatPtr<f32> out, Vec3Stream lhs, Vec3Stream rhs) psh_no_except;
 }  // namespace psh
@@ -24,6 +24,7 @@
 
 #include <stdlib.h>  // For rand.
 #include <psh_algorithms.hpp>
+#include <psh_defer.hpp>
 #include "utils.hpp"
 
 namespace psh::test::algorithms {
@@ -115,6 +116,278 @@ namespace psh::test::algorithms {
         report_test_successful();
     }
 
+    struct KeyedValue {
+        i32 key;
+        u32 order;
+
+        bool operator<(KeyedValue const& other) const {
+            return this->key < other.key;
+        }
+        bool operator>(KeyedValue const& other) const {
+            return this->key > other.key;
+        }
+    };
+
+    psh_internal void merge_sort() {
+        Arena arena = make_owned_arena(psh_kibibytes(64));
+        psh_defer(destroy_owned_arena(&arena));
+
+        // Random, with many runs to be merged.
+        {
+            Array<i32> arr = make_array<i32>(&arena, 1000);
+            for (u32 iter = 0; iter < 10u; ++iter) {
+                for (i32& v : arr) {
+                    v = rand() % 500;
+                }
+                psh_assert(psh::merge_sort(&arena, make_fat_ptr(&arr)));
+                psh_assert(test_sort(make_fat_ptr(&arr)));
+            }
+        }
+
+        // Equivalent elements keep their relative order.
+        {
+            Array<KeyedValue> arr = make_array<KeyedValue>(&arena, 300);
+            for (u32 idx = 0; idx < arr.count; ++idx) {
+                arr[idx] = KeyedValue{.key = static_cast<i32>((idx * 7u) % 10u), .order = idx};
+            }
+            psh_assert(psh::merge_sort(&arena, make_fat_ptr(&arr)));
+            for (u32 idx = 0; idx + 1u < arr.count; ++idx) {
+                psh_assert(arr[idx].key <= arr[idx + 1u].key);
+                if (arr[idx].key == arr[idx + 1u].key) {
+                    psh_assert(arr[idx].order < arr[idx + 1u].order);
+                }
+            }
+        }
+
+        report_test_successful();
+    }
+
+    psh_internal bool keyed_value_by_order(KeyedValue lhs, KeyedValue rhs) {
+        return (lhs.order < rhs.order);
+    }
+
+    psh_internal bool keyed_value_descending(KeyedValue lhs, KeyedValue rhs) {
+        return (lhs.key > rhs.key);
+    }
+
+    psh_internal void adaptive_merge_sort() {
+        Arena arena = make_owned_arena(psh_kibibytes(256));
+        psh_defer(destroy_owned_arena(&arena));
+
+        Array<i32>  arr  = make_array<i32>(&arena, 5000);
+        FatPtr<i32> fptr = make_fat_ptr(&arr);
+
+        // Sorted, reverse sorted, organ pipe and concatenated sorted runs.
+        for (u32 idx = 0; idx < arr.count; ++idx) {
+            arr[idx] = static_cast<i32>(idx);
+        }
+        psh_assert(psh::merge_sort(&arena, fptr));
+        psh_assert(test_sort(fptr));
+
+        for (u32 idx = 0; idx < arr.count; ++idx) {
+            arr[idx] = -static_cast<i32>(idx);
+        }
+        psh_assert(psh::merge_sort(&arena, fptr));
+        psh_assert(test_sort(fptr));
+
+        for (u32 idx = 0; idx < arr.count; ++idx) {
+            arr[idx] = static_cast<i32>((idx < arr.count / 2) ? idx : arr.count - idx);
+        }
+        psh_assert(psh::merge_sort(&arena, fptr));
+        psh_assert(test_sort(fptr));
+
+        for (u32 idx = 0; idx < arr.count; ++idx) {
+            arr[idx] = static_cast<i32>((idx * 37u) % 1000u) + static_cast<i32>(idx % 7u);
+        }
+        psh_assert(psh::merge_sort(&arena, fptr));
+        psh_assert(test_sort(fptr));
+
+        // Random runs of random lengths, with a few equal elements.
+        for (u32 iter = 0; iter < 20u; ++iter) {
+            for (u32 idx = 0; idx < arr.count;) {
+                u32 run_count = static_cast<u32>(rand() % 300) + 1u;
+                run_count     = psh_min_value(run_count, static_cast<u32>(arr.count) - idx);
+                i32 value     = rand() % 100;
+                for (u32 run_idx = 0; run_idx < run_count; ++run_idx) {
+                    value += rand() % 3;
+                    arr[idx + run_idx] = (iter % 2 == 0) ? value : -value;
+                }
+                idx += run_count;
+            }
+            psh_assert(psh::merge_sort(&arena, fptr));
+            psh_assert(test_sort(fptr));
+        }
+
+        // Multi-key ordering: sorting by the secondary key then stably by the primary key.
+        Array<KeyedValue> values = make_array<KeyedValue>(&arena, 2000);
+        for (u32 idx = 0; idx < values.count; ++idx) {
+            values[idx] = KeyedValue{.key = rand() % 16, .order = static_cast<u32>(rand() % 100)};
+        }
+        psh_assert(psh::merge_sort(&arena, make_fat_ptr(&values), keyed_value_by_order));
+        psh_assert(psh::merge_sort(&arena, make_fat_ptr(&values), keyed_value_descending));
+        for (u32 idx = 0; idx + 1u < values.count; ++idx) {
+            psh_assert(values[idx].key >= values[idx + 1u].key);
+            if (values[idx].key == values[idx + 1u].key) {
+                psh_assert(values[idx].order <= values[idx + 1u].order);
+            }
+        }
+
+        report_test_successful();
+    }
+
+    psh_internal bool descending_i32(i32 lhs, i32 rhs) {
+        return (lhs > rhs);
+    }
+
+    psh_internal void nth_element_and_partial_sort() {
+        Arena arena = make_owned_arena(psh_kibibytes(256));
+        psh_defer(destroy_owned_arena(&arena));
+
+        Array<i32>  arr    = make_array<i32>(&arena, 10000);
+        Array<i32>  sorted = make_array<i32>(&arena, arr.count);
+        FatPtr<i32> fptr   = make_fat_ptr(&arr);
+
+        for (u32 iter = 0; iter < 8u; ++iter) {
+            for (u32 idx = 0; idx < arr.count; ++idx) {
+                arr[idx]    = (iter % 2 == 0) ? rand() % 50000 : rand() % 10;
+                sorted[idx] = arr[idx];
+            }
+            psh::quick_sort(make_fat_ptr(&sorted));
+
+            usize nth = static_cast<usize>(rand()) % arr.count;
+            psh::nth_element(fptr, nth);
+            psh_assert(arr[nth] == sorted[nth]);
+            for (usize idx = 0; idx < arr.count; ++idx) {
+                psh_assert((idx < nth) ? (arr[idx] <= arr[nth]) : (arr[nth] <= arr[idx]));
+            }
+
+            // Both the heap selection and the quick selection.
+            Buffer<usize, 4> sorted_counts = {1, 100, 5000, arr.count};
+            for (usize sorted_count : sorted_counts) {
+                psh::partial_sort(fptr, sorted_count);
+                for (usize idx = 0; idx < sorted_count; ++idx) {
+                    psh_assert(arr[idx] == sorted[idx]);
+                }
+                for (u32 idx = 0; idx < arr.count; ++idx) {
+                    arr[idx] = sorted[(idx * 7919u) % arr.count];
+                }
+            }
+        }
+
+        // Top-k with a custom order, as well as edge cases.
+        for (u32 idx = 0; idx < arr.count; ++idx) {
+            arr[idx] = static_cast<i32>(idx);
+        }
+        psh::partial_sort(fptr, 3, descending_i32);
+        psh_assert((arr[0] == 9999) && (arr[1] == 9998) && (arr[2] == 9997));
+
+        psh::nth_element(fptr, 0, descending_i32);
+        psh_assert(arr[0] == 9999);
+
+        psh::partial_sort(fptr, 0);
+        psh::partial_sort(FatPtr<i32>{arr.buf, 0}, 10);
+        psh::nth_element(FatPtr<i32>{arr.buf, 1}, 0);
+
+        report_test_successful();
+    }
+
+    psh_internal void introsort_adversarial_inputs() {
+        Arena arena = make_owned_arena(psh_kibibytes(64));
+        psh_defer(destroy_owned_arena(&arena));
+
+        Array<i32>  arr  = make_array<i32>(&arena, 5000);
+        FatPtr<i32> fptr = make_fat_ptr(&arr);
+
+        // Sorted, reverse sorted, all equal and organ pipe inputs, which used to be quadratic.
+        for (u32 idx = 0; idx < arr.count; ++idx) {
+            arr[idx] = static_cast<i32>(idx);
+        }
+        psh::quick_sort(fptr);
+        psh_assert(test_sort(fptr));
+
+        for (u32 idx = 0; idx < arr.count; ++idx) {
+            arr[idx] = -static_cast<i32>(idx);
+        }
+        psh::quick_sort(fptr);
+        psh_assert(test_sort(fptr));
+
+        for (i32& v : arr) {
+            v = 7;
+        }
+        psh::quick_sort(fptr);
+        psh_assert(test_sort(fptr));
+
+        for (u32 idx = 0; idx < arr.count; ++idx) {
+            arr[idx] = static_cast<i32>((idx < arr.count / 2) ? idx : arr.count - idx);
+        }
+        psh::quick_sort(fptr);
+        psh_assert(test_sort(fptr));
+
+        // Empty and single element ranges.
+        psh::quick_sort(FatPtr<i32>{arr.buf, 0});
+        psh::quick_sort(FatPtr<i32>{arr.buf, 1});
+
+        for (i32& v : arr) {
+            v = rand();
+        }
+        psh::heap_sort(fptr);
+        psh_assert(test_sort(fptr));
+
+        report_test_successful();
+    }
+
+    psh_internal f32 keyed_value_key(KeyedValue const& value) {
+        return static_cast<f32>(value.key);
+    }
+
+    psh_internal void radix_sort() {
+        Arena arena = make_owned_arena(psh_kibibytes(64));
+        psh_defer(destroy_owned_arena(&arena));
+
+        {
+            Array<u32> arr = make_array<u32>(&arena, 2000);
+            for (u32& v : arr) {
+                v = static_cast<u32>(rand()) * 2654435761u;
+            }
+            psh_assert(psh::radix_sort(&arena, make_fat_ptr(&arr)));
+            psh_assert(test_sort(make_fat_ptr(&arr)));
+        }
+
+        {
+            Array<i64> arr = make_array<i64>(&arena, 2000);
+            for (i64& v : arr) {
+                v = static_cast<i64>(rand()) - static_cast<i64>(RAND_MAX / 2);
+            }
+            psh_assert(psh::radix_sort(&arena, make_fat_ptr(&arr)));
+            psh_assert(test_sort(make_fat_ptr(&arr)));
+        }
+
+        {
+            Buffer<f32, 9> buf = {3.5f, -0.0f, -100.25f, 1e9f, 0.0f, -1e-9f, 2.0f, -3.5f, 1e-9f};
+            psh_assert(psh::radix_sort(&arena, make_fat_ptr(&buf)));
+            psh_assert(test_sort(make_fat_ptr(&buf)));
+            psh_assert(buf[0] == -100.25f);
+            psh_assert(buf[8] == 1e9f);
+        }
+
+        // Key extraction keeps equivalent elements in their relative order.
+        {
+            Array<KeyedValue> arr = make_array<KeyedValue>(&arena, 300);
+            for (u32 idx = 0; idx < arr.count; ++idx) {
+                arr[idx] = KeyedValue{.key = static_cast<i32>((idx * 7u) % 10u) - 5, .order = idx};
+            }
+            psh_assert(psh::radix_sort(&arena, make_fat_ptr(&arr), keyed_value_key));
+            for (u32 idx = 0; idx + 1u < arr.count; ++idx) {
+                psh_assert(arr[idx].key <= arr[idx + 1u].key);
+                if (arr[idx].key == arr[idx + 1u].key) {
+                    psh_assert(arr[idx].order < arr[idx + 1u].order);
+                }
+            }
+        }
+
+        report_test_successful();
+    }
+
     psh_internal void contains() {
         // Default matcher.
         {
@@ -223,6 +496,51 @@ namespace psh::test::algorithms {
         report_test_successful();
     }
 
+    psh_internal void vectorised_linear_search() {
+        // Every position, including those handled by the scalar tail, should be found.
+        {
+            Buffer<u8, 77> buf;
+            for (usize size = 0; size <= buf.count; ++size) {
+                for (usize idx = 0; idx < size; ++idx) {
+                    memory_set(buf.buf, buf.count, 0);
+                    buf[idx] = 0xAB;
+
+                    FatPtr<u8 const> fptr = {buf.buf, size};
+                    psh_assert(psh::linear_search(fptr, u8{0xAB}) == static_cast<isize>(idx));
+                    psh_assert(psh::contains(fptr, u8{0xAB}));
+                }
+                psh_assert(psh::linear_search(FatPtr<u8 const>{buf.buf, size}, u8{0xCD}) == -1);
+            }
+        }
+        {
+            Buffer<u32, 37> buf;
+            for (usize idx = 0; idx < buf.count; ++idx) {
+                buf[idx] = static_cast<u32>(idx) * 0x01010101u;
+            }
+            for (usize idx = 0; idx < buf.count; ++idx) {
+                psh_assert(psh::linear_search(make_const_fat_ptr(&buf), buf[idx]) == static_cast<isize>(idx));
+            }
+            psh_assert(psh::linear_search(make_const_fat_ptr(&buf), u32{0xFFFFFFFF}) == -1);
+            psh_assert(!psh::contains(make_const_fat_ptr(&buf), u32{3}));
+        }
+        {
+            // Values sharing one of their 32-bit halves with the match shouldn't be found.
+            Buffer<u64, 19> buf;
+            for (usize idx = 0; idx < buf.count; ++idx) {
+                buf[idx] = (u64{0xDEADBEEF} << 32u) | static_cast<u64>(idx);
+            }
+            buf[13] = 0xFFFFFFFF;
+            for (usize idx = 0; idx < buf.count; ++idx) {
+                psh_assert(psh::linear_search(make_const_fat_ptr(&buf), buf[idx]) == static_cast<isize>(idx));
+            }
+            psh_assert(psh::linear_search(make_const_fat_ptr(&buf), u64{2}) == -1);
+            psh_assert(psh::linear_search(make_const_fat_ptr(&buf), (u64{0xDEADBEEF} << 32u) | 0xFFFFFFFFu) == -1);
+            psh_assert(psh::contains(make_const_fat_ptr(&buf), u64{0xFFFFFFFF}));
+        }
+
+        report_test_successful();
+    }
+
     psh_internal void binary_search() {
         // Basic test.
         {
@@ -271,15 +589,153 @@ namespace psh::test::algorithms {
             }
         }
 
+        // Empty and restricted ranges.
+        {
+            Buffer<i32, 5> buf = {1, 2, 3, 4, 5};
+            psh_assert(psh::binary_search(FatPtr<i32 const>{buf.buf, 0}, 1) == -1);
+            psh_assert(psh::binary_search_range(make_const_fat_ptr(&buf), 4, 1, 3) == 3);
+            psh_assert(psh::binary_search_range(make_const_fat_ptr(&buf), 5, 1, 3) == -1);
+            psh_assert(psh::binary_search_range(make_const_fat_ptr(&buf), 1, 1, 0) == -1);
+            psh_assert(psh::binary_search_range(make_const_fat_ptr(&buf), 1, 0, 5) == -1);
+        }
+
+        report_test_successful();
+    }
+
+    psh_internal void lower_and_upper_bounds() {
+        Buffer<i32, 7>    buf  = {1, 3, 3, 3, 7, 9, 9};
+        FatPtr<i32 const> fptr = make_const_fat_ptr(&buf);
+
+        psh_assert(psh::lower_bound(fptr, 0) == 0);
+        psh_assert(psh::lower_bound(fptr, 1) == 0);
+        psh_assert(psh::lower_bound(fptr, 3) == 1);
+        psh_assert(psh::lower_bound(fptr, 4) == 4);
+        psh_assert(psh::lower_bound(fptr, 9) == 5);
+        psh_assert(psh::lower_bound(fptr, 10) == 7);
+
+        psh_assert(psh::upper_bound(fptr, 0) == 0);
+        psh_assert(psh::upper_bound(fptr, 1) == 1);
+        psh_assert(psh::upper_bound(fptr, 3) == 4);
+        psh_assert(psh::upper_bound(fptr, 8) == 5);
+        psh_assert(psh::upper_bound(fptr, 9) == 7);
+
+        psh_assert(psh::lower_bound(FatPtr<i32 const>{buf.buf, 0}, 3) == 0);
+        psh_assert(psh::upper_bound(FatPtr<i32 const>{buf.buf, 0}, 3) == 0);
+
+        // Compare against a linear scan for every count.
+        Buffer<i32, 64> sorted;
+        for (usize count = 0; count <= sorted.count; ++count) {
+            for (usize idx = 0; idx < count; ++idx) {
+                sorted[idx] = static_cast<i32>(2 * (idx / 2));
+            }
+            FatPtr<i32 const> range = {sorted.buf, count};
+            for (i32 match = -1; match <= static_cast<i32>(count) + 1; ++match) {
+                usize lower = 0;
+                while ((lower < count) && (sorted[lower] < match)) {
+                    ++lower;
+                }
+                usize upper = lower;
+                while ((upper < count) && !(match < sorted[upper])) {
+                    ++upper;
+                }
+                psh_assert(psh::lower_bound(range, match) == lower);
+                psh_assert(psh::upper_bound(range, match) == upper);
+            }
+        }
+
+        report_test_successful();
+    }
+
+    psh_internal void eytzinger_search() {
+        Buffer<u32, 100> sorted;
+        Buffer<u32, 100> layout;
+        for (usize idx = 0; idx < sorted.count; ++idx) {
+            sorted[idx] = static_cast<u32>(3 * idx + 1);
+        }
+
+        for (usize count = 0; count <= sorted.count; ++count) {
+            FatPtr<u32 const> sorted_range = {sorted.buf, count};
+            FatPtr<u32>       layout_range = {layout.buf, count};
+            psh::eytzinger_layout(sorted_range, layout_range);
+
+            FatPtr<u32 const> layout_view = {layout.buf, count};
+            for (u32 match = 0; match <= 3 * count + 2; ++match) {
+                usize expected = psh::lower_bound(sorted_range, match);
+                usize idx      = psh::eytzinger_lower_bound(layout_view, match);
+                if (expected == count) {
+                    psh_assert(idx == count);
+                } else {
+                    psh_assert(idx < count);
+                    psh_assert(layout[idx] == sorted[expected]);
+                }
+
+                bool  present = ((match % 3) == 1) && (match < 3 * count);
+                isize found   = psh::eytzinger_search(layout_view, match);
+                psh_assert(present ? ((found != -1) && (layout[static_cast<usize>(found)] == match)) : (found == -1));
+            }
+        }
+
+        report_test_successful();
+    }
+
+    psh_internal void flat_map_usage() {
+        Arena arena = make_owned_arena(psh_kibibytes(8));
+        psh_defer(destroy_owned_arena(&arena));
+
+        FlatMap<i32, u64> map = make_flat_map<i32, u64>(&arena, 2);
+        psh_assert(flat_map_find(&map, 3) == nullptr);
+        psh_assert(!flat_map_remove(&map, 3));
+
+        // Insert out of order, forcing the map to grow.
+        Buffer<i32, 8> keys = {40, -2, 17, 3, 99, 0, 25, 8};
+        for (i32 key : keys) {
+            psh_assert(flat_map_insert(&map, key, static_cast<u64>(key * 10 + 1)));
+        }
+        psh_assert(map.keys.count == 8);
+        psh_assert(map.values.count == 8);
+        for (usize idx = 1; idx < map.keys.count; ++idx) {
+            psh_assert(map.keys[idx - 1] < map.keys[idx]);
+        }
+        for (i32 key : keys) {
+            u64 const* value = flat_map_find(&map, key);
+            psh_assert((value != nullptr) && (*value == static_cast<u64>(key * 10 + 1)));
+        }
+        psh_assert(!flat_map_contains(&map, 4));
+
+        // Overwrite an existing key.
+        psh_assert(flat_map_insert(&map, 17, u64{7}));
+        psh_assert(map.keys.count == 8);
+        psh_assert(*flat_map_find(&map, 17) == 7);
+
+        psh_assert(flat_map_remove(&map, 3));
+        psh_assert(flat_map_remove(&map, 99));
+        psh_assert(!flat_map_contains(&map, 3));
+        psh_assert(map.keys.count == 6);
+        psh_assert(*flat_map_find(&map, 25) == 251);
+        psh_assert(*flat_map_find(&map, -2) == static_cast<u64>(-2 * 10 + 1));
+
+        flat_map_clear(&map);
+        psh_assert(map.keys.count == 0);
+        psh_assert(flat_map_find(&map, 25) == nullptr);
+
         report_test_successful();
     }
 
     psh_internal void run_all() {
         psh::test::algorithms::insertion_sort();
         psh::test::algorithms::quick_sort();
+        psh::test::algorithms::merge_sort();
+        psh::test::algorithms::adaptive_merge_sort();
+        psh::test::algorithms::nth_element_and_partial_sort();
+        psh::test::algorithms::introsort_adversarial_inputs();
+        psh::test::algorithms::radix_sort();
         psh::test::algorithms::contains();
         psh::test::algorithms::linear_search();
+        psh::test::algorithms::vectorised_linear_search();
         psh::test::algorithms::binary_search();
+        psh::test::algorithms::lower_and_upper_bounds();
+        psh::test::algorithms::eytzinger_search();
+        psh::test::algorithms::flat_map_usage();
     }
 }  // namespace psh::test::algorithms
 
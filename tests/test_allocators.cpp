@@ -23,6 +23,7 @@
 /// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
 
 #include <stdlib.h>
+#include <string.h>
 #include <psh_memory.hpp>
 #include "utils.hpp"
 
@@ -237,6 +238,246 @@ namespace psh::test::allocators {
         report_test_successful();
     }
 
+    psh_internal void reserved_arena_commits_on_demand() {
+        usize page_size = memory_virtual_page_size();
+        usize chunk     = 4 * page_size;
+
+        // Reserve far more than will ever be committed.
+        Arena arena = make_reserved_arena(psh_gibibytes(64ull), chunk, 2 * chunk);
+        psh_defer(destroy_owned_arena(&arena));
+        psh_assert(arena.buf != nullptr);
+        psh_assert(arena.reserved == psh_gibibytes(64ull));
+        psh_assert(arena.capacity == chunk);
+
+        // Allocations past the committed memory commit whole chunks.
+        u8* block = memory_alloc<u8>(&arena, chunk + 1);
+        psh_assert(block != nullptr);
+        psh_assert(arena.capacity == 2 * chunk);
+        block[chunk] = 42;
+
+        psh_discard_value(memory_alloc<u8>(&arena, 3 * chunk));
+        psh_assert(arena.capacity == 5 * chunk);
+
+        // Growing the last block in place also commits memory.
+        u8* last = memory_alloc<u8>(&arena, 16);
+        last     = memory_realloc<u8>(&arena, last, 16, 2 * chunk);
+        psh_assert(last != nullptr);
+        psh_assert(arena.capacity >= arena.offset);
+        last[2 * chunk - 1] = 1;
+
+        // Clearing the arena only keeps the memory below the threshold committed.
+        arena_clear(&arena);
+        psh_assert(arena.offset == 0);
+        psh_assert(arena.capacity == 2 * chunk);
+
+        // Decommitted memory is recommitted and zeroed on demand.
+        u8* fresh = memory_alloc<u8>(&arena, 3 * chunk);
+        psh_assert(fresh != nullptr);
+        psh_assert(fresh[3 * chunk - 1] == 0);
+
+        report_test_successful();
+    }
+
+    psh_internal void owned_arenas_with_paging_options() {
+        usize page_size      = memory_virtual_page_size();
+        usize huge_page_size = memory_virtual_huge_page_size();
+
+        // Huge pages round the capacity up, even when the system falls back to regular pages.
+        VirtualMemoryOptions huge  = {.flags = VIRTUAL_MEMORY_FLAG_HUGE_PAGES | VIRTUAL_MEMORY_FLAG_PREFAULT};
+        Arena                arena = make_owned_arena(psh_mebibytes(3) + 1, huge);
+        psh_assert(arena.buf != nullptr);
+        psh_assert(arena.capacity == memory_virtual_alloc_size(psh_mebibytes(3) + 1, huge));
+        psh_assert(arena.capacity > psh_mebibytes(3));
+        if (huge_page_size != 0) {
+            psh_assert(arena.capacity % huge_page_size == 0);
+        }
+
+        u8* block = memory_alloc<u8>(&arena, arena.capacity);
+        psh_assert(block != nullptr);
+        psh_assert((block[0] == 0) && (block[arena.capacity - 1] == 0));
+        block[arena.capacity - 1] = 42;
+        destroy_owned_arena(&arena);
+
+        // Binding to the first NUMA node only affects the placement of the memory.
+        VirtualMemoryOptions bound = {
+            .flags     = VIRTUAL_MEMORY_FLAG_TRANSPARENT_HUGE_PAGES | VIRTUAL_MEMORY_FLAG_PREFAULT,
+            .numa_node = 0,
+        };
+        arena = make_owned_arena(psh_mebibytes(1), bound);
+        psh_assert(arena.buf != nullptr);
+        psh_assert(arena.capacity == psh_mebibytes(1));
+        psh_assert(arena.buf[psh_mebibytes(1) - 1] == 0);
+        destroy_owned_arena(&arena);
+
+        // Reserved arenas fault in each chunk as it gets committed.
+        Arena reserved = make_reserved_arena(psh_mebibytes(64), 4 * page_size, 0, bound);
+        psh_defer(destroy_owned_arena(&reserved));
+        psh_assert(reserved.buf != nullptr);
+        psh_assert(reserved.commit_prefault);
+
+        u8* chunk = memory_alloc<u8>(&reserved, 6 * page_size);
+        psh_assert(chunk != nullptr);
+        psh_assert(reserved.capacity == 8 * page_size);
+        psh_assert(chunk[6 * page_size - 1] == 0);
+
+        report_test_successful();
+    }
+
+    psh_internal void chained_arena_links_blocks() {
+        Arena arena = make_chained_arena(psh_kibibytes(4));
+        psh_defer(destroy_owned_arena(&arena));
+        psh_assert(arena.capacity == psh_kibibytes(4));
+        psh_assert(arena.chain_block == nullptr);
+
+        u8* first_block = arena.buf;
+        u8* small       = memory_alloc<u8>(&arena, 3000);
+        psh_assert(small == first_block);
+        small[2999] = 7;
+
+        {
+            ScratchArena scratch{&arena};
+
+            // Overflowing the first block links a new one, without moving the previous blocks.
+            u8* spill = memory_alloc<u8>(scratch.arena, 3000);
+            psh_assert(spill != nullptr);
+            psh_assert(arena.chain_block != nullptr);
+            psh_assert(arena.buf != first_block);
+            psh_assert(arena.capacity >= psh_kibibytes(8));
+            spill[2999] = 1;
+
+            // Requests larger than the geometric growth get a block of their own size.
+            u64* large = memory_alloc<u64>(scratch.arena, psh_mebibytes(1));
+            psh_assert(large != nullptr);
+            psh_assert(reinterpret_cast<uptr>(large) % alignof(u64) == 0);
+            psh_assert(arena.capacity >= psh_mebibytes(8));
+            large[psh_mebibytes(1) - 1] = 42;
+
+            ArenaCheckpoint checkpoint = make_arena_checkpoint(&arena);
+            u8*             current    = arena.buf;
+            psh_discard_value(memory_alloc<u8>(&arena, psh_mebibytes(16)));
+            psh_assert(arena.buf != current);
+            arena_checkpoint_restore(checkpoint);
+            psh_assert(arena.buf == current);
+            psh_assert(arena.offset == checkpoint.saved_offset);
+            psh_assert(large[psh_mebibytes(1) - 1] == 42);
+        }
+
+        // The scratch arena unlinks every block chained within its lifetime.
+        psh_assert(arena.buf == first_block);
+        psh_assert(arena.chain_block == nullptr);
+        psh_assert(arena.offset == 3000);
+        psh_assert(small[2999] == 7);
+
+        // Blocks of the arena can still be reallocated after moving on to a new block.
+        u32* grown = memory_alloc<u32>(&arena, 16);
+        grown[15]  = 15;
+        grown      = memory_realloc<u32>(&arena, grown, 16, 1024);
+        psh_assert(grown != nullptr);
+        psh_assert(grown[15] == 15);
+        psh_assert(grown[1023] == 0);
+        psh_assert(arena.chain_block != nullptr);
+
+        arena_clear(&arena);
+        psh_assert(arena.buf == first_block);
+        psh_assert(arena.offset == 0);
+        psh_assert(arena.capacity == psh_kibibytes(4));
+
+        report_test_successful();
+    }
+
+    psh_internal void chained_arena_with_parent() {
+        Arena parent = make_owned_arena(psh_kibibytes(64));
+        psh_defer(destroy_owned_arena(&parent));
+
+        Arena arena = make_chained_arena(1024, &parent);
+        psh_assert(arena.capacity == 1024);
+        psh_assert(parent.offset == 1024);
+
+        psh_discard_value(memory_alloc<u8>(&arena, 1000));
+        psh_discard_value(memory_alloc<u8>(&arena, 1000));
+        psh_assert(arena.chain_block != nullptr);
+        usize parent_offset = parent.offset;
+        psh_assert(parent_offset > 2048);
+
+        // Blocks at the top of the parent are given back to it.
+        arena_clear(&arena);
+        psh_assert(parent.offset == 1024);
+
+        destroy_owned_arena(&arena);
+        psh_assert(parent.offset == 0);
+
+        report_test_successful();
+    }
+
+    /// Build a string of n digits in the persistent arena, using a scratch of its own.
+    psh_internal char* scratch_build_digits(Arena* persistent, usize n) {
+        ScratchArena scratch = get_scratch(persistent);
+        psh_assert(scratch.arena != persistent);
+
+        char* temporary = memory_alloc<char>(scratch.arena, n);
+        for (usize idx = 0; idx < n; ++idx) {
+            temporary[idx] = static_cast<char>('0' + (idx % 10));
+        }
+
+        char* result = memory_alloc<char>(persistent, n + 1);
+        memory_copy(reinterpret_cast<u8*>(result), reinterpret_cast<u8 const*>(temporary), n);
+        return result;
+    }
+
+    psh_internal void thread_scratch_arenas_avoid_conflicts() {
+        Arena* outer_arena;
+        {
+            ScratchArena outer = get_scratch();
+            outer_arena        = outer.arena;
+            psh_assert(outer_arena != nullptr);
+            psh_assert(outer_arena->reserved == SCRATCH_ARENA_RESERVE_SIZE);
+
+            // The callee allocates its results into the scratch arena of the caller, and takes
+            // the other scratch arena for its own temporary allocations.
+            usize saved_offset = outer_arena->offset;
+            char* digits       = scratch_build_digits(outer_arena, 100);
+            psh_assert(outer_arena->offset > saved_offset);
+            psh_assert((digits[0] == '0') && (digits[99] == '9') && (digits[100] == 0));
+
+            // Nested requests without conflicts keep handing out arenas of the pool.
+            ScratchArena inner = get_scratch(outer_arena);
+            psh_assert(inner.arena != outer_arena);
+            Arena* conflicts[] = {inner.arena};
+            psh_assert(get_scratch(conflicts, count_of(conflicts)).arena == outer_arena);
+        }
+        psh_assert(get_scratch().arena == outer_arena);
+
+        report_test_successful();
+    }
+
+    psh_internal void atomic_arena_and_sub_arenas() {
+        Arena backing = make_owned_arena(4096);
+        psh_defer(destroy_owned_arena(&backing));
+
+        AtomicArena arena = make_atomic_arena(backing.buf, backing.capacity);
+
+        u8* first = memory_alloc<u8>(&arena, 3);
+        psh_assert(first == backing.buf);
+        u64* second = memory_alloc<u64>(&arena, 2);
+        psh_assert(reinterpret_cast<uptr>(second) % alignof(u64) == 0);
+        psh_assert(atomic_load(&arena.offset) == 8 + 2 * sizeof(u64));
+
+        // Sub-arenas are cache line aligned blocks of the parent.
+        Arena sub = make_sub_arena(&arena, 1024);
+        psh_assert(sub.capacity == 1024);
+        psh_assert(reinterpret_cast<uptr>(sub.buf) % 64 == 0);
+        psh_assert(atomic_load(&arena.offset) == 64 + 1024);
+
+        u32* sub_block = memory_alloc<u32>(&sub, 4);
+        psh_assert(reinterpret_cast<u8*>(sub_block) == sub.buf);
+        psh_assert(atomic_load(&arena.offset) == 64 + 1024);
+
+        atomic_arena_clear(&arena);
+        psh_assert(atomic_load(&arena.offset) == 0);
+
+        report_test_successful();
+    }
+
     psh_internal void stack_allocation_with_default_alignment() {
         usize stack_min_expected_size = 0;
         usize expected_alloc_size     = 512;
@@ -511,13 +752,328 @@ namespace psh::test::allocators {
         report_test_successful();
     }
 
+    struct PoolNode {
+        PoolNode* parent;
+        u64       payload[3];
+    };
+
+    psh_internal void pool_alloc_and_free() {
+        Arena arena = make_owned_arena(psh_kibibytes(16));
+        psh_defer(destroy_owned_arena(&arena));
+
+        Pool pool;
+        psh_assert(init_pool<PoolNode>(&pool, &arena, 8));
+        psh_assert(pool.block_size == sizeof(PoolNode));
+        psh_assert(pool.block_count == 8 && pool.free_count == 8);
+
+        // Blocks of a fresh chunk are handed out contiguously.
+        PoolNode* nodes[20];
+        for (u32 idx = 0; idx < count_of(nodes); ++idx) {
+            nodes[idx] = pool_alloc<PoolNode>(&pool);
+            psh_assert((nodes[idx] != nullptr) && (nodes[idx]->parent == nullptr) && (nodes[idx]->payload[2] == 0));
+            psh_assert(reinterpret_cast<uptr>(nodes[idx]) % alignof(PoolNode) == 0);
+            nodes[idx]->payload[0] = idx;
+        }
+        psh_assert(nodes[1] == nodes[0] + 1);
+        psh_assert(pool.block_count == 24 && pool.free_count == 4);
+
+        // Freed blocks are reused in reverse order, and zeroed on allocation.
+        pool_free(&pool, nodes[13]);
+        pool_free(&pool, nodes[2]);
+        pool_free(&pool, nodes[17]);
+        psh_assert(pool.free_count == 7);
+        psh_assert(pool_alloc<PoolNode>(&pool) == nodes[17]);
+        psh_assert(pool_alloc<PoolNode>(&pool) == nodes[2]);
+        psh_assert(nodes[2]->payload[0] == 0);
+        psh_assert(pool_alloc<PoolNode>(&pool) == nodes[13]);
+        psh_assert(nodes[19]->payload[0] == 19);
+
+        // Small blocks are rounded up to hold a link of the free list.
+        Pool small_pool;
+        psh_assert(init_pool(&small_pool, &arena, 1, 1, 4));
+        psh_assert(small_pool.block_size == sizeof(void*));
+        pool_free_block(&small_pool, nullptr);
+        psh_assert(small_pool.free_count == 4);
+
+        report_test_successful();
+    }
+
+    psh_internal void pool_backed_by_virtual_memory() {
+        Pool pool;
+        psh_assert(init_pool(&pool, nullptr, 48, 16, 4));
+        psh_assert(pool.block_size == 48 && pool.block_alignment == 16);
+
+        // Virtual memory chunks are rounded up to fill whole pages.
+        usize blocks_per_page = pool.block_count;
+        psh_assert(blocks_per_page >= 4);
+
+        PoolCache cache = make_pool_cache(&pool, 8);
+        u8*       blocks[300];
+        for (u32 idx = 0; idx < count_of(blocks); ++idx) {
+            blocks[idx] = pool_alloc_block(&cache);
+            psh_assert(blocks[idx] != nullptr);
+            psh_assert(reinterpret_cast<uptr>(blocks[idx]) % 16 == 0);
+            memory_set(blocks[idx], 48, 0xAB);
+        }
+        psh_assert(pool.chunks != nullptr);
+        psh_assert(pool.block_count >= count_of(blocks));
+
+        for (u32 idx = 0; idx < count_of(blocks); ++idx) {
+            pool_free_block(&cache, blocks[idx]);
+            psh_assert(cache.count <= cache.capacity);
+        }
+        pool_cache_flush(&cache);
+        psh_assert(cache.count == 0 && cache.free_list == nullptr);
+        psh_assert(pool.free_count == pool.block_count);
+
+        destroy_pool(&pool);
+        psh_assert(pool.chunks == nullptr && pool.free_list == nullptr);
+
+        report_test_successful();
+    }
+
+    psh_internal void tlsf_out_of_order_free() {
+        Arena backing = make_owned_arena(psh_kibibytes(64));
+        psh_defer(destroy_owned_arena(&backing));
+
+        Tlsf tlsf;
+        psh_assert(init_tlsf(&tlsf, backing.buf, backing.capacity));
+        usize initial_largest = tlsf_largest_free_block(&tlsf);
+        psh_assert(initial_largest > psh_kibibytes(63));
+
+        // Allocate blocks of many size classes and fill them with a known pattern.
+        u8*   blocks[64];
+        usize sizes[64];
+        for (u32 idx = 0; idx < count_of(blocks); ++idx) {
+            sizes[idx]  = 1 + ((idx * 97) % 700);
+            blocks[idx] = memory_alloc<u8>(&tlsf, sizes[idx]);
+            psh_assert(blocks[idx] != nullptr);
+            psh_assert(reinterpret_cast<uptr>(blocks[idx]) % 8 == 0);
+            psh_assert(tlsf_block_size(blocks[idx]) >= sizes[idx]);
+            psh_assert(blocks[idx][0] == 0 && blocks[idx][sizes[idx] - 1] == 0);
+            memory_set(blocks[idx], sizes[idx], static_cast<i32>(idx));
+        }
+        psh_assert(tlsf.allocation_count == count_of(blocks));
+
+        // Free every other block, in an order unrelated to the allocation order.
+        for (u32 idx = 1; idx < count_of(blocks); idx += 2) {
+            memory_free(&tlsf, blocks[count_of(blocks) - idx]);
+            blocks[count_of(blocks) - idx] = nullptr;
+        }
+        for (u32 idx = 0; idx < count_of(blocks); ++idx) {
+            if (blocks[idx] != nullptr) {
+                psh_assert(blocks[idx][0] == idx && blocks[idx][sizes[idx] - 1] == idx);
+            }
+        }
+
+        // Aligned allocations are carved out of the free blocks.
+        u64* aligned = reinterpret_cast<u64*>(memory_alloc_align(&tlsf, 100, 256));
+        psh_assert(aligned != nullptr);
+        psh_assert(reinterpret_cast<uptr>(aligned) % 256 == 0);
+        memory_free(&tlsf, aligned);
+
+        // Once everything is freed, the neighbouring blocks are merged back into a single block.
+        for (u32 idx = 0; idx < count_of(blocks); ++idx) {
+            memory_free(&tlsf, blocks[idx]);
+        }
+        psh_assert(tlsf.allocation_count == 0 && tlsf.used_bytes == 0);
+        psh_assert(tlsf.peak_used_bytes > 0);
+        psh_assert(tlsf_largest_free_block(&tlsf) == initial_largest);
+
+        report_test_successful();
+    }
+
+    psh_internal void tlsf_realloc_and_resize() {
+        Arena backing = make_owned_arena(psh_kibibytes(16));
+        psh_defer(destroy_owned_arena(&backing));
+
+        Tlsf tlsf;
+        psh_assert(init_tlsf(&tlsf, backing.buf, psh_kibibytes(4)));
+
+        u32* values = memory_alloc<u32>(&tlsf, 16);
+        for (u32 idx = 0; idx < 16; ++idx) {
+            values[idx] = idx;
+        }
+
+        // The block grows in place while its neighbour is free.
+        u32* grown = memory_realloc<u32>(&tlsf, values, 64);
+        psh_assert(grown == values);
+        psh_assert(grown[15] == 15 && grown[63] == 0);
+
+        // A block in the way forces the reallocation to move the data.
+        u8*  blocker = memory_alloc<u8>(&tlsf, 32);
+        u32* moved   = memory_realloc<u32>(&tlsf, grown, 128);
+        psh_assert(moved != grown);
+        psh_assert(moved[0] == 0 && moved[15] == 15 && moved[127] == 0);
+        psh_assert(tlsf.allocation_count == 2);
+
+        // Shrinking always happens in place.
+        psh_assert(memory_realloc<u32>(&tlsf, moved, 8) == moved);
+        psh_assert(tlsf_block_size(reinterpret_cast<u8*>(moved)) < 128 * sizeof(u32));
+
+        // The allocator can't satisfy requests larger than its memory until it grows.
+        psh_assert(tlsf_largest_free_block(&tlsf) < psh_kibibytes(8));
+        psh_assert(tlsf_resize(&tlsf, psh_kibibytes(16)));
+        u8* large = memory_alloc<u8>(&tlsf, psh_kibibytes(8));
+        psh_assert(large != nullptr);
+
+        // Memory in use can't be cut, but the free tail can.
+        psh_assert(!tlsf_resize(&tlsf, psh_kibibytes(4)));
+        memory_free(&tlsf, large);
+        psh_assert(tlsf_resize(&tlsf, psh_kibibytes(4)));
+        psh_assert(tlsf.capacity == psh_kibibytes(4));
+        psh_assert(tlsf_largest_free_block(&tlsf) < psh_kibibytes(4));
+
+        memory_free(&tlsf, blocker);
+        memory_free(&tlsf, moved);
+        psh_assert(tlsf.used_bytes == 0);
+
+        report_test_successful();
+    }
+
+    psh_internal void uninitialised_allocations() {
+        Arena arena = make_owned_arena(1024);
+        psh_defer(destroy_owned_arena(&arena));
+
+        // Dirty the memory of the arena and give it back.
+        ArenaCheckpoint checkpoint = make_arena_checkpoint(&arena);
+        u8*             dirty      = memory_alloc<u8>(&arena, 64);
+        memory_set(dirty, 64, 0xAB);
+        arena_checkpoint_restore(checkpoint);
+
+        // The non-zeroing variant keeps the previous contents of the memory.
+        u8* uninit = memory_alloc_uninit<u8>(&arena, 32);
+        psh_assert(uninit == dirty);
+        psh_assert(uninit[0] == 0xAB && uninit[31] == 0xAB);
+
+        // Growing in place only zeroes the new memory if asked to.
+        psh_assert(memory_realloc_uninit<u8>(&arena, uninit, 32, 48) == uninit);
+        psh_assert(uninit[47] == 0xAB);
+        psh_assert(memory_realloc<u8>(&arena, uninit, 48, 64) == uninit);
+        psh_assert(uninit[47] == 0xAB && uninit[48] == 0 && uninit[63] == 0);
+        arena_checkpoint_restore(checkpoint);
+
+        u8* zeroed = memory_alloc<u8>(&arena, 32);
+        psh_assert(zeroed == dirty);
+        psh_assert(zeroed[0] == 0 && zeroed[31] == 0);
+        arena_checkpoint_restore(checkpoint);
+
+        // Arrays whose elements are all written right away.
+        memory_set(dirty, 64, 0xAB);
+        Array<u8> bytes = make_array_uninit<u8>(&arena, 16);
+        psh_assert(bytes.count == 16 && bytes[15] == 0xAB);
+
+        // Pool blocks hold the free list link while free, the remaining bytes are left untouched.
+        Pool pool;
+        psh_assert(init_pool(&pool, &arena, 32, 8, 4));
+        u8* block = pool_alloc_block(&pool);
+        memory_set(block, 32, 0xCD);
+        pool_free_block(&pool, block);
+        psh_assert(pool_alloc_block_uninit(&pool) == block);
+        psh_assert(block[31] == 0xCD);
+        pool_free_block(&pool, block);
+        psh_assert(pool_alloc_block(&pool) == block);
+        psh_assert(block[31] == 0);
+
+        report_test_successful();
+    }
+
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+    struct MemoryReport {
+        char  buf[1024];
+        usize length;
+    };
+
+    psh_internal void write_memory_report(void* context, char const* msg, usize length) {
+        MemoryReport* report = reinterpret_cast<MemoryReport*>(context);
+        psh_assert(report->length + length < sizeof(report->buf));
+        memory_copy(reinterpret_cast<u8*>(report->buf + report->length), reinterpret_cast<u8 const*>(msg), length);
+        report->length += length;
+        report->buf[report->length] = 0;
+    }
+
+    psh_internal void allocation_instrumentation() {
+        memory_reset_allocation_sites();
+
+        Arena arena = make_owned_arena(1024);
+        psh_defer(destroy_owned_arena(&arena));
+
+        u8* bytes = memory_alloc<u8>(&arena, 3);
+        u32 const bytes_line = psh_source_line_number() - 1;
+        u64* words = memory_alloc<u64>(&arena, 2);
+        u32 const words_line = psh_source_line_number() - 1;
+
+        // The words had to be aligned past the three bytes.
+        psh_assert(arena.stats.allocation_count == 2);
+        psh_assert(arena.stats.bytes_allocated == 19);
+        psh_assert(arena.stats.padding_bytes == 5);
+        psh_assert(arena.stats.peak_used_bytes == 24);
+
+        // The last block grows in place, while any other block has to be copied.
+        psh_assert(memory_realloc<u64>(&arena, words, 2, 4) == words);
+        psh_assert(arena.stats.realloc_copy_bytes == 0);
+        u8* moved_bytes = memory_realloc<u8>(&arena, bytes, 3, 6);
+        u32 const moved_bytes_line = psh_source_line_number() - 1;
+        psh_assert(moved_bytes != bytes);
+        psh_assert(arena.stats.realloc_count == 2);
+        psh_assert(arena.stats.realloc_copy_bytes == 3);
+        psh_assert(arena.stats.allocation_count == 3);
+
+        // The high-water mark outlives the offset.
+        arena_clear(&arena);
+        psh_assert(arena.stats.peak_used_bytes == 46);
+
+        // The sites are sorted by the number of bytes they allocated.
+        AllocationSiteStats sites[4];
+        psh_assert(memory_allocation_sites(sites, count_of(sites)) == 3);
+        psh_assert(sites[0].location.line == words_line && sites[0].bytes_allocated == 16);
+        psh_assert(sites[1].location.line == moved_bytes_line && sites[1].bytes_allocated == 6);
+        psh_assert(sites[2].location.line == bytes_line && sites[2].allocation_count == 1);
+        psh_assert(strcmp(sites[0].location.file_name, psh_source_file_name()) == 0);
+        psh_assert(strcmp(sites[0].location.function_name, psh_source_function_name()) == 0);
+
+        // Allocators able to free blocks also count their frees.
+        Tlsf tlsf;
+        psh_assert(init_tlsf(&tlsf, arena.buf, arena.capacity));
+        u32* triple = memory_alloc<u32>(&tlsf, 3);
+        psh_assert(tlsf.stats.padding_bytes == tlsf_block_size(reinterpret_cast<u8*>(triple)) - 3 * sizeof(u32));
+        memory_free(&tlsf, triple);
+        psh_assert(tlsf.stats.allocation_count == 1 && tlsf.stats.free_count == 1);
+
+        MemoryReport report = {};
+        memory_report_allocator_stats("frame", &arena.stats, write_memory_report, &report);
+        psh_assert(strstr(report.buf, "Allocator 'frame':\n") == report.buf);
+        psh_assert(strstr(report.buf, "peak used bytes: 46\n") != nullptr);
+
+        report = {};
+        memory_report_allocation_sites(write_memory_report, &report);
+        psh_assert(strstr(report.buf, "Allocation sites (4)") == report.buf);
+
+        report_test_successful();
+    }
+#endif
+
     psh_internal void run_all() {
         scratch_arena_basic();
         scratch_arena_passed_as_reference();
+        reserved_arena_commits_on_demand();
+        owned_arenas_with_paging_options();
+        chained_arena_links_blocks();
+        chained_arena_with_parent();
+        thread_scratch_arenas_avoid_conflicts();
+        atomic_arena_and_sub_arenas();
         stack_allocation_with_default_alignment();
         stack_offsets_reads_and_writes();
         stack_memory_stress_and_free();
         stack_free_all();
+        pool_alloc_and_free();
+        pool_backed_by_virtual_memory();
+        tlsf_out_of_order_free();
+        tlsf_realloc_and_resize();
+        uninitialised_allocations();
+#if PSH_ENABLE_MEMORY_INSTRUMENTATION
+        allocation_instrumentation();
+#endif
     }
 }  // namespace psh::test::allocators
 
@@ -196,6 +196,23 @@ namespace psh::test::bit {
         report_test_successful();
     }
 
+    psh_internal void count_and_select_ones() {
+        psh_assert(bit_count_ones(u32{0}) == 0);
+        psh_assert(bit_count_ones(u32{0xF0F0}) == 8);
+        psh_assert(bit_count_ones(~u64{0}) == 64);
+        psh_assert(bit_count_ones(u64{0x8000000000000001}) == 2);
+
+        u64 value = 0b1010'0110'0000'0001;
+        psh_assert(bit_select(value, 0) == 0);
+        psh_assert(bit_select(value, 1) == 9);
+        psh_assert(bit_select(value, 2) == 10);
+        psh_assert(bit_select(value, 3) == 13);
+        psh_assert(bit_select(value, 4) == 15);
+        psh_assert(bit_select(u64{0x8000000000000000}, 0) == 63);
+
+        report_test_successful();
+    }
+
     psh_internal void run_all() {
         little_endian();
         create_with_bit();
@@ -207,6 +224,7 @@ namespace psh::test::bit {
         set_u16_bytes();
         integers_have_opposite_sign();
         integer_swap_values();
+        count_and_select_ones();
     }
 }  // namespace psh::test::bit
 
@@ -22,7 +22,9 @@
 /// Description: Tests for the dynamic array.
 /// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
 
+#include <psh_defer.hpp>
 #include <psh_memory.hpp>
+#include <psh_string.hpp>
 #include "utils.hpp"
 
 namespace psh::test::containers {
@@ -120,6 +122,108 @@ namespace psh::test::containers {
         report_test_successful();
     }
 
+    psh_internal void dynamic_array_uninitialised_growth(MemoryManager& memory_manager) {
+        Arena arena;
+        {
+            usize arena_capacity = psh_usize_of(i32) * 1024;
+            init_arena(&arena, memory_alloc<u8>(&memory_manager, arena_capacity), arena_capacity);
+        }
+
+        DynamicArray<i32> v = make_dynamic_array<i32>(&arena, 2, DynamicArrayGrowth::UNINITIALISED);
+        psh_assert(v.growth == DynamicArrayGrowth::UNINITIALISED);
+
+        for (i32 i = 0; i < 100; ++i) {
+            psh_assert(dynamic_array_push(&v, i));
+        }
+        psh_assert(dynamic_array_reserve(&v, 512));
+        psh_assert(v.count == 100 && v.capacity == 512);
+        for (i32 i = 0; i < 100; ++i) {
+            psh_assert(v[static_cast<usize>(i)] == i);
+        }
+
+        memory_manager.pop();
+        report_test_successful();
+    }
+
+    psh_internal void dynamic_array_resize_policies() {
+        DynamicArrayResizePolicy golden = {.kind = DynamicArrayResize::GOLDEN_RATIO};
+        psh_assert(dynamic_array_next_capacity({}, 4, 16, 0) == 32);
+        psh_assert(dynamic_array_next_capacity(golden, 4, 16, 0) == 26);
+        psh_assert(dynamic_array_next_capacity({.kind = DynamicArrayResize::PAGE_GRANULAR}, 8, 16, 0) == 512);
+        psh_assert(dynamic_array_next_capacity({.kind = DynamicArrayResize::FIXED_STEP, .step = 10}, 4, 16, 0) == 26);
+        psh_assert(dynamic_array_next_capacity(golden, 4, 1, 0) == DYNARRAY_DEFAULT_INITIAL_CAPACITY);
+        psh_assert(dynamic_array_next_capacity(golden, 4, 16, 100) == 100);
+
+        Arena arena = make_owned_arena(psh_usize_of(i32) * 64);
+        psh_defer(destroy_owned_arena(&arena));
+
+        // The last block of the arena grows in place, taking the remaining memory if needed.
+        DynamicArray<i32> v = make_dynamic_array<i32>(&arena, 4);
+        v.resize            = {.kind = DynamicArrayResize::GEOMETRIC, .step = 32};
+        i32* buf            = v.buf;
+        for (i32 i = 0; i < 40; ++i) {
+            psh_assert(dynamic_array_push(&v, i));
+        }
+        psh_assert(v.buf == buf && v.capacity == 64);
+
+        // Only the unused capacity at the top of the arena is given back.
+        psh_assert(dynamic_array_shrink_to_fit(&v));
+        psh_assert(v.capacity == 40 && arena.offset == psh_usize_of(i32) * 40);
+
+        DynamicArray<i32> w = make_dynamic_array<i32>(&arena, 4);
+        psh_assert(dynamic_array_pop(&v));
+        psh_assert(!dynamic_array_shrink_to_fit(&v) && v.capacity == 40);
+        psh_assert(dynamic_array_shrink_to_fit(&w) && w.capacity == 0);
+        psh_assert(arena.offset == psh_usize_of(i32) * 40);
+
+        report_test_successful();
+    }
+
+    psh_internal void stable_array_push_and_pop() {
+        Arena arena = make_owned_arena(psh_kibibytes(4));
+        psh_defer(destroy_owned_arena(&arena));
+
+        StableArray<i32> v = make_stable_array<i32>(&arena, 2);
+        i32*             first = stable_array_push(&v, 0);
+        for (i32 i = 1; i < 100; ++i) {
+            // Allocations in between segments don't affect the array.
+            psh_discard_value(memory_alloc<u8>(&arena, 3));
+            psh_assert(stable_array_push(&v, i) != nullptr);
+        }
+        psh_assert(v.count == 100 && v.capacity == 128);
+        psh_assert(first == stable_array_at(&v, 0) && *first == 0);
+        for (i32 i = 0; i < 100; ++i) {
+            psh_assert(v[static_cast<usize>(i)] == i);
+        }
+
+        usize segment_count = 0;
+        i32   expected      = 0;
+        for (StableArraySegment<i32>* segment = v.first; segment != nullptr; segment = segment->next) {
+            for (i32 value : *segment) {
+                psh_assert(value == expected++);
+            }
+            ++segment_count;
+        }
+        psh_assert(segment_count == 7 && expected == 100);
+
+        // Popping past a segment boundary and pushing again reuses the segments.
+        usize offset = arena.offset;
+        for (i32 i = 0; i < 40; ++i) {
+            psh_assert(stable_array_pop(&v));
+        }
+        for (i32 i = 60; i < 100; ++i) {
+            psh_assert(stable_array_push(&v, -i) != nullptr);
+        }
+        psh_assert(v.count == 100 && v[59] == 59 && v[60] == -60 && v[99] == -99);
+
+        stable_array_clear(&v);
+        psh_assert(!stable_array_pop(&v));
+        psh_assert(stable_array_push(&v, 42) == first && *first == 42);
+        psh_assert(arena.offset == offset);
+
+        report_test_successful();
+    }
+
     psh_internal void dynamic_array_count_and_capacity(MemoryManager& memory_manager) {
         Arena arena;
         {
@@ -286,6 +390,436 @@ namespace psh::test::containers {
         report_test_successful();
     }
 
+    psh_internal void hash_map_insert_and_find() {
+        Arena arena = make_owned_arena(64 * 1024);
+        psh_defer(destroy_owned_arena(&arena));
+
+        HashMap<u32, u32> map = make_hash_map<u32, u32>(&arena);
+        psh_assert(map.capacity >= HASH_MAP_DEFAULT_INITIAL_CAPACITY);
+
+        // Force the map to grow a couple of times.
+        for (u32 i = 0; i < 500; ++i) {
+            psh_assert(hash_map_insert(&map, i, i * 3u));
+        }
+        psh_assert(map.count == 500);
+        psh_assert(psh_is_pow_of_two(map.capacity));
+        psh_assert(map.count * 8u <= map.capacity * 7u);
+
+        for (u32 i = 0; i < 500; ++i) {
+            u32* value = hash_map_find(&map, i);
+            psh_assert((value != nullptr) && (*value == i * 3u));
+        }
+        psh_assert(!hash_map_contains(&map, 500u));
+        psh_assert(hash_map_find(&map, 12345u) == nullptr);
+
+        // Inserting an existing key overwrites its value.
+        psh_assert(hash_map_insert(&map, 42u, 7u));
+        psh_assert(map.count == 500);
+        u32* overwritten = hash_map_find(&map, 42u);
+        psh_assert((overwritten != nullptr) && (*overwritten == 7u));
+
+        // Each growth doubles the capacity.
+        HashMap<u32, u32> small_map = make_hash_map<u32, u32>(&arena, 14);
+        psh_assert(small_map.capacity == 16);
+        for (u32 i = 0; i < 14; ++i) {
+            psh_assert(hash_map_insert(&small_map, i, i));
+        }
+        psh_assert(small_map.capacity == 16);
+        psh_assert(hash_map_insert(&small_map, 14u, 14u));
+        psh_assert(small_map.capacity == 32);
+
+        report_test_successful();
+    }
+
+    psh_internal void hash_map_remove_and_clear() {
+        Arena arena = make_owned_arena(64 * 1024);
+        psh_defer(destroy_owned_arena(&arena));
+
+        HashMap<u64, i32> map = make_hash_map<u64, i32>(&arena, 64);
+        usize capacity = map.capacity;
+
+        // Repeatedly fill and drain the map: tombstones should never force the map to grow.
+        for (i32 round = 0; round < 8; ++round) {
+            for (u64 i = 0; i < 50; ++i) {
+                psh_assert(hash_map_insert(&map, i + static_cast<u64>(round) * 1000u, round));
+            }
+            for (u64 i = 0; i < 50; i += 2) {
+                psh_assert(hash_map_remove(&map, i + static_cast<u64>(round) * 1000u));
+                psh_assert(!hash_map_remove(&map, i + static_cast<u64>(round) * 1000u));
+            }
+            for (u64 i = 0; i < 50; ++i) {
+                bool expected = ((i % 2) == 1);
+                psh_assert(hash_map_contains(&map, i + static_cast<u64>(round) * 1000u) == expected);
+            }
+            for (u64 i = 1; i < 50; i += 2) {
+                psh_assert(hash_map_remove(&map, i + static_cast<u64>(round) * 1000u));
+            }
+            psh_assert(map.count == 0);
+        }
+        psh_assert(map.capacity == capacity);
+
+        psh_assert(hash_map_insert(&map, u64{1}, 1));
+        psh_assert(hash_map_insert(&map, u64{2}, 2));
+        hash_map_clear(&map);
+        psh_assert(map.count == 0);
+        psh_assert(map.capacity == capacity);
+        psh_assert(!hash_map_contains(&map, u64{1}));
+
+        report_test_successful();
+    }
+
+    psh_internal void hash_map_string_keys() {
+        Arena arena = make_owned_arena(4096);
+        psh_defer(destroy_owned_arena(&arena));
+
+        HashMap<String, u32> map = make_hash_map<String, u32>(&arena);
+
+        cstring words[] = {"presheaf", "sheaf", "topos", "site", "presheaf", "topos", "presheaf"};
+        for (usize idx = 0; idx < count_of(words); ++idx) {
+            String word  = make_string(words[idx]);
+            u32*   count = hash_map_find(&map, word);
+            if (count == nullptr) {
+                psh_assert(hash_map_insert(&map, word, 1u));
+            } else {
+                ++*count;
+            }
+        }
+
+        psh_assert(map.count == 4);
+        psh_assert(*hash_map_find(&map, make_string("presheaf")) == 3u);
+        psh_assert(*hash_map_find(&map, make_string("topos")) == 2u);
+        psh_assert(*hash_map_find(&map, make_string("sheaf")) == 1u);
+        psh_assert(!hash_map_contains(&map, make_string("sheafification")));
+
+        report_test_successful();
+    }
+
+    /// Check that a handle refers to an element of the slot map with a given value.
+    psh_internal bool slot_map_holds(SlotMap<Foo>* map, SlotHandle handle, i32 bar) {
+        Foo* value = slot_map_find(map, handle);
+        return (value != nullptr) && (value->bar == bar);
+    }
+
+    psh_internal void slot_map_usage() {
+        Arena arena = make_owned_arena(4096);
+        psh_defer(destroy_owned_arena(&arena));
+
+        SlotMap<Foo> map = make_slot_map<Foo>(&arena, 2);
+        psh_assert(slot_map_find(&map, SlotHandle{}) == nullptr);
+
+        SlotHandle handles[16];
+        for (i32 idx = 0; idx < 16; ++idx) {
+            handles[idx] = slot_map_insert(&map, Foo{.bar = idx});
+            psh_assert(!slot_handle_is_null(handles[idx]));
+        }
+        psh_assert(map.count == 16);
+
+        // Handles survive the growth of the arrays.
+        for (i32 idx = 0; idx < 16; ++idx) {
+            psh_assert(slot_map_holds(&map, handles[idx], idx));
+        }
+
+        // Removals reorder the dense values without invalidating the other handles.
+        psh_assert(slot_map_remove(&map, handles[3]));
+        psh_assert(slot_map_remove(&map, handles[0]));
+        psh_assert(!slot_map_remove(&map, handles[3]));
+        psh_assert(!slot_map_contains(&map, handles[3]));
+        psh_assert(map.count == 14);
+        psh_assert(map.values.count == 14);
+        for (i32 idx = 0; idx < 16; ++idx) {
+            if ((idx != 0) && (idx != 3)) {
+                psh_assert(slot_map_holds(&map, handles[idx], idx));
+            }
+        }
+
+        // The dense array can be iterated, and every position maps back to its handle.
+        i32 sum = 0;
+        for (usize idx = 0; idx < map.values.count; ++idx) {
+            SlotHandle handle = slot_map_handle_at(&map, idx);
+            psh_assert(slot_map_find(&map, handle) == &map.values[idx]);
+            sum += map.values[idx].bar;
+        }
+        psh_assert(sum == (15 * 16) / 2 - 3);
+
+        // Freed slots are reused with a new generation, so the stale handle stays invalid.
+        SlotHandle reused = slot_map_insert(&map, Foo{.bar = 100});
+        psh_assert(slot_handle_index(reused) == slot_handle_index(handles[0]));
+        psh_assert(slot_handle_generation(reused) != slot_handle_generation(handles[0]));
+        psh_assert(slot_map_find(&map, handles[0]) == nullptr);
+        psh_assert(slot_map_holds(&map, reused, 100));
+
+        SlotMap<Foo> const* const_map   = &map;
+        Foo const*          const_found = slot_map_find(const_map, reused);
+        psh_assert(const_found == slot_map_find(&map, reused));
+
+        slot_map_clear(&map);
+        psh_assert(map.count == 0);
+        psh_assert(!slot_map_contains(&map, reused));
+        psh_assert(!slot_map_contains(&map, handles[15]));
+
+        SlotHandle after_clear = slot_map_insert(&map, Foo{.bar = 7});
+        psh_assert(slot_map_holds(&map, after_clear, 7));
+        psh_assert(map.slots.count == 16);
+
+        report_test_successful();
+    }
+
+    psh_internal void slot_map_generation_wrap_around() {
+        Arena arena = make_owned_arena(4096);
+        psh_defer(destroy_owned_arena(&arena));
+
+        SlotMap<Foo> map = make_slot_map<Foo>(&arena, 4);
+
+        SlotHandle kept  = slot_map_insert(&map, Foo{.bar = 1});
+        SlotHandle stale = slot_map_insert(&map, Foo{.bar = 2});
+        psh_assert(slot_map_remove(&map, stale));
+
+        // Cycle the freed slot through every generation. Whenever it is free, the stale handle must
+        // not reach it, even when the slot generation is back to the one of the handle.
+        bool generation_matched_while_free = false;
+        for (u32 cycle = 0; cycle < 2u * SLOT_HANDLE_MAX_GENERATION; ++cycle) {
+            u32 free_generation = map.slots.buf[slot_handle_index(stale)].generation;
+            generation_matched_while_free |= (free_generation == slot_handle_generation(stale));
+
+            psh_assert(slot_map_find(&map, stale) == nullptr);
+            psh_assert(!slot_map_contains(&map, stale));
+            psh_assert(!slot_map_remove(&map, stale));
+            psh_assert(map.count == 1);
+
+            SlotHandle handle = slot_map_insert(&map, Foo{.bar = 3});
+            psh_assert(slot_handle_index(handle) == slot_handle_index(stale));
+            psh_assert(slot_map_holds(&map, handle, 3));
+            psh_assert(slot_map_remove(&map, handle));
+        }
+        psh_assert(generation_matched_while_free);
+        psh_assert(slot_map_holds(&map, kept, 1));
+
+        report_test_successful();
+    }
+
+    psh_internal void raw_memory_operations() {
+        constexpr usize max_size = 300;
+
+        u8 source[max_size];
+        u8 target[max_size + 64];
+        for (usize idx = 0; idx < max_size; ++idx) {
+            source[idx] = static_cast<u8>(idx * 7u + 1u);
+        }
+
+        // Cover the inline small sizes, the block boundaries of the bulk kernels, and misaligned
+        // destinations.
+        for (usize size = 0; size <= max_size - 8; ++size) {
+            for (usize offset = 0; offset < 8; offset += 3) {
+                memory_set(target, count_of(target), 0);
+                memory_copy(target + offset, source + 8 - offset, size);
+                for (usize idx = 0; idx < count_of(target); ++idx) {
+                    bool in_range = (idx >= offset) && (idx < offset + size);
+                    psh_assert(target[idx] == (in_range ? source[idx + 8 - 2 * offset] : 0));
+                }
+
+                memory_set(target + offset, size, 0x5A);
+                for (usize idx = 0; idx < count_of(target); ++idx) {
+                    bool in_range = (idx >= offset) && (idx < offset + size);
+                    psh_assert(!in_range || (target[idx] == 0x5A));
+                }
+            }
+        }
+
+        // Overlapping moves in both directions.
+        for (usize size = 0; size <= max_size - 16; size += 5) {
+            for (usize shift = 1; shift < 16; shift += 7) {
+                memory_copy(target, source, max_size);
+                memory_move(target + shift, target, size);
+                for (usize idx = 0; idx < size; ++idx) {
+                    psh_assert(target[idx + shift] == source[idx]);
+                }
+
+                memory_copy(target, source, max_size);
+                memory_move(target, target + shift, size);
+                for (usize idx = 0; idx < size; ++idx) {
+                    psh_assert(target[idx] == source[idx + shift]);
+                }
+            }
+        }
+
+        report_test_successful();
+    }
+
+    psh_internal void raw_memory_fixed_size_operations() {
+        struct Large {
+            u64 words[21];
+            u8  tail[3];
+        };
+
+        Large a = {};
+        for (usize idx = 0; idx < count_of(a.words); ++idx) {
+            a.words[idx] = idx * 0x9E3779B97F4A7C15ull;
+        }
+        a.tail[2] = 0xEE;
+
+        Large b;
+        copy_struct(&b, &a);
+        for (usize idx = 0; idx < count_of(a.words); ++idx) {
+            psh_assert(b.words[idx] == a.words[idx]);
+        }
+        psh_assert(b.tail[2] == 0xEE);
+
+        zero_struct(&b);
+        for (usize idx = 0; idx < sizeof(Large); ++idx) {
+            psh_assert(reinterpret_cast<u8 const*>(&b)[idx] == 0);
+        }
+
+        u8 bytes[64];
+        for (usize idx = 0; idx < count_of(bytes); ++idx) {
+            bytes[idx] = static_cast<u8>(idx);
+        }
+        memory_move_fixed<40>(bytes + 3, bytes);
+        for (usize idx = 0; idx < 40; ++idx) {
+            psh_assert(bytes[idx + 3] == static_cast<u8>(idx));
+        }
+        memory_set_fixed<5>(bytes, 0xFF);
+        memory_set_fixed<37>(bytes + 10, 0x11);
+        psh_assert((bytes[4] == 0xFF) && (bytes[5] == 2));
+        psh_assert((bytes[9] == 6) && (bytes[10] == 0x11) && (bytes[46] == 0x11) && (bytes[47] == 47));
+
+        report_test_successful();
+    }
+
+    psh_internal void raw_memory_non_temporal_operations() {
+        // Big enough to take the non-temporal path, with an odd size and a misaligned destination.
+        constexpr usize size = PSH_MEMORY_NON_TEMPORAL_THRESHOLD + 77;
+
+        Arena arena = make_owned_arena(2 * size + 64);
+        psh_defer(destroy_owned_arena(&arena));
+
+        u8* src = memory_alloc<u8>(&arena, size);
+        u8* dst = memory_alloc<u8>(&arena, size + 1);
+        for (usize idx = 0; idx < size; ++idx) {
+            src[idx] = static_cast<u8>(idx ^ (idx >> 8));
+        }
+
+        memory_copy(dst + 1, src, size);
+        for (usize idx = 0; idx < size; ++idx) {
+            psh_assert(dst[idx + 1] == src[idx]);
+        }
+
+        memory_set(dst + 1, size, 0x3C);
+        for (usize idx = 1; idx <= size; ++idx) {
+            psh_assert(dst[idx] == 0x3C);
+        }
+
+        report_test_successful();
+    }
+
+    psh_internal void bit_array_usage() {
+        Arena arena = make_owned_arena(4096);
+        psh_defer(destroy_owned_arena(&arena));
+
+        // Use a bit count that isn't a multiple of the word size, spanning enough words for the
+        // vectorised paths to be exercised.
+        constexpr usize bit_count = 1000;
+
+        BitArray bits = make_bit_array(&arena, bit_count);
+        psh_assert(bits.bit_count == bit_count);
+        psh_assert(bits.word_count == 16);
+        psh_assert(bit_array_count_ones(&bits) == 0);
+        psh_assert(bit_array_find_next(&bits, 0) == -1);
+
+        for (usize idx = 0; idx < bit_count; idx += 3) {
+            bit_array_set(&bits, idx);
+        }
+        psh_assert(bit_array_count_ones(&bits) == 334);
+        psh_assert(bit_array_test(&bits, 999));
+        psh_assert(!bit_array_test(&bits, 998));
+
+        usize visited = 0;
+        for (isize idx = bit_array_find_next(&bits, 0); idx != -1; idx = bit_array_find_next(&bits, static_cast<usize>(idx) + 1)) {
+            psh_assert(static_cast<usize>(idx) == visited * 3);
+            ++visited;
+        }
+        psh_assert(visited == 334);
+
+        psh_assert(bit_array_rank(&bits, 0) == 0);
+        psh_assert(bit_array_rank(&bits, 1) == 1);
+        psh_assert(bit_array_rank(&bits, 64) == 22);
+        psh_assert(bit_array_rank(&bits, bit_count) == 334);
+        psh_assert(bit_array_select(&bits, 0) == 0);
+        psh_assert(bit_array_select(&bits, 100) == 300);
+        psh_assert(bit_array_select(&bits, 333) == 999);
+        psh_assert(bit_array_select(&bits, 334) == -1);
+
+        bit_array_clear(&bits, 999);
+        bit_array_toggle(&bits, 3);
+        bit_array_toggle(&bits, 4);
+        psh_assert(!bit_array_test(&bits, 999) && !bit_array_test(&bits, 3) && bit_array_test(&bits, 4));
+        psh_assert(bit_array_count_ones(&bits) == 333);
+
+        // The tail bits past the bit count should remain cleared.
+        BitArray others = make_bit_array(&arena, bit_count);
+        bit_array_fill(&others, true);
+        psh_assert(bit_array_count_ones(&others) == bit_count);
+        psh_assert(bit_array_find_next(&others, bit_count - 1) == static_cast<isize>(bit_count - 1));
+
+        bit_array_xor(&others, &bits);
+        psh_assert(bit_array_count_ones(&others) == bit_count - 333);
+        bit_array_and(&others, &bits);
+        psh_assert(bit_array_count_ones(&others) == 0);
+        bit_array_or(&others, &bits);
+        psh_assert(bit_array_count_ones(&others) == 333);
+        psh_assert(bit_array_test(&others, 4) && !bit_array_test(&others, 3));
+        bit_array_andnot(&others, &bits);
+        psh_assert(bit_array_count_ones(&others) == 0);
+
+        // The destination may be the source itself.
+        bit_array_or(&bits, &bits);
+        bit_array_and(&bits, &bits);
+        psh_assert(bit_array_count_ones(&bits) == 333);
+        bit_array_xor(&bits, &bits);
+        psh_assert(bit_array_count_ones(&bits) == 0);
+
+        report_test_successful();
+    }
+
+    psh_internal void bit_set_usage() {
+        BitSet<130> bits = {};
+        psh_assert(bits.word_count == 3);
+        psh_assert(bit_set_count_ones(&bits) == 0);
+
+        bit_set_set(&bits, 0);
+        bit_set_set(&bits, 64);
+        bit_set_set(&bits, 129);
+        psh_assert(bit_set_test(&bits, 64) && !bit_set_test(&bits, 65));
+        psh_assert(bit_set_find_next(&bits, 1) == 64);
+        psh_assert(bit_set_find_next(&bits, 65) == 129);
+        psh_assert(bit_set_find_next(&bits, 130) == -1);
+        psh_assert(bit_set_rank(&bits, 129) == 2);
+        psh_assert(bit_set_select(&bits, 2) == 129);
+
+        BitSet<130> all = {};
+        bit_set_fill(&all, true);
+        psh_assert(bit_set_count_ones(&all) == 130);
+        bit_set_andnot(&all, &bits);
+        psh_assert(bit_set_count_ones(&all) == 127);
+        bit_set_or(&all, &bits);
+        psh_assert(bit_set_count_ones(&all) == 130);
+        bit_set_xor(&all, &bits);
+        bit_set_and(&all, &bits);
+        psh_assert(bit_set_count_ones(&all) == 0);
+        bit_set_andnot(&bits, &bits);
+        psh_assert(bit_set_count_ones(&bits) == 0);
+        bit_set_set(&bits, 0);
+        bit_set_set(&bits, 64);
+        bit_set_set(&bits, 129);
+
+        bit_set_clear(&bits, 64);
+        bit_set_toggle(&bits, 1);
+        psh_assert(bit_set_count_ones(&bits) == 3);
+        bit_set_fill(&bits, false);
+        psh_assert(bit_set_find_next(&bits, 0) == -1);
+
+        report_test_successful();
+    }
+
     psh_internal void run_all() {
         MemoryManager memory_manager;
         memory_manager.init(10240);
@@ -294,10 +828,23 @@ namespace psh::test::containers {
         usage_push_buffer();
         usage_push_array();
         dynamic_array_push_elements(memory_manager);
+        dynamic_array_uninitialised_growth(memory_manager);
+        dynamic_array_resize_policies();
+        stable_array_push_and_pop();
         dynamic_array_count_and_capacity(memory_manager);
         dynamic_array_peek_and_pop(memory_manager);
         dynamic_array_remove(memory_manager);
         dynamic_array_clear(memory_manager);
+        hash_map_insert_and_find();
+        hash_map_remove_and_clear();
+        hash_map_string_keys();
+        slot_map_usage();
+        slot_map_generation_wrap_around();
+        raw_memory_operations();
+        raw_memory_fixed_size_operations();
+        raw_memory_non_temporal_operations();
+        bit_array_usage();
+        bit_set_usage();
     }
 }  // namespace psh::test::containers
 
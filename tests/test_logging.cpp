@@ -19,10 +19,15 @@
 /// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 /// SOFTWARE.
 ///
-/// Description: Tests for the system time interface.
+/// Description: Tests for the logging utilities.
 /// Author: Luiz G. Mugnaini A. <luizmuganini@gmail.com>
 
+#include <stdio.h>
 #include <psh_debug.hpp>
+#include <psh_log.hpp>
+#include <psh_streams.hpp>
+#include <psh_string.hpp>
+#include <psh_thread.hpp>
 #include "utils.hpp"
 
 // @TODO: can we programatically validate if the loggings are correct? Is it even worth it?
@@ -65,9 +70,201 @@ namespace psh::test::logging {
         report_test_successful();
     }
 
+    struct CapturedLog {
+        char  buf[256];
+        usize length;
+        u32   count;
+    };
+
+    psh_internal void capture_log(void* context, impl::LogInfo const& info, char const* msg, usize length) {
+        psh_discard_value(info);
+
+        CapturedLog* captured = reinterpret_cast<CapturedLog*>(context);
+        captured->length      = psh_min_value(length, psh_usize_of(captured->buf));
+        memory_copy(reinterpret_cast<u8*>(captured->buf), reinterpret_cast<u8 const*>(msg), captured->length);
+        ++captured->count;
+    }
+
+    psh_internal void custom_log_writer() {
+        CapturedLog captured = {};
+        set_log_writer(capture_log, &captured);
+        {
+            impl::log_msg(psh_impl_make_log_info(impl::LOG_LEVEL_INFO), "Not all those who wander are lost.");
+            impl::log_fmt(psh_impl_make_log_info(impl::LOG_LEVEL_INFO), "The %s that is strong does not wither.", "old");
+        }
+        set_log_writer(nullptr);
+
+        psh_assert(captured.count == 2);
+        String msg = String{captured.buf, captured.length};
+        psh_assert(string_find(msg, "The old that is strong does not wither.\n") >= 0);
+        psh_assert(msg[msg.count - 1u] == '\n');
+
+        report_test_successful();
+    }
+
+    constexpr cstring ASYNC_LOG_FILE_PATH      = "psh_test_async_log.txt";
+    constexpr u32     ASYNC_LOG_THREAD_COUNT   = 4;
+    constexpr u32     ASYNC_LOG_MSGS_PER_THREAD = 500;
+
+    psh_internal void async_log_producer(void* arg) {
+        u32 thread_idx = *reinterpret_cast<u32*>(arg);
+        for (u32 idx = 0; idx < ASYNC_LOG_MSGS_PER_THREAD; ++idx) {
+            impl::log_fmt(psh_impl_make_log_info(impl::LOG_LEVEL_INFO), "producer=%u message=%u", thread_idx, idx);
+        }
+    }
+
+    psh_internal void async_logger_multiple_producers() {
+        Arena arena = make_owned_arena(psh_mebibytes(1));
+        {
+            // A small buffer forces the records to wrap around and the producers to wait.
+            AsyncLogger logger;
+            psh_discard_value(remove(ASYNC_LOG_FILE_PATH));  // Discard leftovers of previous runs.
+            psh_assert(init_async_logger(&logger, &arena, ASYNC_LOG_FILE_PATH, psh_kibibytes(4)));
+
+            Thread threads[ASYNC_LOG_THREAD_COUNT];
+            u32    thread_indices[ASYNC_LOG_THREAD_COUNT];
+            for (u32 idx = 0; idx < ASYNC_LOG_THREAD_COUNT; ++idx) {
+                thread_indices[idx] = idx;
+                psh_assert(thread_create(&threads[idx], async_log_producer, &thread_indices[idx]));
+            }
+            for (u32 idx = 0; idx < ASYNC_LOG_THREAD_COUNT; ++idx) {
+                thread_join(&threads[idx]);
+            }
+
+            async_logger_flush(&logger);
+            destroy_async_logger(&logger);
+
+            // Every message is written whole, and the messages of each producer are kept in order.
+            FileReadResult result = read_file(&arena, ASYNC_LOG_FILE_PATH);
+            psh_assert(result.status == FILE_STATUS_OK);
+
+            u32 next_msg[ASYNC_LOG_THREAD_COUNT] = {};
+            u32 line_count                       = 0;
+
+            StringSplitter lines = make_string_splitter(make_string(FatPtr<u8 const>{result.content.buf, result.content.count}), '\n');
+            String         line;
+            while (string_split_next(&lines, &line)) {
+                if (line.count == 0) {
+                    continue;
+                }
+
+                isize found = string_find(line, "producer=");
+                psh_assert(found >= 0);
+
+                u32 thread_idx = 0;
+                u32 msg_idx    = 0;
+                psh_assert(sscanf(line.buf + found, "producer=%u message=%u", &thread_idx, &msg_idx) == 2);
+                psh_assert(thread_idx < ASYNC_LOG_THREAD_COUNT);
+                psh_assert(msg_idx == next_msg[thread_idx]);
+
+                ++next_msg[thread_idx];
+                ++line_count;
+            }
+            psh_assert(line_count == ASYNC_LOG_THREAD_COUNT * ASYNC_LOG_MSGS_PER_THREAD);
+        }
+        destroy_owned_arena(&arena);
+
+        psh_assert(remove(ASYNC_LOG_FILE_PATH) == 0);
+
+        report_test_successful();
+    }
+
+    constexpr cstring BINARY_LOG_FILE_PATH = "psh_test_binary_log.bin";
+
+    struct DecodedLogs {
+        DynamicString text;
+        u32           count;
+    };
+
+    psh_internal void collect_decoded_log(void* context, impl::LogInfo const& info, char const* msg, usize length) {
+        DecodedLogs* decoded = reinterpret_cast<DecodedLogs*>(context);
+        psh_assert(info.level < impl::LOG_LEVEL_COUNT);
+        psh_assert(dynamic_array_push_many(&decoded->text, FatPtr<char const>{msg, length}));
+        ++decoded->count;
+    }
+
+    psh_internal void binary_logging() {
+        Arena arena = make_owned_arena(psh_mebibytes(1));
+        {
+            psh_discard_value(remove(BINARY_LOG_FILE_PATH));  // Discard leftovers of previous runs.
+
+            // Without a binary logger, the calls are discarded.
+            psh_log_binary_info("Discarded %d.", 0);
+
+            AsyncLogger logger;
+            psh_assert(init_binary_logger(&logger, &arena, BINARY_LOG_FILE_PATH, BINARY_LOGGER_MIN_BUFFER_SIZE));
+            for (i32 idx = 0; idx < 3; ++idx) {
+                psh_log_binary_info("Ring %d of %u, forged by %s.", idx, 9u, "Sauron");
+            }
+            psh_log_binary_debug("The road goes ever on.");
+            psh_log_binary_warning("count=%zu ratio=%.2f letter=%c padded=[%5d] star=[%-*d]", usize{42}, 3.14159, 'Z', 12, 4, 7);
+            destroy_async_logger(&logger);
+
+            // A second session appended to the same file defines its call sites again.
+            psh_assert(init_binary_logger(&logger, &arena, BINARY_LOG_FILE_PATH, BINARY_LOGGER_MIN_BUFFER_SIZE));
+            psh_log_binary_info("Ring %d of %u, forged by %s.", 3, 9u, "Sauron");
+            psh_log_binary_error("Lost %llu of %lld.", 1ull, -1ll);
+            destroy_async_logger(&logger);
+
+            FileReadResult result = read_file(&arena, BINARY_LOG_FILE_PATH);
+            psh_assert(result.status == FILE_STATUS_OK);
+
+            DecodedLogs decoded = {.text = make_dynamic_string(&arena, 256), .count = 0};
+            psh_assert(binary_log_decode(&arena, FatPtr<u8 const>{result.content.buf, result.content.count}, collect_decoded_log, &decoded));
+            psh_assert(decoded.count == 7);
+
+            String text = make_string(decoded.text);
+            psh_assert(string_find(text, "[INFO] [") >= 0);
+            psh_assert(string_find(text, "test_logging.cpp:") >= 0);
+            psh_assert(string_find(text, "Ring 0 of 9, forged by Sauron.\n") >= 0);
+            psh_assert(string_find(text, "Ring 2 of 9, forged by Sauron.\n") >= 0);
+            psh_assert(string_find(text, "Ring 3 of 9, forged by Sauron.\n") >= 0);
+            psh_assert(string_find(text, "[DEBUG]") >= 0);
+            psh_assert(string_find(text, "The road goes ever on.\n") >= 0);
+            psh_assert(string_find(text, "count=42 ratio=3.14 letter=Z padded=[   12] star=[7   ]\n") >= 0);
+            psh_assert(string_find(text, "Lost 1 of -1.\n") >= 0);
+            psh_assert(string_find(text, "Discarded") < 0);
+
+            // A truncated record is reported.
+            FatPtr<u8 const> truncated = {result.content.buf, result.content.count - 1u};
+            decoded.count              = 0;
+            psh_assert(!binary_log_decode(&arena, truncated, collect_decoded_log, &decoded));
+            psh_assert(decoded.count == 6);
+
+            // A definition of a site with an absurd identifier is rejected without allocating a
+            // table of sites up to it.
+            u8  forged[64] = {};
+            u32 size       = 0;
+            u32 site_id    = (u32{1} << 31u) | 0x7FFFFFFFu;  // Site definition flag and identifier.
+            f64 timestamp  = 0.0;
+            memcpy(forged, BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+            size = sizeof(BINARY_LOG_MAGIC) + sizeof(size);
+            memcpy(forged + size, &site_id, sizeof(site_id));
+            size += sizeof(site_id);
+            memcpy(forged + size, &timestamp, sizeof(timestamp));
+            size += sizeof(timestamp) + sizeof(u8) + sizeof(u32) + 3u * sizeof(u16);  // Empty definition.
+            u32 record_size = size - static_cast<u32>(sizeof(BINARY_LOG_MAGIC));
+            memcpy(forged + sizeof(BINARY_LOG_MAGIC), &record_size, sizeof(record_size));
+
+            usize arena_offset = arena.offset;
+            decoded.count      = 0;
+            psh_assert(!binary_log_decode(&arena, FatPtr<u8 const>{forged, size}, collect_decoded_log, &decoded));
+            psh_assert(decoded.count == 0);
+            psh_assert(arena.offset - arena_offset < psh_kibibytes(4));
+        }
+        destroy_owned_arena(&arena);
+
+        psh_assert(remove(BINARY_LOG_FILE_PATH) == 0);
+
+        report_test_successful();
+    }
+
     psh_internal void run_all() {
         printing_to_console();
         formatted_printing();
+        custom_log_writer();
+        async_logger_multiple_producers();
+        binary_logging();
     }
 }  // namespace psh::test::logging
 
@@ -25,6 +25,7 @@
 /// This test should be ran with sanitizer flags on in order to detect possible memory leaks that
 /// may go unseen.
 
+#include <psh_defer.hpp>
 #include <psh_memory.hpp>
 #include "utils.hpp"
 
@@ -200,10 +201,120 @@ namespace psh::test::memory_manager {
         report_test_successful();
     }
 
+    psh_internal void general_allocator_backend() {
+        MemoryManager memory_manager;
+        memory_manager.init(psh_kibibytes(8), MemoryManagerBackend::TLSF, psh_kibibytes(64));
+        psh_defer(memory_manager.destroy());
+
+        MemoryManagerStats stats = memory_manager.stats();
+        psh_assert(stats.capacity == psh_kibibytes(8));
+        psh_assert(stats.reserved == psh_kibibytes(64));
+        psh_assert(stats.used_bytes == 0);
+
+        u64* a = memory_alloc<u64>(&memory_manager, 100);
+        u64* b = memory_alloc<u64>(&memory_manager, 200);
+        u64* c = memory_alloc<u64>(&memory_manager, 300);
+        psh_assert((a != nullptr) && (b != nullptr) && (c != nullptr));
+        psh_assert(memory_manager.allocation_count == 3);
+        c[299] = 42;
+
+        // Blocks can be freed in any order.
+        psh_assert(memory_free(&memory_manager, b));
+        psh_assert(memory_manager.allocation_count == 2);
+        u64* d = memory_alloc<u64>(&memory_manager, 150);
+        psh_assert(d == b);
+        psh_assert(memory_free(&memory_manager, a));
+        psh_assert(c[299] == 42);
+
+        stats = memory_manager.stats();
+        psh_assert(stats.allocation_count == 2);
+        psh_assert(stats.used_bytes >= (150 + 300) * sizeof(u64));
+        psh_assert(stats.peak_used_bytes >= (100 + 200 + 300) * sizeof(u64));
+
+        // Growing the manager doesn't move the blocks in use.
+        psh_assert(memory_manager.stats().largest_free_block < psh_kibibytes(16));
+        psh_assert(memory_manager.resize(psh_kibibytes(32)));
+        u8* large = memory_alloc<u8>(&memory_manager, psh_kibibytes(16));
+        psh_assert(large != nullptr);
+        large[psh_kibibytes(16) - 1] = 1;
+        psh_assert(c[299] == 42);
+        psh_assert(memory_manager.stats().capacity == psh_kibibytes(32));
+
+        // The capacity is bounded by the reserved memory and the memory in use.
+        psh_assert(!memory_manager.resize(psh_kibibytes(128)));
+        psh_assert(!memory_manager.resize(psh_kibibytes(8)));
+        psh_assert(memory_free(&memory_manager, large));
+        psh_assert(memory_manager.resize(psh_kibibytes(8)));
+
+        memory_manager.clear();
+        psh_assert(memory_manager.stats().used_bytes == 0);
+        psh_assert(memory_manager.allocation_count == 0);
+
+        report_test_successful();
+    }
+
+    psh_internal void stack_backend_resize_and_stats() {
+        MemoryManager memory_manager;
+        memory_manager.init(1024, MemoryManagerBackend::STACK, psh_kibibytes(16));
+        psh_defer(memory_manager.destroy());
+
+        u8* a = memory_alloc<u8>(&memory_manager, 512);
+        u8* b = memory_alloc<u8>(&memory_manager, 256);
+        psh_assert((a != nullptr) && (b != nullptr));
+
+        // Only the last block of a stack can be freed.
+        psh_assert(!memory_free(&memory_manager, a));
+        psh_assert(memory_free(&memory_manager, b));
+        psh_assert(memory_manager.allocation_count == 1);
+
+        MemoryManagerStats stats = memory_manager.stats();
+        psh_assert(stats.used_bytes == memory_manager.allocator.offset);
+        psh_assert(stats.peak_used_bytes >= 512 + 256);
+        psh_assert(stats.largest_free_block == 1024 - stats.used_bytes);
+
+        psh_assert(memory_manager.stats().largest_free_block < 4096);
+        psh_assert(memory_manager.resize(psh_kibibytes(8)));
+        u8* c = memory_alloc<u8>(&memory_manager, 4096);
+        psh_assert(c != nullptr);
+        c[4095] = 1;
+
+        psh_assert(!memory_manager.resize(1024));
+        psh_assert(memory_manager.pop());
+        psh_assert(memory_manager.resize(1024));
+        psh_assert(memory_manager.allocator.capacity == 1024);
+
+        report_test_successful();
+    }
+
+    psh_internal void prefaulted_general_backend() {
+        VirtualMemoryOptions options = {
+            .flags     = VIRTUAL_MEMORY_FLAG_TRANSPARENT_HUGE_PAGES | VIRTUAL_MEMORY_FLAG_PREFAULT,
+            .numa_node = 0,
+        };
+
+        MemoryManager memory_manager;
+        memory_manager.init(psh_kibibytes(64), MemoryManagerBackend::TLSF, psh_mebibytes(4), options);
+        psh_defer(memory_manager.destroy());
+        psh_assert(memory_manager.buf != nullptr);
+        psh_assert(memory_manager.commit_prefault);
+
+        // Memory committed by later resizes is faulted in as well.
+        psh_assert(memory_manager.resize(psh_mebibytes(1)));
+        u8* block = memory_alloc<u8>(&memory_manager, psh_kibibytes(512));
+        psh_assert(block != nullptr);
+        psh_assert(block[psh_kibibytes(512) - 1] == 0);
+        block[psh_kibibytes(512) - 1] = 7;
+
+        report_test_successful();
+    }
+
     psh_internal void run_all() {
         zeroed_at_initialisation();
         initialisation_and_shutdown();
         memory_statistics();
+        general_allocator_backend();
+        stack_backend_resize_and_stats();
+        prefaulted_general_backend();
     }
 }  // namespace psh::test::memory_manager
 
@@ -0,0 +1,286 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Tests for the networking module.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <string.h>
+#include <psh_memory.hpp>
+#include <psh_net.hpp>
+#include <psh_string.hpp>
+#include "utils.hpp"
+
+namespace psh::test::net {
+    /// Time after which a wait for a loopback socket is considered stuck.
+    psh_internal constexpr i32 WAIT_TIMEOUT_MS = 2000;
+
+    /// Wait until a single socket registered to the poller reports the expected events.
+    psh_internal u32 wait_single_event(NetPoller* poller, void* user_data) {
+        Buffer<NetEvent, 4> events;
+        u32                 count = net_poller_wait(poller, make_fat_ptr(&events), WAIT_TIMEOUT_MS);
+        psh_assert(count == 1);
+        psh_assert(events[0].user_data == user_data);
+        return events[0].flags;
+    }
+
+    psh_internal void address_parsing() {
+        NetAddress address;
+        psh_assert(net_address_parse(make_string("127.0.0.1"), 8080, &address));
+        psh_assert(net_address_port(&address) == 8080);
+
+        NetAddress loopback = make_net_address_ipv4(127, 0, 0, 1, 8080);
+        psh_assert((loopback.size == address.size) && (memcmp(loopback.storage, address.storage, address.size) == 0));
+
+        psh_assert(net_address_parse(make_string("::1"), 443, &address));
+        psh_assert(net_address_port(&address) == 443);
+        psh_assert(address.size > loopback.size);
+
+        // Only numeric addresses are accepted.
+        psh_assert(!net_address_parse(make_string("localhost"), 80, &address));
+        psh_assert(!net_address_parse(make_string("256.0.0.1"), 80, &address));
+        psh_assert(!net_address_parse(make_string(""), 80, &address));
+
+        report_test_successful();
+    }
+
+    psh_internal void tcp_loopback_exchange() {
+        Arena arena = make_owned_arena(psh_kibibytes(16));
+        psh_defer(destroy_owned_arena(&arena));
+
+        NetPoller poller;
+        psh_assert(init_net_poller(&poller, &arena, 4));
+        psh_defer(destroy_net_poller(&poller));
+
+        // Listen on any free port of the loopback interface.
+        NetAddress any_port = make_net_address_ipv4(127, 0, 0, 1, 0);
+        Socket     listener;
+        psh_assert(net_tcp_listen(&listener, &any_port));
+        psh_defer(net_close(&listener));
+
+        NetAddress listener_address;
+        psh_assert(net_local_address(&listener, &listener_address));
+        psh_assert(net_address_port(&listener_address) != 0);
+
+        Socket    client;
+        NetStatus connect_status = net_tcp_connect(&client, &listener_address);
+        psh_assert((connect_status == NET_STATUS_OK) || (connect_status == NET_STATUS_WOULD_BLOCK));
+        psh_defer(net_close(&client));
+
+        // The listener becomes readable once the connection is pending.
+        psh_assert(net_poller_add(&poller, &listener, NET_EVENT_READ, &listener));
+        psh_assert((wait_single_event(&poller, &listener) & NET_EVENT_READ) != 0);
+
+        Socket     server;
+        NetAddress peer_address;
+        psh_assert(net_tcp_accept(&listener, &server, &peer_address) == NET_STATUS_OK);
+        psh_defer(net_close(&server));
+        Socket no_connection;
+        psh_assert(net_tcp_accept(&listener, &no_connection) == NET_STATUS_WOULD_BLOCK);
+        psh_assert(net_poller_remove(&poller, &listener));
+
+        NetAddress client_address;
+        psh_assert(net_local_address(&client, &client_address));
+        psh_assert(net_address_port(&client_address) == net_address_port(&peer_address));
+
+        // The client becomes writable once connected.
+        psh_assert(net_poller_add(&poller, &client, NET_EVENT_WRITE, &client));
+        psh_assert((wait_single_event(&poller, &client) & NET_EVENT_WRITE) != 0);
+        psh_assert(net_tcp_finish_connect(&client));
+        psh_assert(net_tcp_set_no_delay(&client, true));
+        psh_assert(net_poller_modify(&poller, &client, NET_EVENT_READ, &client));
+
+        // Nothing has been sent yet.
+        Buffer<u8, 16> scratch;
+        usize          received_count;
+        psh_assert(net_receive(&server, make_fat_ptr(&scratch), &received_count) == NET_STATUS_WOULD_BLOCK);
+        psh_assert(received_count == 0);
+
+        String request = make_string(
+            "GET /index.html HTTP/1.1\r\n"
+            "Host: presheaf\r\n"
+            "User-Agent: test\n"
+            "\r\n");
+        usize sent_count;
+        psh_assert(net_send(&client, FatPtr<u8 const>{reinterpret_cast<u8 const*>(request.buf), request.count}, &sent_count) == NET_STATUS_OK);
+        psh_assert(sent_count == request.count);
+
+        // Buffers smaller than the request, so that lines straddle receives and the unconsumed
+        // bytes are moved to the start of the block.
+        Pool pool;
+        psh_assert(init_pool(&pool, &arena, 32, 8, 2));
+        psh_defer(destroy_pool(&pool));
+
+        NetBuffer buffer;
+        psh_assert(init_net_buffer(&buffer, &pool));
+        psh_assert(buffer.capacity == 32);
+
+        psh_assert(net_poller_add(&poller, &server, NET_EVENT_READ, &server));
+
+        Buffer<String, 4> expected_lines = {
+            make_string("GET /index.html HTTP/1.1"),
+            make_string("Host: presheaf"),
+            make_string("User-Agent: test"),
+            make_string(""),
+        };
+        usize line_count = 0;
+        while (line_count < expected_lines.count) {
+            NetStatus status = net_buffer_receive(&buffer, &server);
+            if (status == NET_STATUS_WOULD_BLOCK) {
+                psh_assert((wait_single_event(&poller, &server) & NET_EVENT_READ) != 0);
+                continue;
+            }
+            psh_assert(status == NET_STATUS_OK);
+
+            String line;
+            while (net_buffer_next_line(&buffer, &line)) {
+                psh_assert(line_count < expected_lines.count);
+                psh_assert(string_equal(line, expected_lines[line_count]));
+
+                // Lines are views into the block of the buffer, never copied.
+                psh_assert((reinterpret_cast<u8 const*>(line.buf) >= buffer.buf) && (reinterpret_cast<u8 const*>(line.buf) < buffer.buf + buffer.capacity));
+                ++line_count;
+            }
+        }
+        psh_assert(net_buffer_contents(&buffer).count == 0);
+
+        // A line longer than the buffer can't be received.
+        u8 long_line[40];
+        memory_set(long_line, psh_usize_of(long_line), 'a');
+        psh_assert(net_send(&client, FatPtr<u8 const>{long_line, psh_usize_of(long_line)}, &sent_count) == NET_STATUS_OK);
+        psh_assert((wait_single_event(&poller, &server) & NET_EVENT_READ) != 0);
+
+        NetStatus status = NET_STATUS_OK;
+        while (status == NET_STATUS_OK) {
+            status = net_buffer_receive(&buffer, &server);
+        }
+        psh_assert((status == NET_STATUS_BUFFER_FULL) || (status == NET_STATUS_WOULD_BLOCK));
+        if (status == NET_STATUS_WOULD_BLOCK) {
+            psh_assert((wait_single_event(&poller, &server) & NET_EVENT_READ) != 0);
+            psh_assert(net_buffer_receive(&buffer, &server) == NET_STATUS_BUFFER_FULL);
+        }
+        net_buffer_consume(&buffer, buffer.end - buffer.begin);
+
+        destroy_net_buffer(&buffer, &pool);
+        psh_assert(pool.free_count == pool.block_count);
+
+        // Closing the client is reported to the server as a hang up, with any remaining bytes
+        // received before the connection is reported as closed.
+        psh_assert(net_poller_remove(&poller, &client));
+        net_close(&client);
+
+        psh_assert((wait_single_event(&poller, &server) & (NET_EVENT_READ | NET_EVENT_HANG_UP)) != 0);
+        while (net_receive(&server, make_fat_ptr(&scratch), &received_count) == NET_STATUS_OK) {
+            psh_assert(received_count != 0);
+        }
+        psh_assert(net_receive(&server, make_fat_ptr(&scratch), &received_count) == NET_STATUS_CLOSED);
+        psh_assert(net_poller_remove(&poller, &server));
+
+        report_test_successful();
+    }
+
+    psh_internal void udp_batches() {
+        NetAddress any_port = make_net_address_ipv4(127, 0, 0, 1, 0);
+
+        Socket sender;
+        Socket receiver;
+        psh_assert(net_udp_open(&sender, &any_port));
+        psh_defer(net_close(&sender));
+        psh_assert(net_udp_open(&receiver, &any_port));
+        psh_defer(net_close(&receiver));
+
+        NetAddress sender_address;
+        NetAddress receiver_address;
+        psh_assert(net_local_address(&sender, &sender_address));
+        psh_assert(net_local_address(&receiver, &receiver_address));
+
+        // Nothing to be received yet.
+        Buffer<u8, 8 * 4>       storage;
+        Buffer<NetDatagram, 4> datagrams;
+        for (usize idx = 0; idx < datagrams.count; ++idx) {
+            datagrams[idx] = NetDatagram{.buf = &storage[8 * idx], .capacity = 8};
+        }
+        NetBatchResult result = net_udp_receive_batch(&receiver, make_fat_ptr(&datagrams));
+        psh_assert((result.count == 0) && (result.status == NET_STATUS_WOULD_BLOCK));
+
+        Buffer<String, 3>      payloads = {make_string("Mae"), make_string("govannen"), make_string("Elen sila lumenn")};
+        Buffer<NetDatagram, 3> outgoing;
+        for (usize idx = 0; idx < outgoing.count; ++idx) {
+            outgoing[idx] = NetDatagram{
+                .buf     = reinterpret_cast<u8*>(const_cast<char*>(payloads[idx].buf)),
+                .count   = payloads[idx].count,
+                .address = receiver_address,
+            };
+        }
+        result = net_udp_send_batch(&sender, make_const_fat_ptr(&outgoing));
+        psh_assert((result.count == 3) && (result.status == NET_STATUS_OK));
+
+        Arena arena = make_owned_arena(psh_kibibytes(4));
+        psh_defer(destroy_owned_arena(&arena));
+
+        NetPoller poller;
+        psh_assert(init_net_poller(&poller, &arena, 1));
+        psh_defer(destroy_net_poller(&poller));
+        psh_assert(net_poller_add(&poller, &receiver, NET_EVENT_READ, &receiver));
+        psh_assert((wait_single_event(&poller, &receiver) & NET_EVENT_READ) != 0);
+
+        // Datagrams may arrive a bit apart, even through the loopback interface.
+        u32 received_count = 0;
+        while (received_count < 3) {
+            result = net_udp_receive_batch(&receiver, FatPtr<NetDatagram>{&datagrams[received_count], datagrams.count - received_count});
+            if (result.status == NET_STATUS_WOULD_BLOCK) {
+                psh_assert((wait_single_event(&poller, &receiver) & NET_EVENT_READ) != 0);
+                continue;
+            }
+            psh_assert(result.status == NET_STATUS_OK);
+            received_count += result.count;
+        }
+        psh_assert(received_count == 3);
+
+        // The last payload doesn't fit its buffer and gets truncated.
+        for (usize idx = 0; idx < 3; ++idx) {
+            usize expected_count = psh_min_value(payloads[idx].count, usize{8});
+            psh_assert(datagrams[idx].count == expected_count);
+            psh_assert(memcmp(datagrams[idx].buf, payloads[idx].buf, expected_count) == 0);
+            psh_assert(net_address_port(&datagrams[idx].address) == net_address_port(&sender_address));
+        }
+
+        result = net_udp_receive_batch(&receiver, make_fat_ptr(&datagrams));
+        psh_assert((result.count == 0) && (result.status == NET_STATUS_WOULD_BLOCK));
+        psh_assert(net_poller_wait(&poller, FatPtr<NetEvent>{}, 0) == 0);
+
+        report_test_successful();
+    }
+
+    psh_internal void run_all() {
+        psh_assert(init_net());
+        address_parsing();
+        tcp_loopback_exchange();
+        udp_batches();
+        destroy_net();
+    }
+}  // namespace psh::test::net
+
+#if !defined(PSH_TEST_NOMAIN)
+int main() {
+    psh::test::net::run_all();
+    return 0;
+}
+#endif
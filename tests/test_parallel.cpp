@@ -0,0 +1,134 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Tests for the parallel algorithms.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <stdlib.h>  // For rand.
+#include <psh_defer.hpp>
+#include <psh_parallel.hpp>
+#include "utils.hpp"
+
+namespace psh::test::parallel {
+    psh_internal void square_chunk(FatPtr<u64> chunk, usize chunk_start, void* context) {
+        psh_discard_value(context);
+        for (usize idx = 0; idx < chunk.count; ++idx) {
+            psh_assert(chunk[idx] == chunk_start + idx);
+            chunk[idx] *= chunk[idx];
+        }
+    }
+
+    psh_internal u64 sum_chunk(FatPtr<u64 const> chunk, void* context) {
+        psh_discard_value(context);
+        u64 sum = 0;
+        for (usize idx = 0; idx < chunk.count; ++idx) {
+            sum += chunk[idx];
+        }
+        return sum;
+    }
+
+    psh_internal u64 add(u64 lhs, u64 rhs, void* context) {
+        psh_discard_value(context);
+        return lhs + rhs;
+    }
+
+    psh_internal void parallel_for_and_reduce(JobSystem* job_system, Arena* arena) {
+        ScratchArena scratch{arena};
+
+        constexpr usize COUNT = 50000;
+
+        u64* values = memory_alloc<u64>(scratch.arena, COUNT);
+        for (usize idx = 0; idx < COUNT; ++idx) {
+            values[idx] = idx;
+        }
+
+        // Use small chunks so that the work is spread among many jobs.
+        parallel_for(job_system, FatPtr<u64>{values, COUNT}, square_chunk, nullptr, 1024);
+        for (usize idx = 0; idx < COUNT; ++idx) {
+            psh_assert(values[idx] == idx * idx);
+        }
+
+        u64 sum = parallel_reduce(job_system, FatPtr<u64 const>{values, COUNT}, u64{0}, sum_chunk, add, nullptr, 1024);
+        psh_assert(sum == ((COUNT - 1) * COUNT * (2 * COUNT - 1)) / 6);
+
+        u64 empty_sum = parallel_reduce(job_system, FatPtr<u64 const>{values, 0}, u64{0}, sum_chunk, add, nullptr);
+        psh_assert(empty_sum == 0);
+
+        report_test_successful();
+    }
+
+    psh_internal void parallel_sort(JobSystem* job_system, Arena* arena) {
+        ScratchArena scratch{arena};
+
+        constexpr usize COUNT = 100003;
+
+        u32*        values = memory_alloc<u32>(scratch.arena, COUNT);
+        FatPtr<u32> data   = {values, COUNT};
+
+        // Random.
+        for (usize idx = 0; idx < COUNT; ++idx) {
+            values[idx] = static_cast<u32>(rand());
+        }
+        psh_assert(psh::parallel_sort(job_system, scratch.arena, data));
+        for (usize idx = 0; idx + 1 < COUNT; ++idx) {
+            psh_assert(values[idx] <= values[idx + 1]);
+        }
+
+        // Already sorted and reverse sorted.
+        for (usize idx = 0; idx < COUNT; ++idx) {
+            values[idx] = static_cast<u32>(idx);
+        }
+        psh_assert(psh::parallel_sort(job_system, scratch.arena, data));
+        for (usize idx = 0; idx < COUNT; ++idx) {
+            psh_assert(values[idx] == idx);
+        }
+
+        for (usize idx = 0; idx < COUNT; ++idx) {
+            values[idx] = static_cast<u32>(COUNT - idx);
+        }
+        psh_assert(psh::parallel_sort(job_system, scratch.arena, data));
+        for (usize idx = 0; idx < COUNT; ++idx) {
+            psh_assert(values[idx] == idx + 1);
+        }
+
+        report_test_successful();
+    }
+
+    psh_internal void run_all() {
+        Arena arena = make_owned_arena(psh_mebibytes(8));
+        psh_defer(destroy_owned_arena(&arena));
+
+        JobSystem job_system;
+        psh_assert(init_job_system(&job_system, &arena, 4, psh_kibibytes(64), 256));
+
+        parallel_for_and_reduce(&job_system, &arena);
+        parallel_sort(&job_system, &arena);
+
+        destroy_job_system(&job_system);
+    }
+}  // namespace psh::test::parallel
+
+#if !defined(PSH_TEST_NOMAIN)
+int main() {
+    psh::test::parallel::run_all();
+    return 0;
+}
+#endif
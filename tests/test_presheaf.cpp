@@ -47,7 +47,13 @@
 #include "test_string.cpp"
 #include "test_algorithms.cpp"
 #include "test_time.cpp"
+#include "test_streams.cpp"
+#include "test_serialize.cpp"
+#include "test_net.cpp"
 #include "test_logging.cpp"
+#include "test_thread.cpp"
+#include "test_parallel.cpp"
+#include "test_profile.cpp"
 // clang-format on
 
 int main() {
@@ -61,6 +67,12 @@ int main() {
     psh::test::string::run_all();
     psh::test::algorithms::run_all();
     psh::test::time::run_all();
+    psh::test::streams::run_all();
+    psh::test::serialize::run_all();
+    psh::test::net::run_all();
     psh::test::logging::run_all();
+    psh::test::thread::run_all();
+    psh::test::parallel::run_all();
+    psh::test::profile::run_all();
     return 0;
 }
@@ -0,0 +1,200 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+///
+/// Description: Tests for the profiling zones and the Chrome trace export.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <stdio.h>
+#include <psh_profile.hpp>
+#include <psh_streams.hpp>
+#include <psh_string.hpp>
+#include <psh_thread.hpp>
+#include "utils.hpp"
+
+namespace psh::test::profile {
+    psh_internal constexpr cstring TEST_TRACE_PATH = "psh_test_profile.json";
+
+    // Registered threads keep referencing their event buffers, so the profiler memory should live
+    // for the whole program.
+    psh_global u8    profiler_memory[4096];
+    psh_global Arena profiler_arena = {.buf = profiler_memory, .capacity = sizeof(profiler_memory)};
+
+    psh_internal void record_worker_zones(void* arg) {
+        psh_discard_value(arg);
+        psh_assert(profile_register_thread(&profiler_arena, 8, "worker \"one\""));
+
+        ProfileZone zone = profile_zone_begin("worker_zone");
+        profile_zone_end(zone);
+    }
+
+    psh_internal void record_short_lived_thread_zones(void* arg) {
+        ProfileThreadBuffer** buffer = reinterpret_cast<ProfileThreadBuffer**>(arg);
+        psh_assert(profile_register_thread(&profiler_arena, 8, "short lived"));
+        *buffer = profile_thread_buffer();
+
+        profile_zone_end(profile_zone_begin("short_lived_zone"));
+        profile_unregister_thread();
+        psh_assert(profile_thread_buffer() == nullptr);
+    }
+
+    psh_internal void record_large_thread_zones(void* arg) {
+        ProfileThreadBuffer** buffer = reinterpret_cast<ProfileThreadBuffer**>(arg);
+        psh_assert(profile_register_thread(&profiler_arena, 16));
+        *buffer = profile_thread_buffer();
+        profile_unregister_thread();
+    }
+
+    psh_internal void timer_frequencies() {
+        u64 frequency = cpu_timestamp_frequency();
+        psh_assert(frequency > 0);
+        psh_assert(cpu_timestamp_frequency() == frequency);
+        psh_assert(os_timer_frequency() > 0);
+
+        u64 os_begin  = os_timer_ticks();
+        u64 cpu_begin = cpu_timestamp_counter();
+        sleep_milliseconds(2.0);
+        u64 os_elapsed  = os_timer_ticks() - os_begin;
+        u64 cpu_elapsed = cpu_timestamp_counter() - cpu_begin;
+
+        f64 os_seconds  = ticks_to_seconds(os_elapsed, os_timer_frequency());
+        f64 cpu_seconds = ticks_to_seconds(cpu_elapsed, frequency);
+        psh_assert(os_seconds >= 0.001);
+        psh_assert(cpu_seconds >= 0.001);
+        psh_assert(ticks_to_nanoseconds(frequency, frequency) == 1e9);
+
+        report_test_successful();
+    }
+
+    psh_internal void zones_are_kept_in_a_ring_buffer() {
+        // Zones of unregistered threads are discarded.
+        psh_assert(profile_thread_buffer() == nullptr);
+        profile_zone_end(profile_zone_begin("discarded"));
+
+        psh_assert(profile_register_thread(&profiler_arena, 4, "main"));
+        ProfileThreadBuffer const* buffer = profile_thread_buffer();
+        psh_assert(buffer != nullptr);
+
+        cstring names[] = {"zone_0", "zone_1", "zone_2", "zone_3", "zone_4", "zone_5"};
+        for (usize idx = 0; idx < count_of(names); ++idx) {
+            ProfileZone zone = profile_zone_begin(names[idx]);
+            profile_zone_end(zone);
+        }
+
+        psh_assert(buffer->count == 6);
+        psh_assert(buffer->events[0].name == names[4]);
+        psh_assert(buffer->events[1].name == names[5]);
+        psh_assert(buffer->events[2].name == names[2]);
+        psh_assert(buffer->events[3].name == names[3]);
+        for (usize idx = 0; idx < 4; ++idx) {
+            psh_assert(buffer->events[idx].begin <= buffer->events[idx].end);
+        }
+
+        profile_clear_thread();
+        psh_assert(buffer->count == 0);
+
+        {
+            psh_profile_scope(outer);
+            psh_profile_begin(inner);
+            psh_profile_end(inner);
+        }
+#if PSH_ENABLE_PROFILING
+        psh_assert(buffer->count == 2);
+        psh_assert(string_equal(make_string(buffer->events[0].name), psh_comptime_make_string("inner")));
+        psh_assert(string_equal(make_string(buffer->events[1].name), psh_comptime_make_string("outer")));
+#else
+        psh_assert(buffer->count == 0);
+#endif
+
+        report_test_successful();
+    }
+
+    psh_internal void chrome_trace_export() {
+        Thread worker;
+        psh_assert(thread_create(&worker, record_worker_zones, nullptr));
+        thread_join(&worker);
+
+        ProfileZone zone = profile_zone_begin("main_zone");
+        profile_zone_end(zone);
+
+        Arena arena = make_owned_arena(psh_kibibytes(128));
+        {
+            psh_assert(profile_write_chrome_trace(&arena, TEST_TRACE_PATH));
+
+            FileReadResult trace = read_file(&arena, TEST_TRACE_PATH);
+            psh_assert(trace.status == FILE_STATUS_OK);
+
+            String text = String{reinterpret_cast<cstring>(trace.content.buf), trace.content.count};
+            psh_assert(string_find(text, "{\"traceEvents\":[") == 0);
+            psh_assert(string_find(text, "\"name\":\"main_zone\",\"ph\":\"X\"") != -1);
+            psh_assert(string_find(text, "\"name\":\"worker_zone\",\"ph\":\"X\"") != -1);
+            psh_assert(string_find(text, "\"args\":{\"name\":\"worker \\\"one\\\"\"}") != -1);
+            psh_assert(string_find(text, "\"args\":{\"name\":\"main\"}") != -1);
+            psh_assert(string_find(text, "\"displayTimeUnit\":\"ns\"}") != -1);
+        }
+        destroy_owned_arena(&arena);
+        psh_assert(remove(TEST_TRACE_PATH) == 0);
+
+        report_test_successful();
+    }
+
+    psh_internal void unregistered_buffers_are_reused() {
+        usize arena_offset = profiler_arena.offset;
+
+        // Threads that come and go take turns with the same buffer.
+        ProfileThreadBuffer* buffers[3] = {};
+        for (usize idx = 0; idx < count_of(buffers); ++idx) {
+            Thread worker;
+            psh_assert(thread_create(&worker, record_short_lived_thread_zones, &buffers[idx]));
+            thread_join(&worker);
+
+            psh_assert(buffers[idx] != nullptr);
+            psh_assert(buffers[idx] == buffers[0]);
+            psh_assert(buffers[idx]->count == 1);
+        }
+        psh_assert(profiler_arena.offset > arena_offset);
+        arena_offset = profiler_arena.offset;
+
+        // A released buffer that is too small isn't reused.
+        ProfileThreadBuffer* large_buffer = nullptr;
+        Thread               worker;
+        psh_assert(thread_create(&worker, record_large_thread_zones, &large_buffer));
+        thread_join(&worker);
+        psh_assert((large_buffer != nullptr) && (large_buffer != buffers[0]));
+        psh_assert(profiler_arena.offset > arena_offset);
+
+        report_test_successful();
+    }
+
+    psh_internal void run_all() {
+        timer_frequencies();
+        zones_are_kept_in_a_ring_buffer();
+        chrome_trace_export();
+        unregistered_buffers_are_reused();
+    }
+}  // namespace psh::test::profile
+
+#if !defined(PSH_TEST_NOMAIN)
+int main() {
+    psh::test::profile::run_all();
+    return 0;
+}
+#endif
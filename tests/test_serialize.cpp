@@ -0,0 +1,191 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+///
+/// Description: Tests for the serialization of containers and arenas.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <stdio.h>
+#include <string.h>
+#include <psh_serialize.hpp>
+#include "utils.hpp"
+
+namespace psh::test::serialize {
+    psh_internal constexpr cstring TEST_FILE_PATH = "psh_test_serialize.bin";
+
+    struct Record {
+        u32 id;
+        f32 score;
+    };
+
+    psh_internal void containers_round_trip() {
+        Arena arena = make_owned_arena(psh_mebibytes(1));
+        psh_defer(destroy_owned_arena(&arena));
+
+        Array<u64> squares = make_array<u64>(&arena, 1000);
+        for (usize idx = 0; idx < squares.count; ++idx) {
+            squares[idx] = idx * idx;
+        }
+
+        DynamicArray<Record> records = make_dynamic_array<Record>(&arena);
+        for (u32 idx = 0; idx < 37; ++idx) {
+            psh_assert(dynamic_array_push(&records, Record{idx, static_cast<f32>(idx) * 0.5f}));
+        }
+
+        HashMap<u32, u32> doubles = make_hash_map<u32, u32>(&arena);
+        for (u32 idx = 0; idx < 500; ++idx) {
+            psh_assert(hash_map_insert(&doubles, idx, 2u * idx));
+        }
+        psh_assert(hash_map_remove(&doubles, 7u));
+
+        // Snapshot of an arena whose contents refer to each other via offsets.
+        Arena snapshot = make_owned_arena(1024);
+        psh_defer(destroy_owned_arena(&snapshot));
+        u32* offsets = memory_alloc<u32>(&snapshot, 2);
+        u8*  text    = memory_alloc<u8>(&snapshot, 6);
+        memory_copy(text, reinterpret_cast<u8 const*>("hello"), 6);
+        offsets[0] = static_cast<u32>(text - snapshot.buf);
+        offsets[1] = 5;
+
+        {
+            SerialWriter writer;
+            init_serial_writer(&writer, &arena);
+            serial_writer_add_array(&writer, make_string("squares"), &squares);
+            serial_writer_add_array(&writer, make_string("records"), &records);
+            serial_writer_add_array(&writer, make_string("empty"), FatPtr<u8 const>{});
+            serial_writer_add_hash_map(&writer, make_string("doubles"), &doubles);
+            serial_writer_add_arena(&writer, make_string("snapshot"), &snapshot);
+            psh_assert(write_serial_file(&writer, &arena, TEST_FILE_PATH) == SERIAL_STATUS_OK);
+        }
+
+        SerialFile file;
+        psh_assert(open_serial_file(&file, TEST_FILE_PATH, SERIAL_OPEN_FLAG_VERIFY_CONTENTS) == SERIAL_STATUS_OK);
+        psh_assert(file.header->section_count == 5);
+
+        // Contents are used in place, straight from the mapped file.
+        FatPtr<u64 const> loaded_squares;
+        psh_assert(serial_file_get_array(&file, make_string("squares"), &loaded_squares));
+        psh_assert(loaded_squares.count == squares.count);
+        psh_assert(memcmp(loaded_squares.buf, squares.buf, squares.count * sizeof(u64)) == 0);
+        psh_assert(reinterpret_cast<uptr>(loaded_squares.buf) % SERIAL_SECTION_ALIGNMENT == 0);
+
+        FatPtr<Record const> loaded_records;
+        psh_assert(serial_file_get_array(&file, make_string("records"), &loaded_records));
+        psh_assert(loaded_records.count == 37);
+        psh_assert((loaded_records[36].id == 36) && (loaded_records[36].score == 18.0f));
+
+        FatPtr<u8 const> empty;
+        psh_assert(serial_file_get_array(&file, make_string("empty"), &empty));
+        psh_assert(empty.count == 0);
+
+        HashMap<u32, u32> loaded_doubles;
+        psh_assert(serial_file_get_hash_map(&file, make_string("doubles"), &loaded_doubles));
+        psh_assert(loaded_doubles.count == 499);
+        HashMap<u32, u32> const* doubles_view = &loaded_doubles;
+        for (u32 idx = 0; idx < 500; ++idx) {
+            u32 const* value = hash_map_find(doubles_view, idx);
+            psh_assert((idx == 7) ? (value == nullptr) : ((value != nullptr) && (*value == 2u * idx)));
+        }
+        psh_assert(!hash_map_contains(doubles_view, 1000u));
+
+        FatPtr<u8 const> loaded_snapshot;
+        psh_assert(serial_file_get_arena(&file, make_string("snapshot"), &loaded_snapshot));
+        psh_assert(loaded_snapshot.count == snapshot.offset);
+        u32 const* loaded_offsets = reinterpret_cast<u32 const*>(loaded_snapshot.buf);
+        psh_assert(memcmp(loaded_snapshot.buf + loaded_offsets[0], "hello", loaded_offsets[1]) == 0);
+
+        // Sections are only found by their exact name, kind and element size.
+        FatPtr<u32 const> wrong_type;
+        psh_assert(serial_file_find_section(&file, make_string("missing")) == nullptr);
+        psh_assert(!serial_file_get_array(&file, make_string("squares"), &wrong_type));
+        psh_assert(!serial_file_get_array(&file, make_string("doubles"), &wrong_type));
+
+        close_serial_file(&file);
+        psh_assert(remove(TEST_FILE_PATH) == 0);
+
+        report_test_successful();
+    }
+
+    psh_internal void write_bytes(u8 const* bytes, usize size) {
+        FILE* stream = fopen(TEST_FILE_PATH, "wb");
+        psh_assert(stream != nullptr);
+        psh_assert(fwrite(bytes, 1, size, stream) == size);
+        psh_assert(fclose(stream) == 0);
+    }
+
+    psh_internal void invalid_and_corrupted_files() {
+        Arena arena = make_owned_arena(psh_kibibytes(256));
+        psh_defer(destroy_owned_arena(&arena));
+
+        Array<u32> values = make_array<u32>(&arena, 256);
+        for (u32 idx = 0; idx < values.count; ++idx) {
+            values[idx] = idx;
+        }
+
+        SerialWriter writer;
+        init_serial_writer(&writer, &arena);
+        serial_writer_add_array(&writer, make_string("values"), &values);
+        psh_assert(write_serial_file(&writer, &arena, TEST_FILE_PATH) == SERIAL_STATUS_OK);
+
+        FileReadResult original = read_file(&arena, TEST_FILE_PATH);
+        psh_assert(original.status == FILE_STATUS_OK);
+
+        SerialFile file;
+
+        // Flipping a byte of the contents is only caught when verifying them.
+        original.content[original.content.count - 1] ^= 0xFF;
+        write_bytes(original.content.buf, original.content.count);
+        psh_assert(open_serial_file(&file, TEST_FILE_PATH) == SERIAL_STATUS_OK);
+        psh_assert(!serial_file_verify_section(&file, serial_file_find_section(&file, make_string("values"))));
+        close_serial_file(&file);
+        psh_assert(open_serial_file(&file, TEST_FILE_PATH, SERIAL_OPEN_FLAG_VERIFY_CONTENTS) == SERIAL_STATUS_CORRUPTED);
+        original.content[original.content.count - 1] ^= 0xFF;
+
+        // Damaged directories and truncated files are always rejected.
+        original.content[sizeof(SerialHeader) + 1] ^= 0xFF;
+        write_bytes(original.content.buf, original.content.count);
+        psh_assert(open_serial_file(&file, TEST_FILE_PATH) == SERIAL_STATUS_INVALID_FORMAT);
+        original.content[sizeof(SerialHeader) + 1] ^= 0xFF;
+
+        write_bytes(original.content.buf, original.content.count - 4);
+        psh_assert(open_serial_file(&file, TEST_FILE_PATH) == SERIAL_STATUS_INVALID_FORMAT);
+
+        write_bytes(reinterpret_cast<u8 const*>("not a serialized file"), 21);
+        psh_assert(open_serial_file(&file, TEST_FILE_PATH) == SERIAL_STATUS_INVALID_FORMAT);
+
+        psh_assert(remove(TEST_FILE_PATH) == 0);
+        psh_assert(open_serial_file(&file, TEST_FILE_PATH) == SERIAL_STATUS_FAILED_TO_OPEN);
+
+        report_test_successful();
+    }
+
+    psh_internal void run_all() {
+        containers_round_trip();
+        invalid_and_corrupted_files();
+    }
+}  // namespace psh::test::serialize
+
+#if !defined(PSH_TEST_NOMAIN)
+int main() {
+    psh::test::serialize::run_all();
+    return 0;
+}
+#endif
@@ -0,0 +1,308 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Tests for the file stream utilities.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <stdio.h>
+#include <string.h>
+#include <psh_streams.hpp>
+#include "utils.hpp"
+
+namespace psh::test::streams {
+    psh_internal constexpr cstring TEST_FILE_PATH = "psh_test_streams.txt";
+
+    psh_internal void write_test_file(String contents) {
+        FILE* file = fopen(TEST_FILE_PATH, "wb");
+        psh_assert(file != nullptr);
+        if (contents.count != 0) {
+            psh_assert(fwrite(contents.buf, 1, contents.count, file) == contents.count);
+        }
+        psh_assert(fclose(file) == 0);
+    }
+
+    psh_internal void mapped_file_matches_read_file() {
+        String contents = psh_comptime_make_string(
+            "Even the very wise cannot see all ends.\n"
+            "All we have to decide is what to do with the time that is given to us.\n");
+        write_test_file(contents);
+
+        Arena arena = make_owned_arena(1024);
+        {
+            FileReadResult read = read_file(&arena, TEST_FILE_PATH);
+            psh_assert(read.status == FILE_STATUS_OK);
+
+            FileMapResult mapped = map_file(TEST_FILE_PATH, MAP_FILE_HINT_SEQUENTIAL | MAP_FILE_HINT_WILL_NEED);
+            psh_assert(mapped.status == FILE_STATUS_OK);
+            psh_assert(mapped.content.count == read.content.count);
+            psh_assert(memcmp(mapped.content.buf, read.content.buf, read.content.count) == 0);
+
+            // The mapped contents can be parsed directly as a string.
+            String text = make_string(mapped.content);
+            psh_assert(string_equal(text, contents));
+            psh_assert(string_find(text, "time") == 85);
+
+            Array<String> lines = string_split(&arena, text, '\n');
+            psh_assert(lines.count == 3);
+            psh_assert(string_equal(lines[0], "Even the very wise cannot see all ends."));
+            psh_assert(lines[2].count == 0);
+
+            unmap_file(mapped.content);
+        }
+        destroy_owned_arena(&arena);
+
+        psh_assert(remove(TEST_FILE_PATH) == 0);
+
+        report_test_successful();
+    }
+
+    psh_internal void map_empty_and_missing_files() {
+        write_test_file(String{});
+
+        FileMapResult empty = map_file(TEST_FILE_PATH);
+        psh_assert(empty.status == FILE_STATUS_OK);
+        psh_assert(empty.content.count == 0);
+        unmap_file(empty.content);
+
+        psh_assert(remove(TEST_FILE_PATH) == 0);
+
+        FileMapResult missing = map_file(TEST_FILE_PATH);
+        psh_assert(missing.status == FILE_STATUS_FAILED_TO_OPEN);
+
+        report_test_successful();
+    }
+
+    psh_internal void buffered_writer_and_streaming_reader() {
+        Arena arena = make_owned_arena(psh_kibibytes(64));
+
+        // Write lines of increasing length, some longer than the reader buffer.
+        constexpr usize READER_BUFFER_SIZE = 32;
+        constexpr usize LINE_COUNT         = 100;
+
+        Buffer<u32, 2> writer_flags = {FILE_WRITER_FLAG_NONE, FILE_WRITER_FLAG_DIRECT};
+        for (u32 flags : writer_flags) {
+            ArenaCheckpoint checkpoint = make_arena_checkpoint(&arena);
+
+            usize expected_size = 0;
+            {
+                FileWriter writer;
+                psh_assert(open_file_writer(&writer, &arena, TEST_FILE_PATH, 64, flags) == FILE_STATUS_OK);
+
+                char line[LINE_COUNT + 1];
+                for (usize idx = 0; idx < LINE_COUNT; ++idx) {
+                    for (usize c = 0; c < idx; ++c) {
+                        line[c] = static_cast<char>('a' + (idx % 26));
+                    }
+                    line[idx] = '\n';
+                    psh_assert(file_writer_write(&writer, String{line, idx + 1u}));
+                    expected_size += idx + 1u;
+                }
+                psh_assert(file_writer_flush(&writer));
+                psh_assert(close_file_writer(&writer));
+            }
+
+            FileReadResult read = read_file(&arena, TEST_FILE_PATH);
+            psh_assert(read.status == FILE_STATUS_OK);
+            psh_assert(read.content.count == expected_size);
+
+            // Chunks cover the whole file.
+            {
+                FileReader reader;
+                psh_assert(open_file_reader(&reader, &arena, TEST_FILE_PATH, READER_BUFFER_SIZE) == FILE_STATUS_OK);
+
+                usize            offset = 0;
+                FatPtr<u8 const> chunk;
+                while (file_reader_next_chunk(&reader, &chunk)) {
+                    psh_assert(chunk.count <= READER_BUFFER_SIZE);
+                    psh_assert(memcmp(chunk.buf, read.content.buf + offset, chunk.count) == 0);
+                    offset += chunk.count;
+                }
+                psh_assert(reader.status == FILE_STATUS_OK);
+                psh_assert(offset == expected_size);
+
+                close_file_reader(&reader);
+            }
+
+            // Lines fitting the buffer are yielded whole, longer ones in buffer sized pieces.
+            {
+                FileReader reader;
+                psh_assert(open_file_reader(&reader, &arena, TEST_FILE_PATH, READER_BUFFER_SIZE) == FILE_STATUS_OK);
+
+                String line;
+                for (usize idx = 0; idx < LINE_COUNT; ++idx) {
+                    usize remaining = idx;
+                    do {
+                        psh_assert(file_reader_next_line(&reader, &line));
+                        usize expected = (remaining >= READER_BUFFER_SIZE) ? READER_BUFFER_SIZE : remaining;
+                        psh_assert(line.count == expected);
+                        for (char c : line) {
+                            psh_assert(c == static_cast<char>('a' + (idx % 26)));
+                        }
+                        remaining -= expected;
+                    } while (line.count == READER_BUFFER_SIZE);
+                }
+                psh_assert(!file_reader_next_line(&reader, &line));
+                psh_assert(reader.status == FILE_STATUS_OK);
+
+                close_file_reader(&reader);
+            }
+
+            arena_checkpoint_restore(checkpoint);
+        }
+
+        // Appending and records without a trailing delimiter.
+        {
+            FileWriter writer;
+            psh_assert(open_file_writer(&writer, &arena, TEST_FILE_PATH, 16) == FILE_STATUS_OK);
+            psh_assert(file_writer_write(&writer, psh_comptime_make_string("Frodo;Sam")));
+            psh_assert(close_file_writer(&writer));
+
+            psh_assert(open_file_writer(&writer, &arena, TEST_FILE_PATH, 16, FILE_WRITER_FLAG_APPEND) == FILE_STATUS_OK);
+            psh_assert(file_writer_write(&writer, psh_comptime_make_string(";Merry;Pippin")));
+            psh_assert(close_file_writer(&writer));
+
+            u8         buf[8];
+            FileReader reader;
+            psh_assert(open_file_reader(&reader, TEST_FILE_PATH, buf, psh_usize_of(buf)) == FILE_STATUS_OK);
+
+            FatPtr<u8 const> record;
+            psh_assert(file_reader_next_record(&reader, ';', &record) && string_equal(make_string(record), "Frodo"));
+            psh_assert(file_reader_next_record(&reader, ';', &record) && string_equal(make_string(record), "Sam"));
+            psh_assert(file_reader_next_record(&reader, ';', &record) && string_equal(make_string(record), "Merry"));
+            psh_assert(file_reader_next_record(&reader, ';', &record) && string_equal(make_string(record), "Pippin"));
+            psh_assert(!file_reader_next_record(&reader, ';', &record));
+
+            close_file_reader(&reader);
+        }
+
+        destroy_owned_arena(&arena);
+        psh_assert(remove(TEST_FILE_PATH) == 0);
+
+        report_test_successful();
+    }
+
+    psh_internal void asynchronous_reads_and_writes() {
+        constexpr usize CHUNK_SIZE  = 1024;
+        constexpr u32   CHUNK_COUNT = 24;
+        constexpr u32   QUEUE_DEPTH = 8;
+
+        Arena arena = make_owned_arena(psh_kibibytes(128));
+        {
+            AsyncIo io;
+            psh_assert(init_async_io(&io, &arena, QUEUE_DEPTH));
+
+            u8* data = memory_alloc<u8>(&arena, CHUNK_SIZE * CHUNK_COUNT);
+            for (usize idx = 0; idx < CHUNK_SIZE * CHUNK_COUNT; ++idx) {
+                data[idx] = static_cast<u8>((idx * 7u) ^ (idx >> 8u));
+            }
+
+            Buffer<AsyncIoCompletion, QUEUE_DEPTH> completions;
+
+            // Write the chunks in batches, never exceeding the queue depth.
+            {
+                AsyncFile file;
+                psh_assert(async_io_open_file(&io, &file, TEST_FILE_PATH, ASYNC_FILE_MODE_WRITE) == FILE_STATUS_OK);
+
+                u32 next_chunk = 0;
+                u32 written    = 0;
+                while (written < CHUNK_COUNT) {
+                    while ((next_chunk < CHUNK_COUNT) && (async_io_pending_count(&io) < QUEUE_DEPTH)) {
+                        u8 const* chunk = data + next_chunk * CHUNK_SIZE;
+                        psh_assert(async_io_write(&io, &file, chunk, CHUNK_SIZE, next_chunk * CHUNK_SIZE, nullptr));
+                        ++next_chunk;
+                    }
+
+                    u32 count = async_io_wait(&io, make_fat_ptr(&completions), 1);
+                    psh_assert(count >= 1);
+                    for (u32 idx = 0; idx < count; ++idx) {
+                        psh_assert(completions[idx].operation == ASYNC_IO_OPERATION_WRITE);
+                        psh_assert(completions[idx].result == static_cast<isize>(CHUNK_SIZE));
+                    }
+                    written += count;
+                }
+
+                psh_assert(async_io_pending_count(&io) == 0);
+                async_io_close_file(&file);
+            }
+
+            // Queue a full batch of reads, the last one reaching past the end of the file.
+            {
+                AsyncFile file;
+                psh_assert(async_io_open_file(&io, &file, TEST_FILE_PATH, ASYNC_FILE_MODE_READ) == FILE_STATUS_OK);
+
+                u32 chunk_indices[QUEUE_DEPTH];
+                for (u32 idx = 0; idx < QUEUE_DEPTH; ++idx) {
+                    chunk_indices[idx] = idx * 3u;
+                    psh_assert(async_io_read_to_arena(&io, &arena, &file, CHUNK_SIZE, chunk_indices[idx] * CHUNK_SIZE, &chunk_indices[idx]));
+                }
+
+                // The queue is full until completions are harvested.
+                u8 extra[16];
+                psh_assert(!async_io_read(&io, &file, extra, psh_usize_of(extra), 0, nullptr));
+
+                psh_assert(async_io_submit(&io));
+
+                u32 completed = 0;
+                while (async_io_pending_count(&io) != 0) {
+                    u32 count = async_io_wait(&io, make_fat_ptr(&completions), 1);
+                    for (u32 idx = 0; idx < count; ++idx) {
+                        AsyncIoCompletion const& completion = completions[idx];
+                        u32 chunk = *reinterpret_cast<u32 const*>(completion.user_data);
+
+                        psh_assert(completion.operation == ASYNC_IO_OPERATION_READ);
+                        psh_assert(completion.result == static_cast<isize>(CHUNK_SIZE));
+                        psh_assert(memcmp(completion.buf, data + chunk * CHUNK_SIZE, CHUNK_SIZE) == 0);
+                    }
+                    completed += count;
+                }
+                psh_assert(completed == QUEUE_DEPTH);
+
+                // Reads past the end of the file complete with zero bytes.
+                psh_assert(async_io_read(&io, &file, extra, psh_usize_of(extra), CHUNK_SIZE * CHUNK_COUNT, nullptr));
+                psh_assert(async_io_wait(&io, make_fat_ptr(&completions), 1) == 1);
+                psh_assert(completions[0].result == 0);
+
+                async_io_close_file(&file);
+            }
+
+            destroy_async_io(&io);
+        }
+        destroy_owned_arena(&arena);
+
+        psh_assert(remove(TEST_FILE_PATH) == 0);
+
+        report_test_successful();
+    }
+
+    psh_internal void run_all() {
+        mapped_file_matches_read_file();
+        map_empty_and_missing_files();
+        buffered_writer_and_streaming_reader();
+        asynchronous_reads_and_writes();
+    }
+}  // namespace psh::test::streams
+
+#if !defined(PSH_TEST_NOMAIN)
+int main() {
+    psh::test::streams::run_all();
+    return 0;
+}
+#endif
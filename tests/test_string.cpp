@@ -135,10 +135,507 @@ namespace psh::test::string {
         report_test_successful();
     }
 
+    psh_internal void string_search() {
+        String str = make_string("Three Rings for the Elven-kings under the sky, Seven for the Dwarf-lords in their halls of stone");
+
+        psh_assert(string_find_char(str, 'T') == 0);
+        psh_assert(string_find_char(str, 'R') == 6);
+        psh_assert(string_find_char(str, ',') == 45);
+        psh_assert(string_find_char(str, 'e') == 3);
+        psh_assert(string_find_char(str, 'z') == -1);
+        psh_assert(string_find_char(make_string(""), 'a') == -1);
+
+        psh_assert(string_find(str, "Three") == 0);
+        psh_assert(string_find(str, "Elven") == 20);
+        psh_assert(string_find(str, "the") == 16);
+        psh_assert(string_find(str, "stone") == static_cast<isize>(str.count) - 5);
+        psh_assert(string_find(str, "halls of stone") == static_cast<isize>(str.count) - 14);
+        psh_assert(string_find(str, "Mordor") == -1);
+        psh_assert(string_find(str, "stones") == -1);
+        psh_assert(string_find(str, "") == 0);
+        psh_assert(string_find(make_string("ab"), "abc") == -1);
+
+        // Needles whose first and last characters match at many positions of the haystack.
+        {
+            char buf[101];
+            for (usize idx = 0; idx < 100; ++idx) {
+                buf[idx] = 'a';
+            }
+            buf[100] = 0;
+            buf[97]  = 'b';
+
+            String s = make_string(buf);
+            psh_assert(string_find(s, "aba") == 96);
+            psh_assert(string_find(s, "aab") == 95);
+            psh_assert(string_find(s, "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab") == 63);
+            psh_assert(string_find(s, "aaca") == -1);
+        }
+
+        report_test_successful();
+    }
+
+    psh_internal void string_splitting() {
+        Arena arena = make_owned_arena(1024);
+        {
+            Array<String> tokens = string_split(&arena, make_string("Narya,Nenya,,Vilya"), ',');
+            psh_assert(tokens.count == 4);
+            psh_assert(string_equal(tokens[0], "Narya"));
+            psh_assert(string_equal(tokens[1], "Nenya"));
+            psh_assert(string_equal(tokens[2], ""));
+            psh_assert(string_equal(tokens[3], "Vilya"));
+        }
+        {
+            Array<String> tokens = string_split(&arena, make_string(",Ring,"), ',');
+            psh_assert(tokens.count == 3);
+            psh_assert(string_equal(tokens[0], ""));
+            psh_assert(string_equal(tokens[1], "Ring"));
+            psh_assert(string_equal(tokens[2], ""));
+        }
+        {
+            Array<String> tokens = string_split(&arena, make_string("No delimiters"), ',');
+            psh_assert(tokens.count == 1);
+            psh_assert(string_equal(tokens[0], "No delimiters"));
+        }
+        {
+            StringSplitter splitter = make_string_splitter(make_string("a b c"), ' ');
+            String         token;
+            usize          count = 0;
+            while (string_split_next(&splitter, &token)) {
+                psh_assert(token.count == 1);
+                ++count;
+            }
+            psh_assert(count == 3);
+            psh_assert(splitter.remaining.count == 0);
+        }
+        {
+            // Empty strings are made of a single empty token, whether or not they have a buffer.
+            String empty_strings[] = {String{.buf = nullptr, .count = 0}, make_string("")};
+            for (String empty : empty_strings) {
+                StringSplitter splitter = make_string_splitter(empty, ',');
+                String         token;
+                psh_assert(string_split_next(&splitter, &token));
+                psh_assert(token.count == 0);
+                psh_assert(!string_split_next(&splitter, &token));
+            }
+
+            Array<String> tokens = string_split(&arena, String{.buf = nullptr, .count = 0}, ',');
+            psh_assert((tokens.count == 1) && (tokens[0].count == 0));
+        }
+        destroy_owned_arena(&arena);
+
+        report_test_successful();
+    }
+
+    psh_internal void string_comparison() {
+        psh_assert(string_compare(make_string("abc"), make_string("abc")) == StringCompareResult::EQUAL);
+        psh_assert(string_compare(make_string("abc"), make_string("abd")) == StringCompareResult::LESS_THAN);
+        psh_assert(string_compare(make_string("abd"), make_string("abc")) == StringCompareResult::GREATER_THAN);
+        psh_assert(string_compare(make_string("ab"), make_string("abc")) == StringCompareResult::LESS_THAN);
+        psh_assert(string_compare(make_string("abc"), make_string("ab")) == StringCompareResult::GREATER_THAN);
+        psh_assert(string_compare(make_string(""), make_string("")) == StringCompareResult::EQUAL);
+
+        report_test_successful();
+    }
+
+    psh_global constexpr String HTTP_METHODS[] = {
+        psh_comptime_make_string("GET"),
+        psh_comptime_make_string("HEAD"),
+        psh_comptime_make_string("POST"),
+        psh_comptime_make_string("PUT"),
+        psh_comptime_make_string("DELETE"),
+        psh_comptime_make_string("CONNECT"),
+        psh_comptime_make_string("OPTIONS"),
+        psh_comptime_make_string("TRACE"),
+        psh_comptime_make_string("PATCH"),
+    };
+    psh_global constexpr StaticStringTable<9> HTTP_METHOD_TABLE = make_static_string_table(HTTP_METHODS);
+
+    psh_global constexpr String CPP_KEYWORDS[] = {
+        psh_comptime_make_string("alignas"),  psh_comptime_make_string("alignof"),   psh_comptime_make_string("auto"),
+        psh_comptime_make_string("bool"),     psh_comptime_make_string("break"),     psh_comptime_make_string("case"),
+        psh_comptime_make_string("catch"),    psh_comptime_make_string("char"),      psh_comptime_make_string("class"),
+        psh_comptime_make_string("const"),    psh_comptime_make_string("consteval"), psh_comptime_make_string("constexpr"),
+        psh_comptime_make_string("continue"), psh_comptime_make_string("default"),   psh_comptime_make_string("delete"),
+        psh_comptime_make_string("do"),       psh_comptime_make_string("double"),    psh_comptime_make_string("else"),
+        psh_comptime_make_string("enum"),     psh_comptime_make_string("explicit"),  psh_comptime_make_string("extern"),
+        psh_comptime_make_string("false"),    psh_comptime_make_string("float"),     psh_comptime_make_string("for"),
+        psh_comptime_make_string("goto"),     psh_comptime_make_string("if"),        psh_comptime_make_string("inline"),
+        psh_comptime_make_string("int"),      psh_comptime_make_string("long"),      psh_comptime_make_string("namespace"),
+        psh_comptime_make_string("new"),      psh_comptime_make_string("nullptr"),   psh_comptime_make_string("operator"),
+        psh_comptime_make_string("return"),   psh_comptime_make_string("short"),     psh_comptime_make_string("signed"),
+        psh_comptime_make_string("sizeof"),   psh_comptime_make_string("static"),    psh_comptime_make_string("struct"),
+        psh_comptime_make_string("switch"),   psh_comptime_make_string("template"),  psh_comptime_make_string("this"),
+        psh_comptime_make_string("true"),     psh_comptime_make_string("typedef"),   psh_comptime_make_string("union"),
+        psh_comptime_make_string("unsigned"), psh_comptime_make_string("using"),     psh_comptime_make_string("void"),
+        psh_comptime_make_string("volatile"), psh_comptime_make_string("while"),
+    };
+    psh_global constexpr StaticStringTable<count_of(CPP_KEYWORDS)> CPP_KEYWORD_TABLE = make_static_string_table(CPP_KEYWORDS);
+
+    psh_internal void static_string_tables() {
+        // Every key is found at its position in the array.
+        for (usize idx = 0; idx < count_of(HTTP_METHODS); ++idx) {
+            psh_assert(static_string_table_find(&HTTP_METHOD_TABLE, HTTP_METHODS[idx]) == static_cast<isize>(idx));
+        }
+        for (usize idx = 0; idx < count_of(CPP_KEYWORDS); ++idx) {
+            psh_assert(static_string_table_find(&CPP_KEYWORD_TABLE, CPP_KEYWORDS[idx]) == static_cast<isize>(idx));
+        }
+
+        // Lookups of strings living in mutable buffers.
+        char post[] = "POST";
+        psh_assert(static_string_table_find(&HTTP_METHOD_TABLE, make_string(post)) == 2);
+        post[3] = 'E';
+        psh_assert(static_string_table_find(&HTTP_METHOD_TABLE, make_string(post)) == -1);
+
+        // Prefixes, extensions and wrong cases of keys aren't keys.
+        psh_assert(static_string_table_find(&HTTP_METHOD_TABLE, make_string("")) == -1);
+        psh_assert(static_string_table_find(&HTTP_METHOD_TABLE, make_string("GE")) == -1);
+        psh_assert(static_string_table_find(&HTTP_METHOD_TABLE, make_string("GETS")) == -1);
+        psh_assert(static_string_table_find(&HTTP_METHOD_TABLE, make_string("get")) == -1);
+        psh_assert(static_string_table_find(&CPP_KEYWORD_TABLE, make_string("constexp")) == -1);
+        psh_assert(static_string_table_find(&CPP_KEYWORD_TABLE, make_string("mutable")) == -1);
+
+        // Each key occupies exactly one slot.
+        usize used_slots = 0;
+        for (usize idx = 0; idx < StaticStringTable<count_of(CPP_KEYWORDS)>::slot_count; ++idx) {
+            used_slots += (CPP_KEYWORD_TABLE.slots[idx] != STATIC_STRING_TABLE_EMPTY_SLOT) ? 1u : 0u;
+        }
+        psh_assert(used_slots == count_of(CPP_KEYWORDS));
+
+        report_test_successful();
+    }
+
+    psh_internal void number_formatting() {
+        char buf[FORMAT_FLOAT_MAX_LENGTH];
+
+        psh_assert(string_equal(String{buf, format_u64(buf, 0)}, "0"));
+        psh_assert(string_equal(String{buf, format_u64(buf, 18446744073709551615ull)}, "18446744073709551615"));
+        psh_assert(string_equal(String{buf, format_i64(buf, -1234567)}, "-1234567"));
+        psh_assert(string_equal(String{buf, format_i64(buf, -9223372036854775807ll - 1)}, "-9223372036854775808"));
+
+        psh_assert(string_equal(String{buf, format_f64(buf, 3.14159, 2)}, "3.14"));
+        psh_assert(string_equal(String{buf, format_f64(buf, -0.5)}, "-0.500000"));
+        psh_assert(string_equal(String{buf, format_f64(buf, 2.0009, 3)}, "2.001"));
+        psh_assert(string_equal(String{buf, format_f64(buf, 9.999, 0)}, "10"));
+        psh_assert(string_equal(String{buf, format_f64(buf, 1.05, 4)}, "1.0500"));
+
+        // Values out of the fixed-point range agree with string_format.
+        char expected[FORMAT_FLOAT_MAX_LENGTH + 1];
+        i32  expected_length = string_format(expected, static_cast<i32>(sizeof(expected)), "%.3f", 1e300);
+        psh_assert(string_equal(String{buf, format_f64(buf, 1e300, 3)}, String{expected, static_cast<usize>(expected_length)}));
+
+        // Scaled values past 2^53 aren't exact, so their trailing digits come from string_format.
+        f64 const inexact_values[]     = {1234.5678, -9999.123456789, 9999.123456789};
+        u32 const inexact_precisions[] = {15, 13, 15};
+        for (usize idx = 0; idx < count_of(inexact_values); ++idx) {
+            expected_length = string_format(
+                expected,
+                static_cast<i32>(sizeof(expected)),
+                "%.*f",
+                static_cast<i32>(inexact_precisions[idx]),
+                inexact_values[idx]);
+            String formatted = {buf, format_f64(buf, inexact_values[idx], inexact_precisions[idx])};
+            psh_assert(string_equal(formatted, String{expected, static_cast<usize>(expected_length)}));
+        }
+        psh_assert(!string_equal(String{buf, format_f64(buf, 1234.5678, 15)}, "1234.567800000000000"));
+
+        report_test_successful();
+    }
+
+    psh_global constexpr f64 INFINITY_F64 = __builtin_bit_cast(f64, u64{0x7FF0000000000000});
+    psh_global constexpr f64 NAN_F64      = __builtin_bit_cast(f64, u64{0x7FF8000000000000});
+
+    psh_internal void shortest_float_formatting() {
+        char buf[FORMAT_FLOAT_SHORTEST_MAX_LENGTH];
+
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, 0.0)}, "0"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, -0.0)}, "-0"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, 0.1)}, "0.1"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, 0.1 + 0.2)}, "0.30000000000000004"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, -1250.0)}, "-1250"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, 3.25)}, "3.25"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, 1e-6)}, "0.000001"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, 1.5e-7)}, "1.5e-7"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, 123456789012345680000.0)}, "123456789012345680000"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, 1e21)}, "1e21"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, 1.7976931348623157e308)}, "1.7976931348623157e308"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, -2.2250738585072014e-308)}, "-2.2250738585072014e-308"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, 5e-324)}, "5e-324"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, INFINITY_F64)}, "inf"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, -INFINITY_F64)}, "-inf"));
+        psh_assert(string_equal(String{buf, format_f64_shortest(buf, NAN_F64)}, "nan"));
+
+        // Formatting and parsing back gives the exact same value.
+        u64 bits = 0x9E3779B97F4A7C15ull;
+        for (u32 idx = 0; idx < 10'000; ++idx) {
+            bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+
+            f64 value = __builtin_bit_cast(f64, bits);
+            if (value != value) {
+                continue;
+            }
+
+            usize length = format_f64_shortest(buf, value);
+            f64   parsed;
+            psh_assert(string_to_f64(String{buf, length}, &parsed));
+            psh_assert(__builtin_bit_cast(u64, parsed) == bits);
+        }
+
+        report_test_successful();
+    }
+
+    psh_internal void integer_parsing() {
+        u64 unsigned_value;
+        psh_assert(string_to_u64(make_string("0"), &unsigned_value) && (unsigned_value == 0));
+        psh_assert(string_to_u64(make_string("+42"), &unsigned_value) && (unsigned_value == 42));
+        psh_assert(string_to_u64(make_string("000123456789012345"), &unsigned_value) && (unsigned_value == 123456789012345ull));
+        psh_assert(string_to_u64(make_string("18446744073709551615"), &unsigned_value));
+        psh_assert(unsigned_value == 18446744073709551615ull);
+
+        // Failures leave the value untouched.
+        unsigned_value = 7;
+        psh_assert(!string_to_u64(make_string("18446744073709551616"), &unsigned_value));
+        psh_assert(!string_to_u64(make_string("99999999999999999999"), &unsigned_value));
+        psh_assert(!string_to_u64(make_string("123456789012345678901"), &unsigned_value));
+        psh_assert(!string_to_u64(make_string("-1"), &unsigned_value));
+        psh_assert(!string_to_u64(make_string(""), &unsigned_value));
+        psh_assert(!string_to_u64(make_string("+"), &unsigned_value));
+        psh_assert(!string_to_u64(make_string("12 "), &unsigned_value));
+        psh_assert(!string_to_u64(make_string("1234567a"), &unsigned_value));
+        psh_assert(unsigned_value == 7);
+
+        i64 signed_value;
+        psh_assert(string_to_i64(make_string("-1234567"), &signed_value) && (signed_value == -1234567));
+        psh_assert(string_to_i64(make_string("9223372036854775807"), &signed_value) && (signed_value == 9223372036854775807ll));
+        psh_assert(string_to_i64(make_string("-9223372036854775808"), &signed_value));
+        psh_assert(signed_value == -9223372036854775807ll - 1);
+        psh_assert(!string_to_i64(make_string("9223372036854775808"), &signed_value));
+        psh_assert(!string_to_i64(make_string("-9223372036854775809"), &signed_value));
+        psh_assert(!string_to_i64(make_string("--1"), &signed_value));
+
+        // Tokens of a comma separated line are parsed in place.
+        StringSplitter line = make_string_splitter(make_string("17,-3,20000000000"), ',');
+        String         token;
+        i64            sum = 0;
+        while (string_split_next(&line, &token)) {
+            psh_assert(string_to_i64(token, &signed_value));
+            sum += signed_value;
+        }
+        psh_assert(sum == 20000000014ll);
+
+        report_test_successful();
+    }
+
+    psh_internal void float_parsing() {
+        f64 value;
+        psh_assert(string_to_f64(make_string("0"), &value) && (value == 0.0));
+        psh_assert(string_to_f64(make_string("-0.0"), &value) && (__builtin_bit_cast(u64, value) == (u64{1} << 63)));
+        psh_assert(string_to_f64(make_string("3.25"), &value) && (value == 3.25));
+        psh_assert(string_to_f64(make_string("+.5e-3"), &value) && (value == 0.0005));
+        psh_assert(string_to_f64(make_string("1."), &value) && (value == 1.0));
+        psh_assert(string_to_f64(make_string("6.02214076E23"), &value) && (value == 6.02214076e23));
+        psh_assert(string_to_f64(make_string("0.30000000000000004"), &value) && (value == 0.1 + 0.2));
+        psh_assert(string_to_f64(make_string("1.7976931348623157e308"), &value) && (value == 1.7976931348623157e308));
+        psh_assert(string_to_f64(make_string("4.9406564584124654e-324"), &value) && (value == 5e-324));
+        psh_assert(string_to_f64(make_string("2.2250738585072011e-308"), &value) && (value == 2.2250738585072011e-308));
+
+        // Out of range values.
+        psh_assert(string_to_f64(make_string("1e400"), &value) && (value == INFINITY_F64));
+        psh_assert(string_to_f64(make_string("-1e-400"), &value) && (value == 0.0) && (__builtin_bit_cast(u64, value) >> 63));
+        psh_assert(string_to_f64(make_string("1e99999999999"), &value) && (value == INFINITY_F64));
+
+        // Significant digits past the 19th.
+        psh_assert(string_to_f64(make_string("3.141592653589793238462643383279"), &value) && (value == 3.141592653589793));
+        psh_assert(string_to_f64(make_string("123456789012345678901234567890"), &value));
+        psh_assert(value == 123456789012345678901234567890.0);
+
+        // Exactly halfway between 1 and the next floating point number, but for the last digit, which
+        // has to be taken into account.
+        psh_assert(string_to_f64(make_string("1.00000000000000011102230246251565404236316680908203125"), &value));
+        psh_assert(value == 1.0);
+        psh_assert(string_to_f64(make_string("1.00000000000000011102230246251565404236316680908203126"), &value));
+        psh_assert(value == 1.0000000000000002);
+
+        psh_assert(string_to_f64(make_string("-Infinity"), &value) && (value == -INFINITY_F64));
+        psh_assert(string_to_f64(make_string("inf"), &value) && (value == INFINITY_F64));
+        psh_assert(string_to_f64(make_string("NaN"), &value) && (value != value));
+
+        value = 7.0;
+        psh_assert(!string_to_f64(make_string(""), &value));
+        psh_assert(!string_to_f64(make_string("-"), &value));
+        psh_assert(!string_to_f64(make_string("."), &value));
+        psh_assert(!string_to_f64(make_string("e5"), &value));
+        psh_assert(!string_to_f64(make_string("1e"), &value));
+        psh_assert(!string_to_f64(make_string("1e+"), &value));
+        psh_assert(!string_to_f64(make_string("1.2.3"), &value));
+        psh_assert(!string_to_f64(make_string(" 1"), &value));
+        psh_assert(!string_to_f64(make_string("infinite"), &value));
+        psh_assert(value == 7.0);
+
+        report_test_successful();
+    }
+
+    psh_internal void utf8_validation() {
+        psh_assert(utf8_is_valid(make_string("")));
+        psh_assert(utf8_is_valid(make_string("Mae govannen")));
+        psh_assert(utf8_is_valid(make_string("na\xC3\xAFve \xE2\x82\xAC \xF0\x9F\x8C\xB3")));
+        psh_assert(utf8_is_valid(make_string("\xF4\x8F\xBF\xBF")));
+
+        psh_assert(!utf8_is_valid(make_string("\x80")));              // Lone continuation byte.
+        psh_assert(!utf8_is_valid(make_string("\xC3")));              // Missing continuation byte.
+        psh_assert(!utf8_is_valid(make_string("\xC3\xA9\xA9")));      // Extra continuation byte.
+        psh_assert(!utf8_is_valid(make_string("\xC0\xAF")));          // Overlong encoding of '/'.
+        psh_assert(!utf8_is_valid(make_string("\xE0\x9F\xBF")));      // Overlong three byte sequence.
+        psh_assert(!utf8_is_valid(make_string("\xF0\x8F\xBF\xBF")));  // Overlong four byte sequence.
+        psh_assert(!utf8_is_valid(make_string("\xED\xA0\x80")));      // Surrogate.
+        psh_assert(!utf8_is_valid(make_string("\xF4\x90\x80\x80")));  // Past U+10FFFF.
+        psh_assert(!utf8_is_valid(make_string("\xFF")));
+
+        // Sequences at every position of a string spanning multiple blocks, so that they straddle
+        // the block boundaries and the zero padded tail.
+        char buf[100];
+        for (usize idx = 0; idx + 4 <= psh_usize_of(buf); ++idx) {
+            memory_set(reinterpret_cast<u8*>(buf), psh_usize_of(buf), 'a');
+            memory_copy(reinterpret_cast<u8*>(buf + idx), reinterpret_cast<u8 const*>("\xF0\x9F\x8C\xB3"), 4);
+            psh_assert(utf8_is_valid(String{buf, psh_usize_of(buf)}));
+            psh_assert(!utf8_is_valid(String{buf, idx + 3}));
+            psh_assert(utf8_codepoint_count(String{buf, psh_usize_of(buf)}) == psh_usize_of(buf) - 3);
+
+            buf[idx + 3] = 'a';
+            psh_assert(!utf8_is_valid(String{buf, psh_usize_of(buf)}));
+        }
+
+        memory_set(reinterpret_cast<u8*>(buf), psh_usize_of(buf), 'a');
+        psh_assert(utf8_is_ascii(String{buf, psh_usize_of(buf)}));
+        buf[97] = '\xC3';
+        psh_assert(!utf8_is_ascii(String{buf, psh_usize_of(buf)}));
+        psh_assert(utf8_is_ascii(String{buf, 97}));
+
+        psh_assert(utf8_codepoint_count(make_string("na\xC3\xAFve \xE2\x82\xAC \xF0\x9F\x8C\xB3")) == 9);
+
+        report_test_successful();
+    }
+
+    psh_internal void utf8_decoding() {
+        String remaining = make_string("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x8C\xB3\xC0z");
+        u32    codepoint;
+        psh_assert(utf8_decode_next(&remaining, &codepoint) && (codepoint == 'a'));
+        psh_assert(utf8_decode_next(&remaining, &codepoint) && (codepoint == 0xE9));
+        psh_assert(utf8_decode_next(&remaining, &codepoint) && (codepoint == 0x20AC));
+        psh_assert(utf8_decode_next(&remaining, &codepoint) && (codepoint == 0x1F333));
+        psh_assert(utf8_decode_next(&remaining, &codepoint) && (codepoint == UTF8_REPLACEMENT_CODEPOINT));
+        psh_assert(utf8_decode_next(&remaining, &codepoint) && (codepoint == 'z'));
+        psh_assert(!utf8_decode_next(&remaining, &codepoint));
+
+        char buf[UTF8_MAX_ENCODED_LENGTH];
+        psh_assert((utf8_encode(buf, 0x24) == 1) && (buf[0] == '$'));
+        psh_assert((utf8_encode(buf, 0xE9) == 2) && (strncmp(buf, "\xC3\xA9", 2) == 0));
+        psh_assert((utf8_encode(buf, 0x20AC) == 3) && (strncmp(buf, "\xE2\x82\xAC", 3) == 0));
+        psh_assert((utf8_encode(buf, 0x10FFFF) == 4) && (strncmp(buf, "\xF4\x8F\xBF\xBF", 4) == 0));
+        psh_assert((utf8_encode(buf, 0xD800) == 3) && (strncmp(buf, "\xEF\xBF\xBD", 3) == 0));
+        psh_assert((utf8_encode(buf, 0x110000) == 3) && (strncmp(buf, "\xEF\xBF\xBD", 3) == 0));
+
+        report_test_successful();
+    }
+
+    psh_internal void utf8_transcoding() {
+        Arena arena = make_owned_arena(psh_kibibytes(4));
+        psh_defer(destroy_owned_arena(&arena));
+
+        String     str   = make_string("C:\\Users\\Ba\xC3\xB1o\\\xE2\x82\xAC\\\xF0\x9F\x8C\xB3.txt");
+        Array<u16> units = utf8_to_utf16(&arena, str);
+        Buffer<u16, 20> expected = {
+            'C', ':', '\\', 'U', 's', 'e', 'r', 's', '\\', 'B', 'a', 0xF1, 'o', '\\', 0x20AC, '\\', 0xD83C, 0xDF33, '.', 't',
+        };
+        psh_assert(units.buf != nullptr);
+        psh_assert(units.count == 22);
+        psh_assert(memcmp(units.buf, expected.buf, psh_usize_of(expected.buf)) == 0);
+        psh_assert((units.buf[20] == 'x') && (units.buf[21] == 't') && (units.buf[22] == 0));
+
+        String round_trip = utf16_to_utf8(&arena, FatPtr<u16 const>{units.buf, units.count});
+        psh_assert(string_equal(round_trip, str));
+        psh_assert(round_trip.buf[round_trip.count] == 0);
+
+        // Long ASCII runs go through the widening fast path.
+        String ascii = make_string("The Road goes ever on and on, down from the door where it began.");
+        units        = utf8_to_utf16(&arena, ascii);
+        psh_assert(units.count == ascii.count);
+        for (usize idx = 0; idx < ascii.count; ++idx) {
+            psh_assert(units.buf[idx] == static_cast<u16>(ascii.buf[idx]));
+        }
+
+        psh_assert(utf8_to_utf16(&arena, make_string("\xED\xA0\x80")).buf == nullptr);
+
+        // Unpaired surrogates.
+        Buffer<u16, 3> high_only = {'a', 0xD83C, 'b'};
+        Buffer<u16, 2> low_only  = {0xDF33, 'a'};
+        Buffer<u16, 1> trailing  = {0xD83C};
+        psh_assert(utf16_to_utf8(&arena, FatPtr<u16 const>{high_only.buf, 3}).buf == nullptr);
+        psh_assert(utf16_to_utf8(&arena, FatPtr<u16 const>{low_only.buf, 2}).buf == nullptr);
+        psh_assert(utf16_to_utf8(&arena, FatPtr<u16 const>{trailing.buf, 1}).buf == nullptr);
+
+        String empty = utf16_to_utf8(&arena, FatPtr<u16 const>{});
+        psh_assert((empty.buf != nullptr) && (empty.count == 0) && (empty.buf[0] == 0));
+
+        report_test_successful();
+    }
+
+    psh_internal void string_builder_usage() {
+        Arena arena = make_owned_arena(psh_kibibytes(4));
+        psh_defer(destroy_owned_arena(&arena));
+
+        // While the builder is at the top of the arena, growing it doesn't move its contents.
+        StringBuilder builder = make_string_builder(&arena, 4);
+        char*         buf     = builder.buf;
+        psh_assert(string_builder_append(&builder, make_string("id: ")));
+        psh_assert(string_builder_append_u64(&builder, 42));
+        psh_assert(string_builder_append_char(&builder, ','));
+        psh_assert(string_builder_append_i64(&builder, -7));
+        psh_assert(string_builder_append_fmt(&builder, " name: %s, ratio: %.2f", "Frodo", 0.5));
+        psh_assert(string_builder_append_char(&builder, ','));
+        psh_assert(string_builder_append_f64_shortest(&builder, 0.125));
+        psh_assert(builder.buf == buf);
+
+        String result = string_builder_to_string(&builder);
+        psh_assert(string_equal(result, "id: 42,-7 name: Frodo, ratio: 0.50,0.125"));
+        psh_assert(result.buf[result.count] == 0);
+
+        // Formatted output spanning multiple chunks.
+        string_builder_clear(&builder);
+        for (u32 idx = 0; idx < 100; ++idx) {
+            psh_assert(string_builder_append_fmt(&builder, "%03u,", idx));
+        }
+        psh_assert(builder.count == 400);
+        psh_assert(strncmp(builder.buf + 396, "099,", 4) == 0);
+
+        string_builder_clear(&builder);
+        psh_assert(string_builder_append_fmt(&builder, "%0900d", 1));
+        psh_assert(builder.count == 900 && builder.buf[0] == '0' && builder.buf[899] == '1');
+
+        // Joining without a separator after the last element.
+        Buffer<String, 3> words = {make_string("Mellon"), make_string("Elen"), make_string("Namarie")};
+        string_builder_clear(&builder);
+        psh_assert(string_builder_join(&builder, make_const_fat_ptr(&words), make_string(", ")));
+        psh_assert(string_equal(string_builder_to_string(&builder), "Mellon, Elen, Namarie"));
+
+        report_test_successful();
+    }
+
     psh_internal void run_all() {
         string_type();
         dynamic_string_type();
         string_joining_operation();
+        string_search();
+        string_splitting();
+        string_comparison();
+        static_string_tables();
+        number_formatting();
+        shortest_float_formatting();
+        integer_parsing();
+        float_parsing();
+        utf8_validation();
+        utf8_decoding();
+        utf8_transcoding();
+        string_builder_usage();
     }
 }  // namespace psh::test::string
 
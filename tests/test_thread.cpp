@@ -0,0 +1,463 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Tests for the threading primitives and the job system.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+
+#include <psh_defer.hpp>
+#include <psh_memory.hpp>
+#include <psh_thread.hpp>
+#include "utils.hpp"
+
+namespace psh::test::thread {
+    struct SharedCounter {
+        Mutex mutex;
+        u64   value;
+    };
+
+    psh_internal void increment_counter(void* arg) {
+        SharedCounter* counter = reinterpret_cast<SharedCounter*>(arg);
+        for (u32 i = 0; i < 10000; ++i) {
+            mutex_lock(&counter->mutex);
+            ++counter->value;
+            mutex_unlock(&counter->mutex);
+        }
+    }
+
+    psh_internal void threads_and_mutexes() {
+        SharedCounter counter;
+        init_mutex(&counter.mutex);
+        counter.value = 0;
+
+        Thread threads[4];
+        for (usize idx = 0; idx < count_of(threads); ++idx) {
+            psh_assert(thread_create(&threads[idx], increment_counter, &counter));
+        }
+        for (usize idx = 0; idx < count_of(threads); ++idx) {
+            thread_join(&threads[idx]);
+        }
+
+        psh_assert(counter.value == 4 * 10000);
+        destroy_mutex(&counter.mutex);
+        psh_assert(thread_hardware_count() >= 1);
+
+        report_test_successful();
+    }
+
+    struct AtomicArenaContext {
+        AtomicArena* arena;
+        u32*         blocks[1000];
+    };
+
+    psh_internal void allocate_from_atomic_arena(void* arg) {
+        AtomicArenaContext* context = reinterpret_cast<AtomicArenaContext*>(arg);
+        for (u32 idx = 0; idx < count_of(context->blocks); ++idx) {
+            u32* block = memory_alloc<u32>(context->arena, 4);
+            psh_assert(block != nullptr);
+            block[0] = block[3] = idx;
+            context->blocks[idx] = block;
+        }
+    }
+
+    psh_internal void atomic_arena_concurrent_allocations() {
+        Arena backing = make_owned_arena(psh_mebibytes(1));
+        psh_defer(destroy_owned_arena(&backing));
+        AtomicArena arena = make_atomic_arena(backing.buf, backing.capacity);
+
+        AtomicArenaContext contexts[4];
+        Thread             threads[4];
+        for (usize idx = 0; idx < count_of(threads); ++idx) {
+            contexts[idx].arena = &arena;
+            psh_assert(thread_create(&threads[idx], allocate_from_atomic_arena, &contexts[idx]));
+        }
+        for (usize idx = 0; idx < count_of(threads); ++idx) {
+            thread_join(&threads[idx]);
+        }
+
+        // No two threads were given overlapping blocks.
+        for (usize idx = 0; idx < count_of(contexts); ++idx) {
+            for (u32 block = 0; block < count_of(contexts[idx].blocks); ++block) {
+                psh_assert(contexts[idx].blocks[block][0] == block);
+                psh_assert(contexts[idx].blocks[block][3] == block);
+            }
+        }
+        psh_assert(atomic_load(&arena.offset) == 4 * 1000 * 4 * sizeof(u32));
+
+        report_test_successful();
+    }
+
+    struct ScratchArenaContext {
+        Atomic<u32>* ready_count;
+        Arena*       arena;
+    };
+
+    psh_internal void use_thread_scratch_arena(void* arg) {
+        ScratchArenaContext* context = reinterpret_cast<ScratchArenaContext*>(arg);
+
+        ScratchArena scratch = get_scratch();
+        u64*         block   = memory_alloc<u64>(scratch.arena, 512);
+        psh_assert(block != nullptr);
+        block[511]     = 1;
+        context->arena = scratch.arena;
+
+        // Keep the thread alive until all threads got their arenas, so that no thread local
+        // storage gets reused by another thread.
+        atomic_fetch_add(context->ready_count, 1u);
+        while (atomic_load(context->ready_count) != 3) {
+            thread_yield();
+        }
+    }
+
+    psh_internal void scratch_arenas_are_thread_local() {
+        Atomic<u32>         ready_count = {};
+        ScratchArenaContext contexts[3];
+        Thread              threads[3];
+        for (usize idx = 0; idx < count_of(threads); ++idx) {
+            contexts[idx].ready_count = &ready_count;
+            psh_assert(thread_create(&threads[idx], use_thread_scratch_arena, &contexts[idx]));
+        }
+        for (usize idx = 0; idx < count_of(threads); ++idx) {
+            thread_join(&threads[idx]);
+        }
+
+        Arena* main_arena = get_scratch().arena;
+        psh_assert((contexts[0].arena != contexts[1].arena) && (contexts[1].arena != contexts[2].arena));
+        psh_assert(contexts[0].arena != contexts[2].arena);
+        for (usize idx = 0; idx < count_of(contexts); ++idx) {
+            psh_assert(contexts[idx].arena != main_arena);
+        }
+
+        report_test_successful();
+    }
+
+    struct PoolCacheContext {
+        Pool* pool;
+        u32   id;
+    };
+
+    psh_internal void churn_pool_via_cache(void* arg) {
+        PoolCacheContext* context = reinterpret_cast<PoolCacheContext*>(arg);
+        PoolCache         cache   = make_pool_cache(context->pool, 16);
+
+        u64* live[100];
+        for (u32 round = 0; round < 50; ++round) {
+            for (u32 idx = 0; idx < count_of(live); ++idx) {
+                live[idx] = pool_alloc<u64>(&cache);
+                psh_assert((live[idx] != nullptr) && (*live[idx] == 0));
+                *live[idx] = (static_cast<u64>(context->id) << 32) | idx;
+            }
+
+            // No other thread was given any of the blocks in use.
+            for (u32 idx = 0; idx < count_of(live); ++idx) {
+                psh_assert(*live[idx] == ((static_cast<u64>(context->id) << 32) | idx));
+                pool_free(&cache, live[idx]);
+            }
+        }
+
+        pool_cache_flush(&cache);
+    }
+
+    psh_internal void pool_caches_shared_between_threads() {
+        Pool pool;
+        psh_assert(init_pool<u64>(&pool, nullptr, 64));
+
+        PoolCacheContext contexts[4];
+        Thread           threads[4];
+        for (u32 idx = 0; idx < count_of(threads); ++idx) {
+            contexts[idx] = PoolCacheContext{.pool = &pool, .id = idx + 1};
+            psh_assert(thread_create(&threads[idx], churn_pool_via_cache, &contexts[idx]));
+        }
+        for (usize idx = 0; idx < count_of(threads); ++idx) {
+            thread_join(&threads[idx]);
+        }
+
+        psh_assert(pool.free_count == pool.block_count);
+        destroy_pool(&pool);
+
+        report_test_successful();
+    }
+
+    struct SumJob {
+        u64 const*   values;
+        usize        count;
+        Atomic<u64>* total;
+    };
+
+    psh_internal void sum_job(void* data, Arena* scratch) {
+        SumJob* job = reinterpret_cast<SumJob*>(data);
+
+        // Exercise the scratch arena of the worker.
+        u64* partial = memory_alloc<u64>(scratch, 1);
+        psh_assert(partial != nullptr);
+        for (usize idx = 0; idx < job->count; ++idx) {
+            *partial += job->values[idx];
+        }
+        psh_discard_value(atomic_fetch_add(job->total, *partial));
+    }
+
+    psh_internal void job_system_parallel_sum() {
+        Arena arena = make_owned_arena(psh_mebibytes(4));
+        psh_defer(destroy_owned_arena(&arena));
+
+        JobSystem job_system;
+        psh_assert(init_job_system(&job_system, &arena, 4, psh_kibibytes(16), 64));
+        psh_assert(job_system.worker_count == 4);
+        psh_assert(job_system_current_worker(&job_system) == &job_system.workers[0]);
+
+        constexpr usize VALUE_COUNT = 100000;
+        constexpr usize JOB_COUNT   = 200;  // More jobs than the deque capacity.
+
+        u64* values = memory_alloc<u64>(&arena, VALUE_COUNT);
+        for (usize idx = 0; idx < VALUE_COUNT; ++idx) {
+            values[idx] = idx;
+        }
+
+        Atomic<u64> total   = {0};
+        SumJob*     jobs    = memory_alloc<SumJob>(&arena, JOB_COUNT);
+        JobCounter  counter = {};
+        usize       chunk   = VALUE_COUNT / JOB_COUNT;
+        for (usize idx = 0; idx < JOB_COUNT; ++idx) {
+            jobs[idx] = SumJob{.values = values + idx * chunk, .count = chunk, .total = &total};
+            job_system_submit(&job_system, sum_job, &jobs[idx], &counter);
+        }
+        job_system_wait(&job_system, &counter);
+
+        psh_assert(atomic_load(&counter.pending) == 0);
+        psh_assert(atomic_load(&total) == (VALUE_COUNT * (VALUE_COUNT - 1)) / 2);
+
+        destroy_job_system(&job_system);
+        psh_assert(job_system_current_worker(&job_system) == nullptr);
+
+        report_test_successful();
+    }
+
+    struct NestedJob {
+        JobSystem*   job_system;
+        Atomic<u32>* leaf_count;
+        u32          depth;
+    };
+
+    psh_internal void nested_job(void* data, Arena* scratch) {
+        NestedJob* job = reinterpret_cast<NestedJob*>(data);
+        if (job->depth == 0) {
+            psh_discard_value(atomic_fetch_add(job->leaf_count, 1u));
+            return;
+        }
+
+        // Spawn children from within the job, depending on the scratch memory being alive until
+        // they have completed.
+        NestedJob* children = memory_alloc<NestedJob>(scratch, 4);
+        JobCounter counter  = {};
+        for (u32 idx = 0; idx < 4; ++idx) {
+            children[idx] = NestedJob{.job_system = job->job_system, .leaf_count = job->leaf_count, .depth = job->depth - 1};
+            job_system_submit(job->job_system, nested_job, &children[idx], &counter);
+        }
+        job_system_wait(job->job_system, &counter);
+    }
+
+    psh_internal void job_system_nested_jobs() {
+        Arena arena = make_owned_arena(psh_mebibytes(1));
+        psh_defer(destroy_owned_arena(&arena));
+
+        JobSystem job_system;
+        psh_assert(init_job_system(&job_system, &arena, 3, psh_kibibytes(16), 256));
+
+        Atomic<u32> leaf_count = {0};
+        NestedJob   root       = {.job_system = &job_system, .leaf_count = &leaf_count, .depth = 4};
+        JobCounter  counter    = {};
+        job_system_submit(&job_system, nested_job, &root, &counter);
+        job_system_wait(&job_system, &counter);
+
+        psh_assert(atomic_load(&leaf_count) == 4 * 4 * 4 * 4);
+        destroy_job_system(&job_system);
+
+        report_test_successful();
+    }
+
+    psh_internal void spsc_queue_bounds() {
+        Buffer<u32, 4> storage;
+        SpscQueue<u32> queue;
+        init_spsc_queue(&queue, &storage);
+
+        u32 value = 0;
+        psh_assert(!spsc_queue_pop(&queue, &value));
+
+        // Wrap around the storage a few times.
+        for (u32 round = 0; round < 3; ++round) {
+            for (u32 idx = 0; idx < 4; ++idx) {
+                psh_assert(spsc_queue_push(&queue, round * 10 + idx));
+            }
+            psh_assert(!spsc_queue_push(&queue, 100u));
+            psh_assert(spsc_queue_count(&queue) == 4);
+
+            for (u32 idx = 0; idx < 4; ++idx) {
+                psh_assert(spsc_queue_pop(&queue, &value));
+                psh_assert(value == round * 10 + idx);
+            }
+            psh_assert(!spsc_queue_pop(&queue, &value));
+        }
+
+        report_test_successful();
+    }
+
+    psh_global constexpr u64 QUEUE_TRANSFER_COUNT = 100'000;
+
+    psh_internal void spsc_produce(void* arg) {
+        SpscQueue<u64>* queue = reinterpret_cast<SpscQueue<u64>*>(arg);
+        for (u64 idx = 1; idx <= QUEUE_TRANSFER_COUNT; ++idx) {
+            while (!spsc_queue_push(queue, idx)) {
+                thread_yield();
+            }
+        }
+    }
+
+    psh_internal void spsc_queue_between_threads() {
+        Arena arena = make_owned_arena(psh_kibibytes(4));
+        {
+            SpscQueue<u64> queue;
+            psh_assert(init_spsc_queue(&queue, &arena, 64));
+
+            Thread producer;
+            psh_assert(thread_create(&producer, spsc_produce, &queue));
+
+            // Elements should arrive in order.
+            u64 expected = 1;
+            while (expected <= QUEUE_TRANSFER_COUNT) {
+                u64 value;
+                if (spsc_queue_pop(&queue, &value)) {
+                    psh_assert(value == expected);
+                    ++expected;
+                } else {
+                    thread_yield();
+                }
+            }
+
+            thread_join(&producer);
+            psh_assert(spsc_queue_count(&queue) == 0);
+        }
+        destroy_owned_arena(&arena);
+
+        report_test_successful();
+    }
+
+    struct MpmcContext {
+        MpmcQueue<u64>* queue;
+        Atomic<u64>*    consumed_sum;
+        Atomic<u64>*    consumed_count;
+        u64             first;
+    };
+
+    psh_global constexpr u64 MPMC_THREAD_COUNT = 4;
+
+    psh_internal void mpmc_produce(void* arg) {
+        MpmcContext* ctx = reinterpret_cast<MpmcContext*>(arg);
+        for (u64 idx = 0; idx < QUEUE_TRANSFER_COUNT; ++idx) {
+            while (!mpmc_queue_push(ctx->queue, ctx->first + idx)) {
+                thread_yield();
+            }
+        }
+    }
+
+    psh_internal void mpmc_consume(void* arg) {
+        MpmcContext* ctx   = reinterpret_cast<MpmcContext*>(arg);
+        u64          total = MPMC_THREAD_COUNT * QUEUE_TRANSFER_COUNT;
+        while (atomic_load(ctx->consumed_count, MemoryOrder::RELAXED) < total) {
+            u64 value;
+            if (mpmc_queue_pop(ctx->queue, &value)) {
+                atomic_fetch_add(ctx->consumed_sum, value, MemoryOrder::RELAXED);
+                atomic_fetch_add(ctx->consumed_count, u64{1}, MemoryOrder::RELAXED);
+            } else {
+                thread_yield();
+            }
+        }
+    }
+
+    psh_internal void mpmc_queue_between_threads() {
+        Buffer<MpmcQueueCell<u32>, 2> small_storage;
+        MpmcQueue<u32>                small_queue;
+        init_mpmc_queue(&small_queue, &small_storage);
+
+        u32 value = 0;
+        psh_assert(!mpmc_queue_pop(&small_queue, &value));
+        psh_assert(mpmc_queue_push(&small_queue, 7u));
+        psh_assert(mpmc_queue_push(&small_queue, 8u));
+        psh_assert(!mpmc_queue_push(&small_queue, 9u));
+        psh_assert(mpmc_queue_pop(&small_queue, &value) && (value == 7));
+        psh_assert(mpmc_queue_pop(&small_queue, &value) && (value == 8));
+        psh_assert(!mpmc_queue_pop(&small_queue, &value));
+
+        Arena arena = make_owned_arena(psh_kibibytes(8));
+        {
+            MpmcQueue<u64> queue;
+            psh_assert(init_mpmc_queue(&queue, &arena, 128));
+
+            Atomic<u64> consumed_sum   = {0};
+            Atomic<u64> consumed_count = {0};
+
+            MpmcContext contexts[MPMC_THREAD_COUNT];
+            Thread      producers[MPMC_THREAD_COUNT];
+            Thread      consumers[MPMC_THREAD_COUNT];
+            for (u64 idx = 0; idx < MPMC_THREAD_COUNT; ++idx) {
+                contexts[idx] = {
+                    .queue          = &queue,
+                    .consumed_sum   = &consumed_sum,
+                    .consumed_count = &consumed_count,
+                    .first          = idx * QUEUE_TRANSFER_COUNT + 1,
+                };
+                psh_assert(thread_create(&consumers[idx], mpmc_consume, &contexts[idx]));
+                psh_assert(thread_create(&producers[idx], mpmc_produce, &contexts[idx]));
+            }
+            for (u64 idx = 0; idx < MPMC_THREAD_COUNT; ++idx) {
+                thread_join(&producers[idx]);
+                thread_join(&consumers[idx]);
+            }
+
+            // Every value from 1 to the total count was received exactly once.
+            u64 total = MPMC_THREAD_COUNT * QUEUE_TRANSFER_COUNT;
+            psh_assert(atomic_load(&consumed_count) == total);
+            psh_assert(atomic_load(&consumed_sum) == total * (total + 1) / 2);
+            u64 leftover;
+            psh_assert(!mpmc_queue_pop(&queue, &leftover));
+        }
+        destroy_owned_arena(&arena);
+
+        report_test_successful();
+    }
+
+    psh_internal void run_all() {
+        threads_and_mutexes();
+        atomic_arena_concurrent_allocations();
+        scratch_arenas_are_thread_local();
+        pool_caches_shared_between_threads();
+        job_system_parallel_sum();
+        job_system_nested_jobs();
+        spsc_queue_bounds();
+        spsc_queue_between_threads();
+        mpmc_queue_between_threads();
+    }
+}  // namespace psh::test::thread
+
+#if !defined(PSH_TEST_NOMAIN)
+int main() {
+    psh::test::thread::run_all();
+    return 0;
+}
+#endif
@@ -52,8 +52,210 @@ namespace psh::test::vec {
         report_test_successful();
     }
 
+    /// Deterministic values spread over positive and negative numbers.
+    psh_internal f32 sample_value(u32 idx) {
+        return static_cast<f32>(static_cast<i32>((idx * 2654435761u) % 2001u) - 1000) / 250.0f;
+    }
+
+    psh_internal ColMat4 sample_matrix(u32 seed) {
+        ColMat4 m;
+        for (u32 idx = 0; idx < 16; ++idx) {
+            m.buf[idx] = sample_value(seed * 16 + idx);
+        }
+        return m;
+    }
+
+    psh_internal void vec4_operations() {
+        Vec4 a = {1.0f, -2.0f, 3.0f, 0.5f};
+        Vec4 b = {-4.0f, 0.25f, 2.0f, 8.0f};
+
+        psh_assert(approx_equal(a.dot(b), -4.0f - 0.5f + 6.0f + 4.0f));
+
+        Vec4 n = Vec4{3.0f, 0.0f, 4.0f, 0.0f}.normalised();
+        psh_assert(approx_equal(n.x, 0.6f) && approx_equal(n.y, 0.0f) && approx_equal(n.z, 0.8f) && approx_equal(n.w, 0.0f));
+        psh_assert(approx_equal(a.normalised().dot(a.normalised()), 1.0f, 1e-5f));
+        psh_assert(Vec4{}.normalised().is_zero(F32_IS_ZERO_RANGE));
+
+        Vec4 c = (a + b) * 2.0f - a * b;
+        psh_assert(approx_equal(c.x, -2.0f) && approx_equal(c.y, -3.0f) && approx_equal(c.z, 4.0f) && approx_equal(c.w, 13.0f));
+
+        report_test_successful();
+    }
+
+    psh_internal void matrix_multiplication() {
+        for (u32 seed = 0; seed < 8; ++seed) {
+            ColMat4 lhs = sample_matrix(2 * seed);
+            ColMat4 rhs = sample_matrix(2 * seed + 1);
+            Vec4    v   = {sample_value(seed), sample_value(seed + 100), sample_value(seed + 200), sample_value(seed + 300)};
+
+            ColMat4 prod = mat_mul(lhs, rhs);
+            for (u32 r = 0; r < 4; ++r) {
+                for (u32 c = 0; c < 4; ++c) {
+                    f32 expected = 0.0f;
+                    for (u32 k = 0; k < 4; ++k) {
+                        expected += lhs.buf[r * 4 + k] * rhs.buf[k * 4 + c];
+                    }
+                    psh_assert(approx_equal(prod.buf[r * 4 + c], expected, 1e-4f));
+                }
+            }
+
+            // The columns of the matrix are scaled by the components of the vector.
+            Vec4 transformed = mat_mul(lhs, v);
+            f32  components[4] = {v.x, v.y, v.z, v.w};
+            f32  result[4]     = {transformed.x, transformed.y, transformed.z, transformed.w};
+            for (u32 r = 0; r < 4; ++r) {
+                f32 expected = 0.0f;
+                for (u32 k = 0; k < 4; ++k) {
+                    expected += lhs.buf[k * 4 + r] * components[k];
+                }
+                psh_assert(approx_equal(result[r], expected, 1e-4f));
+            }
+        }
+
+        // Transformations compose as expected.
+        ColMat4 translation = ColMat4::translation(Vec3{1.0f, 2.0f, 3.0f});
+        Vec4    point       = mat_mul(translation, Vec4{1.0f, 1.0f, 1.0f, 1.0f});
+        psh_assert(approx_equal(point.x, 2.0f) && approx_equal(point.y, 3.0f) && approx_equal(point.z, 4.0f) && approx_equal(point.w, 1.0f));
+
+        ColMat4 id = mat_mul(ColMat4::id(), ColMat4::id());
+        for (u32 idx = 0; idx < 16; ++idx) {
+            psh_assert(approx_equal(id.buf[idx], ColMat4::id().buf[idx]));
+        }
+
+        report_test_successful();
+    }
+
+    psh_internal void batched_matrix_multiplication() {
+        constexpr u32 BATCH_COUNT = 37;
+
+        ColMat4 m = sample_matrix(42);
+
+        Vec4    vectors[BATCH_COUNT];
+        Vec4    transformed[BATCH_COUNT];
+        ColMat4 matrices[BATCH_COUNT];
+        ColMat4 products[BATCH_COUNT];
+        for (u32 idx = 0; idx < BATCH_COUNT; ++idx) {
+            vectors[idx]  = Vec4{sample_value(4 * idx), sample_value(4 * idx + 1), sample_value(4 * idx + 2), sample_value(4 * idx + 3)};
+            matrices[idx] = sample_matrix(100 + idx);
+        }
+
+        mat_mul(FatPtr<Vec4>{transformed, BATCH_COUNT}, m, FatPtr<Vec4 const>{vectors, BATCH_COUNT});
+        mat_mul(FatPtr<ColMat4>{products, BATCH_COUNT}, m, FatPtr<ColMat4 const>{matrices, BATCH_COUNT});
+        for (u32 idx = 0; idx < BATCH_COUNT; ++idx) {
+            Vec4 expected_vector = mat_mul(m, vectors[idx]);
+            psh_assert(approx_equal(transformed[idx].x, expected_vector.x) && approx_equal(transformed[idx].w, expected_vector.w));
+
+            ColMat4 expected_matrix = mat_mul(m, matrices[idx]);
+            for (u32 c = 0; c < 16; ++c) {
+                psh_assert(approx_equal(products[idx].buf[c], expected_matrix.buf[c]));
+            }
+        }
+
+        // The batches may be transformed in place.
+        mat_mul(FatPtr<Vec4>{vectors, BATCH_COUNT}, m, FatPtr<Vec4 const>{vectors, BATCH_COUNT});
+        for (u32 idx = 0; idx < BATCH_COUNT; ++idx) {
+            psh_assert(approx_equal(vectors[idx].y, transformed[idx].y) && approx_equal(vectors[idx].z, transformed[idx].z));
+        }
+
+        report_test_successful();
+    }
+
+    psh_internal void vec3_stream_conversion() {
+        constexpr u32 VECTOR_COUNT = 37;
+
+        Arena arena = make_owned_arena(psh_kibibytes(16));
+        psh_defer(destroy_owned_arena(&arena));
+
+        Vec3 vectors[VECTOR_COUNT];
+        for (u32 idx = 0; idx < VECTOR_COUNT; ++idx) {
+            vectors[idx] = Vec3{sample_value(3 * idx), sample_value(3 * idx + 1), sample_value(3 * idx + 2)};
+        }
+
+        Vec3Stream stream = make_vec3_stream(&arena, VECTOR_COUNT);
+        psh_assert(stream.count == VECTOR_COUNT);
+        psh_assert((reinterpret_cast<uptr>(stream.x) % VEC_STREAM_ALIGNMENT) == 0);
+        psh_assert((reinterpret_cast<uptr>(stream.y) % VEC_STREAM_ALIGNMENT) == 0);
+        psh_assert((reinterpret_cast<uptr>(stream.z) % VEC_STREAM_ALIGNMENT) == 0);
+
+        vec3_stream_from_aos(stream, FatPtr<Vec3 const>{vectors, VECTOR_COUNT});
+        for (u32 idx = 0; idx < VECTOR_COUNT; ++idx) {
+            psh_assert(approx_equal(stream.x[idx], vectors[idx].x));
+            psh_assert(approx_equal(stream.y[idx], vectors[idx].y));
+            psh_assert(approx_equal(stream.z[idx], vectors[idx].z));
+        }
+
+        Vec3 round_trip[VECTOR_COUNT];
+        vec3_stream_to_aos(FatPtr<Vec3>{round_trip, VECTOR_COUNT}, stream);
+        for (u32 idx = 0; idx < VECTOR_COUNT; ++idx) {
+            psh_assert((round_trip[idx] - vectors[idx]).is_zero(F32_IS_ZERO_RANGE));
+        }
+
+        report_test_successful();
+    }
+
+    psh_internal void vec3_stream_batch_kernels() {
+        constexpr u32 VECTOR_COUNT = 37;
+
+        Arena arena = make_owned_arena(psh_kibibytes(16));
+        psh_defer(destroy_owned_arena(&arena));
+
+        ColMat4 m = sample_matrix(7);
+
+        Vec3 vectors[VECTOR_COUNT];
+        for (u32 idx = 0; idx < VECTOR_COUNT; ++idx) {
+            vectors[idx] = Vec3{sample_value(3 * idx), sample_value(3 * idx + 1), sample_value(3 * idx + 2)};
+        }
+        vectors[3]  = Vec3{};
+        vectors[32] = Vec3{};
+
+        Vec3Stream stream = make_vec3_stream(&arena, VECTOR_COUNT);
+        Vec3Stream result = make_vec3_stream(&arena, VECTOR_COUNT);
+        vec3_stream_from_aos(stream, FatPtr<Vec3 const>{vectors, VECTOR_COUNT});
+
+        // Points and directions.
+        f32 const ws[2] = {1.0f, 0.0f};
+        for (f32 w : ws) {
+            batch_mat_mul(result, m, stream, w);
+            for (u32 idx = 0; idx < VECTOR_COUNT; ++idx) {
+                Vec4 expected = mat_mul(m, Vec4{vectors[idx].x, vectors[idx].y, vectors[idx].z, w});
+                Vec3 actual   = vec3_stream_get(result, idx);
+                psh_assert(approx_equal(actual.x, expected.x, 1e-4f));
+                psh_assert(approx_equal(actual.y, expected.y, 1e-4f));
+                psh_assert(approx_equal(actual.z, expected.z, 1e-4f));
+            }
+        }
+
+        batch_normalise(result, stream);
+        for (u32 idx = 0; idx < VECTOR_COUNT; ++idx) {
+            Vec3 expected = vectors[idx].normalised();
+            Vec3 actual   = vec3_stream_get(result, idx);
+            psh_assert(approx_equal(actual.x, expected.x) && approx_equal(actual.y, expected.y) && approx_equal(actual.z, expected.z));
+        }
+        psh_assert(vec3_stream_get(result, 3).is_zero(F32_IS_ZERO_RANGE) && vec3_stream_get(result, 32).is_zero(F32_IS_ZERO_RANGE));
+
+        f32 dots[VECTOR_COUNT];
+        batch_dot(FatPtr<f32>{dots, VECTOR_COUNT}, stream, result);
+        for (u32 idx = 0; idx < VECTOR_COUNT; ++idx) {
+            psh_assert(approx_equal(dots[idx], vectors[idx].dot(vec3_stream_get(result, idx)), 1e-4f));
+        }
+
+        // The stream may be transformed in place.
+        batch_mat_mul(result, m, stream);
+        batch_mat_mul(stream, m, stream);
+        for (u32 idx = 0; idx < VECTOR_COUNT; ++idx) {
+            psh_assert((vec3_stream_get(stream, idx) - vec3_stream_get(result, idx)).is_zero(F32_IS_ZERO_RANGE));
+        }
+
+        report_test_successful();
+    }
+
     psh_internal void run_all() {
         matrix_indexed_access();
+        vec4_operations();
+        matrix_multiplication();
+        batched_matrix_multiplication();
+        vec3_stream_conversion();
+        vec3_stream_batch_kernels();
     }
 }  // namespace psh::test::vec
 
@@ -0,0 +1,68 @@
+///                             Presheaf library
+/// Copyright (C) 2024 Luiz Gustavo Mugnaini Anselmo
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy of
+/// this software and associated documentation files (the “Software”), to deal in
+/// the Software without restriction, including without limitation the rights to
+/// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+/// of the Software, and to permit persons to whom the Software is furnished to do
+/// so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+/// Description: Command line tool decoding binary log files into text.
+/// Author: Luiz G. Mugnaini A. <luizmugnaini@gmail.com>
+///
+/// Usage: psh_log_decoder <binary log file>
+///
+/// The decoded messages are written to the standard output.
+
+#include "../src/presheaf_impl.cpp"
+
+#include <stdio.h>
+
+namespace psh::tools {
+    psh_global constexpr usize LOG_DECODER_ARENA_SIZE = psh_mebibytes(64);
+
+    psh_internal void write_to_stdout(void* context, impl::LogInfo const& info, char const* msg, usize length) {
+        psh_discard_value(context);
+        psh_discard_value(info);
+        psh_discard_value(fwrite(msg, 1, length, stdout));
+    }
+}  // namespace psh::tools
+
+int main(int argc, char** argv) {
+    using namespace psh;
+
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <binary log file>\n", argv[0]);
+        return 1;
+    }
+
+    FileMapResult mapped = map_file(argv[1], MAP_FILE_HINT_SEQUENTIAL);
+    if (mapped.status != FILE_STATUS_OK) {
+        String reason = file_status_to_string(mapped.status);
+        fprintf(stderr, "Unable to read the file %s: %.*s\n", argv[1], static_cast<int>(reason.count), reason.buf);
+        return 1;
+    }
+
+    Arena  arena  = make_owned_arena(tools::LOG_DECODER_ARENA_SIZE);
+    Status status = binary_log_decode(&arena, mapped.content, tools::write_to_stdout);
+    destroy_owned_arena(&arena);
+    unmap_file(mapped.content);
+
+    if (!status) {
+        fprintf(stderr, "Some records of %s couldn't be decoded.\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}